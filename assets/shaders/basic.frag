@@ -6,7 +6,7 @@ in vec2 vTexCoord;
 
 uniform vec3 uColor;
 uniform bool uUseTexture;
-uniform sampler2D uTexture;
+layout(binding = 0) uniform sampler2D uTexture;
 
 out vec4 fragColor;
 
@@ -17,6 +17,9 @@ void main() {
         // Use standard texture sampling - OpenGL will automatically select appropriate mip level
         // The LOD bias we set in texture parameters will prefer higher quality mip levels
         vec4 texColor = texture(uTexture, vTexCoord);
+        if (texColor.a < 0.5) {
+            discard;  // Alpha-keyed texels (index 255 of '{' textures)
+        }
         color = texColor.rgb;
         
         // Fallback for debugging
@@ -1,23 +1,35 @@
 #version 450 core
 
 layout(location = 0) in vec3 aPosition;
-layout(location = 1) in vec3 aNormal;
+layout(location = 1) in vec2 aNormal;     // Octahedral (renderer::PackedVertex)
 layout(location = 2) in vec2 aTexCoord;
 
+// Per-frame camera data, written once per frame (SimpleRenderer::FrameUniforms)
+layout(std140) uniform FrameUniforms {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+};
+
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
 
 out vec3 vPosition;
 out vec3 vNormal;
 out vec2 vTexCoord;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() {
     vec4 worldPos = uModel * vec4(aPosition, 1.0);
     vPosition = worldPos.xyz;
-    vNormal = mat3(transpose(inverse(uModel))) * aNormal;
+    vNormal = mat3(transpose(inverse(uModel))) * octDecode(aNormal);
     vTexCoord = aTexCoord;
     
-    gl_Position = uProjection * uView * worldPos;
+    gl_Position = uViewProjection * worldPos;
 }
 
@@ -0,0 +1,41 @@
+#version 450 core
+
+// basic.frag with the color of each instance instead of uColor
+
+in vec3 vPosition;
+in vec3 vNormal;
+in vec2 vTexCoord;
+flat in vec3 vColor;
+
+uniform bool uUseTexture;
+layout(binding = 0) uniform sampler2D uTexture;
+
+out vec4 fragColor;
+
+void main() {
+    vec3 color = vColor;
+    
+    if (uUseTexture) {
+        vec4 texColor = texture(uTexture, vTexCoord);
+        if (texColor.a < 0.5) {
+            discard;  // Alpha-keyed texels
+        }
+        color = texColor.rgb * vColor;
+    } else {
+        // Same checkerboard as basic.frag, so untextured instances look alike
+        vec2 grid = floor(vTexCoord * 8.0);
+        float checker = mod(grid.x + grid.y, 2.0);
+        vec3 texColor = mix(vec3(0.3, 0.3, 0.4), vec3(0.6, 0.6, 0.7), checker);
+        color = mix(vColor, texColor, 0.7);
+    }
+    
+    vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
+    float ndotl = max(dot(normalize(vNormal), lightDir), 0.6);
+    color *= ndotl;
+    
+    if (uUseTexture) {
+        color *= 1.2;  // Matches basic.frag's brightness boost
+    }
+    
+    fragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,49 @@
+#version 450 core
+
+// basic.vert for instanced draws: the model matrix and color come from the
+// instance ring (renderer::GLInstanceBuffer), indexed by the draw parameter,
+// which reads baseInstance + instance in an instanced draw
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec2 aNormal;     // Octahedral (renderer::PackedVertex)
+layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in uint aDrawParameter;
+
+// Per-frame camera data, written once per frame (SimpleRenderer::FrameUniforms)
+layout(std140) uniform FrameUniforms {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+};
+
+// This frame's slice of the ring (renderer::InstanceData)
+struct Instance {
+    mat4 model;
+    vec4 color;
+};
+layout(std430, binding = 0) readonly buffer Instances {
+    Instance uInstances[];
+};
+
+out vec3 vPosition;
+out vec3 vNormal;
+out vec2 vTexCoord;
+flat out vec3 vColor;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+    mat4 model = uInstances[aDrawParameter].model;
+    vec4 worldPos = model * vec4(aPosition, 1.0);
+    vPosition = worldPos.xyz;
+    vNormal = mat3(transpose(inverse(model))) * octDecode(aNormal);
+    vTexCoord = aTexCoord;
+    vColor = uInstances[aDrawParameter].color.rgb;
+    
+    gl_Position = uViewProjection * worldPos;
+}
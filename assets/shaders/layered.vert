@@ -0,0 +1,44 @@
+#version 450 core
+
+// basic.vert for multi-draws into texture arrays: each indirect command's
+// baseInstance arrives as aDrawParameter and selects the array layer. Map
+// vertices also carry their lightmap atlas coordinate and page
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec2 aNormal;     // Octahedral (renderer::PackedVertex)
+layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in uint aDrawParameter;
+layout(location = 4) in vec3 aLightmapCoord;  // 16-bit fixed point in the page, page (renderer::PackedVertex)
+
+// Per-frame camera data, written once per frame (SimpleRenderer::FrameUniforms)
+layout(std140) uniform FrameUniforms {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+};
+
+uniform mat4 uModel;
+
+out vec3 vPosition;
+out vec3 vNormal;
+out vec2 vTexCoord;
+out vec3 vLightmapCoord;
+flat out uint vLayer;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+    vec4 worldPos = uModel * vec4(aPosition, 1.0);
+    vPosition = worldPos.xyz;
+    vNormal = mat3(transpose(inverse(uModel))) * octDecode(aNormal);
+    vTexCoord = aTexCoord;
+    vLightmapCoord = vec3(aLightmapCoord.xy / 65535.0, aLightmapCoord.z);
+    vLayer = aDrawParameter;
+    
+    gl_Position = uViewProjection * worldPos;
+}
@@ -0,0 +1,982 @@
+#include "assets/assets.hpp"
+#include "assets/bsp/simple_bsp_loader.hpp"
+#include "assets/cooked/cooked_map_format.hpp"
+#include "assets/gltf/simple_gltf_loader.hpp"
+#include "assets/texture/block_compression.hpp"
+#include "assets/texture/ktx2.hpp"
+#include "assets/texture_image.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "renderer/backend/gl_texture.hpp"
+#include "renderer/backend/gl_upload_queue.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <span>
+
+namespace cscpp::assets {
+
+// ============================================================================
+// Pending Uploads
+// ============================================================================
+
+/**
+ * A decoded asset and its upload progress. Workers fill the decoded half
+ * and hand it over through m_decoded; update() then uploads the textures
+ * level by level and the groups buffer range by buffer range, resuming
+ * where the last frame's budget ran out.
+ */
+struct AssetManager::PendingUpload {
+    struct Group {
+        std::vector<renderer::PackedVertex> vertices;
+        std::vector<u8> indices;      // Packed to indexType
+        u32 indexCount = 0;
+        std::vector<BSPFaceRange> faces;  // Maps, moved into mesh.culling once groups are sorted
+        i32 texture = -1;  // Index into textures, -1 = untextured
+        u32 layer = 0;     // Layer of an array texture
+        u32 firstFace = 0; // Range of mesh.culling.faces
+        u32 faceCount = 0;
+    };
+    
+    /// One GL texture: a single image, or a 2D array of images of one size and format
+    struct Texture {
+        std::vector<std::shared_ptr<const TextureImage>> layers;
+        bool array = false;
+        bool mipmapped = true;  // False allocates level 0 only (lightmap atlas pages)
+    };
+    
+    /// Pack a group into the GPU layout (set indexType first)
+    Group& addGroup(const std::vector<renderer::Vertex>& vertices, const std::vector<u32>& indices,
+                    i32 texture, u32 layer) {
+        Group& group = groups.emplace_back();
+        group.vertices = renderer::packVertices(vertices);
+        group.indices = renderer::packIndices(indices, indexType);
+        group.indexCount = static_cast<u32>(indices.size());
+        group.texture = texture;
+        group.layer = layer;
+        return group;
+    }
+    
+    bool isMesh = true;
+    u32 slot = 0;
+    std::string error;  // Set by the decoder if the load failed
+    
+    // Decoded on a worker
+    std::vector<Group> groups;      // Sorted by texture
+    renderer::IndexType indexType = renderer::IndexType::U32;
+    std::vector<Texture> textures;
+    bool textureArrays = false;
+    i32 lightmapTexture = -1;  // Index into textures, -1 = unlit
+    AABB bounds;
+    size_t cpuMemory = 0;  // Bytes of decoded data, counted when handed to the GL thread
+    
+    // Upload progress (GL thread)
+    std::vector<u32> textureIDs;  // One per started texture, 0 if it could not be created
+    GPUMesh mesh;                 // Except mesh.culling, built by the map decoder
+    size_t textureMemory = 0;
+    u32 nextTexture = 0;
+    u32 nextLayer = 0;
+    u32 nextLevel = 0;
+    u32 nextGroup = 0;
+    bool verticesUploaded = false;
+};
+
+/// Layers per array texture, the GL 4.5 minimum of GL_MAX_ARRAY_TEXTURE_LAYERS
+static constexpr u32 MAX_TEXTURE_ARRAY_LAYERS = 2048;
+static_assert(MAX_TEXTURE_ARRAY_LAYERS <= renderer::MAX_DRAW_PARAMETER, "Layers are passed as draw parameters");
+
+static std::string lowercaseExtension(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::ranges::transform(extension, extension.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+template<typename T>
+static std::span<const u8> bytesOf(const std::vector<T>& data) {
+    return {reinterpret_cast<const u8*>(data.data()), data.size() * sizeof(T)};
+}
+
+static f64 millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Newest write time of an asset and its cooked file, searched like the loaders search
+static std::filesystem::file_time_type sourceWriteTime(const std::string& path) {
+    std::filesystem::file_time_type newest{};
+    for (const std::string& candidate : {path, "../" + path, "../../" + path}) {
+        for (const std::string& file : {candidate, cooked::cookedPathFor(candidate)}) {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(file, error);
+            if (!error) {
+                newest = std::max(newest, time);
+            }
+        }
+    }
+    return newest;
+}
+
+/// Replace S3TC textures with RGBA8 copies for drivers that cannot sample them
+static Result<void> decompressUnsupported(std::vector<std::shared_ptr<const TextureImage>>& images) {
+    CSCPP_PROFILE_FUNCTION();
+    for (auto& image : images) {
+        if (image->format != renderer::TextureFormat::BC1 && image->format != renderer::TextureFormat::BC3) {
+            continue;
+        }
+        auto decoded = decompressImage(*image);
+        if (!decoded) {
+            return std::unexpected(decoded.error());
+        }
+        image = std::make_shared<const TextureImage>(std::move(*decoded));
+    }
+    return {};
+}
+
+/// Whether an image's dimensions, mip count and data size are consistent
+static bool isUploadable(const TextureImage& image) {
+    return image.width > 0 && image.height > 0 && image.mipCount > 0 &&
+           image.mipCount <= renderer::mipLevelCount(image.width, image.height) &&
+           image.pixels.size() >= renderer::mipChainSize(image.width, image.height, image.mipCount, image.format);
+}
+
+// ============================================================================
+// Slots
+// ============================================================================
+
+template<typename SlotT>
+SlotT* AssetManager::findSlot(std::vector<SlotT>& slots, u32 id) {
+    const u32 index = (id & HANDLE_INDEX_MASK) - 1;  // Wraps for id 0
+    if (index >= slots.size()) {
+        return nullptr;
+    }
+    SlotT& slot = slots[index];
+    if (slot.state == AssetState::Invalid || slot.generation != id >> HANDLE_INDEX_BITS) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+template<typename SlotT>
+const SlotT* AssetManager::findSlot(const std::vector<SlotT>& slots, u32 id) {
+    return findSlot(const_cast<std::vector<SlotT>&>(slots), id);
+}
+
+template<typename SlotT>
+bool AssetManager::acquireSlot(std::vector<SlotT>& slots, std::vector<u32>& freeSlots,
+                               std::unordered_map<std::string, u32>& byPath, const std::string& path, u32& index) {
+    auto it = byPath.find(path);
+    if (it != byPath.end()) {
+        index = it->second;
+        SlotT& slot = slots[index];
+        slot.refCount++;
+        slot.lastUsed = m_frame;
+        return slot.state == AssetState::Failed;  // Loading again retries a failed load
+    }
+    
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = static_cast<u32>(slots.size());
+        slots.emplace_back();
+    }
+    
+    SlotT& slot = slots[index];
+    slot.path = path;
+    slot.refCount = 1;
+    slot.lastUsed = m_frame;
+    byPath.emplace(path, index);
+    return true;
+}
+
+// ============================================================================
+// Lifetime
+// ============================================================================
+
+AssetManager::AssetManager() = default;
+
+AssetManager::~AssetManager() {
+    shutdown();
+}
+
+void AssetManager::initialize(JobSystem* jobs, renderer::GLUploadQueue& uploads) {
+    m_jobs = jobs;
+    m_uploads = &uploads;
+    
+    // Queried here on the GL thread, workers only read the flag
+    m_s3tcSupported = renderer::isTextureFormatSupported(renderer::TextureFormat::BC1) &&
+                      renderer::isTextureFormatSupported(renderer::TextureFormat::BC3);
+    if (!m_s3tcSupported) {
+        LOG_WARN("S3TC textures are not supported by the driver, BC1/BC3 textures are decoded on load");
+    }
+}
+
+void AssetManager::shutdown() {
+    if (m_jobs) {
+        for (const JobHandle& handle : m_jobHandles) {
+            m_jobs->wait(handle);
+        }
+    }
+    m_jobHandles.clear();
+    
+    {
+        std::lock_guard lock(m_decodedMutex);
+        m_decoded.clear();
+    }
+    for (const auto& pending : m_uploading) {
+        discard(*pending);
+    }
+    m_uploading.clear();
+    
+    for (u32 index = 0; index < m_meshes.size(); ++index) {
+        evictMesh(index);
+    }
+    for (u32 index = 0; index < m_textures.size(); ++index) {
+        evictTexture(index);
+    }
+    m_meshes.clear();
+    m_textures.clear();
+    m_freeMeshes.clear();
+    m_freeTextures.clear();
+    m_meshByPath.clear();
+    m_textureByPath.clear();
+    m_pendingCount = 0;
+    m_meshMemory = 0;
+    m_textureMemory = 0;
+    m_jobs = nullptr;
+    m_uploads = nullptr;
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+Result<MeshHandle> AssetManager::loadMesh(const std::string& path) {
+    const std::string extension = lowercaseExtension(path);
+    const bool isMap = extension == ".bsp";
+    if (!isMap && extension != ".gltf" && extension != ".glb") {
+        return std::unexpected(Error{"Unsupported mesh format: " + path});
+    }
+    if (m_meshes.size() >= HANDLE_INDEX_MASK && !m_meshByPath.contains(path) && m_freeMeshes.empty()) {
+        return std::unexpected(Error{"Mesh cache is full"});
+    }
+    
+    u32 index = 0;
+    if (acquireSlot(m_meshes, m_freeMeshes, m_meshByPath, path, index)) {
+        scheduleMesh(index, isMap);
+    }
+    
+    MeshHandle handle;
+    handle.id = makeHandleID(index, m_meshes[index].generation);
+    return handle;
+}
+
+Result<TextureHandle> AssetManager::loadTexture(const std::string& path) {
+    if (m_textures.size() >= HANDLE_INDEX_MASK && !m_textureByPath.contains(path) && m_freeTextures.empty()) {
+        return std::unexpected(Error{"Texture cache is full"});
+    }
+    
+    u32 index = 0;
+    if (acquireSlot(m_textures, m_freeTextures, m_textureByPath, path, index)) {
+        scheduleTexture(index);
+    }
+    
+    TextureHandle handle;
+    handle.id = makeHandleID(index, m_textures[index].generation);
+    return handle;
+}
+
+Result<MaterialHandle> AssetManager::loadMaterial(const std::string& path) {
+    return std::unexpected(Error{"Material assets are not supported yet: " + path});
+}
+
+void AssetManager::scheduleMesh(u32 index, bool isMap) {
+    MeshSlot& slot = m_meshes[index];
+    if (slot.state != AssetState::Ready) {
+        slot.state = AssetState::Loading;
+    }
+    slot.requested = std::chrono::steady_clock::now();
+    slot.writeTime = sourceWriteTime(slot.path);
+    
+    if (isMap) {
+        schedule([path = slot.path](PendingUpload& pending) {
+            CSCPP_PROFILE_ZONE("DecodeMap");
+            SimpleBSPLoader loader;
+            auto data = loader.loadData(path);
+            if (!data) {
+                pending.error = data.error().message;
+                return;
+            }
+            
+            // Images of one size, format and mip count share an array texture, a group picks its layer
+            struct ArraySlot {
+                i32 texture;
+                u32 layer;
+            };
+            std::unordered_map<i32, ArraySlot> slotByMiptex;
+            for (BSPTextureImage& texture : data->textures) {
+                const TextureImage& image = *texture.image;
+                auto it = std::ranges::find_if(pending.textures, [&](const PendingUpload::Texture& array) {
+                    const TextureImage& first = *array.layers.front();
+                    return first.width == image.width && first.height == image.height &&
+                           first.mipCount == image.mipCount && first.format == image.format &&
+                           array.layers.size() < MAX_TEXTURE_ARRAY_LAYERS;
+                });
+                if (it == pending.textures.end()) {
+                    pending.textures.push_back({{}, true});
+                    it = std::prev(pending.textures.end());
+                }
+                slotByMiptex[texture.miptexIndex] = {static_cast<i32>(it - pending.textures.begin()),
+                                                     static_cast<u32>(it->layers.size())};
+                it->layers.push_back(std::move(texture.image));
+            }
+            pending.textureArrays = true;
+            
+            // Atlas pages are one more array, sampled with each vertex's page
+            if (!data->mesh.lightmapPages.empty()) {
+                PendingUpload::Texture& lightmaps = pending.textures.emplace_back();
+                lightmaps.array = true;
+                lightmaps.mipmapped = false;
+                for (TextureImage& page : data->mesh.lightmapPages) {
+                    lightmaps.layers.push_back(std::make_shared<const TextureImage>(std::move(page)));
+                }
+                pending.lightmapTexture = static_cast<i32>(pending.textures.size()) - 1;
+            }
+            
+            // Indices are relative to their group's base vertex: the largest group decides the width
+            size_t largestGroup = 0;
+            for (const BSPMeshGroup& group : data->mesh.groups) {
+                largestGroup = std::max(largestGroup, group.vertices.size());
+            }
+            pending.indexType = renderer::selectIndexType(largestGroup);
+            
+            for (BSPMeshGroup& group : data->mesh.groups) {
+                if (group.vertices.empty() || group.indices.empty()) {
+                    continue;
+                }
+                auto found = slotByMiptex.find(group.miptexIndex);
+                const ArraySlot slot = found != slotByMiptex.end() ? found->second : ArraySlot{-1, 0};
+                pending.addGroup(group.vertices, group.indices, slot.texture, slot.layer).faces = std::move(group.faces);
+                
+                // Only the packed copy is kept until upload
+                group.vertices = {};
+                group.indices = {};
+            }
+            
+            // Groups of one texture become adjacent, each run is one multi-draw
+            std::ranges::stable_sort(pending.groups, {}, &PendingUpload::Group::texture);
+            pending.bounds = data->mesh.bounds;
+            
+            // Faces in arena order (the upload lays groups out back to back), leaves point at them
+            MapCulling& culling = pending.mesh.culling;
+            std::vector<u32> faceSlot;  // BSP face index -> culling.faces
+            u32 firstIndex = 0;
+            for (PendingUpload::Group& group : pending.groups) {
+                group.firstFace = static_cast<u32>(culling.faces.size());
+                group.faceCount = static_cast<u32>(group.faces.size());
+                for (const BSPFaceRange& face : group.faces) {
+                    if (face.face >= faceSlot.size()) {
+                        faceSlot.resize(face.face + 1, ~0u);
+                    }
+                    faceSlot[face.face] = static_cast<u32>(culling.faces.size());
+                    culling.faces.push_back({firstIndex + face.firstIndex, face.indexCount});
+                }
+                firstIndex += group.indexCount;
+                group.faces = {};
+            }
+            
+            if (!data->mesh.leaves.empty()) {
+                std::vector<u8> inLeaf(culling.faces.size(), 0);
+                const std::span<const u32> leafFaces(data->mesh.leafFaces);
+                culling.leaves.reserve(data->mesh.leaves.size());
+                for (const BSPRenderLeaf& leaf : data->mesh.leaves) {
+                    MapCulling::Leaf& culled = culling.leaves.emplace_back();
+                    culled.bounds = leaf.bounds;
+                    culled.firstFace = static_cast<u32>(culling.leafFaces.size());
+                    for (u32 face : leafFaces.subspan(leaf.firstFace, leaf.faceCount)) {
+                        if (face < faceSlot.size() && faceSlot[face] != ~0u) {
+                            culling.leafFaces.push_back(faceSlot[face]);
+                            inLeaf[faceSlot[face]] = 1;
+                        }
+                    }
+                    culled.faceCount = static_cast<u32>(culling.leafFaces.size()) - culled.firstFace;
+                }
+                
+                // Brush entity faces are in no world leaf
+                for (u32 face = 0; face < inLeaf.size(); ++face) {
+                    if (!inLeaf[face]) {
+                        culling.unculledFaces.push_back(face);
+                    }
+                }
+            }
+        }, true, index);
+        return;
+    }
+    
+    schedule([path = slot.path](PendingUpload& pending) {
+        CSCPP_PROFILE_ZONE("DecodeModel");
+        SimpleGLTFLoader loader;
+        auto data = loader.loadData(path);
+        if (!data) {
+            pending.error = data.error().message;
+            return;
+        }
+        if (data->vertices.empty() || data->indices.empty()) {
+            pending.error = "Model has no geometry: " + path;
+            return;
+        }
+        
+        pending.bounds.min = data->vertices.front().position;
+        pending.bounds.max = data->vertices.front().position;
+        for (const renderer::Vertex& vertex : data->vertices) {
+            pending.bounds.min = glm::min(pending.bounds.min, vertex.position);
+            pending.bounds.max = glm::max(pending.bounds.max, vertex.position);
+        }
+        
+        i32 texture = -1;
+        if (data->texture) {
+            texture = 0;
+            pending.textures.push_back({{std::move(data->texture)}, false});
+        }
+        pending.indexType = renderer::selectIndexType(data->vertices.size());
+        pending.addGroup(data->vertices, data->indices, texture, 0);
+    }, true, index);
+}
+
+void AssetManager::scheduleTexture(u32 index) {
+    TextureSlot& slot = m_textures[index];
+    if (slot.state != AssetState::Ready) {
+        slot.state = AssetState::Loading;
+    }
+    slot.requested = std::chrono::steady_clock::now();
+    slot.writeTime = sourceWriteTime(slot.path);
+    
+    schedule([path = slot.path](PendingUpload& pending) {
+        CSCPP_PROFILE_ZONE("DecodeTexture");
+        auto image = lowercaseExtension(path) == KTX2_EXTENSION ? loadKTX2File(path) : loadImageFile(path);
+        if (!image) {
+            pending.error = image.error().message;
+            return;
+        }
+        pending.textures.push_back({{std::make_shared<const TextureImage>(std::move(*image))}, false});
+    }, false, index);
+}
+
+void AssetManager::schedule(std::function<void(PendingUpload&)> decode, bool isMesh, u32 slot) {
+    m_pendingCount++;
+    
+    auto job = [this, decode = std::move(decode), isMesh, slot, s3tcSupported = m_s3tcSupported] {
+        auto pending = std::make_unique<PendingUpload>();
+        pending->isMesh = isMesh;
+        pending->slot = slot;
+        decode(*pending);
+        if (!s3tcSupported && pending->error.empty()) {
+            // All layers of an array share a format, so decoding keeps them uniform
+            for (auto& texture : pending->textures) {
+                if (auto decompressed = decompressUnsupported(texture.layers); !decompressed) {
+                    pending->error = decompressed.error().message;
+                    break;
+                }
+            }
+        }
+        
+        std::lock_guard lock(m_decodedMutex);
+        m_decoded.push_back(std::move(pending));
+    };
+    
+    if (!m_jobs) {
+        job();
+        return;
+    }
+    
+    // Handles of finished jobs are dropped here rather than every frame
+    std::erase_if(m_jobHandles, [](const JobHandle& handle) { return handle.isDone(); });
+    m_jobHandles.push_back(m_jobs->schedule(std::move(job)));
+}
+
+// ============================================================================
+// References
+// ============================================================================
+
+void AssetManager::addRef(MeshHandle handle) {
+    if (MeshSlot* slot = findSlot(m_meshes, handle.id)) {
+        slot->refCount++;
+    }
+}
+
+void AssetManager::addRef(TextureHandle handle) {
+    if (TextureSlot* slot = findSlot(m_textures, handle.id)) {
+        slot->refCount++;
+    }
+}
+
+void AssetManager::release(MeshHandle handle) {
+    MeshSlot* slot = findSlot(m_meshes, handle.id);
+    if (slot && slot->refCount > 0) {
+        slot->refCount--;
+    }
+}
+
+void AssetManager::release(TextureHandle handle) {
+    TextureSlot* slot = findSlot(m_textures, handle.id);
+    if (slot && slot->refCount > 0) {
+        slot->refCount--;
+    }
+}
+
+// ============================================================================
+// Uploading
+// ============================================================================
+
+void AssetManager::update() {
+    CSCPP_PROFILE_FUNCTION();
+    m_frame++;
+    
+    {
+        std::lock_guard lock(m_decodedMutex);
+        for (auto& pending : m_decoded) {
+            if (!pending->error.empty()) {
+                fail(*pending);
+                continue;
+            }
+            
+            for (const auto& group : pending->groups) {
+                pending->cpuMemory += group.vertices.size() * sizeof(renderer::PackedVertex) + group.indices.size();
+            }
+            for (const auto& texture : pending->textures) {
+                for (const auto& image : texture.layers) {
+                    pending->cpuMemory += image->pixels.size();
+                }
+            }
+            
+            Slot& slot = pending->isMesh ? static_cast<Slot&>(m_meshes[pending->slot])
+                                         : static_cast<Slot&>(m_textures[pending->slot]);
+            if (slot.state == AssetState::Ready) {
+                slot.reloading = true;  // Keep serving the old version until the new one completes
+            } else {
+                slot.state = AssetState::Uploading;
+            }
+            m_uploading.push_back(std::move(pending));
+        }
+        m_decoded.clear();
+    }
+    
+    if (m_uploads) {
+        // Oldest request first: one asset becomes resident before the next starts
+        while (!m_uploading.empty() && upload(*m_uploading.front())) {
+            complete(*m_uploading.front());
+            m_uploading.pop_front();
+        }
+    }
+    
+    enforceBudget();
+}
+
+bool AssetManager::upload(PendingUpload& pending) {
+    // Textures first, one mip level of one layer per queue call
+    while (pending.nextTexture < pending.textures.size()) {
+        const PendingUpload::Texture& texture = pending.textures[pending.nextTexture];
+        const TextureImage& first = *texture.layers.front();
+        const u32 levels = texture.mipmapped
+            ? renderer::textureStorageLevels(first.width, first.height, first.mipCount, first.format)
+            : 1;
+        
+        if (pending.textureIDs.size() == pending.nextTexture) {
+            const bool valid = std::ranges::all_of(texture.layers, [](const auto& image) { return isUploadable(*image); });
+            const u32 layers = static_cast<u32>(texture.layers.size());
+            u32 textureID = 0;
+            if (valid) {
+                textureID = texture.array
+                    ? renderer::createTexture2DArray(first.width, first.height, layers, levels, first.format)
+                    : renderer::createTexture2D(first.width, first.height, levels, first.format);
+                if (textureID != 0) {
+                    pending.textureMemory += renderer::mipChainSize(first.width, first.height, levels, first.format) *
+                                             layers;
+                }
+            } else {
+                LOG_WARN("Skipping malformed texture '{}' ({}x{})", first.name, first.width, first.height);
+            }
+            pending.textureIDs.push_back(textureID);
+            pending.nextLayer = 0;
+            pending.nextLevel = 0;
+        }
+        
+        const u32 textureID = pending.textureIDs.back();
+        while (textureID != 0 && pending.nextLayer < texture.layers.size()) {
+            const TextureImage& image = *texture.layers[pending.nextLayer];
+            while (pending.nextLevel < image.mipCount) {
+                const u32 level = pending.nextLevel;
+                const u32 width = std::max(image.width >> level, 1u);
+                const u32 height = std::max(image.height >> level, 1u);
+                const u64 offset = renderer::mipChainSize(image.width, image.height, level, image.format);
+                const u64 size = renderer::textureLevelSize(width, height, image.format);
+                
+                const std::span<const u8> pixels = std::span(image.pixels).subspan(offset, size);
+                const bool uploaded = texture.array
+                    ? m_uploads->uploadTextureLayer(textureID, pending.nextLayer, level, width, height, image.format,
+                                                    pixels)
+                    : m_uploads->uploadTextureLevel(textureID, level, width, height, image.format, pixels);
+                if (!uploaded) {
+                    return false;
+                }
+                pending.nextLevel++;
+            }
+            pending.nextLevel = 0;
+            pending.nextLayer++;
+        }
+        
+        if (textureID != 0) {
+            if (texture.array) {
+                renderer::finishTexture2DArray(textureID, first.mipCount, levels, first.format);
+            } else {
+                renderer::finishTexture2D(textureID, first.mipCount, levels, first.format);
+            }
+        }
+        pending.nextTexture++;
+    }
+    
+    // Then geometry: one arena for all groups, allocated up front and filled group by group
+    if (!pending.groups.empty() && pending.mesh.groups.empty()) {
+        u32 vertexCount = 0;
+        u32 indexCount = 0;
+        for (const PendingUpload::Group& group : pending.groups) {
+            GPUMesh::Group& gpuGroup = pending.mesh.groups.emplace_back();
+            gpuGroup.firstIndex = indexCount;
+            gpuGroup.indexCount = group.indexCount;
+            gpuGroup.baseVertex = static_cast<i32>(vertexCount);
+            gpuGroup.textureLayer = group.layer;
+            gpuGroup.firstFace = group.firstFace;
+            gpuGroup.faceCount = group.faceCount;
+            if (group.texture >= 0) {
+                gpuGroup.textureID = pending.textureIDs[static_cast<size_t>(group.texture)];
+            }
+            vertexCount += static_cast<u32>(group.vertices.size());
+            indexCount += group.indexCount;
+        }
+        pending.mesh.geometry.allocate(vertexCount, indexCount, pending.indexType);
+        pending.mesh.textureArrays = pending.textureArrays;
+        if (pending.lightmapTexture >= 0) {
+            pending.mesh.lightmapTexture = pending.textureIDs[static_cast<size_t>(pending.lightmapTexture)];
+        }
+    }
+    
+    const renderer::GLMesh& geometry = pending.mesh.geometry;
+    while (pending.nextGroup < pending.groups.size()) {
+        PendingUpload::Group& group = pending.groups[pending.nextGroup];
+        const GPUMesh::Group& range = pending.mesh.groups[pending.nextGroup];
+        
+        if (!pending.verticesUploaded) {
+            const u64 offset = static_cast<u64>(range.baseVertex) * sizeof(renderer::PackedVertex);
+            if (!m_uploads->uploadBuffer(geometry.getVertexBuffer(), offset, bytesOf(group.vertices))) {
+                return false;
+            }
+            pending.verticesUploaded = true;
+        }
+        const u64 offset = static_cast<u64>(range.firstIndex) * renderer::indexSize(pending.indexType);
+        if (!m_uploads->uploadBuffer(geometry.getIndexBuffer(), offset, bytesOf(group.indices))) {
+            return false;
+        }
+        
+        group = {};  // Release the CPU copy once it is on the GPU
+        pending.verticesUploaded = false;
+        pending.nextGroup++;
+    }
+    return true;
+}
+
+void AssetManager::complete(PendingUpload& pending) {
+    m_pendingCount--;
+    
+    const size_t geometryMemory = pending.mesh.geometry.getMemorySize();
+    
+    if (!pending.isMesh) {
+        const u32 textureID = pending.textureIDs.empty() ? 0 : pending.textureIDs.front();
+        TextureSlot& slot = m_textures[pending.slot];
+        if (textureID == 0) {
+            LOG_WARN("Failed to upload texture {}", slot.path);
+            slot.reloading = false;
+            if (slot.state != AssetState::Ready) {
+                slot.state = AssetState::Failed;
+            }
+            return;
+        }
+        
+        renderer::destroyTexture2D(slot.textureID);
+        m_textureMemory = m_textureMemory - slot.textureMemory + pending.textureMemory;
+        slot.textureID = textureID;
+        slot.textureMemory = pending.textureMemory;
+        slot.state = AssetState::Ready;
+        LOG_INFO("{} texture {} in {:.1f} ms", slot.reloading ? "Reloaded" : "Streamed", slot.path,
+                 millisecondsSince(slot.requested));
+        slot.reloading = false;
+        return;
+    }
+    
+    MeshSlot& slot = m_meshes[pending.slot];
+    for (u32 textureID : slot.mesh.textures) {
+        renderer::destroyTexture2D(textureID);
+    }
+    m_meshMemory = m_meshMemory - slot.geometryMemory + geometryMemory;
+    m_textureMemory = m_textureMemory - slot.textureMemory + pending.textureMemory;
+    
+    slot.mesh = std::move(pending.mesh);
+    slot.mesh.bounds = pending.bounds;
+    slot.mesh.textures = std::move(pending.textureIDs);
+    slot.geometryMemory = geometryMemory;
+    slot.textureMemory = pending.textureMemory;
+    slot.state = AssetState::Ready;
+    LOG_INFO("{} {} in {:.1f} ms ({} groups, {} textures, {:.1f} MB)", slot.reloading ? "Reloaded" : "Streamed",
+             slot.path, millisecondsSince(slot.requested), slot.mesh.groups.size(), slot.mesh.textures.size(),
+             static_cast<f64>(geometryMemory + slot.textureMemory) / (1024.0 * 1024.0));
+    slot.reloading = false;
+}
+
+void AssetManager::fail(PendingUpload& pending) {
+    m_pendingCount--;
+    
+    Slot& slot = pending.isMesh ? static_cast<Slot&>(m_meshes[pending.slot])
+                                : static_cast<Slot&>(m_textures[pending.slot]);
+    if (slot.state == AssetState::Ready) {
+        LOG_WARN("Reload of {} failed, keeping the loaded version: {}", slot.path, pending.error);
+        slot.reloading = false;
+        return;
+    }
+    slot.state = AssetState::Failed;
+    LOG_WARN("Asset load failed: {}", pending.error);
+}
+
+void AssetManager::discard(PendingUpload& pending) {
+    for (u32 textureID : pending.textureIDs) {
+        renderer::destroyTexture2D(textureID);
+    }
+    pending.textureIDs.clear();
+    pending.mesh = {};
+}
+
+// ============================================================================
+// Hot Swapping
+// ============================================================================
+
+void AssetManager::reload(MeshHandle handle) {
+    MeshSlot* slot = findSlot(m_meshes, handle.id);
+    if (!slot || slot->state == AssetState::Loading || slot->state == AssetState::Uploading || slot->reloading) {
+        return;
+    }
+    slot->reloading = slot->state == AssetState::Ready;
+    scheduleMesh(static_cast<u32>(slot - m_meshes.data()), lowercaseExtension(slot->path) == ".bsp");
+}
+
+void AssetManager::reload(TextureHandle handle) {
+    TextureSlot* slot = findSlot(m_textures, handle.id);
+    if (!slot || slot->state == AssetState::Loading || slot->state == AssetState::Uploading || slot->reloading) {
+        return;
+    }
+    slot->reloading = slot->state == AssetState::Ready;
+    scheduleTexture(static_cast<u32>(slot - m_textures.data()));
+}
+
+u32 AssetManager::reloadChanged() {
+    CSCPP_PROFILE_FUNCTION();
+    u32 reloaded = 0;
+    
+    for (u32 index = 0; index < m_meshes.size(); ++index) {
+        MeshSlot& slot = m_meshes[index];
+        if (slot.state == AssetState::Ready && !slot.reloading && sourceWriteTime(slot.path) > slot.writeTime) {
+            MeshHandle handle;
+            handle.id = makeHandleID(index, slot.generation);
+            reload(handle);
+            reloaded++;
+        }
+    }
+    for (u32 index = 0; index < m_textures.size(); ++index) {
+        TextureSlot& slot = m_textures[index];
+        if (slot.state == AssetState::Ready && !slot.reloading && sourceWriteTime(slot.path) > slot.writeTime) {
+            TextureHandle handle;
+            handle.id = makeHandleID(index, slot.generation);
+            reload(handle);
+            reloaded++;
+        }
+    }
+    
+    if (reloaded > 0) {
+        LOG_INFO("Reloading {} changed assets", reloaded);
+    }
+    return reloaded;
+}
+
+// ============================================================================
+// Memory
+// ============================================================================
+
+void AssetManager::evictMesh(u32 index) {
+    MeshSlot& slot = m_meshes[index];
+    if (slot.state == AssetState::Invalid) {
+        return;
+    }
+    
+    for (u32 textureID : slot.mesh.textures) {
+        renderer::destroyTexture2D(textureID);
+    }
+    m_meshMemory -= slot.geometryMemory;
+    m_textureMemory -= slot.textureMemory;
+    m_meshByPath.erase(slot.path);
+    
+    const u32 generation = (slot.generation + 1) & HANDLE_GENERATION_MASK;
+    slot = {};
+    slot.generation = generation;
+    m_freeMeshes.push_back(index);
+}
+
+void AssetManager::evictTexture(u32 index) {
+    TextureSlot& slot = m_textures[index];
+    if (slot.state == AssetState::Invalid) {
+        return;
+    }
+    
+    renderer::destroyTexture2D(slot.textureID);
+    m_textureMemory -= slot.textureMemory;
+    m_textureByPath.erase(slot.path);
+    
+    const u32 generation = (slot.generation + 1) & HANDLE_GENERATION_MASK;
+    slot = {};
+    slot.generation = generation;
+    m_freeTextures.push_back(index);
+}
+
+/// Unreferenced and not waiting on a decode or upload
+static bool isEvictable(AssetState state, u32 refCount, bool reloading) {
+    return refCount == 0 && !reloading && (state == AssetState::Ready || state == AssetState::Failed);
+}
+
+void AssetManager::collectGarbage() {
+    CSCPP_PROFILE_FUNCTION();
+    u32 evicted = 0;
+    
+    for (u32 index = 0; index < m_meshes.size(); ++index) {
+        const MeshSlot& slot = m_meshes[index];
+        if (isEvictable(slot.state, slot.refCount, slot.reloading)) {
+            evictMesh(index);
+            evicted++;
+        }
+    }
+    for (u32 index = 0; index < m_textures.size(); ++index) {
+        const TextureSlot& slot = m_textures[index];
+        if (isEvictable(slot.state, slot.refCount, slot.reloading)) {
+            evictTexture(index);
+            evicted++;
+        }
+    }
+    
+    if (evicted > 0) {
+        LOG_INFO("Unloaded {} unused assets", evicted);
+    }
+}
+
+void AssetManager::enforceBudget() {
+    const auto overMesh = [this] { return m_budget.meshMemory != 0 && m_meshMemory > m_budget.meshMemory; };
+    const auto overTexture = [this] { return m_budget.textureMemory != 0 && m_textureMemory > m_budget.textureMemory; };
+    
+    while (overMesh() || overTexture()) {
+        // Least recently used evictable asset that holds memory of an over-budget kind
+        const bool meshes = overMesh();
+        const bool textures = overTexture();
+        const Slot* oldest = nullptr;
+        bool oldestIsMesh = false;
+        u32 oldestIndex = 0;
+        
+        for (u32 index = 0; index < m_meshes.size(); ++index) {
+            const MeshSlot& slot = m_meshes[index];
+            const bool holdsMemory = (meshes && slot.geometryMemory > 0) || (textures && slot.textureMemory > 0);
+            if (holdsMemory && isEvictable(slot.state, slot.refCount, slot.reloading) &&
+                (!oldest || slot.lastUsed < oldest->lastUsed)) {
+                oldest = &slot;
+                oldestIsMesh = true;
+                oldestIndex = index;
+            }
+        }
+        if (textures) {
+            for (u32 index = 0; index < m_textures.size(); ++index) {
+                const TextureSlot& slot = m_textures[index];
+                if (slot.textureMemory > 0 && isEvictable(slot.state, slot.refCount, slot.reloading) &&
+                    (!oldest || slot.lastUsed < oldest->lastUsed)) {
+                    oldest = &slot;
+                    oldestIsMesh = false;
+                    oldestIndex = index;
+                }
+            }
+        }
+        
+        if (!oldest) {
+            // Everything left is referenced; warn once per excursion over the budget
+            if (!m_overBudgetWarned) {
+                LOG_WARN("Asset memory over budget with nothing evictable (meshes {:.1f}/{:.1f} MB, textures {:.1f}/{:.1f} MB)",
+                         static_cast<f64>(m_meshMemory) / (1024.0 * 1024.0),
+                         static_cast<f64>(m_budget.meshMemory) / (1024.0 * 1024.0),
+                         static_cast<f64>(m_textureMemory) / (1024.0 * 1024.0),
+                         static_cast<f64>(m_budget.textureMemory) / (1024.0 * 1024.0));
+                m_overBudgetWarned = true;
+            }
+            return;
+        }
+        
+        LOG_DEBUG("Evicting {} (over memory budget)", oldest->path);
+        if (oldestIsMesh) {
+            evictMesh(oldestIndex);
+        } else {
+            evictTexture(oldestIndex);
+        }
+    }
+    m_overBudgetWarned = false;
+}
+
+AssetManager::MemoryStats AssetManager::getMemoryStats() const {
+    MemoryStats stats{};
+    stats.meshMemory = m_meshMemory;
+    stats.textureMemory = m_textureMemory;
+    for (const auto& pending : m_uploading) {
+        stats.pendingMemory += pending->cpuMemory;
+    }
+    stats.totalMemory = stats.meshMemory + stats.textureMemory + stats.pendingMemory;
+    
+    for (const MeshSlot& slot : m_meshes) {
+        stats.meshCount += slot.state == AssetState::Ready ? 1 : 0;
+    }
+    for (const TextureSlot& slot : m_textures) {
+        stats.textureCount += slot.state == AssetState::Ready ? 1 : 0;
+    }
+    return stats;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+AssetState AssetManager::getState(MeshHandle handle) const {
+    const MeshSlot* slot = findSlot(m_meshes, handle.id);
+    return slot ? slot->state : AssetState::Invalid;
+}
+
+AssetState AssetManager::getState(TextureHandle handle) const {
+    const TextureSlot* slot = findSlot(m_textures, handle.id);
+    return slot ? slot->state : AssetState::Invalid;
+}
+
+const GPUMesh* AssetManager::getMesh(MeshHandle handle) const {
+    const MeshSlot* slot = findSlot(m_meshes, handle.id);
+    if (!slot || slot->state != AssetState::Ready) {
+        return nullptr;
+    }
+    slot->lastUsed = m_frame;
+    return &slot->mesh;
+}
+
+u32 AssetManager::getTexture(TextureHandle handle) const {
+    const TextureSlot* slot = findSlot(m_textures, handle.id);
+    if (!slot || slot->state != AssetState::Ready) {
+        return 0;
+    }
+    slot->lastUsed = m_frame;
+    return slot->textureID;
+}
+
+} // namespace cscpp::assets
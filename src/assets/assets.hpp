@@ -7,9 +7,22 @@
 
 #include "core/types.hpp"
 #include "core/math/math.hpp"
+#include "core/jobs/job_system.hpp"
+#include "renderer/backend/gl_mesh.hpp"
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+namespace cscpp::renderer {
+class GLUploadQueue;
+}
+
 namespace cscpp::assets {
 
 // ============================================================================
@@ -168,7 +181,7 @@ Result<BSPAsset> loadBSP(const std::string& path);
 struct TextureAsset {
     u32 width;
     u32 height;
-    u32 format;
+    u32 format;     ///< renderer::TextureFormat
     u32 mipLevels;
     std::vector<u8> data;
 };
@@ -183,27 +196,176 @@ Result<TextureAsset> loadKTX2(const std::string& path);
 // Asset Manager
 // ============================================================================
 
+/// Residency of a streamed asset
+enum class AssetState : u8 {
+    Invalid,    ///< Not a handle of this manager
+    Loading,    ///< Reading and decoding on a worker
+    Uploading,  ///< Decoded, uploading within the per-frame budget
+    Ready,      ///< Resident on the GPU
+    Failed,     ///< Load failed (see log), loading the path again retries
+};
+
+/**
+ * @brief Faces of every BSP leaf, for PVS and frustum culling of a map
+ *
+ * Faces are index ranges of the mesh's geometry, stored group by group in
+ * index order, so the visible faces of a group merge into as few draw
+ * commands as possible. Faces no leaf references (brush entities) are
+ * listed in unculledFaces and always drawn.
+ */
+struct MapCulling {
+    struct Face {
+        u32 firstIndex = 0;     // Into the geometry's index buffer
+        u32 indexCount = 0;
+    };
+
+    struct Leaf {
+        AABB bounds;            // Mesh space, before the map's model matrix
+        u32 firstFace = 0;      // Into leafFaces
+        u32 faceCount = 0;
+    };
+
+    std::vector<Face> faces;
+    std::vector<Leaf> leaves;           ///< Indexed like LUMP_LEAVES
+    std::vector<u32> leafFaces;         ///< Into faces
+    std::vector<u32> unculledFaces;     ///< Into faces
+
+    bool empty() const { return leaves.empty(); }
+    size_t getMemorySize() const {
+        return faces.size() * sizeof(Face) + leaves.size() * sizeof(Leaf) +
+               (leafFaces.size() + unculledFaces.size()) * sizeof(u32);
+    }
+};
+
+/**
+ * @brief GPU-resident mesh, every group in one shared vertex/index arena
+ *
+ * Groups are index ranges of `geometry`, sorted by texture, so all groups
+ * sharing a texture can be submitted as one multi-draw. Maps keep their
+ * textures in 2D arrays (one per image size and format) and a group's
+ * layer selects its image; models have a single group and a 2D texture.
+ */
+struct GPUMesh {
+    struct Group {
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+        i32 baseVertex = 0;
+        u32 textureID = 0;      // 0 = untextured
+        u32 textureLayer = 0;   // Layer of textureID if textureArrays is set
+        u32 firstFace = 0;      // Into culling.faces
+        u32 faceCount = 0;
+    };
+
+    renderer::GLMesh geometry;  ///< Vertices and indices of all groups, back to back
+    std::vector<Group> groups;
+    std::vector<u32> textures;  ///< Texture names owned by this mesh (groups reference these)
+    bool textureArrays = false; ///< Group textures are 2D array textures
+    u32 lightmapTexture = 0;    ///< 2D array of lightmap atlas pages (maps only), 0 = unlit
+    MapCulling culling;         ///< Maps only, empty = draw every group whole
+    AABB bounds;
+};
+
 /**
  * @brief Manages loaded assets with caching
+ *
+ * loadMesh() and loadTexture() return a handle immediately; the file is
+ * read and decoded on the job system. update(), called once per frame on
+ * the GL thread, uploads finished decodes through the GLUploadQueue within
+ * its frame budget, so a large map streams in over several frames instead
+ * of stalling one. getMesh() and getTexture() return nothing until the
+ * asset is resident.
+ *
+ * Assets are deduplicated by path and reference counted: every load adds a
+ * reference, release() drops one. Handles carry a generation, so a handle
+ * to an evicted asset resolves to nothing instead of to whatever reused its
+ * slot. Unreferenced assets stay cached until collectGarbage() or until a
+ * memory budget is exceeded, then the least recently used go first.
+ *
+ * GL thread only, apart from the decode jobs it schedules itself.
  */
 class AssetManager {
 public:
-    /// Load a model (cached)
+    /// GPU memory limits in bytes, 0 = unlimited
+    struct MemoryBudget {
+        size_t meshMemory = 0;
+        size_t textureMemory = 0;
+    };
+
+    AssetManager();
+    ~AssetManager();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    /// Decode on `jobs` (nullptr = inline on the caller) and upload through `uploads`
+    void initialize(JobSystem* jobs, renderer::GLUploadQueue& uploads);
+
+    /// Wait for in-flight decodes and release every GPU resource (GL thread)
+    void shutdown();
+
+    /// Load a mesh, .bsp map or .gltf/.glb model (cached, adds a reference)
     Result<MeshHandle> loadMesh(const std::string& path);
     
-    /// Load a texture (cached)
+    /// Load an image file or a .ktx2 texture (cached, adds a reference)
     Result<TextureHandle> loadTexture(const std::string& path);
     
     /// Load a material
     Result<MaterialHandle> loadMaterial(const std::string& path);
+
+    /// Add a reference to a loaded asset
+    void addRef(MeshHandle handle);
+    void addRef(TextureHandle handle);
+
+    /// Drop a reference; unreferenced assets become eligible for eviction
+    void release(MeshHandle handle);
+    void release(TextureHandle handle);
+
+    /// Upload finished decodes within the frame budget and enforce the memory budget (GL thread)
+    void update();
+
+    AssetState getState(MeshHandle handle) const;
+    AssetState getState(TextureHandle handle) const;
+
+    /// Resident mesh, nullptr while loading, after a failed load or once evicted
+    const GPUMesh* getMesh(MeshHandle handle) const;
+
+    /// Resident texture name, 0 while loading, after a failed load or once evicted
+    u32 getTexture(TextureHandle handle) const;
+
+    /// Assets still decoding or uploading
+    u32 getPendingCount() const { return m_pendingCount; }
+
+    // ========================================================================
+    // Hot Swapping
+    // ========================================================================
+
+    /**
+     * @brief Decode and upload an asset again and swap it in once resident
+     *
+     * The handle stays valid and keeps returning the old data until the new
+     * version is complete; a failed reload keeps the old version.
+     */
+    void reload(MeshHandle handle);
+    void reload(TextureHandle handle);
+
+    /// Reload every resident asset whose source or cooked file changed on disk
+    u32 reloadChanged();
+
+    // ========================================================================
+    // Memory
+    // ========================================================================
+
+    void setBudget(const MemoryBudget& budget) { m_budget = budget; }
+    const MemoryBudget& getBudget() const { return m_budget; }
     
     /// Unload unused assets
     void collectGarbage();
     
     /// Get memory usage
     struct MemoryStats {
-        size_t meshMemory;
-        size_t textureMemory;
+        size_t meshMemory;      ///< Vertex and index buffers (GPU)
+        size_t textureMemory;   ///< Textures, including those owned by meshes (GPU)
+        size_t pendingMemory;   ///< Decoded data waiting for upload (CPU)
         size_t totalMemory;
         i32 meshCount;
         i32 textureCount;
@@ -211,7 +373,98 @@ public:
     MemoryStats getMemoryStats() const;
     
 private:
-    // Asset caches would be here
+    struct PendingUpload;
+
+    /// Cache entry state shared by every asset type
+    struct Slot {
+        std::string path;
+        AssetState state = AssetState::Invalid;
+        u32 generation = 0;
+        u32 refCount = 0;
+        bool reloading = false;                 ///< A new version is on its way
+        mutable u64 lastUsed = 0;               ///< Frame of the last lookup, for LRU eviction
+        size_t geometryMemory = 0;
+        size_t textureMemory = 0;
+        std::filesystem::file_time_type writeTime{};
+        std::chrono::steady_clock::time_point requested;
+    };
+
+    struct MeshSlot : Slot {
+        GPUMesh mesh;
+    };
+
+    struct TextureSlot : Slot {
+        u32 textureID = 0;
+    };
+
+    /// Handle ids pack the slot index (plus one) under the slot's generation
+    static constexpr u32 HANDLE_INDEX_BITS = 20;
+    static constexpr u32 HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+    static constexpr u32 HANDLE_GENERATION_MASK = (1u << (32 - HANDLE_INDEX_BITS)) - 1;
+
+    static u32 makeHandleID(u32 index, u32 generation) {
+        return (generation << HANDLE_INDEX_BITS) | (index + 1);
+    }
+
+    /// Slot a handle id refers to, nullptr if it is stale or was never issued
+    template<typename SlotT>
+    static SlotT* findSlot(std::vector<SlotT>& slots, u32 id);
+    template<typename SlotT>
+    static const SlotT* findSlot(const std::vector<SlotT>& slots, u32 id);
+
+    /// Find or create the slot for `path`, false if the loaded asset can be reused as is
+    template<typename SlotT>
+    bool acquireSlot(std::vector<SlotT>& slots, std::vector<u32>& freeSlots,
+                     std::unordered_map<std::string, u32>& byPath, const std::string& path, u32& index);
+
+    /// Schedule the decode job for a mesh or texture slot
+    void scheduleMesh(u32 slot, bool isMap);
+    void scheduleTexture(u32 slot);
+
+    /// Run `decode` for a slot on the job system (inline without one)
+    void schedule(std::function<void(PendingUpload&)> decode, bool isMesh, u32 slot);
+
+    /// Advance one upload, false once the frame budget is spent
+    bool upload(PendingUpload& pending);
+
+    /// Publish a finished upload into its slot
+    void complete(PendingUpload& pending);
+
+    /// Mark a slot failed after a decode or upload error
+    void fail(PendingUpload& pending);
+
+    /// Free an upload's GL objects (shutdown, superseded or failed uploads)
+    static void discard(PendingUpload& pending);
+
+    /// Release a slot's GPU resources and retire its handles
+    void evictMesh(u32 index);
+    void evictTexture(u32 index);
+
+    /// Evict least recently used unreferenced assets until both budgets hold
+    void enforceBudget();
+
+    JobSystem* m_jobs = nullptr;
+    renderer::GLUploadQueue* m_uploads = nullptr;
+
+    std::vector<MeshSlot> m_meshes;
+    std::vector<TextureSlot> m_textures;
+    std::vector<u32> m_freeMeshes;
+    std::vector<u32> m_freeTextures;
+    std::unordered_map<std::string, u32> m_meshByPath;
+    std::unordered_map<std::string, u32> m_textureByPath;
+
+    std::vector<JobHandle> m_jobHandles;
+    std::mutex m_decodedMutex;
+    std::vector<std::unique_ptr<PendingUpload>> m_decoded;  ///< Filled by workers
+    std::deque<std::unique_ptr<PendingUpload>> m_uploading;  ///< GL thread only
+    u32 m_pendingCount = 0;
+
+    MemoryBudget m_budget;
+    size_t m_meshMemory = 0;
+    size_t m_textureMemory = 0;
+    u64 m_frame = 0;
+    bool m_overBudgetWarned = false;
+    bool m_s3tcSupported = true;  ///< BC1/BC3 sampled natively, otherwise decoded on the workers
 };
 
 } // namespace cscpp::assets
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file bsp_entities.hpp
+ * @brief Queries on a BSP's entity lump
+ *
+ * Header-only like BSPView, so the server and the tools can use it without
+ * linking the asset library.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "assets/bsp/bsp_view.hpp"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cscpp::assets::bsp {
+
+/// Origins of info_player_start / info_player_deathmatch entities, raised one unit off the floor
+inline std::vector<Vec3> readSpawnPoints(const BSPView& bsp) {
+    std::vector<Vec3> spawns;
+    const std::string_view text = bsp.getEntities();
+
+    // Entity blocks are { "key" "value" ... }
+    size_t pos = 0;
+    while ((pos = text.find('{', pos)) != std::string_view::npos) {
+        const size_t end = text.find('}', pos);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        const std::string_view block = text.substr(pos, end - pos);
+        pos = end;
+
+        if (block.find("\"info_player_start\"") == std::string_view::npos &&
+            block.find("\"info_player_deathmatch\"") == std::string_view::npos) {
+            continue;
+        }
+        const size_t key = block.find("\"origin\"");
+        if (key == std::string_view::npos) {
+            continue;
+        }
+        const size_t open = block.find('"', key + 8);
+        const size_t close = open == std::string_view::npos ? open : block.find('"', open + 1);
+        if (close == std::string_view::npos) {
+            continue;
+        }
+
+        std::istringstream value(std::string(block.substr(open + 1, close - open - 1)));
+        Vec3 origin(0.0f);
+        if (value >> origin.x >> origin.y >> origin.z) {
+            spawns.push_back(origin + Vec3(0.0f, 0.0f, 1.0f));
+        }
+    }
+    return spawns;
+}
+
+} // namespace cscpp::assets::bsp
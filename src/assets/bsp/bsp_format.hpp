@@ -67,6 +67,30 @@ struct BSPTextureInfo {
     i32 flags;
 };
 
+struct BSPNode {
+    i32 planeIndex;
+    i16 children[2];    // >= 0: node index, < 0: -(leaf index + 1)
+    i16 mins[3];
+    i16 maxs[3];
+    u16 firstFace;
+    u16 numFaces;
+};
+
+struct BSPClipNode {
+    i32 planeIndex;
+    i16 children[2];    // >= 0: clipnode index, < 0: contents
+};
+
+struct BSPLeaf {
+    i32 contents;
+    i32 visOffset;      // Offset into visibility lump (-1 = no vis)
+    i16 mins[3];
+    i16 maxs[3];
+    u16 firstMarkSurface;
+    u16 numMarkSurfaces;
+    u8 ambientLevels[4];
+};
+
 struct BSPModel {
     f32 mins[3];
     f32 maxs[3];
@@ -77,12 +101,15 @@ struct BSPModel {
     i32 numFaces;
 };
 
+// Mip levels stored with every miptex
+inline constexpr u32 MIPLEVELS = 4;
+
 // Miptex structure (texture format in BSP and WAD)
 struct BSPMiptex {
     char name[16];      // Texture name
     u32 width;          // Texture width
     u32 height;         // Texture height
-    u32 offsets[4];     // Offsets to mip levels (0=full, 1=half, 2=quarter, 3=eighth)
+    u32 offsets[MIPLEVELS];  // Offsets to mip levels (0=full, 1=half, 2=quarter, 3=eighth)
 };
 
 // WAD file format structures (GoldSrc WAD3 format)
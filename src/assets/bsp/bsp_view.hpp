@@ -0,0 +1,190 @@
+#pragma once
+
+/**
+ * @file bsp_view.hpp
+ * @brief Zero-copy view of a GoldSrc BSP file
+ *
+ * Maps the file once and hands out typed spans straight into the mapping,
+ * so loaders read lumps in place instead of copying each one into a heap
+ * buffer. The header, every lump's bounds, element size and alignment, and
+ * the miptex directory of the texture lump are validated in open(); after
+ * that, lump access is a pointer cast.
+ *
+ * One view serves every consumer of a map (render mesh, collision hulls,
+ * PVS), and the spans stay valid for as long as the view is alive.
+ */
+
+#include "core/types.hpp"
+#include "core/platform/mapped_file.hpp"
+#include "assets/bsp/bsp_format.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cscpp::assets::bsp {
+
+class BSPView {
+public:
+    static constexpr i32 VERSION = 30;
+    static constexpr i32 LUMP_COUNT = 15;
+    static constexpr i32 MAX_MIPTEX = 1024;
+    
+    /// Map and validate a BSP file
+    Result<void> open(const std::string& path) {
+        close();
+        if (auto mapped = m_file.open(path); !mapped) {
+            return mapped;
+        }
+        if (auto valid = validate(); !valid) {
+            close();
+            return valid;
+        }
+        return {};
+    }
+    
+    void close() {
+        m_file.close();
+        m_header = BSPHeader{};
+        m_miptexCount = 0;
+    }
+    
+    bool isOpen() const { return m_file.isOpen(); }
+    const std::string& getPath() const { return m_file.getPath(); }
+    u64 getFileSize() const { return m_file.getSize(); }
+    const BSPHeader& getHeader() const { return m_header; }
+    
+    /// Raw bytes of a lump
+    std::span<const u8> getLumpBytes(BSPLumpType type) const {
+        const BSPLump& lump = m_header.lumps[type];
+        return m_file.getBytes().subspan(static_cast<size_t>(lump.offset), static_cast<size_t>(lump.length));
+    }
+    
+    /// A lump as an array of its records (empty if T is not the lump's record type)
+    template<typename T>
+    std::span<const T> getLump(BSPLumpType type) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const std::span<const u8> bytes = getLumpBytes(type);
+        if (bytes.size() % sizeof(T) != 0 ||
+            reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(T) != 0) {
+            return {};
+        }
+        return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+    }
+    
+    /// Entity lump text without the trailing terminator
+    std::string_view getEntities() const {
+        const std::span<const u8> bytes = getLumpBytes(LUMP_ENTITIES);
+        std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        while (!text.empty() && text.back() == '\0') {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+    
+    /// Slots in the texture lump's miptex directory
+    i32 getMiptexCount() const { return m_miptexCount; }
+    
+    /// Miptex header of a slot, or nullptr for empty slots (texture lives in a WAD)
+    const BSPMiptex* getMiptex(i32 index) const {
+        const std::span<const u8> bytes = getMiptexBytes(index);
+        return bytes.empty() ? nullptr : reinterpret_cast<const BSPMiptex*>(bytes.data());
+    }
+    
+    /// Bytes from a slot's miptex header to the end of the texture lump
+    std::span<const u8> getMiptexBytes(i32 index) const {
+        if (index < 0 || index >= m_miptexCount) {
+            return {};
+        }
+        const std::span<const u8> lump = getLumpBytes(LUMP_TEXTURES);
+        const i32 offset = miptexOffset(lump, index);
+        if (offset < 0) {
+            return {};
+        }
+        return lump.subspan(static_cast<size_t>(offset));
+    }
+
+private:
+    /// Record size of each lump (1 for byte lumps)
+    static constexpr size_t LUMP_RECORD_SIZES[LUMP_COUNT] = {
+        1,                          // LUMP_ENTITIES
+        sizeof(BSPPlane),           // LUMP_PLANES
+        1,                          // LUMP_TEXTURES
+        sizeof(BSPVertex),          // LUMP_VERTICES
+        1,                          // LUMP_VISIBILITY
+        sizeof(BSPNode),            // LUMP_NODES
+        sizeof(BSPTextureInfo),     // LUMP_TEXINFO
+        sizeof(BSPFace),            // LUMP_FACES
+        1,                          // LUMP_LIGHTING
+        sizeof(BSPClipNode),        // LUMP_CLIPNODES
+        sizeof(BSPLeaf),            // LUMP_LEAVES
+        sizeof(u16),                // LUMP_MARKSURFACES
+        sizeof(BSPEdge),            // LUMP_EDGES
+        sizeof(i32),                // LUMP_SURFEDGES
+        sizeof(BSPModel),           // LUMP_MODELS
+    };
+    
+    /// All structured lumps are made of 2- and 4-byte fields
+    static constexpr size_t LUMP_ALIGNMENT = 4;
+    
+    Result<void> validate() {
+        const std::span<const u8> file = m_file.getBytes();
+        const std::string& path = m_file.getPath();
+        
+        if (file.size() < sizeof(BSPHeader)) {
+            return std::unexpected(Error{"BSP file too small: " + path});
+        }
+        std::memcpy(&m_header, file.data(), sizeof(BSPHeader));
+        if (m_header.version != VERSION) {
+            return std::unexpected(Error{"Unsupported BSP version " + std::to_string(m_header.version) + ": " + path});
+        }
+        
+        for (i32 i = 0; i < LUMP_COUNT; ++i) {
+            BSPLump& lump = m_header.lumps[i];
+            if (lump.length == 0) {
+                lump.offset = 0;    // Empty lumps often carry junk offsets
+                continue;
+            }
+            const size_t record = LUMP_RECORD_SIZES[i];
+            if (lump.offset < 0 || lump.length < 0 ||
+                static_cast<u64>(lump.offset) + static_cast<u64>(lump.length) > file.size() ||
+                static_cast<size_t>(lump.length) % record != 0 ||
+                (record > 1 && static_cast<size_t>(lump.offset) % LUMP_ALIGNMENT != 0)) {
+                return std::unexpected(Error{"Corrupt BSP lump " + std::to_string(i) + ": " + path});
+            }
+        }
+        
+        // Texture lump: i32 count, count x i32 offset (-1 = empty), miptexes.
+        // A bad directory only costs the textures, not geometry or collision
+        const std::span<const u8> textures = getLumpBytes(LUMP_TEXTURES);
+        if (textures.size() >= sizeof(i32)) {
+            i32 count = 0;
+            std::memcpy(&count, textures.data(), sizeof(count));
+            if (count > 0 && count <= MAX_MIPTEX &&
+                (static_cast<size_t>(count) + 1) * sizeof(i32) <= textures.size()) {
+                m_miptexCount = count;
+            }
+        }
+        return {};
+    }
+    
+    /// Offset of a directory slot's miptex in the texture lump, -1 if empty or invalid
+    static i32 miptexOffset(std::span<const u8> lump, i32 index) {
+        i32 offset = 0;
+        std::memcpy(&offset, lump.data() + sizeof(i32) * (1 + static_cast<size_t>(index)), sizeof(offset));
+        if (offset < 0 || static_cast<size_t>(offset) + sizeof(BSPMiptex) > lump.size() ||
+            reinterpret_cast<std::uintptr_t>(lump.data() + offset) % alignof(BSPMiptex) != 0) {
+            return -1;
+        }
+        return offset;
+    }
+    
+    MappedFile m_file;
+    BSPHeader m_header{};
+    i32 m_miptexCount = 0;
+};
+
+} // namespace cscpp::assets::bsp
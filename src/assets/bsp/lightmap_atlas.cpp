@@ -0,0 +1,275 @@
+/**
+ * @file lightmap_atlas.cpp
+ * @brief Lightmap extents, skyline packing and atlas pages
+ */
+
+#include "assets/bsp/lightmap_atlas.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace cscpp::assets {
+
+/// BSPTextureInfo::flags bit of sky, water and other surfaces without a lightmap
+static constexpr i32 TEX_SPECIAL = 1;
+
+// ============================================================================
+// SkylinePacker
+// ============================================================================
+
+SkylinePacker::SkylinePacker(u32 width, u32 height)
+    : m_width(width)
+    , m_height(height)
+{
+    m_skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::insert(u32 width, u32 height, u32& x, u32& y) {
+    if (width == 0 || height == 0 || width > m_width || height > m_height) {
+        return false;
+    }
+    
+    // A rectangle starting at a segment rests on the highest segment under it
+    size_t best = m_skyline.size();
+    u32 bestY = 0;
+    for (size_t i = 0; i < m_skyline.size() && m_skyline[i].x + width <= m_width; ++i) {
+        const u32 left = m_skyline[i].x;
+        u32 top = 0;
+        for (size_t j = i; m_skyline[j].x < left + width; ++j) {
+            top = std::max(top, m_skyline[j].y);
+            if (j + 1 == m_skyline.size()) {
+                break;
+            }
+        }
+        if (top + height <= m_height && (best == m_skyline.size() || top < bestY)) {
+            best = i;
+            bestY = top;
+        }
+    }
+    if (best == m_skyline.size()) {
+        return false;
+    }
+    
+    // The rectangle's top replaces the segments it covers, a partly covered one keeps its right part
+    const u32 left = m_skyline[best].x;
+    const u32 right = left + width;
+    size_t end = best;
+    while (end < m_skyline.size() && m_skyline[end].x + m_skyline[end].width <= right) {
+        end++;
+    }
+    if (end < m_skyline.size() && m_skyline[end].x < right) {
+        Segment& rest = m_skyline[end];
+        rest.width -= right - rest.x;
+        rest.x = right;
+    }
+    m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(best),
+                    m_skyline.begin() + static_cast<std::ptrdiff_t>(end));
+    m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best), Segment{left, bestY + height, width});
+    
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            i++;
+        }
+    }
+    
+    x = left;
+    y = bestY;
+    return true;
+}
+
+// ============================================================================
+// LightmapAtlas
+// ============================================================================
+
+void LightmapAtlas::build(const bsp::BSPView& bsp) {
+    CSCPP_PROFILE_FUNCTION();
+    m_faces.clear();
+    m_packers.clear();
+    m_pages.clear();
+    
+    const auto faces = bsp.getLump<bsp::BSPFace>(bsp::LUMP_FACES);
+    const auto texInfos = bsp.getLump<bsp::BSPTextureInfo>(bsp::LUMP_TEXINFO);
+    const auto vertices = bsp.getLump<bsp::BSPVertex>(bsp::LUMP_VERTICES);
+    const auto edges = bsp.getLump<bsp::BSPEdge>(bsp::LUMP_EDGES);
+    const auto surfedges = bsp.getLump<i32>(bsp::LUMP_SURFEDGES);
+    const std::span<const u8> lighting = bsp.getLumpBytes(bsp::LUMP_LIGHTING);
+    
+    m_faces.resize(faces.size());
+    if (lighting.empty()) {
+        LOG_INFO("BSP has no lighting, the map is drawn unlit");
+        return;
+    }
+    
+    // Faces without light data sample the middle of one white block (their axes stay zero)
+    u32 whitePage = 0;
+    u32 whiteX = 0;
+    u32 whiteY = 0;
+    const u8 white[3] = {255, 255, 255};
+    place(1 + 2 * BORDER, 1 + 2 * BORDER, whitePage, whiteX, whiteY);
+    fill(whitePage, whiteX + BORDER, whiteY + BORDER, 1, 1, white);
+    
+    struct Block {
+        u32 face;
+        u32 width;
+        u32 height;
+    };
+    std::vector<Block> blocks;
+    blocks.reserve(faces.size());
+    
+    for (u32 faceIndex = 0; faceIndex < faces.size(); ++faceIndex) {
+        const bsp::BSPFace& face = faces[faceIndex];
+        FaceBlock& block = m_faces[faceIndex];
+        block.page = whitePage;
+        block.x = whiteX + BORDER;
+        block.y = whiteY + BORDER;
+        
+        if (face.textureInfo >= texInfos.size() || face.lightmapOffset < 0 || face.lightmapStyles[0] == 255 ||
+            face.numEdges < 3 || face.firstEdge < 0 ||
+            static_cast<size_t>(face.firstEdge) + face.numEdges > surfedges.size()) {
+            continue;
+        }
+        const bsp::BSPTextureInfo& texInfo = texInfos[face.textureInfo];
+        if (texInfo.flags & TEX_SPECIAL) {
+            continue;
+        }
+        
+        // Texture-space bounds in double precision, as the engine computes them
+        f64 mins[2] = {std::numeric_limits<f64>::max(), std::numeric_limits<f64>::max()};
+        f64 maxs[2] = {std::numeric_limits<f64>::lowest(), std::numeric_limits<f64>::lowest()};
+        bool valid = true;
+        for (u32 i = 0; i < face.numEdges && valid; ++i) {
+            const i32 edge = surfedges[static_cast<size_t>(face.firstEdge) + i];
+            const size_t edgeIndex = static_cast<size_t>(edge >= 0 ? edge : -static_cast<i64>(edge));
+            if (edgeIndex >= edges.size()) {
+                valid = false;
+                break;
+            }
+            const u16 vertex = edges[edgeIndex].vertexIndices[edge >= 0 ? 0 : 1];
+            if (vertex >= vertices.size()) {
+                valid = false;
+                break;
+            }
+            const f32* position = vertices[vertex].position;
+            for (i32 axis = 0; axis < 2; ++axis) {
+                const f32* vec = texInfo.vecs[axis];
+                const f64 value = static_cast<f64>(position[0]) * vec[0] + static_cast<f64>(position[1]) * vec[1] +
+                                  static_cast<f64>(position[2]) * vec[2] + vec[3];
+                mins[axis] = std::min(mins[axis], value);
+                maxs[axis] = std::max(maxs[axis], value);
+            }
+        }
+        if (!valid) {
+            continue;
+        }
+        
+        u32 size[2];
+        f32 origin[2];
+        for (i32 axis = 0; axis < 2; ++axis) {
+            const f64 low = std::floor(mins[axis] / LUXEL_SIZE);
+            const f64 high = std::ceil(maxs[axis] / LUXEL_SIZE);
+            size[axis] = static_cast<u32>(std::min(high - low + 1.0, static_cast<f64>(PAGE_SIZE)));
+            origin[axis] = static_cast<f32>(low * LUXEL_SIZE);
+        }
+        const u64 bytes = static_cast<u64>(size[0]) * size[1] * 3;
+        if (size[0] + 2 * BORDER > PAGE_SIZE || size[1] + 2 * BORDER > PAGE_SIZE ||
+            static_cast<u64>(face.lightmapOffset) + bytes > lighting.size()) {
+            continue;
+        }
+        
+        std::copy(&texInfo.vecs[0][0], &texInfo.vecs[0][0] + 8, &block.axes[0][0]);
+        block.mins[0] = origin[0];
+        block.mins[1] = origin[1];
+        blocks.push_back({faceIndex, size[0], size[1]});
+    }
+    
+    // Tallest first keeps the skyline flat
+    std::ranges::sort(blocks, [](const Block& a, const Block& b) {
+        return a.height != b.height ? a.height > b.height : a.width > b.width;
+    });
+    
+    for (const Block& entry : blocks) {
+        FaceBlock& block = m_faces[entry.face];
+        u32 page = 0;
+        u32 x = 0;
+        u32 y = 0;
+        if (!place(entry.width + 2 * BORDER, entry.height + 2 * BORDER, page, x, y)) {
+            block = FaceBlock{{}, {}, whitePage, whiteX + BORDER, whiteY + BORDER};
+            continue;
+        }
+        block.page = page;
+        block.x = x + BORDER;
+        block.y = y + BORDER;
+        fill(page, block.x, block.y, entry.width, entry.height,
+             lighting.data() + faces[entry.face].lightmapOffset);
+    }
+    
+    LOG_INFO("Packed {} face lightmaps into {} atlas page(s) of {}x{}", blocks.size(), m_pages.size(),
+             PAGE_SIZE, PAGE_SIZE);
+}
+
+Vec3 LightmapAtlas::getCoord(u32 face, const Vec3& position) const {
+    if (face >= m_faces.size()) {
+        return Vec3(0.0f);
+    }
+    const FaceBlock& block = m_faces[face];
+    const u32 origin[2] = {block.x, block.y};
+    f32 coord[2];
+    for (i32 axis = 0; axis < 2; ++axis) {
+        const f32* vec = block.axes[axis];
+        const f32 value = position.x * vec[0] + position.y * vec[1] + position.z * vec[2] + vec[3];
+        coord[axis] = (static_cast<f32>(origin[axis]) + (value - block.mins[axis]) / LUXEL_SIZE + 0.5f) / PAGE_SIZE;
+    }
+    return Vec3(coord[0], coord[1], static_cast<f32>(block.page));
+}
+
+std::vector<TextureImage> LightmapAtlas::takePages() {
+    m_packers.clear();
+    return std::move(m_pages);
+}
+
+bool LightmapAtlas::place(u32 width, u32 height, u32& page, u32& x, u32& y) {
+    for (page = 0; page < m_packers.size(); ++page) {
+        if (m_packers[page].insert(width, height, x, y)) {
+            return true;
+        }
+    }
+    
+    m_packers.emplace_back(PAGE_SIZE, PAGE_SIZE);
+    TextureImage& image = m_pages.emplace_back();
+    image.name = "lightmap" + std::to_string(page);
+    image.width = PAGE_SIZE;
+    image.height = PAGE_SIZE;
+    image.format = renderer::TextureFormat::RGBA8;
+    image.mipCount = 1;
+    image.pixels.assign(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE * 4, 0);
+    return m_packers.back().insert(width, height, x, y);
+}
+
+void LightmapAtlas::fill(u32 page, u32 x, u32 y, u32 width, u32 height, const u8* rgb) {
+    u8* pixels = m_pages[page].pixels.data();
+    const i32 border = static_cast<i32>(BORDER);
+    const i32 w = static_cast<i32>(width);
+    const i32 h = static_cast<i32>(height);
+    for (i32 row = -border; row < h + border; ++row) {
+        const i32 sourceRow = std::clamp(row, 0, h - 1);
+        for (i32 column = -border; column < w + border; ++column) {
+            const i32 sourceColumn = std::clamp(column, 0, w - 1);
+            const u8* source = rgb + (static_cast<size_t>(sourceRow) * width + static_cast<size_t>(sourceColumn)) * 3;
+            u8* target = pixels + ((static_cast<size_t>(static_cast<i32>(y) + row) * PAGE_SIZE) +
+                                   static_cast<size_t>(static_cast<i32>(x) + column)) * 4;
+            target[0] = source[0];
+            target[1] = source[1];
+            target[2] = source[2];
+            target[3] = 255;
+        }
+    }
+}
+
+} // namespace cscpp::assets
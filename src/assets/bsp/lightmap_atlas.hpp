@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file lightmap_atlas.hpp
+ * @brief BSP face lightmaps packed into a few large atlas pages
+ *
+ * GoldSrc stores one RGB luxel per 16x16 texels of a face's texture space
+ * in LUMP_LIGHTING, addressed by BSPFace::lightmapOffset. A face's block
+ * covers its texture-space bounds snapped outward to the luxel grid, plus
+ * one luxel (the engine's CalcSurfaceExtents); luxels sit on the grid
+ * points, so a point samples the block at (s - mins) / 16 + 0.5.
+ *
+ * Blocks are placed tallest first by a skyline packer into square pages,
+ * each with a one-luxel border copied from its edge so bilinear filtering
+ * never reaches a neighbouring face. Faces without light data (sky and
+ * other special surfaces, maps compiled without RAD) share one white
+ * block. Only the first light style is packed; switchable and animated
+ * styles are not applied.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/texture_image.hpp"
+#include <vector>
+
+namespace cscpp::assets {
+
+/**
+ * @brief Rectangle packer tracking the top edge of what it placed
+ *
+ * The skyline is a list of horizontal segments; a rectangle goes where
+ * its bottom ends up lowest, leftmost on ties. Space under an overhang is
+ * never reused, which costs little when rectangles arrive tallest first.
+ */
+class SkylinePacker {
+public:
+    SkylinePacker(u32 width, u32 height);
+    
+    /// Place a rectangle, false if it does not fit
+    bool insert(u32 width, u32 height, u32& x, u32& y);
+
+private:
+    struct Segment {
+        u32 x;
+        u32 y;
+        u32 width;
+    };
+    
+    std::vector<Segment> m_skyline;     // Left to right, covering the full width
+    u32 m_width;
+    u32 m_height;
+};
+
+class LightmapAtlas {
+public:
+    static constexpr u32 PAGE_SIZE = 1024;     ///< Luxels per page side
+    static constexpr u32 LUXEL_SIZE = 16;      ///< Texels per luxel
+    static constexpr u32 BORDER = 1;           ///< Luxels copied around each block
+    
+    /// Pack the lightmaps of every face of a BSP
+    void build(const bsp::BSPView& bsp);
+    
+    /**
+     * @brief Atlas coordinate of a point on a face
+     * @param position GoldSrc coordinates (before the mesh-space swap)
+     * @return xy normalized in the page, z the page
+     */
+    Vec3 getCoord(u32 face, const Vec3& position) const;
+    
+    /// Pages as RGBA8 images, moved out (getCoord() keeps working, nothing more can be placed)
+    std::vector<TextureImage> takePages();
+    
+    u32 getPageCount() const { return static_cast<u32>(m_pages.size()); }
+
+private:
+    /// Placement and texture axes of one face
+    struct FaceBlock {
+        f32 axes[2][4] = {};    ///< BSPTextureInfo::vecs
+        f32 mins[2] = {};       ///< Texture-space origin of the block (texels)
+        u32 page = 0;
+        u32 x = 0;              ///< Luxel (0, 0), inside the border
+        u32 y = 0;
+    };
+    
+    /// Reserve a block in the first page with room (a new one once all are full)
+    bool place(u32 width, u32 height, u32& page, u32& x, u32& y);
+    
+    /// Copy RGB luxels into a placed block and replicate its edges into the border
+    void fill(u32 page, u32 x, u32 y, u32 width, u32 height, const u8* rgb);
+    
+    std::vector<FaceBlock> m_faces;    // Indexed like LUMP_FACES
+    std::vector<SkylinePacker> m_packers;
+    std::vector<TextureImage> m_pages;
+};
+
+} // namespace cscpp::assets
@@ -1,15 +1,36 @@
 #include "assets/bsp/simple_bsp_loader.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "assets/cooked/cooked_map_writer.hpp"
+#include "assets/texture/block_compression.hpp"
+#include "assets/wad/palette_convert.hpp"
 #include "core/logging/logger.hpp"
-#include <glad/glad.h>
-#include <fstream>
+#include "core/memory/frame_arena.hpp"
+#include "core/profiling/profiler.hpp"
+#include "renderer/backend/gl_texture.hpp"
+#include <memory_resource>
 #include <unordered_map>
 #include <unordered_set>
 #include <cstring>
+#include <cmath>
 #include <algorithm>
 
 namespace cscpp::assets {
 
+static_assert(sizeof(cooked::CookedVertex) == sizeof(renderer::Vertex),
+              "Cooked vertices are uploaded as renderer::Vertex");
+
 Result<SimpleBSPMesh> SimpleBSPLoader::load(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
+    auto data = loadData(path);
+    if (!data) {
+        LOG_WARN("{}, using test mesh", data.error().message);
+        return createTestMesh();
+    }
+    return upload(std::move(*data));
+}
+
+Result<BSPMapData> SimpleBSPLoader::loadData(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
     LOG_INFO("Loading BSP map: {}", path);
     
     // Try multiple paths
@@ -22,174 +43,366 @@ Result<SimpleBSPMesh> SimpleBSPLoader::load(const std::string& path) {
         "../../assets/maps/de_dust2.bsp",
     };
     
-    std::ifstream file;
-    std::string foundPath;
+    bsp::BSPView view;
+    Result<void> opened = std::unexpected(Error{"No BSP path"});
     for (const auto& tryPath : tryPaths) {
-        file.open(tryPath, std::ios::binary);
-        if (file.is_open()) {
-            foundPath = tryPath;
+        opened = view.open(tryPath);
+        
+        // A cooked map next to the BSP skips all conversion, unless the BSP was rebuilt since
+        cooked::CookedMapView cookedView;
+        if (cookedView.open(cooked::cookedPathFor(tryPath))) {
+            if (!opened || cookedView.isCookedFrom(view)) {
+                auto cookedData = loadCooked(cookedView);
+                if (cookedData) {
+                    return cookedData;
+                }
+                LOG_WARN("Failed to load cooked map: {}", cookedData.error().message);
+            } else {
+                LOG_WARN("Cooked map {} is stale, loading the BSP instead", cookedView.getPath());
+            }
+        }
+        
+        if (opened) {
             break;
         }
     }
     
-    if (!file.is_open()) {
-        LOG_WARN("BSP file not found in any location, creating test mesh");
-        return createTestMesh();
+    if (!opened) {
+        return std::unexpected(Error{"BSP file not found in any location (" + opened.error().message + ")"});
     }
     
-    LOG_INFO("Found BSP file at: {}", foundPath);
-    
-    // Try to parse the BSP file
-    auto result = parseBSP(file, foundPath);
-    file.close();
+    LOG_INFO("Found BSP file at: {}", view.getPath());
     
+    // The mapping is released when the view goes out of scope
+    auto result = parseBSP(view);
     if (!result) {
-        LOG_WARN("Failed to parse BSP file: {}, using test mesh", result.error().message);
-        return createTestMesh();
+        return std::unexpected(Error{"Failed to parse BSP file: " + result.error().message});
     }
-    
     return result;
 }
 
-Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::string& path) {
-    SimpleBSPMesh mesh;
-    
-    // Read BSP header
-    bsp::BSPHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-    
-    if (!file.good() || file.gcount() != sizeof(header)) {
-        return std::unexpected(Error{"Failed to read BSP header"});
-    }
+SimpleBSPMesh SimpleBSPLoader::upload(BSPMapData&& data) {
+    CSCPP_PROFILE_FUNCTION();
+    SimpleBSPMesh mesh = std::move(data.mesh);
     
-    // Check BSP version (30 for GoldSrc)
-    if (header.version != 30) {
-        return std::unexpected(Error{"Unsupported BSP version: " + std::to_string(header.version)});
+    // Collision loads its own hulls from the BSP, the render copies are not needed once uploaded
+    for (auto& group : mesh.groups) {
+        group.mesh.create(group.vertices, group.indices);
+        group.vertices = {};
+        group.indices = {};
     }
     
-    LOG_INFO("BSP version: {}", header.version);
+    // Lightmaps are only drawn through the AssetManager's texture array path
+    mesh.lightmapPages = {};
     
-    // Log lump info for debugging
-    for (int i = 0; i < 15; ++i) {
-        if (header.lumps[i].length > 0) {
-            LOG_INFO("Lump {}: offset={}, length={}", i, header.lumps[i].offset, header.lumps[i].length);
+    // Must be done before assigning texture IDs to groups
+    for (const auto& entry : data.textures) {
+        u32 textureID = createTextureFromImage(*entry.image);
+        if (textureID != 0) {
+            // Map by miptex index (this is what BSPTextureInfo.miptex refers to)
+            mesh.textureMap[entry.miptexIndex] = textureID;
         }
     }
     
-    // Read vertices
-    std::vector<u8> vertexData;
-    if (!readLump(file, bsp::LUMP_VERTICES, header, vertexData)) {
-        return std::unexpected(Error{"Failed to read vertices lump"});
+    // Assign texture IDs to mesh groups
+    u32 groupsWithTextures = 0;
+    u32 groupsWithoutTextures = 0;
+    for (auto& group : mesh.groups) {
+        auto it = mesh.textureMap.find(group.miptexIndex);
+        if (it != mesh.textureMap.end()) {
+            group.textureID = it->second;
+            groupsWithTextures++;
+        } else {
+            // Texture not loaded (likely in WAD file)
+            group.textureID = 0;
+            groupsWithoutTextures++;
+            LOG_DEBUG("Mesh group with miptex index {} has no loaded texture (likely in WAD file)", group.miptexIndex);
+        }
     }
+    LOG_INFO("Texture assignment: {} groups have textures, {} groups missing textures (need WAD files)", 
+             groupsWithTextures, groupsWithoutTextures);
     
-    u32 vertexCount = static_cast<u32>(vertexData.size() / sizeof(bsp::BSPVertex));
-    LOG_INFO("BSP vertex count: {}", vertexCount);
+    mesh.loaded = true;
+    return mesh;
+}
+
+Result<BSPMapData> SimpleBSPLoader::parseBSP(const bsp::BSPView& bsp) {
+    CSCPP_PROFILE_FUNCTION();
+    BSPMapData data;
     
-    if (vertexCount == 0) {
-        return std::unexpected(Error{"BSP file has no vertices"});
+    if (auto built = buildGeometry(bsp, data.mesh); !built) {
+        return std::unexpected(built.error());
     }
     
-    // Read edges
-    std::vector<u8> edgeData;
-    if (!readLump(file, bsp::LUMP_EDGES, header, edgeData)) {
-        return std::unexpected(Error{"Failed to read edges lump"});
+    if (!bsp.getLump<bsp::BSPTextureInfo>(bsp::LUMP_TEXINFO).empty()) {
+        data.textures = loadTextures(bsp);
+    }
+    return data;
+}
+
+Result<BSPMapData> SimpleBSPLoader::loadCooked(const cooked::CookedMapView& view) {
+    CSCPP_PROFILE_FUNCTION();
+    LOG_INFO("Loading cooked map: {}", view.getPath());
+    BSPMapData data;
+    SimpleBSPMesh& mesh = data.mesh;
+    
+    const auto* info = view.getRecord<cooked::CookedMeshInfo>(cooked::SECTION_MESH_INFO);
+    const auto groups = view.getSection<cooked::CookedMeshGroup>(cooked::SECTION_MESH_GROUPS);
+    const auto vertices = view.getSection<cooked::CookedVertex>(cooked::SECTION_VERTICES);
+    const auto indices = view.getSection<u32>(cooked::SECTION_INDICES);
+    const auto textures = view.getSection<cooked::CookedTexture>(cooked::SECTION_TEXTURES);
+    const std::span<const u8> textureData = view.getSectionBytes(cooked::SECTION_TEXTURE_DATA);
+    const auto faces = view.getSection<cooked::CookedMeshFace>(cooked::SECTION_MESH_FACES);
+    const auto leaves = view.getSection<cooked::CookedRenderLeaf>(cooked::SECTION_RENDER_LEAVES);
+    const auto leafFaces = view.getSection<u32>(cooked::SECTION_LEAF_FACES);
+    const auto lightmaps = view.getSection<cooked::CookedTexture>(cooked::SECTION_LIGHTMAPS);
+    
+    if (!info || groups.empty()) {
+        return std::unexpected(Error{"Cooked map has no render mesh: " + view.getPath()});
+    }
+    
+    mesh.bounds.min = Vec3(info->boundsMin[0], info->boundsMin[1], info->boundsMin[2]);
+    mesh.bounds.max = Vec3(info->boundsMax[0], info->boundsMax[1], info->boundsMax[2]);
+    
+    // Buffers were built by cook(): copy out of the mapping, nothing else
+    for (const auto& g : groups) {
+        if (static_cast<u64>(g.firstVertex) + g.vertexCount > vertices.size() ||
+            static_cast<u64>(g.firstIndex) + g.indexCount > indices.size() ||
+            static_cast<u64>(g.firstFace) + g.faceCount > faces.size()) {
+            return std::unexpected(Error{"Corrupt cooked mesh group: " + view.getPath()});
+        }
+        
+        BSPMeshGroup group;
+        group.miptexIndex = g.miptexIndex;
+        group.textureID = 0;
+        group.vertices.resize(g.vertexCount);
+        std::memcpy(static_cast<void*>(group.vertices.data()), vertices.data() + g.firstVertex, g.vertexCount * sizeof(renderer::Vertex));
+        group.indices.assign(indices.begin() + g.firstIndex, indices.begin() + g.firstIndex + g.indexCount);
+        for (const auto& f : faces.subspan(g.firstFace, g.faceCount)) {
+            if (static_cast<u64>(f.firstIndex) + f.indexCount > g.indexCount) {
+                return std::unexpected(Error{"Corrupt cooked mesh face: " + view.getPath()});
+            }
+            group.faces.push_back({f.face, f.firstIndex, f.indexCount});
+        }
+        mesh.groups.push_back(std::move(group));
     }
     
-    u32 edgeCount = static_cast<u32>(edgeData.size() / sizeof(bsp::BSPEdge));
-    LOG_INFO("BSP edge count: {}", edgeCount);
+    // Leaf face lists for culling (a map cooked without them is drawn whole)
+    mesh.leaves.reserve(leaves.size());
+    for (const auto& l : leaves) {
+        if (static_cast<u64>(l.firstFace) + l.faceCount > leafFaces.size()) {
+            return std::unexpected(Error{"Corrupt cooked leaf: " + view.getPath()});
+        }
+        BSPRenderLeaf leaf;
+        leaf.bounds.min = Vec3(l.mins[0], l.mins[1], l.mins[2]);
+        leaf.bounds.max = Vec3(l.maxs[0], l.maxs[1], l.maxs[2]);
+        leaf.firstFace = l.firstFace;
+        leaf.faceCount = l.faceCount;
+        mesh.leaves.push_back(leaf);
+    }
+    mesh.leafFaces.assign(leafFaces.begin(), leafFaces.end());
+    
+    // Textures carry their full mip chains
+    const auto readImage = [&](const cooked::CookedTexture& t, TextureImage& image) {
+        if (t.dataOffset > textureData.size() || t.dataSize > textureData.size() - t.dataOffset ||
+            t.format > static_cast<u32>(renderer::TextureFormat::BC7)) {
+            return false;
+        }
+        image.name = std::string(t.name, sizeof(t.name)).c_str();
+        image.width = t.width;
+        image.height = t.height;
+        image.format = static_cast<renderer::TextureFormat>(t.format);
+        image.mipCount = t.mipCount;
+        const std::span<const u8> pixels = textureData.subspan(t.dataOffset, t.dataSize);
+        image.pixels.assign(pixels.begin(), pixels.end());
+        return true;
+    };
+    for (const auto& t : textures) {
+        auto image = std::make_shared<TextureImage>();
+        if (!readImage(t, *image)) {
+            return std::unexpected(Error{"Corrupt cooked texture: " + view.getPath()});
+        }
+        data.textures.push_back({t.miptexIndex, std::move(image)});
+    }
+    for (const auto& t : lightmaps) {
+        if (!readImage(t, mesh.lightmapPages.emplace_back())) {
+            return std::unexpected(Error{"Corrupt cooked lightmap: " + view.getPath()});
+        }
+    }
     
-    // Read surfedges
-    std::vector<u8> surfedgeData;
-    if (!readLump(file, bsp::LUMP_SURFEDGES, header, surfedgeData)) {
-        return std::unexpected(Error{"Failed to read surfedges lump"});
+    LOG_INFO("Loaded cooked map: {} mesh groups, {} vertices, {} indices, {} textures, {} leaves, {} lightmap pages",
+             mesh.groups.size(), vertices.size(), indices.size(), data.textures.size(), mesh.leaves.size(),
+             mesh.lightmapPages.size());
+    return data;
+}
+
+Result<void> SimpleBSPLoader::cook(const bsp::BSPView& bsp, cooked::CookedMapWriter& writer, bool compressTextures) {
+    CSCPP_PROFILE_FUNCTION();
+    SimpleBSPMesh mesh;
+    if (auto built = buildGeometry(bsp, mesh); !built) {
+        return built;
     }
     
-    u32 surfedgeCount = static_cast<u32>(surfedgeData.size() / sizeof(i32));
-    LOG_INFO("BSP surfedge count: {}", surfedgeCount);
+    // All groups share one vertex and one index section
+    std::vector<cooked::CookedMeshGroup> groups;
+    std::vector<cooked::CookedMeshFace> faces;
+    std::vector<cooked::CookedVertex> vertices;
+    std::vector<u32> indices;
+    for (const auto& group : mesh.groups) {
+        cooked::CookedMeshGroup g{};
+        g.miptexIndex = group.miptexIndex;
+        g.firstVertex = static_cast<u32>(vertices.size());
+        g.vertexCount = static_cast<u32>(group.vertices.size());
+        g.firstIndex = static_cast<u32>(indices.size());
+        g.indexCount = static_cast<u32>(group.indices.size());
+        g.firstFace = static_cast<u32>(faces.size());
+        g.faceCount = static_cast<u32>(group.faces.size());
+        groups.push_back(g);
+        
+        vertices.resize(vertices.size() + group.vertices.size());
+        std::memcpy(vertices.data() + g.firstVertex, group.vertices.data(), group.vertices.size() * sizeof(renderer::Vertex));
+        indices.insert(indices.end(), group.indices.begin(), group.indices.end());
+        for (const BSPFaceRange& face : group.faces) {
+            faces.push_back({face.face, face.firstIndex, face.indexCount});
+        }
+    }
     
-    // Read faces
-    std::vector<u8> faceData;
-    if (!readLump(file, bsp::LUMP_FACES, header, faceData)) {
-        return std::unexpected(Error{"Failed to read faces lump"});
+    std::vector<cooked::CookedRenderLeaf> leaves;
+    leaves.reserve(mesh.leaves.size());
+    for (const BSPRenderLeaf& leaf : mesh.leaves) {
+        cooked::CookedRenderLeaf l{};
+        for (i32 axis = 0; axis < 3; ++axis) {
+            l.mins[axis] = leaf.bounds.min[axis];
+            l.maxs[axis] = leaf.bounds.max[axis];
+        }
+        l.firstFace = leaf.firstFace;
+        l.faceCount = leaf.faceCount;
+        leaves.push_back(l);
     }
     
-    u32 faceCount = static_cast<u32>(faceData.size() / sizeof(bsp::BSPFace));
-    LOG_INFO("BSP face count: {}", faceCount);
+    // Textures: palette conversion done, full mip chains built here instead of on the GPU at load
+    std::vector<cooked::CookedTexture> textures;
+    std::vector<u8> textureData;
+    const auto appendTexture = [&](const TextureImage& image, i32 miptexIndex) {
+        cooked::CookedTexture t{};
+        std::strncpy(t.name, image.name.c_str(), sizeof(t.name) - 1);
+        t.miptexIndex = miptexIndex;
+        t.width = image.width;
+        t.height = image.height;
+        t.mipCount = image.mipCount;
+        t.format = static_cast<u32>(image.format);
+        t.dataOffset = textureData.size();
+        t.dataSize = image.pixels.size();
+        textureData.insert(textureData.end(), image.pixels.begin(), image.pixels.end());
+        return t;
+    };
+    if (!bsp.getLump<bsp::BSPTextureInfo>(bsp::LUMP_TEXINFO).empty()) {
+        for (const auto& entry : loadTextures(bsp)) {
+            // Cached WAD images are shared, mip into a copy
+            TextureImage image = *entry.image;
+            extendMipChain(image);
+            if (compressTextures) {
+                // Alpha-keyed textures need BC3's alpha block, BC1's 1-bit mode blurs the key at block edges
+                const bool alphaKeyed = isAlphaKeyedName(image.name.c_str());
+                auto compressed = compressImage(image, alphaKeyed ? renderer::TextureFormat::BC3 : renderer::TextureFormat::BC1);
+                if (!compressed) {
+                    return std::unexpected(compressed.error());
+                }
+                image = std::move(*compressed);
+            }
+            
+            textures.push_back(appendTexture(image, entry.miptexIndex));
+        }
+    }
     
-    if (faceCount == 0) {
-        return std::unexpected(Error{"BSP file has no faces"});
+    // Lightmap pages stay RGBA8: block compression would smear light across the atlas' face borders
+    std::vector<cooked::CookedTexture> lightmaps;
+    for (const TextureImage& page : mesh.lightmapPages) {
+        lightmaps.push_back(appendTexture(page, -1));
     }
     
-    // Parse vertices
-    const bsp::BSPVertex* bspVertices = reinterpret_cast<const bsp::BSPVertex*>(vertexData.data());
-    std::vector<Vec3> positions;
-    positions.reserve(vertexCount);
-    for (u32 i = 0; i < vertexCount; ++i) {
-        // Simple swap: GoldSrc (X,Y,Z) -> OpenGL (Z,Y,X)
-        // Transformation matrix applied in render function handles final orientation
-        positions.push_back(Vec3(
-            bspVertices[i].position[2],   // GoldSrc Z -> OpenGL X
-            bspVertices[i].position[1],   // GoldSrc Y -> OpenGL Y (up stays up)
-            bspVertices[i].position[0]    // GoldSrc X -> OpenGL Z
-        ));
+    cooked::CookedMeshInfo info{};
+    for (i32 axis = 0; axis < 3; ++axis) {
+        info.boundsMin[axis] = mesh.bounds.min[axis];
+        info.boundsMax[axis] = mesh.bounds.max[axis];
     }
     
-    // Read planes for normal calculation
-    std::vector<u8> planeData;
-    if (!readLump(file, bsp::LUMP_PLANES, header, planeData)) {
-        return std::unexpected(Error{"Failed to read planes lump"});
+    const std::span<const u8> entities = bsp.getLumpBytes(bsp::LUMP_ENTITIES);
+    writer.setSection(cooked::SECTION_ENTITIES, entities);
+    writer.setRecord(cooked::SECTION_MESH_INFO, info);
+    writer.setSection(cooked::SECTION_MESH_GROUPS, std::span<const cooked::CookedMeshGroup>(groups));
+    writer.setSection(cooked::SECTION_VERTICES, std::span<const cooked::CookedVertex>(vertices));
+    writer.setSection(cooked::SECTION_INDICES, std::span<const u32>(indices));
+    writer.setSection(cooked::SECTION_TEXTURES, std::span<const cooked::CookedTexture>(textures));
+    writer.setSection(cooked::SECTION_TEXTURE_DATA, std::span<const u8>(textureData));
+    writer.setSection(cooked::SECTION_MESH_FACES, std::span<const cooked::CookedMeshFace>(faces));
+    writer.setSection(cooked::SECTION_RENDER_LEAVES, std::span<const cooked::CookedRenderLeaf>(leaves));
+    writer.setSection(cooked::SECTION_LEAF_FACES, std::span<const u32>(mesh.leafFaces));
+    writer.setSection(cooked::SECTION_LIGHTMAPS, std::span<const cooked::CookedTexture>(lightmaps));
+    
+    LOG_INFO("Cooked render mesh: {} groups, {} vertices, {} indices, {} textures ({} KB), {} leaves, "
+             "{} lightmap pages", groups.size(), vertices.size(), indices.size(), textures.size(),
+             textureData.size() / 1024, leaves.size(), lightmaps.size());
+    return {};
+}
+
+Result<void> SimpleBSPLoader::buildGeometry(const bsp::BSPView& bsp, SimpleBSPMesh& mesh) {
+    CSCPP_PROFILE_FUNCTION();
+    
+    // Header, lump bounds and record sizes were validated when the view was opened
+    const bsp::BSPHeader& header = bsp.getHeader();
+    LOG_INFO("BSP version: {}", header.version);
+    
+    // Log lump info for debugging
+    for (int i = 0; i < bsp::BSPView::LUMP_COUNT; ++i) {
+        if (header.lumps[i].length > 0) {
+            LOG_INFO("Lump {}: offset={}, length={}", i, header.lumps[i].offset, header.lumps[i].length);
+        }
     }
     
-    u32 planeCount = static_cast<u32>(planeData.size() / sizeof(bsp::BSPPlane));
-    LOG_INFO("BSP plane count: {}", planeCount);
+    const auto vertices = bsp.getLump<bsp::BSPVertex>(bsp::LUMP_VERTICES);
+    const auto edges = bsp.getLump<bsp::BSPEdge>(bsp::LUMP_EDGES);
+    const auto surfedges = bsp.getLump<i32>(bsp::LUMP_SURFEDGES);
+    const auto faces = bsp.getLump<bsp::BSPFace>(bsp::LUMP_FACES);
+    const auto planes = bsp.getLump<bsp::BSPPlane>(bsp::LUMP_PLANES);
+    const auto texInfoLump = bsp.getLump<bsp::BSPTextureInfo>(bsp::LUMP_TEXINFO);
     
-    const bsp::BSPPlane* planes = reinterpret_cast<const bsp::BSPPlane*>(planeData.data());
+    const u32 vertexCount = static_cast<u32>(vertices.size());
+    const u32 edgeCount = static_cast<u32>(edges.size());
+    const u32 surfedgeCount = static_cast<u32>(surfedges.size());
+    const u32 faceCount = static_cast<u32>(faces.size());
+    const u32 planeCount = static_cast<u32>(planes.size());
+    LOG_INFO("BSP counts: {} vertices, {} edges, {} surfedges, {} faces, {} planes",
+             vertexCount, edgeCount, surfedgeCount, faceCount, planeCount);
     
-    // Read texture info for texture coordinates
-    std::vector<u8> texInfoData;
-    if (!readLump(file, bsp::LUMP_TEXINFO, header, texInfoData)) {
-        LOG_WARN("Failed to read texture info lump, textures will not be available");
+    if (vertexCount == 0) {
+        return std::unexpected(Error{"BSP file has no vertices"});
+    }
+    if (faceCount == 0) {
+        return std::unexpected(Error{"BSP file has no faces"});
     }
     
     u32 texInfoCount = 0;
     const bsp::BSPTextureInfo* texInfos = nullptr;
-    if (!texInfoData.empty()) {
-        texInfoCount = static_cast<u32>(texInfoData.size() / sizeof(bsp::BSPTextureInfo));
+    if (!texInfoLump.empty()) {
+        texInfoCount = static_cast<u32>(texInfoLump.size());
         LOG_INFO("BSP texture info count: {}", texInfoCount);
-        texInfos = reinterpret_cast<const bsp::BSPTextureInfo*>(texInfoData.data());
+        texInfos = texInfoLump.data();
+    } else {
+        LOG_WARN("BSP has no texture info, textures will not be available");
     }
     
-    // Read texture lump to get texture dimensions for proper texture coordinate calculation
-    std::vector<u8> textureData;
-    bsp::BSPHeader nonConstHeader = header;  // Make a copy for readLump
+    // Texture dimensions for texture coordinates, straight from the miptex headers
     std::unordered_map<i32, std::pair<u32, u32>> textureSizes;  // miptex index -> (width, height)
-    
-    if (readLump(file, bsp::LUMP_TEXTURES, nonConstHeader, textureData) && !textureData.empty()) {
-        const i32* numTexturesPtr = reinterpret_cast<const i32*>(textureData.data());
-        i32 numTextures = *numTexturesPtr;
-        
-        if (numTextures > 0 && numTextures <= 1024) {
-            const i32* offsets = reinterpret_cast<const i32*>(textureData.data() + sizeof(i32));
-            
-            for (i32 i = 0; i < numTextures; ++i) {
-                if (offsets[i] != -1) {
-                    const bsp::BSPMiptex* miptex = reinterpret_cast<const bsp::BSPMiptex*>(
-                        textureData.data() + offsets[i]
-                    );
-                    if (miptex->width > 0 && miptex->height > 0 && 
-                        miptex->width <= 1024 && miptex->height <= 1024) {
-                        textureSizes[i] = std::make_pair(miptex->width, miptex->height);
-                    }
-                }
+    for (i32 i = 0; i < bsp.getMiptexCount(); ++i) {
+        if (const bsp::BSPMiptex* miptex = bsp.getMiptex(i)) {
+            if (miptex->width > 0 && miptex->height > 0 &&
+                miptex->width <= 1024 && miptex->height <= 1024) {
+                textureSizes[i] = std::make_pair(miptex->width, miptex->height);
             }
-            LOG_INFO("Loaded {} texture dimensions for coordinate calculation", textureSizes.size());
         }
     }
-    
-    // Parse edges
-    const bsp::BSPEdge* edges = reinterpret_cast<const bsp::BSPEdge*>(edgeData.data());
-    const i32* surfedges = reinterpret_cast<const i32*>(surfedgeData.data());
-    const bsp::BSPFace* faces = reinterpret_cast<const bsp::BSPFace*>(faceData.data());
+    LOG_INFO("Loaded {} texture dimensions for coordinate calculation", textureSizes.size());
     
     // Group faces by miptex index (texture)
     // Map: miptex index -> vector of face indices
@@ -211,7 +424,14 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
     
     LOG_INFO("Grouped {} faces into {} texture groups", faceCount, facesByTexture.size());
     
+    // Lightmap blocks of every face, the vertices get their atlas coordinates below
+    LightmapAtlas lightmaps;
+    lightmaps.build(bsp);
+    
     // Convert BSP faces to triangles, grouped by texture
+    // Per-face scratch, rewound for every face (a face has at most a few dozen edges)
+    FrameArena faceArena(4096);
+    
     // Process each face group
     for (const auto& [miptexIndex, faceIndices] : facesByTexture) {
         BSPMeshGroup group;
@@ -225,7 +445,7 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
             const bsp::BSPFace& face = faces[faceIdx];
             
             if (face.numEdges < 3) continue;
-        
+            
             // Get face normal from plane
             // Apply same swap as vertices: GoldSrc (X,Y,Z) -> OpenGL (Z,Y,X)
             // Transformation matrix in render function handles final orientation
@@ -241,13 +461,21 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
             }
             
             // Get face vertices from edges
-            std::vector<u16> faceVertexIndices;
+            faceArena.reset();
+            std::pmr::vector<u16> faceVertexIndices(&faceArena);
             faceVertexIndices.reserve(face.numEdges);
             
+            if (face.firstEdge < 0 || static_cast<u32>(face.firstEdge) + face.numEdges > surfedgeCount) {
+                continue;
+            }
+            
             for (u16 i = 0; i < face.numEdges; ++i) {
                 i32 edgeIdx = surfedges[face.firstEdge + i];
                 u16 v0, v1;
                 
+                if (edgeIdx >= static_cast<i32>(edgeCount) || -edgeIdx >= static_cast<i32>(edgeCount)) {
+                    continue;
+                }
                 if (edgeIdx >= 0) {
                     v0 = edges[edgeIdx].vertexIndices[0];
                     v1 = edges[edgeIdx].vertexIndices[1];
@@ -267,6 +495,7 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
             
             // Triangulate the face (fan triangulation)
             if (faceVertexIndices.size() >= 3) {
+                const u32 firstIndex = static_cast<u32>(renderIndices.size());
                 u32 baseIndex = static_cast<u32>(renderVertices.size());
                 
                 // Calculate texture coordinates from texture info
@@ -299,9 +528,13 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
                 for (u16 vIdx : faceVertexIndices) {
                     if (vIdx >= vertexCount) continue;
                     
+                    // Simple swap: GoldSrc (X,Y,Z) -> OpenGL (Z,Y,X)
+                    // Transformation matrix applied in render function handles final orientation
+                    const f32* position = vertices[vIdx].position;
                     renderer::Vertex v;
-                    v.position = positions[vIdx];
+                    v.position = Vec3(position[2], position[1], position[0]);
                     v.normal = faceNormal;  // Use plane normal
+                    v.lightmapCoord = lightmaps.getCoord(faceIdx, Vec3(position[0], position[1], position[2]));
                     
                     if (hasTexCoords) {
                         // Calculate texture coordinates from texture vectors
@@ -339,20 +572,35 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
                     renderVertices.push_back(v);
                 }
                 
+                // Textures repeat: shift the face's coordinates by whole tiles to next to zero,
+                // where the half floats of renderer::PackedVertex are precise
+                if (hasTexCoords && baseIndex < renderVertices.size()) {
+                    Vec2 minCoord = renderVertices[baseIndex].texCoord;
+                    for (size_t i = baseIndex; i < renderVertices.size(); ++i) {
+                        minCoord = glm::min(minCoord, renderVertices[i].texCoord);
+                    }
+                    const Vec2 tiles(std::floor(minCoord.x), std::floor(minCoord.y));
+                    for (size_t i = baseIndex; i < renderVertices.size(); ++i) {
+                        renderVertices[i].texCoord -= tiles;
+                    }
+                }
+                
                 // Create triangles (fan)
                 for (u32 i = 1; i + 1 < faceVertexIndices.size(); ++i) {
                     renderIndices.push_back(baseIndex);
                     renderIndices.push_back(baseIndex + i);
                     renderIndices.push_back(baseIndex + i + 1);
                 }
+                
+                // Leaves reference faces, culling draws these ranges
+                group.faces.push_back({faceIdx, firstIndex, static_cast<u32>(renderIndices.size()) - firstIndex});
             }
         }
         
-        // Create mesh for this texture group
+        // Keep the group if any of its faces produced triangles (uploaded by the caller)
         if (!renderVertices.empty()) {
             group.vertices = std::move(renderVertices);
             group.indices = std::move(renderIndices);
-            group.mesh.create(group.vertices, group.indices);
             mesh.groups.push_back(std::move(group));
         }
     }
@@ -395,70 +643,50 @@ Result<SimpleBSPMesh> SimpleBSPLoader::parseBSP(std::ifstream& file, const std::
              mesh.bounds.min.x, mesh.bounds.min.y, mesh.bounds.min.z,
              mesh.bounds.max.x, mesh.bounds.max.y, mesh.bounds.max.z);
     
-    // Load textures from BSP (must be done before assigning texture IDs to groups)
-    if (texInfos != nullptr && texInfoCount > 0) {
-        loadTextures(file, header, mesh, texInfos, texInfoCount, path);
-    }
-    
-    // Assign texture IDs to mesh groups
-    u32 groupsWithTextures = 0;
-    u32 groupsWithoutTextures = 0;
-    for (auto& group : mesh.groups) {
-        auto it = mesh.textureMap.find(group.miptexIndex);
-        if (it != mesh.textureMap.end()) {
-            group.textureID = it->second;
-            groupsWithTextures++;
-        } else {
-            // Texture not loaded (likely in WAD file)
-            group.textureID = 0;
-            groupsWithoutTextures++;
-            LOG_DEBUG("Mesh group with miptex index {} has no loaded texture (likely in WAD file)", group.miptexIndex);
-        }
-    }
-    LOG_INFO("Texture assignment: {} groups have textures, {} groups missing textures (need WAD files)", 
-             groupsWithTextures, groupsWithoutTextures);
-    
-    mesh.loaded = true;
-    
-    return mesh;
+    mesh.lightmapPages = lightmaps.takePages();
+    buildLeaves(bsp, mesh);
+    return {};
 }
 
-bool SimpleBSPLoader::readLump(std::ifstream& file, bsp::BSPLumpType lumpType, 
-                                bsp::BSPHeader& header, std::vector<u8>& data) {
-    i32 lumpIdx = static_cast<i32>(lumpType);
-    if (lumpIdx < 0 || lumpIdx >= 15) {
-        LOG_ERROR("Invalid lump type: {}", lumpIdx);
-        return false;
-    }
-    
-    const bsp::BSPLump& lump = header.lumps[lumpIdx];
-    i32 offset = lump.offset;
-    i32 length = lump.length;
-    
-    LOG_INFO("Reading lump {}: offset={}, length={}", lumpIdx, offset, length);
-    
-    if (offset <= 0 || length <= 0) {
-        LOG_WARN("Lump {} has invalid offset/length: offset={}, length={}", lumpIdx, offset, length);
-        return false;
-    }
-    
-    file.seekg(offset, std::ios::beg);
-    if (!file.good()) {
-        LOG_ERROR("Failed to seek to lump {} offset {}", lumpIdx, offset);
-        return false;
-    }
-    
-    data.resize(length);
-    file.read(reinterpret_cast<char*>(data.data()), length);
-    
-    i32 bytesRead = static_cast<i32>(file.gcount());
-    if (!file.good() || bytesRead != length) {
-        LOG_ERROR("Failed to read lump {}: expected {} bytes, got {}", lumpIdx, length, bytesRead);
-        return false;
+void SimpleBSPLoader::buildLeaves(const bsp::BSPView& bsp, SimpleBSPMesh& mesh) {
+    CSCPP_PROFILE_FUNCTION();
+    const auto leaves = bsp.getLump<bsp::BSPLeaf>(bsp::LUMP_LEAVES);
+    const auto markSurfaces = bsp.getLump<u16>(bsp::LUMP_MARKSURFACES);
+    const u32 faceCount = static_cast<u32>(bsp.getLump<bsp::BSPFace>(bsp::LUMP_FACES).size());
+    
+    mesh.leaves.clear();
+    mesh.leafFaces.clear();
+    if (leaves.empty()) {
+        LOG_WARN("BSP has no leaves, the map is drawn without culling");
+        return;
+    }
+    
+    mesh.leaves.reserve(leaves.size());
+    mesh.leafFaces.reserve(markSurfaces.size());
+    for (const bsp::BSPLeaf& leaf : leaves) {
+        if (static_cast<size_t>(leaf.firstMarkSurface) + leaf.numMarkSurfaces > markSurfaces.size()) {
+            LOG_WARN("Corrupt leaf face list, the map is drawn without culling");
+            mesh.leaves.clear();
+            mesh.leafFaces.clear();
+            return;
+        }
+        
+        // Same swap as the vertices: GoldSrc (X,Y,Z) -> OpenGL (Z,Y,X)
+        BSPRenderLeaf renderLeaf;
+        renderLeaf.bounds.min = Vec3(leaf.mins[2], leaf.mins[1], leaf.mins[0]);
+        renderLeaf.bounds.max = Vec3(leaf.maxs[2], leaf.maxs[1], leaf.maxs[0]);
+        renderLeaf.firstFace = static_cast<u32>(mesh.leafFaces.size());
+        for (u32 i = 0; i < leaf.numMarkSurfaces; ++i) {
+            const u16 face = markSurfaces[leaf.firstMarkSurface + i];
+            if (face < faceCount) {
+                mesh.leafFaces.push_back(face);
+            }
+        }
+        renderLeaf.faceCount = static_cast<u32>(mesh.leafFaces.size()) - renderLeaf.firstFace;
+        mesh.leaves.push_back(renderLeaf);
     }
     
-    LOG_INFO("Successfully read lump {}: {} bytes", lumpIdx, length);
-    return true;
+    LOG_INFO("Extracted {} leaves with {} face references for culling", mesh.leaves.size(), mesh.leafFaces.size());
 }
 
 SimpleBSPMesh SimpleBSPLoader::createTestMesh() {
@@ -489,54 +717,31 @@ SimpleBSPMesh SimpleBSPLoader::createTestMesh() {
     return mesh;
 }
 
-bool SimpleBSPLoader::loadTextures(std::ifstream& file, const bsp::BSPHeader& header, 
-                                    SimpleBSPMesh& mesh, const bsp::BSPTextureInfo* texInfos, u32 texInfoCount,
-                                    const std::string& path) {
-    (void)texInfos;      // Will be used for WAD loading later
-    (void)texInfoCount;  // Will be used for WAD loading later
-    
-    // Read texture lump
-    std::vector<u8> textureData;
-    bsp::BSPHeader nonConstHeader = header;  // Make a copy for readLump
-    if (!readLump(file, bsp::LUMP_TEXTURES, nonConstHeader, textureData)) {
-        LOG_WARN("Failed to read texture lump, textures will not be available");
-        return false;
-    }
-    
-    LOG_INFO("Texture lump size: {} bytes", textureData.size());
-    
-    if (textureData.empty()) {
-        LOG_WARN("Texture lump is empty");
-        return false;
-    }
+std::vector<BSPTextureImage> SimpleBSPLoader::loadTextures(const bsp::BSPView& bsp) {
+    CSCPP_PROFILE_FUNCTION();
+    std::vector<BSPTextureImage> textures;
     
-    // First 4 bytes: number of textures
-    const i32* numTexturesPtr = reinterpret_cast<const i32*>(textureData.data());
-    i32 numTextures = *numTexturesPtr;
+    const std::string& path = bsp.getPath();
+    const i32 numTextures = bsp.getMiptexCount();
+    LOG_INFO("Texture lump size: {} bytes", bsp.getLumpBytes(bsp::LUMP_TEXTURES).size());
     
-    if (numTextures <= 0 || numTextures > 1024) {  // Sanity check
-        LOG_WARN("Invalid texture count: {}", numTextures);
-        return false;
+    if (numTextures <= 0) {
+        LOG_WARN("Texture lump is empty or invalid, textures will not be available");
+        return textures;
     }
     
     LOG_INFO("BSP contains {} textures", numTextures);
     
-    // Array of offsets follows
-    const i32* offsets = reinterpret_cast<const i32*>(textureData.data() + sizeof(i32));
-    
-    // Load each texture
-    // Map miptex index to OpenGL texture ID
+    // Convert each embedded texture
     for (i32 i = 0; i < numTextures; ++i) {
-        if (offsets[i] == -1) {
+        // Miptex header and everything after it in the lump, read in place
+        const std::span<const u8> miptexBytes = bsp.getMiptexBytes(i);
+        if (miptexBytes.empty()) {
             // Empty texture slot - texture is in WAD file, not embedded
             LOG_DEBUG("Texture slot {} is empty (likely in WAD file)", i);
             continue;
         }
-        
-        // Read miptex header
-        const bsp::BSPMiptex* miptex = reinterpret_cast<const bsp::BSPMiptex*>(
-            textureData.data() + offsets[i]
-        );
+        const bsp::BSPMiptex* miptex = reinterpret_cast<const bsp::BSPMiptex*>(miptexBytes.data());
         
         if (miptex->width == 0 || miptex->height == 0 || 
             miptex->width > 1024 || miptex->height > 1024) {
@@ -551,46 +756,36 @@ bool SimpleBSPLoader::loadTextures(std::ifstream& file, const bsp::BSPHeader& he
             continue;
         }
         
-        // Calculate absolute offset: miptex pointer + offset
-        const u8* miptexBase = reinterpret_cast<const u8*>(miptex);
-        const u8* pixelData = miptexBase + miptex->offsets[0];
-        u32 pixelCount = miptex->width * miptex->height;
-        
-        // Verify we have enough data
-        u32 expectedDataSize = pixelCount;  // 8-bit indexed color
-        if (miptex->offsets[0] + expectedDataSize > textureData.size()) {
+        // Offsets are relative to the miptex, and so is the span
+        auto image = std::make_shared<const TextureImage>(decodeMiptex(miptexBytes));
+        if (image->pixels.empty()) {
             LOG_WARN("Texture {} '{}' pixel data extends beyond texture lump", i, miptex->name);
             continue;
         }
-        
-        // Create OpenGL texture
-        u32 textureID = createTextureFromMiptex(*miptex, pixelData, pixelCount);
-        if (textureID != 0) {
-            // Map by miptex index (this is what BSPTextureInfo.miptex refers to)
-            mesh.textureMap[i] = textureID;
-            LOG_INFO("Loaded embedded texture {}: '{}' {}x{} (ID: {})", 
-                     i, miptex->name, miptex->width, miptex->height, textureID);
-        }
+        textures.push_back({i, std::move(image)});
+        LOG_INFO("Loaded embedded texture {}: '{}' {}x{}", i, miptex->name, miptex->width, miptex->height);
     }
     
-    LOG_INFO("Loaded {} embedded textures from BSP (out of {} total)", mesh.textureMap.size(), numTextures);
+    LOG_INFO("Loaded {} embedded textures from BSP (out of {} total)", textures.size(), numTextures);
     
     // Collect texture names and miptex indices for WAD loading
     // Map: texture name -> miptex index
     std::unordered_map<std::string, i32> textureNameToIndex;
     std::vector<std::string> missingTextureNames;
     
+    std::unordered_set<i32> embedded;
+    for (const auto& image : textures) {
+        embedded.insert(image.miptexIndex);
+    }
+    
     for (i32 i = 0; i < numTextures; ++i) {
-        if (offsets[i] == -1) {
+        // Read miptex header to get texture name
+        const bsp::BSPMiptex* miptex = bsp.getMiptex(i);
+        if (miptex == nullptr) {
             // Empty texture slot - skip
             continue;
         }
         
-        // Read miptex header to get texture name
-        const bsp::BSPMiptex* miptex = reinterpret_cast<const bsp::BSPMiptex*>(
-            textureData.data() + offsets[i]
-        );
-        
         std::string texName(miptex->name, 16);
         // Trim null characters
         texName = texName.c_str();
@@ -598,7 +793,7 @@ bool SimpleBSPLoader::loadTextures(std::ifstream& file, const bsp::BSPHeader& he
         textureNameToIndex[texName] = i;
         
         // If texture wasn't loaded (no embedded data), add to missing list
-        if (mesh.textureMap.find(i) == mesh.textureMap.end()) {
+        if (embedded.find(i) == embedded.end()) {
             missingTextureNames.push_back(texName);
         }
     }
@@ -606,219 +801,16 @@ bool SimpleBSPLoader::loadTextures(std::ifstream& file, const bsp::BSPHeader& he
     // Load missing textures from WAD files
     if (!missingTextureNames.empty()) {
         LOG_INFO("Attempting to load {} missing textures from WAD files", missingTextureNames.size());
-        
-        // Try to find BSP file directory
-        std::string bspDir = path;
-        size_t lastSlash = bspDir.find_last_of("/\\");
-        if (lastSlash != std::string::npos) {
-            bspDir = bspDir.substr(0, lastSlash + 1);
-        } else {
-            bspDir = "";
-        }
-        
-        // Try common WAD file names
-        std::vector<std::string> wadFiles = {
-            bspDir + "halflife.wad",
-            bspDir + "decals.wad",
-            bspDir + "cs_dust.wad",
-            "assets/maps/halflife.wad",
-            "assets/maps/decals.wad",
-            "assets/maps/cs_dust.wad"
-        };
-        
-        loadWADTextures(path, mesh, missingTextureNames, textureNameToIndex);
-    }
-    
-    return true;
-}
-
-// Loaded palette from palette.lmp file
-static u8 g_palette[256][3] = {0};
-static bool g_paletteLoaded = false;
-
-// Load palette from palette.lmp file (256 colors * 3 bytes RGB = 768 bytes)
-static bool loadPalette() {
-    if (g_paletteLoaded) {
-        return true;
-    }
-    
-    // Try multiple paths to find palette.lmp
-    std::vector<std::string> tryPaths = {
-        "assets/gfx/palette.lmp",
-        "../assets/gfx/palette.lmp",
-        "../../assets/gfx/palette.lmp",
-        "../../../assets/gfx/palette.lmp",
-        "gfx/palette.lmp"
-    };
-    
-    std::string foundPath;
-    std::ifstream file;
-    for (const auto& path : tryPaths) {
-        file.open(path, std::ios::binary);
-        if (file.is_open()) {
-            foundPath = path;
-            break;
-        }
-    }
-    
-    if (!file.is_open()) {
-        LOG_ERROR("Failed to find palette.lmp file. Tried: {}", tryPaths[0]);
-        return false;
-    }
-    
-    // Read palette data (768 bytes: 256 colors * 3 bytes RGB)
-    file.read(reinterpret_cast<char*>(g_palette), 256 * 3);
-    
-    if (!file.good() || file.gcount() != 768) {
-        LOG_ERROR("Failed to read palette.lmp: expected 768 bytes, got {}", file.gcount());
-        file.close();
-        return false;
-    }
-    
-    file.close();
-    g_paletteLoaded = true;
-    LOG_INFO("Loaded palette from: {}", foundPath);
-    return true;
-}
-
-u32 SimpleBSPLoader::createTextureFromMiptex(const bsp::BSPMiptex& miptex, const u8* data, u32 dataSize) {
-    // Load palette if not already loaded
-    if (!loadPalette()) {
-        LOG_WARN("Using fallback grayscale conversion - palette not loaded");
-    }
-    u32 textureID = 0;
-    glGenTextures(1, &textureID);
-    if (textureID == 0) {
-        LOG_ERROR("Failed to generate texture");
-        return 0;
-    }
-    
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    // GoldSrc textures are 8-bit indexed color (palette-based)
-    // Convert indexed color to RGB using the standard Quake/Half-Life palette
-    std::vector<u8> rgbData(miptex.width * miptex.height * 3);
-    u32 pixelCount = miptex.width * miptex.height;
-    
-    // Check if we have enough data
-    if (dataSize < pixelCount) {
-        LOG_WARN("Texture data size {} is less than expected {} pixels", dataSize, pixelCount);
+        loadWADTextures(path, textures, missingTextureNames, textureNameToIndex);
     }
     
-    // Convert indexed colors to RGB using the palette
-    for (u32 i = 0; i < pixelCount && i < dataSize; ++i) {
-        u8 index = data[i];
-        
-        // Use the palette to get RGB values
-        // Index 255 is typically transparent, but we'll render it as the palette color
-        if (g_paletteLoaded) {
-            const u8* paletteColor = g_palette[index];
-            rgbData[i * 3 + 0] = paletteColor[0];  // R
-            rgbData[i * 3 + 1] = paletteColor[1];  // G
-            rgbData[i * 3 + 2] = paletteColor[2];  // B
-        } else {
-            // Fallback: grayscale conversion if palette not loaded
-            rgbData[i * 3 + 0] = index;
-            rgbData[i * 3 + 1] = index;
-            rgbData[i * 3 + 2] = index;
-        } 
-    }
-    
-    // Verify texture has non-zero data
-    u32 nonZeroPixels = 0;
-    for (u32 i = 0; i < pixelCount; ++i) {
-        if (rgbData[i * 3] > 0 || rgbData[i * 3 + 1] > 0 || rgbData[i * 3 + 2] > 0) {
-            nonZeroPixels++;
-        }
-    }
-    
-    // Log sample pixels for debugging
-    if (pixelCount > 10) {
-        LOG_INFO("Texture '{}' - non-zero pixels: {}/{} ({:.1f}%), sample - first: index={}, RGB=({},{},{}), middle: index={}, RGB=({},{},{})", 
-                 miptex.name, nonZeroPixels, pixelCount, (100.0f * nonZeroPixels / pixelCount),
-                 data[0], rgbData[0], rgbData[1], rgbData[2],
-                 data[pixelCount/2], rgbData[(pixelCount/2)*3], rgbData[(pixelCount/2)*3+1], rgbData[(pixelCount/2)*3+2]);
-    }
-    
-    if (nonZeroPixels == 0) {
-        LOG_WARN("Texture '{}' has no non-zero pixels! Texture may appear black.", miptex.name);
-    }
-    
-    // Set pixel storage parameters for optimal quality
-    // Ensure proper alignment for RGB data (3 bytes per pixel)
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // No padding needed for RGB
-    
-    // Upload texture data with explicit internal format for better quality
-    // Use GL_RGB8 instead of GL_RGB for explicit 8-bit per channel
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, miptex.width, miptex.height, 0, 
-                 GL_RGB, GL_UNSIGNED_BYTE, rgbData.data());
-    
-    // Check for errors
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) {
-        LOG_ERROR("OpenGL error uploading texture '{}': 0x{:X}", miptex.name, static_cast<u32>(err));
-    }
-    
-    // Generate high-quality mipmaps for better quality when textures are viewed at distance
-    // This creates multiple resolution levels automatically
-    glGenerateMipmap(GL_TEXTURE_2D);
-    
-    err = glGetError();
-    if (err != GL_NO_ERROR) {
-        LOG_WARN("OpenGL error generating mipmaps for '{}': 0x{:X}", miptex.name, static_cast<u32>(err));
-    }
-    
-    // Set texture parameters for maximum quality filtering
-    // Use trilinear filtering (GL_LINEAR_MIPMAP_LINEAR) for minification - smooth interpolation between mip levels
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    // Use linear filtering for magnification (when viewing textures up close)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // Repeat texture coordinates (seamless tiling)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    // No LOD bias - let OpenGL choose optimal mip level automatically
-    // This prevents artifacts and ensures smooth filtering
-    
-    // Enable maximum anisotropic filtering if available (reduces blurriness on angled surfaces)
-    // This significantly improves texture quality on surfaces viewed at angles
-    // Anisotropic filtering is widely supported and part of OpenGL core since 4.6
-    GLfloat maxAnisotropy = 1.0f;
-    // GL_MAX_TEXTURE_MAX_ANISOTROPY is 0x84FF, but GLAD should define it
-    // If not defined, we'll skip anisotropic filtering (textures will still look good with mipmaps)
-    #ifndef GL_MAX_TEXTURE_MAX_ANISOTROPY
-        #define GL_MAX_TEXTURE_MAX_ANISOTROPY 0x84FF
-        #define GL_TEXTURE_MAX_ANISOTROPY 0x84FE
-    #endif
-    
-    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
-    if (maxAnisotropy > 1.0f) {
-        // Use maximum available anisotropy for best quality (typically 8x or 16x)
-        // This provides the sharpest textures on angled surfaces
-        GLfloat anisotropy = maxAnisotropy;
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
-        LOG_DEBUG("Texture '{}' using {}x anisotropic filtering", miptex.name, static_cast<int>(anisotropy));
-    }
-    
-    // Verify texture was created correctly
-    GLint width = 0, height = 0;
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-    if (width != static_cast<GLint>(miptex.width) || height != static_cast<GLint>(miptex.height)) {
-        LOG_ERROR("Texture '{}' size mismatch! Expected: {}x{}, Got: {}x{}", 
-                 miptex.name, miptex.width, miptex.height, width, height);
-    } else {
-        LOG_DEBUG("Texture '{}' verified: {}x{}", miptex.name, width, height);
-    }
-    
-    glBindTexture(GL_TEXTURE_2D, 0);
-    
-    return textureID;
+    return textures;
 }
 
-bool SimpleBSPLoader::loadWADTextures(const std::string& bspPath, SimpleBSPMesh& mesh, 
+bool SimpleBSPLoader::loadWADTextures(const std::string& bspPath, std::vector<BSPTextureImage>& textures,
                                       const std::vector<std::string>& textureNames,
                                       const std::unordered_map<std::string, i32>& textureNameToIndex) {
+    CSCPP_PROFILE_FUNCTION();
     // Extract directory from BSP path
     std::string bspDir = bspPath;
     size_t lastSlash = bspDir.find_last_of("/\\");
@@ -838,145 +830,32 @@ bool SimpleBSPLoader::loadWADTextures(const std::string& bspPath, SimpleBSPMesh&
         "assets/maps/cs_dust.wad"
     };
     
+    // WADs stay mapped and decoded textures cached across maps, so only new names cost a decode
     u32 totalLoaded = 0;
-    for (const auto& wadPath : wadFiles) {
-        u32 loaded = loadWADFile(wadPath, mesh, textureNames, textureNameToIndex);
-        totalLoaded += loaded;
-    }
-    
-    if (totalLoaded > 0) {
-        LOG_INFO("Loaded {} textures from WAD files", totalLoaded);
-    } else {
-        LOG_WARN("No textures loaded from WAD files. Tried: halflife.wad, decals.wad, cs_dust.wad");
-    }
-    
-    return totalLoaded > 0;
-}
-
-bool SimpleBSPLoader::loadWADFile(const std::string& wadPath, SimpleBSPMesh& mesh, 
-                                   const std::vector<std::string>& neededTextures,
-                                   const std::unordered_map<std::string, i32>& textureNameToIndex) {
-    std::ifstream file(wadPath, std::ios::binary);
-    if (!file.is_open()) {
-        LOG_DEBUG("WAD file not found: {}", wadPath);
-        return false;
-    }
-    
-    LOG_INFO("Loading WAD file: {}", wadPath);
-    
-    // Read WAD header
-    bsp::WADHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-    
-    if (!file.good() || file.gcount() != sizeof(header)) {
-        LOG_WARN("Failed to read WAD header from {}", wadPath);
-        return false;
-    }
-    
-    // Check magic number
-    if (std::memcmp(header.magic, "WAD3", 4) != 0) {
-        LOG_WARN("Invalid WAD magic number in {} (expected WAD3)", wadPath);
-        return false;
-    }
-    
-    if (header.numEntries <= 0 || header.numEntries > 10000) {
-        LOG_WARN("Invalid WAD entry count: {}", header.numEntries);
-        return false;
-    }
-    
-    // Read directory
-    file.seekg(header.dirOffset, std::ios::beg);
-    std::vector<bsp::WADEntry> entries(header.numEntries);
-    file.read(reinterpret_cast<char*>(entries.data()), 
-              header.numEntries * sizeof(bsp::WADEntry));
-    
-    if (!file.good() || file.gcount() != static_cast<std::streamsize>(header.numEntries * sizeof(bsp::WADEntry))) {
-        LOG_WARN("Failed to read WAD directory from {}", wadPath);
-        return false;
-    }
-    
-    // Create a set of needed texture names for fast lookup
-    std::unordered_set<std::string> neededSet(neededTextures.begin(), neededTextures.end());
-    
-    u32 loadedCount = 0;
-    
-    // Search for needed textures in WAD
-    for (const auto& entry : entries) {
-        if (entry.type != 0x43) {  // 0x43 = miptex
-            continue;
-        }
-        
-        std::string texName(entry.name, 16);
-        texName = texName.c_str();  // Trim null characters
-        
-        // Check if we need this texture
-        if (neededSet.find(texName) == neededSet.end()) {
-            continue;
-        }
-        
-        // Find the miptex index for this texture name
+    WADLibrary& library = WADLibrary::shared();
+    for (const auto& texName : textureNames) {
         auto it = textureNameToIndex.find(texName);
         if (it == textureNameToIndex.end()) {
-            LOG_DEBUG("Texture '{}' found in WAD but not in BSP texture name map", texName);
-            continue;
-        }
-        
-        i32 miptexIndex = it->second;
-        
-        // Skip if we already have this texture loaded
-        if (mesh.textureMap.find(miptexIndex) != mesh.textureMap.end()) {
             continue;
         }
         
-        // Read miptex data
-        file.seekg(entry.offset, std::ios::beg);
-        bsp::BSPMiptex miptex;
-        file.read(reinterpret_cast<char*>(&miptex), sizeof(miptex));
-        
-        if (!file.good() || file.gcount() != sizeof(miptex)) {
-            LOG_WARN("Failed to read miptex header for '{}' from {}", texName, wadPath);
+        auto image = library.findTexture(wadFiles, texName);
+        if (!image) {
+            LOG_DEBUG("Texture '{}' not found in any WAD", texName);
             continue;
         }
-        
-        if (miptex.width == 0 || miptex.height == 0 || 
-            miptex.width > 1024 || miptex.height > 1024) {
-            LOG_WARN("Invalid texture dimensions for '{}': {}x{}", texName, miptex.width, miptex.height);
-            continue;
-        }
-        
-        // Read pixel data (first mip level)
-        u32 pixelCount = miptex.width * miptex.height;
-        std::vector<u8> pixelData(pixelCount);
-        
-        if (miptex.offsets[0] > 0) {
-            file.seekg(entry.offset + miptex.offsets[0], std::ios::beg);
-            file.read(reinterpret_cast<char*>(pixelData.data()), pixelCount);
-            
-            if (!file.good() || file.gcount() != static_cast<std::streamsize>(pixelCount)) {
-                LOG_WARN("Failed to read pixel data for '{}' from {}", texName, wadPath);
-                continue;
-            }
-            
-            // Create OpenGL texture
-            u32 textureID = createTextureFromMiptex(miptex, pixelData.data(), pixelCount);
-            if (textureID != 0) {
-                // Map texture to miptex index
-                mesh.textureMap[miptexIndex] = textureID;
-                LOG_INFO("Loaded texture '{}' from WAD {} (miptex index {}, {}x{}, ID: {})", 
-                         texName, wadPath, miptexIndex, miptex.width, miptex.height, textureID);
-                loadedCount++;
-            }
-        } else {
-            LOG_WARN("Texture '{}' in WAD has no pixel data", texName);
-        }
+        textures.push_back({it->second, std::move(image)});
+        totalLoaded++;
     }
     
-    if (loadedCount > 0) {
-        LOG_INFO("Loaded {} textures from WAD file {}", loadedCount, wadPath);
+    if (totalLoaded > 0) {
+        LOG_INFO("Loaded {} textures from WAD files ({} cached, {} KB)", totalLoaded,
+                 library.getCachedTextureCount(), library.getCachedBytes() / 1024);
+    } else {
+        LOG_WARN("No textures loaded from WAD files. Tried: halflife.wad, decals.wad, cs_dust.wad");
     }
     
-    return loadedCount > 0;
+    return totalLoaded > 0;
 }
 
 } // namespace cscpp::assets
-
@@ -4,62 +4,106 @@
 #include "core/math/math.hpp"
 #include "renderer/backend/gl_mesh.hpp"
 #include "assets/bsp/bsp_format.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/bsp/lightmap_atlas.hpp"
+#include "assets/wad/wad_library.hpp"
+#include <memory>
 #include <string>
 #include <vector>
-#include <fstream>
 #include <unordered_map>
 
+namespace cscpp::assets::cooked {
+class CookedMapView;
+class CookedMapWriter;
+}
+
 namespace cscpp::assets {
 
+// Index range of one BSP face inside its group (relative to the group's indices)
+struct BSPFaceRange {
+    u32 face;
+    u32 firstIndex;
+    u32 indexCount;
+};
+
 // Mesh group for a single texture
 struct BSPMeshGroup {
-    std::vector<renderer::Vertex> vertices;
+    std::vector<renderer::Vertex> vertices;  // Released by upload() once on the GPU
     std::vector<u32> indices;
+    std::vector<BSPFaceRange> faces;  // In index order
     renderer::GLMesh mesh;
     u32 textureID;  // OpenGL texture ID for this group
     i32 miptexIndex;  // BSP miptex index (for reference)
 };
 
+// Texture used by a BSP miptex slot (WAD textures are shared with the WAD library cache)
+struct BSPTextureImage {
+    i32 miptexIndex = -1;
+    std::shared_ptr<const TextureImage> image;
+};
+
+// BSP leaf for render culling
+struct BSPRenderLeaf {
+    AABB bounds;  // Mesh space (same swap as the vertices)
+    u32 firstFace = 0;  // Into SimpleBSPMesh::leafFaces
+    u32 faceCount = 0;
+};
+
 struct SimpleBSPMesh {
     std::vector<BSPMeshGroup> groups;  // One mesh group per texture
+    std::vector<BSPRenderLeaf> leaves;  // Indexed like LUMP_LEAVES (empty for the test mesh)
+    std::vector<u32> leafFaces;  // BSP face indices of each leaf (LUMP_MARKSURFACES)
+    std::vector<TextureImage> lightmapPages;  // LightmapAtlas pages the vertices' lightmapCoord point into (empty = unlit)
     std::unordered_map<i32, u32> textureMap;  // Maps miptex index to OpenGL texture ID
     AABB bounds;  // Map bounding box for collision/bounds checking
     bool loaded = false;
 };
 
+// CPU side of a map load: built on any thread, uploaded on the GL thread
+struct BSPMapData {
+    SimpleBSPMesh mesh;  // Groups carry vertices and indices, no GL objects yet
+    std::vector<BSPTextureImage> textures;
+};
+
 class SimpleBSPLoader {
 public:
-    /// Load a BSP file
+    /// Load a BSP file (or the cooked map next to it, if it was cooked from this BSP)
     Result<SimpleBSPMesh> load(const std::string& path);
     
+    /// CPU half of load(): geometry and decoded textures, no GL calls (safe on worker threads)
+    Result<BSPMapData> loadData(const std::string& path);
+    
+    /// GL half of load(): create the group meshes and textures
+    SimpleBSPMesh upload(BSPMapData&& data);
+    
     /// Create a test mesh (for testing without actual BSP file)
     SimpleBSPMesh createTestMesh();
     
+    /// Build the render groups and mipmapped textures of a BSP into a cooked map (no GL calls)
+    /// @param compressTextures Store BC1 (BC3 for alpha-keyed) instead of RGBA8
+    Result<void> cook(const bsp::BSPView& bsp, cooked::CookedMapWriter& writer, bool compressTextures = true);
+    
 private:
-    /// Parse BSP file
-    Result<SimpleBSPMesh> parseBSP(std::ifstream& file, const std::string& path);
+    /// Copy the buffers and textures out of a cooked map
+    Result<BSPMapData> loadCooked(const cooked::CookedMapView& view);
     
-    /// Read BSP lump data
-    bool readLump(std::ifstream& file, bsp::BSPLumpType lumpType, 
-                  bsp::BSPHeader& header, std::vector<u8>& data);
+    /// Build the render mesh from a mapped BSP (lumps are read in place)
+    Result<BSPMapData> parseBSP(const bsp::BSPView& bsp);
     
-    /// Load textures from BSP texture lump
-    bool loadTextures(std::ifstream& file, const bsp::BSPHeader& header, 
-                      SimpleBSPMesh& mesh, const bsp::BSPTextureInfo* texInfos, u32 texInfoCount,
-                      const std::string& path);
+    /// Triangulate faces into per-texture groups and compute the map bounds (no GL calls)
+    Result<void> buildGeometry(const bsp::BSPView& bsp, SimpleBSPMesh& mesh);
     
-    /// Load textures from WAD files
-    bool loadWADTextures(const std::string& bspPath, SimpleBSPMesh& mesh, 
-                         const std::vector<std::string>& textureNames,
-                         const std::unordered_map<std::string, i32>& textureNameToIndex);
+    /// Leaf bounds and face lists for PVS and frustum culling (none if the BSP has no usable leaves)
+    void buildLeaves(const bsp::BSPView& bsp, SimpleBSPMesh& mesh);
     
-    /// Load a single WAD file
-    bool loadWADFile(const std::string& wadPath, SimpleBSPMesh& mesh, 
-                     const std::vector<std::string>& neededTextures,
-                     const std::unordered_map<std::string, i32>& textureNameToIndex);
+    /// Convert embedded textures and the WAD textures the BSP references
+    std::vector<BSPTextureImage> loadTextures(const bsp::BSPView& bsp);
     
-    /// Create OpenGL texture from miptex data
-    u32 createTextureFromMiptex(const bsp::BSPMiptex& miptex, const u8* data, u32 dataSize);
+    /// Look up textures in the WAD files next to the map (through WADLibrary::shared())
+    bool loadWADTextures(const std::string& bspPath, std::vector<BSPTextureImage>& textures,
+                         const std::vector<std::string>& textureNames,
+                         const std::unordered_map<std::string, i32>& textureNameToIndex);
+
 };
 
 } // namespace cscpp::assets
@@ -0,0 +1,211 @@
+#pragma once
+
+/**
+ * @file cooked_map_format.hpp
+ * @brief On-disk layout of cooked maps (.cmap)
+ *
+ * A cooked map is a BSP (plus the WAD textures it references) run through
+ * every load-time conversion once, offline, by asset_compiler: triangulated
+ * vertex/index buffers per texture group, palette-converted RGB8 textures
+ * with full mip chains, collision hulls, the decompressed PVS and the faces
+ * of each leaf for render culling. Loading
+ * one is mapping the file and handing the sections to the GPU and to the
+ * collision / visibility structures as they are.
+ *
+ * Layout: CookedHeader, then sections at 16-byte aligned offsets. Every
+ * section is a tightly packed array of one record type (see
+ * SECTION_RECORD_SIZES). Files are native-endian and only meant to be read
+ * by the build that produced them; bump COOKED_MAP_VERSION whenever a
+ * record or a cooking step changes.
+ */
+
+#include "core/types.hpp"
+
+#include <string>
+
+namespace cscpp::assets::cooked {
+
+inline constexpr char COOKED_MAP_MAGIC[4] = {'C', 'M', 'A', 'P'};
+inline constexpr u32 COOKED_MAP_VERSION = 6;
+inline constexpr const char* COOKED_MAP_EXTENSION = ".cmap";
+
+/// Section offsets are aligned to this (enough for every record type)
+inline constexpr u64 COOKED_SECTION_ALIGNMENT = 16;
+
+// Section indices
+enum CookedSectionType {
+    SECTION_ENTITIES = 0,           ///< Entity lump text (char)
+    SECTION_MESH_INFO = 1,          ///< CookedMeshInfo (one record)
+    SECTION_MESH_GROUPS = 2,        ///< CookedMeshGroup
+    SECTION_VERTICES = 3,           ///< CookedVertex, all groups back to back
+    SECTION_INDICES = 4,            ///< u32, relative to the group's first vertex
+    SECTION_TEXTURES = 5,           ///< CookedTexture
+    SECTION_TEXTURE_DATA = 6,       ///< RGB8 mip chains (u8)
+    SECTION_COLLISION_PLANES = 7,   ///< CookedPlane
+    SECTION_HULL0_NODES = 8,        ///< CookedHullNode, render tree with leaf contents
+    SECTION_CLIP_NODES = 9,         ///< CookedHullNode, hulls 1-3
+    SECTION_MODELS = 10,            ///< CookedModel
+    SECTION_VIS_INFO = 11,          ///< CookedVisInfo (one record)
+    SECTION_VIS_PLANES = 12,        ///< CookedPlane
+    SECTION_VIS_NODES = 13,         ///< CookedVisNode
+    SECTION_PVS = 14,               ///< u64 bit rows, leafCount x rowWords
+    SECTION_PVS_ROWS = 15,          ///< u8 per leaf, 1 if the leaf has vis data
+    SECTION_MESH_FACES = 16,        ///< CookedMeshFace, index ranges of each group's faces
+    SECTION_RENDER_LEAVES = 17,     ///< CookedRenderLeaf, indexed like LUMP_LEAVES
+    SECTION_LEAF_FACES = 18,        ///< u32 BSP face indices (LUMP_MARKSURFACES)
+    SECTION_LIGHTMAPS = 19,         ///< CookedTexture, RGBA8 lightmap atlas pages (data in SECTION_TEXTURE_DATA)
+    SECTION_COUNT = 20
+};
+
+struct CookedSection {
+    u64 offset;
+    u64 length;
+};
+
+struct CookedHeader {
+    char magic[4];
+    u32 version;
+    u64 sourceSize;                         ///< Size of the BSP this was cooked from
+    u64 sourceHash;                         ///< cookedSourceHash() of that BSP's header
+    CookedSection sections[SECTION_COUNT];
+};
+
+// ============================================================================
+// Render Records
+// ============================================================================
+
+struct CookedMeshInfo {
+    f32 boundsMin[3];           ///< Render-space bounds (after the map transform)
+    f32 boundsMax[3];
+};
+
+struct CookedMeshGroup {
+    i32 miptexIndex;            ///< BSP miptex index (-1 = untextured faces)
+    u32 firstVertex;
+    u32 vertexCount;
+    u32 firstIndex;
+    u32 indexCount;
+    u32 firstFace;              ///< Into SECTION_MESH_FACES
+    u32 faceCount;
+};
+
+/// One BSP face inside its group, indices relative to the group's first index
+struct CookedMeshFace {
+    u32 face;
+    u32 firstIndex;
+    u32 indexCount;
+};
+
+/// Mesh-space bounds of a BSP leaf and its faces
+struct CookedRenderLeaf {
+    f32 mins[3];
+    f32 maxs[3];
+    u32 firstFace;              ///< Into SECTION_LEAF_FACES
+    u32 faceCount;
+};
+
+/// Same layout as renderer::Vertex, so groups upload straight from the file
+struct CookedVertex {
+    f32 position[3];
+    f32 normal[3];
+    f32 texCoord[2];
+    f32 lightmapCoord[3];       ///< xy in the atlas page, z the page
+};
+
+struct CookedTexture {
+    char name[16];
+    i32 miptexIndex;            ///< BSP miptex index the groups refer to
+    u32 width;
+    u32 height;
+    u32 mipCount;               ///< Levels stored, level 0 first, each half the last (min 1)
+    u32 format;                 ///< renderer::TextureFormat (RGBA8, or BC1/BC3 when compressed)
+    u32 reserved;               ///< Keeps dataOffset 8-byte aligned without implicit padding
+    u64 dataOffset;             ///< Into SECTION_TEXTURE_DATA
+    u64 dataSize;
+};
+
+// ============================================================================
+// Collision / Visibility Records
+// ============================================================================
+
+struct CookedPlane {
+    f32 normal[3];
+    f32 dist;
+    i32 type;
+};
+
+/// children >= 0 index the node array, < 0 are contents
+struct CookedHullNode {
+    i32 planeIndex;
+    i16 children[2];
+};
+
+struct CookedModel {
+    f32 mins[3];
+    f32 maxs[3];
+    f32 origin[3];
+    i32 headNodes[4];
+};
+
+struct CookedVisInfo {
+    i32 headNode;
+    i32 visLeafCount;
+    u32 leafCount;
+    u32 rowWords;
+};
+
+/// children >= 0 index the node array, < 0 are -(leaf + 1)
+struct CookedVisNode {
+    i32 planeIndex;
+    i32 children[2];
+};
+
+/// Record size of each section (1 for byte sections)
+inline constexpr u64 SECTION_RECORD_SIZES[SECTION_COUNT] = {
+    1,                          // SECTION_ENTITIES
+    sizeof(CookedMeshInfo),     // SECTION_MESH_INFO
+    sizeof(CookedMeshGroup),    // SECTION_MESH_GROUPS
+    sizeof(CookedVertex),       // SECTION_VERTICES
+    sizeof(u32),                // SECTION_INDICES
+    sizeof(CookedTexture),      // SECTION_TEXTURES
+    1,                          // SECTION_TEXTURE_DATA
+    sizeof(CookedPlane),        // SECTION_COLLISION_PLANES
+    sizeof(CookedHullNode),     // SECTION_HULL0_NODES
+    sizeof(CookedHullNode),     // SECTION_CLIP_NODES
+    sizeof(CookedModel),        // SECTION_MODELS
+    sizeof(CookedVisInfo),      // SECTION_VIS_INFO
+    sizeof(CookedPlane),        // SECTION_VIS_PLANES
+    sizeof(CookedVisNode),      // SECTION_VIS_NODES
+    sizeof(u64),                // SECTION_PVS
+    1,                          // SECTION_PVS_ROWS
+    sizeof(CookedMeshFace),     // SECTION_MESH_FACES
+    sizeof(CookedRenderLeaf),   // SECTION_RENDER_LEAVES
+    sizeof(u32),                // SECTION_LEAF_FACES
+    sizeof(CookedTexture),      // SECTION_LIGHTMAPS
+};
+
+/**
+ * @brief Fingerprint of a source BSP (FNV-1a over its header)
+ *
+ * The lump directory moves whenever a map is recompiled, so this catches
+ * stale cooks without reading the whole BSP at runtime.
+ */
+inline u64 cookedSourceHash(const u8* header, u64 size) {
+    u64 hash = 0xCBF29CE484222325ull;
+    for (u64 i = 0; i < size; ++i) {
+        hash = (hash ^ header[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/// Cooked file next to a BSP ("maps/de_dust2.bsp" -> "maps/de_dust2.cmap")
+inline std::string cookedPathFor(const std::string& bspPath) {
+    const size_t dot = bspPath.find_last_of('.');
+    const size_t slash = bspPath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return bspPath + COOKED_MAP_EXTENSION;
+    }
+    return bspPath.substr(0, dot) + COOKED_MAP_EXTENSION;
+}
+
+} // namespace cscpp::assets::cooked
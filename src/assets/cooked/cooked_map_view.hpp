@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @file cooked_map_view.hpp
+ * @brief Zero-copy view of a cooked map (.cmap)
+ *
+ * Counterpart of bsp::BSPView for files written by CookedMapWriter: the
+ * header and section table are validated in open(), after which sections
+ * are typed spans into the mapping. Header-only for the same reason as
+ * BSPView, so collision and visibility can load cooked data without
+ * linking the assets library.
+ */
+
+#include "core/types.hpp"
+#include "core/platform/mapped_file.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_format.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cscpp::assets::cooked {
+
+class CookedMapView {
+public:
+    /// Map and validate a cooked map
+    Result<void> open(const std::string& path) {
+        close();
+        if (auto mapped = m_file.open(path); !mapped) {
+            return mapped;
+        }
+        if (auto valid = validate(); !valid) {
+            close();
+            return valid;
+        }
+        return {};
+    }
+    
+    void close() {
+        m_file.close();
+        m_header = CookedHeader{};
+    }
+    
+    bool isOpen() const { return m_file.isOpen(); }
+    const std::string& getPath() const { return m_file.getPath(); }
+    const CookedHeader& getHeader() const { return m_header; }
+    
+    /// True if the file was cooked from this BSP (stale cooks should be ignored)
+    bool isCookedFrom(const bsp::BSPView& source) const {
+        const bsp::BSPHeader& header = source.getHeader();
+        return m_header.sourceSize == source.getFileSize() &&
+               m_header.sourceHash == cookedSourceHash(reinterpret_cast<const u8*>(&header), sizeof(header));
+    }
+    
+    /// Raw bytes of a section
+    std::span<const u8> getSectionBytes(CookedSectionType type) const {
+        const CookedSection& section = m_header.sections[type];
+        return m_file.getBytes().subspan(static_cast<size_t>(section.offset), static_cast<size_t>(section.length));
+    }
+    
+    /// A section as an array of its records (empty if T is not the section's record type)
+    template<typename T>
+    std::span<const T> getSection(CookedSectionType type) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const std::span<const u8> bytes = getSectionBytes(type);
+        if (bytes.size() % sizeof(T) != 0 ||
+            reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(T) != 0) {
+            return {};
+        }
+        return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+    }
+    
+    /// Single-record section, or nullptr if absent
+    template<typename T>
+    const T* getRecord(CookedSectionType type) const {
+        const std::span<const T> records = getSection<T>(type);
+        return records.size() == 1 ? records.data() : nullptr;
+    }
+    
+    std::string_view getEntities() const {
+        const std::span<const u8> bytes = getSectionBytes(SECTION_ENTITIES);
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+
+private:
+    Result<void> validate() {
+        const std::span<const u8> file = m_file.getBytes();
+        const std::string& path = m_file.getPath();
+        
+        if (file.size() < sizeof(CookedHeader)) {
+            return std::unexpected(Error{"Cooked map too small: " + path});
+        }
+        std::memcpy(&m_header, file.data(), sizeof(CookedHeader));
+        if (std::memcmp(m_header.magic, COOKED_MAP_MAGIC, sizeof(COOKED_MAP_MAGIC)) != 0) {
+            return std::unexpected(Error{"Not a cooked map: " + path});
+        }
+        if (m_header.version != COOKED_MAP_VERSION) {
+            return std::unexpected(Error{"Cooked map version " + std::to_string(m_header.version) +
+                                         " (expected " + std::to_string(COOKED_MAP_VERSION) + "): " + path});
+        }
+        
+        for (i32 i = 0; i < SECTION_COUNT; ++i) {
+            CookedSection& section = m_header.sections[i];
+            if (section.length == 0) {
+                section.offset = 0;
+                continue;
+            }
+            if (section.offset > file.size() || section.length > file.size() - section.offset ||
+                section.length % SECTION_RECORD_SIZES[i] != 0 ||
+                section.offset % COOKED_SECTION_ALIGNMENT != 0) {
+                return std::unexpected(Error{"Corrupt cooked map section " + std::to_string(i) + ": " + path});
+            }
+        }
+        return {};
+    }
+    
+    MappedFile m_file;
+    CookedHeader m_header{};
+};
+
+} // namespace cscpp::assets::cooked
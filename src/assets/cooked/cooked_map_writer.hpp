@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @file cooked_map_writer.hpp
+ * @brief Builds and writes cooked maps (.cmap)
+ *
+ * Each subsystem fills its own sections (the render mesh via
+ * SimpleBSPLoader::cook, collision and visibility via their cook()
+ * methods); write() lays them out behind the header. Only asset_compiler
+ * writes cooked maps, but the writer is header-only like the view so the
+ * movement and network libraries can cook without linking assets.
+ */
+
+#include "core/types.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_format.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace cscpp::assets::cooked {
+
+class CookedMapWriter {
+public:
+    /// Fingerprint of the BSP being cooked (checked by loaders against the BSP on disk)
+    void setSource(const bsp::BSPView& source) {
+        const bsp::BSPHeader& header = source.getHeader();
+        m_sourceSize = source.getFileSize();
+        m_sourceHash = cookedSourceHash(reinterpret_cast<const u8*>(&header), sizeof(header));
+    }
+    
+    /// Replace a section with an array of records
+    template<typename T>
+    void setSection(CookedSectionType type, std::span<const T> records) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::vector<u8>& data = m_sections[type];
+        data.resize(records.size_bytes());
+        if (!records.empty()) {
+            std::memcpy(data.data(), records.data(), records.size_bytes());
+        }
+    }
+    
+    template<typename T>
+    void setRecord(CookedSectionType type, const T& record) {
+        setSection(type, std::span<const T>(&record, 1));
+    }
+    
+    u64 getSectionSize(CookedSectionType type) const { return m_sections[type].size(); }
+    
+    /// Total file size write() will produce
+    u64 getFileSize() const {
+        u64 size = sizeof(CookedHeader);
+        for (const auto& data : m_sections) {
+            if (!data.empty()) {
+                size = alignUp(size) + data.size();
+            }
+        }
+        return size;
+    }
+    
+    /**
+     * @brief Write the cooked map
+     *
+     * Goes through a temporary file and a rename, so a running client never
+     * maps a half-written cook.
+     */
+    Result<void> write(const std::string& path) const {
+        CookedHeader header{};
+        std::memcpy(header.magic, COOKED_MAP_MAGIC, sizeof(header.magic));
+        header.version = COOKED_MAP_VERSION;
+        header.sourceSize = m_sourceSize;
+        header.sourceHash = m_sourceHash;
+        
+        u64 offset = sizeof(CookedHeader);
+        for (i32 i = 0; i < SECTION_COUNT; ++i) {
+            if (m_sections[i].empty()) {
+                continue;
+            }
+            offset = alignUp(offset);
+            header.sections[i].offset = offset;
+            header.sections[i].length = m_sections[i].size();
+            offset += m_sections[i].size();
+        }
+        
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return std::unexpected(Error{"Failed to create " + tempPath});
+            }
+            
+            static constexpr char PADDING[COOKED_SECTION_ALIGNMENT] = {};
+            u64 written = sizeof(CookedHeader);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (i32 i = 0; i < SECTION_COUNT; ++i) {
+                if (m_sections[i].empty()) {
+                    continue;
+                }
+                file.write(PADDING, static_cast<std::streamsize>(header.sections[i].offset - written));
+                file.write(reinterpret_cast<const char*>(m_sections[i].data()),
+                           static_cast<std::streamsize>(m_sections[i].size()));
+                written = header.sections[i].offset + header.sections[i].length;
+            }
+            if (!file.flush()) {
+                return std::unexpected(Error{"Failed to write " + tempPath});
+            }
+        }
+        
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::filesystem::remove(tempPath, error);
+            return std::unexpected(Error{"Failed to replace " + path});
+        }
+        return {};
+    }
+
+private:
+    static u64 alignUp(u64 value) {
+        return (value + COOKED_SECTION_ALIGNMENT - 1) & ~(COOKED_SECTION_ALIGNMENT - 1);
+    }
+    
+    u64 m_sourceSize = 0;
+    u64 m_sourceHash = 0;
+    std::array<std::vector<u8>, SECTION_COUNT> m_sections;
+};
+
+} // namespace cscpp::assets::cooked
@@ -1,8 +1,10 @@
 #include "assets/gltf/simple_gltf_loader.hpp"
+#include "assets/texture/ktx2.hpp"
 #include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "renderer/backend/gl_texture.hpp"
 #include <fstream>
 #include <filesystem>
-#include <glad/glad.h>
 
 #if defined(TINYGLTF_FOUND) || __has_include(<tiny_gltf.h>)
 // Define stb_image implementation before tinygltf includes it
@@ -19,6 +21,16 @@
 namespace cscpp::assets {
 
 Result<SimpleModel> SimpleGLTFLoader::load(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
+    auto data = loadData(path);
+    if (!data) {
+        return std::unexpected(data.error());
+    }
+    return upload(std::move(*data));
+}
+
+Result<ModelData> SimpleGLTFLoader::loadData(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
     LOG_INFO("Loading glTF model: {}", path);
     
     // Try multiple paths (relative to executable directory)
@@ -51,8 +63,7 @@ Result<SimpleModel> SimpleGLTFLoader::load(const std::string& path) {
     }
     
     if (!found) {
-        LOG_WARN("glTF file not found in any location, creating test mesh");
-        return createTestWeaponMesh();
+        return std::unexpected(Error{"glTF file not found in any location: " + path});
     }
     
     LOG_INFO("Found glTF file at: {}", foundPath);
@@ -60,8 +71,49 @@ Result<SimpleModel> SimpleGLTFLoader::load(const std::string& path) {
 #if HAS_TINYGLTF
     return loadGLTF(foundPath);
 #else
-    LOG_WARN("tinygltf not found, using test mesh");
-    return createTestWeaponMesh();
+    return std::unexpected(Error{"tinygltf not found, cannot load " + foundPath});
+#endif
+}
+
+SimpleModel SimpleGLTFLoader::upload(ModelData&& data) {
+    CSCPP_PROFILE_FUNCTION();
+    SimpleModel result;
+    result.mesh.create(data.vertices, data.indices);
+    
+    if (data.texture) {
+        const TextureImage& image = *data.texture;
+        result.textureID = createTextureFromImage(image);
+        if (result.textureID != 0) {
+            LOG_INFO("Loaded texture from glTF: {}x{} (format {}, {} levels, ID: {})",
+                     image.width, image.height, static_cast<u32>(image.format), image.mipCount, result.textureID);
+        }
+    }
+    
+    result.loaded = true;
+    LOG_INFO("Loaded glTF model: {} vertices, {} indices, texture ID: {}", 
+             data.vertices.size(), data.indices.size(), result.textureID);
+    return result;
+}
+
+// stb_image's implementation is compiled into this file along with tinygltf
+Result<TextureImage> loadImageFile(const std::string& path) {
+#if HAS_TINYGLTF
+    int width = 0, height = 0, channels = 0;
+    u8* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!data) {
+        return std::unexpected(Error{"Failed to decode image: " + path});
+    }
+    
+    TextureImage image;
+    image.name = path;
+    image.width = static_cast<u32>(width);
+    image.height = static_cast<u32>(height);
+    image.format = renderer::uncompressedFormat(static_cast<u32>(channels));
+    image.pixels.assign(data, data + static_cast<size_t>(width) * height * channels);
+    stbi_image_free(data);
+    return image;
+#else
+    return std::unexpected(Error{"stb_image not available, cannot decode " + path});
 #endif
 }
 
@@ -129,7 +181,26 @@ static std::string ExpandFilePath(const std::string& filepath, void* user_data)
     return filepath;
 }
 
-Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
+// A .ktx2 next to the image (asset_compiler -texture) is used instead of it
+static bool loadCookedImage(const std::filesystem::path& imagePath, TextureImage& image) {
+    std::filesystem::path ktx2Path = imagePath;
+    ktx2Path.replace_extension(KTX2_EXTENSION);
+    std::error_code error;
+    if (!std::filesystem::exists(ktx2Path, error)) {
+        return false;
+    }
+    
+    auto loaded = loadKTX2File(ktx2Path.string());
+    if (!loaded) {
+        LOG_WARN("Ignoring {}: {}", ktx2Path.string(), loaded.error().message);
+        return false;
+    }
+    image = std::move(*loaded);
+    return true;
+}
+
+Result<ModelData> SimpleGLTFLoader::loadGLTF(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
     tinygltf::Model model;
     tinygltf::TinyGLTF loader;
     std::string err, warn;
@@ -162,7 +233,7 @@ Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
         return std::unexpected(Error{"Failed to load glTF: " + err});
     }
     
-    SimpleModel result;
+    ModelData result;
     
     // Process all meshes in the model
     std::vector<renderer::Vertex> allVertices;
@@ -299,13 +370,11 @@ Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
     }
     
     if (allVertices.empty() || allIndices.empty()) {
-        LOG_WARN("No vertex data found in glTF, using test mesh");
-        return createTestWeaponMesh();
+        return std::unexpected(Error{"No vertex data found in glTF: " + path});
     }
     
     // Load textures from glTF
     // Try to find a material with a base color texture
-    u32 textureID = 0;
     for (const auto& material : model.materials) {
         if (material.pbrMetallicRoughness.baseColorTexture.index >= 0) {
             int textureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
@@ -314,16 +383,18 @@ Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
                 if (texture.source >= 0 && texture.source < static_cast<int>(model.images.size())) {
                     const auto& image = model.images[texture.source];
                     
-                    // Load image data
-                    std::vector<u8> imageData;
-                    int width = 0, height = 0, channels = 0;
-                    
-                    if (!image.image.empty() && image.width > 0 && image.height > 0) {
+                    auto decoded = std::make_shared<TextureImage>();
+                    const bool cooked = !image.uri.empty() && loadCookedImage(baseDir / image.uri, *decoded);
+                    if (cooked) {
+                        LOG_INFO("Loaded KTX2 texture for: {}", image.uri);
+                    } else if (!image.image.empty() && image.width > 0 && image.height > 0 &&
+                               image.component >= 1 && image.component <= 4) {
                         // Image data is already decoded by tinygltf
-                        imageData = image.image;
-                        width = image.width;
-                        height = image.height;
-                        channels = image.component; // 1=gray, 2=gray+alpha, 3=RGB, 4=RGBA
+                        decoded->name = image.name;
+                        decoded->pixels = image.image;
+                        decoded->width = static_cast<u32>(image.width);
+                        decoded->height = static_cast<u32>(image.height);
+                        decoded->format = renderer::uncompressedFormat(static_cast<u32>(image.component)); // 1=gray, 2=gray+alpha, 3=RGB, 4=RGBA
                     } else if (!image.uri.empty()) {
                         // Image is in external file - try to load it
                         std::filesystem::path imagePath = baseDir / image.uri;
@@ -339,10 +410,8 @@ Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
                         
                         bool loaded = false;
                         for (const auto& tryPath : tryPaths) {
-                            u8* data = stbi_load(tryPath.c_str(), &width, &height, &channels, 0);
-                            if (data) {
-                                imageData.assign(data, data + width * height * channels);
-                                stbi_image_free(data);
+                            if (auto file = loadImageFile(tryPath)) {
+                                *decoded = std::move(*file);
                                 loaded = true;
                                 LOG_INFO("Loaded texture from: {}", tryPath);
                                 break;
@@ -358,47 +427,17 @@ Result<SimpleModel> SimpleGLTFLoader::loadGLTF(const std::string& path) {
                         continue;
                     }
                     
-                    if (!imageData.empty() && width > 0 && height > 0) {
-                        // Create OpenGL texture
-                        glGenTextures(1, &textureID);
-                        if (textureID != 0) {
-                            glBindTexture(GL_TEXTURE_2D, textureID);
-                            
-                            // Determine format
-                            GLenum format = GL_RGB;
-                            if (channels == 4) {
-                                format = GL_RGBA;
-                            } else if (channels == 1) {
-                                format = GL_RED;
-                            }
-                            
-                            // Upload texture data
-                            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, imageData.data());
-                            
-                            // Set texture parameters
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                            
-                            glBindTexture(GL_TEXTURE_2D, 0);
-                            
-                            LOG_INFO("Loaded texture from glTF: {}x{} ({} channels, ID: {})", width, height, channels, textureID);
-                            break; // Use first texture found
-                        }
+                    if (!decoded->pixels.empty() && decoded->width > 0 && decoded->height > 0) {
+                        result.texture = std::move(decoded);
+                        break; // Use first texture found
                     }
                 }
             }
         }
     }
     
-    result.mesh.create(allVertices, allIndices);
-    result.textureID = textureID;
-    result.loaded = true;
-    
-    LOG_INFO("Loaded glTF model: {} vertices, {} indices, texture ID: {}", 
-             allVertices.size(), allIndices.size(), textureID);
-    
+    result.vertices = std::move(allVertices);
+    result.indices = std::move(allIndices);
     return result;
 }
 #endif
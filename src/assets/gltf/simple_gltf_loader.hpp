@@ -2,6 +2,8 @@
 
 #include "core/types.hpp"
 #include "renderer/backend/gl_mesh.hpp"
+#include "assets/texture_image.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,18 +15,31 @@ struct SimpleModel {
     bool loaded = false;
 };
 
+// CPU side of a model load: built on any thread, uploaded on the GL thread
+struct ModelData {
+    std::vector<renderer::Vertex> vertices;
+    std::vector<u32> indices;
+    std::shared_ptr<const TextureImage> texture;  // Base color, nullptr if the model has none
+};
+
 class SimpleGLTFLoader {
 public:
     /// Load a glTF file (simplified)
     Result<SimpleModel> load(const std::string& path);
     
+    /// CPU half of load(): parse buffers and decode the base color image, no GL calls
+    Result<ModelData> loadData(const std::string& path);
+    
+    /// GL half of load(): create the mesh and texture
+    SimpleModel upload(ModelData&& data);
+    
     /// Create a test weapon mesh (for testing without actual glTF file)
     SimpleModel createTestWeaponMesh();
 
 private:
 #if defined(TINYGLTF_FOUND) || __has_include(<tiny_gltf.h>)
     /// Load glTF using tinygltf library
-    Result<SimpleModel> loadGLTF(const std::string& path);
+    Result<ModelData> loadGLTF(const std::string& path);
 #endif
 };
 
@@ -0,0 +1,459 @@
+/**
+ * @file block_compression.cpp
+ * @brief BC1/BC3 block encoders and decoders
+ */
+
+#include "assets/texture/block_compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace cscpp::assets {
+
+namespace {
+
+using Texels = u8[16][4];
+
+/// Weight of c0 in each of the four-color palette entries
+constexpr f32 PALETTE_WEIGHTS[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+u16 packRGB565(const f32 (&color)[3]) {
+    const auto quantize = [](f32 value, f32 maxValue) {
+        return static_cast<u32>(std::clamp(std::lround(value * maxValue / 255.0f), 0L, static_cast<long>(maxValue)));
+    };
+    return static_cast<u16>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) |
+                            quantize(color[2], 31.0f));
+}
+
+void unpackRGB565(u16 color, i32 (&rgb)[3]) {
+    const i32 r = (color >> 11) & 31;
+    const i32 g = (color >> 5) & 63;
+    const i32 b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void buildPalette(u16 c0, u16 c1, bool fourColor, i32 (&palette)[4][3]) {
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    for (u32 c = 0; c < 3; ++c) {
+        if (fourColor) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+/// Nearest palette entry per texel; returns the squared error over the used texels
+u32 selectIndices(const Texels& rgba, const bool (&used)[16], u16 c0, u16 c1, u32& indices) {
+    i32 palette[4][3];
+    buildPalette(c0, c1, true, palette);
+    
+    u32 error = 0;
+    indices = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        u32 best = 0;
+        u32 bestError = ~0u;
+        for (u32 entry = 0; entry < 4; ++entry) {
+            u32 entryError = 0;
+            for (u32 c = 0; c < 3; ++c) {
+                const i32 delta = rgba[i][c] - palette[entry][c];
+                entryError += static_cast<u32>(delta * delta);
+            }
+            if (entryError < bestError) {
+                best = entry;
+                bestError = entryError;
+            }
+        }
+        indices |= best << (i * 2);
+        error += used[i] ? bestError : 0;
+    }
+    return error;
+}
+
+/// Quantize two endpoints and order them for four-color mode (c0 > c1)
+void packEndpoints(const f32 (&first)[3], const f32 (&second)[3], u16& c0, u16& c1) {
+    c0 = packRGB565(first);
+    c1 = packRGB565(second);
+    if (c0 < c1) {
+        std::swap(c0, c1);  // Equal endpoints stay in three-color mode, where index 0 is still exact
+    }
+}
+
+void writeColorBlock(u16 c0, u16 c1, u32 indices, u8* block) {
+    block[0] = static_cast<u8>(c0);
+    block[1] = static_cast<u8>(c0 >> 8);
+    block[2] = static_cast<u8>(c1);
+    block[3] = static_cast<u8>(c1 >> 8);
+    for (u32 i = 0; i < 4; ++i) {
+        block[4 + i] = static_cast<u8>(indices >> (i * 8));
+    }
+}
+
+/// Principal axis fit of the used texels, then one least-squares refinement
+void encodeColorBlock(const Texels& rgba, const bool (&used)[16], u8* block) {
+    f32 mean[3] = {};
+    u32 count = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        if (used[i]) {
+            for (u32 c = 0; c < 3; ++c) {
+                mean[c] += rgba[i][c];
+            }
+            count++;
+        }
+    }
+    if (count == 0) {
+        writeColorBlock(0, 0, 0, block);
+        return;
+    }
+    for (f32& value : mean) {
+        value /= static_cast<f32>(count);
+    }
+    
+    // Covariance (xx, xy, xz, yy, yz, zz)
+    f32 covariance[6] = {};
+    for (u32 i = 0; i < 16; ++i) {
+        if (!used[i]) {
+            continue;
+        }
+        const f32 r = rgba[i][0] - mean[0];
+        const f32 g = rgba[i][1] - mean[1];
+        const f32 b = rgba[i][2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+    
+    // Power iteration converges on the principal axis within a few steps for 3x3
+    f32 axis[3] = {1.0f, 1.0f, 1.0f};
+    for (u32 iteration = 0; iteration < 8; ++iteration) {
+        const f32 next[3] = {
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+        };
+        const f32 largest = std::max({std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+        if (largest < 1e-6f) {
+            break;  // All used texels are the same color
+        }
+        for (u32 c = 0; c < 3; ++c) {
+            axis[c] = next[c] / largest;
+        }
+    }
+    const f32 length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    for (f32& value : axis) {
+        value /= length;
+    }
+    
+    f32 minT = 0.0f;
+    f32 maxT = 0.0f;
+    for (u32 i = 0; i < 16; ++i) {
+        if (used[i]) {
+            const f32 t = (rgba[i][0] - mean[0]) * axis[0] + (rgba[i][1] - mean[1]) * axis[1] +
+                          (rgba[i][2] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+    }
+    
+    // Pull the endpoints in: the extremes are rare, the interpolated colors are not
+    const f32 inset = (maxT - minT) / 16.0f;
+    f32 high[3];
+    f32 low[3];
+    for (u32 c = 0; c < 3; ++c) {
+        high[c] = mean[c] + axis[c] * (maxT - inset);
+        low[c] = mean[c] + axis[c] * (minT + inset);
+    }
+    
+    u16 c0 = 0;
+    u16 c1 = 0;
+    u32 indices = 0;
+    packEndpoints(high, low, c0, c1);
+    u32 error = selectIndices(rgba, used, c0, c1, indices);
+    
+    // Endpoints that minimize the squared error for the chosen indices
+    f32 aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    f32 ax[3] = {};
+    f32 bx[3] = {};
+    for (u32 i = 0; i < 16; ++i) {
+        if (!used[i]) {
+            continue;
+        }
+        const f32 w = PALETTE_WEIGHTS[(indices >> (i * 2)) & 3];
+        aa += w * w;
+        bb += (1.0f - w) * (1.0f - w);
+        ab += w * (1.0f - w);
+        for (u32 c = 0; c < 3; ++c) {
+            ax[c] += w * rgba[i][c];
+            bx[c] += (1.0f - w) * rgba[i][c];
+        }
+    }
+    const f32 determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) > 1e-6f) {
+        f32 first[3];
+        f32 second[3];
+        for (u32 c = 0; c < 3; ++c) {
+            first[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            second[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+        
+        u16 refined0 = 0;
+        u16 refined1 = 0;
+        u32 refinedIndices = 0;
+        packEndpoints(first, second, refined0, refined1);
+        const u32 refinedError = selectIndices(rgba, used, refined0, refined1, refinedIndices);
+        if (refinedError < error) {
+            c0 = refined0;
+            c1 = refined1;
+            indices = refinedIndices;
+        }
+    }
+    
+    writeColorBlock(c0, c1, indices, block);
+}
+
+void decodeColorBlock(const u8* block, bool alwaysFourColor, Texels& rgba) {
+    const u16 c0 = static_cast<u16>(block[0] | (block[1] << 8));
+    const u16 c1 = static_cast<u16>(block[2] | (block[3] << 8));
+    u32 indices = 0;
+    for (u32 i = 0; i < 4; ++i) {
+        indices |= static_cast<u32>(block[4 + i]) << (i * 8);
+    }
+    
+    i32 palette[4][3];
+    buildPalette(c0, c1, alwaysFourColor || c0 > c1, palette);
+    for (u32 i = 0; i < 16; ++i) {
+        const u32 index = (indices >> (i * 2)) & 3;
+        for (u32 c = 0; c < 3; ++c) {
+            rgba[i][c] = static_cast<u8>(palette[index][c]);
+        }
+        rgba[i][3] = 255;
+    }
+}
+
+/// Eight-value alpha block between the block's extremes
+void encodeAlphaBlock(const Texels& rgba, u8* block) {
+    u8 low = 255;
+    u8 high = 0;
+    for (u32 i = 0; i < 16; ++i) {
+        low = std::min(low, rgba[i][3]);
+        high = std::max(high, rgba[i][3]);
+    }
+    block[0] = high;
+    block[1] = low;
+    
+    u64 indices = 0;
+    if (high != low) {
+        i32 values[8] = {high, low};
+        for (i32 i = 2; i < 8; ++i) {
+            values[i] = ((8 - i) * high + (i - 1) * low + 3) / 7;
+        }
+        for (u32 i = 0; i < 16; ++i) {
+            u32 best = 0;
+            i32 bestError = 256;
+            for (u32 entry = 0; entry < 8; ++entry) {
+                const i32 entryError = std::abs(rgba[i][3] - values[entry]);
+                if (entryError < bestError) {
+                    best = entry;
+                    bestError = entryError;
+                }
+            }
+            indices |= static_cast<u64>(best) << (i * 3);
+        }
+    }
+    for (u32 i = 0; i < 6; ++i) {
+        block[2 + i] = static_cast<u8>(indices >> (i * 8));
+    }
+}
+
+void decodeAlphaBlock(const u8* block, Texels& rgba) {
+    const i32 a0 = block[0];
+    const i32 a1 = block[1];
+    i32 values[8] = {a0, a1};
+    if (a0 > a1) {
+        for (i32 i = 2; i < 8; ++i) {
+            values[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+        }
+    } else {
+        for (i32 i = 2; i < 6; ++i) {
+            values[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+        }
+        values[6] = 0;
+        values[7] = 255;
+    }
+    
+    u64 indices = 0;
+    for (u32 i = 0; i < 6; ++i) {
+        indices |= static_cast<u64>(block[2 + i]) << (i * 8);
+    }
+    for (u32 i = 0; i < 16; ++i) {
+        rgba[i][3] = static_cast<u8>(values[(indices >> (i * 3)) & 7]);
+    }
+}
+
+/// Expand 1-4 channel texels to RGBA8 the way GL samples them
+void expandToRGBA(const u8* src, size_t count, u32 channels, u8* rgba) {
+    for (size_t i = 0; i < count; ++i) {
+        u8 texel[4] = {0, 0, 0, 255};
+        std::memcpy(texel, src + i * channels, channels);
+        std::memcpy(rgba + i * 4, texel, 4);
+    }
+}
+
+/// Gather a 4x4 block, repeating the last row and column past the edges
+void loadBlock(const u8* rgba, u32 width, u32 height, u32 blockX, u32 blockY, Texels& block) {
+    for (u32 y = 0; y < 4; ++y) {
+        const u32 sy = std::min(blockY * 4 + y, height - 1);
+        for (u32 x = 0; x < 4; ++x) {
+            const u32 sx = std::min(blockX * 4 + x, width - 1);
+            std::memcpy(block[y * 4 + x], rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+void storeBlock(const Texels& block, u32 width, u32 height, u32 blockX, u32 blockY, u8* rgba) {
+    for (u32 y = 0; y < 4 && blockY * 4 + y < height; ++y) {
+        for (u32 x = 0; x < 4 && blockX * 4 + x < width; ++x) {
+            const size_t offset = (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4;
+            std::memcpy(rgba + offset, block[y * 4 + x], 4);
+        }
+    }
+}
+
+bool hasPixels(const TextureImage& image) {
+    return image.width > 0 && image.height > 0 && image.mipCount > 0 &&
+           image.pixels.size() >= renderer::mipChainSize(image.width, image.height, image.mipCount, image.format);
+}
+
+} // anonymous namespace
+
+void encodeBC1Block(const u8 (&rgba)[16][4], u8* block) {
+    bool used[16];
+    std::fill(std::begin(used), std::end(used), true);
+    encodeColorBlock(rgba, used, block);
+}
+
+void encodeBC3Block(const u8 (&rgba)[16][4], u8* block) {
+    encodeAlphaBlock(rgba, block);
+    
+    // Texels that will be discarded do not pull the colors toward black
+    bool used[16];
+    bool anyUsed = false;
+    for (u32 i = 0; i < 16; ++i) {
+        used[i] = rgba[i][3] >= 128;
+        anyUsed |= used[i];
+    }
+    if (!anyUsed) {
+        std::fill(std::begin(used), std::end(used), true);
+    }
+    encodeColorBlock(rgba, used, block + 8);
+}
+
+void decodeBC1Block(const u8* block, u8 (&rgba)[16][4]) {
+    decodeColorBlock(block, false, rgba);
+}
+
+void decodeBC3Block(const u8* block, u8 (&rgba)[16][4]) {
+    decodeColorBlock(block + 8, true, rgba);  // DXT5 color blocks are always four-color
+    decodeAlphaBlock(block, rgba);
+}
+
+Result<TextureImage> compressImage(const TextureImage& image, renderer::TextureFormat format) {
+    if (format != renderer::TextureFormat::BC1 && format != renderer::TextureFormat::BC3) {
+        return std::unexpected(Error{"Only BC1 and BC3 can be encoded: " + image.name});
+    }
+    if (renderer::isBlockCompressed(image.format)) {
+        return std::unexpected(Error{"Texture is already block-compressed: " + image.name});
+    }
+    if (!hasPixels(image)) {
+        return std::unexpected(Error{"Texture has no valid pixel data: " + image.name});
+    }
+    
+    TextureImage result;
+    result.name = image.name;
+    result.width = image.width;
+    result.height = image.height;
+    result.format = format;
+    result.mipCount = image.mipCount;
+    result.pixels.resize(renderer::mipChainSize(image.width, image.height, image.mipCount, format));
+    
+    const u32 channels = renderer::texelSize(image.format);
+    const u32 blockBytes = format == renderer::TextureFormat::BC1 ? 8 : 16;
+    std::vector<u8> rgba;
+    size_t srcOffset = 0;
+    u8* dst = result.pixels.data();
+    for (u32 level = 0; level < image.mipCount; ++level) {
+        const u32 width = std::max(image.width >> level, 1u);
+        const u32 height = std::max(image.height >> level, 1u);
+        const size_t texelCount = static_cast<size_t>(width) * height;
+        rgba.resize(texelCount * 4);
+        expandToRGBA(image.pixels.data() + srcOffset, texelCount, channels, rgba.data());
+        srcOffset += texelCount * channels;
+        
+        for (u32 blockY = 0; blockY < (height + 3) / 4; ++blockY) {
+            for (u32 blockX = 0; blockX < (width + 3) / 4; ++blockX) {
+                Texels block;
+                loadBlock(rgba.data(), width, height, blockX, blockY, block);
+                if (format == renderer::TextureFormat::BC1) {
+                    encodeBC1Block(block, dst);
+                } else {
+                    encodeBC3Block(block, dst);
+                }
+                dst += blockBytes;
+            }
+        }
+    }
+    return result;
+}
+
+Result<TextureImage> decompressImage(const TextureImage& image) {
+    if (image.format != renderer::TextureFormat::BC1 && image.format != renderer::TextureFormat::BC3) {
+        return std::unexpected(Error{"Only BC1 and BC3 can be decoded: " + image.name});
+    }
+    if (!hasPixels(image)) {
+        return std::unexpected(Error{"Texture has no valid pixel data: " + image.name});
+    }
+    
+    TextureImage result;
+    result.name = image.name;
+    result.width = image.width;
+    result.height = image.height;
+    result.format = renderer::TextureFormat::RGBA8;
+    result.mipCount = image.mipCount;
+    result.pixels.resize(renderer::mipChainSize(image.width, image.height, image.mipCount, result.format));
+    
+    const u32 blockBytes = image.format == renderer::TextureFormat::BC1 ? 8 : 16;
+    const u8* src = image.pixels.data();
+    size_t dstOffset = 0;
+    for (u32 level = 0; level < image.mipCount; ++level) {
+        const u32 width = std::max(image.width >> level, 1u);
+        const u32 height = std::max(image.height >> level, 1u);
+        
+        for (u32 blockY = 0; blockY < (height + 3) / 4; ++blockY) {
+            for (u32 blockX = 0; blockX < (width + 3) / 4; ++blockX) {
+                Texels block;
+                if (image.format == renderer::TextureFormat::BC1) {
+                    decodeBC1Block(src, block);
+                } else {
+                    decodeBC3Block(src, block);
+                }
+                storeBlock(block, width, height, blockX, blockY, result.pixels.data() + dstOffset);
+                src += blockBytes;
+            }
+        }
+        dstOffset += static_cast<size_t>(width) * height * 4;
+    }
+    return result;
+}
+
+} // namespace cscpp::assets
@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * @file block_compression.hpp
+ * @brief BC1/BC3 encoding for the cooker and CPU decoding for drivers without S3TC
+ *
+ * The encoder fits each 4x4 block's colors along their principal axis,
+ * insets the endpoints to reduce the rounding error at the extremes, and
+ * refines them once by least squares over the chosen indices. Colors are
+ * always stored with c0 > c1 (four-color mode), so BC1 blocks are opaque.
+ * BC3 alpha uses the eight-value mode between the block's alpha extremes;
+ * its color fit ignores texels with alpha below 128, which are discarded
+ * when sampled. Partial blocks at the edges of small levels repeat the
+ * last row and column.
+ *
+ * Encoding is slow compared to a GPU upload and only meant for offline
+ * cooking. BC7 images are loaded and uploaded, but not encoded or decoded.
+ */
+
+#include "core/types.hpp"
+#include "assets/texture_image.hpp"
+
+namespace cscpp::assets {
+
+/**
+ * @brief Compress every level of an uncompressed image to BC1 or BC3
+ *
+ * 1-3 channel images are expanded the way GL samples them (missing
+ * channels 0, alpha 1) before encoding.
+ */
+Result<TextureImage> compressImage(const TextureImage& image, renderer::TextureFormat format);
+
+/// Decode every level of a BC1 or BC3 image to RGBA8
+Result<TextureImage> decompressImage(const TextureImage& image);
+
+/// Encode one block of 16 RGBA8 texels (row-major) into 8 bytes
+void encodeBC1Block(const u8 (&rgba)[16][4], u8* block);
+
+/// Encode one block of 16 RGBA8 texels (row-major) into 16 bytes
+void encodeBC3Block(const u8 (&rgba)[16][4], u8* block);
+
+/// Decode 8 bytes into 16 RGBA8 texels (opaque, as GL samples RGB DXT1)
+void decodeBC1Block(const u8* block, u8 (&rgba)[16][4]);
+
+/// Decode 16 bytes into 16 RGBA8 texels
+void decodeBC3Block(const u8* block, u8 (&rgba)[16][4]);
+
+} // namespace cscpp::assets
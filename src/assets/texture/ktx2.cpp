@@ -0,0 +1,300 @@
+/**
+ * @file ktx2.cpp
+ * @brief KTX2 header parsing, level extraction and writing
+ */
+
+#include "assets/texture/ktx2.hpp"
+#include "assets/assets.hpp"
+#include "core/platform/mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace cscpp::assets {
+
+namespace {
+
+constexpr u8 KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+struct KTX2Header {
+    u8 identifier[12];
+    u32 vkFormat;
+    u32 typeSize;
+    u32 pixelWidth;
+    u32 pixelHeight;
+    u32 pixelDepth;
+    u32 layerCount;
+    u32 faceCount;
+    u32 levelCount;
+    u32 supercompressionScheme;
+    u32 dfdByteOffset;
+    u32 dfdByteLength;
+    u32 kvdByteOffset;
+    u32 kvdByteLength;
+    u64 sgdByteOffset;
+    u64 sgdByteLength;
+};
+static_assert(sizeof(KTX2Header) == 80);
+
+struct KTX2Level {
+    u64 byteOffset;
+    u64 byteLength;
+    u64 uncompressedByteLength;
+};
+static_assert(sizeof(KTX2Level) == 24);
+
+/// VkFormat values of the supported formats
+enum : u32 {
+    VK_FORMAT_R8_UNORM = 9,
+    VK_FORMAT_R8G8_UNORM = 16,
+    VK_FORMAT_R8G8B8_UNORM = 23,
+    VK_FORMAT_R8G8B8A8_UNORM = 37,
+    VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
+    VK_FORMAT_BC3_UNORM_BLOCK = 137,
+    VK_FORMAT_BC7_UNORM_BLOCK = 145,
+};
+
+/// Data format descriptor color models (Khronos Data Format Specification)
+enum : u8 {
+    KHR_DF_MODEL_RGBSDA = 1,
+    KHR_DF_MODEL_BC1A = 128,
+    KHR_DF_MODEL_BC3 = 130,
+    KHR_DF_MODEL_BC7 = 134,
+};
+
+constexpr u8 KHR_DF_PRIMARIES_BT709 = 1;
+constexpr u8 KHR_DF_TRANSFER_LINEAR = 1;
+constexpr u8 KHR_DF_CHANNEL_ALPHA = 15;
+
+bool toTextureFormat(u32 vkFormat, renderer::TextureFormat& format) {
+    switch (vkFormat) {
+        case VK_FORMAT_R8_UNORM: format = renderer::TextureFormat::R8; return true;
+        case VK_FORMAT_R8G8_UNORM: format = renderer::TextureFormat::RG8; return true;
+        case VK_FORMAT_R8G8B8_UNORM: format = renderer::TextureFormat::RGB8; return true;
+        case VK_FORMAT_R8G8B8A8_UNORM: format = renderer::TextureFormat::RGBA8; return true;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK: format = renderer::TextureFormat::BC1; return true;
+        case VK_FORMAT_BC3_UNORM_BLOCK: format = renderer::TextureFormat::BC3; return true;
+        case VK_FORMAT_BC7_UNORM_BLOCK: format = renderer::TextureFormat::BC7; return true;
+        default: return false;
+    }
+}
+
+u32 toVkFormat(renderer::TextureFormat format) {
+    switch (format) {
+        case renderer::TextureFormat::R8: return VK_FORMAT_R8_UNORM;
+        case renderer::TextureFormat::RG8: return VK_FORMAT_R8G8_UNORM;
+        case renderer::TextureFormat::RGB8: return VK_FORMAT_R8G8B8_UNORM;
+        case renderer::TextureFormat::RGBA8: return VK_FORMAT_R8G8B8A8_UNORM;
+        case renderer::TextureFormat::BC1: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case renderer::TextureFormat::BC3: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case renderer::TextureFormat::BC7: return VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    return 0;
+}
+
+/// Bytes of one texel or block
+u32 elementSize(renderer::TextureFormat format) {
+    return renderer::isBlockCompressed(format) ? static_cast<u32>(renderer::textureLevelSize(1, 1, format))
+                                               : renderer::texelSize(format);
+}
+
+void appendU32(std::vector<u8>& out, u32 value) {
+    const size_t offset = out.size();
+    out.resize(offset + sizeof(value));
+    std::memcpy(out.data() + offset, &value, sizeof(value));
+}
+
+struct DFDSample {
+    u16 bitOffset;
+    u8 bitLength;
+    u8 channel;
+    u32 upper;
+};
+
+/// Basic descriptor block: one sample per channel, or per block half for BC3
+std::vector<u8> buildDataFormatDescriptor(renderer::TextureFormat format) {
+    std::vector<DFDSample> samples;
+    u8 model = KHR_DF_MODEL_RGBSDA;
+    switch (format) {
+        case renderer::TextureFormat::BC1:
+            model = KHR_DF_MODEL_BC1A;
+            samples.push_back({0, 64, 0, ~0u});
+            break;
+        case renderer::TextureFormat::BC3:
+            model = KHR_DF_MODEL_BC3;
+            samples.push_back({0, 64, KHR_DF_CHANNEL_ALPHA, ~0u});
+            samples.push_back({64, 64, 0, ~0u});
+            break;
+        case renderer::TextureFormat::BC7:
+            model = KHR_DF_MODEL_BC7;
+            samples.push_back({0, 128, 0, ~0u});
+            break;
+        default: {
+            static constexpr u8 CHANNELS[4] = {0, 1, 2, KHR_DF_CHANNEL_ALPHA};
+            for (u32 i = 0; i < renderer::texelSize(format); ++i) {
+                samples.push_back({static_cast<u16>(i * 8), 8, CHANNELS[i], 255});
+            }
+            break;
+        }
+    }
+    
+    const bool block = renderer::isBlockCompressed(format);
+    const u32 blockSize = 24 + 16 * static_cast<u32>(samples.size());
+    std::vector<u8> dfd;
+    appendU32(dfd, 4 + blockSize);  // dfdTotalSize
+    appendU32(dfd, 0);  // vendorId KHRONOS, descriptorType BASICFORMAT
+    appendU32(dfd, 2u | (blockSize << 16));  // versionNumber 1.3, descriptorBlockSize
+    dfd.insert(dfd.end(), {model, KHR_DF_PRIMARIES_BT709, KHR_DF_TRANSFER_LINEAR, 0});
+    dfd.insert(dfd.end(), {static_cast<u8>(block ? 3 : 0), static_cast<u8>(block ? 3 : 0), 0, 0});
+    dfd.insert(dfd.end(), {static_cast<u8>(elementSize(format)), 0, 0, 0, 0, 0, 0, 0});  // bytesPlane0-7
+    for (const DFDSample& sample : samples) {
+        appendU32(dfd, sample.bitOffset | (static_cast<u32>(sample.bitLength - 1) << 16) |
+                       (static_cast<u32>(sample.channel) << 24));
+        appendU32(dfd, 0);  // samplePosition
+        appendU32(dfd, 0);  // sampleLower
+        appendU32(dfd, sample.upper);
+    }
+    return dfd;
+}
+
+} // anonymous namespace
+
+Result<TextureImage> loadKTX2File(const std::string& path) {
+    MappedFile file;
+    if (auto opened = file.open(path); !opened) {
+        return std::unexpected(opened.error());
+    }
+    const std::span<const u8> bytes = file.getBytes();
+    
+    KTX2Header header{};
+    if (bytes.size() < sizeof(header)) {
+        return std::unexpected(Error{"File too small for a KTX2 header: " + path});
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        return std::unexpected(Error{"Not a KTX2 file: " + path});
+    }
+    
+    TextureImage image;
+    image.name = path;
+    if (!toTextureFormat(header.vkFormat, image.format)) {
+        return std::unexpected(Error{"Unsupported KTX2 vkFormat " + std::to_string(header.vkFormat) + ": " + path});
+    }
+    if (header.supercompressionScheme != 0) {
+        return std::unexpected(Error{"Supercompressed KTX2 files are not supported: " + path});
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 ||
+        header.layerCount > 1 || header.faceCount != 1) {
+        return std::unexpected(Error{"Only single 2D KTX2 textures are supported: " + path});
+    }
+    
+    // levelCount 0 asks the loader to generate the chain, which finishTexture2D() does for uncompressed formats
+    image.width = header.pixelWidth;
+    image.height = header.pixelHeight;
+    image.mipCount = std::max(header.levelCount, 1u);
+    if (image.mipCount > renderer::mipLevelCount(image.width, image.height)) {
+        return std::unexpected(Error{"Too many KTX2 mip levels: " + path});
+    }
+    
+    const u64 indexSize = static_cast<u64>(image.mipCount) * sizeof(KTX2Level);
+    if (bytes.size() - sizeof(header) < indexSize) {
+        return std::unexpected(Error{"Truncated KTX2 level index: " + path});
+    }
+    
+    image.pixels.resize(renderer::mipChainSize(image.width, image.height, image.mipCount, image.format));
+    size_t dstOffset = 0;
+    for (u32 level = 0; level < image.mipCount; ++level) {
+        KTX2Level entry{};
+        std::memcpy(&entry, bytes.data() + sizeof(header) + level * sizeof(KTX2Level), sizeof(entry));
+        
+        const u32 width = std::max(image.width >> level, 1u);
+        const u32 height = std::max(image.height >> level, 1u);
+        const u64 size = renderer::textureLevelSize(width, height, image.format);
+        if (entry.byteLength != size || entry.byteOffset > bytes.size() || size > bytes.size() - entry.byteOffset) {
+            return std::unexpected(Error{"Corrupt KTX2 level " + std::to_string(level) + ": " + path});
+        }
+        std::memcpy(image.pixels.data() + dstOffset, bytes.data() + entry.byteOffset, size);
+        dstOffset += size;
+    }
+    return image;
+}
+
+Result<void> writeKTX2File(const std::string& path, const TextureImage& image) {
+    if (image.width == 0 || image.height == 0 || image.mipCount == 0 ||
+        image.pixels.size() < renderer::mipChainSize(image.width, image.height, image.mipCount, image.format)) {
+        return std::unexpected(Error{"Texture has no valid pixel data: " + image.name});
+    }
+    
+    const std::vector<u8> dfd = buildDataFormatDescriptor(image.format);
+    KTX2Header header{};
+    std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat = toVkFormat(image.format);
+    header.typeSize = 1;
+    header.pixelWidth = image.width;
+    header.pixelHeight = image.height;
+    header.faceCount = 1;
+    header.levelCount = image.mipCount;
+    header.dfdByteOffset = static_cast<u32>(sizeof(header) + image.mipCount * sizeof(KTX2Level));
+    header.dfdByteLength = static_cast<u32>(dfd.size());
+    
+    // Levels go smallest first, each aligned to lcm(element size, 4)
+    const u64 alignment = std::lcm<u64>(elementSize(image.format), 4);
+    std::vector<KTX2Level> levels(image.mipCount);
+    std::vector<u64> sourceOffsets(image.mipCount);
+    u64 sourceOffset = 0;
+    for (u32 level = 0; level < image.mipCount; ++level) {
+        const u32 width = std::max(image.width >> level, 1u);
+        const u32 height = std::max(image.height >> level, 1u);
+        levels[level].byteLength = renderer::textureLevelSize(width, height, image.format);
+        levels[level].uncompressedByteLength = levels[level].byteLength;
+        sourceOffsets[level] = sourceOffset;
+        sourceOffset += levels[level].byteLength;
+    }
+    u64 offset = header.dfdByteOffset + header.dfdByteLength;
+    for (u32 level = image.mipCount; level-- > 0;) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        levels[level].byteOffset = offset;
+        offset += levels[level].byteLength;
+    }
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return std::unexpected(Error{"Failed to create " + path});
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(KTX2Level)));
+    file.write(reinterpret_cast<const char*>(dfd.data()), static_cast<std::streamsize>(dfd.size()));
+    
+    static constexpr char PADDING[16] = {};
+    u64 written = header.dfdByteOffset + header.dfdByteLength;
+    for (u32 level = image.mipCount; level-- > 0;) {
+        file.write(PADDING, static_cast<std::streamsize>(levels[level].byteOffset - written));
+        file.write(reinterpret_cast<const char*>(image.pixels.data() + sourceOffsets[level]),
+                   static_cast<std::streamsize>(levels[level].byteLength));
+        written = levels[level].byteOffset + levels[level].byteLength;
+    }
+    if (!file.flush()) {
+        return std::unexpected(Error{"Failed to write " + path});
+    }
+    return {};
+}
+
+Result<TextureAsset> loadKTX2(const std::string& path) {
+    auto image = loadKTX2File(path);
+    if (!image) {
+        return std::unexpected(image.error());
+    }
+    
+    TextureAsset asset;
+    asset.width = image->width;
+    asset.height = image->height;
+    asset.format = static_cast<u32>(image->format);
+    asset.mipLevels = image->mipCount;
+    asset.data = std::move(image->pixels);
+    return asset;
+}
+
+} // namespace cscpp::assets
@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * @file ktx2.hpp
+ * @brief KTX2 container reading and writing
+ *
+ * Supports the subset the renderer can upload as stored: 2D textures with
+ * one layer and face, no supercompression, in R8/RG8/RGB8/RGBA8 UNORM or
+ * BC1 (RGB), BC3 and BC7 UNORM. Level data is copied into a TextureImage,
+ * level 0 first. Basis Universal and Zstandard supercompressed files are
+ * rejected; transcode them to one of the formats above offline.
+ *
+ * The writer emits the level index, a basic data format descriptor and the
+ * levels smallest first with the alignment the spec requires, which is
+ * enough for other KTX2 tools to read the files back.
+ */
+
+#include "core/types.hpp"
+#include "assets/texture_image.hpp"
+
+#include <string>
+
+namespace cscpp::assets {
+
+inline constexpr const char* KTX2_EXTENSION = ".ktx2";
+
+/// Read a KTX2 file (safe to call from worker threads)
+Result<TextureImage> loadKTX2File(const std::string& path);
+
+/// Write every level of an image to a KTX2 file
+Result<void> writeKTX2File(const std::string& path, const TextureImage& image);
+
+} // namespace cscpp::assets
@@ -0,0 +1,91 @@
+/**
+ * @file texture_image.cpp
+ * @brief CPU mip chain generation and direct texture upload
+ */
+
+#include "assets/texture_image.hpp"
+#include "assets/texture/block_compression.hpp"
+#include "core/logging/logger.hpp"
+
+#include <algorithm>
+
+namespace cscpp::assets {
+
+void extendMipChain(TextureImage& image) {
+    if (image.mipCount == 0 || image.width == 0 || image.height == 0 || renderer::isBlockCompressed(image.format)) {
+        return;
+    }
+    
+    const u32 channels = renderer::texelSize(image.format);
+    const u32 levels = renderer::mipLevelCount(image.width, image.height);
+    size_t srcOffset = renderer::mipChainSize(image.width, image.height, image.mipCount - 1, image.format);
+    u32 width = std::max(image.width >> (image.mipCount - 1), 1u);
+    u32 height = std::max(image.height >> (image.mipCount - 1), 1u);
+    
+    // 2x2 box filter per level, matching what glGenerateMipmap does on upload
+    image.pixels.resize(renderer::mipChainSize(image.width, image.height, image.mipCount, image.format));
+    image.pixels.reserve(renderer::mipChainSize(image.width, image.height, levels, image.format));
+    while (image.mipCount < levels) {
+        const u32 nextWidth = std::max(width / 2, 1u);
+        const u32 nextHeight = std::max(height / 2, 1u);
+        const size_t dstOffset = image.pixels.size();
+        image.pixels.resize(dstOffset + static_cast<size_t>(nextWidth) * nextHeight * channels);
+        
+        const u8* src = image.pixels.data() + srcOffset;
+        u8* dst = image.pixels.data() + dstOffset;
+        for (u32 y = 0; y < nextHeight; ++y) {
+            const u32 y0 = std::min(y * 2, height - 1);
+            const u32 y1 = std::min(y * 2 + 1, height - 1);
+            for (u32 x = 0; x < nextWidth; ++x) {
+                const u32 x0 = std::min(x * 2, width - 1);
+                const u32 x1 = std::min(x * 2 + 1, width - 1);
+                for (u32 c = 0; c < channels; ++c) {
+                    const u32 sum = src[(y0 * width + x0) * channels + c] + src[(y0 * width + x1) * channels + c] +
+                                    src[(y1 * width + x0) * channels + c] + src[(y1 * width + x1) * channels + c];
+                    dst[(y * nextWidth + x) * channels + c] = static_cast<u8>((sum + 2) / 4);
+                }
+            }
+        }
+        
+        srcOffset = dstOffset;
+        width = nextWidth;
+        height = nextHeight;
+        image.mipCount++;
+    }
+}
+
+u32 createTextureFromImage(const TextureImage& image) {
+    if (renderer::isBlockCompressed(image.format) && !renderer::isTextureFormatSupported(image.format)) {
+        auto decoded = decompressImage(image);
+        if (!decoded) {
+            LOG_ERROR("Texture '{}': {}", image.name, decoded.error().message);
+            return 0;
+        }
+        return createTextureFromImage(*decoded);
+    }
+    
+    if (image.width == 0 || image.height == 0 || image.mipCount == 0 ||
+        image.pixels.size() < renderer::mipChainSize(image.width, image.height, image.mipCount, image.format)) {
+        LOG_ERROR("Texture '{}' has no valid pixel data", image.name);
+        return 0;
+    }
+    
+    const u32 levels = renderer::textureStorageLevels(image.width, image.height, image.mipCount, image.format);
+    const u32 uploaded = std::min(image.mipCount, levels);
+    const u32 textureID = renderer::createTexture2D(image.width, image.height, levels, image.format);
+    if (textureID == 0) {
+        return 0;
+    }
+    
+    size_t offset = 0;
+    for (u32 level = 0; level < uploaded; ++level) {
+        const u32 levelWidth = std::max(image.width >> level, 1u);
+        const u32 levelHeight = std::max(image.height >> level, 1u);
+        renderer::uploadTextureLevel(textureID, level, levelWidth, levelHeight, image.format, image.pixels.data() + offset);
+        offset += renderer::textureLevelSize(levelWidth, levelHeight, image.format);
+    }
+    renderer::finishTexture2D(textureID, uploaded, levels, image.format);
+    return textureID;
+}
+
+} // namespace cscpp::assets
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file texture_image.hpp
+ * @brief Decoded texture pixels, ready for upload
+ */
+
+#include "core/types.hpp"
+#include "renderer/backend/gl_texture.hpp"
+#include <string>
+#include <vector>
+
+namespace cscpp::assets {
+
+// Decoded texture (mip levels packed back to back, level 0 first)
+struct TextureImage {
+    std::string name;
+    u32 width = 0;
+    u32 height = 0;
+    renderer::TextureFormat format = renderer::TextureFormat::RGB8;  // RGBA8 for GoldSrc textures, BCn when cooked
+    u32 mipCount = 1;  // Levels present; uncompressed chains are completed on upload
+    std::vector<u8> pixels;
+};
+
+/**
+ * @brief Append box-filtered levels down to 1x1 after the last level present
+ *
+ * Matches what glGenerateMipmap produces from the same source level.
+ * Block-compressed images are left as they are.
+ */
+void extendMipChain(TextureImage& image);
+
+/**
+ * @brief Create and fill a GL texture from a decoded image (GL thread)
+ *
+ * Block formats the driver cannot sample are decompressed to RGBA8 first.
+ *
+ * @return Texture name, or 0 on failure
+ */
+u32 createTextureFromImage(const TextureImage& image);
+
+/**
+ * @brief Decode a PNG/JPEG/TGA image file (stb_image)
+ *
+ * Safe to call from worker threads.
+ */
+Result<TextureImage> loadImageFile(const std::string& path);
+
+} // namespace cscpp::assets
@@ -0,0 +1,181 @@
+/**
+ * @file palette_convert.cpp
+ * @brief Indexed to RGBA8 kernels and runtime dispatch
+ */
+
+#include "assets/wad/palette_convert.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CSCPP_PALETTE_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define CSCPP_TARGET_AVX2
+    #else
+        #define CSCPP_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define CSCPP_PALETTE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace cscpp::assets {
+
+namespace {
+
+constexpr u8 ALPHA_KEY_INDEX = 255;
+
+u32 packTexel(u8 r, u8 g, u8 b, u8 a) {
+    const u8 bytes[4] = {r, g, b, a};
+    u32 texel = 0;
+    std::memcpy(&texel, bytes, sizeof(texel));
+    return texel;
+}
+
+using ConvertKernel = void (*)(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba);
+
+void convertScalar(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba) {
+    for (size_t i = 0; i < count; ++i) {
+        const u8 index = indices[i];
+        const u32 texel = (alphaKey && index == ALPHA_KEY_INDEX) ? 0 : palette.texels[index];
+        std::memcpy(rgba + i * 4, &texel, sizeof(texel));
+    }
+}
+
+#if defined(CSCPP_PALETTE_X86)
+
+CSCPP_TARGET_AVX2
+void convertAVX2(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba) {
+    const int* table = reinterpret_cast<const int*>(palette.texels);
+    const __m256i keyIndex = _mm256_set1_epi32(ALPHA_KEY_INDEX);
+    const __m256i keyEnabled = alphaKey ? _mm256_set1_epi32(-1) : _mm256_setzero_si256();
+
+    // Two independent gathers per iteration hide part of their latency
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+        const __m256i lo = _mm256_cvtepu8_epi32(packed);
+        const __m256i hi = _mm256_cvtepu8_epi32(_mm_srli_si128(packed, 8));
+
+        __m256i texelsLo = _mm256_i32gather_epi32(table, lo, 4);
+        __m256i texelsHi = _mm256_i32gather_epi32(table, hi, 4);
+        texelsLo = _mm256_andnot_si256(_mm256_and_si256(_mm256_cmpeq_epi32(lo, keyIndex), keyEnabled), texelsLo);
+        texelsHi = _mm256_andnot_si256(_mm256_and_si256(_mm256_cmpeq_epi32(hi, keyIndex), keyEnabled), texelsHi);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4), texelsLo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4 + 32), texelsHi);
+    }
+    convertScalar(indices + i, count - i, palette, alphaKey, rgba + i * 4);
+}
+
+bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;  // The OS does not save YMM state
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(CSCPP_PALETTE_NEON)
+
+/// 256-entry byte lookup: one 64-byte table per quarter, out-of-range lanes keep the previous result
+inline uint8x16_t lookup256(const uint8x16x4_t (&quarters)[4], uint8x16_t index) {
+    uint8x16_t result = vqtbl4q_u8(quarters[0], index);
+    result = vqtbx4q_u8(result, quarters[1], vsubq_u8(index, vdupq_n_u8(64)));
+    result = vqtbx4q_u8(result, quarters[2], vsubq_u8(index, vdupq_n_u8(128)));
+    result = vqtbx4q_u8(result, quarters[3], vsubq_u8(index, vdupq_n_u8(192)));
+    return result;
+}
+
+void convertNEON(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba) {
+    uint8x16x4_t planes[3][4];
+    for (u32 channel = 0; channel < 3; ++channel) {
+        for (u32 quarter = 0; quarter < 4; ++quarter) {
+            planes[channel][quarter] = vld1q_u8_x4(palette.planes[channel] + quarter * 64);
+        }
+    }
+    const uint8x16_t keyIndex = vdupq_n_u8(ALPHA_KEY_INDEX);
+    const uint8x16_t keyEnabled = vdupq_n_u8(alphaKey ? 0xFF : 0x00);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t index = vld1q_u8(indices + i);
+        const uint8x16_t transparent = vandq_u8(vceqq_u8(index, keyIndex), keyEnabled);
+
+        uint8x16x4_t texels;
+        texels.val[0] = vbicq_u8(lookup256(planes[0], index), transparent);
+        texels.val[1] = vbicq_u8(lookup256(planes[1], index), transparent);
+        texels.val[2] = vbicq_u8(lookup256(planes[2], index), transparent);
+        texels.val[3] = vmvnq_u8(transparent);
+        vst4q_u8(rgba + i * 4, texels);  // Interleaves the planes into RGBA
+    }
+    convertScalar(indices + i, count - i, palette, alphaKey, rgba + i * 4);
+}
+
+#endif
+
+struct KernelChoice {
+    ConvertKernel kernel;
+    const char* name;
+};
+
+KernelChoice selectKernel() {
+#if defined(CSCPP_PALETTE_X86)
+    if (cpuHasAVX2()) {
+        return {convertAVX2, "avx2"};
+    }
+#elif defined(CSCPP_PALETTE_NEON)
+    return {convertNEON, "neon"};  // Baseline on AArch64
+#endif
+    return {convertScalar, "scalar"};
+}
+
+const KernelChoice& getKernel() {
+    static const KernelChoice choice = selectKernel();
+    return choice;
+}
+
+} // anonymous namespace
+
+RGBAPalette makeRGBAPalette(const u8 (&colors)[256][3]) {
+    RGBAPalette palette{};
+    for (u32 i = 0; i < 256; ++i) {
+        palette.texels[i] = packTexel(colors[i][0], colors[i][1], colors[i][2], 255);
+        for (u32 channel = 0; channel < 3; ++channel) {
+            palette.planes[channel][i] = colors[i][channel];
+        }
+    }
+    return palette;
+}
+
+RGBAPalette makeGrayscalePalette() {
+    u8 colors[256][3];
+    for (u32 i = 0; i < 256; ++i) {
+        colors[i][0] = colors[i][1] = colors[i][2] = static_cast<u8>(i);
+    }
+    return makeRGBAPalette(colors);
+}
+
+void convertIndexedToRGBA(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba) {
+    getKernel().kernel(indices, count, palette, alphaKey, rgba);
+}
+
+const char* getPaletteConvertKernel() {
+    return getKernel().name;
+}
+
+} // namespace cscpp::assets
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file palette_convert.hpp
+ * @brief Vectorized 8-bit indexed to RGBA8 conversion
+ *
+ * GoldSrc textures are palette indices. The palette is expanded once into a
+ * table of RGBA8 texels, and conversion is a table lookup per pixel: AVX2
+ * gathers 8 texels per instruction, NEON looks up 16 pixels per channel
+ * with byte table instructions. Other targets use the scalar table loop.
+ * The kernel is picked once at runtime from the CPU's features.
+ *
+ * Alpha-keyed textures (names starting with '{') treat index 255 as
+ * transparent; the kernels write it as transparent black.
+ */
+
+#include "core/types.hpp"
+
+namespace cscpp::assets {
+
+/// Palette expanded for conversion (opaque texels, index 255 included)
+struct RGBAPalette {
+    alignas(64) u32 texels[256];  ///< RGBA8 as stored in memory (R in the lowest byte on little-endian)
+    alignas(64) u8 planes[3][256];  ///< Same colors as R, G and B planes (NEON table lookups)
+};
+
+/// Expand a 256 * RGB palette (palette.lmp layout)
+RGBAPalette makeRGBAPalette(const u8 (&colors)[256][3]);
+
+/// Grayscale palette (index i -> i, i, i), used when palette.lmp is missing
+RGBAPalette makeGrayscalePalette();
+
+/// True for GoldSrc names whose index 255 is transparent ("{fence", ...)
+inline bool isAlphaKeyedName(const char* name) {
+    return name[0] == '{';
+}
+
+/**
+ * @brief Convert `count` palette indices to RGBA8
+ *
+ * @param rgba Output, 4 * `count` bytes (no alignment requirement)
+ * @param alphaKey Write index 255 as transparent black (0, 0, 0, 0)
+ */
+void convertIndexedToRGBA(const u8* indices, size_t count, const RGBAPalette& palette, bool alphaKey, u8* rgba);
+
+/// Kernel convertIndexedToRGBA() dispatches to ("avx2", "neon" or "scalar")
+const char* getPaletteConvertKernel();
+
+} // namespace cscpp::assets
@@ -0,0 +1,296 @@
+/**
+ * @file wad_library.cpp
+ * @brief WAD3 index, miptex decoding and texture cache
+ */
+
+#include "assets/wad/wad_library.hpp"
+#include "assets/wad/palette_convert.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "renderer/backend/gl_texture.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+namespace cscpp::assets {
+
+namespace {
+
+/// Widest / tallest texture GoldSrc tools produce
+constexpr u32 MAX_TEXTURE_SIZE = 1024;
+
+constexpr u8 WAD_TYPE_MIPTEX = 0x43;
+
+/// palette.lmp: 256 colors * 3 bytes RGB, expanded for conversion (grayscale if missing)
+struct Palette {
+    u8 colors[256][3] = {};
+    RGBAPalette rgba = makeGrayscalePalette();
+    bool loaded = false;
+    
+    Palette() {
+        // Try multiple paths to find palette.lmp
+        const char* tryPaths[] = {
+            "assets/gfx/palette.lmp",
+            "../assets/gfx/palette.lmp",
+            "../../assets/gfx/palette.lmp",
+            "../../../assets/gfx/palette.lmp",
+            "gfx/palette.lmp"
+        };
+        
+        for (const char* path : tryPaths) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                continue;
+            }
+            file.read(reinterpret_cast<char*>(colors), sizeof(colors));
+            if (!file.good() || file.gcount() != static_cast<std::streamsize>(sizeof(colors))) {
+                LOG_ERROR("Failed to read palette.lmp: expected 768 bytes, got {}", file.gcount());
+                return;
+            }
+            loaded = true;
+            rgba = makeRGBAPalette(colors);
+            LOG_INFO("Loaded palette from: {} (conversion kernel: {})", path, getPaletteConvertKernel());
+            return;
+        }
+        LOG_ERROR("Failed to find palette.lmp file, textures will be grayscale. Tried: {}", tryPaths[0]);
+    }
+};
+
+/// Loaded once per process, on first use (thread-safe static initialization)
+const Palette& getPalette() {
+    static const Palette palette;
+    return palette;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+std::string normalizeTextureName(std::string_view name) {
+    // Names are NUL-padded to 16 bytes
+    const size_t end = name.find('\0');
+    std::string normalized(name.substr(0, end));
+    for (char& c : normalized) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+TextureImage decodeMiptex(std::span<const u8> miptexBytes) {
+    CSCPP_PROFILE_FUNCTION();
+    TextureImage image;
+    bsp::BSPMiptex miptex{};
+    if (miptexBytes.size() < sizeof(miptex)) {
+        return image;
+    }
+    std::memcpy(&miptex, miptexBytes.data(), sizeof(miptex));
+    
+    image.name = std::string(miptex.name, sizeof(miptex.name)).c_str();
+    image.width = miptex.width;
+    image.height = miptex.height;
+    image.format = renderer::TextureFormat::RGBA8;
+    image.mipCount = 0;
+    if (miptex.width == 0 || miptex.height == 0 ||
+        miptex.width > MAX_TEXTURE_SIZE || miptex.height > MAX_TEXTURE_SIZE) {
+        return image;
+    }
+    
+    // The four embedded levels are converted as they are, only the levels below them are filtered
+    const RGBAPalette& palette = getPalette().rgba;
+    const bool alphaKey = isAlphaKeyedName(image.name.c_str());
+    image.pixels.resize(renderer::mipChainSize(miptex.width, miptex.height, bsp::MIPLEVELS, image.format));
+    for (u32 level = 0; level < bsp::MIPLEVELS; ++level) {
+        const u32 width = std::max(miptex.width >> level, 1u);
+        const u32 height = std::max(miptex.height >> level, 1u);
+        const u64 pixelCount = static_cast<u64>(width) * height;
+        if (miptex.offsets[level] == 0 || miptex.offsets[level] + pixelCount > miptexBytes.size()) {
+            break;
+        }
+        
+        u8* rgba = image.pixels.data() + renderer::mipChainSize(miptex.width, miptex.height, level, image.format);
+        convertIndexedToRGBA(miptexBytes.data() + miptex.offsets[level], pixelCount, palette, alphaKey, rgba);
+        image.mipCount++;
+        if (width == 1 && height == 1) {
+            break;
+        }
+    }
+    
+    if (image.mipCount == 0) {
+        LOG_WARN("Texture '{}' pixel data extends beyond its miptex", image.name);
+        image.pixels.clear();
+        return image;
+    }
+    if (image.mipCount < bsp::MIPLEVELS) {
+        LOG_DEBUG("Texture '{}' has {} of {} embedded mip levels", image.name, image.mipCount, bsp::MIPLEVELS);
+    }
+    extendMipChain(image);
+    return image;
+}
+
+// ============================================================================
+// WAD File
+// ============================================================================
+
+Result<void> WADFile::open(const std::string& path) {
+    CSCPP_PROFILE_FUNCTION();
+    m_entries.clear();
+    if (auto mapped = m_file.open(path); !mapped) {
+        return mapped;
+    }
+    
+    const std::span<const u8> file = m_file.getBytes();
+    bsp::WADHeader header{};
+    if (file.size() < sizeof(header)) {
+        return std::unexpected(Error{"WAD file too small: " + path});
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, "WAD3", 4) != 0) {
+        return std::unexpected(Error{"Invalid WAD magic number (expected WAD3): " + path});
+    }
+    if (header.numEntries <= 0 || header.numEntries > 10000 || header.dirOffset < 0 ||
+        static_cast<u64>(header.dirOffset) + static_cast<u64>(header.numEntries) * sizeof(bsp::WADEntry) > file.size()) {
+        return std::unexpected(Error{"Invalid WAD directory: " + path});
+    }
+    
+    // Index every uncompressed miptex; a bad entry only costs that texture
+    m_entries.reserve(static_cast<size_t>(header.numEntries));
+    for (i32 i = 0; i < header.numEntries; ++i) {
+        bsp::WADEntry entry{};
+        std::memcpy(&entry, file.data() + header.dirOffset + i * sizeof(bsp::WADEntry), sizeof(entry));
+        if (entry.type != WAD_TYPE_MIPTEX || entry.compression != 0 || entry.offset < 0 || entry.diskSize <= 0 ||
+            static_cast<u64>(entry.offset) + static_cast<u64>(entry.diskSize) > file.size()) {
+            continue;
+        }
+        // First entry wins, as in the engine
+        m_entries.try_emplace(normalizeTextureName(std::string_view(entry.name, sizeof(entry.name))),
+                              file.subspan(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.diskSize)));
+    }
+    
+    LOG_INFO("Indexed WAD {}: {} textures", path, m_entries.size());
+    return {};
+}
+
+std::span<const u8> WADFile::findMiptex(std::string_view normalizedName) const {
+    auto it = m_entries.find(std::string(normalizedName));
+    return it != m_entries.end() ? it->second : std::span<const u8>{};
+}
+
+// ============================================================================
+// WAD Library
+// ============================================================================
+
+WADLibrary& WADLibrary::shared() {
+    static WADLibrary library;
+    return library;
+}
+
+std::shared_ptr<const TextureImage> WADLibrary::findTexture(std::span<const std::string> wadPaths,
+                                                             std::string_view name) {
+    CSCPP_PROFILE_FUNCTION();
+    const std::string normalized = normalizeTextureName(name);
+    
+    for (const auto& wadPath : wadPaths) {
+        std::shared_ptr<const WADFile> wad;
+        std::span<const u8> entry;
+        std::string key;
+        {
+            std::lock_guard lock(m_mutex);
+            wad = getWAD(wadPath);
+            if (!wad) {
+                continue;
+            }
+            entry = wad->findMiptex(normalized);
+            if (entry.empty()) {
+                continue;
+            }
+            
+            // Same name in two WADs may be two different textures
+            key = wad->getPath() + ':' + normalized;
+            if (auto cached = lookup(key)) {
+                return cached;
+            }
+        }
+        
+        // Decode unlocked so concurrent loads do not queue behind each other;
+        // holding the WAD keeps the entry mapped even through a clear()
+        auto image = std::make_shared<const TextureImage>(decodeMiptex(entry));
+        if (image->pixels.empty()) {
+            LOG_WARN("Invalid miptex '{}' in WAD {}", normalized, wadPath);
+            continue;
+        }
+        
+        std::lock_guard lock(m_mutex);
+        if (auto cached = lookup(key)) {
+            return cached;  // Another thread decoded it meanwhile; share its copy
+        }
+        insert(key, image);
+        return image;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const WADFile> WADLibrary::getWAD(const std::string& path) {
+    auto it = m_wads.find(path);
+    if (it == m_wads.end()) {
+        auto wad = std::make_shared<WADFile>();
+        if (auto opened = wad->open(path); !opened) {
+            LOG_DEBUG("WAD unavailable: {}", opened.error().message);
+            wad.reset();
+        }
+        it = m_wads.emplace(path, std::move(wad)).first;
+    }
+    return it->second;
+}
+
+std::shared_ptr<const TextureImage> WADLibrary::lookup(const std::string& key) {
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) {
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->image;
+}
+
+void WADLibrary::insert(const std::string& key, std::shared_ptr<const TextureImage> image) {
+    m_cachedBytes += image->pixels.size();
+    m_lru.push_front({key, std::move(image)});
+    m_cache[key] = m_lru.begin();
+    
+    // Never evict the entry just added, even if it alone exceeds the budget
+    while (m_cachedBytes > m_cacheBudget && m_lru.size() > 1) {
+        const CacheEntry& oldest = m_lru.back();
+        m_cachedBytes -= oldest.image->pixels.size();
+        m_cache.erase(oldest.key);
+        m_lru.pop_back();
+    }
+}
+
+size_t WADLibrary::getWADCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_wads.size();
+}
+
+size_t WADLibrary::getCachedTextureCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_lru.size();
+}
+
+size_t WADLibrary::getCachedBytes() const {
+    std::lock_guard lock(m_mutex);
+    return m_cachedBytes;
+}
+
+void WADLibrary::clear() {
+    std::lock_guard lock(m_mutex);
+    m_cache.clear();
+    m_lru.clear();
+    m_cachedBytes = 0;
+    m_wads.clear();
+}
+
+} // namespace cscpp::assets
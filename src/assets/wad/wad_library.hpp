@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file wad_library.hpp
+ * @brief Shared WAD3 texture index and decoded texture cache
+ *
+ * Maps share most of their textures through a handful of WADs
+ * (halflife.wad, cs_dust.wad, ...). The library maps each WAD once, hashes
+ * its directory by lowercase name, and keeps decoded RGBA8 textures in an
+ * LRU cache bounded by bytes, so a map change only decodes textures the
+ * previous maps did not use. Images are handed out as shared pointers and
+ * stay valid after eviction for as long as someone holds them.
+ *
+ * All methods are thread-safe. Texture decodes run outside the lock, so
+ * concurrent loads of different textures decode in parallel.
+ */
+
+#include "core/types.hpp"
+#include "core/platform/mapped_file.hpp"
+#include "assets/bsp/bsp_format.hpp"
+#include "assets/texture_image.hpp"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cscpp::assets {
+
+/**
+ * @brief Convert a miptex (header and the pixels after it) to RGBA8 through palette.lmp
+ *
+ * Converts the embedded mip levels directly and box-filters the levels
+ * below them, so the image carries a full chain. Index 255 is transparent
+ * in alpha-keyed ('{') textures. Falls back to grayscale if the palette
+ * cannot be found. Returns an image without pixels if the miptex is invalid.
+ */
+TextureImage decodeMiptex(std::span<const u8> miptexBytes);
+
+/// Lowercase copy of a texture name (lookups are case-insensitive, like GoldSrc)
+std::string normalizeTextureName(std::string_view name);
+
+// ============================================================================
+// WAD File
+// ============================================================================
+
+/**
+ * @brief One mapped WAD3 file with a hashed directory
+ */
+class WADFile {
+public:
+    /// Map a WAD and index its miptex entries
+    Result<void> open(const std::string& path);
+    
+    const std::string& getPath() const { return m_file.getPath(); }
+    size_t getTextureCount() const { return m_entries.size(); }
+    
+    /// Bytes of a miptex entry (header first), empty if the WAD does not have it
+    std::span<const u8> findMiptex(std::string_view normalizedName) const;
+
+private:
+    MappedFile m_file;
+    std::unordered_map<std::string, std::span<const u8>> m_entries;  // lowercase name -> entry
+};
+
+// ============================================================================
+// WAD Library
+// ============================================================================
+
+class WADLibrary {
+public:
+    /// Decoded bytes kept in the LRU cache before the least recently used textures are dropped
+    static constexpr size_t DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024;
+    
+    explicit WADLibrary(size_t cacheBudget = DEFAULT_CACHE_BUDGET)
+        : m_cacheBudget(cacheBudget) {}
+    
+    /// Library shared by every map load in the process
+    static WADLibrary& shared();
+    
+    /**
+     * @brief Decoded texture from the first WAD in the search list that has it
+     * @return nullptr if no WAD in the list has a valid miptex of that name
+     */
+    std::shared_ptr<const TextureImage> findTexture(std::span<const std::string> wadPaths, std::string_view name);
+    
+    /// WADs opened (or found missing) so far
+    size_t getWADCount() const;
+    
+    size_t getCachedTextureCount() const;
+    size_t getCachedBytes() const;
+    
+    /// Drop every mapped WAD and cached texture (e.g. after WADs changed on disk)
+    void clear();
+
+private:
+    struct CacheEntry {
+        std::string key;
+        std::shared_ptr<const TextureImage> image;
+    };
+    
+    /// Mapped WAD for a path, nullptr if it is missing or invalid (both are remembered)
+    std::shared_ptr<const WADFile> getWAD(const std::string& path);
+    
+    /// Cached image for a key, moved to the front of the LRU list
+    std::shared_ptr<const TextureImage> lookup(const std::string& key);
+    
+    void insert(const std::string& key, std::shared_ptr<const TextureImage> image);
+    
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<const WADFile>> m_wads;  // Shared with in-flight decodes
+    
+    size_t m_cacheBudget;
+    size_t m_cachedBytes = 0;
+    std::list<CacheEntry> m_lru;    // Most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> m_cache;
+};
+
+} // namespace cscpp::assets
@@ -0,0 +1,122 @@
+/**
+ * @file entity_renderer.cpp
+ * @brief LOD selection, culling and instance batching of renderable entities
+ */
+
+#include "client/entity_renderer.hpp"
+#include "assets/assets.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "ecs/components/render.hpp"
+#include "ecs/components/transform.hpp"
+#include "ecs/world/world.hpp"
+#include "renderer/frustum.hpp"
+#include "renderer/simple_renderer.hpp"
+
+#include <algorithm>
+
+namespace cscpp::client {
+
+/// Mesh of the LOD level covering `distance`, invalid past the last level
+static MeshHandle selectLOD(ecs::LODComponent& lod, f32 distance) {
+    for (size_t i = 0; i < lod.levels.size(); ++i) {
+        const ecs::LODComponent::Level& level = lod.levels[i];
+        if (distance < level.maxDistance * lod.lodBias) {
+            lod.currentLOD = static_cast<i32>(i);
+            return level.mesh;
+        }
+    }
+    lod.currentLOD = static_cast<i32>(lod.levels.size());
+    return {};
+}
+
+void EntityRenderer::gather(ecs::World& world, const Vec3& eye, std::vector<EntityDraw>& out) {
+    CSCPP_PROFILE_FUNCTION();
+    auto view = world.view<ecs::TransformComponent, ecs::RenderableComponent>();
+    for (const entt::entity entity : view) {
+        const auto& renderable = view.get<ecs::RenderableComponent>(entity);
+        if (!renderable.isVisible()) {
+            continue;
+        }
+        const auto& transform = view.get<ecs::TransformComponent>(entity);
+        MeshHandle mesh = renderable.mesh;
+        if (auto* lod = world.tryGetComponent<ecs::LODComponent>(entity); lod && !lod->levels.empty()) {
+            mesh = selectLOD(*lod, glm::length(transform.position - eye));
+        }
+        if (mesh.isValid()) {
+            out.push_back({mesh, renderable.material, transform.getMatrix()});
+        }
+    }
+}
+
+void EntityRenderer::render(std::span<const EntityDraw> draws, const assets::AssetManager& assets,
+                            const Mat4& viewProjection, renderer::SimpleRenderer& renderer) {
+    CSCPP_PROFILE_FUNCTION();
+    m_visible.clear();
+    m_stats = {};
+    m_stats.entities = static_cast<u32>(draws.size());
+
+    // Residency and frustum tests
+    for (const EntityDraw& draw : draws) {
+        const assets::GPUMesh* gpuMesh = assets.getMesh(draw.mesh);
+        if (!gpuMesh || !gpuMesh->geometry.isValid() || gpuMesh->textureArrays) {
+            m_stats.culled++;
+            continue;
+        }
+        if (gpuMesh->bounds.isValid() && !renderer::Frustum(viewProjection * draw.model).testAABB(gpuMesh->bounds)) {
+            m_stats.culled++;
+            continue;
+        }
+        m_visible.push_back({(static_cast<u64>(draw.mesh.id) << 32) | draw.material.id, gpuMesh, &draw.model});
+    }
+    if (m_visible.empty()) {
+        return;
+    }
+
+    // One contiguous range of the ring for the frame, filled in batch order
+    std::ranges::sort(m_visible, {}, &Visible::key);
+    u32 first = 0;
+    const std::span<renderer::InstanceData> instances =
+        renderer.allocateInstances(static_cast<u32>(m_visible.size()), first);
+    if (instances.empty()) {
+        static bool logged = false;
+        if (!logged) {
+            LOG_WARN("Instance ring full, {} entities not drawn", m_visible.size());
+            logged = true;
+        }
+        m_stats.culled += static_cast<u32>(m_visible.size());
+        return;
+    }
+    for (size_t i = 0; i < m_visible.size(); ++i) {
+        instances[i] = {*m_visible[i].model, Vec4(1.0f)};
+    }
+    m_stats.instances = static_cast<u32>(m_visible.size());
+
+    // A run of one mesh and material draws every entity with each of the mesh's groups
+    for (size_t begin = 0; begin < m_visible.size();) {
+        size_t end = begin + 1;
+        while (end < m_visible.size() && m_visible[end].key == m_visible[begin].key) {
+            end++;
+        }
+        const assets::GPUMesh& mesh = *m_visible[begin].mesh;
+        const u32 count = static_cast<u32>(end - begin);
+        const u32 baseInstance = first + static_cast<u32>(begin);
+
+        // Groups are sorted by texture, each run of one texture is one multi-draw
+        for (size_t group = 0; group < mesh.groups.size();) {
+            const u32 textureID = mesh.groups[group].textureID;
+            m_commands.clear();
+            for (; group < mesh.groups.size() && mesh.groups[group].textureID == textureID; ++group) {
+                const assets::GPUMesh::Group& g = mesh.groups[group];
+                m_commands.push_back({g.indexCount, count, g.firstIndex, g.baseVertex, baseInstance});
+            }
+            renderer.drawInstanced(mesh.geometry, textureID, m_commands);
+            m_stats.draws++;
+        }
+        begin = end;
+    }
+
+    CSCPP_PROFILE_PLOT("Entity instances", static_cast<i64>(m_stats.instances));
+}
+
+} // namespace cscpp::client
@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file entity_renderer.hpp
+ * @brief Instanced drawing of every renderable entity (players, weapons, props)
+ *
+ * Split across the simulation and render threads. gather() makes one pass
+ * over the ECS view of TransformComponent + RenderableComponent, skips
+ * hidden entities and picks each LODComponent's level from the camera
+ * distance, producing plain EntityDraw values for the frame packet.
+ * render() tests the chosen meshes' bounds against the view frustum, sorts
+ * the survivors by mesh and material, writes their model matrices straight
+ * into the renderer's instance ring and turns each run of entities sharing
+ * a mesh and material into one instanced multi-draw per group texture.
+ * Draw calls scale with the number of distinct meshes on screen, not with
+ * the number of entities.
+ *
+ * Material assets are not loaded yet, so the material only separates
+ * batches; textures come from the mesh's groups. Meshes with texture
+ * arrays (maps) are left to the map path.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "renderer/draw_list.hpp"
+
+#include <span>
+#include <vector>
+
+namespace cscpp::assets {
+class AssetManager;
+struct GPUMesh;
+}
+
+namespace cscpp::ecs {
+class World;
+}
+
+namespace cscpp::renderer {
+class SimpleRenderer;
+}
+
+namespace cscpp::client {
+
+/// A visible renderable at its LOD, as captured by EntityRenderer::gather()
+struct EntityDraw {
+    MeshHandle mesh;
+    MaterialHandle material;
+    Mat4 model;
+};
+
+/// Counts of the last render()
+struct EntityRenderStats {
+    u32 entities = 0;           ///< Draws gathered
+    u32 culled = 0;             ///< Not resident or outside the frustum
+    u32 instances = 0;
+    u32 draws = 0;              ///< Instanced multi-draws queued
+};
+
+class EntityRenderer {
+public:
+    /**
+     * @brief Append the visible renderables of a world at their LOD (simulation thread)
+     * @param eye Camera position, for LOD distances
+     */
+    static void gather(ecs::World& world, const Vec3& eye, std::vector<EntityDraw>& out);
+
+    /**
+     * @brief Queue gathered renderables as instanced draws (GL thread)
+     * @param viewProjection Camera matrices of the frame, for frustum culling
+     */
+    void render(std::span<const EntityDraw> draws, const assets::AssetManager& assets, const Mat4& viewProjection,
+                renderer::SimpleRenderer& renderer);
+
+    const EntityRenderStats& getStats() const { return m_stats; }
+
+private:
+    /// A draw that passed culling
+    struct Visible {
+        u64 key;                        // Mesh id, then material id
+        const assets::GPUMesh* mesh;
+        const Mat4* model;              // Into the draws being rendered
+    };
+
+    std::vector<Visible> m_visible;     // Capacity kept across frames
+    std::vector<renderer::DrawIndirectCommand> m_commands;
+    EntityRenderStats m_stats;
+};
+
+} // namespace cscpp::client
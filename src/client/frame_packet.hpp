@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @file frame_packet.hpp
+ * @brief Everything the render thread needs to draw one frame
+ *
+ * The simulation thread fills a packet after its update and publishes it
+ * through a TripleBuffer; the render thread draws the newest one it has.
+ * A packet is a value snapshot: nothing in it points into the ECS or the
+ * camera state, so the simulation is free to run on while it is drawn.
+ * Asset handles are resolved on the render thread, which owns the GL
+ * context and with it the AssetManager.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "client/entity_renderer.hpp"
+
+#include <vector>
+
+namespace cscpp::client {
+
+struct FramePacket {
+    u64 frame = 0;                  ///< Simulation frame that produced it (0 = none yet)
+    f32 interpolation = 0.0f;       ///< Fraction of a fixed tick the transforms are past the last one
+
+    i32 viewportWidth = 0;
+    i32 viewportHeight = 0;
+    Mat4 view{1.0f};
+    Mat4 projection{1.0f};
+    Vec3 cameraPosition{0.0f};
+    f32 cameraYaw = 0.0f;           ///< Degrees, for the debug log only
+    f32 cameraPitch = 0.0f;
+
+    Mat4 viewmodel{1.0f};           ///< For the test weapon, drawn directly if the streamed one failed
+
+    std::vector<EntityDraw> entities;   ///< Capacity kept across frames (TripleBuffer reuses packets)
+};
+
+} // namespace cscpp::client
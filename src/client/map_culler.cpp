@@ -0,0 +1,152 @@
+/**
+ * @file map_culler.cpp
+ * @brief PVS and frustum culling of map faces
+ */
+
+#include "client/map_culler.hpp"
+#include "assets/assets.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "renderer/frustum.hpp"
+
+#include <algorithm>
+
+namespace cscpp::client {
+
+Result<void> MapCuller::loadVisibility(const std::string& bspPath) {
+    const std::string searchPaths[] = {
+        bspPath,
+        "../" + bspPath,
+        "../../" + bspPath,
+    };
+    
+    Result<void> result = std::unexpected(Error{"Map not found: " + bspPath});
+    for (const auto& path : searchPaths) {
+        assets::bsp::BSPView view;
+        const Result<void> opened = view.open(path);
+        
+        // The cooked map carries the PVS already decompressed
+        assets::cooked::CookedMapView cookedView;
+        if (cookedView.open(assets::cooked::cookedPathFor(path)) && (!opened || cookedView.isCookedFrom(view))) {
+            result = m_visibility.load(cookedView);
+            if (result) {
+                break;
+            }
+        }
+        if (opened) {
+            result = m_visibility.load(view);
+            break;
+        }
+    }
+    
+    m_cameraLeaf = -1;
+    return result;
+}
+
+void MapCuller::cull(const assets::GPUMesh& map, Vec3 eye, const Mat4& clipFromMesh) {
+    CSCPP_PROFILE_FUNCTION();
+    m_commands.clear();
+    m_batches.clear();
+    m_stats = {};
+    
+    const assets::MapCulling& culling = map.culling;
+    const bool culled = !culling.empty();
+    if (culled) {
+        // A new arena (first frame, hot reload) invalidates the cached leaf
+        if (map.geometry.getVertexArray() != m_mapVertexArray || m_faceFrame.size() != culling.faces.size()) {
+            m_mapVertexArray = map.geometry.getVertexArray();
+            m_faceFrame.assign(culling.faces.size(), 0);
+            m_frame = 0;
+            m_cameraLeaf = -1;
+        }
+        if (++m_frame == 0) {
+            std::ranges::fill(m_faceFrame, 0u);
+            m_frame = 1;
+        }
+        
+        // The tree is in GoldSrc coordinates, mesh space swaps X and Z (see SimpleBSPLoader)
+        i32 leaf = 0;
+        if (m_visibility.isLoaded() && m_visibility.getLeafCount() == culling.leaves.size()) {
+            leaf = m_visibility.findLeaf(Vec3(eye.z, eye.y, eye.x));
+        }
+        if (leaf != m_cameraLeaf) {
+            updatePotentiallyVisible(map, leaf);
+        }
+        
+        const renderer::Frustum frustum(clipFromMesh);
+        for (u32 index : m_potentiallyVisible) {
+            const assets::MapCulling::Leaf& visibleLeaf = culling.leaves[index];
+            if (!frustum.testAABB(visibleLeaf.bounds)) {
+                continue;
+            }
+            m_stats.visibleLeaves++;
+            for (u32 i = 0; i < visibleLeaf.faceCount; ++i) {
+                m_faceFrame[culling.leafFaces[visibleLeaf.firstFace + i]] = m_frame;
+            }
+        }
+        for (u32 face : culling.unculledFaces) {
+            m_faceFrame[face] = m_frame;
+        }
+    }
+    
+    // Groups are sorted by texture: each run becomes one batch, adjacent visible faces one command
+    const auto& groups = map.groups;
+    u32 batchStart = 0;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const assets::GPUMesh::Group& group = groups[i];
+        const u32 layer = map.textureArrays ? group.textureLayer : 0;
+        
+        if (!culled) {
+            m_commands.push_back({group.indexCount, 1, group.firstIndex, group.baseVertex, layer});
+        } else {
+            const size_t groupStart = m_commands.size();
+            for (u32 f = group.firstFace; f < group.firstFace + group.faceCount; ++f) {
+                if (m_faceFrame[f] != m_frame) {
+                    continue;
+                }
+                const assets::MapCulling::Face& face = culling.faces[f];
+                m_stats.visibleFaces++;
+                if (m_commands.size() > groupStart) {
+                    renderer::DrawIndirectCommand& last = m_commands.back();
+                    if (last.firstIndex + last.indexCount == face.firstIndex) {
+                        last.indexCount += face.indexCount;
+                        continue;
+                    }
+                }
+                m_commands.push_back({face.indexCount, 1, face.firstIndex, group.baseVertex, layer});
+            }
+        }
+        
+        if (i + 1 == groups.size() || groups[i + 1].textureID != group.textureID) {
+            const u32 commandCount = static_cast<u32>(m_commands.size()) - batchStart;
+            if (commandCount > 0) {
+                m_batches.push_back({group.textureID, batchStart, commandCount});
+            }
+            batchStart = static_cast<u32>(m_commands.size());
+        }
+    }
+    
+    m_stats.cameraLeaf = m_cameraLeaf;
+    m_stats.potentiallyVisibleLeaves = static_cast<u32>(m_potentiallyVisible.size());
+    CSCPP_PROFILE_PLOT("Map visible leaves", static_cast<i64>(m_stats.visibleLeaves));
+    CSCPP_PROFILE_PLOT("Map visible faces", static_cast<i64>(m_stats.visibleFaces));
+}
+
+void MapCuller::updatePotentiallyVisible(const assets::GPUMesh& map, i32 leaf) {
+    CSCPP_PROFILE_FUNCTION();
+    const auto& leaves = map.culling.leaves;
+    
+    // Leaf 0 is the shared solid leaf: outside the map everything may be visible
+    const u64* pvs = leaf > 0 ? m_visibility.getPVS(leaf) : nullptr;
+    m_potentiallyVisible.clear();
+    for (u32 i = 1; i < leaves.size(); ++i) {
+        if (leaves[i].faceCount > 0 && m_visibility.isLeafVisible(pvs, static_cast<i32>(i))) {
+            m_potentiallyVisible.push_back(i);
+        }
+    }
+    m_cameraLeaf = leaf;
+}
+
+} // namespace cscpp::client
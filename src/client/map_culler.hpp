@@ -0,0 +1,86 @@
+#pragma once
+
+/**
+ * @file map_culler.hpp
+ * @brief Per-frame visible face set of the map (PVS + view frustum)
+ *
+ * The camera's leaf is found through the BSP node tree and its PVS row
+ * gives the leaves that can be seen from it; that list is cached until the
+ * camera crosses into another leaf. Every frame the cached leaves are
+ * tested against the view frustum and the faces of the survivors become
+ * indirect draw commands, adjacent faces of a group merged into one
+ * command, one batch per run of groups sharing a texture.
+ *
+ * Without visibility data (or with the camera in solid space) every leaf
+ * is frustum tested; a mesh without leaves (test mesh) is drawn whole.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "network/interest/map_visibility.hpp"
+#include "renderer/draw_list.hpp"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cscpp::assets {
+struct GPUMesh;
+}
+
+namespace cscpp::client {
+
+/// Commands of one run of groups sharing a texture
+struct MapBatch {
+    u32 textureID = 0;
+    u32 firstCommand = 0;
+    u32 commandCount = 0;
+};
+
+/// Counts of the last cull()
+struct MapCullStats {
+    i32 cameraLeaf = 0;
+    u32 potentiallyVisibleLeaves = 0;
+    u32 visibleLeaves = 0;
+    u32 visibleFaces = 0;
+};
+
+class MapCuller {
+public:
+    /// Load leaf lookup and PVS for a map (its cooked map if current, otherwise the BSP)
+    Result<void> loadVisibility(const std::string& bspPath);
+    
+    /**
+     * @brief Build the draw commands of the faces visible this frame
+     * @param eye Camera position in mesh space (before the map's model matrix)
+     * @param clipFromMesh viewProjection * model of the map
+     */
+    void cull(const assets::GPUMesh& map, Vec3 eye, const Mat4& clipFromMesh);
+    
+    std::span<const MapBatch> getBatches() const { return m_batches; }
+    
+    /// Commands of a batch from getBatches()
+    std::span<const renderer::DrawIndirectCommand> getCommands(const MapBatch& batch) const {
+        return std::span<const renderer::DrawIndirectCommand>(m_commands).subspan(batch.firstCommand, batch.commandCount);
+    }
+    
+    const MapCullStats& getStats() const { return m_stats; }
+
+private:
+    /// Rebuild the leaf list from the PVS of `leaf` (0 = every leaf)
+    void updatePotentiallyVisible(const assets::GPUMesh& map, i32 leaf);
+    
+    network::MapVisibility m_visibility;
+    
+    u32 m_mapVertexArray = 0;                   ///< Arena the cached state below belongs to
+    i32 m_cameraLeaf = -1;                      ///< -1 = nothing cached
+    std::vector<u32> m_potentiallyVisible;      ///< Leaves in the camera leaf's PVS
+    std::vector<u32> m_faceFrame;               ///< Frame a face was last marked visible
+    u32 m_frame = 0;
+    
+    std::vector<renderer::DrawIndirectCommand> m_commands;  // Capacity kept across frames
+    std::vector<MapBatch> m_batches;
+    MapCullStats m_stats;
+};
+
+} // namespace cscpp::client
@@ -4,13 +4,34 @@
  * 
  * This is the main entry point for the Counter-Strike C++ game client.
  * It initializes all subsystems and runs the main game loop.
+ *
+ * The main thread pumps events and simulates; after each update it fills a
+ * FramePacket (camera, entity draws, viewmodel) and publishes it through a
+ * TripleBuffer. A render thread owns the GL context, the asset streaming
+ * and the renderer, and draws the newest packet at its own pace. Neither
+ * thread waits for the other, so a slow tick does not drop frames and the
+ * frame rate is not tied to the tick rate.
  */
 
 #include "core/core.hpp"
+#include "core/profiling/profiler.hpp"
+#include "core/jobs/spsc_ring.hpp"
+#include "core/jobs/triple_buffer.hpp"
+#include "core/memory/allocation_counter.hpp"
+#include "core/metrics/metrics.hpp"
+#include "core/time/tick_pacer.hpp"
 #include "ecs/ecs.hpp"
 #include "renderer/simple_renderer.hpp"
+#include "renderer/backend/gl_upload_queue.hpp"
+#include "assets/assets.hpp"
 #include "assets/bsp/simple_bsp_loader.hpp"
 #include "assets/gltf/simple_gltf_loader.hpp"
+#include "client/entity_renderer.hpp"
+#include "client/frame_packet.hpp"
+#include "client/map_culler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <SDL2/SDL.h>
 #include <glad/glad.h>
@@ -54,32 +75,38 @@ public:
         auto fbSize = m_window.getFramebufferSize();
         m_renderer.setViewport(fbSize.x, fbSize.y);
         
-        // Load map
-        assets::SimpleBSPLoader bspLoader;
-        auto mapResult = bspLoader.load("assets/maps/de_dust2.bsp");
+        // Stream map and weapon: decoded on workers, uploaded a budget's worth per frame
+        m_jobs.initialize(JobSystem::defaultWorkerCount());
+        auto uploadResult = m_uploads.initialize();
+        if (!uploadResult) {
+            LOG_WARN("{}, uploading directly", uploadResult.error().message);
+        }
+        m_assets.initialize(&m_jobs, m_uploads);
+        
+        auto mapResult = m_assets.loadMesh("assets/maps/de_dust2.bsp");
         if (mapResult) {
-            m_mapMesh = std::move(*mapResult);  // Move instead of copy
-            LOG_INFO("Map loaded successfully");
-            LOG_INFO("Map has {} textures loaded", m_mapMesh.textureMap.size());
-            if (!m_mapMesh.textureMap.empty()) {
-                for (const auto& [index, texID] : m_mapMesh.textureMap) {
-                    LOG_INFO("  Texture index {} -> OpenGL texture ID {}", index, texID);
-                }
-            }
+            m_mapHandle = *mapResult;
         } else {
             LOG_WARN("Failed to load map, using test mesh: {}", mapResult.error().message);
-            m_mapMesh = std::move(bspLoader.createTestMesh());  // Move instead of copy
+            m_fallbackMap = toGPUMesh(assets::SimpleBSPLoader().createTestMesh());
         }
         
-        // Load weapon
-        assets::SimpleGLTFLoader gltfLoader;
-        auto weaponResult = gltfLoader.load("assets/weapons/ak-47/scene.gltf");
+        // Leaf tree and PVS for map culling (small next to the streamed mesh, loaded up front)
+        if (auto visResult = m_mapCuller.loadVisibility("assets/maps/de_dust2.bsp"); !visResult) {
+            LOG_WARN("No map visibility, culling against the view frustum only: {}", visResult.error().message);
+        }
+        
+        auto weaponResult = m_assets.loadMesh("assets/weapons/ak-47/scene.gltf");
         if (weaponResult) {
-            m_weaponModel = std::move(*weaponResult);  // Move instead of copy
-            LOG_INFO("Weapon loaded successfully");
+            m_weaponHandle = *weaponResult;
+            
+            // The viewmodel is an entity like any other, drawn instanced by m_entityRenderer
+            m_viewmodel = m_world->createEntity();
+            m_world->addComponent<ecs::TransformComponent>(m_viewmodel);
+            m_world->addComponent<ecs::RenderableComponent>(m_viewmodel).mesh = m_weaponHandle;
         } else {
             LOG_WARN("Failed to load weapon, using test mesh: {}", weaponResult.error().message);
-            m_weaponModel = std::move(gltfLoader.createTestWeaponMesh());  // Move instead of copy
+            m_fallbackWeapon = toGPUMesh(assets::SimpleGLTFLoader().createTestWeaponMesh());
         }
         
         // Set up camera inside the map (de_dust2 spawn area)
@@ -95,6 +122,10 @@ public:
         m_window.setCursorCaptured(true);
         m_input.setCursorCaptured(true);
         
+        // Handed to the render thread for the duration of run()
+        m_glWindow = SDL_GL_GetCurrentWindow();
+        m_glContext = SDL_GL_GetCurrentContext();
+        
         LOG_INFO("Client initialized successfully");
         return true;
     }
@@ -103,6 +134,14 @@ public:
         LOG_INFO("Client shutting down...");
         
         m_world.reset();
+        
+        // GL resources go before the context
+        m_assets.shutdown();
+        m_fallbackMap = {};
+        m_fallbackWeapon = {};
+        m_uploads.shutdown();
+        m_jobs.shutdown();
+        
         m_window.destroy();
         
         Logger::shutdown();
@@ -111,11 +150,21 @@ public:
     void run() {
         LOG_INFO("Starting main loop");
         
+        // The render thread owns the GL context until it exits
+        SDL_GL_MakeCurrent(m_glWindow, nullptr);
+        m_renderThread = std::thread([this] { renderLoop(); });
+        
+        TickPacer pacer(framePacerConfig());
+        pacer.start();
+        
         auto lastTime = Clock::now();
         f32 accumulator = 0.0f;
         constexpr f32 FIXED_TIMESTEP = 1.0f / 128.0f;  // 128 tick
         
-        while (m_running) {
+        while (m_running.load(std::memory_order_relaxed)) {
+            pacer.waitForTick();
+            const AllocationScope frameAllocations;
+            
             // Calculate delta time
             auto currentTime = Clock::now();
             f32 deltaTime = std::chrono::duration<f32>(currentTime - lastTime).count();
@@ -138,6 +187,7 @@ public:
             // Fixed timestep for physics
             accumulator += deltaTime;
             while (accumulator >= FIXED_TIMESTEP) {
+                CSCPP_PROFILE_ZONE("Fixed update");
                 fixedUpdate(FIXED_TIMESTEP);
                 accumulator -= FIXED_TIMESTEP;
             }
@@ -145,13 +195,18 @@ public:
             // Variable timestep update
             update(deltaTime);
             
-            // Render with interpolation
+            // Hand the frame to the render thread with interpolation
             f32 alpha = accumulator / FIXED_TIMESTEP;
-            render(alpha);
-            
-            // Swap buffers
-            m_window.swapBuffers();
+            publishFrame(alpha);
+            m_simulationAllocations.add(frameAllocations.getCount());
+            CSCPP_PROFILE_PLOT("Simulation frame allocations", static_cast<i64>(frameAllocations.getCount()));
+            CSCPP_PROFILE_FRAME_NAMED("Simulation");
+            pacer.endTick();
         }
+        
+        m_running = false;
+        m_renderThread.join();
+        SDL_GL_MakeCurrent(m_glWindow, m_glContext);
     }
     
 private:
@@ -222,11 +277,121 @@ private:
         updateCamera(dt);
     }
     
-    void render(f32 interpolation) {
-        (void)interpolation;
+    void updateAssets() {
+        m_assets.update();
+        
+#ifndef NDEBUG
+        // Swap in re-cooked maps and edited models without restarting
+        static u32 updateCount = 0;
+        if (++updateCount % 60 == 0) {
+            m_assets.reloadChanged();
+        }
+#endif
+        
+        // Failed loads fall back to the procedural test meshes
+        if (m_assets.getState(m_mapHandle) == assets::AssetState::Failed && m_fallbackMap.groups.empty()) {
+            LOG_WARN("Map failed to stream, using test mesh");
+            m_fallbackMap = toGPUMesh(assets::SimpleBSPLoader().createTestMesh());
+        }
+        if (m_assets.getState(m_weaponHandle) == assets::AssetState::Failed && m_fallbackWeapon.groups.empty()) {
+            LOG_WARN("Weapon failed to stream, using test mesh");
+            m_fallbackWeapon = toGPUMesh(assets::SimpleGLTFLoader().createTestWeaponMesh());
+        }
+        
+        // The simulation keeps the camera inside the map without touching the asset manager
+        const assets::GPUMesh* mapMesh = resolveMesh(m_mapHandle, m_fallbackMap);
+        if (mapMesh != m_mapBoundsSource && mapMesh && m_mapBoundsUpdates.tryPush(mapMesh->bounds)) {
+            m_mapBoundsSource = mapMesh;
+        }
+    }
+    
+    /// Streamed mesh once resident, otherwise the fallback (nullptr if there is none yet)
+    const assets::GPUMesh* resolveMesh(MeshHandle handle, const assets::GPUMesh& fallback) const {
+        if (const assets::GPUMesh* mesh = m_assets.getMesh(handle)) {
+            return mesh;
+        }
+        return fallback.groups.empty() ? nullptr : &fallback;
+    }
+    
+    static assets::GPUMesh toGPUMesh(assets::SimpleBSPMesh&& map) {
+        // Same arena layout the asset manager builds, groups sorted by texture
+        std::ranges::stable_sort(map.groups, {}, &assets::BSPMeshGroup::textureID);
+        std::vector<renderer::Vertex> vertices;
+        std::vector<u32> indices;
+        assets::GPUMesh mesh;
+        for (const auto& group : map.groups) {
+            mesh.groups.push_back({static_cast<u32>(indices.size()), static_cast<u32>(group.indices.size()),
+                                   static_cast<i32>(vertices.size()), group.textureID, 0});
+            vertices.insert(vertices.end(), group.vertices.begin(), group.vertices.end());
+            indices.insert(indices.end(), group.indices.begin(), group.indices.end());
+        }
+        mesh.geometry.create(vertices, indices);
+        mesh.bounds = map.bounds;
+        return mesh;
+    }
+    
+    static assets::GPUMesh toGPUMesh(assets::SimpleModel&& model) {
+        assets::GPUMesh mesh;
+        if (model.loaded) {
+            mesh.groups.push_back({0, model.mesh.getIndexCount(), 0, model.textureID, 0});
+            mesh.geometry = std::move(model.mesh);
+        }
+        return mesh;
+    }
+    
+    /// Frame limiter of both threads: fps_max, frames past it are dropped rather than caught up
+    static TickPacerConfig framePacerConfig() {
+        TickPacerConfig config;
+        config.tickRate = FPS_MAX;
+        config.maxCatchUpTicks = 0;
+        return config;
+    }
+    
+    void renderLoop() {
+        CSCPP_PROFILE_THREAD("Render");
+        SDL_GL_MakeCurrent(m_glWindow, m_glContext);
+        
+        TickPacer pacer(framePacerConfig());
+        pacer.start();
+        while (m_running.load(std::memory_order_relaxed)) {
+            pacer.waitForTick();
+            const AllocationScope frameAllocations;
+            
+            // The newest packet, or the last one again if the simulation is behind
+            m_packets.acquire();
+            const client::FramePacket& packet = m_packets.front();
+            
+            // Upload streamed assets within this frame's budget
+            m_uploads.beginFrame();
+            updateAssets();
+            
+            if (packet.frame != 0) {
+                render(packet);
+            }
+            
+            // Swap buffers
+            m_uploads.endFrame();
+            m_renderer.endFrame();
+            m_window.swapBuffers();
+            m_renderAllocations.add(frameAllocations.getCount());
+            CSCPP_PROFILE_PLOT("Render frame allocations", static_cast<i64>(frameAllocations.getCount()));
+            CSCPP_PROFILE_FRAME();
+            pacer.endTick();
+        }
+        
+        SDL_GL_MakeCurrent(m_glWindow, nullptr);
+    }
+    
+    /// Capture the camera and renderables of this frame into the back packet and publish it
+    void publishFrame(f32 interpolation) {
+        CSCPP_PROFILE_FUNCTION();
+        client::FramePacket& packet = m_packets.back();
+        packet.frame = ++m_frameIndex;
+        packet.interpolation = interpolation;
         
         auto fbSize = m_window.getFramebufferSize();
-        m_renderer.setViewport(fbSize.x, fbSize.y);
+        packet.viewportWidth = fbSize.x;
+        packet.viewportHeight = fbSize.y;
         
         // 1. CALCULATE VECTORS
         // Must match updateCamera logic exactly
@@ -255,28 +420,59 @@ private:
         f32 aspect = static_cast<f32>(fbSize.x) / static_cast<f32>(fbSize.y);
         Mat4 projection = math::perspective(math::radians(90.0f), aspect, 0.1f, 10000.0f);
         
+        packet.view = view;
+        packet.projection = projection;
+        packet.cameraPosition = m_cameraPosition;
+        packet.cameraYaw = m_cameraYaw;
+        packet.cameraPitch = m_cameraPitch;
+        
+        // First-person weapon: right side, slightly down, in front, turned with the camera
+        // (glTF models are in meters, scaled to a reasonable weapon size)
+        const Vec3 weaponOffset = Vec3(0.3f, -0.2f, 0.0f);
+        const Quat weaponRotation = glm::angleAxis(glm::radians(-m_cameraYaw), Vec3(0.0f, 1.0f, 0.0f)) *
+                                    glm::angleAxis(glm::radians(-m_cameraPitch), Vec3(1.0f, 0.0f, 0.0f));
+        packet.viewmodel = math::compose(m_cameraPosition + weaponOffset, weaponRotation, Vec3(2.5f));
+        if (m_world->isValid(m_viewmodel)) {
+            auto& transform = m_world->getComponent<ecs::TransformComponent>(m_viewmodel);
+            transform.position = m_cameraPosition + weaponOffset;
+            transform.rotation = weaponRotation;
+            transform.scale = Vec3(2.5f);
+        }
+        
+        packet.entities.clear();
+        client::EntityRenderer::gather(*m_world, m_cameraPosition, packet.entities);
+        m_packets.publish();
+    }
+    
+    /// Draw a frame packet (render thread)
+    void render(const client::FramePacket& packet) {
+        CSCPP_PROFILE_FUNCTION();
+        
+        m_renderer.setViewport(packet.viewportWidth, packet.viewportHeight);
+        const Mat4& view = packet.view;
+        const Mat4& projection = packet.projection;
         m_renderer.setCamera(view, projection);
         
         // Clear with a visible color to test
         m_renderer.clear(Vec3(0.2f, 0.2f, 0.3f));
         
         // Render map
+        const assets::GPUMesh* mapMesh = resolveMesh(m_mapHandle, m_fallbackMap);
         static bool firstRender = true;
         static u32 renderCount = 0;
         renderCount++;
         
         if (firstRender) {
             LOG_INFO("First render - Camera pos: ({}, {}, {}), Yaw: {}, Pitch: {}", 
-                     m_cameraPosition.x, m_cameraPosition.y, m_cameraPosition.z,
-                     m_cameraYaw, m_cameraPitch);
-            LOG_INFO("Map mesh loaded: {}, groups: {}", m_mapMesh.loaded, m_mapMesh.groups.size());
-            LOG_INFO("Weapon mesh loaded: {}, valid: {}", m_weaponModel.loaded, m_weaponModel.mesh.isValid());
+                     packet.cameraPosition.x, packet.cameraPosition.y, packet.cameraPosition.z,
+                     packet.cameraYaw, packet.cameraPitch);
+            LOG_INFO("Assets streaming: {}", m_assets.getPendingCount());
             LOG_INFO("Shader valid: {}", m_renderer.getShader().isValid());
             firstRender = false;
         }
         
         // Always try to render - even if there are issues, we should see something
-        if (m_mapMesh.loaded && !m_mapMesh.groups.empty()) {
+        if (mapMesh) {
             // WORKING TRANSFORMATION (discovered through testing):
             // This transformation correctly orients the GoldSrc BSP map to OpenGL coordinate system
             Mat4 mapModel = glm::mat4(1.0f);
@@ -288,86 +484,55 @@ private:
             // 2. Rotate 180° around Y axis
             
             
-            // Render each mesh group with its corresponding texture
-            u32 renderedGroups = 0;
+            // Faces of the leaves in the camera leaf's PVS that pass the frustum test, one multi-draw per texture
+            const Vec3 eye = Vec3(glm::inverse(mapModel) * Vec4(packet.cameraPosition, 1.0f));
+            m_mapCuller.cull(*mapMesh, eye, projection * view * mapModel);
             u32 renderedWithTexture = 0;
             u32 renderedWithoutTexture = 0;
-            for (const auto& group : m_mapMesh.groups) {
-                if (!group.mesh.isValid()) continue;
-                
-                if (group.textureID != 0) {
-                    // Render with texture
-                    m_renderer.drawMeshWithTexture(group.mesh, mapModel, group.textureID, Vec3(1.0f, 1.0f, 1.0f));
+            for (const client::MapBatch& batch : m_mapCuller.getBatches()) {
+                // Untextured groups get the checkerboard pattern
+                const Vec3 color = batch.textureID != 0 ? Vec3(1.0f) : Vec3(0.8f);
+                m_renderer.drawMeshGroups(mapMesh->geometry, mapModel, batch.textureID, mapMesh->textureArrays,
+                                          mapMesh->lightmapTexture, m_mapCuller.getCommands(batch), color);
+                if (batch.textureID != 0) {
                     renderedWithTexture++;
                 } else {
-                    // Render without texture (checkerboard pattern)
-                    m_renderer.drawMesh(group.mesh, mapModel, Vec3(0.8f, 0.8f, 0.8f));
                     renderedWithoutTexture++;
                 }
-                renderedGroups++;
             }
             
             // Debug: log texture usage on first render
             static bool firstTextureLog = true;
             if (firstTextureLog) {
-                LOG_INFO("Rendering {} groups: {} with textures, {} without textures (need WAD files)", 
-                         renderedGroups, renderedWithTexture, renderedWithoutTexture);
+                LOG_INFO("Rendering {} batches: {} with textures, {} without textures (need WAD files)", 
+                         renderedWithTexture + renderedWithoutTexture, renderedWithTexture, renderedWithoutTexture);
                 firstTextureLog = false;
             }
             
             // Debug: log camera and map info occasionally
             if (renderCount % 300 == 0) {
-                u32 totalVertices = 0;
-                u32 totalIndices = 0;
-                for (const auto& group : m_mapMesh.groups) {
-                    totalVertices += static_cast<u32>(group.vertices.size());
-                    totalIndices += static_cast<u32>(group.indices.size());
-                }
-                LOG_INFO("Rendering map - Camera: ({:.1f}, {:.1f}, {:.1f}), {} groups, {} vertices, {} indices", 
-                         m_cameraPosition.x, m_cameraPosition.y, m_cameraPosition.z,
-                         renderedGroups, totalVertices, totalIndices);
+                const client::MapCullStats& cullStats = m_mapCuller.getStats();
+                LOG_INFO("Rendering map - Camera: ({:.1f}, {:.1f}, {:.1f}), leaf {}, {}/{} leaves, {} faces", 
+                         packet.cameraPosition.x, packet.cameraPosition.y, packet.cameraPosition.z, cullStats.cameraLeaf,
+                         cullStats.visibleLeaves, cullStats.potentiallyVisibleLeaves, cullStats.visibleFaces);
+                
+                // Both should stay flat once streaming is done (this log line allocates a few itself)
+                LOG_INFO("Heap allocations - simulation: {}, render: {}, streaming: {}",
+                         m_simulationAllocations.get(), m_renderAllocations.get(), m_assets.getPendingCount());
             }
         } else if (renderCount == 60) {
-            // Log every second (assuming 60 FPS) if meshes aren't valid
-            LOG_WARN("Map mesh not rendering - loaded: {}, groups: {}", m_mapMesh.loaded, m_mapMesh.groups.size());
+            // Log every second (assuming 60 FPS) while the map is still streaming
+            LOG_WARN("Map mesh not rendering - state: {}", static_cast<u32>(m_assets.getState(m_mapHandle)));
         }
         
-         if (m_weaponModel.loaded && m_weaponModel.mesh.isValid()) {
-             // Position weapon in first-person view position
-             // Use camera's orientation vectors to position weapon relative to view
-             
-             // Weapon offset in camera space: right, down, forward
-             f32 rightOffset = 0.3f;   // Slightly to the right
-             f32 downOffset = -0.2f;   // Slightly down
-             f32 forwardOffset = -0.5f; // In front of camera (negative = forward in camera space)
-             
-             // Calculate weapon position using camera's orientation vectors
-             Vec3 weaponPosition = m_cameraPosition 
-                 + right * rightOffset
-                 + up * downOffset
-                 + forward * forwardOffset;
-             
-             // Build transformation matrix
-             Mat4 weaponModel = glm::mat4(1.0f);
-             
-             // First-person weapon position: right side, slightly down, in front
-             Vec3 weaponOffset = Vec3(0.3f, -0.2f, 0.0f);
-             weaponModel = glm::translate(weaponModel, m_cameraPosition + weaponOffset);
-             
-             // Rotate to match camera orientation using the correct axes
-             weaponModel = glm::rotate(weaponModel, glm::radians(-m_cameraYaw), Vec3(0.0f, 1.0f, 0.0f));
-             weaponModel = glm::rotate(weaponModel, glm::radians(-m_cameraPitch), Vec3(1.0f, 0.0f, 0.0f));
-             
-             // Scale: glTF models are typically in meters, scale to appropriate weapon size
-             weaponModel = glm::scale(weaponModel, Vec3(2.5f)); // Scale down from meters to reasonable size
-             
-             // Render with texture if available, otherwise use white color
-             if (m_weaponModel.textureID != 0) {
-                 m_renderer.drawMeshWithTexture(m_weaponModel.mesh, weaponModel, m_weaponModel.textureID, Vec3(1.0f, 1.0f, 1.0f));
-             } else {
-                 m_renderer.drawMesh(m_weaponModel.mesh, weaponModel, Vec3(1.0f, 1.0f, 1.0f));
-             }
-         }
+        // The test weapon is not an asset, so it is drawn directly
+        if (!m_fallbackWeapon.groups.empty()) {
+            m_renderer.drawMeshWithTexture(m_fallbackWeapon.geometry, packet.viewmodel,
+                                           m_fallbackWeapon.groups.front().textureID, Vec3(1.0f));
+        }
+        
+        // Every renderable entity, one instanced draw per mesh, material and texture
+        m_entityRenderer.render(packet.entities, m_assets, projection * view, m_renderer);
     }
     
     void updateCamera(f32 dt) {
@@ -423,12 +588,14 @@ private:
         if (m_input.isKeyDown(Key::Space))    m_cameraPosition.y += moveSpeed * dt;
         if (m_input.isKeyDown(Key::LeftCtrl)) m_cameraPosition.y -= moveSpeed * dt;
 
-        // Bounds check
-        if (m_mapMesh.loaded && m_mapMesh.bounds.isValid()) {
+        // Bounds check, against the map bounds the render thread last reported
+        while (m_mapBoundsUpdates.tryPop(m_mapBounds)) {}
+        if (m_mapBounds.isValid()) {
+             const AABB& bounds = m_mapBounds;
              const f32 margin = 10.0f;
-             m_cameraPosition.x = math::clamp(m_cameraPosition.x, m_mapMesh.bounds.min.x + margin, m_mapMesh.bounds.max.x - margin);
-             m_cameraPosition.z = math::clamp(m_cameraPosition.z, m_mapMesh.bounds.min.z + margin, m_mapMesh.bounds.max.z - margin);
-             m_cameraPosition.y = math::clamp(m_cameraPosition.y, m_mapMesh.bounds.min.y - 100.0f, m_mapMesh.bounds.max.y + 500.0f);
+             m_cameraPosition.x = math::clamp(m_cameraPosition.x, bounds.min.x + margin, bounds.max.x - margin);
+             m_cameraPosition.z = math::clamp(m_cameraPosition.z, bounds.min.z + margin, bounds.max.z - margin);
+             m_cameraPosition.y = math::clamp(m_cameraPosition.y, bounds.min.y - 100.0f, bounds.max.y + 500.0f);
         }
     }
     
@@ -437,16 +604,39 @@ private:
     std::unique_ptr<ecs::World> m_world;
     renderer::SimpleRenderer m_renderer;
     
-    // Map and weapon
-    assets::SimpleBSPMesh m_mapMesh;
-    assets::SimpleModel m_weaponModel;
+    // Asset streaming (render thread once run() starts)
+    JobSystem m_jobs;
+    renderer::GLUploadQueue m_uploads;
+    assets::AssetManager m_assets;
+    
+    // Map and weapon (fallbacks are the test meshes, used if streaming fails)
+    MeshHandle m_mapHandle;
+    MeshHandle m_weaponHandle;
+    assets::GPUMesh m_fallbackMap;
+    assets::GPUMesh m_fallbackWeapon;
+    client::MapCuller m_mapCuller;
+    client::EntityRenderer m_entityRenderer;
+    entt::entity m_viewmodel = entt::null;
     
     // Camera
     Vec3 m_cameraPosition{0.0f, 50.0f, 0.0f};
     f32 m_cameraYaw = 0.0f;
     f32 m_cameraPitch = 0.0f;
     
-    bool m_running = true;
+    // Render thread and the packets handed to it
+    static constexpr u32 FPS_MAX = 300;
+    SDL_Window* m_glWindow = nullptr;
+    SDL_GLContext m_glContext = nullptr;
+    std::thread m_renderThread;
+    TripleBuffer<client::FramePacket> m_packets;
+    u64 m_frameIndex = 0;
+    metrics::Counter m_simulationAllocations;           // Heap allocations of all simulation frames
+    metrics::Counter m_renderAllocations;               // And of all render frames
+    SpscRing<AABB, 4> m_mapBoundsUpdates;               // Render thread -> simulation
+    const assets::GPUMesh* m_mapBoundsSource = nullptr; // Render thread
+    AABB m_mapBounds;                                   // Simulation thread
+    
+    std::atomic<bool> m_running{true};
 };
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,416 @@
+/**
+ * @file job_system.cpp
+ * @brief Work-stealing job system implementation
+ */
+
+#include "core/jobs/job_system.hpp"
+#include "core/profiling/profiler.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace cscpp {
+
+namespace detail {
+
+/// Job held back until its dependencies finish
+struct PendingJob {
+    std::atomic<u32> waitingOn{0};
+    Job function;
+    std::shared_ptr<JobCounter> counter;
+};
+
+} // namespace detail
+
+namespace {
+
+/// Worker identity of the current thread (index into the owner's queues)
+thread_local const JobSystem* t_owner = nullptr;
+thread_local u32 t_workerIndex = 0;
+
+} // anonymous namespace
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+void JobSystem::initialize(u32 workerCount) {
+    shutdown();
+
+    m_queues.clear();
+    for (u32 i = 0; i < workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_running = true;
+    m_workers.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+void JobSystem::shutdown() {
+    if (!m_running) {
+        return;
+    }
+
+    waitAll();
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+    m_queues.clear();
+}
+
+u32 JobSystem::defaultWorkerCount() {
+    u32 hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+JobHandle JobSystem::schedule(Job&& job) {
+    if (m_workers.empty()) {
+        job();
+        return JobHandle();
+    }
+
+    auto counter = std::make_shared<detail::JobCounter>();
+    counter->pending.store(1, std::memory_order_relaxed);
+    m_activeJobs.fetch_add(1, std::memory_order_relaxed);
+
+    push(QueuedJob{std::move(job), counter});
+    return JobHandle(std::move(counter));
+}
+
+JobHandle JobSystem::schedule(Job&& job, std::span<const JobHandle> dependencies) {
+    if (m_workers.empty()) {
+        // Everything ran inline, so dependencies are already complete
+        job();
+        return JobHandle();
+    }
+
+    auto counter = std::make_shared<detail::JobCounter>();
+    counter->pending.store(1, std::memory_order_relaxed);
+    m_activeJobs.fetch_add(1, std::memory_order_relaxed);
+
+    auto pending = std::make_shared<detail::PendingJob>();
+    pending->function = std::move(job);
+    pending->counter = counter;
+
+    // One extra reference so the job can't start while we're still registering
+    pending->waitingOn.store(static_cast<u32>(dependencies.size()) + 1, std::memory_order_relaxed);
+
+    u32 satisfied = 1;
+    for (const JobHandle& dependency : dependencies) {
+        detail::JobCounter* depCounter = dependency.m_counter.get();
+        if (!depCounter) {
+            ++satisfied;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(depCounter->mutex);
+        if (depCounter->released) {
+            ++satisfied;
+        } else {
+            depCounter->continuations.push_back(pending);
+        }
+    }
+
+    if (pending->waitingOn.fetch_sub(satisfied, std::memory_order_acq_rel) == satisfied) {
+        push(QueuedJob{std::move(pending->function), std::move(pending->counter)});
+    }
+
+    return JobHandle(std::move(counter));
+}
+
+JobHandle JobSystem::scheduleParallel(ParallelJob&& job, u32 count, u32 grainSize) {
+    if (count == 0) {
+        return JobHandle();
+    }
+
+    grainSize = std::max(grainSize, 1u);
+
+    if (m_workers.empty()) {
+        for (u32 begin = 0; begin < count; begin += grainSize) {
+            job(begin, std::min(begin + grainSize, count));
+        }
+        return JobHandle();
+    }
+
+    const u32 chunkCount = (count + grainSize - 1) / grainSize;
+
+    auto counter = std::make_shared<detail::JobCounter>();
+    counter->pending.store(chunkCount, std::memory_order_relaxed);
+    m_activeJobs.fetch_add(chunkCount, std::memory_order_relaxed);
+
+    auto shared = std::make_shared<ParallelJob>(std::move(job));
+    for (u32 begin = 0; begin < count; begin += grainSize) {
+        u32 end = std::min(begin + grainSize, count);
+        push(QueuedJob{[shared, begin, end] { (*shared)(begin, end); }, counter});
+    }
+
+    return JobHandle(std::move(counter));
+}
+
+void JobSystem::parallelFor(u32 count, u32 grainSize, const ParallelJob& job) {
+    grainSize = std::max(grainSize, 1u);
+
+    if (m_workers.empty() || count <= grainSize) {
+        if (count > 0) {
+            job(0, count);
+        }
+        return;
+    }
+
+    ParallelFor* task = claimParallelFor();
+    if (!task) {
+        parallelForQueued(count, grainSize, job);
+        return;
+    }
+
+    task->job = &job;
+    task->count = count;
+    task->grainSize = grainSize;
+    task->chunkCount = (count + grainSize - 1) / grainSize;
+    task->nextChunk.store(0, std::memory_order_relaxed);
+    task->pendingChunks.store(task->chunkCount, std::memory_order_relaxed);
+    m_openParallelFors.fetch_add(1, std::memory_order_relaxed);
+    task->state.store(ParallelFor::Open);
+
+    // Same lock handshake as push(), so no sleeping worker misses the range
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_all();
+
+    runChunks(*task);
+
+    const u32 preferred = (t_owner == this) ? t_workerIndex : 0;
+    while (task->pendingChunks.load(std::memory_order_acquire) > 0) {
+        if (!tryExecuteOne(preferred)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Helpers that saw the slot open may still read it; let them leave first
+    task->state.store(ParallelFor::Closed);
+    while (task->helpers.load() > 0) {
+        std::this_thread::yield();
+    }
+    task->state.store(ParallelFor::Free, std::memory_order_release);
+}
+
+void JobSystem::parallelForQueued(u32 count, u32 grainSize, const ParallelJob& job) {
+    const u32 chunkCount = (count + grainSize - 1) / grainSize;
+
+    // The first chunk runs on this thread, the rest go to the pool
+    auto counter = std::make_shared<detail::JobCounter>();
+    counter->pending.store(chunkCount - 1, std::memory_order_relaxed);
+    m_activeJobs.fetch_add(chunkCount - 1, std::memory_order_relaxed);
+
+    // `job` outlives the chunks since we wait below
+    const ParallelJob* function = &job;
+    for (u32 begin = grainSize; begin < count; begin += grainSize) {
+        u32 end = std::min(begin + grainSize, count);
+        push(QueuedJob{[function, begin, end] { (*function)(begin, end); }, counter});
+    }
+
+    job(0, grainSize);
+
+    wait(JobHandle(std::move(counter)));
+}
+
+JobSystem::ParallelFor* JobSystem::claimParallelFor() {
+    for (ParallelFor& task : m_parallelFors) {
+        u32 expected = ParallelFor::Free;
+        if (task.state.compare_exchange_strong(expected, ParallelFor::Publishing, std::memory_order_acquire)) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+u32 JobSystem::runChunks(ParallelFor& task) {
+    u32 ran = 0;
+    for (;;) {
+        const u32 chunk = task.nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= task.chunkCount) {
+            return ran;
+        }
+        if (chunk == task.chunkCount - 1) {
+            // Nothing left to claim: stop drawing idle workers to this slot
+            m_openParallelFors.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        const u32 begin = chunk * task.grainSize;
+        (*task.job)(begin, std::min(begin + task.grainSize, task.count));
+        task.pendingChunks.fetch_sub(1, std::memory_order_release);
+        ++ran;
+    }
+}
+
+bool JobSystem::helpParallelFor() {
+    if (m_openParallelFors.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    bool ran = false;
+    for (ParallelFor& task : m_parallelFors) {
+        if (task.state.load(std::memory_order_acquire) != ParallelFor::Open) {
+            continue;
+        }
+        // Register, then re-check: pairs with the owner closing the slot
+        // before it waits for helpers to leave
+        task.helpers.fetch_add(1);
+        if (task.state.load() == ParallelFor::Open) {
+            ran = runChunks(task) > 0 || ran;
+        }
+        task.helpers.fetch_sub(1, std::memory_order_release);
+    }
+    return ran;
+}
+
+void JobSystem::wait(const JobHandle& handle) {
+    const u32 preferred = (t_owner == this) ? t_workerIndex : 0;
+
+    while (!handle.isDone()) {
+        if (!tryExecuteOne(preferred)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::waitAll() {
+    const u32 preferred = (t_owner == this) ? t_workerIndex : 0;
+
+    while (m_activeJobs.load(std::memory_order_acquire) > 0) {
+        if (!tryExecuteOne(preferred)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ============================================================================
+// Queues
+// ============================================================================
+
+void JobSystem::push(QueuedJob&& job) {
+    // Workers push to their own queue, other threads spread round-robin
+    u32 queue = (t_owner == this)
+        ? t_workerIndex
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<u32>(m_queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->jobs.push_back(std::move(job));
+    }
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Take the sleep lock so a worker can't miss the wakeup between its check and wait
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+bool JobSystem::popLocal(u32 queue, QueuedJob& out) {
+    WorkerQueue& q = *m_queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) {
+        return false;
+    }
+    out = std::move(q.jobs.back());
+    q.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(u32 queue, QueuedJob& out) {
+    const u32 queueCount = static_cast<u32>(m_queues.size());
+
+    for (u32 offset = 1; offset < queueCount; ++offset) {
+        WorkerQueue& q = *m_queues[(queue + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.jobs.empty()) {
+            out = std::move(q.jobs.front());
+            q.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::tryExecuteOne(u32 preferredQueue) {
+    if (helpParallelFor()) {
+        return true;
+    }
+    if (m_queues.empty() || m_queuedJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    QueuedJob job;
+    if (!popLocal(preferredQueue, job) && !steal(preferredQueue, job)) {
+        return false;
+    }
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    job.function();
+
+    if (job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        complete(*job.counter);
+    }
+    m_activeJobs.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::complete(detail::JobCounter& counter) {
+    std::vector<std::shared_ptr<detail::PendingJob>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        counter.released = true;
+        continuations.swap(counter.continuations);
+    }
+
+    for (auto& pending : continuations) {
+        if (pending->waitingOn.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            push(QueuedJob{std::move(pending->function), std::move(pending->counter)});
+        }
+    }
+}
+
+void JobSystem::workerLoop(u32 index) {
+    t_owner = this;
+    t_workerIndex = index;
+    
+    const std::string threadName = "Job worker " + std::to_string(index);
+    CSCPP_PROFILE_THREAD(threadName.c_str());
+
+    for (;;) {
+        if (tryExecuteOne(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this] {
+            return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0 ||
+                   m_openParallelFors.load(std::memory_order_acquire) > 0;
+        });
+
+        if (!m_running) {
+            break;
+        }
+    }
+
+    t_owner = nullptr;
+}
+
+} // namespace cscpp
@@ -0,0 +1,194 @@
+#pragma once
+
+/**
+ * @file job_system.hpp
+ * @brief Work-stealing job system
+ *
+ * Fixed pool of worker threads, each with its own job deque. Workers pop
+ * their own jobs LIFO and steal from other workers FIFO when idle. Threads
+ * that wait on a handle help execute pending jobs instead of blocking, so
+ * waits can be nested inside jobs.
+ *
+ * parallelFor() does not queue anything: it publishes the range in one of
+ * a fixed set of slots and every helping thread claims chunks from an
+ * atomic cursor, so a steady-state caller makes no heap allocations.
+ *
+ * Scheduling order is not deterministic. Callers that need deterministic
+ * results must have jobs write disjoint outputs and merge them afterwards
+ * in a fixed order.
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace cscpp {
+
+/// Single job
+using Job = std::function<void()>;
+
+/// Range job, called with [begin, end)
+using ParallelJob = std::function<void(u32 begin, u32 end)>;
+
+namespace detail {
+
+struct PendingJob;
+
+/// Completion counter shared by a group of jobs
+struct JobCounter {
+    std::atomic<u32> pending{0};
+
+    /// Jobs waiting for this counter (guarded by mutex)
+    std::mutex mutex;
+    bool released = false;
+    std::vector<std::shared_ptr<PendingJob>> continuations;
+};
+
+} // namespace detail
+
+/**
+ * @brief Handle to a scheduled job or job group
+ */
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    /// True if all jobs of this handle have finished (or the handle is empty)
+    bool isDone() const {
+        return !m_counter || m_counter->pending.load(std::memory_order_acquire) == 0;
+    }
+
+    bool isValid() const { return m_counter != nullptr; }
+
+private:
+    friend class JobSystem;
+    explicit JobHandle(std::shared_ptr<detail::JobCounter> counter)
+        : m_counter(std::move(counter)) {}
+
+    std::shared_ptr<detail::JobCounter> m_counter;
+};
+
+/**
+ * @brief Work-stealing thread pool
+ *
+ * With zero workers every job runs inline on the calling thread.
+ */
+class JobSystem {
+public:
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Start the worker threads
+     * @param workerCount Number of pool threads (callers of wait() help in addition)
+     */
+    void initialize(u32 workerCount);
+
+    /// Finish outstanding jobs and join the workers
+    void shutdown();
+
+    u32 getWorkerCount() const { return static_cast<u32>(m_workers.size()); }
+
+    /// Default worker count for this machine (hardware threads minus the caller)
+    static u32 defaultWorkerCount();
+
+    // ========================================================================
+    // Scheduling
+    // ========================================================================
+
+    /// Schedule a single job
+    JobHandle schedule(Job&& job);
+
+    /**
+     * @brief Schedule a job that starts once all `dependencies` have finished
+     *
+     * Empty handles count as finished.
+     */
+    JobHandle schedule(Job&& job, std::span<const JobHandle> dependencies);
+
+    /**
+     * @brief Split [0, count) into chunks of at most `grainSize` and schedule them
+     */
+    JobHandle scheduleParallel(ParallelJob&& job, u32 count, u32 grainSize = 1);
+
+    /// Wait for a handle, executing other jobs meanwhile
+    void wait(const JobHandle& handle);
+
+    /// Wait until every scheduled job has finished
+    void waitAll();
+
+    /**
+     * @brief Run [0, count) in chunks across the pool and wait for completion
+     *
+     * The calling thread executes chunks too. Runs inline when count fits a
+     * single chunk or the pool has no workers. Allocation-free unless more
+     * than MAX_PARALLEL_FORS calls are in flight at once, which fall back to
+     * the job queues.
+     */
+    void parallelFor(u32 count, u32 grainSize, const ParallelJob& job);
+
+    /// Concurrent parallelFor() calls served without allocating
+    static constexpr u32 MAX_PARALLEL_FORS = 16;
+
+private:
+    struct QueuedJob {
+        Job function;
+        std::shared_ptr<detail::JobCounter> counter;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+    
+    /// One in-flight parallelFor(), owned by its caller from claim to Free
+    struct ParallelFor {
+        enum State : u32 { Free, Publishing, Open, Closed };
+        
+        std::atomic<u32> state{Free};
+        std::atomic<u32> helpers{0};            ///< Threads that may still read the fields
+        std::atomic<u32> nextChunk{0};
+        std::atomic<u32> pendingChunks{0};
+        const ParallelJob* job = nullptr;
+        u32 count = 0;
+        u32 grainSize = 1;
+        u32 chunkCount = 0;
+    };
+
+    void push(QueuedJob&& job);
+    void parallelForQueued(u32 count, u32 grainSize, const ParallelJob& job);
+    ParallelFor* claimParallelFor();
+    u32 runChunks(ParallelFor& task);
+    bool helpParallelFor();
+    void complete(detail::JobCounter& counter);
+    bool tryExecuteOne(u32 preferredQueue);
+    bool popLocal(u32 queue, QueuedJob& out);
+    bool steal(u32 queue, QueuedJob& out);
+    void workerLoop(u32 index);
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::array<ParallelFor, MAX_PARALLEL_FORS> m_parallelFors;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<u32> m_queuedJobs{0};       ///< Jobs sitting in queues
+    std::atomic<u32> m_activeJobs{0};       ///< Jobs scheduled but not finished
+    std::atomic<u32> m_openParallelFors{0}; ///< parallelFor() slots with unclaimed chunks
+    std::atomic<u32> m_nextQueue{0};        ///< Round-robin target for external threads
+    std::atomic<bool> m_running{false};
+};
+
+} // namespace cscpp
@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * @file spsc_ring.hpp
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * One thread pushes, one other thread pops; neither ever blocks or
+ * allocates. Slots are constructed once and reused, so elements holding
+ * vectors keep their capacity between uses: fill a slot in place with
+ * beginPush()/endPush() and read it in place with front()/pop().
+ *
+ * The head and tail indices live on separate cache lines, and each side
+ * caches the other's index so it only touches the shared line when the
+ * ring looks full (producer) or empty (consumer).
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace cscpp {
+
+template<typename T, u32 Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr u32 CAPACITY = Capacity;
+    
+    // ========================================================================
+    // Producer
+    // ========================================================================
+    
+    /// Slot to fill in place, or nullptr if the ring is full
+    T* beginPush() {
+        const u32 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) {
+                return nullptr;
+            }
+        }
+        return &m_slots[tail & (Capacity - 1)];
+    }
+    
+    /// Publish the slot returned by beginPush()
+    void endPush() {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /// Copy an element in; false if the ring is full
+    bool tryPush(const T& value) {
+        T* slot = beginPush();
+        if (!slot) {
+            return false;
+        }
+        *slot = value;
+        endPush();
+        return true;
+    }
+    
+    // ========================================================================
+    // Consumer
+    // ========================================================================
+    
+    /// Oldest element, or nullptr if the ring is empty
+    T* front() {
+        const u32 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return nullptr;
+            }
+        }
+        return &m_slots[head & (Capacity - 1)];
+    }
+    
+    /// Release the element returned by front()
+    void pop() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /// Copy the oldest element out; false if the ring is empty
+    bool tryPop(T& out) {
+        T* slot = front();
+        if (!slot) {
+            return false;
+        }
+        out = *slot;
+        pop();
+        return true;
+    }
+    
+    /// Elements queued (exact only on the producer or consumer thread)
+    u32 size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    
+    alignas(CACHE_LINE) std::atomic<u32> m_head{0};      ///< Next slot to pop (consumer)
+    u32 m_cachedTail = 0;                               ///< Consumer's view of m_tail
+    
+    alignas(CACHE_LINE) std::atomic<u32> m_tail{0};      ///< Next slot to push (producer)
+    u32 m_cachedHead = 0;                               ///< Producer's view of m_head
+    
+    alignas(CACHE_LINE) std::array<T, Capacity> m_slots{};
+};
+
+} // namespace cscpp
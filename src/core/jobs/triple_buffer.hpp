@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file triple_buffer.hpp
+ * @brief Lock-free latest-value handoff between one writer and one reader
+ *
+ * Three slots: the writer fills its back slot in place and publish() swaps
+ * it with the shared middle slot; the reader's acquire() swaps the middle
+ * slot with its front slot if something was published since. Neither side
+ * ever waits for the other. A slot the reader has not picked up yet is
+ * overwritten by the next publish, so the reader always sees the newest
+ * value and a slow side never stalls a fast one.
+ *
+ * Like SpscRing, slots are constructed once and reused, so elements holding
+ * vectors keep their capacity: clear and refill back() rather than
+ * assigning a new value.
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace cscpp {
+
+template<typename T>
+class TripleBuffer {
+public:
+    // ========================================================================
+    // Writer
+    // ========================================================================
+
+    /// Slot to fill in place; the reader never sees it until publish()
+    T& back() { return m_slots[m_back]; }
+
+    /// Hand back() to the reader, replacing any value it has not acquired yet
+    void publish() {
+        const u8 previous = m_middle.exchange(static_cast<u8>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // ========================================================================
+    // Reader
+    // ========================================================================
+
+    /// Take the newest published value into front(); false if nothing new was published
+    bool acquire() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        const u8 previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /// Value of the last successful acquire() (default-constructed before the first)
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr u8 INDEX_MASK = 0x3;
+    static constexpr u8 FRESH = 0x4;                    ///< Middle slot not acquired yet
+
+    alignas(CACHE_LINE) std::atomic<u8> m_middle{1};    ///< Shared slot index, with FRESH
+    alignas(CACHE_LINE) u8 m_back = 0;                  ///< Writer's slot
+    alignas(CACHE_LINE) u8 m_front = 2;                 ///< Reader's slot
+
+    alignas(CACHE_LINE) std::array<T, 3> m_slots{};
+};
+
+} // namespace cscpp
@@ -0,0 +1,77 @@
+/**
+ * @file allocation_counter.cpp
+ * @brief Global operator new/delete with per-thread counts
+ *
+ * Replaces the global operator new/delete: every allocation bumps the
+ * calling thread's counter and, with CSCPP_ENABLE_PROFILING, shows up on
+ * Tracy's memory timeline. Aligned overloads keep the standard library's
+ * implementation and are not counted.
+ */
+
+#include "core/memory/allocation_counter.hpp"
+#include "core/profiling/profiler.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local cscpp::u64 t_allocations = 0;
+}
+
+cscpp::u64 cscpp::threadAllocationCount() {
+    return t_allocations;
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    ++t_allocations;
+    CSCPP_PROFILE_ALLOC(ptr, size);
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr) {
+        ++t_allocations;
+        CSCPP_PROFILE_ALLOC(ptr, size);
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        CSCPP_PROFILE_FREE(ptr);
+        std::free(ptr);
+    }
+}
+
+void operator delete[](void* ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file allocation_counter.hpp
+ * @brief Per-thread counts of global heap allocations
+ *
+ * The global operator new is replaced (allocation_counter.cpp) and bumps a
+ * thread-local counter on every call, so a thread can check that a loop it
+ * runs, such as a server tick or a client frame, makes no heap allocations
+ * in steady state. Counting is one thread-local increment; with
+ * CSCPP_ENABLE_PROFILING the same replacement also reports to Tracy.
+ *
+ * Allocations through std::pmr resources that never reach operator new
+ * (a FrameArena's block) are not counted.
+ */
+
+#include "core/types.hpp"
+
+namespace cscpp {
+
+/// Global operator new calls made by the calling thread so far
+u64 threadAllocationCount();
+
+/// Allocations made by the calling thread since construction (or restart())
+class AllocationScope {
+public:
+    AllocationScope() : m_start(threadAllocationCount()) {}
+
+    void restart() { m_start = threadAllocationCount(); }
+    u64 getCount() const { return threadAllocationCount() - m_start; }
+
+private:
+    u64 m_start;
+};
+
+} // namespace cscpp
@@ -0,0 +1,71 @@
+/**
+ * @file frame_arena.cpp
+ * @brief Linear std::pmr resource for per-tick and per-frame temporaries
+ */
+
+#include "core/memory/frame_arena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+namespace cscpp {
+
+/// Alignment of the block; larger requests are aligned within it
+static constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream), m_capacity(capacity) {
+    if (m_capacity > 0) {
+        m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, BLOCK_ALIGNMENT));
+    }
+}
+
+FrameArena::~FrameArena() {
+    for (const Overflow& overflow : m_overflow) {
+        m_upstream->deallocate(overflow.ptr, overflow.bytes, overflow.alignment);
+    }
+    if (m_block) {
+        m_upstream->deallocate(m_block, m_capacity, BLOCK_ALIGNMENT);
+    }
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    // Pad from the block's address, so alignments above BLOCK_ALIGNMENT work too
+    const size_t address = reinterpret_cast<size_t>(m_block) + m_offset;
+    const size_t aligned = (address + alignment - 1) & ~(alignment - 1);
+    const size_t end = aligned - reinterpret_cast<size_t>(m_block) + bytes;
+    if (m_block && end <= m_capacity) {
+        m_offset = end;
+        m_peak = std::max(m_peak, getUsed());
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Past the block: borrow from upstream until reset()
+    void* ptr = m_upstream->allocate(bytes, alignment);
+    m_overflow.push_back({ptr, bytes, alignment});
+    m_overflowBytes += bytes + alignment;
+    m_overflowCount++;
+    m_peak = std::max(m_peak, getUsed());
+    return ptr;
+}
+
+void FrameArena::reset() {
+    if (!m_overflow.empty()) {
+        for (const Overflow& overflow : m_overflow) {
+            m_upstream->deallocate(overflow.ptr, overflow.bytes, overflow.alignment);
+        }
+        m_overflow.clear();
+
+        // One block for the whole peak from now on
+        if (m_block) {
+            m_upstream->deallocate(m_block, m_capacity, BLOCK_ALIGNMENT);
+        }
+        m_capacity = std::bit_ceil(m_peak);
+        m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, BLOCK_ALIGNMENT));
+    }
+    m_offset = 0;
+    m_overflowBytes = 0;
+}
+
+} // namespace cscpp
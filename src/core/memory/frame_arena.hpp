@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file frame_arena.hpp
+ * @brief Linear std::pmr resource for per-tick and per-frame temporaries
+ *
+ * Allocation bumps an offset into one block; deallocation does nothing;
+ * reset() rewinds the offset, so everything allocated since the last reset
+ * must be dead by then. Hand the arena to std::pmr containers
+ * (std::pmr::vector<T> v(&arena)) that live for one tick, one frame or one
+ * packet.
+ *
+ * When a period needs more than the block, the excess comes from the
+ * upstream resource and is freed at reset(), which also grows the block to
+ * the period's peak. After the first few periods the block covers steady
+ * state and the arena makes no upstream allocations at all.
+ *
+ * Single-threaded: one arena per thread, reset by that thread.
+ */
+
+#include "core/types.hpp"
+
+#include <memory_resource>
+#include <vector>
+
+namespace cscpp {
+
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Start a new period; grows the block if the last one overflowed it
+    void reset();
+
+    size_t getUsed() const { return m_offset + m_overflowBytes; }
+    size_t getCapacity() const { return m_capacity; }
+    size_t getPeak() const { return m_peak; }
+
+    /// Allocations served by the upstream resource since construction
+    u64 getOverflowCount() const { return m_overflowCount; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}   // Reclaimed by reset()
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    struct Overflow {
+        void* ptr;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    std::pmr::memory_resource* m_upstream;
+    std::byte* m_block = nullptr;
+    size_t m_capacity = 0;
+    size_t m_offset = 0;
+    size_t m_overflowBytes = 0;         // This period
+    size_t m_peak = 0;                  // Largest getUsed() of any period
+    u64 m_overflowCount = 0;
+    std::vector<Overflow> m_overflow;   // Freed at reset()
+};
+
+} // namespace cscpp
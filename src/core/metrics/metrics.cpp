@@ -0,0 +1,138 @@
+/**
+ * @file metrics.cpp
+ * @brief Histogram queries and Prometheus text formatting
+ */
+
+#include "core/metrics/metrics.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace cscpp::metrics {
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+u64 Histogram::getPercentile(f64 percentile) const {
+    const u64 count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    
+    const f64 clamped = std::clamp(percentile, 0.0, 100.0);
+    const u64 target = std::max<u64>(1, static_cast<u64>(std::ceil(clamped / 100.0 * static_cast<f64>(count))));
+    
+    u64 seen = 0;
+    for (u32 i = 0; i < BUCKET_COUNT; ++i) {
+        seen += getBucket(i);
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+u64 Histogram::countAtOrBelow(u64 limit) const {
+    // Whole buckets only: a power-of-two limit is a bucket edge, so this
+    // counts exactly the values below it (or up to it, for limits < SUB_BUCKETS)
+    u64 total = 0;
+    for (u32 i = 0; i < BUCKET_COUNT && bucketUpperBound(i) <= limit; ++i) {
+        total += getBucket(i);
+    }
+    return total;
+}
+
+// ============================================================================
+// PrometheusWriter
+// ============================================================================
+
+void PrometheusWriter::family(std::string_view name, std::string_view type, std::string_view help) {
+    m_text += "# HELP ";
+    m_text += name;
+    m_text += ' ';
+    m_text += help;
+    m_text += "\n# TYPE ";
+    m_text += name;
+    m_text += ' ';
+    m_text += type;
+    m_text += '\n';
+}
+
+void PrometheusWriter::sample(std::string_view name, std::string_view labels, f64 value) {
+    writeName(name, {}, labels);
+    writeNumber(value);
+    m_text += '\n';
+}
+
+void PrometheusWriter::sample(std::string_view name, std::string_view labels, u64 value) {
+    writeName(name, {}, labels);
+    writeNumber(value);
+    m_text += '\n';
+}
+
+void PrometheusWriter::histogram(std::string_view name, std::string_view labels,
+                                 const Histogram& histogram, f64 scale,
+                                 u32 minExponent, u32 maxExponent) {
+    std::string le;
+    for (u32 exponent = minExponent; exponent <= maxExponent && exponent < 64; ++exponent) {
+        const u64 bound = u64{1} << exponent;
+        
+        le = "le=\"";
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), static_cast<f64>(bound) * scale);
+        le.append(buf, ec == std::errc{} ? end : buf);
+        le += '"';
+        
+        writeName(name, "_bucket", labels, le);
+        writeNumber(histogram.countAtOrBelow(bound));
+        m_text += '\n';
+    }
+    
+    writeName(name, "_bucket", labels, "le=\"+Inf\"");
+    writeNumber(histogram.getCount());
+    m_text += '\n';
+    
+    writeName(name, "_sum", labels);
+    writeNumber(static_cast<f64>(histogram.getSum()) * scale);
+    m_text += '\n';
+    
+    writeName(name, "_count", labels);
+    writeNumber(histogram.getCount());
+    m_text += '\n';
+}
+
+void PrometheusWriter::writeName(std::string_view name, std::string_view suffix,
+                                 std::string_view labels, std::string_view extraLabel) {
+    m_text += name;
+    m_text += suffix;
+    if (!labels.empty() || !extraLabel.empty()) {
+        m_text += '{';
+        m_text += labels;
+        if (!labels.empty() && !extraLabel.empty()) {
+            m_text += ',';
+        }
+        m_text += extraLabel;
+        m_text += '}';
+    }
+    m_text += ' ';
+}
+
+void PrometheusWriter::writeNumber(f64 value) {
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    if (ec == std::errc{}) {
+        m_text.append(buf, end);
+    } else {
+        m_text += '0';
+    }
+}
+
+void PrometheusWriter::writeNumber(u64 value) {
+    char buf[24];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    m_text.append(buf, ec == std::errc{} ? end : buf);
+}
+
+} // namespace cscpp::metrics
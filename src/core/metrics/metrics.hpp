@@ -0,0 +1,153 @@
+#pragma once
+
+/**
+ * @file metrics.hpp
+ * @brief Always-on counters, gauges and HDR histograms
+ *
+ * Every metric has exactly one writer thread, which updates it with plain
+ * relaxed loads and stores (no read-modify-write, no locks), so recording
+ * costs about as much as a normal increment. Any other thread may read a
+ * metric at any time, e.g. to export it; a reader racing a writer sees
+ * either the old or the new value of each field.
+ *
+ * Histograms are log-linear (HDR style): every power of two is split into
+ * SUB_BUCKETS equal buckets, so any recorded value is known to within
+ * 1/SUB_BUCKETS (12.5%) of itself over the whole u64 range, in a fixed
+ * array with no allocation.
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <string>
+#include <string_view>
+
+namespace cscpp::metrics {
+
+// ============================================================================
+// Counter / Gauge
+// ============================================================================
+
+/// Monotonic count (single writer)
+class Counter {
+public:
+    void add(u64 amount = 1) {
+        m_value.store(m_value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    u64 get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<u64> m_value{0};
+};
+
+/// Last set value (single writer)
+class Gauge {
+public:
+    void set(i64 value) { m_value.store(value, std::memory_order_relaxed); }
+    i64 get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<i64> m_value{0};
+};
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+class Histogram {
+public:
+    static constexpr u32 SUB_BUCKET_BITS = 3;
+    static constexpr u32 SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    
+    /// Values below SUB_BUCKETS get one bucket each, then SUB_BUCKETS per power of two
+    static constexpr u32 BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    
+    void record(u64 value) {
+        auto& bucket = m_buckets[bucketIndex(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+    }
+    
+    u64 getCount() const { return m_count.load(std::memory_order_relaxed); }
+    u64 getSum() const { return m_sum.load(std::memory_order_relaxed); }
+    u64 getMax() const { return m_max.load(std::memory_order_relaxed); }
+    u64 getBucket(u32 index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    
+    /// Upper bound of the bucket holding the given percentile (0-100), capped at the max
+    u64 getPercentile(f64 percentile) const;
+    
+    /// Recorded values <= limit
+    u64 countAtOrBelow(u64 limit) const;
+    
+    static u32 bucketIndex(u64 value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<u32>(value);
+        }
+        const u32 exponent = static_cast<u32>(std::bit_width(value)) - 1;
+        const u32 shift = exponent - SUB_BUCKET_BITS;
+        const u32 sub = static_cast<u32>(value >> shift) & (SUB_BUCKETS - 1);
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+    
+    /// Largest value that lands in a bucket
+    static u64 bucketUpperBound(u32 index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const u32 shift = index / SUB_BUCKETS - 1;
+        const u64 lower = static_cast<u64>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + ((u64{1} << shift) - 1);
+    }
+
+private:
+    std::array<std::atomic<u64>, BUCKET_COUNT> m_buckets{};
+    std::atomic<u64> m_count{0};
+    std::atomic<u64> m_sum{0};
+    std::atomic<u64> m_max{0};
+};
+
+// ============================================================================
+// Prometheus Text Format
+// ============================================================================
+
+/**
+ * @brief Builds a Prometheus text exposition (format 0.0.4)
+ *
+ * Labels are passed preformatted without braces, e.g. `match="0"`.
+ */
+class PrometheusWriter {
+public:
+    /// # HELP / # TYPE lines; call once per metric name before its samples
+    void family(std::string_view name, std::string_view type, std::string_view help);
+    
+    void sample(std::string_view name, std::string_view labels, f64 value);
+    void sample(std::string_view name, std::string_view labels, u64 value);
+    
+    /**
+     * @brief Histogram samples with power-of-two `le` bounds
+     * @param scale Multiplier from recorded units to exported units (1e-9 for ns to seconds)
+     * @param minExponent, maxExponent Bounds 2^minExponent..2^maxExponent (recorded units)
+     */
+    void histogram(std::string_view name, std::string_view labels, const Histogram& histogram,
+                   f64 scale, u32 minExponent, u32 maxExponent);
+    
+    const std::string& getText() const { return m_text; }
+    void clear() { m_text.clear(); }
+
+private:
+    void writeName(std::string_view name, std::string_view suffix, std::string_view labels,
+                   std::string_view extraLabel = {});
+    void writeNumber(f64 value);
+    void writeNumber(u64 value);
+    
+    std::string m_text;
+};
+
+} // namespace cscpp::metrics
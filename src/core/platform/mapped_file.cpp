@@ -0,0 +1,131 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Read-only memory-mapped file
+ */
+
+#include "core/platform/mapped_file.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace cscpp {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        swap(other);
+    }
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_open, other.m_open);
+    std::swap(m_path, other.m_path);
+}
+
+Result<void> MappedFile::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::unexpected(Error{"Failed to open file: " + path});
+    }
+    
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return std::unexpected(Error{"Failed to stat file: " + path});
+    }
+    
+    if (size.QuadPart > 0) {
+        // The view keeps the mapping alive; both handles can go right away
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            return std::unexpected(Error{"Failed to map file: " + path});
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) {
+            return std::unexpected(Error{"Failed to map file: " + path});
+        }
+        m_data = static_cast<const u8*>(view);
+        m_size = static_cast<size_t>(size.QuadPart);
+    } else {
+        CloseHandle(file);
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected(Error{"Failed to open file: " + path});
+    }
+    
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return std::unexpected(Error{"Failed to stat file: " + path});
+    }
+    
+    if (info.st_size > 0) {
+        // The mapping keeps the file referenced after the descriptor closes
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return std::unexpected(Error{"Failed to map file: " + path});
+        }
+        m_data = static_cast<const u8*>(view);
+        m_size = static_cast<size_t>(info.st_size);
+        
+        // Loaders walk most lumps front to back once
+        madvise(view, m_size, MADV_WILLNEED);
+    } else {
+        ::close(fd);
+    }
+#endif
+
+    m_open = true;
+    m_path = path;
+    return {};
+}
+
+void MappedFile::close() {
+    if (m_data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<u8*>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+    m_path.clear();
+}
+
+} // namespace cscpp
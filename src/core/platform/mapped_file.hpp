@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped file
+ *
+ * Maps a whole file into the address space (mmap / MapViewOfFile). Pages
+ * are read from the OS file cache on first touch and shared between every
+ * process and mapping of the same file, so nothing is copied into private
+ * heap memory and untouched parts of the file never cost RSS.
+ */
+
+#include "core/types.hpp"
+
+#include <span>
+#include <string>
+
+namespace cscpp {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    /// Map a file read-only (empty files open with no bytes)
+    Result<void> open(const std::string& path);
+    
+    void close();
+    
+    bool isOpen() const { return m_open; }
+    const std::string& getPath() const { return m_path; }
+    
+    std::span<const u8> getBytes() const { return {m_data, m_size}; }
+    size_t getSize() const { return m_size; }
+
+private:
+    void swap(MappedFile& other) noexcept;
+    
+    const u8* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+    std::string m_path;
+};
+
+} // namespace cscpp
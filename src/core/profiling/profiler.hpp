@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file profiler.hpp
+ * @brief Profiling macros (Tracy when CSCPP_ENABLE_PROFILING is set)
+ *
+ * Without CSCPP_ENABLE_PROFILING every macro expands to nothing, so
+ * instrumented code compiles to exactly what it was before. Zone names must
+ * be string literals except in CSCPP_PROFILE_ZONE_DYNAMIC, which copies the
+ * name on every entry and is meant for names only known at run time
+ * (system names).
+ *
+ * GPU zones need the GL loader and live in profiler_gpu.hpp.
+ */
+
+#ifdef CSCPP_ENABLE_PROFILING
+
+#include <tracy/Tracy.hpp>
+
+/// Time the enclosing scope
+#define CSCPP_PROFILE_ZONE(name) ZoneScopedN(name)
+
+/// Time the enclosing function, named after it
+#define CSCPP_PROFILE_FUNCTION() ZoneScoped
+
+/// Time the enclosing scope under a run-time name
+#define CSCPP_PROFILE_ZONE_DYNAMIC(name) ZoneTransientN(cscppProfileZone, name, true)
+
+/// Attach a formatted value to the current zone
+#define CSCPP_PROFILE_ZONE_VALUE(value) ZoneValue(value)
+
+/// End of the main frame / of a named secondary frame
+#define CSCPP_PROFILE_FRAME() FrameMark
+#define CSCPP_PROFILE_FRAME_NAMED(name) FrameMarkNamed(name)
+
+/// Name the calling thread in captures (the name is copied)
+#define CSCPP_PROFILE_THREAD(name) tracy::SetThreadName(name)
+
+/// Sample a value over time
+#define CSCPP_PROFILE_PLOT(name, value) TracyPlot(name, value)
+
+/// Memory events (operator new/delete report themselves, see core/memory/allocation_counter.cpp)
+#define CSCPP_PROFILE_ALLOC(ptr, size) TracyAlloc(ptr, size)
+#define CSCPP_PROFILE_FREE(ptr) TracyFree(ptr)
+
+#else
+
+#define CSCPP_PROFILE_ZONE(name)
+#define CSCPP_PROFILE_FUNCTION()
+#define CSCPP_PROFILE_ZONE_DYNAMIC(name)
+#define CSCPP_PROFILE_ZONE_VALUE(value)
+#define CSCPP_PROFILE_FRAME()
+#define CSCPP_PROFILE_FRAME_NAMED(name)
+#define CSCPP_PROFILE_THREAD(name)
+#define CSCPP_PROFILE_PLOT(name, value)
+#define CSCPP_PROFILE_ALLOC(ptr, size)
+#define CSCPP_PROFILE_FREE(ptr)
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file profiler_gpu.hpp
+ * @brief OpenGL GPU zones (Tracy when CSCPP_ENABLE_PROFILING is set)
+ *
+ * Include after the GL loader. The context must be created once the GL
+ * context is current, and collected once per frame before the swap.
+ */
+
+#include "core/profiling/profiler.hpp"
+
+#ifdef CSCPP_ENABLE_PROFILING
+
+#include <tracy/TracyOpenGL.hpp>
+
+#define CSCPP_PROFILE_GPU_CONTEXT() TracyGpuContext
+#define CSCPP_PROFILE_GPU_ZONE(name) TracyGpuZone(name)
+#define CSCPP_PROFILE_GPU_COLLECT() TracyGpuCollect
+
+#else
+
+#define CSCPP_PROFILE_GPU_CONTEXT()
+#define CSCPP_PROFILE_GPU_ZONE(name)
+#define CSCPP_PROFILE_GPU_COLLECT()
+
+#endif
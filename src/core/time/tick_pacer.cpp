@@ -0,0 +1,230 @@
+/**
+ * @file tick_pacer.cpp
+ * @brief Fixed-rate tick scheduling
+ */
+
+#include "core/time/tick_pacer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <thread>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <time.h>
+    #if defined(__linux__)
+        #include <sys/prctl.h>
+    #endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace cscpp {
+
+namespace {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Platform Sleep
+// ============================================================================
+
+#if defined(_WIN32)
+
+void platformSleep(i64 nanos) {
+    if (nanos <= 0) {
+        return;
+    }
+    
+    // High-resolution waitable timers (Windows 10 1803+) avoid the 1-15 ms
+    // scheduler quantum of Sleep()
+    thread_local HANDLE timer = CreateWaitableTimerExW(
+        nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    
+    if (timer) {
+        LARGE_INTEGER due;
+        due.QuadPart = -(nanos / 100);  // Relative, 100 ns units
+        if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer, INFINITE);
+            return;
+        }
+    }
+    Sleep(static_cast<DWORD>(nanos / 1'000'000));
+}
+
+i64 platformSpinNanos() {
+    return 1'000'000;
+}
+
+#else
+
+void platformSleep(i64 nanos) {
+    if (nanos <= 0) {
+        return;
+    }
+    
+    timespec request;
+    request.tv_sec = static_cast<time_t>(nanos / 1'000'000'000);
+    request.tv_nsec = static_cast<long>(nanos % 1'000'000'000);
+#if defined(__linux__)
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &request, nullptr);
+#else
+    nanosleep(&request, nullptr);
+#endif
+}
+
+i64 platformSpinNanos() {
+#if defined(__linux__)
+    return 200'000;     // Timer slack is lowered in TickPacer::start()
+#else
+    return 500'000;
+#endif
+}
+
+#endif
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+void LatencyHistogram::record(i64 nanos) {
+    nanos = std::max<i64>(nanos, 0);
+    
+    const u64 micros = static_cast<u64>(nanos) / 1000;
+    const size_t bucket = std::min<size_t>(static_cast<size_t>(std::bit_width(micros)), BUCKET_COUNT - 1);
+    
+    ++m_buckets[bucket];
+    ++m_count;
+    m_sum += nanos;
+    m_max = std::max(m_max, nanos);
+}
+
+void LatencyHistogram::reset() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+i64 LatencyHistogram::getPercentileNanos(f64 percentile) const {
+    if (m_count == 0) {
+        return 0;
+    }
+    
+    const u64 target = static_cast<u64>(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<f64>(m_count));
+    u64 seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT - 1; ++i) {
+        seen += m_buckets[i];
+        if (seen > target || seen == m_count) {
+            return std::min(bucketUpperNanos(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+// ============================================================================
+// Tick Pacer
+// ============================================================================
+
+void TickPacer::configure(const TickPacerConfig& config) {
+    m_config = config;
+    m_config.tickRate = std::max(m_config.tickRate, 1u);
+    if (!m_config.sleep) {
+        m_config.sleep = &platformSleep;
+    }
+    
+    m_intervalNanos = 1'000'000'000 / static_cast<i64>(m_config.tickRate);
+    m_spinNanos = m_config.spinNanos >= 0 ? m_config.spinNanos : platformSpinNanos();
+}
+
+void TickPacer::start(Tick firstTick) {
+#if defined(__linux__)
+    // Default 50 us slack makes short sleeps overshoot; ask for the minimum
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+    
+    m_firstTick = firstTick;
+    m_index = 0;
+    m_epochNanos = monotonicNanos();
+    m_tickStartNanos = m_epochNanos;
+}
+
+void TickPacer::waitUntil(i64 deadline) const {
+    const i64 remaining = deadline - monotonicNanos();
+    if (remaining > m_spinNanos) {
+        m_config.sleep(remaining - m_spinNanos);
+    }
+    while (monotonicNanos() < deadline) {
+        cpuRelax();
+    }
+}
+
+TickTiming TickPacer::waitForTick() {
+    i64 due = dueNanos(m_index);
+    i64 now = monotonicNanos();
+    if (now < due) {
+        waitUntil(due);
+        now = monotonicNanos();
+    }
+    
+    u32 backlog = static_cast<u32>(std::min<i64>((now - due) / m_intervalNanos, static_cast<i64>(std::numeric_limits<u32>::max())));
+    if (backlog > m_config.maxCatchUpTicks) {
+        // Too far behind to replay: move the schedule so this tick is due now
+        m_stats.droppedTicks += backlog;
+        m_epochNanos += now - due;
+        due = now;
+        backlog = 0;
+    }
+    
+    TickTiming timing;
+    timing.tick = m_firstTick + static_cast<Tick>(m_index);
+    timing.scheduledNanos = due;
+    timing.startNanos = now;
+    timing.backlog = backlog;
+    timing.shed = m_config.overload == OverloadPolicy::Shed && backlog > 0;
+    
+    const i64 lateness = now - due;
+    if (lateness >= m_intervalNanos) {
+        ++m_stats.lateTicks;
+    } else {
+        m_stats.startJitter.record(lateness);
+    }
+    if (timing.shed) {
+        ++m_stats.shedTicks;
+    }
+    ++m_stats.ticks;
+    
+    m_tickStartNanos = now;
+    ++m_index;
+    return timing;
+}
+
+void TickPacer::endTick() {
+    const i64 duration = monotonicNanos() - m_tickStartNanos;
+    m_stats.tickDuration.record(duration);
+    if (duration > m_intervalNanos) {
+        ++m_stats.overruns;
+    }
+}
+
+} // namespace cscpp
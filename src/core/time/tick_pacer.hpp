@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file tick_pacer.hpp
+ * @brief Fixed-rate tick scheduling with integer nanosecond timing
+ *
+ * Tick n is due at start + n * 1e9 / tickRate, computed in integer
+ * nanoseconds, so the schedule never drifts no matter how long the server
+ * runs. Waiting is hybrid: the OS sleep covers all but the last spinNs of
+ * the wait and a pause loop covers the rest, so start jitter does not depend
+ * on the scheduler's sleep granularity.
+ *
+ * When a tick runs late, the overload policy decides what happens: run the
+ * missed ticks back-to-back (CatchUp), or do the same but flag shedding so
+ * the caller can skip optional work such as snapshots (Shed). A backlog
+ * beyond maxCatchUpTicks is dropped and counted instead of replayed.
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <chrono>
+
+namespace cscpp {
+
+/// Monotonic time in nanoseconds
+inline i64 monotonicNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+/**
+ * @brief Power-of-two microsecond histogram
+ *
+ * Bucket 0 holds samples under 1 us, bucket i samples in [2^(i-1), 2^i) us,
+ * the last bucket everything above. Recording is a bit scan and an add.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 20;   // Last bucket: >= ~262 ms
+    
+    void record(i64 nanos);
+    void reset();
+    
+    u64 getCount() const { return m_count; }
+    i64 getMaxNanos() const { return m_max; }
+    i64 getMeanNanos() const { return m_count ? m_sum / static_cast<i64>(m_count) : 0; }
+    
+    /// Upper bound (ns) of the bucket containing the given percentile (0-100)
+    i64 getPercentileNanos(f64 percentile) const;
+    
+    const std::array<u64, BUCKET_COUNT>& getBuckets() const { return m_buckets; }
+    
+    /// Upper bound of a bucket in nanoseconds
+    static i64 bucketUpperNanos(size_t bucket) {
+        return static_cast<i64>(1000) << bucket;
+    }
+    
+private:
+    std::array<u64, BUCKET_COUNT> m_buckets{};
+    u64 m_count = 0;
+    i64 m_sum = 0;
+    i64 m_max = 0;
+};
+
+// ============================================================================
+// Tick Pacer
+// ============================================================================
+
+enum class OverloadPolicy : u8 {
+    CatchUp,    ///< Run missed ticks back-to-back
+    Shed,       ///< Run missed ticks, flag them so optional work is skipped
+};
+
+/// Platform sleep primitive; may return early but should not oversleep much
+using SleepFunction = void (*)(i64 nanos);
+
+/// OS sleep for this platform (high-resolution timers where available)
+void platformSleep(i64 nanos);
+
+/// Default spin window for this platform's sleep precision
+i64 platformSpinNanos();
+
+struct TickPacerConfig {
+    u32 tickRate = 128;
+    OverloadPolicy overload = OverloadPolicy::CatchUp;
+    u32 maxCatchUpTicks = 32;                   ///< Larger backlogs are dropped
+    i64 spinNanos = -1;                         ///< Busy-wait window (-1 = platform default)
+    SleepFunction sleep = &platformSleep;
+};
+
+/**
+ * @brief Timing of one tick, returned by waitForTick()
+ */
+struct TickTiming {
+    Tick tick = 0;
+    i64 scheduledNanos = 0;     ///< When the tick was due
+    i64 startNanos = 0;         ///< When it actually started
+    u32 backlog = 0;            ///< Further ticks already due after this one
+    bool shed = false;          ///< Behind schedule under OverloadPolicy::Shed
+    
+    i64 getLateness() const { return startNanos - scheduledNanos; }
+};
+
+struct TickPacerStats {
+    LatencyHistogram startJitter;   ///< Start time minus due time (on-time ticks)
+    LatencyHistogram tickDuration;  ///< Time spent between waitForTick() and endTick()
+    u64 ticks = 0;
+    u64 lateTicks = 0;              ///< Ticks that started a full interval late
+    u64 overruns = 0;               ///< Ticks that took longer than one interval
+    u64 shedTicks = 0;
+    u64 droppedTicks = 0;           ///< Backlog discarded beyond maxCatchUpTicks
+    
+    void reset() { *this = TickPacerStats{}; }
+};
+
+class TickPacer {
+public:
+    TickPacer() = default;
+    explicit TickPacer(const TickPacerConfig& config) { configure(config); }
+    
+    void configure(const TickPacerConfig& config);
+    
+    /// Start the schedule at tick 0, due now
+    void start(Tick firstTick = 0);
+    
+    /**
+     * @brief Block until the next tick is due
+     *
+     * Returns immediately while catching up on a backlog.
+     */
+    TickTiming waitForTick();
+    
+    /// Mark the end of the tick returned by the last waitForTick()
+    void endTick();
+    
+    i64 getIntervalNanos() const { return m_intervalNanos; }
+    f32 getIntervalSeconds() const { return static_cast<f32>(m_intervalNanos) * 1e-9f; }
+    const TickPacerConfig& getConfig() const { return m_config; }
+    
+    const TickPacerStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats.reset(); }
+    
+private:
+    /// Due time of tick index n (relative to the schedule start)
+    i64 dueNanos(u64 index) const {
+        return m_epochNanos + static_cast<i64>(index * 1'000'000'000ull / m_config.tickRate);
+    }
+    
+    void waitUntil(i64 deadline) const;
+    
+    TickPacerConfig m_config;
+    i64 m_intervalNanos = 1'000'000'000 / 128;
+    i64 m_spinNanos = 0;
+    
+    i64 m_epochNanos = 0;
+    u64 m_index = 0;            ///< Schedule index of the next tick
+    Tick m_firstTick = 0;
+    i64 m_tickStartNanos = 0;
+    
+    TickPacerStats m_stats;
+};
+
+} // namespace cscpp
@@ -2,7 +2,11 @@
 
 #include "core/types.hpp"
 #include "core/math/math.hpp"
+#include "core/platform/input.hpp"
+#include "ecs/components/physics.hpp"
+#include <algorithm>
 #include <array>
+#include <utility>
 
 namespace cscpp::ecs {
 
@@ -36,9 +40,17 @@ struct EntityState {
 
 /**
  * @brief Client-side interpolation state
+ *
+ * Ring of the newest `depth` snapshots of a remote entity, oldest to newest
+ * in tick order. Snapshots arriving out of order are dropped; the sender's
+ * later states already supersede them.
  */
 struct InterpolationComponent {
-    static constexpr size_t HISTORY_SIZE = 3;
+    static constexpr size_t MAX_HISTORY = 32;
+    static constexpr size_t DEFAULT_DEPTH = 3;
+    
+    /// How far past the newest snapshot samples are extrapolated (seconds)
+    static constexpr f32 DEFAULT_MAX_EXTRAPOLATION = 0.1f;
     
     struct Snapshot {
         Tick tick = 0;
@@ -48,96 +60,274 @@ struct InterpolationComponent {
         Quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
     };
     
-    std::array<Snapshot, HISTORY_SIZE> history;
-    size_t historyHead = 0;
-    f32 interpTime = 0.0f;
+    std::array<Snapshot, MAX_HISTORY> history;
+    size_t historyHead = 0;             ///< Newest snapshot
+    size_t historyCount = 0;
+    size_t depth = DEFAULT_DEPTH;       ///< Snapshots kept (<= MAX_HISTORY)
+    f32 interpTime = 0.0f;              ///< Time of the last sample taken
     
     void addSnapshot(Tick tick, f32 time, Vec3 pos, Vec3 vel, Quat rot) {
-        historyHead = (historyHead + 1) % HISTORY_SIZE;
+        if (historyCount > 0 && tick <= history[historyHead].tick) {
+            return;
+        }
+        historyHead = (historyHead + 1) % MAX_HISTORY;
         history[historyHead] = {tick, time, pos, vel, rot};
+        historyCount = std::min(historyCount + 1, std::clamp<size_t>(depth, 2, MAX_HISTORY));
+    }
+    
+    /// Snapshot `age` steps back from the newest (0 = newest)
+    const Snapshot& getSnapshot(size_t age) const {
+        return history[(historyHead + MAX_HISTORY - age) % MAX_HISTORY];
+    }
+    
+    void clear() {
+        historyCount = 0;
+    }
+    
+    /**
+     * @brief Snapshots around `time`
+     * @param alpha Blend factor from `from` to `to`
+     * @return false if the history is empty
+     *
+     * Before the oldest snapshot both point at the oldest; past the newest
+     * both point at the newest and alpha is the time since it (seconds).
+     */
+    bool findBracket(f32 time, const Snapshot*& from, const Snapshot*& to, f32& alpha) const {
+        if (historyCount == 0) {
+            return false;
+        }
+        
+        const Snapshot& newest = getSnapshot(0);
+        if (time >= newest.time) {
+            from = to = &newest;
+            alpha = time - newest.time;
+            return true;
+        }
+        
+        // Render time trails the newest snapshot by a few entries: scan back
+        for (size_t age = 1; age < historyCount; ++age) {
+            const Snapshot& older = getSnapshot(age);
+            if (older.time <= time) {
+                const Snapshot& newer = getSnapshot(age - 1);
+                const f32 span = newer.time - older.time;
+                from = &older;
+                to = &newer;
+                alpha = span > 0.0f ? (time - older.time) / span : 1.0f;
+                return true;
+            }
+        }
+        
+        from = to = &getSnapshot(historyCount - 1);
+        alpha = 0.0f;
+        return true;
     }
     
     /// Get interpolated position at given time
-    Vec3 getInterpolatedPosition(f32 time) const;
-    Quat getInterpolatedRotation(f32 time) const;
+    Vec3 getInterpolatedPosition(f32 time) const {
+        const Snapshot* from = nullptr;
+        const Snapshot* to = nullptr;
+        f32 alpha = 0.0f;
+        if (!findBracket(time, from, to, alpha)) {
+            return Vec3(0.0f);
+        }
+        if (from == to) {
+            return from->position + from->velocity * std::min(alpha, DEFAULT_MAX_EXTRAPOLATION);
+        }
+        return glm::mix(from->position, to->position, alpha);
+    }
+    
+    Quat getInterpolatedRotation(f32 time) const {
+        const Snapshot* from = nullptr;
+        const Snapshot* to = nullptr;
+        f32 alpha = 0.0f;
+        if (!findBracket(time, from, to, alpha)) {
+            return Quat(1.0f, 0.0f, 0.0f, 0.0f);
+        }
+        if (from == to) {
+            return from->rotation;
+        }
+        return glm::slerp(from->rotation, to->rotation, alpha);
+    }
 };
 
 /**
  * @brief Client-side prediction state
+ *
+ * Ring of movement states after each predicted command, indexed by
+ * tick % BUFFER_SIZE. Each entry holds everything PM_PlayerMove carries
+ * from one tick to the next, so prediction can restart from any stored tick.
  */
 struct PredictionComponent {
     static constexpr size_t BUFFER_SIZE = 128;
     
     struct PredictedState {
         Tick tick = 0;
+        bool valid = false;
+        UserCmd cmd;                    ///< Command that produced this state
+        
         Vec3 position{0.0f};
         Vec3 velocity{0.0f};
+        Vec3 baseVelocity{0.0f};
         i32 flags = 0;
-        UserCmd cmd;
+        i32 waterLevel = 0;
+        i32 useHull = 0;
+        f32 duckTime = 0.0f;
+        bool inDuck = false;
+        f32 fallVelocity = 0.0f;
     };
     
     std::array<PredictedState, BUFFER_SIZE> buffer;
     Tick oldestTick = 0;
     Tick newestTick = 0;
+    Tick lastReconciledTick = 0;        ///< Newest server ack already checked
     
     /// Store predicted state for reconciliation
     void store(Tick tick, const PredictedState& state) {
         size_t index = tick % BUFFER_SIZE;
         buffer[index] = state;
         buffer[index].tick = tick;
+        buffer[index].valid = true;
         
         if (tick > newestTick) newestTick = tick;
         if (oldestTick == 0 || tick < oldestTick) oldestTick = tick;
+        if (newestTick - oldestTick >= BUFFER_SIZE) oldestTick = newestTick - BUFFER_SIZE + 1;
     }
     
     /// Get predicted state at tick
     const PredictedState* get(Tick tick) const {
         if (tick < oldestTick || tick > newestTick) return nullptr;
         size_t index = tick % BUFFER_SIZE;
-        if (buffer[index].tick != tick) return nullptr;
+        if (!buffer[index].valid || buffer[index].tick != tick) return nullptr;
         return &buffer[index];
     }
     
+    PredictedState* get(Tick tick) {
+        return const_cast<PredictedState*>(std::as_const(*this).get(tick));
+    }
+    
     /// Clear predictions before tick
     void clearBefore(Tick tick) {
         oldestTick = tick;
     }
+    
+    /// Forget every prediction (respawn, teleport)
+    void reset() {
+        for (PredictedState& state : buffer) {
+            state.valid = false;
+        }
+        oldestTick = 0;
+        newestTick = 0;
+        lastReconciledTick = 0;
+    }
 };
 
 /**
  * @brief Server-side hitbox history for lag compensation
+ *
+ * Tick-indexed ring: entry for tick T lives at T % HISTORY_SIZE, so lookups
+ * are a single index plus a tick check. Each entry keeps the entity
+ * transform and a copy of every hitbox, stored inline to avoid per-tick
+ * allocation. Entries are keyed by tick only; a float time would lose
+ * sub-tick precision after a few hours of uptime.
  */
 struct HitboxHistoryComponent {
     static constexpr size_t HISTORY_SIZE = 128;  // ~1 second at 128 tick
+    static constexpr size_t MAX_HITBOXES = 24;   // Player models use ~20
     
     struct HistoryEntry {
         Tick tick = 0;
-        f32 time = 0.0f;
+        bool valid = false;
         Vec3 position{0.0f};
         Quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
-        // Could include full hitbox transforms for accurate rewind
+        u32 hitboxCount = 0;
+        std::array<HitboxComponent::Hitbox, MAX_HITBOXES> hitboxes{};
     };
     
     std::array<HistoryEntry, HISTORY_SIZE> history;
-    size_t historyHead = 0;
+    Tick newestTick = 0;
+    bool hasHistory = false;
     
-    void record(Tick tick, f32 time, Vec3 pos, Quat rot) {
-        historyHead = (historyHead + 1) % HISTORY_SIZE;
-        history[historyHead] = {tick, time, pos, rot};
+    void record(Tick tick, Vec3 pos, Quat rot, const HitboxComponent& hitbox) {
+        HistoryEntry& entry = history[tick % HISTORY_SIZE];
+        entry.tick = tick;
+        entry.valid = true;
+        entry.position = pos;
+        entry.rotation = rot;
+        entry.hitboxCount = static_cast<u32>(std::min(hitbox.hitboxes.size(), MAX_HITBOXES));
+        std::copy_n(hitbox.hitboxes.begin(), entry.hitboxCount, entry.hitboxes.begin());
+        
+        if (!hasHistory || tick > newestTick) {
+            newestTick = tick;
+        }
+        hasHistory = true;
     }
     
     /// Get historical state at tick (for lag compensation)
     const HistoryEntry* getAtTick(Tick tick) const {
-        for (const auto& entry : history) {
-            if (entry.tick == tick) {
-                return &entry;
+        const HistoryEntry& entry = history[tick % HISTORY_SIZE];
+        return (entry.valid && entry.tick == tick) ? &entry : nullptr;
+    }
+    
+    /**
+     * @brief Interpolated state `fraction` of the way from tick to tick + 1
+     *
+     * Hitbox extents are blended when both records have the same hitbox
+     * layout, otherwise the nearer record's hitboxes are used. Ticks past the
+     * newest record return the newest, ticks older than the ring the oldest.
+     */
+    bool sample(Tick tick, f32 fraction, HistoryEntry& out) const {
+        const HistoryEntry* from = nullptr;
+        const HistoryEntry* to = nullptr;
+        f32 alpha = 0.0f;
+        if (!findBracket(tick, fraction, from, to, alpha)) {
+            return false;
+        }
+        
+        if (!from) {
+            out = *to;
+            return true;
+        }
+        
+        out = alpha < 0.5f ? *from : *to;
+        out.position = glm::mix(from->position, to->position, alpha);
+        out.rotation = glm::slerp(from->rotation, to->rotation, alpha);
+        
+        if (from->hitboxCount == to->hitboxCount) {
+            for (u32 i = 0; i < out.hitboxCount; ++i) {
+                out.hitboxes[i].mins = glm::mix(from->hitboxes[i].mins, to->hitboxes[i].mins, alpha);
+                out.hitboxes[i].maxs = glm::mix(from->hitboxes[i].maxs, to->hitboxes[i].maxs, alpha);
             }
         }
-        return nullptr;
+        return true;
     }
     
-    /// Get historical state closest to time
-    const HistoryEntry* getAtTime(f32 time) const;
+private:
+    /// Records at tick (`from`) and tick + 1 (`to`); `to` alone when only one applies
+    bool findBracket(Tick tick, f32 fraction, const HistoryEntry*& from, const HistoryEntry*& to,
+                     f32& alpha) const {
+        if (!hasHistory) {
+            return false;
+        }
+        
+        // Clamp to the records the ring still holds
+        const Tick oldestTick = newestTick - std::min<Tick>(HISTORY_SIZE - 1, newestTick);
+        if (tick >= newestTick || tick < oldestTick) {
+            from = nullptr;
+            to = getAtTick(tick >= newestTick ? newestTick : oldestTick);
+            return to != nullptr;
+        }
+        
+        from = getAtTick(tick);
+        to = getAtTick(tick + 1);
+        if (!from || !to) {
+            to = from ? from : to;
+            from = nullptr;
+            return to != nullptr;
+        }
+        
+        alpha = std::clamp(fraction, 0.0f, 1.0f);
+        return true;
+    }
 };
 
 /**
@@ -149,6 +339,8 @@ struct NetworkStatsComponent {
     f32 packetLoss = 0.0f;        // 0-1 packet loss ratio
     u32 packetsReceived = 0;
     u32 packetsSent = 0;
+    u64 bytesReceived = 0;        // Totals since connecting
+    u64 bytesSent = 0;
     f32 incomingBandwidth = 0.0f; // Bytes/sec
     f32 outgoingBandwidth = 0.0f;
 };
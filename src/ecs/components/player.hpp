@@ -2,8 +2,9 @@
 
 #include "core/types.hpp"
 #include "core/platform/input.hpp"
+#include "ecs/components/user_cmd_ring.hpp"
 #include <entt/entt.hpp>
-#include <deque>
+#include <span>
 
 namespace cscpp::ecs {
 
@@ -84,29 +85,45 @@ struct HealthComponent {
 
 /**
  * @brief Input command buffer
+ *
+ * Filled by the network receive path, consumed by movement.
  */
 struct InputComponent {
-    std::deque<UserCmd> pendingCmds;
+    UserCmdRing cmds;
     UserCmd latestCmd;
     Tick lastProcessedTick = 0;
+    u16 lastButtons = 0;            ///< Buttons of the last command movement ran
     
-    static constexpr size_t MAX_PENDING_CMDS = 128;
+    static constexpr size_t MAX_PENDING_CMDS = UserCmdRing::CAPACITY;
     
-    void addCmd(const UserCmd& cmd) {
-        pendingCmds.push_back(cmd);
-        while (pendingCmds.size() > MAX_PENDING_CMDS) {
-            pendingCmds.pop_front();
+    /// Buffer a command; false for duplicates and already processed ticks
+    bool addCmd(const UserCmd& cmd) {
+        if (!cmds.insert(cmd)) {
+            return false;
         }
-        latestCmd = cmd;
+        if (cmd.tick >= latestCmd.tick) {
+            latestCmd = cmd;
+        }
+        return true;
     }
     
-    UserCmd* getCmd(Tick tick) {
-        for (auto& cmd : pendingCmds) {
-            if (cmd.tick == tick) {
-                return &cmd;
-            }
+    /// Buffer a UserCmdMsg batch; returns the number of new commands
+    u32 addCmds(std::span<const UserCmd> batch) {
+        u32 added = 0;
+        for (const UserCmd& cmd : batch) {
+            added += addCmd(cmd) ? 1u : 0u;
         }
-        return nullptr;
+        return added;
+    }
+    
+    UserCmd* getCmd(Tick tick) {
+        return cmds.find(tick);
+    }
+    
+    /// Release commands up to tick once movement has run them
+    void markProcessed(Tick tick) {
+        cmds.markProcessed(tick);
+        lastProcessedTick = tick;
     }
 };
 
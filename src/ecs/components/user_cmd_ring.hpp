@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file user_cmd_ring.hpp
+ * @brief Fixed-capacity, tick-indexed command buffer
+ *
+ * The command for tick T lives in slot T % CAPACITY, so lookup is one index
+ * plus a tick check. Clients resend their last few commands in every
+ * UserCmdMsg; insert() drops anything already buffered or already
+ * processed, so redundant copies cost one compare each and lost packets are
+ * filled in by the next one that arrives. No heap allocation.
+ */
+
+#include "core/types.hpp"
+#include "core/platform/input.hpp"
+
+#include <array>
+#include <bitset>
+#include <span>
+
+namespace cscpp::ecs {
+
+class UserCmdRing {
+public:
+    static constexpr size_t CAPACITY = 128;   // ~1 second at 128 tick
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    
+    /**
+     * @brief Buffer a command
+     * @return false if it was a duplicate, already processed, more than
+     *         CAPACITY ticks past the last processed command, or too old to
+     *         fit behind the newest command
+     *
+     * cmd.tick comes from the client, so the comparisons are written as tick
+     * differences that cannot wrap. Once a command has been processed, every
+     * accepted tick lies within one lap after it and slots cannot collide.
+     */
+    bool insert(const UserCmd& cmd) {
+        if (m_hasProcessed) {
+            if (cmd.tick <= m_lastProcessed || cmd.tick - m_lastProcessed > CAPACITY) {
+                return false;
+            }
+        } else if (m_hasNewest && cmd.tick < m_newest && m_newest - cmd.tick >= CAPACITY) {
+            return false;
+        }
+        
+        const size_t slot = cmd.tick & (CAPACITY - 1);
+        if (m_occupied[slot] && m_cmds[slot].tick == cmd.tick) {
+            return false;
+        }
+        
+        // Overwrites a stale command CAPACITY ticks older, if any
+        m_cmds[slot] = cmd;
+        m_occupied[slot] = true;
+        
+        if (!m_hasNewest || cmd.tick > m_newest) {
+            m_newest = cmd.tick;
+            m_hasNewest = true;
+        }
+        return true;
+    }
+    
+    /// Buffer a batch (e.g. UserCmdMsg::cmds); returns the number of new commands
+    u32 insert(std::span<const UserCmd> cmds) {
+        u32 added = 0;
+        for (const UserCmd& cmd : cmds) {
+            added += insert(cmd) ? 1u : 0u;
+        }
+        return added;
+    }
+    
+    /// Command for tick, or nullptr if it has not arrived
+    const UserCmd* find(Tick tick) const {
+        const size_t slot = tick & (CAPACITY - 1);
+        return (m_occupied[slot] && m_cmds[slot].tick == tick) ? &m_cmds[slot] : nullptr;
+    }
+    
+    UserCmd* find(Tick tick) {
+        const size_t slot = tick & (CAPACITY - 1);
+        return (m_occupied[slot] && m_cmds[slot].tick == tick) ? &m_cmds[slot] : nullptr;
+    }
+    
+    /**
+     * @brief Mark every command up to tick as processed
+     *
+     * Later resends of those ticks are rejected by insert().
+     */
+    void markProcessed(Tick tick) {
+        if (m_hasProcessed && tick <= m_lastProcessed) {
+            return;
+        }
+        
+        // Free the slots in (lastProcessed, tick], at most one lap
+        Tick first = m_hasProcessed ? m_lastProcessed + 1 : 0;
+        if (tick - first >= CAPACITY) {
+            first = tick - (CAPACITY - 1);
+        }
+        for (Tick t = first; ; ++t) {
+            const size_t slot = t & (CAPACITY - 1);
+            if (m_occupied[slot] && m_cmds[slot].tick <= tick) {
+                m_occupied[slot] = false;
+            }
+            if (t == tick) {
+                break;
+            }
+        }
+        
+        m_lastProcessed = tick;
+        m_hasProcessed = true;
+        
+        // Drop a newest tick that insert() would no longer accept
+        if (!m_hasNewest || m_newest < tick || m_newest - tick > CAPACITY) {
+            m_newest = tick;
+            m_hasNewest = true;
+        }
+    }
+    
+    void clear() {
+        m_occupied.reset();
+        m_hasNewest = false;
+        m_hasProcessed = false;
+        m_newest = 0;
+        m_lastProcessed = 0;
+    }
+    
+    /// Commands buffered and not yet processed
+    size_t size() const { return m_occupied.count(); }
+    bool empty() const { return m_occupied.none(); }
+    
+    bool hasNewest() const { return m_hasNewest; }
+    Tick getNewestTick() const { return m_newest; }
+    bool hasProcessed() const { return m_hasProcessed; }
+    Tick getLastProcessedTick() const { return m_lastProcessed; }
+    
+private:
+    std::array<UserCmd, CAPACITY> m_cmds{};
+    std::bitset<CAPACITY> m_occupied;
+    Tick m_newest = 0;
+    Tick m_lastProcessed = 0;
+    bool m_hasNewest = false;
+    bool m_hasProcessed = false;
+};
+
+} // namespace cscpp::ecs
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "ecs/systems/system_access.hpp"
 #include <entt/entt.hpp>
 
 namespace cscpp::ecs {
@@ -33,7 +34,20 @@ public:
     virtual void shutdown(entt::registry& registry) {
         (void)registry;
     }
-    
+
+    /**
+     * @brief Declare the components this system reads and writes
+     *
+     * Called once at registration. Systems that declare nothing run
+     * exclusively within their phase.
+     */
+    virtual void declareAccess(SystemAccess& access) const {
+        (void)access;
+    }
+
+    /// Name used for timing reports
+    virtual const char* getName() const { return "System"; }
+
     /// Enable/disable the system
     void setEnabled(bool enabled) { m_enabled = enabled; }
     bool isEnabled() const { return m_enabled; }
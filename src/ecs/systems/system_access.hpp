@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace cscpp::ecs {
+
+/**
+ * @brief Components a system reads and writes
+ *
+ * Filled by System::declareAccess and used by the World scheduler to decide
+ * which systems of a phase may run at the same time. Two systems conflict if
+ * one writes a component the other reads or writes.
+ *
+ * A system that declares nothing, or calls structural(), is exclusive: it
+ * runs alone. Systems that create/destroy entities or add/remove components
+ * must be structural, since that mutates registry state shared by all views.
+ */
+class SystemAccess {
+public:
+    /// Declare read-only access to component T
+    template<typename T>
+    SystemAccess& read() {
+        add<T>(m_reads);
+        return *this;
+    }
+
+    /// Declare read/write access to component T
+    template<typename T>
+    SystemAccess& write() {
+        add<T>(m_writes);
+        return *this;
+    }
+
+    /// Declare that the system changes registry structure (runs exclusively)
+    SystemAccess& structural() {
+        m_declared = true;
+        m_exclusive = true;
+        return *this;
+    }
+
+    /// True if the system must run alone
+    bool isExclusive() const { return !m_declared || m_exclusive; }
+
+    /// True if the two systems may not run at the same time
+    bool conflictsWith(const SystemAccess& other) const {
+        if (isExclusive() || other.isExclusive()) {
+            return true;
+        }
+        return intersects(m_writes, other.m_writes) ||
+               intersects(m_writes, other.m_reads) ||
+               intersects(m_reads, other.m_writes);
+    }
+
+    /**
+     * @brief Create every declared storage up front
+     *
+     * entt creates storage lazily on first view; doing it before systems run
+     * concurrently keeps the registry's pool map read-only during the phase.
+     */
+    void assureStorage(entt::registry& registry) const {
+        for (auto assure : m_assure) {
+            assure(registry);
+        }
+    }
+
+private:
+    using AssureFunc = void(*)(entt::registry&);
+
+    template<typename T>
+    void add(std::vector<entt::id_type>& list) {
+        m_declared = true;
+
+        constexpr entt::id_type id = entt::type_hash<T>::value();
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it != list.end() && *it == id) {
+            return;
+        }
+        list.insert(it, id);
+
+        m_assure.push_back([](entt::registry& registry) {
+            (void)registry.storage<T>();
+        });
+    }
+
+    static bool intersects(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b) {
+        // Both lists are sorted
+        auto ia = a.begin();
+        auto ib = b.begin();
+        while (ia != a.end() && ib != b.end()) {
+            if (*ia == *ib) return true;
+            if (*ia < *ib) ++ia; else ++ib;
+        }
+        return false;
+    }
+
+    std::vector<entt::id_type> m_reads;
+    std::vector<entt::id_type> m_writes;
+    std::vector<AssureFunc> m_assure;
+    bool m_declared = false;
+    bool m_exclusive = false;
+};
+
+} // namespace cscpp::ecs
@@ -1,6 +1,8 @@
 #include "ecs/world/world.hpp"
 #include "ecs/systems/system.hpp"
 #include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include <chrono>
 
 namespace cscpp::ecs {
 
@@ -31,13 +33,7 @@ size_t World::getEntityCount() const {
 }
 
 void World::updatePhase(SystemPhase phase, f32 deltaTime) {
-    size_t phaseIndex = static_cast<size_t>(phase);
-    
-    for (auto& system : m_systems[phaseIndex]) {
-        if (system->isEnabled()) {
-            system->update(m_registry, deltaTime);
-        }
-    }
+    runPhase(static_cast<size_t>(phase), deltaTime, false);
 }
 
 void World::update(f32 deltaTime) {
@@ -56,23 +52,147 @@ void World::update(f32 deltaTime) {
 void World::fixedUpdate(f32 fixedDeltaTime) {
     // Fixed update runs physics systems at a fixed rate
     for (size_t i = 0; i < PHASE_COUNT; ++i) {
-        for (auto& system : m_systems[i]) {
-            if (system->isEnabled()) {
-                system->fixedUpdate(m_registry, fixedDeltaTime);
+        runPhase(i, fixedDeltaTime, true);
+    }
+    
+    ++m_currentTick;
+}
+
+// ============================================================================
+// System Scheduling
+// ============================================================================
+
+void World::addSystem(SystemPhase phase, std::unique_ptr<System> system) {
+    size_t phaseIndex = static_cast<size_t>(phase);
+    
+    SystemEntry entry;
+    system->declareAccess(entry.access);
+    entry.system = std::move(system);
+    
+    m_systems[phaseIndex].push_back(std::move(entry));
+    m_schedules[phaseIndex].dirty = true;
+}
+
+void World::rebuildSchedule(size_t phaseIndex) {
+    auto& entries = m_systems[phaseIndex];
+    PhaseSchedule& schedule = m_schedules[phaseIndex];
+    
+    // Each system depends on every earlier system it conflicts with, so
+    // conflicting systems still run in registration order
+    schedule.parallel = false;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entries[i].dependencies.clear();
+        for (size_t j = 0; j < i; ++j) {
+            if (entries[i].access.conflictsWith(entries[j].access)) {
+                entries[i].dependencies.push_back(static_cast<u32>(j));
             }
         }
+        if (entries[i].dependencies.size() < i) {
+            schedule.parallel = true;
+        }
     }
     
-    ++m_currentTick;
+    schedule.handles.resize(entries.size());
+    schedule.dirty = false;
+}
+
+void World::runSystem(SystemEntry& entry, entt::registry& registry, f32 deltaTime, bool fixed) {
+    if (!entry.system->isEnabled()) {
+        return;
+    }
+    
+    CSCPP_PROFILE_ZONE_DYNAMIC(entry.system->getName());
+    
+    auto start = Clock::now();
+    
+    if (fixed) {
+        entry.system->fixedUpdate(registry, deltaTime);
+    } else {
+        entry.system->update(registry, deltaTime);
+    }
+    
+    f64 elapsedMs = std::chrono::duration<f64, std::milli>(Clock::now() - start).count();
+    if (fixed) {
+        entry.fixedUpdateMs = elapsedMs;
+    } else {
+        entry.updateMs = elapsedMs;
+    }
+    entry.averageMs = entry.averageMs * 0.95 + elapsedMs * 0.05;
+}
+
+void World::runPhase(size_t phaseIndex, f32 deltaTime, bool fixed) {
+    CSCPP_PROFILE_ZONE("World::runPhase");
+    CSCPP_PROFILE_ZONE_VALUE(phaseIndex);
+    
+    auto& entries = m_systems[phaseIndex];
+    PhaseSchedule& schedule = m_schedules[phaseIndex];
+    
+    if (schedule.dirty) {
+        rebuildSchedule(phaseIndex);
+    }
+    
+    // Serial path: no pool, or nothing in this phase can overlap
+    if (!m_jobs || m_jobs->getWorkerCount() == 0 || !schedule.parallel) {
+        for (auto& entry : entries) {
+            runSystem(entry, m_registry, deltaTime, fixed);
+        }
+        return;
+    }
+    
+    // Storage must exist before views are created from several threads
+    for (const auto& entry : entries) {
+        entry.access.assureStorage(m_registry);
+    }
+    
+    for (size_t i = 0; i < entries.size(); ++i) {
+        m_dependencyScratch.clear();
+        for (u32 dependency : entries[i].dependencies) {
+            m_dependencyScratch.push_back(schedule.handles[dependency]);
+        }
+        
+        SystemEntry* entry = &entries[i];
+        schedule.handles[i] = m_jobs->schedule(
+            [this, entry, deltaTime, fixed] { runSystem(*entry, m_registry, deltaTime, fixed); },
+            m_dependencyScratch
+        );
+    }
+    
+    for (const auto& handle : schedule.handles) {
+        m_jobs->wait(handle);
+    }
+    
+    // Drop references to finished counters
+    for (auto& handle : schedule.handles) {
+        handle = JobHandle();
+    }
+}
+
+std::vector<SystemTiming> World::getSystemTimings() const {
+    std::vector<SystemTiming> timings;
+    
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        for (const auto& entry : m_systems[i]) {
+            SystemTiming timing;
+            timing.name = entry.system->getName();
+            timing.phase = static_cast<SystemPhase>(i);
+            timing.updateMs = entry.updateMs;
+            timing.fixedUpdateMs = entry.fixedUpdateMs;
+            timing.averageMs = entry.averageMs;
+            timings.push_back(timing);
+        }
+    }
+    
+    return timings;
 }
 
 void World::clear() {
     // Shutdown all systems
     for (size_t i = 0; i < PHASE_COUNT; ++i) {
-        for (auto& system : m_systems[i]) {
-            system->shutdown(m_registry);
+        for (auto& entry : m_systems[i]) {
+            entry.system->shutdown(m_registry);
         }
         m_systems[i].clear();
+        m_schedules[i] = PhaseSchedule();
     }
     
     // Clear all entities
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "core/jobs/job_system.hpp"
+#include "ecs/systems/system_access.hpp"
 #include <entt/entt.hpp>
 #include <vector>
 #include <memory>
@@ -23,10 +25,25 @@ enum class SystemPhase {
     Network         ///< Network send/receive
 };
 
+/**
+ * @brief Per-system timing from the last update
+ */
+struct SystemTiming {
+    const char* name = "";
+    SystemPhase phase = SystemPhase::PrePhysics;
+    f64 updateMs = 0.0;         ///< Last update() duration
+    f64 fixedUpdateMs = 0.0;    ///< Last fixedUpdate() duration
+    f64 averageMs = 0.0;        ///< Smoothed total per call
+};
+
 /**
  * @brief ECS World
  * 
  * Manages entities, components, and systems.
+ * 
+ * Phases run in order. Within a phase, systems whose declared component
+ * access doesn't conflict run concurrently on the job system (if one is
+ * set); conflicting systems keep their registration order.
  */
 class World {
 public:
@@ -114,10 +131,16 @@ public:
     T* registerSystem(SystemPhase phase, Args&&... args) {
         auto system = std::make_unique<T>(std::forward<Args>(args)...);
         T* ptr = system.get();
-        m_systems[static_cast<size_t>(phase)].push_back(std::move(system));
+        addSystem(phase, std::move(system));
         return ptr;
     }
     
+    /// Set the job system used to run independent systems in parallel (nullptr = serial)
+    void setJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+    
+    /// Timings of all systems from their last run
+    std::vector<SystemTiming> getSystemTimings() const;
+    
     /// Update all systems in a phase
     void updatePhase(SystemPhase phase, f32 deltaTime);
     
@@ -147,11 +170,35 @@ public:
     f32 getTime() const { return m_time; }
     
 private:
+    struct SystemEntry {
+        std::unique_ptr<System> system;
+        SystemAccess access;
+        std::vector<u32> dependencies;  ///< Earlier systems in the phase this one conflicts with
+        f64 updateMs = 0.0;
+        f64 fixedUpdateMs = 0.0;
+        f64 averageMs = 0.0;
+    };
+    
+    struct PhaseSchedule {
+        bool dirty = true;
+        bool parallel = false;          ///< At least two systems may overlap
+        std::vector<JobHandle> handles;
+    };
+    
+    void addSystem(SystemPhase phase, std::unique_ptr<System> system);
+    void runPhase(size_t phaseIndex, f32 deltaTime, bool fixed);
+    void rebuildSchedule(size_t phaseIndex);
+    static void runSystem(SystemEntry& entry, entt::registry& registry, f32 deltaTime, bool fixed);
+    
     entt::registry m_registry;
     
     // Systems organized by phase
     static constexpr size_t PHASE_COUNT = 7;
-    std::vector<std::unique_ptr<System>> m_systems[PHASE_COUNT];
+    std::vector<SystemEntry> m_systems[PHASE_COUNT];
+    PhaseSchedule m_schedules[PHASE_COUNT];
+    std::vector<JobHandle> m_dependencyScratch;
+    
+    JobSystem* m_jobs = nullptr;
     
     Tick m_currentTick = 0;
     f32 m_time = 0.0f;
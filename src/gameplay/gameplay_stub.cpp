@@ -1,7 +0,0 @@
-// Stub file for gameplay library
-// Implementation files will be added here
-
-namespace cscpp::gameplay {
-    // Placeholder
-}
-
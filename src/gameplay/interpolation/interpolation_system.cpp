@@ -0,0 +1,173 @@
+/**
+ * @file interpolation_system.cpp
+ * @brief Client-side interpolation of remote entities between snapshots
+ */
+
+#include "gameplay/interpolation/interpolation_system.hpp"
+#include "ecs/components/transform.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cscpp::gameplay {
+
+namespace {
+
+/// Render clock errors beyond this are snapped instead of slewed (seconds)
+constexpr f32 CLOCK_SNAP_THRESHOLD = 0.25f;
+
+/// Fraction of the render clock error corrected per second
+constexpr f32 CLOCK_CORRECTION_RATE = 4.0f;
+
+} // anonymous namespace
+
+void InterpolationSystem::setConfig(const InterpolationConfig& config) {
+    m_config = config;
+    m_config.bufferDepth = std::clamp<u32>(config.bufferDepth, 2,
+                                           static_cast<u32>(ecs::InterpolationComponent::MAX_HISTORY));
+}
+
+void InterpolationSystem::addSnapshot(entt::registry& registry, entt::entity entity, Tick tick, f32 serverTime,
+                                      Vec3 position, Vec3 velocity, Quat rotation) {
+    auto& interpolation = registry.get_or_emplace<ecs::InterpolationComponent>(entity);
+    interpolation.depth = m_config.bufferDepth;
+    interpolation.addSnapshot(tick, serverTime, position, velocity, rotation);
+}
+
+// ============================================================================
+// Render Clock
+// ============================================================================
+
+void InterpolationSystem::onSnapshot(f32 serverTime, f32 snapshotInterval) {
+    if (snapshotInterval > 0.0f) {
+        m_snapshotInterval = snapshotInterval;
+    }
+    
+    if (!m_hasClock) {
+        m_delay = m_snapshotInterval + m_config.minDelay;
+        m_renderTime = serverTime - m_delay;
+        m_latestServerTime = serverTime;
+        m_sinceSnapshot = 0.0f;
+        m_hasClock = true;
+        return;
+    }
+    
+    if (serverTime > m_latestServerTime) {
+        m_latestServerTime = serverTime;
+        m_sinceSnapshot = 0.0f;
+    }
+}
+
+void InterpolationSystem::advance(f32 frameTime, const ecs::NetworkStatsComponent& stats) {
+    if (!m_hasClock) {
+        return;
+    }
+    
+    // One interval so a bracket normally exists, plus headroom for jitter,
+    // never more than the buffer can cover
+    const f32 bufferSpan = static_cast<f32>(m_config.bufferDepth - 1) * m_snapshotInterval;
+    const f32 maxDelay = std::min(m_config.maxDelay, bufferSpan);
+    const f32 target = std::min(m_snapshotInterval + m_config.minDelay + m_config.jitterScale * stats.jitter,
+                                maxDelay);
+    
+    if (target >= m_delay) {
+        m_delay = target;
+    } else {
+        m_delay = std::max(target, m_delay - m_config.delayDecay * frameTime);
+    }
+    
+    // Server time estimate runs on between snapshots; the render clock
+    // follows it smoothly, delayed
+    m_sinceSnapshot += frameTime;
+    m_renderTime += frameTime;
+    
+    const f32 desired = m_latestServerTime + m_sinceSnapshot - m_delay;
+    const f32 error = desired - m_renderTime;
+    if (std::abs(error) > CLOCK_SNAP_THRESHOLD) {
+        m_renderTime = desired;
+    } else {
+        m_renderTime += error * std::min(1.0f, CLOCK_CORRECTION_RATE * frameTime);
+    }
+    
+    m_stats.delay = m_delay;
+}
+
+// ============================================================================
+// Interpolation
+// ============================================================================
+
+void InterpolationSystem::interpolate(entt::registry& registry) {
+    m_entities.clear();
+    m_fromPosition.clear();
+    m_toPosition.clear();
+    m_fromRotation.clear();
+    m_toRotation.clear();
+    m_alpha.clear();
+    m_stats.entities = 0;
+    m_stats.extrapolated = 0;
+    
+    if (!m_hasClock) {
+        return;
+    }
+    
+    const f32 time = m_renderTime;
+    const f32 maxExtrapolation = m_config.maxExtrapolation;
+    auto view = registry.view<ecs::InterpolationComponent, ecs::TransformComponent>(
+        entt::exclude<ecs::LocalPlayerComponent>);
+    
+    // Gather: reduce every entity to two endpoints and a blend factor
+    for (auto [entity, interpolation, transform] : view.each()) {
+        const ecs::InterpolationComponent::Snapshot* from = nullptr;
+        const ecs::InterpolationComponent::Snapshot* to = nullptr;
+        f32 alpha = 0.0f;
+        if (!interpolation.findBracket(time, from, to, alpha)) {
+            continue;
+        }
+        interpolation.interpTime = time;
+        
+        m_entities.push_back(entity);
+        m_fromPosition.push_back(from->position);
+        m_fromRotation.push_back(from->rotation);
+        
+        if (from != to) {
+            m_toPosition.push_back(to->position);
+            // Blend along the shorter arc
+            const bool flip = glm::dot(from->rotation, to->rotation) < 0.0f;
+            m_toRotation.push_back(flip ? -to->rotation : to->rotation);
+            m_alpha.push_back(std::clamp(alpha, 0.0f, 1.0f));
+        } else if (alpha > 0.0f && maxExtrapolation > 0.0f) {
+            // Past the newest snapshot: run on along the last velocity, then hold
+            m_toPosition.push_back(from->position + from->velocity * maxExtrapolation);
+            m_toRotation.push_back(from->rotation);
+            m_alpha.push_back(std::min(alpha / maxExtrapolation, 1.0f));
+            ++m_stats.extrapolated;
+        } else {
+            m_toPosition.push_back(from->position);
+            m_toRotation.push_back(from->rotation);
+            m_alpha.push_back(0.0f);
+        }
+    }
+    
+    // Blend: one pass over flat arrays, results written over the `to` arrays
+    const size_t count = m_entities.size();
+    for (size_t i = 0; i < count; ++i) {
+        const f32 alpha = m_alpha[i];
+        m_toPosition[i] = m_fromPosition[i] + (m_toPosition[i] - m_fromPosition[i]) * alpha;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        // Normalized lerp: snapshots are a tick apart, where it matches slerp
+        const f32 alpha = m_alpha[i];
+        m_toRotation[i] = glm::normalize(m_fromRotation[i] * (1.0f - alpha) + m_toRotation[i] * alpha);
+    }
+    
+    // Scatter
+    for (size_t i = 0; i < count; ++i) {
+        auto& transform = view.get<ecs::TransformComponent>(m_entities[i]);
+        transform.position = m_toPosition[i];
+        transform.rotation = m_toRotation[i];
+    }
+    
+    m_stats.entities = static_cast<u32>(count);
+}
+
+} // namespace cscpp::gameplay
@@ -0,0 +1,106 @@
+#pragma once
+
+/**
+ * @file interpolation_system.hpp
+ * @brief Client-side interpolation of remote entities between snapshots
+ *
+ * Remote entities are drawn `delay` seconds behind the newest server state so
+ * there are usually two snapshots to blend between. The delay is derived
+ * from the link each frame: one snapshot interval plus a multiple of the
+ * measured jitter, so a clean connection renders as close to the server as
+ * it can. It rises straight away when jitter grows and decays slowly, so a
+ * single late packet does not make it oscillate. When a snapshot is missing
+ * anyway, entities are extrapolated along their velocity for a short time.
+ *
+ * interpolate() works in three passes over flat arrays: gather the bracketing
+ * snapshots of every entity, blend all of them in one branch-free loop, and
+ * write the results back to the transforms. The arrays keep their capacity
+ * between frames.
+ *
+ * Not wired into the client yet: client_main has no server connection, so
+ * nothing feeds decoded snapshots into the buffers. Once it does, each
+ * received snapshot goes through addSnapshot() and onSnapshot(), and each
+ * frame calls advance() and interpolate() before rendering.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "ecs/components/network.hpp"
+
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace cscpp::gameplay {
+
+/**
+ * @brief Interpolation tuning
+ */
+struct InterpolationConfig {
+    u32 bufferDepth = 8;            ///< Snapshots kept per entity (2..MAX_HISTORY)
+    f32 minDelay = 0.0f;            ///< Seconds, on top of one snapshot interval
+    f32 maxDelay = 0.25f;
+    f32 jitterScale = 2.0f;         ///< Jitter multiples added to the delay
+    f32 delayDecay = 0.05f;         ///< Seconds of delay shed per second when the link improves
+    f32 maxExtrapolation = ecs::InterpolationComponent::DEFAULT_MAX_EXTRAPOLATION;
+};
+
+/**
+ * @brief Counters of the last interpolate()
+ */
+struct InterpolationStats {
+    u32 entities = 0;
+    u32 extrapolated = 0;           ///< Entities past their newest snapshot
+    f32 delay = 0.0f;               ///< Current interpolation delay (seconds)
+};
+
+class InterpolationSystem {
+public:
+    void setConfig(const InterpolationConfig& config);
+    const InterpolationConfig& getConfig() const { return m_config; }
+    
+    /**
+     * @brief Buffer one remote entity's state from a snapshot
+     *
+     * Adds an InterpolationComponent sized to the configured depth if the
+     * entity has none yet.
+     */
+    void addSnapshot(entt::registry& registry, entt::entity entity, Tick tick, f32 serverTime,
+                     Vec3 position, Vec3 velocity, Quat rotation);
+    
+    /// A snapshot arrived: newest server time and the spacing between snapshots
+    void onSnapshot(f32 serverTime, f32 snapshotInterval);
+    
+    /**
+     * @brief Advance the render clock and adapt the delay to the link
+     * @param stats Link statistics of the server connection
+     */
+    void advance(f32 frameTime, const ecs::NetworkStatsComponent& stats);
+    
+    /// Write interpolated transforms of every remote entity
+    void interpolate(entt::registry& registry);
+    
+    f32 getRenderTime() const { return m_renderTime; }
+    f32 getDelay() const { return m_delay; }
+    const InterpolationStats& getStats() const { return m_stats; }
+
+private:
+    InterpolationConfig m_config;
+    InterpolationStats m_stats;
+    
+    f32 m_latestServerTime = 0.0f;
+    f32 m_sinceSnapshot = 0.0f;         ///< Local time since the newest snapshot
+    f32 m_snapshotInterval = 1.0f / 64.0f;
+    f32 m_renderTime = 0.0f;
+    f32 m_delay = 0.0f;
+    bool m_hasClock = false;
+    
+    // Per-frame arrays, one element per remote entity
+    std::vector<entt::entity> m_entities;
+    std::vector<Vec3> m_fromPosition;
+    std::vector<Vec3> m_toPosition;
+    std::vector<Quat> m_fromRotation;
+    std::vector<Quat> m_toRotation;
+    std::vector<f32> m_alpha;
+};
+
+} // namespace cscpp::gameplay
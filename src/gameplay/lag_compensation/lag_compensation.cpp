@@ -0,0 +1,155 @@
+/**
+ * @file lag_compensation.cpp
+ * @brief Hitbox history recording and rewind
+ */
+
+#include "gameplay/lag_compensation/lag_compensation.hpp"
+#include "gameplay/spatial/spatial_grid.hpp"
+#include "core/profiling/profiler.hpp"
+#include "ecs/components/transform.hpp"
+#include "ecs/components/player.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cscpp::gameplay {
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void LagCompensation::recordTick(entt::registry& registry, Tick tick) {
+    CSCPP_PROFILE_FUNCTION();
+    m_latestTick = tick;
+    
+    auto view = registry.view<ecs::TransformComponent, ecs::HitboxComponent>();
+    for (auto entity : view) {
+        const auto& transform = view.get<ecs::TransformComponent>(entity);
+        const auto& hitbox = view.get<ecs::HitboxComponent>(entity);
+        
+        auto* history = registry.try_get<ecs::HitboxHistoryComponent>(entity);
+        if (!history) {
+            history = &registry.emplace<ecs::HitboxHistoryComponent>(entity);
+        }
+        history->record(tick, transform.position, transform.rotation, hitbox);
+    }
+}
+
+// ============================================================================
+// Rewind
+// ============================================================================
+
+u32 LagCompensation::rewind(entt::registry& registry, entt::entity shooter, f64 targetTime,
+                            Vec3 origin, f32 range) {
+    // History is keyed by tick; only the requested view time is converted
+    f64 ticks = targetTime / static_cast<f64>(m_tickInterval);
+    if (!(ticks > 0.0)) {
+        ticks = 0.0;  // Also rejects NaN from a bad client time
+    }
+    const f64 whole = std::floor(std::min(ticks, static_cast<f64>(m_latestTick)));
+    return rewindTo(registry, shooter, static_cast<Tick>(whole), static_cast<f32>(ticks - whole),
+                    origin, range);
+}
+
+u32 LagCompensation::rewindToTick(entt::registry& registry, entt::entity shooter, Tick tick,
+                                  Vec3 origin, f32 range) {
+    return rewindTo(registry, shooter, tick, 0.0f, origin, range);
+}
+
+u32 LagCompensation::rewindTo(entt::registry& registry, entt::entity shooter, Tick tick, f32 fraction,
+                              Vec3 origin, f32 range) {
+    if (m_rewound) {
+        restore(registry);
+    }
+    
+    const Tick maxBack = std::min(static_cast<Tick>(MAX_UNLAG / m_tickInterval), m_latestTick);
+    if (tick >= m_latestTick) {
+        tick = m_latestTick;
+        fraction = 0.0f;
+    } else if (tick < m_latestTick - maxBack) {
+        tick = m_latestTick - maxBack;
+        fraction = 0.0f;
+    }
+    const f32 rangeSq = range * range;
+    
+    m_savedCount = 0;
+    m_rewound = true;
+    
+    ecs::HitboxHistoryComponent::HistoryEntry past;
+    
+    auto view = registry.view<ecs::TransformComponent, ecs::HitboxComponent, ecs::HitboxHistoryComponent>();
+    for (auto entity : view) {
+        if (entity == shooter) {
+            continue;
+        }
+        
+        const auto* health = registry.try_get<ecs::HealthComponent>(entity);
+        if (health && health->isDead()) {
+            continue;
+        }
+        
+        const auto& history = view.get<ecs::HitboxHistoryComponent>(entity);
+        if (!history.sample(tick, fraction, past)) {
+            continue;
+        }
+        
+        if (rangeSq > 0.0f) {
+            Vec3 delta = past.position - origin;
+            if (glm::dot(delta, delta) > rangeSq) {
+                continue;
+            }
+        }
+        
+        auto& transform = view.get<ecs::TransformComponent>(entity);
+        auto& hitbox = view.get<ecs::HitboxComponent>(entity);
+        
+        if (m_savedCount == m_saved.size()) {
+            m_saved.emplace_back();
+        }
+        SavedState& saved = m_saved[m_savedCount++];
+        saved.entity = entity;
+        saved.position = transform.position;
+        saved.rotation = transform.rotation;
+        saved.hitboxCount = static_cast<u32>(std::min(hitbox.hitboxes.size(),
+                                                      ecs::HitboxHistoryComponent::MAX_HITBOXES));
+        std::copy_n(hitbox.hitboxes.begin(), saved.hitboxCount, saved.hitboxes.begin());
+        
+        transform.position = past.position;
+        transform.rotation = past.rotation;
+        if (past.hitboxCount == saved.hitboxCount) {
+            std::copy_n(past.hitboxes.begin(), past.hitboxCount, hitbox.hitboxes.begin());
+        }
+        if (m_grid) {
+            m_grid->update(entity, computeHitboxBounds(transform.position, hitbox));
+        }
+    }
+    
+    return m_savedCount;
+}
+
+void LagCompensation::restore(entt::registry& registry) {
+    for (u32 i = 0; i < m_savedCount; ++i) {
+        const SavedState& saved = m_saved[i];
+        if (!registry.valid(saved.entity)) {
+            continue;
+        }
+        
+        if (auto* transform = registry.try_get<ecs::TransformComponent>(saved.entity)) {
+            transform->position = saved.position;
+            transform->rotation = saved.rotation;
+        }
+        if (auto* hitbox = registry.try_get<ecs::HitboxComponent>(saved.entity)) {
+            const size_t count = std::min<size_t>(saved.hitboxCount, hitbox->hitboxes.size());
+            std::copy_n(saved.hitboxes.begin(), count, hitbox->hitboxes.begin());
+            
+            if (m_grid && registry.all_of<ecs::TransformComponent>(saved.entity)) {
+                m_grid->update(saved.entity, computeHitboxBounds(saved.position, *hitbox));
+            }
+        }
+    }
+    
+    m_savedCount = 0;
+    m_rewound = false;
+}
+
+} // namespace cscpp::gameplay
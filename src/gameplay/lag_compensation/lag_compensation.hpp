@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file lag_compensation.hpp
+ * @brief Server-side rewind of player hitboxes to a shooter's view time
+ *
+ * recordTick() stores every hitbox owner into its HitboxHistoryComponent once
+ * per tick. When a shot is fired, rewind() moves all relevant players back to
+ * the time the shooter saw them, hit tests run against the live components,
+ * and restore() puts everything back. An attached SpatialGrid is updated
+ * with the rewound bounds so broad-phase ray queries see the same positions.
+ * Rewinds reuse internal storage, so a shot does not allocate once the
+ * buffer has grown to the player count.
+ *
+ * Match records every tick, but nothing fires shots yet: the server has no
+ * weapon state or weapon table, so no code runs rewind(), performHitscan()
+ * and restore(). The shot path belongs in the match tick after movement,
+ * for commands with IN_ATTACK set.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "ecs/components/network.hpp"
+#include "ecs/components/physics.hpp"
+
+#include <entt/entt.hpp>
+#include <array>
+#include <vector>
+
+namespace cscpp::gameplay {
+
+class SpatialGrid;
+
+class LagCompensation {
+public:
+    /// Never rewind further back than this (seconds)
+    static constexpr f32 MAX_UNLAG = 1.0f;
+    
+    /// Keep a broad-phase grid in step with rewound positions (optional)
+    void setSpatialGrid(SpatialGrid* grid) { m_grid = grid; }
+    
+    /// Seconds per tick, used to convert view times to ticks
+    void setTickInterval(f32 interval) { m_tickInterval = interval; }
+    
+    /**
+     * @brief Record the current state of every entity with hitboxes
+     *
+     * Adds HitboxHistoryComponent to entities that do not have one yet.
+     */
+    void recordTick(entt::registry& registry, Tick tick);
+    
+    /**
+     * @brief Move relevant players to their state at targetTime
+     * @param shooter Entity firing (never rewound)
+     * @param targetTime Server time the shooter was seeing, in seconds since
+     *                   tick 0 (tick * tick interval)
+     * @param origin Shot origin
+     * @param range Only rewind players whose historical position lies within
+     *              range of origin (0 = everyone)
+     * @return Number of players rewound
+     *
+     * Must be paired with restore() before the next rewind or recordTick().
+     */
+    u32 rewind(entt::registry& registry, entt::entity shooter, f64 targetTime,
+               Vec3 origin, f32 range = 0.0f);
+    
+    /// Same as rewind(), addressed by tick
+    u32 rewindToTick(entt::registry& registry, entt::entity shooter, Tick tick,
+                     Vec3 origin, f32 range = 0.0f);
+    
+    /// Put every rewound player back to its current state
+    void restore(entt::registry& registry);
+    
+    bool isRewound() const { return m_rewound; }
+    Tick getLatestTick() const { return m_latestTick; }
+    f64 getLatestTime() const { return static_cast<f64>(m_latestTick) * m_tickInterval; }
+    f32 getTickInterval() const { return m_tickInterval; }
+    
+private:
+    /// Present state of a rewound player
+    struct SavedState {
+        entt::entity entity = entt::null;
+        Vec3 position{0.0f};
+        Quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+        u32 hitboxCount = 0;
+        std::array<ecs::HitboxComponent::Hitbox, ecs::HitboxHistoryComponent::MAX_HITBOXES> hitboxes{};
+    };
+    
+    /// Rewind to `fraction` of the way from tick to tick + 1
+    u32 rewindTo(entt::registry& registry, entt::entity shooter, Tick tick, f32 fraction,
+                 Vec3 origin, f32 range);
+    
+    SpatialGrid* m_grid = nullptr;
+    
+    std::vector<SavedState> m_saved;
+    u32 m_savedCount = 0;
+    bool m_rewound = false;
+    
+    Tick m_latestTick = 0;
+    f32 m_tickInterval = 1.0f / 128.0f;
+};
+
+} // namespace cscpp::gameplay
@@ -0,0 +1,206 @@
+/**
+ * @file client_prediction.cpp
+ * @brief Client-side movement prediction and reconciliation
+ */
+
+#include "gameplay/prediction/client_prediction.hpp"
+#include "core/logging/logger.hpp"
+#include "network/protocol/message_schemas.hpp"
+
+#include <algorithm>
+
+namespace cscpp::gameplay {
+
+namespace {
+
+/// Flags bits carried by snapshots (EntityState::flags is 16 bits)
+constexpr i32 REPLICATED_FLAGS = 0xFFFF;
+
+/// Round lossy fields to what the server will decode
+void quantizeUserCmd(UserCmd& cmd) {
+    network::codec::Angles16::quantize(cmd.viewAngles);
+    network::codec::MoveAxis::quantize(cmd.forwardMove);
+    network::codec::MoveAxis::quantize(cmd.sideMove);
+}
+
+void readState(const ecs::TransformComponent& transform, const ecs::VelocityComponent& velocity,
+               const ecs::MovementComponent& movement, ecs::PredictionComponent::PredictedState& out) {
+    out.position = transform.position;
+    out.velocity = velocity.linear;
+    out.baseVelocity = movement.baseVelocity;
+    out.flags = movement.flags;
+    out.waterLevel = movement.waterLevel;
+    out.useHull = movement.useHull;
+    out.duckTime = movement.duckTime;
+    out.inDuck = movement.inDuck;
+    out.fallVelocity = movement.fallVelocity;
+}
+
+void writeState(const ecs::PredictionComponent::PredictedState& state, ecs::TransformComponent& transform,
+                ecs::VelocityComponent& velocity, ecs::MovementComponent& movement) {
+    transform.position = state.position;
+    velocity.linear = state.velocity;
+    movement.baseVelocity = state.baseVelocity;
+    movement.viewAngles = state.cmd.viewAngles;
+    movement.flags = state.flags;
+    movement.waterLevel = state.waterLevel;
+    movement.useHull = state.useHull;
+    movement.duckTime = state.duckTime;
+    movement.inDuck = state.inDuck;
+    movement.fallVelocity = state.fallVelocity;
+}
+
+} // anonymous namespace
+
+ClientPrediction::ClientPrediction() {
+    m_template.initHulls();
+}
+
+void ClientPrediction::setTrace(movement::TraceFunc func, void* userData) {
+    m_template.traceFunc = func;
+    m_template.traceUserData = userData;
+}
+
+// ============================================================================
+// Prediction
+// ============================================================================
+
+void ClientPrediction::runCommand(const PredictedState& from, const UserCmd& cmd, u16 oldButtons,
+                                  PredictedState& out) {
+    // Same inputs the server's match lane gets for this command
+    const f32 maxSpeed = m_move.maxSpeed;
+    m_move = m_template;
+    m_move.maxSpeed = maxSpeed;
+    
+    m_move.origin = from.position;
+    m_move.velocity = from.velocity;
+    m_move.baseVelocity = from.baseVelocity;
+    movement::PM_SetupCmd(&m_move, cmd, oldButtons);
+    m_move.flags = from.flags;
+    m_move.waterLevel = from.waterLevel;
+    m_move.useHull = from.useHull;
+    m_move.duckTime = from.duckTime;
+    m_move.inDuck = from.inDuck;
+    m_move.fallVelocity = from.fallVelocity;
+    m_move.dead = false;
+    
+    movement::PM_PlayerMove(&m_move);
+    
+    out.cmd = cmd;
+    out.position = m_move.origin;
+    out.velocity = m_move.velocity;
+    out.baseVelocity = m_move.baseVelocity;
+    out.flags = m_move.flags;
+    out.waterLevel = m_move.waterLevel;
+    out.useHull = m_move.useHull;
+    out.duckTime = m_move.duckTime;
+    out.inDuck = m_move.inDuck;
+    out.fallVelocity = m_move.fallVelocity;
+}
+
+void ClientPrediction::predict(entt::registry& registry, entt::entity player, const UserCmd& localCmd) {
+    auto [transform, velocity, movement, prediction] = registry.get<
+        ecs::TransformComponent,
+        ecs::VelocityComponent,
+        ecs::MovementComponent,
+        ecs::PredictionComponent
+    >(player);
+    
+    // Predict with the command as the server will see it, so a replay from
+    // the ring and the server's own move start from identical inputs
+    UserCmd cmd = localCmd;
+    quantizeUserCmd(cmd);
+    
+    PredictedState current;
+    readState(transform, velocity, movement, current);
+    
+    const PredictedState* previous = prediction.get(cmd.tick - 1);
+    const u16 oldButtons = previous ? previous->cmd.buttons : 0;
+    
+    m_move.maxSpeed = movement.maxSpeed;
+    PredictedState next;
+    runCommand(current, cmd, oldButtons, next);
+    prediction.store(cmd.tick, next);
+    
+    writeState(next, transform, velocity, movement);
+    ++m_stats.predictedTicks;
+}
+
+// ============================================================================
+// Reconciliation
+// ============================================================================
+
+bool ClientPrediction::matches(const PredictedState& predicted, const network::EntityState& authoritative) const {
+    if ((predicted.flags & REPLICATED_FLAGS) != authoritative.flags) {
+        return false;
+    }
+    
+    const Vec3 positionError = predicted.position - authoritative.position;
+    const Vec3 velocityError = predicted.velocity - authoritative.velocity;
+    return glm::dot(positionError, positionError) <= m_config.positionTolerance * m_config.positionTolerance &&
+           glm::dot(velocityError, velocityError) <= m_config.velocityTolerance * m_config.velocityTolerance;
+}
+
+ReconcileResult ClientPrediction::reconcile(entt::registry& registry, entt::entity player,
+                                            Tick ackTick, const network::EntityState& authoritative) {
+    ReconcileResult result;
+    
+    auto* prediction = registry.try_get<ecs::PredictionComponent>(player);
+    if (!prediction || ackTick <= prediction->lastReconciledTick) {
+        return result;  // Same ack as an earlier snapshot: already checked
+    }
+    
+    PredictedState* base = prediction->get(ackTick);
+    if (!base) {
+        return result;  // Not predicted locally, or older than the ring
+    }
+    
+    prediction->lastReconciledTick = ackTick;
+    prediction->clearBefore(ackTick);
+    result.checked = true;
+    ++m_stats.reconciles;
+    
+    // Common case: the server agrees and there is nothing to do
+    if (matches(*base, authoritative)) {
+        return result;
+    }
+    
+    result.mispredicted = true;
+    ++m_stats.mispredictions;
+    
+    LOG_DEBUG("Misprediction at tick {}: position error {:.3f}, velocity error {:.3f}",
+              ackTick, glm::length(base->position - authoritative.position),
+              glm::length(base->velocity - authoritative.velocity));
+    
+    // Adopt the server state; fields snapshots don't carry stay as predicted
+    base->position = authoritative.position;
+    base->velocity = authoritative.velocity;
+    base->flags = (base->flags & ~REPLICATED_FLAGS) | authoritative.flags;
+    
+    // Replay only the commands the server has not processed yet
+    auto [transform, velocity, movement] = registry.get<
+        ecs::TransformComponent,
+        ecs::VelocityComponent,
+        ecs::MovementComponent
+    >(player);
+    m_move.maxSpeed = movement.maxSpeed;
+    
+    const PredictedState* previous = base;
+    for (Tick tick = ackTick + 1; tick <= prediction->newestTick; ++tick) {
+        PredictedState* state = prediction->get(tick);
+        if (!state) {
+            break;
+        }
+        runCommand(*previous, state->cmd, previous->cmd.buttons, *state);
+        previous = state;
+        ++result.replayedTicks;
+    }
+    
+    writeState(*previous, transform, velocity, movement);
+    
+    m_stats.replayedTicks += result.replayedTicks;
+    m_stats.maxReplay = std::max(m_stats.maxReplay, result.replayedTicks);
+    return result;
+}
+
+} // namespace cscpp::gameplay
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file client_prediction.hpp
+ * @brief Client-side movement prediction and server reconciliation
+ *
+ * predict() runs the shared PM_PlayerMove on each local UserCmd as soon as
+ * it is created and stores the resulting state in the player's
+ * PredictionComponent. When a snapshot arrives, reconcile() compares the
+ * server's state after the last command it processed against the stored
+ * prediction for that tick. A match ends there, without touching the
+ * history. On a mismatch the server state is adopted at that tick and only
+ * the commands after it are replayed.
+ *
+ * Replays reuse one PlayerMove and write the ring in place, so even a
+ * 40-tick replay (300 ms at 128 tick) is a tight loop with no allocation.
+ */
+
+#include "core/types.hpp"
+#include "core/platform/input.hpp"
+#include "ecs/ecs.hpp"
+#include "movement/pm_shared/pm_shared.hpp"
+#include "network/protocol/messages.hpp"
+
+#include <entt/entt.hpp>
+
+namespace cscpp::gameplay {
+
+/**
+ * @brief Misprediction thresholds
+ *
+ * Snapshots quantize position to 1/64 unit and velocity to 1/16 unit/s,
+ * so anything below these is rounding, not divergence.
+ */
+struct PredictionConfig {
+    f32 positionTolerance = 0.1f;
+    f32 velocityTolerance = 1.0f;
+};
+
+/**
+ * @brief Counters since the last resetStats()
+ */
+struct PredictionStats {
+    u32 predictedTicks = 0;
+    u32 reconciles = 0;             ///< Snapshots compared against a prediction
+    u32 mispredictions = 0;
+    u32 replayedTicks = 0;
+    u32 maxReplay = 0;              ///< Longest single replay
+};
+
+/**
+ * @brief Outcome of one reconcile()
+ */
+struct ReconcileResult {
+    bool checked = false;           ///< A stored prediction existed for the ack tick
+    bool mispredicted = false;
+    u32 replayedTicks = 0;
+};
+
+class ClientPrediction {
+public:
+    ClientPrediction();
+    
+    // ========================================================================
+    // Setup (must match the server's match setup)
+    // ========================================================================
+    
+    void setMoveVars(const movement::MoveVars* moveVars) { m_template.moveVars = moveVars; }
+    void setTrace(movement::TraceFunc func, void* userData);
+    void setFrameTime(f32 frameTime) { m_template.frameTime = frameTime; }
+    void setConfig(const PredictionConfig& config) { m_config = config; }
+    
+    // ========================================================================
+    // Prediction
+    // ========================================================================
+    
+    /**
+     * @brief Run one local command on the predicted player and store the result
+     *
+     * The entity needs Transform, Velocity, Movement and Prediction
+     * components. Commands must be predicted in tick order. The command is
+     * first rounded through the UserCmd wire codecs, so the stored prediction
+     * is what the server simulates.
+     */
+    void predict(entt::registry& registry, entt::entity player, const UserCmd& cmd);
+    
+    /**
+     * @brief Check a snapshot's state of the local player against the prediction
+     * @param ackTick Last command tick the server processed (snapshot clientTickAck)
+     * @param authoritative The local player's entity state from that snapshot
+     *
+     * On a mismatch the server state replaces the prediction at ackTick and
+     * the commands after it are replayed; the entity ends up at the
+     * corrected newest prediction.
+     */
+    ReconcileResult reconcile(entt::registry& registry, entt::entity player,
+                              Tick ackTick, const network::EntityState& authoritative);
+    
+    const PredictionStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+private:
+    using PredictedState = ecs::PredictionComponent::PredictedState;
+    
+    /// Run cmd from `from`, writing the new state to `out`
+    void runCommand(const PredictedState& from, const UserCmd& cmd, u16 oldButtons, PredictedState& out);
+    
+    bool matches(const PredictedState& predicted, const network::EntityState& authoritative) const;
+    
+    movement::PlayerMove m_template;    ///< Hulls, move vars and trace, copied per command
+    movement::PlayerMove m_move;
+    PredictionConfig m_config;
+    PredictionStats m_stats;
+};
+
+} // namespace cscpp::gameplay
@@ -0,0 +1,366 @@
+/**
+ * @file spatial_grid.cpp
+ * @brief Hashed uniform grid broad-phase
+ */
+
+#include "gameplay/spatial/spatial_grid.hpp"
+#include "core/profiling/profiler.hpp"
+#include "ecs/components/transform.hpp"
+#include "ecs/components/physics.hpp"
+#include "ecs/components/render.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cscpp::gameplay {
+
+namespace {
+
+/// Cell coordinates are packed into 21 bits per axis
+constexpr i32 CELL_COORD_LIMIT = (1 << 20) - 1;
+
+/// Upper bound on cells walked by one ray
+constexpr u32 MAX_RAY_CELLS = 4096;
+
+bool isEmpty(const AABB& box) {
+    return box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z;
+}
+
+bool overlaps(const AABB& a, const AABB& b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+f32 distanceSqToBox(Vec3 point, const AABB& box) {
+    Vec3 closest = glm::clamp(point, box.min, box.max);
+    Vec3 delta = point - closest;
+    return glm::dot(delta, delta);
+}
+
+} // anonymous namespace
+
+AABB computeHitboxBounds(Vec3 position, const ecs::HitboxComponent& hitbox) {
+    AABB bounds;
+    for (const auto& box : hitbox.hitboxes) {
+        bounds.expand(position + box.mins);
+        bounds.expand(position + box.maxs);
+    }
+    return bounds;
+}
+
+// ============================================================================
+// Construction / Updates
+// ============================================================================
+
+SpatialGrid::SpatialGrid(f32 cellSize)
+    : m_cellSize(cellSize > 0.0f ? cellSize : DEFAULT_CELL_SIZE)
+    , m_invCellSize(1.0f / m_cellSize) {
+}
+
+i32 SpatialGrid::toCell(f32 coordinate) const {
+    f32 cell = std::floor(coordinate * m_invCellSize);
+    cell = std::clamp(cell, static_cast<f32>(-CELL_COORD_LIMIT), static_cast<f32>(CELL_COORD_LIMIT));
+    return static_cast<i32>(cell);
+}
+
+SpatialGrid::CellRange SpatialGrid::computeRange(const AABB& bounds) const {
+    CellRange range;
+    for (i32 axis = 0; axis < 3; ++axis) {
+        range.min[axis] = toCell(bounds.min[axis]);
+        range.max[axis] = toCell(bounds.max[axis]);
+    }
+    return range;
+}
+
+u64 SpatialGrid::cellKey(i32 x, i32 y, i32 z) {
+    constexpr u64 MASK = (1u << 21) - 1;
+    return ((static_cast<u64>(x) & MASK) << 42) |
+           ((static_cast<u64>(y) & MASK) << 21) |
+           (static_cast<u64>(z) & MASK);
+}
+
+void SpatialGrid::link(u32 index) {
+    Proxy& proxy = m_proxies[index];
+    proxy.oversized = proxy.cells.cellCount() > MAX_CELLS_PER_ENTITY;
+    if (proxy.oversized) {
+        m_oversized.push_back(index);
+        return;
+    }
+    
+    const CellRange& r = proxy.cells;
+    for (i32 x = r.min[0]; x <= r.max[0]; ++x) {
+        for (i32 y = r.min[1]; y <= r.max[1]; ++y) {
+            for (i32 z = r.min[2]; z <= r.max[2]; ++z) {
+                m_cells[cellKey(x, y, z)].push_back(index);
+            }
+        }
+    }
+}
+
+void SpatialGrid::unlink(u32 index) {
+    Proxy& proxy = m_proxies[index];
+    auto eraseFrom = [index](std::vector<u32>& list) {
+        auto it = std::find(list.begin(), list.end(), index);
+        if (it != list.end()) {
+            *it = list.back();
+            list.pop_back();
+        }
+    };
+    
+    if (proxy.oversized) {
+        eraseFrom(m_oversized);
+        return;
+    }
+    
+    const CellRange& r = proxy.cells;
+    for (i32 x = r.min[0]; x <= r.max[0]; ++x) {
+        for (i32 y = r.min[1]; y <= r.max[1]; ++y) {
+            for (i32 z = r.min[2]; z <= r.max[2]; ++z) {
+                auto it = m_cells.find(cellKey(x, y, z));
+                if (it == m_cells.end()) {
+                    continue;
+                }
+                eraseFrom(it->second);
+                if (it->second.empty()) {
+                    m_cells.erase(it);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::update(entt::entity entity, const AABB& bounds) {
+    if (isEmpty(bounds)) {
+        remove(entity);
+        return;
+    }
+    
+    const CellRange range = computeRange(bounds);
+    
+    auto found = m_lookup.find(entity);
+    if (found != m_lookup.end()) {
+        Proxy& proxy = m_proxies[found->second];
+        proxy.bounds = bounds;
+        proxy.syncStamp = m_syncStamp;
+        if (proxy.cells == range) {
+            return;     // Still in the same cells
+        }
+        unlink(found->second);
+        proxy.cells = range;
+        link(found->second);
+        return;
+    }
+    
+    u32 index;
+    if (!m_freeProxies.empty()) {
+        index = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    } else {
+        index = static_cast<u32>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+    
+    Proxy& proxy = m_proxies[index];
+    proxy.entity = entity;
+    proxy.bounds = bounds;
+    proxy.cells = range;
+    proxy.queryStamp = m_queryStamp;
+    proxy.syncStamp = m_syncStamp;
+    m_lookup.emplace(entity, index);
+    link(index);
+}
+
+void SpatialGrid::remove(entt::entity entity) {
+    auto found = m_lookup.find(entity);
+    if (found == m_lookup.end()) {
+        return;
+    }
+    
+    const u32 index = found->second;
+    unlink(index);
+    m_proxies[index].entity = entt::null;
+    m_freeProxies.push_back(index);
+    m_lookup.erase(found);
+}
+
+void SpatialGrid::clear() {
+    m_proxies.clear();
+    m_freeProxies.clear();
+    m_lookup.clear();
+    m_cells.clear();
+    m_oversized.clear();
+}
+
+void SpatialGrid::sync(entt::registry& registry) {
+    CSCPP_PROFILE_FUNCTION();
+    ++m_syncStamp;
+    
+    auto hitboxView = registry.view<ecs::TransformComponent, ecs::HitboxComponent>();
+    for (auto entity : hitboxView) {
+        const auto& transform = hitboxView.get<ecs::TransformComponent>(entity);
+        const auto& hitbox = hitboxView.get<ecs::HitboxComponent>(entity);
+        update(entity, computeHitboxBounds(transform.position, hitbox));
+    }
+    
+    auto boundsView = registry.view<ecs::BoundsComponent>();
+    for (auto entity : boundsView) {
+        if (registry.all_of<ecs::HitboxComponent>(entity) && registry.all_of<ecs::TransformComponent>(entity)) {
+            continue;
+        }
+        auto& bounds = boundsView.get<ecs::BoundsComponent>(entity);
+        if (const auto* transform = registry.try_get<ecs::TransformComponent>(entity)) {
+            bounds.worldBounds = bounds.localBounds.transformed(transform->getMatrix());
+        }
+        update(entity, bounds.worldBounds);
+    }
+    
+    // Drop entities that were not refreshed this pass
+    for (u32 index = 0; index < static_cast<u32>(m_proxies.size()); ++index) {
+        const Proxy& proxy = m_proxies[index];
+        if (proxy.entity != entt::null && proxy.syncStamp != m_syncStamp) {
+            remove(proxy.entity);
+        }
+    }
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+void SpatialGrid::beginQuery() {
+    if (++m_queryStamp == 0) {
+        // Stamp wrapped: reset so stale stamps cannot match
+        for (auto& proxy : m_proxies) {
+            proxy.queryStamp = 0;
+        }
+        m_queryStamp = 1;
+    }
+}
+
+void SpatialGrid::queryBox(const AABB& box, std::vector<entt::entity>& out) {
+    if (isEmpty(box)) {
+        return;
+    }
+    beginQuery();
+    
+    auto test = [&](u32 index) {
+        Proxy& proxy = m_proxies[index];
+        if (visit(proxy) && overlaps(proxy.bounds, box)) {
+            out.push_back(proxy.entity);
+        }
+    };
+    
+    for (u32 index : m_oversized) {
+        test(index);
+    }
+    
+    const CellRange r = computeRange(box);
+    if (r.cellCount() > m_cells.size()) {
+        // Box covers more cells than exist: walk the occupied cells instead
+        for (const auto& [key, cell] : m_cells) {
+            for (u32 index : cell) {
+                test(index);
+            }
+        }
+        return;
+    }
+    
+    for (i32 x = r.min[0]; x <= r.max[0]; ++x) {
+        for (i32 y = r.min[1]; y <= r.max[1]; ++y) {
+            for (i32 z = r.min[2]; z <= r.max[2]; ++z) {
+                auto it = m_cells.find(cellKey(x, y, z));
+                if (it == m_cells.end()) {
+                    continue;
+                }
+                for (u32 index : it->second) {
+                    test(index);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::querySphere(Vec3 center, f32 radius, std::vector<entt::entity>& out) {
+    AABB box;
+    box.min = center - Vec3(radius);
+    box.max = center + Vec3(radius);
+    
+    const size_t first = out.size();
+    queryBox(box, out);
+    
+    // Reject box corners outside the sphere
+    const f32 radiusSq = radius * radius;
+    auto end = std::remove_if(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+                              [&](entt::entity entity) {
+        return distanceSqToBox(center, m_proxies[m_lookup.at(entity)].bounds) > radiusSq;
+    });
+    out.erase(end, out.end());
+}
+
+void SpatialGrid::queryRay(Vec3 origin, Vec3 direction, f32 maxDistance, std::vector<RayHit>& out) {
+    if (maxDistance <= 0.0f) {
+        return;
+    }
+    beginQuery();
+    
+    const Vec3 invDir = rayInverseDirection(direction);
+    const size_t first = out.size();
+    
+    auto test = [&](u32 index) {
+        Proxy& proxy = m_proxies[index];
+        f32 distance;
+        if (visit(proxy) && intersectRayAABB(origin, invDir, proxy.bounds.min, proxy.bounds.max,
+                                             maxDistance, distance)) {
+            out.push_back({proxy.entity, distance});
+        }
+    };
+    
+    for (u32 index : m_oversized) {
+        test(index);
+    }
+    
+    // 3D DDA through the cells the ray crosses
+    i32 cell[3];
+    i32 step[3];
+    f32 tNext[3];
+    f32 tDelta[3];
+    for (i32 axis = 0; axis < 3; ++axis) {
+        cell[axis] = toCell(origin[axis]);
+        if (direction[axis] > 0.0f) {
+            step[axis] = 1;
+            tNext[axis] = (static_cast<f32>(cell[axis] + 1) * m_cellSize - origin[axis]) * invDir[axis];
+            tDelta[axis] = m_cellSize * invDir[axis];
+        } else if (direction[axis] < 0.0f) {
+            step[axis] = -1;
+            tNext[axis] = (static_cast<f32>(cell[axis]) * m_cellSize - origin[axis]) * invDir[axis];
+            tDelta[axis] = -m_cellSize * invDir[axis];
+        } else {
+            step[axis] = 0;
+            tNext[axis] = std::numeric_limits<f32>::infinity();
+            tDelta[axis] = std::numeric_limits<f32>::infinity();
+        }
+    }
+    
+    for (u32 visited = 0; visited < MAX_RAY_CELLS; ++visited) {
+        auto it = m_cells.find(cellKey(cell[0], cell[1], cell[2]));
+        if (it != m_cells.end()) {
+            for (u32 index : it->second) {
+                test(index);
+            }
+        }
+        
+        i32 axis = tNext[0] < tNext[1] ? 0 : 1;
+        axis = tNext[2] < tNext[axis] ? 2 : axis;
+        if (tNext[axis] > maxDistance) {
+            break;
+        }
+        cell[axis] += step[axis];
+        tNext[axis] += tDelta[axis];
+    }
+    
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+              [](const RayHit& a, const RayHit& b) { return a.distance < b.distance; });
+}
+
+} // namespace cscpp::gameplay
@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @file spatial_grid.hpp
+ * @brief Hashed uniform grid broad-phase for entity queries
+ *
+ * Each entity is stored as one AABB in every grid cell it overlaps. Cells
+ * live in a hash map, so the grid covers the whole world without a fixed
+ * extent. update() only touches the hash map when an entity crosses a cell
+ * boundary; a player moving inside its cells just overwrites its bounds.
+ * Boxes spanning too many cells (large triggers) go to an oversized list
+ * that every query checks.
+ *
+ * Queries return candidates whose AABB overlaps the query shape; callers do
+ * the exact test (hitboxes, line of sight). Queries use a visit stamp for
+ * de-duplication, so a grid must not be queried from several threads at once.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+
+#include <entt/entt.hpp>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cscpp::ecs { struct HitboxComponent; }
+
+namespace cscpp::gameplay {
+
+/**
+ * @brief Slab test of a ray against an AABB
+ * @param invDir 1 / direction per axis (infinite for zero components)
+ * @param tEnter Distance along the ray where it enters the box (0 if inside)
+ */
+inline bool intersectRayAABB(Vec3 origin, Vec3 invDir, Vec3 mins, Vec3 maxs,
+                             f32 maxDistance, f32& tEnter) {
+    f32 tMin = 0.0f;
+    f32 tMax = maxDistance;
+    for (i32 axis = 0; axis < 3; ++axis) {
+        f32 t0 = (mins[axis] - origin[axis]) * invDir[axis];
+        f32 t1 = (maxs[axis] - origin[axis]) * invDir[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        // NaN (origin on a slab plane with a zero direction) keeps the old bounds
+        tMin = t0 > tMin ? t0 : tMin;
+        tMax = t1 < tMax ? t1 : tMax;
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    tEnter = tMin;
+    return true;
+}
+
+/// Component-wise reciprocal of a ray direction
+inline Vec3 rayInverseDirection(Vec3 direction) {
+    constexpr f32 INF = std::numeric_limits<f32>::infinity();
+    return Vec3(direction.x != 0.0f ? 1.0f / direction.x : INF,
+                direction.y != 0.0f ? 1.0f / direction.y : INF,
+                direction.z != 0.0f ? 1.0f / direction.z : INF);
+}
+
+/**
+ * @brief World-space AABB enclosing all hitboxes of an entity
+ */
+AABB computeHitboxBounds(Vec3 position, const ecs::HitboxComponent& hitbox);
+
+class SpatialGrid {
+public:
+    static constexpr f32 DEFAULT_CELL_SIZE = 128.0f;
+    
+    /// Boxes covering more cells than this go to the oversized list
+    static constexpr u32 MAX_CELLS_PER_ENTITY = 64;
+    
+    /// Ray candidate with the distance at which the ray enters its bounds
+    struct RayHit {
+        entt::entity entity = entt::null;
+        f32 distance = 0.0f;
+    };
+    
+    explicit SpatialGrid(f32 cellSize = DEFAULT_CELL_SIZE);
+    
+    /// Insert an entity or move it to new bounds
+    void update(entt::entity entity, const AABB& bounds);
+    
+    void remove(entt::entity entity);
+    
+    void clear();
+    
+    bool contains(entt::entity entity) const { return m_lookup.contains(entity); }
+    size_t size() const { return m_lookup.size(); }
+    f32 getCellSize() const { return m_cellSize; }
+    
+    /**
+     * @brief Refresh from the registry
+     *
+     * Entities with TransformComponent + HitboxComponent use the union of
+     * their hitboxes. Other entities with BoundsComponent use worldBounds,
+     * which is recomputed from localBounds when they have a transform.
+     * Entities that lost their components or were destroyed are removed.
+     */
+    void sync(entt::registry& registry);
+    
+    // ========================================================================
+    // Queries (results are appended to out)
+    // ========================================================================
+    
+    /// Entities whose bounds overlap a box (trigger volumes)
+    void queryBox(const AABB& box, std::vector<entt::entity>& out);
+    
+    /// Entities whose bounds come within radius of center (radius damage)
+    void querySphere(Vec3 center, f32 radius, std::vector<entt::entity>& out);
+    
+    /**
+     * @brief Entities whose bounds a ray passes through, nearest first
+     * @param direction Normalized ray direction
+     */
+    void queryRay(Vec3 origin, Vec3 direction, f32 maxDistance, std::vector<RayHit>& out);
+    
+private:
+    struct CellRange {
+        i32 min[3] = {0, 0, 0};
+        i32 max[3] = {-1, -1, -1};
+        
+        bool operator==(const CellRange&) const = default;
+        u64 cellCount() const {
+            return static_cast<u64>(max[0] - min[0] + 1) *
+                   static_cast<u64>(max[1] - min[1] + 1) *
+                   static_cast<u64>(max[2] - min[2] + 1);
+        }
+    };
+    
+    struct Proxy {
+        entt::entity entity = entt::null;
+        AABB bounds;
+        CellRange cells;
+        bool oversized = false;
+        u32 queryStamp = 0;
+        u32 syncStamp = 0;
+    };
+    
+    i32 toCell(f32 coordinate) const;
+    CellRange computeRange(const AABB& bounds) const;
+    static u64 cellKey(i32 x, i32 y, i32 z);
+    
+    void link(u32 proxy);
+    void unlink(u32 proxy);
+    
+    /// Mark a proxy visited by the current query; false if already seen
+    bool visit(Proxy& proxy) {
+        if (proxy.queryStamp == m_queryStamp) {
+            return false;
+        }
+        proxy.queryStamp = m_queryStamp;
+        return true;
+    }
+    void beginQuery();
+    
+    f32 m_cellSize;
+    f32 m_invCellSize;
+    
+    std::vector<Proxy> m_proxies;
+    std::vector<u32> m_freeProxies;
+    std::unordered_map<entt::entity, u32> m_lookup;
+    std::unordered_map<u64, std::vector<u32>> m_cells;
+    std::vector<u32> m_oversized;
+    
+    u32 m_queryStamp = 0;
+    u32 m_syncStamp = 0;
+};
+
+} // namespace cscpp::gameplay
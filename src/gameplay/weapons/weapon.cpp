@@ -0,0 +1,132 @@
+/**
+ * @file weapon.cpp
+ * @brief Weapon fire resolution
+ */
+
+#include "gameplay/weapons/weapon.hpp"
+#include "gameplay/spatial/spatial_grid.hpp"
+#include "ecs/components/transform.hpp"
+#include "ecs/components/physics.hpp"
+#include "ecs/components/player.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace cscpp::gameplay {
+
+namespace {
+
+/// Nearest hitbox of one entity hit by the ray closer than bestDistance
+bool traceHitboxes(Vec3 origin, Vec3 invDir, f32& bestDistance, entt::entity entity,
+                   const ecs::TransformComponent& transform, const ecs::HitboxComponent& hitbox,
+                   HitscanResult& result) {
+    bool found = false;
+    for (const auto& box : hitbox.hitboxes) {
+        const Vec3 mins = transform.position + box.mins;
+        const Vec3 maxs = transform.position + box.maxs;
+        
+        f32 distance;
+        if (!intersectRayAABB(origin, invDir, mins, maxs, bestDistance, distance)) {
+            continue;
+        }
+        if (found && distance >= bestDistance) {
+            continue;
+        }
+        
+        found = true;
+        bestDistance = distance;
+        result.hit = true;
+        result.hitEntity = entity;
+        result.hitGroup = box.group;
+        result.damage = box.damageMultiplier;
+        
+        // Entry face: the slab whose entry distance matches
+        result.hitNormal = Vec3(0.0f);
+        for (i32 axis = 0; axis < 3; ++axis) {
+            const f32 plane = invDir[axis] >= 0.0f ? mins[axis] : maxs[axis];
+            if (std::abs((plane - origin[axis]) * invDir[axis] - distance) <= 1e-4f) {
+                result.hitNormal[axis] = invDir[axis] >= 0.0f ? -1.0f : 1.0f;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+bool isTargetable(entt::registry& registry, entt::entity entity, entt::entity shooter) {
+    if (entity == shooter) {
+        return false;
+    }
+    const auto* health = registry.try_get<ecs::HealthComponent>(entity);
+    return !health || !health->isDead();
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Hitscan
+// ============================================================================
+
+HitscanResult performHitscan(Vec3 origin, Vec3 direction, f32 range, entt::entity shooter,
+                             entt::registry& registry, SpatialGrid* broadPhase) {
+    HitscanResult result{};
+    result.hit = false;
+    result.hitEntity = entt::null;
+    result.hitGroup = static_cast<i32>(HitGroup::Generic);
+    
+    const Vec3 invDir = rayInverseDirection(direction);
+    f32 bestDistance = range;
+    
+    if (broadPhase) {
+        // Candidates are sorted by where the ray enters their bounds, so the
+        // first candidate past the best hit ends the search
+        thread_local std::vector<SpatialGrid::RayHit> candidates;
+        candidates.clear();
+        broadPhase->queryRay(origin, direction, range, candidates);
+        
+        for (const auto& candidate : candidates) {
+            if (result.hit && candidate.distance >= bestDistance) {
+                break;
+            }
+            if (!isTargetable(registry, candidate.entity, shooter)) {
+                continue;
+            }
+            const auto* transform = registry.try_get<ecs::TransformComponent>(candidate.entity);
+            const auto* hitbox = registry.try_get<ecs::HitboxComponent>(candidate.entity);
+            if (transform && hitbox) {
+                traceHitboxes(origin, invDir, bestDistance, candidate.entity, *transform, *hitbox, result);
+            }
+        }
+    } else {
+        auto view = registry.view<ecs::TransformComponent, ecs::HitboxComponent>();
+        for (auto entity : view) {
+            if (!isTargetable(registry, entity, shooter)) {
+                continue;
+            }
+            traceHitboxes(origin, invDir, bestDistance, entity,
+                          view.get<ecs::TransformComponent>(entity),
+                          view.get<ecs::HitboxComponent>(entity), result);
+        }
+    }
+    
+    if (result.hit) {
+        result.hitPosition = origin + direction * bestDistance;
+    }
+    return result;
+}
+
+// ============================================================================
+// Hit Groups
+// ============================================================================
+
+f32 getHitGroupDamageMultiplier(HitGroup group) {
+    switch (group) {
+        case HitGroup::Head:     return 4.0f;
+        case HitGroup::Stomach:  return 1.25f;
+        case HitGroup::LeftLeg:
+        case HitGroup::RightLeg: return 0.75f;
+        default:                 return 1.0f;
+    }
+}
+
+} // namespace cscpp::gameplay
@@ -8,8 +8,12 @@
 #include "core/types.hpp"
 #include "core/math/math.hpp"
 
+#include <entt/entt.hpp>
+
 namespace cscpp::gameplay {
 
+class SpatialGrid;
+
 // ============================================================================
 // Weapon IDs
 // ============================================================================
@@ -177,18 +181,26 @@ struct HitscanResult {
     Vec3 hitNormal;
     entt::entity hitEntity;
     i32 hitGroup;  // Head, chest, etc.
-    f32 damage;
+    f32 damage;    // Damage multiplier of the hitbox; scale by weapon damage
 };
 
 /**
  * @brief Perform hitscan for weapon fire
+ *
+ * Tests the ray against the HitboxComponent of every living entity except
+ * the shooter. With a broad-phase grid only the entities whose bounds the
+ * ray crosses are tested, nearest first. World geometry is not traced;
+ * clip range against the map first. For lag compensation, rewind before
+ * the call and restore after it. Not called by the server yet (see
+ * lag_compensation.hpp).
  */
 HitscanResult performHitscan(
     Vec3 origin,
     Vec3 direction,
     f32 range,
     entt::entity shooter,
-    entt::registry& registry
+    entt::registry& registry,
+    SpatialGrid* broadPhase = nullptr
 );
 
 // ============================================================================
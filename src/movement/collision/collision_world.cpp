@@ -0,0 +1,456 @@
+/**
+ * @file collision_world.cpp
+ * @brief BSP hull collision implementation
+ */
+
+#include "movement/collision/collision_world.hpp"
+#include "movement/pm_shared/pm_shared.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "assets/cooked/cooked_map_writer.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+
+namespace cscpp::movement {
+
+namespace {
+
+namespace bsp = assets::bsp;
+namespace cooked = assets::cooked;
+
+/// Hull extents used by the map compiler (hlcsg) for hulls 1-3
+constexpr Vec3 BSP_HULL_MINS[CollisionWorld::MAX_HULLS] = {
+    { 0.0f,   0.0f,   0.0f},
+    {-16.0f, -16.0f, -36.0f},
+    {-32.0f, -32.0f, -32.0f},
+    {-16.0f, -16.0f, -18.0f},
+};
+
+constexpr Vec3 BSP_HULL_MAXS[CollisionWorld::MAX_HULLS] = {
+    { 0.0f,  0.0f,  0.0f},
+    {16.0f, 16.0f, 36.0f},
+    {32.0f, 32.0f, 32.0f},
+    {16.0f, 16.0f, 18.0f},
+};
+
+/// Point-side distance with the axial fast path
+inline f32 planeDiff(const CollisionPlane& plane, Vec3 p) {
+    if (plane.type < 3) {
+        return p[plane.type] - plane.dist;
+    }
+    return glm::dot(plane.normal, p) - plane.dist;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+Result<void> CollisionWorld::loadFromFile(const std::string& path) {
+    bsp::BSPView view;
+    if (auto opened = view.open(path); !opened) {
+        clear();
+        return opened;
+    }
+    return load(view);
+}
+
+Result<void> CollisionWorld::load(const bsp::BSPView& view) {
+    CSCPP_PROFILE_FUNCTION();
+    clear();
+
+    const std::string& path = view.getPath();
+    const auto planes = view.getLump<bsp::BSPPlane>(bsp::LUMP_PLANES);
+    const auto nodes = view.getLump<bsp::BSPNode>(bsp::LUMP_NODES);
+    const auto clipNodes = view.getLump<bsp::BSPClipNode>(bsp::LUMP_CLIPNODES);
+    const auto leaves = view.getLump<bsp::BSPLeaf>(bsp::LUMP_LEAVES);
+    const auto models = view.getLump<bsp::BSPModel>(bsp::LUMP_MODELS);
+
+    if (models.empty() || planes.empty()) {
+        return std::unexpected(Error{"BSP has no models or planes: " + path});
+    }
+
+    // Planes
+    m_planes.reserve(planes.size());
+    for (const auto& p : planes) {
+        CollisionPlane plane;
+        plane.normal = Vec3(p.normal[0], p.normal[1], p.normal[2]);
+        plane.dist = p.distance;
+        plane.type = p.type;
+        m_planes.push_back(plane);
+    }
+
+    const i32 planeCount = static_cast<i32>(m_planes.size());
+
+    // Clipnodes (hulls 1-3) map directly
+    const i32 clipNodeCount = static_cast<i32>(clipNodes.size());
+    m_clipNodes.reserve(clipNodes.size());
+    for (const auto& c : clipNodes) {
+        if (c.planeIndex < 0 || c.planeIndex >= planeCount ||
+            c.children[0] >= clipNodeCount || c.children[1] >= clipNodeCount) {
+            clear();
+            return std::unexpected(Error{"Corrupt clipnode data: " + path});
+        }
+        CollisionNode node;
+        node.planeIndex = c.planeIndex;
+        node.children[0] = c.children[0];
+        node.children[1] = c.children[1];
+        m_clipNodes.push_back(node);
+    }
+
+    // Hull 0 is built from the render nodes, leaf references become leaf contents
+    const i32 nodeCount = static_cast<i32>(nodes.size());
+    const i32 leafCount = static_cast<i32>(leaves.size());
+    m_hull0Nodes.reserve(nodes.size());
+    for (const auto& n : nodes) {
+        if (n.planeIndex < 0 || n.planeIndex >= planeCount) {
+            clear();
+            return std::unexpected(Error{"Corrupt node data: " + path});
+        }
+
+        CollisionNode node;
+        node.planeIndex = n.planeIndex;
+        for (i32 side = 0; side < 2; ++side) {
+            i32 child = n.children[side];
+            if (child >= 0) {
+                if (child >= nodeCount) {
+                    clear();
+                    return std::unexpected(Error{"Corrupt node data: " + path});
+                }
+                node.children[side] = static_cast<i16>(child);
+            } else {
+                i32 leafIndex = -1 - child;
+                if (leafIndex >= leafCount) {
+                    clear();
+                    return std::unexpected(Error{"Corrupt leaf reference: " + path});
+                }
+                node.children[side] = static_cast<i16>(leaves[leafIndex].contents);
+            }
+        }
+        m_hull0Nodes.push_back(node);
+    }
+
+    // Models and their hull roots
+    m_models.reserve(models.size());
+    for (const auto& m : models) {
+        addModel(Vec3(m.mins[0], m.mins[1], m.mins[2]),
+                 Vec3(m.maxs[0], m.maxs[1], m.maxs[2]),
+                 Vec3(m.origin[0], m.origin[1], m.origin[2]),
+                 m.headNodes);
+    }
+
+    LOG_INFO("Loaded BSP collision: {} planes, {} nodes, {} clipnodes, {} models",
+             m_planes.size(), m_hull0Nodes.size(), m_clipNodes.size(), m_models.size());
+
+    return {};
+}
+
+Result<void> CollisionWorld::load(const cooked::CookedMapView& view) {
+    CSCPP_PROFILE_FUNCTION();
+    clear();
+
+    const std::string& path = view.getPath();
+    const auto planes = view.getSection<cooked::CookedPlane>(cooked::SECTION_COLLISION_PLANES);
+    const auto hull0Nodes = view.getSection<cooked::CookedHullNode>(cooked::SECTION_HULL0_NODES);
+    const auto clipNodes = view.getSection<cooked::CookedHullNode>(cooked::SECTION_CLIP_NODES);
+    const auto models = view.getSection<cooked::CookedModel>(cooked::SECTION_MODELS);
+
+    if (models.empty() || planes.empty()) {
+        return std::unexpected(Error{"Cooked map has no collision: " + path});
+    }
+
+    m_planes.reserve(planes.size());
+    for (const auto& p : planes) {
+        CollisionPlane plane;
+        plane.normal = Vec3(p.normal[0], p.normal[1], p.normal[2]);
+        plane.dist = p.dist;
+        plane.type = p.type;
+        m_planes.push_back(plane);
+    }
+
+    // Leaf references were already resolved to contents when cooking;
+    // only the indices need checking
+    const i32 planeCount = static_cast<i32>(m_planes.size());
+    auto copyNodes = [planeCount](std::span<const cooked::CookedHullNode> in, std::vector<CollisionNode>& out) {
+        const i32 count = static_cast<i32>(in.size());
+        out.reserve(in.size());
+        for (const auto& n : in) {
+            if (n.planeIndex < 0 || n.planeIndex >= planeCount ||
+                n.children[0] >= count || n.children[1] >= count) {
+                return false;
+            }
+            CollisionNode node;
+            node.planeIndex = n.planeIndex;
+            node.children[0] = n.children[0];
+            node.children[1] = n.children[1];
+            out.push_back(node);
+        }
+        return true;
+    };
+    if (!copyNodes(hull0Nodes, m_hull0Nodes) || !copyNodes(clipNodes, m_clipNodes)) {
+        clear();
+        return std::unexpected(Error{"Corrupt cooked collision nodes: " + path});
+    }
+
+    m_models.reserve(models.size());
+    for (const auto& m : models) {
+        addModel(Vec3(m.mins[0], m.mins[1], m.mins[2]),
+                 Vec3(m.maxs[0], m.maxs[1], m.maxs[2]),
+                 Vec3(m.origin[0], m.origin[1], m.origin[2]),
+                 m.headNodes);
+    }
+
+    LOG_INFO("Loaded cooked collision: {} planes, {} nodes, {} clipnodes, {} models",
+             m_planes.size(), m_hull0Nodes.size(), m_clipNodes.size(), m_models.size());
+
+    return {};
+}
+
+void CollisionWorld::cook(cooked::CookedMapWriter& writer) const {
+    std::vector<cooked::CookedPlane> planes;
+    planes.reserve(m_planes.size());
+    for (const auto& p : m_planes) {
+        planes.push_back({{p.normal.x, p.normal.y, p.normal.z}, p.dist, p.type});
+    }
+
+    auto cookNodes = [](const std::vector<CollisionNode>& in) {
+        std::vector<cooked::CookedHullNode> out;
+        out.reserve(in.size());
+        for (const auto& n : in) {
+            out.push_back({n.planeIndex, {n.children[0], n.children[1]}});
+        }
+        return out;
+    };
+    const std::vector<cooked::CookedHullNode> hull0Nodes = cookNodes(m_hull0Nodes);
+    const std::vector<cooked::CookedHullNode> clipNodes = cookNodes(m_clipNodes);
+
+    std::vector<cooked::CookedModel> models;
+    models.reserve(m_models.size());
+    for (const auto& m : m_models) {
+        cooked::CookedModel model{};
+        for (i32 axis = 0; axis < 3; ++axis) {
+            model.mins[axis] = m.mins[axis];
+            model.maxs[axis] = m.maxs[axis];
+            model.origin[axis] = m.origin[axis];
+        }
+        for (i32 h = 0; h < MAX_HULLS; ++h) {
+            model.headNodes[h] = m.hulls[h].firstNode;
+        }
+        models.push_back(model);
+    }
+
+    writer.setSection(cooked::SECTION_COLLISION_PLANES, std::span<const cooked::CookedPlane>(planes));
+    writer.setSection(cooked::SECTION_HULL0_NODES, std::span<const cooked::CookedHullNode>(hull0Nodes));
+    writer.setSection(cooked::SECTION_CLIP_NODES, std::span<const cooked::CookedHullNode>(clipNodes));
+    writer.setSection(cooked::SECTION_MODELS, std::span<const cooked::CookedModel>(models));
+}
+
+void CollisionWorld::addModel(Vec3 mins, Vec3 maxs, Vec3 origin, const i32 (&headNodes)[MAX_HULLS]) {
+    CollisionModel model;
+    model.mins = mins;
+    model.maxs = maxs;
+    model.origin = origin;
+
+    for (i32 h = 0; h < MAX_HULLS; ++h) {
+        CollisionHull& hull = model.hulls[h];
+        hull.clipMins = BSP_HULL_MINS[h];
+        hull.clipMaxs = BSP_HULL_MAXS[h];
+        hull.firstNode = headNodes[h];
+
+        if (h == 0) {
+            hull.nodes = m_hull0Nodes.data();
+            hull.lastNode = static_cast<i32>(m_hull0Nodes.size()) - 1;
+        } else {
+            hull.nodes = m_clipNodes.data();
+            hull.lastNode = static_cast<i32>(m_clipNodes.size()) - 1;
+        }
+
+        // A head node outside the tree means the hull is empty
+        if (hull.firstNode < 0 || hull.firstNode > hull.lastNode) {
+            hull.nodes = nullptr;
+        }
+    }
+
+    m_models.push_back(model);
+}
+
+void CollisionWorld::clear() {
+    m_planes.clear();
+    m_hull0Nodes.clear();
+    m_clipNodes.clear();
+    m_models.clear();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+i32 CollisionWorld::bspHullIndex(i32 hullType) {
+    switch (hullType) {
+        case HULL_STANDING: return 1;
+        case HULL_DUCKED:   return 3;
+        case HULL_POINT:    return 0;
+        case HULL_LARGE:    return 2;
+        default:            return 1;
+    }
+}
+
+const CollisionHull* CollisionWorld::selectHull(i32 hullType, i32 modelIndex) const {
+    if (modelIndex < 0 || modelIndex >= static_cast<i32>(m_models.size())) {
+        return nullptr;
+    }
+
+    const CollisionHull& hull = m_models[modelIndex].hulls[bspHullIndex(hullType)];
+    return hull.nodes ? &hull : nullptr;
+}
+
+i32 CollisionWorld::hullPointContents(const CollisionHull& hull, i32 num, Vec3 point) const {
+    while (num >= 0) {
+        const CollisionNode& node = hull.nodes[num];
+        f32 d = planeDiff(m_planes[node.planeIndex], point);
+        num = node.children[d < 0.0f ? 1 : 0];
+    }
+    return num;
+}
+
+i32 CollisionWorld::pointContents(Vec3 point, i32 hullType, i32 modelIndex) const {
+    const CollisionHull* hull = selectHull(hullType, modelIndex);
+    if (!hull) {
+        return CONTENTS_EMPTY;
+    }
+    return hullPointContents(*hull, hull->firstNode, point);
+}
+
+TraceResult CollisionWorld::traceHull(Vec3 start, Vec3 end, i32 hullType, i32 modelIndex) const {
+    TraceResult trace;
+    trace.fraction = 1.0f;
+    trace.endPos = end;
+
+    const CollisionHull* hull = selectHull(hullType, modelIndex);
+    if (!hull) {
+        return trace;
+    }
+
+    // Cleared as soon as any part of the move is found in non-solid space
+    trace.allSolid = true;
+
+    recursiveHullCheck(*hull, hull->firstNode, 0.0f, 1.0f, start, end, trace);
+
+    if (trace.allSolid) {
+        trace.startSolid = true;
+    }
+    if (trace.fraction == 1.0f) {
+        trace.endPos = end;
+    } else {
+        trace.entity = 0;
+    }
+
+    return trace;
+}
+
+bool CollisionWorld::recursiveHullCheck(const CollisionHull& hull, i32 num,
+                                        f32 p1f, f32 p2f, Vec3 p1, Vec3 p2,
+                                        TraceResult& trace) const {
+    const CollisionNode* node = nullptr;
+    const CollisionPlane* plane = nullptr;
+    f32 t1 = 0.0f;
+    f32 t2 = 0.0f;
+
+    // Descend while the segment stays on one side (no recursion needed)
+    for (;;) {
+        if (num < 0) {
+            if (num != CONTENTS_SOLID) {
+                trace.allSolid = false;
+                if (num == CONTENTS_EMPTY) {
+                    trace.inOpen = true;
+                } else {
+                    trace.inWater = true;
+                }
+            } else {
+                trace.startSolid = true;
+            }
+            return true;
+        }
+
+        node = &hull.nodes[num];
+        plane = &m_planes[node->planeIndex];
+        t1 = planeDiff(*plane, p1);
+        t2 = planeDiff(*plane, p2);
+
+        if (t1 >= 0.0f && t2 >= 0.0f) {
+            num = node->children[0];
+        } else if (t1 < 0.0f && t2 < 0.0f) {
+            num = node->children[1];
+        } else {
+            break;
+        }
+    }
+
+    // Put the crosspoint DIST_EPSILON units on the near side
+    f32 frac = (t1 < 0.0f) ? (t1 + DIST_EPSILON) / (t1 - t2)
+                           : (t1 - DIST_EPSILON) / (t1 - t2);
+    frac = math::clamp(frac, 0.0f, 1.0f);
+
+    f32 midf = p1f + (p2f - p1f) * frac;
+    Vec3 mid = p1 + frac * (p2 - p1);
+
+    i32 side = (t1 < 0.0f) ? 1 : 0;
+
+    // Move up to the node
+    if (!recursiveHullCheck(hull, node->children[side], p1f, midf, p1, mid, trace)) {
+        return false;
+    }
+
+    // Go past the node
+    if (hullPointContents(hull, node->children[side ^ 1], mid) != CONTENTS_SOLID) {
+        return recursiveHullCheck(hull, node->children[side ^ 1], midf, p2f, mid, p2, trace);
+    }
+
+    // Never got out of the solid area
+    if (trace.allSolid) {
+        return false;
+    }
+
+    // The other side of the node is solid, this is the impact point
+    if (side == 0) {
+        trace.plane.normal = plane->normal;
+        trace.plane.dist = plane->dist;
+    } else {
+        trace.plane.normal = -plane->normal;
+        trace.plane.dist = -plane->dist;
+    }
+
+    // Back up until the midpoint is out of solid (rare, happens on sharp edges)
+    while (hullPointContents(hull, hull.firstNode, mid) == CONTENTS_SOLID) {
+        frac -= 0.1f;
+        if (frac < 0.0f) {
+            trace.fraction = midf;
+            trace.endPos = mid;
+            return false;
+        }
+        midf = p1f + (p2f - p1f) * frac;
+        mid = p1 + frac * (p2 - p1);
+    }
+
+    trace.fraction = midf;
+    trace.endPos = mid;
+    return false;
+}
+
+// ============================================================================
+// PlayerMove Integration
+// ============================================================================
+
+TraceResult worldTraceFunction(const PlayerMove* pm, Vec3 start, Vec3 end, i32 hullType) {
+    const auto* world = static_cast<const CollisionWorld*>(pm->traceUserData);
+    if (!world) {
+        TraceResult result;
+        result.fraction = 1.0f;
+        result.endPos = end;
+        return result;
+    }
+    return world->traceHull(start, end, hullType);
+}
+
+} // namespace cscpp::movement
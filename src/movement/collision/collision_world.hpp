@@ -0,0 +1,177 @@
+#pragma once
+
+/**
+ * @file collision_world.hpp
+ * @brief BSP hull collision (clipnode trace engine)
+ *
+ * Port of the GoldSrc/Quake hull tracing code (SV_RecursiveHullCheck and
+ * SV_HullPointContents). Each BSP model carries four precomputed hulls:
+ * hull 0 is built from the render node tree (point traces), hulls 1-3 are
+ * the clipnode trees expanded by the player/monster bounding boxes.
+ *
+ * Node and plane data are stored in flat, compact arrays. Tracing walks the
+ * tree without touching the heap, so it is safe to call from any number of
+ * threads concurrently once the map is loaded.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "movement/pm_shared/pm_defs.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace cscpp::assets::bsp {
+class BSPView;
+}
+
+namespace cscpp::assets::cooked {
+class CookedMapView;
+class CookedMapWriter;
+}
+
+namespace cscpp::movement {
+
+struct PlayerMove;
+
+// ============================================================================
+// Collision Data
+// ============================================================================
+
+/// Splitting plane (type 0-2 = axial X/Y/Z, used for the fast path)
+struct CollisionPlane {
+    Vec3 normal{0.0f};
+    f32 dist = 0.0f;
+    i32 type = 0;
+};
+
+/// Compact tree node. children >= 0 index the node array, < 0 are Contents.
+struct CollisionNode {
+    i32 planeIndex = 0;
+    i16 children[2] = {CONTENTS_EMPTY, CONTENTS_EMPTY};
+};
+
+/// One collision hull of a BSP model
+struct CollisionHull {
+    const CollisionNode* nodes = nullptr;
+    i32 firstNode = 0;          ///< Root node (model headnode)
+    i32 lastNode = -1;
+    Vec3 clipMins{0.0f};        ///< Bounding box the hull was expanded by
+    Vec3 clipMaxs{0.0f};
+};
+
+/// Brush model (model 0 is the world)
+struct CollisionModel {
+    Vec3 mins{0.0f};
+    Vec3 maxs{0.0f};
+    Vec3 origin{0.0f};
+    std::array<CollisionHull, 4> hulls;
+};
+
+// ============================================================================
+// Collision World
+// ============================================================================
+
+/**
+ * @brief Hull collision for a loaded BSP map
+ */
+class CollisionWorld {
+public:
+    /// Number of hulls in a GoldSrc BSP
+    static constexpr i32 MAX_HULLS = 4;
+
+    /// Impact points are placed this far on the near side of a plane
+    static constexpr f32 DIST_EPSILON = 0.03125f;
+
+    CollisionWorld() = default;
+    ~CollisionWorld() = default;
+
+    // Model data is referenced by raw pointers into our own arrays
+    CollisionWorld(const CollisionWorld&) = delete;
+    CollisionWorld& operator=(const CollisionWorld&) = delete;
+    CollisionWorld(CollisionWorld&&) = delete;
+    CollisionWorld& operator=(CollisionWorld&&) = delete;
+
+    /**
+     * @brief Load collision data (planes, nodes, clipnodes, leaves, models) from a BSP file
+     */
+    Result<void> loadFromFile(const std::string& path);
+
+    /// Same, from a map already opened for other loaders (the world keeps no reference to it)
+    Result<void> load(const assets::bsp::BSPView& view);
+
+    /// Load the hulls stored in a cooked map by cook()
+    Result<void> load(const assets::cooked::CookedMapView& view);
+
+    /// Store the loaded hulls in a cooked map
+    void cook(assets::cooked::CookedMapWriter& writer) const;
+
+    /// Release all collision data
+    void clear();
+
+    bool isLoaded() const { return !m_models.empty(); }
+
+    /**
+     * @brief Trace a hull through a brush model
+     * @param start Trace start (hull origin)
+     * @param end Trace end
+     * @param hullType Movement hull (HullType)
+     * @param modelIndex Brush model, 0 = world
+     */
+    TraceResult traceHull(Vec3 start, Vec3 end, i32 hullType, i32 modelIndex = 0) const;
+
+    /**
+     * @brief Contents of the hull at a point
+     */
+    i32 pointContents(Vec3 point, i32 hullType, i32 modelIndex = 0) const;
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    size_t getModelCount() const { return m_models.size(); }
+    const CollisionModel& getModel(size_t index) const { return m_models[index]; }
+
+    size_t getPlaneCount() const { return m_planes.size(); }
+    size_t getClipNodeCount() const { return m_clipNodes.size(); }
+    size_t getNodeCount() const { return m_hull0Nodes.size(); }
+
+    /**
+     * @brief Map a movement HullType to the BSP hull index
+     *
+     * BSP hulls: 0 = point, 1 = standing, 2 = large, 3 = ducked
+     */
+    static i32 bspHullIndex(i32 hullType);
+
+private:
+    /// Append a model once the node arrays are final (hulls point into them)
+    void addModel(Vec3 mins, Vec3 maxs, Vec3 origin, const i32 (&headNodes)[MAX_HULLS]);
+
+    const CollisionHull* selectHull(i32 hullType, i32 modelIndex) const;
+
+    i32 hullPointContents(const CollisionHull& hull, i32 num, Vec3 point) const;
+
+    bool recursiveHullCheck(const CollisionHull& hull, i32 num,
+                            f32 p1f, f32 p2f, Vec3 p1, Vec3 p2,
+                            TraceResult& trace) const;
+
+    std::vector<CollisionPlane> m_planes;
+    std::vector<CollisionNode> m_hull0Nodes;   ///< Built from LUMP_NODES + leaf contents
+    std::vector<CollisionNode> m_clipNodes;    ///< LUMP_CLIPNODES (hulls 1-3)
+    std::vector<CollisionModel> m_models;
+};
+
+// ============================================================================
+// PlayerMove Integration
+// ============================================================================
+
+/**
+ * @brief TraceFunc adapter for PlayerMove
+ *
+ * Expects pm->traceUserData to point at a CollisionWorld. Falls back to
+ * an unobstructed trace if no world is attached.
+ */
+TraceResult worldTraceFunction(const PlayerMove* pm, Vec3 start, Vec3 end, i32 hullType);
+
+} // namespace cscpp::movement
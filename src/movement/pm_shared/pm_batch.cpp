@@ -0,0 +1,384 @@
+/**
+ * @file pm_batch.cpp
+ * @brief Batched player movement implementation
+ *
+ * The stage functions mirror PM_PlayerMove / PM_WalkMove / PM_AirMove
+ * step by step. Any change to the scalar movement code in pm_shared.cpp
+ * must be reflected here to keep the two paths bit-identical.
+ */
+
+#include "movement/pm_shared/pm_batch.hpp"
+#include "core/profiling/profiler.hpp"
+
+namespace cscpp::movement {
+
+namespace {
+
+/// Wish direction and speed from the flattened view vectors (PM_WalkMove/PM_AirMove)
+inline void computeWish(const PlayerMove* pm, Vec3& wishDir, f32& wishSpeed) {
+    Vec3 wishVel;
+    wishVel.x = pm->forward.x * pm->forwardMove + pm->right.x * pm->sideMove;
+    wishVel.y = pm->forward.y * pm->forwardMove + pm->right.y * pm->sideMove;
+    wishVel.z = 0.0f;
+
+    wishDir = wishVel;
+    wishSpeed = glm::length(wishDir);
+
+    if (wishSpeed > pmove::STOP_EPSILON) {
+        wishDir /= wishSpeed;
+    }
+
+    wishSpeed *= pm->maxSpeed;
+}
+
+/// PM_CheckVelocity on a single component
+inline f32 clampComponent(f32 v, f32 maxVel) {
+    v = (v > maxVel) ? maxVel : v;
+    v = (v < -maxVel) ? -maxVel : v;
+    return v;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+PlayerMoveBatch::PlayerMoveBatch() {
+    m_template.initHulls();
+}
+
+void PlayerMoveBatch::setTrace(TraceFunc func, void* userData) {
+    m_template.traceFunc = func;
+    m_template.traceUserData = userData;
+}
+
+void PlayerMoveBatch::reserve(size_t count) {
+    m_lanes.reserve(count);
+    resizeScratch(count);
+}
+
+PlayerMove& PlayerMoveBatch::addLane() {
+    m_lanes.push_back(m_template);
+    if (m_mode.size() < m_lanes.size()) {
+        resizeScratch(m_lanes.capacity());
+    }
+    return m_lanes.back();
+}
+
+void PlayerMoveBatch::resizeScratch(size_t count) {
+    if (m_mode.size() >= count) {
+        return;
+    }
+
+    m_mode.resize(count);
+    m_slotLane.resize(count);
+    m_needsTrace.resize(count);
+    m_velX.resize(count);
+    m_velY.resize(count);
+    m_velZ.resize(count);
+    m_wishX.resize(count);
+    m_wishY.resize(count);
+    m_wishZ.resize(count);
+    m_wishSpeed.resize(count);
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+void PlayerMoveBatch::run(size_t begin, size_t end) {
+    CSCPP_PROFILE_FUNCTION();
+    if (end > m_lanes.size()) {
+        end = m_lanes.size();
+    }
+    if (begin >= end) {
+        return;
+    }
+
+    // Stage 1: categorize, duck and special moves (scalar, traces)
+    for (size_t i = begin; i < end; ++i) {
+        m_mode[i] = preMove(&m_lanes[i]);
+    }
+
+    // Compact walk lanes, then air lanes, into slots starting at `begin`
+    size_t slot = begin;
+    for (size_t i = begin; i < end; ++i) {
+        if (m_mode[i] == LaneMode::Walk) {
+            m_slotLane[slot++] = static_cast<u32>(i);
+        }
+    }
+    const size_t walkEnd = slot;
+    for (size_t i = begin; i < end; ++i) {
+        if (m_mode[i] == LaneMode::Air) {
+            m_slotLane[slot++] = static_cast<u32>(i);
+        }
+    }
+    const size_t airEnd = slot;
+
+    // Stage 2: wish velocity, friction, acceleration, gravity (SoA)
+    walkMathStage(begin, walkEnd - begin);
+    airMathStage(walkEnd, airEnd - walkEnd);
+
+    // Stage 3: collision moves (scalar, traces)
+    for (size_t s = begin; s < walkEnd; ++s) {
+        if (!m_needsTrace[s]) {
+            continue;
+        }
+
+        PlayerMove* pm = &m_lanes[m_slotLane[s]];
+
+        // Try to move forward
+        Vec3 dest = pm->origin + pm->velocity * pm->frameTime;
+        TraceResult trace = PM_PlayerTrace(pm, pm->origin, dest);
+
+        // Made the full move
+        if (trace.fraction == 1.0f) {
+            pm->origin = dest;
+            continue;
+        }
+
+        // Try stepping up stairs
+        PM_StepMove(pm, dest, trace);
+    }
+
+    for (size_t s = walkEnd; s < airEnd; ++s) {
+        PM_FlyMove(&m_lanes[m_slotLane[s]]);
+    }
+
+    // Stage 4: categorize again and track falling (scalar, traces)
+    slot = begin;
+    for (size_t i = begin; i < end; ++i) {
+        if (m_mode[i] == LaneMode::Done) {
+            continue;
+        }
+
+        PlayerMove* pm = &m_lanes[i];
+        PM_CategorizePosition(pm);
+        PM_CheckFalling(pm);
+        m_slotLane[slot++] = static_cast<u32>(i);
+    }
+
+    // Stage 5: clamp velocity and store old values (SoA)
+    checkVelocityStage(begin, slot - begin);
+}
+
+PlayerMoveBatch::LaneMode PlayerMoveBatch::preMove(PlayerMove* pm) {
+    // Mirrors PM_PlayerMove up to the ground/air move
+    PM_AngleVectors(pm);
+    PM_CategorizePosition(pm);
+
+    if (pm->flags & FL_FROZEN) {
+        return LaneMode::Done;
+    }
+
+    if (pm->dead) {
+        pm->maxSpeed = pmove::DEAD_MAXSPEED;
+        return LaneMode::Done;
+    }
+
+    PM_Duck(pm);
+
+    if (PM_CheckLadder(pm)) {
+        PM_LadderMove(pm);
+        return LaneMode::Done;
+    }
+
+    if (pm->waterLevel >= WL_WAIST) {
+        PM_WaterMove(pm);
+        return LaneMode::Done;
+    }
+
+    if (pm->flags & FL_ONGROUND) {
+        if (pm->buttons & IN_JUMP) {
+            PM_Jump(pm);
+        } else {
+            pm->flags &= ~FL_WATERJUMP;
+        }
+
+        return (pm->flags & FL_ONGROUND) ? LaneMode::Walk : LaneMode::Post;
+    }
+
+    return LaneMode::Air;
+}
+
+void PlayerMoveBatch::walkMathStage(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    const MoveVars& mv = *m_template.moveVars;
+    const f32 frameTime = m_template.frameTime;
+    const size_t last = first + count;
+
+    // Gather velocity and wish (PM_WalkMove, before PM_Friction)
+    for (size_t s = first; s < last; ++s) {
+        const PlayerMove* pm = &m_lanes[m_slotLane[s]];
+
+        Vec3 wishDir;
+        f32 wishSpeed;
+        computeWish(pm, wishDir, wishSpeed);
+
+        if (wishSpeed > pm->maxSpeed) {
+            wishSpeed = pm->maxSpeed;
+        }
+
+        if (pm->buttons & IN_SPEED) {
+            wishSpeed *= 0.52f;
+        }
+
+        m_wishX[s] = wishDir.x;
+        m_wishY[s] = wishDir.y;
+        m_wishZ[s] = wishDir.z;
+        m_wishSpeed[s] = wishSpeed;
+        m_velX[s] = pm->velocity.x;
+        m_velY[s] = pm->velocity.y;
+        m_velZ[s] = pm->velocity.z;
+    }
+
+    // PM_Friction (walk lanes are always on ground)
+    for (size_t s = first; s < last; ++s) {
+        f32 speed = glm::length(Vec3(m_velX[s], m_velY[s], m_velZ[s]));
+
+        f32 control = (speed < mv.stopSpeed) ? mv.stopSpeed : speed;
+        f32 drop = control * mv.friction * frameTime;
+
+        f32 newSpeed = speed - drop;
+        newSpeed = (newSpeed < 0) ? 0.0f : newSpeed;
+
+        bool apply = !(speed < pmove::STOP_EPSILON) && newSpeed != speed;
+        f32 scale = newSpeed / speed;
+
+        m_velX[s] = apply ? m_velX[s] * scale : m_velX[s];
+        m_velY[s] = apply ? m_velY[s] * scale : m_velY[s];
+        m_velZ[s] = apply ? m_velZ[s] * scale : m_velZ[s];
+    }
+
+    // PM_Accelerate
+    for (size_t s = first; s < last; ++s) {
+        f32 currentSpeed = glm::dot(Vec3(m_velX[s], m_velY[s], m_velZ[s]),
+                                    Vec3(m_wishX[s], m_wishY[s], m_wishZ[s]));
+        f32 addSpeed = m_wishSpeed[s] - currentSpeed;
+
+        f32 accelSpeed = mv.accelerate * frameTime * m_wishSpeed[s];
+        accelSpeed = (accelSpeed > addSpeed) ? addSpeed : accelSpeed;
+
+        bool apply = addSpeed > 0;
+        m_velX[s] = apply ? m_velX[s] + accelSpeed * m_wishX[s] : m_velX[s];
+        m_velY[s] = apply ? m_velY[s] + accelSpeed * m_wishY[s] : m_velY[s];
+        m_velZ[s] = apply ? m_velZ[s] + accelSpeed * m_wishZ[s] : m_velZ[s];
+    }
+
+    // PM_CheckVelocity, then stop check
+    for (size_t s = first; s < last; ++s) {
+        f32 vx = clampComponent(m_velX[s], mv.maxVelocity);
+        f32 vy = clampComponent(m_velY[s], mv.maxVelocity);
+        f32 vz = clampComponent(m_velZ[s], mv.maxVelocity);
+
+        bool moving = !(glm::length(Vec3(vx, vy, vz)) < 1.0f);
+        m_velX[s] = moving ? vx : 0.0f;
+        m_velY[s] = moving ? vy : 0.0f;
+        m_velZ[s] = moving ? vz : 0.0f;
+        m_needsTrace[s] = moving ? 1 : 0;
+    }
+
+    // Scatter
+    for (size_t s = first; s < last; ++s) {
+        m_lanes[m_slotLane[s]].velocity = Vec3(m_velX[s], m_velY[s], m_velZ[s]);
+    }
+}
+
+void PlayerMoveBatch::airMathStage(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    const MoveVars& mv = *m_template.moveVars;
+    const f32 frameTime = m_template.frameTime;
+    const size_t last = first + count;
+
+    f32 gravity = mv.gravity;
+    if (mv.entGravity != 0.0f) {
+        gravity *= mv.entGravity;
+    }
+
+    // Gather velocity and wish (PM_AirMove)
+    for (size_t s = first; s < last; ++s) {
+        const PlayerMove* pm = &m_lanes[m_slotLane[s]];
+
+        Vec3 wishDir;
+        f32 wishSpeed;
+        computeWish(pm, wishDir, wishSpeed);
+
+        m_wishX[s] = wishDir.x;
+        m_wishY[s] = wishDir.y;
+        m_wishZ[s] = wishDir.z;
+        m_wishSpeed[s] = wishSpeed;
+        m_velX[s] = pm->velocity.x;
+        m_velY[s] = pm->velocity.y;
+        m_velZ[s] = pm->velocity.z;
+    }
+
+    // PM_AirAccelerate
+    for (size_t s = first; s < last; ++s) {
+        f32 wishSpd = (m_wishSpeed[s] > mv.airSpeedCap) ? mv.airSpeedCap : m_wishSpeed[s];
+
+        f32 currentSpeed = glm::dot(Vec3(m_velX[s], m_velY[s], m_velZ[s]),
+                                    Vec3(m_wishX[s], m_wishY[s], m_wishZ[s]));
+        f32 addSpeed = wishSpd - currentSpeed;
+
+        f32 accelSpeed = mv.airAccelerate * m_wishSpeed[s] * frameTime;
+        accelSpeed = (accelSpeed > addSpeed) ? addSpeed : accelSpeed;
+
+        bool apply = addSpeed > 0;
+        m_velX[s] = apply ? m_velX[s] + accelSpeed * m_wishX[s] : m_velX[s];
+        m_velY[s] = apply ? m_velY[s] + accelSpeed * m_wishY[s] : m_velY[s];
+        m_velZ[s] = apply ? m_velZ[s] + accelSpeed * m_wishZ[s] : m_velZ[s];
+    }
+
+    // PM_AddGravity
+    for (size_t s = first; s < last; ++s) {
+        m_velZ[s] -= gravity * frameTime;
+    }
+
+    // Scatter (base velocity is consumed by PM_AddGravity)
+    for (size_t s = first; s < last; ++s) {
+        PlayerMove* pm = &m_lanes[m_slotLane[s]];
+        f32 vz = m_velZ[s] + pm->baseVelocity.z * frameTime;
+        pm->velocity = Vec3(m_velX[s], m_velY[s], vz);
+        pm->baseVelocity.z = 0.0f;
+    }
+}
+
+void PlayerMoveBatch::checkVelocityStage(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    const f32 maxVel = m_template.moveVars->maxVelocity;
+    const size_t last = first + count;
+
+    for (size_t s = first; s < last; ++s) {
+        const PlayerMove* pm = &m_lanes[m_slotLane[s]];
+        m_velX[s] = pm->velocity.x;
+        m_velY[s] = pm->velocity.y;
+        m_velZ[s] = pm->velocity.z;
+    }
+
+    for (size_t s = first; s < last; ++s) {
+        m_velX[s] = clampComponent(m_velX[s], maxVel);
+        m_velY[s] = clampComponent(m_velY[s], maxVel);
+        m_velZ[s] = clampComponent(m_velZ[s], maxVel);
+    }
+
+    for (size_t s = first; s < last; ++s) {
+        PlayerMove* pm = &m_lanes[m_slotLane[s]];
+        pm->velocity = Vec3(m_velX[s], m_velY[s], m_velZ[s]);
+
+        // Store old values for next frame
+        pm->oldButtons = pm->buttons;
+        pm->oldFlags = pm->flags;
+    }
+}
+
+} // namespace cscpp::movement
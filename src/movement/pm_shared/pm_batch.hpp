@@ -0,0 +1,113 @@
+#pragma once
+
+/**
+ * @file pm_batch.hpp
+ * @brief Batched player movement
+ *
+ * Runs PM_PlayerMove for many players at once. The trace-driven parts of
+ * the movement code (categorize, duck, fly/step move) still run per player,
+ * but the pure math stages (wish velocity, friction, acceleration, gravity,
+ * velocity clamping) run over structure-of-arrays scratch across all lanes
+ * in the same stage.
+ *
+ * Every lane produces exactly the same result as a PM_PlayerMove call on
+ * the same input: the SoA stages evaluate the same expressions in the same
+ * order, so results are bit-identical (with or without CSCPP_GOLDSRC_PARITY).
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "movement/pm_shared/pm_shared.hpp"
+
+#include <vector>
+
+namespace cscpp::movement {
+
+/**
+ * @brief Batch of PlayerMove lanes sharing hulls, MoveVars and trace setup
+ *
+ * Usage per tick:
+ *   batch.clear();
+ *   PlayerMove& pm = batch.addLane();   // once per player, fill input fields
+ *   batch.run();                        // or run(begin, end) per worker
+ *   // read results back from batch.lane(i)
+ *
+ * Lanes start from a template that already has the hull tables, MoveVars,
+ * trace function and frame time set, so callers only write per-player state.
+ * MoveVars and frame time are batch-wide; lanes must not override them.
+ */
+class PlayerMoveBatch {
+public:
+    PlayerMoveBatch();
+
+    // ========================================================================
+    // Shared Setup (applies to lanes added afterwards)
+    // ========================================================================
+
+    void setMoveVars(const MoveVars* moveVars) { m_template.moveVars = moveVars; }
+    void setTrace(TraceFunc func, void* userData);
+    void setFrameTime(f32 frameTime) { m_template.frameTime = frameTime; }
+
+    // ========================================================================
+    // Lanes
+    // ========================================================================
+
+    /// Reserve lanes and scratch so steady-state ticks don't allocate
+    void reserve(size_t count);
+
+    /// Remove all lanes (keeps capacity)
+    void clear() { m_lanes.clear(); }
+
+    /// Append a lane initialized from the shared template
+    PlayerMove& addLane();
+
+    size_t size() const { return m_lanes.size(); }
+    PlayerMove& lane(size_t index) { return m_lanes[index]; }
+    const PlayerMove& lane(size_t index) const { return m_lanes[index]; }
+
+    // ========================================================================
+    // Execution
+    // ========================================================================
+
+    /// Move every lane
+    void run() { run(0, m_lanes.size()); }
+
+    /**
+     * @brief Move lanes [begin, end)
+     *
+     * Scratch is indexed by lane, so disjoint ranges may run concurrently.
+     */
+    void run(size_t begin, size_t end);
+
+private:
+    enum class LaneMode : u8 {
+        Done,   ///< Finished in the pre-phase (frozen, dead, ladder, water)
+        Walk,   ///< Ground move
+        Air,    ///< Air move
+        Post,   ///< No move this tick (jumped), only post-move categorize
+    };
+
+    /// Scalar pre-phase: everything up to the ground/air move
+    LaneMode preMove(PlayerMove* pm);
+
+    void walkMathStage(size_t first, size_t count);
+    void airMathStage(size_t first, size_t count);
+    void checkVelocityStage(size_t first, size_t count);
+
+    void resizeScratch(size_t count);
+
+    PlayerMove m_template;
+    std::vector<PlayerMove> m_lanes;
+
+    // Per-lane scratch (indexed by lane, compacted per range)
+    std::vector<LaneMode> m_mode;
+    std::vector<u32> m_slotLane;     ///< Compacted slot -> lane index
+    std::vector<u8> m_needsTrace;    ///< Walk lanes still moving after the math stage
+
+    // SoA math lanes (indexed by compacted slot)
+    std::vector<f32> m_velX, m_velY, m_velZ;
+    std::vector<f32> m_wishX, m_wishY, m_wishZ;
+    std::vector<f32> m_wishSpeed;
+};
+
+} // namespace cscpp::movement
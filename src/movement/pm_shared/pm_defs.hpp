@@ -143,7 +143,7 @@ struct TraceResult {
         f32 dist = 0.0f;       ///< Distance to plane
     } plane;
     
-    i32 entity = -1;           ///< Entity hit (-1 for world)
+    i32 entity = -1;           ///< Entity hit (-1 = nothing, 0 = world)
     i32 hitgroup = 0;          ///< Hit group (for damage calculation)
 };
 
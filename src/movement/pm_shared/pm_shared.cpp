@@ -11,6 +11,7 @@
 
 #include "movement/pm_shared/pm_shared.hpp"
 #include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
 
 #include <cmath>
 #include <algorithm>
@@ -60,6 +61,7 @@ void PlayerMove::initHulls() {
 // ============================================================================
 
 void PM_PlayerMove(PlayerMove* pm) {
+    CSCPP_PROFILE_FUNCTION();
     // Calculate view direction vectors
     PM_AngleVectors(pm);
     
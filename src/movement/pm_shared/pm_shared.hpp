@@ -20,6 +20,7 @@
 
 #include "core/types.hpp"
 #include "core/math/math.hpp"
+#include "core/platform/input.hpp"
 #include "movement/pm_shared/pm_defs.hpp"
 
 namespace cscpp::movement {
@@ -186,6 +187,24 @@ struct PlayerMove {
  */
 void PM_PlayerMove(PlayerMove* pm);
 
+/// Scale from normalized UserCmd move axes (-1 to 1) to movement units
+constexpr f32 CMD_MOVE_SCALE = 400.0f;
+
+/**
+ * @brief Copy a user command into the movement input fields
+ * @param oldButtons Buttons of the previously run command (jump/duck edges)
+ *
+ * The server and client prediction both go through this, so they feed
+ * PM_PlayerMove the same input for the same command.
+ */
+inline void PM_SetupCmd(PlayerMove* pm, const UserCmd& cmd, u16 oldButtons) {
+    pm->viewAngles = cmd.viewAngles;
+    pm->forwardMove = cmd.forwardMove * CMD_MOVE_SCALE;
+    pm->sideMove = cmd.sideMove * CMD_MOVE_SCALE;
+    pm->buttons = cmd.buttons;
+    pm->oldButtons = oldButtons;
+}
+
 // ============================================================================
 // Movement Mode Functions
 // ============================================================================
@@ -0,0 +1,110 @@
+/**
+ * @file interest_manager.cpp
+ * @brief Per-client snapshot relevance
+ */
+
+#include "network/interest/interest_manager.hpp"
+#include "movement/pm_shared/pm_defs.hpp"
+
+#include <algorithm>
+
+namespace cscpp::network {
+
+void InterestManager::prepare(const SnapshotFrame& world) {
+    m_world = &world;
+    m_entities.clear();
+    m_leaves.clear();
+
+    const bool useVis = m_visibility && m_visibility->isLoaded() && m_visibility->hasVisData();
+
+    i32 touched[MapVisibility::MAX_ENTITY_LEAVES];
+    for (const EntityState& state : world.entities) {
+        EntityLeaves& entity = m_entities.emplace_back();
+        if (!useVis) {
+            entity.everywhere = true;
+            continue;
+        }
+
+        u32 count = m_visibility->findTouchedLeaves(state.position + movement::hull::STANDING_MINS,
+                                                    state.position + movement::hull::STANDING_MAXS,
+                                                    touched);
+        if (count == 0 || count > MapVisibility::MAX_ENTITY_LEAVES) {
+            // Inside solid or spanning a huge area: let distance/budget decide
+            entity.everywhere = true;
+            continue;
+        }
+
+        entity.first = static_cast<u32>(m_leaves.size());
+        entity.count = count;
+        m_leaves.insert(m_leaves.end(), touched, touched + count);
+    }
+}
+
+bool InterestManager::isVisible(const EntityLeaves& entity, const u64* pvs) const {
+    if (entity.everywhere || !pvs) {
+        return true;
+    }
+    for (u32 i = 0; i < entity.count; ++i) {
+        if (m_visibility->isLeafVisible(pvs, m_leaves[entity.first + i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InterestManager::selectRelevant(Vec3 viewOrigin, NetworkId viewerId, std::vector<u32>& out) const {
+    out.clear();
+    if (!m_world) {
+        return;
+    }
+
+    const auto& entities = m_world->entities;
+
+    const u64* pvs = nullptr;
+    if (m_visibility && m_visibility->hasVisData()) {
+        pvs = m_visibility->getPVS(m_visibility->findLeaf(viewOrigin));
+    }
+
+    const f32 maxDistanceSq = m_config.maxDistance * m_config.maxDistance;
+
+    for (u32 i = 0; i < static_cast<u32>(entities.size()); ++i) {
+        const EntityState& state = entities[i];
+        if (state.networkId == viewerId) {
+            out.push_back(i);
+            continue;
+        }
+
+        if (maxDistanceSq > 0.0f) {
+            Vec3 delta = state.position - viewOrigin;
+            if (glm::dot(delta, delta) > maxDistanceSq) {
+                continue;
+            }
+        }
+
+        if (!isVisible(m_entities[i], pvs)) {
+            continue;
+        }
+
+        out.push_back(i);
+    }
+
+    // Over budget: keep the viewer and the nearest entities
+    if (out.size() > m_config.maxEntities) {
+        auto priority = [&](u32 a, u32 b) {
+            const bool aViewer = entities[a].networkId == viewerId;
+            const bool bViewer = entities[b].networkId == viewerId;
+            if (aViewer != bViewer) {
+                return aViewer;
+            }
+            Vec3 da = entities[a].position - viewOrigin;
+            Vec3 db = entities[b].position - viewOrigin;
+            return glm::dot(da, da) < glm::dot(db, db);
+        };
+
+        std::nth_element(out.begin(), out.begin() + m_config.maxEntities, out.end(), priority);
+        out.resize(m_config.maxEntities);
+        std::sort(out.begin(), out.end());
+    }
+}
+
+} // namespace cscpp::network
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file interest_manager.hpp
+ * @brief Per-client snapshot relevance (PVS + distance + entity budget)
+ *
+ * prepare() runs once per snapshot and finds the BSP leaves touched by every
+ * world entity. selectRelevant() then runs per client: one leaf lookup for
+ * the viewer, one PVS bit test per entity leaf, a distance check, and, if
+ * more than the budget survive, a partial sort by priority. Entities outside
+ * the viewer's PVS are never sent, which also keeps hidden players' positions
+ * away from the client.
+ */
+
+#include "core/types.hpp"
+#include "network/interest/map_visibility.hpp"
+#include "network/snapshot/snapshot.hpp"
+
+#include <vector>
+
+namespace cscpp::network {
+
+/**
+ * @brief Relevance limits
+ */
+struct InterestConfig {
+    f32 maxDistance = 0.0f;                     ///< Cull beyond this range (0 = unlimited)
+    u32 maxEntities = MAX_SNAPSHOT_ENTITIES;    ///< Entities per snapshot, nearest first
+};
+
+class InterestManager {
+public:
+    void setVisibility(const MapVisibility* visibility) { m_visibility = visibility; }
+    void setConfig(const InterestConfig& config) { m_config = config; }
+    const InterestConfig& getConfig() const { return m_config; }
+
+    /**
+     * @brief Classify the entities of a world frame
+     *
+     * Entity boxes use the standing player hull around the entity origin.
+     */
+    void prepare(const SnapshotFrame& world);
+
+    /**
+     * @brief Pick the world entities relevant to one viewer
+     * @param viewOrigin Eye position of the viewer
+     * @param viewerId The viewer's own entity (always relevant)
+     * @param out Indices into the prepared world frame, ascending
+     *
+     * Const and thread-safe, so clients can be processed in parallel.
+     */
+    void selectRelevant(Vec3 viewOrigin, NetworkId viewerId, std::vector<u32>& out) const;
+
+private:
+    /// Leaves touched by one entity (a range of m_leaves)
+    struct EntityLeaves {
+        u32 first = 0;
+        u32 count = 0;
+        bool everywhere = false;    ///< Too many leaves (or no map); skip the PVS test
+    };
+
+    bool isVisible(const EntityLeaves& entity, const u64* pvs) const;
+
+    const MapVisibility* m_visibility = nullptr;
+    InterestConfig m_config;
+
+    const SnapshotFrame* m_world = nullptr;
+    std::vector<EntityLeaves> m_entities;
+    std::vector<i32> m_leaves;
+};
+
+} // namespace cscpp::network
@@ -0,0 +1,318 @@
+/**
+ * @file map_visibility.cpp
+ * @brief BSP PVS loading and queries
+ */
+
+#include "network/interest/map_visibility.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "assets/cooked/cooked_map_writer.hpp"
+#include "core/logging/logger.hpp"
+
+#include <algorithm>
+
+namespace cscpp::network {
+
+namespace bsp = assets::bsp;
+namespace cooked = assets::cooked;
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+Result<void> MapVisibility::loadFromFile(const std::string& path) {
+    bsp::BSPView view;
+    if (auto opened = view.open(path); !opened) {
+        clear();
+        return opened;
+    }
+    return load(view);
+}
+
+Result<void> MapVisibility::load(const bsp::BSPView& view) {
+    clear();
+
+    const std::string& path = view.getPath();
+    const auto planes = view.getLump<bsp::BSPPlane>(bsp::LUMP_PLANES);
+    const auto nodes = view.getLump<bsp::BSPNode>(bsp::LUMP_NODES);
+    const auto leaves = view.getLump<bsp::BSPLeaf>(bsp::LUMP_LEAVES);
+    const auto models = view.getLump<bsp::BSPModel>(bsp::LUMP_MODELS);
+    const std::span<const u8> visData = view.getLumpBytes(bsp::LUMP_VISIBILITY);
+
+    if (models.empty() || nodes.empty() || leaves.empty()) {
+        return std::unexpected(Error{"BSP has no world tree: " + path});
+    }
+
+    const i32 planeCount = static_cast<i32>(planes.size());
+    const i32 nodeCount = static_cast<i32>(nodes.size());
+    const i32 leafCount = static_cast<i32>(leaves.size());
+
+    m_planes.reserve(planes.size());
+    for (const auto& p : planes) {
+        Plane plane;
+        plane.normal = Vec3(p.normal[0], p.normal[1], p.normal[2]);
+        plane.dist = p.distance;
+        plane.type = p.type;
+        m_planes.push_back(plane);
+    }
+
+    m_nodes.reserve(nodes.size());
+    for (const auto& n : nodes) {
+        if (n.planeIndex < 0 || n.planeIndex >= planeCount) {
+            clear();
+            return std::unexpected(Error{"Corrupt node data: " + path});
+        }
+
+        Node node;
+        node.planeIndex = n.planeIndex;
+        for (i32 side = 0; side < 2; ++side) {
+            i32 child = n.children[side];
+            if (child >= nodeCount || (child < 0 && -1 - child >= leafCount)) {
+                clear();
+                return std::unexpected(Error{"Corrupt node data: " + path});
+            }
+            node.children[side] = child;
+        }
+        m_nodes.push_back(node);
+    }
+
+    m_headNode = models[0].headNodes[0];
+    if (m_headNode < 0 || m_headNode >= nodeCount) {
+        clear();
+        return std::unexpected(Error{"Invalid world head node: " + path});
+    }
+
+    m_leafCount = leaves.size();
+    m_visLeafCount = std::min(models[0].visLeafs, leafCount - 1);
+
+    // Decompress the PVS: a zero byte is followed by a count of zero bytes
+    if (!visData.empty() && m_visLeafCount > 0) {
+        const size_t rowBytes = (static_cast<size_t>(m_visLeafCount) + 7) / 8;
+        m_rowWords = (rowBytes + 7) / 8;
+        m_pvs.assign(m_leafCount * m_rowWords, 0);
+        m_hasRow.assign(m_leafCount, 0);
+
+        for (size_t leaf = 1; leaf < m_leafCount; ++leaf) {
+            const i32 offset = leaves[leaf].visOffset;
+            if (offset < 0 || static_cast<size_t>(offset) >= visData.size()) {
+                continue;
+            }
+
+            u64* row = &m_pvs[leaf * m_rowWords];
+            size_t in = static_cast<size_t>(offset);
+            size_t out = 0;
+            while (out < rowBytes && in < visData.size()) {
+                u8 value = visData[in++];
+                if (value) {
+                    row[out >> 3] |= static_cast<u64>(value) << ((out & 7) * 8);
+                    ++out;
+                    continue;
+                }
+                if (in >= visData.size()) {
+                    break;
+                }
+                out += visData[in++];
+            }
+            m_hasRow[leaf] = 1;
+        }
+    }
+
+    LOG_INFO("Loaded BSP visibility: {} leaves, {} vis leaves, {} KB PVS",
+             m_leafCount, m_visLeafCount, m_pvs.size() * sizeof(u64) / 1024);
+
+    return {};
+}
+
+Result<void> MapVisibility::load(const cooked::CookedMapView& view) {
+    clear();
+
+    const std::string& path = view.getPath();
+    const auto* info = view.getRecord<cooked::CookedVisInfo>(cooked::SECTION_VIS_INFO);
+    const auto planes = view.getSection<cooked::CookedPlane>(cooked::SECTION_VIS_PLANES);
+    const auto nodes = view.getSection<cooked::CookedVisNode>(cooked::SECTION_VIS_NODES);
+    const auto pvs = view.getSection<u64>(cooked::SECTION_PVS);
+    const std::span<const u8> hasRow = view.getSectionBytes(cooked::SECTION_PVS_ROWS);
+
+    if (!info || nodes.empty()) {
+        return std::unexpected(Error{"Cooked map has no world tree: " + path});
+    }
+
+    const i32 planeCount = static_cast<i32>(planes.size());
+    const i32 nodeCount = static_cast<i32>(nodes.size());
+    const i32 leafCount = static_cast<i32>(info->leafCount);
+
+    m_planes.reserve(planes.size());
+    for (const auto& p : planes) {
+        Plane plane;
+        plane.normal = Vec3(p.normal[0], p.normal[1], p.normal[2]);
+        plane.dist = p.dist;
+        plane.type = p.type;
+        m_planes.push_back(plane);
+    }
+
+    m_nodes.reserve(nodes.size());
+    for (const auto& n : nodes) {
+        if (n.planeIndex < 0 || n.planeIndex >= planeCount) {
+            clear();
+            return std::unexpected(Error{"Corrupt cooked node data: " + path});
+        }
+
+        Node node;
+        node.planeIndex = n.planeIndex;
+        for (i32 side = 0; side < 2; ++side) {
+            const i32 child = n.children[side];
+            if (child >= nodeCount || (child < 0 && -1 - child >= leafCount)) {
+                clear();
+                return std::unexpected(Error{"Corrupt cooked node data: " + path});
+            }
+            node.children[side] = child;
+        }
+        m_nodes.push_back(node);
+    }
+
+    m_headNode = info->headNode;
+    if (m_headNode < 0 || m_headNode >= nodeCount || info->visLeafCount >= leafCount) {
+        clear();
+        return std::unexpected(Error{"Invalid cooked visibility info: " + path});
+    }
+
+    m_leafCount = info->leafCount;
+    m_visLeafCount = info->visLeafCount;
+
+    // Rows are stored decompressed, only their shape needs checking
+    if (!pvs.empty()) {
+        m_rowWords = info->rowWords;
+        const size_t neededWords = (static_cast<size_t>(std::max(m_visLeafCount, 0)) + 63) / 64;
+        if (m_rowWords < neededWords || pvs.size() != m_leafCount * m_rowWords || hasRow.size() != m_leafCount) {
+            clear();
+            return std::unexpected(Error{"Corrupt cooked PVS: " + path});
+        }
+        m_pvs.assign(pvs.begin(), pvs.end());
+        m_hasRow.assign(hasRow.begin(), hasRow.end());
+    }
+
+    LOG_INFO("Loaded cooked visibility: {} leaves, {} vis leaves, {} KB PVS",
+             m_leafCount, m_visLeafCount, m_pvs.size() * sizeof(u64) / 1024);
+
+    return {};
+}
+
+void MapVisibility::cook(cooked::CookedMapWriter& writer) const {
+    cooked::CookedVisInfo info{};
+    info.headNode = m_headNode;
+    info.visLeafCount = m_visLeafCount;
+    info.leafCount = static_cast<u32>(m_leafCount);
+    info.rowWords = static_cast<u32>(m_rowWords);
+
+    std::vector<cooked::CookedPlane> planes;
+    planes.reserve(m_planes.size());
+    for (const auto& p : m_planes) {
+        planes.push_back({{p.normal.x, p.normal.y, p.normal.z}, p.dist, p.type});
+    }
+
+    std::vector<cooked::CookedVisNode> nodes;
+    nodes.reserve(m_nodes.size());
+    for (const auto& n : m_nodes) {
+        nodes.push_back({n.planeIndex, {n.children[0], n.children[1]}});
+    }
+
+    writer.setRecord(cooked::SECTION_VIS_INFO, info);
+    writer.setSection(cooked::SECTION_VIS_PLANES, std::span<const cooked::CookedPlane>(planes));
+    writer.setSection(cooked::SECTION_VIS_NODES, std::span<const cooked::CookedVisNode>(nodes));
+    writer.setSection(cooked::SECTION_PVS, std::span<const u64>(m_pvs));
+    writer.setSection(cooked::SECTION_PVS_ROWS, std::span<const u8>(m_hasRow));
+}
+
+void MapVisibility::clear() {
+    m_planes.clear();
+    m_nodes.clear();
+    m_headNode = 0;
+    m_leafCount = 0;
+    m_visLeafCount = 0;
+    m_rowWords = 0;
+    m_pvs.clear();
+    m_hasRow.clear();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+i32 MapVisibility::findLeaf(Vec3 point) const {
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+    i32 num = m_headNode;
+    while (num >= 0) {
+        const Node& node = m_nodes[num];
+        const Plane& plane = m_planes[node.planeIndex];
+        f32 d = (plane.type < 3) ? point[plane.type] - plane.dist
+                                 : glm::dot(plane.normal, point) - plane.dist;
+        num = node.children[d > 0.0f ? 0 : 1];
+    }
+    return -1 - num;
+}
+
+u32 MapVisibility::findTouchedLeaves(Vec3 mins, Vec3 maxs, i32* leaves) const {
+    u32 count = 0;
+    if (!m_nodes.empty()) {
+        touchLeaves(m_headNode, mins, maxs, leaves, count);
+    }
+    return std::min(count, MAX_ENTITY_LEAVES + 1);
+}
+
+void MapVisibility::touchLeaves(i32 num, Vec3 mins, Vec3 maxs, i32* leaves, u32& count) const {
+    while (num >= 0) {
+        if (count > MAX_ENTITY_LEAVES) {
+            return;
+        }
+
+        const Node& node = m_nodes[num];
+        const Plane& plane = m_planes[node.planeIndex];
+
+        f32 nearDist;
+        f32 farDist;
+        if (plane.type < 3) {
+            nearDist = mins[plane.type];
+            farDist = maxs[plane.type];
+        } else {
+            // Box corners closest to and farthest along the normal
+            nearDist = 0.0f;
+            farDist = 0.0f;
+            for (i32 axis = 0; axis < 3; ++axis) {
+                f32 n = plane.normal[axis];
+                nearDist += n * (n >= 0.0f ? mins[axis] : maxs[axis]);
+                farDist += n * (n >= 0.0f ? maxs[axis] : mins[axis]);
+            }
+        }
+
+        const bool front = farDist > plane.dist;
+        const bool back = nearDist <= plane.dist;
+
+        if (front && back) {
+            touchLeaves(node.children[0], mins, maxs, leaves, count);
+            num = node.children[1];
+        } else {
+            num = node.children[front ? 0 : 1];
+        }
+    }
+
+    const i32 leaf = -1 - num;
+    if (leaf == 0) {
+        return;     // Solid
+    }
+    if (count < MAX_ENTITY_LEAVES) {
+        leaves[count] = leaf;
+    }
+    ++count;
+}
+
+const u64* MapVisibility::getPVS(i32 leaf) const {
+    if (m_pvs.empty() || leaf <= 0 || static_cast<size_t>(leaf) >= m_leafCount || !m_hasRow[leaf]) {
+        return nullptr;
+    }
+    return &m_pvs[static_cast<size_t>(leaf) * m_rowWords];
+}
+
+} // namespace cscpp::network
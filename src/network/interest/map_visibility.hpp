@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file map_visibility.hpp
+ * @brief BSP leaf lookup and potentially visible sets (PVS)
+ *
+ * Loads the render node tree and LUMP_VISIBILITY of a GoldSrc BSP and
+ * decompresses the run-length encoded PVS into one bit row per leaf, so a
+ * visibility test is a single bit lookup. Read-only after loading and safe
+ * to query from any number of threads.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cscpp::assets::bsp {
+class BSPView;
+}
+
+namespace cscpp::assets::cooked {
+class CookedMapView;
+class CookedMapWriter;
+}
+
+namespace cscpp::network {
+
+class MapVisibility {
+public:
+    /// Leaves an entity may touch before it is treated as visible everywhere
+    static constexpr u32 MAX_ENTITY_LEAVES = 16;
+
+    /**
+     * @brief Load nodes, leaves and visibility data from a BSP file
+     */
+    Result<void> loadFromFile(const std::string& path);
+
+    /// Same, from a map already opened for other loaders (nothing is kept referenced)
+    Result<void> load(const assets::bsp::BSPView& view);
+
+    /// Load the tree and the already decompressed PVS stored by cook()
+    Result<void> load(const assets::cooked::CookedMapView& view);
+
+    /// Store the loaded tree and decompressed PVS in a cooked map
+    void cook(assets::cooked::CookedMapWriter& writer) const;
+
+    void clear();
+
+    bool isLoaded() const { return !m_nodes.empty(); }
+
+    /// True if the map was compiled with vis (otherwise everything is visible)
+    bool hasVisData() const { return !m_pvs.empty(); }
+
+    /// Leaf containing a point (0 = solid)
+    i32 findLeaf(Vec3 point) const;
+
+    /**
+     * @brief Leaves touched by a box
+     * @return Number of leaves written, or MAX_ENTITY_LEAVES + 1 if the box
+     *         touches more than fit (treat as visible from everywhere)
+     */
+    u32 findTouchedLeaves(Vec3 mins, Vec3 maxs, i32* leaves) const;
+
+    /**
+     * @brief PVS row of a leaf
+     * @return nullptr if no vis data is available for the leaf (all visible)
+     */
+    const u64* getPVS(i32 leaf) const;
+
+    /// Test a leaf against a PVS row from getPVS()
+    bool isLeafVisible(const u64* pvs, i32 leaf) const {
+        if (!pvs || leaf <= 0 || leaf > m_visLeafCount) {
+            return true;
+        }
+        const u32 bit = static_cast<u32>(leaf - 1);
+        return (pvs[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+    size_t getLeafCount() const { return m_leafCount; }
+
+private:
+    struct Plane {
+        Vec3 normal{0.0f};
+        f32 dist = 0.0f;
+        i32 type = 0;
+    };
+
+    /// children >= 0 index m_nodes, < 0 are -(leaf + 1)
+    struct Node {
+        i32 planeIndex = 0;
+        i32 children[2] = {-1, -1};
+    };
+
+    void touchLeaves(i32 node, Vec3 mins, Vec3 maxs, i32* leaves, u32& count) const;
+
+    std::vector<Plane> m_planes;
+    std::vector<Node> m_nodes;
+    i32 m_headNode = 0;
+    size_t m_leafCount = 0;
+    i32 m_visLeafCount = 0;         ///< Leaves covered by vis (1..m_visLeafCount)
+
+    size_t m_rowWords = 0;
+    std::vector<u64> m_pvs;         ///< m_leafCount rows of m_rowWords
+    std::vector<u8> m_hasRow;       ///< Leaf has compressed vis data
+};
+
+} // namespace cscpp::network
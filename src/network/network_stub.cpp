@@ -1,7 +0,0 @@
-// Stub file for network library
-// Implementation files will be added here
-
-namespace cscpp::network {
-    // Placeholder
-}
-
@@ -0,0 +1,145 @@
+#pragma once
+
+/**
+ * @file bit_buffer.hpp
+ * @brief Bit-level packet writer and reader
+ *
+ * Both classes work on caller-provided memory and never allocate. Bits are
+ * packed LSB first into little-endian bytes. Writes past the end of the
+ * buffer set an overflow flag instead of failing, so a serializer can write
+ * a whole record and check once afterwards.
+ */
+
+#include "core/types.hpp"
+
+#include <bit>
+
+namespace cscpp::network {
+
+// ============================================================================
+// Bit Writer
+// ============================================================================
+
+class BitWriter {
+public:
+    BitWriter(u8* data, size_t capacityBytes)
+        : m_data(data)
+        , m_capacityBits(capacityBytes * 8) {}
+
+    /// Write the low `bits` bits of value (1-32)
+    void writeBits(u32 value, u32 bits) {
+        if (m_bitPosition + bits > m_capacityBits) {
+            m_overflowed = true;
+            return;
+        }
+
+        if (bits < 32) {
+            value &= (1u << bits) - 1u;
+        }
+
+        // Merge into the partially filled byte, then store whole bytes
+        u64 scratch = static_cast<u64>(value) << (m_bitPosition & 7);
+        size_t byteIndex = m_bitPosition >> 3;
+        if (m_bitPosition & 7) {
+            scratch |= m_data[byteIndex] & ((1u << (m_bitPosition & 7)) - 1u);
+        }
+
+        u32 totalBits = static_cast<u32>(m_bitPosition & 7) + bits;
+        for (u32 written = 0; written < totalBits; written += 8) {
+            m_data[byteIndex++] = static_cast<u8>(scratch);
+            scratch >>= 8;
+        }
+
+        m_bitPosition += bits;
+    }
+
+    void writeBool(bool value) { writeBits(value ? 1u : 0u, 1); }
+    void writeU8(u8 value) { writeBits(value, 8); }
+    void writeU16(u16 value) { writeBits(value, 16); }
+    void writeU32(u32 value) { writeBits(value, 32); }
+    void writeFloat(f32 value) { writeBits(std::bit_cast<u32>(value), 32); }
+
+    /// Current position, usable with rewind()
+    size_t getBitPosition() const { return m_bitPosition; }
+
+    /**
+     * @brief Drop everything written after `bitPosition`
+     *
+     * Clears the overflow flag; used to back out a record that did not fit.
+     */
+    void rewind(size_t bitPosition) {
+        m_bitPosition = bitPosition;
+        m_overflowed = false;
+    }
+
+    size_t getBitsRemaining() const { return m_capacityBits - m_bitPosition; }
+
+    /// Bytes touched so far (trailing bits of the last byte are zero padded)
+    size_t getBytesWritten() const { return (m_bitPosition + 7) / 8; }
+
+    bool hasOverflowed() const { return m_overflowed; }
+
+    const u8* getData() const { return m_data; }
+
+private:
+    u8* m_data;
+    size_t m_capacityBits;
+    size_t m_bitPosition = 0;
+    bool m_overflowed = false;
+};
+
+// ============================================================================
+// Bit Reader
+// ============================================================================
+
+class BitReader {
+public:
+    BitReader(const u8* data, size_t sizeBytes)
+        : m_data(data)
+        , m_sizeBits(sizeBytes * 8) {}
+
+    /// Read `bits` bits (1-32). Returns 0 and sets the overflow flag past the end.
+    u32 readBits(u32 bits) {
+        if (m_bitPosition + bits > m_sizeBits) {
+            m_overflowed = true;
+            m_bitPosition = m_sizeBits;
+            return 0;
+        }
+
+        size_t byteIndex = m_bitPosition >> 3;
+        u32 shift = static_cast<u32>(m_bitPosition & 7);
+        u32 totalBits = shift + bits;
+
+        u64 scratch = 0;
+        for (u32 read = 0; read < totalBits; read += 8) {
+            scratch |= static_cast<u64>(m_data[byteIndex++]) << read;
+        }
+
+        m_bitPosition += bits;
+
+        u64 mask = (u64{1} << bits) - 1u;
+        return static_cast<u32>((scratch >> shift) & mask);
+    }
+
+    bool readBool() { return readBits(1) != 0; }
+    u8 readU8() { return static_cast<u8>(readBits(8)); }
+    u16 readU16() { return static_cast<u16>(readBits(16)); }
+    u32 readU32() { return readBits(32); }
+    f32 readFloat() { return std::bit_cast<f32>(readBits(32)); }
+
+    size_t getBitPosition() const { return m_bitPosition; }
+    size_t getBitsRemaining() const { return m_sizeBits - m_bitPosition; }
+
+    bool hasOverflowed() const { return m_overflowed; }
+
+    /// Flag malformed input; handled like running out of data
+    void setOverflowed() { m_overflowed = true; }
+
+private:
+    const u8* m_data;
+    size_t m_sizeBits;
+    size_t m_bitPosition = 0;
+    bool m_overflowed = false;
+};
+
+} // namespace cscpp::network
@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @file message_schemas.hpp
+ * @brief Wire layouts of the protocol messages
+ *
+ * Ticks and counters are varints, angles 16 bits, positions and velocities
+ * quantized, strings length-prefixed.
+ */
+
+#include "network/protocol/messages.hpp"
+#include "network/protocol/serialization.hpp"
+
+namespace cscpp::network {
+
+namespace codec {
+
+/// World coordinates, ~1/64 unit over +-8192
+using WorldPosition = QuantizedVec3<-8192.0f, 8192.0f, 20>;
+
+/// Velocities, 1/16 unit/s over +-2048 (movement clamps to maxVelocity)
+using WorldVelocity = QuantizedVec3<-2048.0f, 2048.0f, 16>;
+
+/// Normalized move axis (-1..1), zero is exact
+using MoveAxis = Quantized<-1.0f, 1.0f, 8>;
+
+} // namespace codec
+
+// ============================================================================
+// Connection Messages
+// ============================================================================
+
+template<>
+struct MessageSchema<ClientConnectMsg> {
+    using Fields = FieldList<
+        Field<&ClientConnectMsg::protocolVersion, codec::VarUInt>,
+        Field<&ClientConnectMsg::playerName, codec::String>,
+        Field<&ClientConnectMsg::passwordHash, codec::Bytes>
+    >;
+};
+
+template<>
+struct MessageSchema<ServerAcceptMsg> {
+    using Fields = FieldList<
+        Field<&ServerAcceptMsg::clientId, codec::Integer>,
+        Field<&ServerAcceptMsg::serverTick, codec::VarUInt>,
+        Field<&ServerAcceptMsg::tickRate, codec::VarUInt>,
+        Field<&ServerAcceptMsg::snapshotRate, codec::VarUInt>,
+        Field<&ServerAcceptMsg::mapName, codec::String>,
+        Field<&ServerAcceptMsg::gameMode, codec::Integer>
+    >;
+};
+
+template<>
+struct MessageSchema<ServerRejectMsg> {
+    using Fields = FieldList<
+        Field<&ServerRejectMsg::reason, codec::UInt<3>>,
+        Field<&ServerRejectMsg::message, codec::String>
+    >;
+};
+
+template<>
+struct MessageSchema<DisconnectMsg> {
+    using Fields = FieldList<
+        Field<&DisconnectMsg::reason, codec::UInt<3>>,
+        Field<&DisconnectMsg::message, codec::String>
+    >;
+};
+
+// ============================================================================
+// Input Messages
+// ============================================================================
+
+template<>
+struct MessageSchema<UserCmd> {
+    using Fields = FieldList<
+        Field<&UserCmd::tick, codec::VarUInt>,
+        Field<&UserCmd::viewAngles, codec::Angles16>,
+        Field<&UserCmd::forwardMove, codec::MoveAxis>,
+        Field<&UserCmd::sideMove, codec::MoveAxis>,
+        Field<&UserCmd::buttons, codec::Integer>
+    >;
+};
+
+template<>
+struct MessageSchema<UserCmdMsg> {
+    using Fields = FieldList<
+        Field<&UserCmdMsg::clientTick, codec::VarUInt>,
+        Field<&UserCmdMsg::lastReceivedServerTick, codec::VarUInt>,
+        Field<&UserCmdMsg::cmds, codec::Array<codec::Nested, MAX_PENDING_COMMANDS>>
+    >;
+
+    /// cmdCount is implied by the array length
+    static void finishRead(UserCmdMsg& msg) {
+        msg.cmdCount = static_cast<u8>(msg.cmds.size());
+    }
+};
+
+template<>
+struct MessageSchema<ClientAckMsg> {
+    using Fields = FieldList<
+        Field<&ClientAckMsg::lastReceivedServerTick, codec::VarUInt>,
+        Field<&ClientAckMsg::snapshotAckBits, codec::UInt<32>>
+    >;
+};
+
+// ============================================================================
+// Snapshot Messages
+// ============================================================================
+
+/// Complete entity state (delta snapshots send a subset of these fields)
+template<>
+struct MessageSchema<EntityState> {
+    using Fields = FieldList<
+        Field<&EntityState::networkId, codec::VarUInt>,
+        Field<&EntityState::position, codec::WorldPosition>,
+        Field<&EntityState::velocity, codec::WorldVelocity>,
+        Field<&EntityState::angles, codec::Angles16>,
+        Field<&EntityState::flags, codec::Integer>,
+        Field<&EntityState::health, codec::Integer>,
+        Field<&EntityState::weaponId, codec::Integer>,
+        Field<&EntityState::animSequence, codec::Integer>,
+        Field<&EntityState::animFrame, codec::Float>
+    >;
+};
+
+template<>
+struct MessageSchema<EntityDelta> {
+    using Fields = FieldList<
+        Field<&EntityDelta::networkId, codec::VarUInt>,
+        Field<&EntityDelta::updateType, codec::UInt<2>>,
+        Field<&EntityDelta::changedFields, codec::VarUInt>,
+        Field<&EntityDelta::data, codec::Array<codec::UInt<8>, MAX_PACKET_SIZE>>
+    >;
+};
+
+template<>
+struct MessageSchema<SnapshotMsg> {
+    using Fields = FieldList<
+        Field<&SnapshotMsg::serverTick, codec::VarUInt>,
+        Field<&SnapshotMsg::clientTickAck, codec::VarUInt>,
+        Field<&SnapshotMsg::sequenceNumber, codec::Integer>,
+        Field<&SnapshotMsg::baselineId, codec::VarUInt>,
+        Field<&SnapshotMsg::entities, codec::Array<codec::Nested, MAX_SNAPSHOT_ENTITIES>>
+    >;
+};
+
+// ============================================================================
+// Game Event Messages
+// ============================================================================
+
+template<>
+struct MessageSchema<GameEventMsg> {
+    using Fields = FieldList<
+        Field<&GameEventMsg::eventType, codec::VarUInt>,
+        Field<&GameEventMsg::eventTick, codec::VarUInt>,
+        Field<&GameEventMsg::eventData, codec::Array<codec::UInt<8>, MAX_EVENT_DATA_SIZE>>
+    >;
+};
+
+template<>
+struct MessageSchema<ChatMsg> {
+    using Fields = FieldList<
+        Field<&ChatMsg::senderId, codec::Integer>,
+        Field<&ChatMsg::teamOnly, codec::Bool>,
+        Field<&ChatMsg::message, codec::String>
+    >;
+};
+
+// ============================================================================
+// Voice Messages
+// ============================================================================
+
+template<>
+struct MessageSchema<VoiceDataMsg> {
+    using Fields = FieldList<
+        Field<&VoiceDataMsg::speakerId, codec::Integer>,
+        Field<&VoiceDataMsg::compressedAudio, codec::Array<codec::UInt<8>, MAX_VOICE_DATA_SIZE>>
+    >;
+
+    /// dataSize is implied by the payload length
+    static void finishRead(VoiceDataMsg& msg) {
+        msg.dataSize = static_cast<u16>(msg.compressedAudio.size());
+    }
+};
+
+} // namespace cscpp::network
@@ -5,11 +5,18 @@
  * @brief Network message definitions
  * 
  * Defines all message types used for client-server communication.
+ *
+ * Variable-length payloads are std::pmr vectors. A message reused across
+ * packets can keep the default resource and its capacity; a message that
+ * lives for one packet or tick takes a FrameArena in its constructor so
+ * decoding and encoding it never touch the heap.
  */
 
 #include "core/types.hpp"
 #include "core/math/math.hpp"
 #include "core/platform/input.hpp"
+#include <memory_resource>
+#include <utility>
 #include <vector>
 
 namespace cscpp::network {
@@ -135,10 +142,13 @@ struct DisconnectMsg {
 struct UserCmdMsg {
     static constexpr MessageId ID = MessageId::UserCmd;
     
+    UserCmdMsg() = default;
+    explicit UserCmdMsg(std::pmr::memory_resource* memory) : cmds(memory) {}
+    
     Tick clientTick;
     Tick lastReceivedServerTick;
     u8 cmdCount;
-    std::vector<UserCmd> cmds;
+    std::pmr::vector<UserCmd> cmds;
 };
 
 struct ClientAckMsg {
@@ -165,6 +175,22 @@ struct EntityState {
 };
 
 struct EntityDelta {
+    // Allocator-aware, so deltas created inside a SnapshotMsg's vector use its resource
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
+    EntityDelta() = default;
+    EntityDelta(const EntityDelta&) = default;
+    EntityDelta(EntityDelta&&) = default;
+    EntityDelta& operator=(const EntityDelta&) = default;
+    EntityDelta& operator=(EntityDelta&&) = default;
+    explicit EntityDelta(const allocator_type& allocator) : data(allocator) {}
+    EntityDelta(const EntityDelta& other, const allocator_type& allocator)
+        : networkId(other.networkId), updateType(other.updateType), changedFields(other.changedFields),
+          data(other.data, allocator) {}
+    EntityDelta(EntityDelta&& other, const allocator_type& allocator)
+        : networkId(other.networkId), updateType(other.updateType), changedFields(other.changedFields),
+          data(std::move(other.data), allocator) {}
+    
     NetworkId networkId;
     
     enum class UpdateType : u8 {
@@ -176,17 +202,20 @@ struct EntityDelta {
     
     UpdateType updateType;
     u32 changedFields;
-    std::vector<u8> data;  // Serialized changed fields
+    std::pmr::vector<u8> data;  // Serialized changed fields
 };
 
 struct SnapshotMsg {
     static constexpr MessageId ID = MessageId::Snapshot;
     
+    SnapshotMsg() = default;
+    explicit SnapshotMsg(std::pmr::memory_resource* memory) : entities(memory) {}
+    
     Tick serverTick;
     Tick clientTickAck;
     SequenceNumber sequenceNumber;
     u32 baselineId;
-    std::vector<EntityDelta> entities;
+    std::pmr::vector<EntityDelta> entities;
 };
 
 // ============================================================================
@@ -211,9 +240,12 @@ struct GameEventMsg {
         BuyZoneLeave = 12,
     };
     
+    GameEventMsg() = default;
+    explicit GameEventMsg(std::pmr::memory_resource* memory) : eventData(memory) {}
+    
     EventType eventType;
     Tick eventTick;
-    std::vector<u8> eventData;
+    std::pmr::vector<u8> eventData;
 };
 
 struct ChatMsg {
@@ -231,9 +263,12 @@ struct ChatMsg {
 struct VoiceDataMsg {
     static constexpr MessageId ID = MessageId::VoiceData;
     
+    VoiceDataMsg() = default;
+    explicit VoiceDataMsg(std::pmr::memory_resource* memory) : compressedAudio(memory) {}
+    
     ClientId speakerId;
     u16 dataSize;
-    std::vector<u8> compressedAudio;  // Opus encoded
+    std::pmr::vector<u8> compressedAudio;  // Opus encoded
 };
 
 // ============================================================================
@@ -259,6 +294,8 @@ constexpr u32 PROTOCOL_VERSION = 1;
 constexpr u32 MAX_PACKET_SIZE = 1400;  // MTU safe size
 constexpr u32 MAX_SNAPSHOT_ENTITIES = 256;
 constexpr u32 MAX_PENDING_COMMANDS = 64;
+constexpr u32 MAX_EVENT_DATA_SIZE = 256;
+constexpr u32 MAX_VOICE_DATA_SIZE = 512;
 
 } // namespace cscpp::network
 
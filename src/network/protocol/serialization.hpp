@@ -0,0 +1,414 @@
+#pragma once
+
+/**
+ * @file serialization.hpp
+ * @brief Compile-time field descriptors for bit-packed messages
+ *
+ * A message is described once by specializing MessageSchema<T> with a
+ * FieldList of Field<&T::member, Codec> entries. writeFields()/readFields()
+ * expand the list at compile time and move each member straight between the
+ * struct and the bit stream, with no intermediate buffers.
+ *
+ * Codecs are stateless types with static write()/read(). Lossy codecs also
+ * provide quantize(), which rounds a value to exactly what read() would
+ * return, so senders can keep delta baselines in sync with receivers.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "network/protocol/bit_buffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cscpp::network {
+
+// ============================================================================
+// Schema Machinery
+// ============================================================================
+
+/// One serialized member
+template<auto Member, typename Codec>
+struct Field {
+    template<typename T>
+    static void write(BitWriter& writer, const T& object) {
+        Codec::write(writer, object.*Member);
+    }
+
+    template<typename T>
+    static void read(BitReader& reader, T& object) {
+        Codec::read(reader, object.*Member);
+    }
+};
+
+/// Ordered list of fields, written front to back
+template<typename... Fields>
+struct FieldList {
+    template<typename T>
+    static void write(BitWriter& writer, const T& object) {
+        (Fields::write(writer, object), ...);
+    }
+
+    template<typename T>
+    static void read(BitReader& reader, T& object) {
+        (Fields::read(reader, object), ...);
+    }
+};
+
+/**
+ * @brief Wire layout of T
+ *
+ * Specializations provide `using Fields = FieldList<...>` and may provide
+ * `static void finishRead(T&)` to fill members implied by others (counts).
+ */
+template<typename T>
+struct MessageSchema;
+
+/// Serialize every field of `object`
+template<typename T>
+void writeFields(BitWriter& writer, const T& object) {
+    MessageSchema<T>::Fields::write(writer, object);
+}
+
+/// Deserialize every field of `object`; check reader.hasOverflowed() afterwards
+template<typename T>
+void readFields(BitReader& reader, T& object) {
+    MessageSchema<T>::Fields::read(reader, object);
+    if constexpr (requires { MessageSchema<T>::finishRead(object); }) {
+        MessageSchema<T>::finishRead(object);
+    }
+}
+
+/// Write the message id followed by the fields
+template<typename T>
+void writeMessage(BitWriter& writer, const T& message) {
+    writer.writeU8(static_cast<u8>(T::ID));
+    writeFields(writer, message);
+}
+
+/**
+ * @brief Read a message written by writeMessage()
+ * @return false if the id does not match or the data is truncated/malformed
+ */
+template<typename T>
+bool readMessage(BitReader& reader, T& message) {
+    if (reader.readU8() != static_cast<u8>(T::ID)) {
+        return false;
+    }
+    readFields(reader, message);
+    return !reader.hasOverflowed();
+}
+
+// ============================================================================
+// Codecs
+// ============================================================================
+
+namespace codec {
+
+namespace detail {
+
+template<typename V>
+using WireInt = typename std::conditional_t<std::is_enum_v<V>, std::underlying_type<V>, std::type_identity<V>>::type;
+
+} // namespace detail
+
+/// Unsigned integer or enum in a fixed number of bits (1-32)
+template<u32 Bits>
+struct UInt {
+    static_assert(Bits >= 1 && Bits <= 32);
+
+    template<typename V>
+    static void write(BitWriter& writer, const V& value) {
+        writer.writeBits(static_cast<u32>(static_cast<detail::WireInt<V>>(value)), Bits);
+    }
+
+    template<typename V>
+    static void read(BitReader& reader, V& value) {
+        value = static_cast<V>(static_cast<detail::WireInt<V>>(reader.readBits(Bits)));
+    }
+};
+
+/// Integer or enum at its full width
+struct Integer {
+    template<typename V>
+    static void write(BitWriter& writer, const V& value) {
+        static_assert(sizeof(V) <= 4, "Use VarUInt for wider integers");
+        writer.writeBits(static_cast<u32>(static_cast<detail::WireInt<V>>(value)), sizeof(V) * 8);
+    }
+
+    template<typename V>
+    static void read(BitReader& reader, V& value) {
+        value = static_cast<V>(static_cast<detail::WireInt<V>>(reader.readBits(sizeof(V) * 8)));
+    }
+};
+
+struct Bool {
+    static void write(BitWriter& writer, bool value) { writer.writeBool(value); }
+    static void read(BitReader& reader, bool& value) { value = reader.readBool(); }
+};
+
+/// Raw 32-bit float
+struct Float {
+    static void write(BitWriter& writer, f32 value) { writer.writeFloat(value); }
+    static void read(BitReader& reader, f32& value) { value = reader.readFloat(); }
+};
+
+/**
+ * @brief Variable-length unsigned integer (ticks, counters)
+ *
+ * 7-bit groups, each followed by a continuation bit. Values are truncated
+ * to 32 bits.
+ */
+struct VarUInt {
+    static constexpr u32 GROUP_BITS = 7;
+
+    template<typename V>
+    static void write(BitWriter& writer, const V& value) {
+        u32 remaining = static_cast<u32>(static_cast<detail::WireInt<V>>(value));
+        do {
+            writer.writeBits(remaining, GROUP_BITS);
+            remaining >>= GROUP_BITS;
+            writer.writeBool(remaining != 0);
+        } while (remaining != 0);
+    }
+
+    template<typename V>
+    static void read(BitReader& reader, V& value) {
+        u32 result = 0;
+        for (u32 shift = 0; shift < 32; shift += GROUP_BITS) {
+            result |= reader.readBits(GROUP_BITS) << shift;
+            if (!reader.readBool()) {
+                value = static_cast<V>(static_cast<detail::WireInt<V>>(result));
+                return;
+            }
+        }
+        reader.setOverflowed();
+        value = V{};
+    }
+};
+
+/**
+ * @brief Scalar quantized uniformly over [Min, Max] (values are clamped)
+ *
+ * Uses an odd number of levels so Min, Max and the midpoint (zero for a
+ * symmetric range) decode exactly.
+ */
+template<f32 Min, f32 Max, u32 Bits>
+struct Quantized {
+    static_assert(Max > Min && Bits >= 2 && Bits <= 24);
+
+    static constexpr u32 MAX_STEP = (1u << Bits) - 2u;
+    static constexpr f32 TO_STEPS = static_cast<f32>(MAX_STEP) / (Max - Min);
+
+    static u32 toSteps(f32 value) {
+        f32 clamped = std::isnan(value) ? Min : std::fmin(std::fmax(value, Min), Max);
+        return static_cast<u32>(std::lround((clamped - Min) * TO_STEPS));
+    }
+
+    static f32 fromSteps(u32 steps) {
+        steps = std::min(steps, MAX_STEP);
+        return (Min * static_cast<f32>(MAX_STEP - steps) + Max * static_cast<f32>(steps)) /
+               static_cast<f32>(MAX_STEP);
+    }
+
+    template<typename V>
+    static void write(BitWriter& writer, const V& value) {
+        writer.writeBits(toSteps(static_cast<f32>(value)), Bits);
+    }
+
+    template<typename V>
+    static void read(BitReader& reader, V& value) {
+        value = static_cast<V>(fromSteps(reader.readBits(Bits)));
+    }
+
+    template<typename V>
+    static void quantize(V& value) {
+        value = static_cast<V>(fromSteps(toSteps(static_cast<f32>(value))));
+    }
+};
+
+/// Vec3 with each component quantized over [Min, Max]
+template<f32 Min, f32 Max, u32 Bits>
+struct QuantizedVec3 {
+    using Component = Quantized<Min, Max, Bits>;
+
+    static void write(BitWriter& writer, const Vec3& value) {
+        Component::write(writer, value.x);
+        Component::write(writer, value.y);
+        Component::write(writer, value.z);
+    }
+
+    static void read(BitReader& reader, Vec3& value) {
+        Component::read(reader, value.x);
+        Component::read(reader, value.y);
+        Component::read(reader, value.z);
+    }
+
+    static void quantize(Vec3& value) {
+        Component::quantize(value.x);
+        Component::quantize(value.y);
+        Component::quantize(value.z);
+    }
+};
+
+/**
+ * @brief Angle in degrees packed to 16 bits
+ *
+ * Angles wrap, so the decoded value is in [0, 360).
+ */
+struct Angle16 {
+    static constexpr f32 TO_STEPS = 65536.0f / 360.0f;
+    static constexpr f32 TO_DEGREES = 360.0f / 65536.0f;
+
+    static u32 toSteps(f32 degrees) {
+        if (!std::isfinite(degrees)) {
+            return 0;
+        }
+        return static_cast<u32>(std::lround(degrees * TO_STEPS)) & 0xFFFFu;
+    }
+
+    static void write(BitWriter& writer, f32 degrees) {
+        writer.writeBits(toSteps(degrees), 16);
+    }
+
+    static void read(BitReader& reader, f32& degrees) {
+        degrees = static_cast<f32>(reader.readBits(16)) * TO_DEGREES;
+    }
+
+    static void quantize(f32& degrees) {
+        degrees = static_cast<f32>(toSteps(degrees)) * TO_DEGREES;
+    }
+};
+
+/// Euler angles (pitch, yaw, roll), 16 bits each
+struct Angles16 {
+    static void write(BitWriter& writer, const Vec3& angles) {
+        Angle16::write(writer, angles.x);
+        Angle16::write(writer, angles.y);
+        Angle16::write(writer, angles.z);
+    }
+
+    static void read(BitReader& reader, Vec3& angles) {
+        Angle16::read(reader, angles.x);
+        Angle16::read(reader, angles.y);
+        Angle16::read(reader, angles.z);
+    }
+
+    static void quantize(Vec3& angles) {
+        Angle16::quantize(angles.x);
+        Angle16::quantize(angles.y);
+        Angle16::quantize(angles.z);
+    }
+};
+
+/**
+ * @brief Null-terminated char[N], sent as length + bytes
+ *
+ * At most N - 1 characters are sent; the decoded string is always terminated.
+ */
+struct String {
+    template<size_t N>
+    static constexpr u32 lengthBits() {
+        return static_cast<u32>(std::bit_width(N - 1));
+    }
+
+    template<size_t N>
+    static void write(BitWriter& writer, const char (&text)[N]) {
+        size_t length = 0;
+        while (length < N - 1 && text[length] != '\0') {
+            ++length;
+        }
+
+        writer.writeBits(static_cast<u32>(length), lengthBits<N>());
+        for (size_t i = 0; i < length; ++i) {
+            writer.writeU8(static_cast<u8>(text[i]));
+        }
+    }
+
+    template<size_t N>
+    static void read(BitReader& reader, char (&text)[N]) {
+        size_t length = reader.readBits(lengthBits<N>());
+        if (length > N - 1) {
+            reader.setOverflowed();
+            length = 0;
+        }
+
+        for (size_t i = 0; i < length; ++i) {
+            text[i] = static_cast<char>(reader.readU8());
+        }
+        text[length] = '\0';
+    }
+};
+
+/// Fixed-size byte array
+struct Bytes {
+    template<size_t N>
+    static void write(BitWriter& writer, const u8 (&data)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            writer.writeU8(data[i]);
+        }
+    }
+
+    template<size_t N>
+    static void read(BitReader& reader, u8 (&data)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            data[i] = reader.readU8();
+        }
+    }
+};
+
+/// Struct with its own MessageSchema
+struct Nested {
+    template<typename V>
+    static void write(BitWriter& writer, const V& value) {
+        writeFields(writer, value);
+    }
+
+    template<typename V>
+    static void read(BitReader& reader, V& value) {
+        readFields(reader, value);
+    }
+};
+
+/**
+ * @brief std::vector of up to MaxCount elements, each written with ElementCodec
+ *
+ * Reading resizes the vector in place, so a reused message keeps its capacity
+ * and a std::pmr::vector keeps allocating from its resource.
+ * Elements past MaxCount are not sent.
+ */
+template<typename ElementCodec, u32 MaxCount>
+struct Array {
+    static constexpr u32 COUNT_BITS = static_cast<u32>(std::bit_width(MaxCount));
+
+    template<typename E, typename Allocator>
+    static void write(BitWriter& writer, const std::vector<E, Allocator>& elements) {
+        u32 count = static_cast<u32>(std::min<size_t>(elements.size(), MaxCount));
+        writer.writeBits(count, COUNT_BITS);
+        for (u32 i = 0; i < count; ++i) {
+            ElementCodec::write(writer, elements[i]);
+        }
+    }
+
+    template<typename E, typename Allocator>
+    static void read(BitReader& reader, std::vector<E, Allocator>& elements) {
+        u32 count = reader.readBits(COUNT_BITS);
+        if (count > MaxCount) {
+            reader.setOverflowed();
+            count = 0;
+        }
+
+        elements.resize(count);
+        for (u32 i = 0; i < count && !reader.hasOverflowed(); ++i) {
+            ElementCodec::read(reader, elements[i]);
+        }
+    }
+};
+
+} // namespace codec
+
+} // namespace cscpp::network
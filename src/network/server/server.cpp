@@ -0,0 +1,379 @@
+/**
+ * @file server.cpp
+ * @brief UDP game server transport
+ */
+
+#include "network/server/server.hpp"
+#include "network/protocol/serialization.hpp"
+#include "network/protocol/message_schemas.hpp"
+#include "core/time/tick_pacer.hpp"
+#include "core/logging/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cscpp::network {
+
+namespace {
+
+/// Unreliable disconnect notices are repeated since nothing acks them
+constexpr u32 DISCONNECT_REDUNDANCY = 3;
+
+template<size_t N>
+void copyString(char (&out)[N], const char* text) {
+    std::strncpy(out, text ? text : "", N - 1);
+    out[N - 1] = '\0';
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// ClientConnection
+// ============================================================================
+
+ClientConnection::ClientConnection(ClientId id)
+    : m_clientId(id) {}
+
+// ============================================================================
+// Lifetime
+// ============================================================================
+
+Server::Server() = default;
+
+Server::~Server() {
+    stop();
+}
+
+Result<void> Server::start(const ServerConfig& config, ServerHandler* handler) {
+    if (m_running) {
+        return std::unexpected(Error{"Server already running"});
+    }
+    if (!handler) {
+        return std::unexpected(Error{"Server needs a handler"});
+    }
+    
+    m_config = config;
+    m_handler = handler;
+    
+    if (auto result = m_socket.open(config.port); !result) {
+        return result;
+    }
+    
+    // Everything the hot path touches is sized here
+    const u32 maxClients = static_cast<u32>(std::clamp(config.maxClients, 1, static_cast<i32>(INVALID_CLIENT_ID)));
+    m_pool = std::make_unique<PacketPool>(std::max(config.packetPoolSize, 1u));
+    m_outgoing.reserve(m_pool->getCapacity());
+    
+    m_receiveBuffers = std::make_unique<Datagram[]>(UdpSocket::MAX_BATCH);
+    m_receiveBatch.resize(UdpSocket::MAX_BATCH);
+    for (u32 i = 0; i < UdpSocket::MAX_BATCH; ++i) {
+        m_receiveBatch[i] = &m_receiveBuffers[i];
+    }
+    
+    m_clients.clear();
+    m_freeIds.clear();
+    m_clients.reserve(maxClients);
+    m_freeIds.reserve(maxClients);
+    for (u32 i = 0; i < maxClients; ++i) {
+        m_clients.push_back(std::make_unique<ClientConnection>(static_cast<ClientId>(i)));
+        m_freeIds.push_back(static_cast<ClientId>(maxClients - 1 - i));
+    }
+    m_addressToClient.clear();
+    m_addressToClient.reserve(maxClients * 2);
+    m_clientCount = 0;
+    m_handshake = std::make_unique<Connection>();
+    
+    m_running = true;
+    
+    LOG_INFO("Network server listening on UDP port {} ({} client slots)", m_socket.getLocalPort(), maxClients);
+    return {};
+}
+
+void Server::stop() {
+    if (!m_running) {
+        return;
+    }
+    
+    for (auto& client : m_clients) {
+        if (client->isConnected()) {
+            sendDisconnect(client->getId(), DisconnectMsg::Reason::ServerShutdown, "Server shutting down");
+        }
+    }
+    sendQueued();
+    
+    m_socket.close();
+    m_running = false;
+}
+
+// ============================================================================
+// Receiving
+// ============================================================================
+
+void Server::poll() {
+    if (!m_running) {
+        return;
+    }
+    
+    // Drain the socket a batch at a time
+    const i64 now = monotonicNanos();
+    for (;;) {
+        const u32 count = m_socket.receive(m_receiveBatch);
+        for (u32 i = 0; i < count; ++i) {
+            receiveDatagram(*m_receiveBatch[i], now);
+        }
+        if (count < m_receiveBatch.size()) {
+            break;
+        }
+    }
+    
+    checkTimeouts(now);
+}
+
+void Server::receiveDatagram(const Datagram& datagram, i64 now) {
+    auto it = m_addressToClient.find(datagram.address.toKey());
+    if (it == m_addressToClient.end()) {
+        acceptClient(datagram, now);
+        return;
+    }
+    
+    ClientConnection& client = *m_clients[it->second];
+    const ClientId clientId = client.getId();
+    bool quit = false;
+    
+    auto onReliable = [&](std::span<const u8> message) {
+        if (message.empty() || quit) {
+            return;
+        }
+        if (static_cast<MessageId>(message[0]) == MessageId::ClientDisconnect) {
+            quit = true;
+            return;
+        }
+        m_handler->onMessage(clientId, message, true);
+    };
+    
+    std::span<const u8> payload;
+    if (!client.getConnection().readPacket(std::span<const u8>(datagram.data.data(), datagram.size),
+                                           now, onReliable, payload)) {
+        return;
+    }
+    
+    // The handler may have kicked the client while handling a message
+    if (!client.isConnected()) {
+        return;
+    }
+    
+    if (!payload.empty() && !quit) {
+        if (static_cast<MessageId>(payload[0]) == MessageId::ClientDisconnect) {
+            quit = true;
+        } else {
+            m_handler->onMessage(clientId, payload, false);
+        }
+    }
+    
+    if (quit && client.isConnected()) {
+        removeClient(clientId, DisconnectMsg::Reason::UserQuit);
+    }
+}
+
+void Server::acceptClient(const Datagram& datagram, i64 now) {
+    // A connection starts with a packet whose first reliable message is ClientConnect
+    m_handshake->reset(datagram.address, now);
+    
+    ClientConnectMsg connect{};
+    bool hasConnect = false;
+    bool first = true;
+    auto onReliable = [&](std::span<const u8> message) {
+        if (first) {
+            BitReader reader(message.data(), message.size());
+            hasConnect = readMessage(reader, connect);
+            first = false;
+        }
+    };
+    
+    std::span<const u8> payload;
+    if (!m_handshake->readPacket(std::span<const u8>(datagram.data.data(), datagram.size),
+                                 now, onReliable, payload) || !hasConnect) {
+        return;
+    }
+    
+    if (connect.protocolVersion != PROTOCOL_VERSION) {
+        reject(ServerRejectMsg::Reason::VersionMismatch, "Protocol version mismatch", now);
+        return;
+    }
+    if (m_freeIds.empty()) {
+        reject(ServerRejectMsg::Reason::ServerFull, "Server is full", now);
+        return;
+    }
+    
+    const ClientId clientId = m_freeIds.back();
+    m_freeIds.pop_back();
+    
+    // Keep the handshake's sequence/ack state so the connect message stays acked
+    ClientConnection& client = *m_clients[clientId];
+    client.getConnection() = *m_handshake;
+    client.setConnected(true);
+    m_addressToClient[datagram.address.toKey()] = clientId;
+    ++m_clientCount;
+    
+    connect.playerName[sizeof(connect.playerName) - 1] = '\0';
+    LOG_INFO("Client {} connected from {} ({})", clientId, datagram.address.toString(), connect.playerName);
+    
+    m_handler->onClientConnected(clientId, connect);
+}
+
+void Server::reject(ServerRejectMsg::Reason reason, const char* message, i64 now) {
+    ServerRejectMsg msg{};
+    msg.reason = reason;
+    copyString(msg.message, message);
+    
+    u8 buffer[256];
+    BitWriter writer(buffer, sizeof(buffer));
+    writeMessage(writer, msg);
+    
+    queuePacket(*m_handshake, std::span<const u8>(buffer, writer.getBytesWritten()), now);
+    LOG_DEBUG("Rejected connection from {}: {}", m_handshake->getAddress().toString(), message);
+}
+
+void Server::checkTimeouts(i64 now) {
+    const i64 timeout = static_cast<i64>(static_cast<f64>(m_config.timeoutSeconds) * 1e9);
+    for (auto& client : m_clients) {
+        if (client->isConnected() && client->getConnection().isTimedOut(now, timeout)) {
+            LOG_INFO("Client {} timed out", client->getId());
+            removeClient(client->getId(), DisconnectMsg::Reason::Timeout);
+        }
+    }
+}
+
+// ============================================================================
+// Connections
+// ============================================================================
+
+ClientConnection* Server::findClient(ClientId clientId) const {
+    if (clientId >= m_clients.size() || !m_clients[clientId]->isConnected()) {
+        return nullptr;
+    }
+    return m_clients[clientId].get();
+}
+
+void Server::kickClient(ClientId clientId, const std::string& reason) {
+    if (findClient(clientId)) {
+        LOG_INFO("Kicked client {}: {}", clientId, reason);
+        sendDisconnect(clientId, DisconnectMsg::Reason::Kicked, reason.c_str());
+    }
+}
+
+void Server::sendDisconnect(ClientId clientId, DisconnectMsg::Reason reason, const char* message) {
+    ClientConnection* client = findClient(clientId);
+    if (!client) {
+        return;
+    }
+    
+    DisconnectMsg msg{};
+    msg.reason = reason;
+    copyString(msg.message, message);
+    
+    u8 buffer[128];
+    BitWriter writer(buffer, sizeof(buffer));
+    writeMessage(writer, msg);
+    
+    const i64 now = monotonicNanos();
+    for (u32 i = 0; i < DISCONNECT_REDUNDANCY; ++i) {
+        queuePacket(client->getConnection(), std::span<const u8>(buffer, writer.getBytesWritten()), now);
+    }
+    
+    removeClient(clientId, reason);
+}
+
+void Server::removeClient(ClientId clientId, DisconnectMsg::Reason reason) {
+    ClientConnection& client = *m_clients[clientId];
+    m_addressToClient.erase(client.getConnection().getAddress().toKey());
+    client.setConnected(false);
+    m_freeIds.push_back(clientId);
+    --m_clientCount;
+    
+    m_handler->onClientDisconnected(clientId, reason);
+}
+
+bool Server::getStats(ClientId clientId, ecs::NetworkStatsComponent& stats) const {
+    const ClientConnection* client = findClient(clientId);
+    if (!client) {
+        return false;
+    }
+    client->getConnection().fillStats(stats);
+    return true;
+}
+
+// ============================================================================
+// Sending
+// ============================================================================
+
+bool Server::sendTo(ClientId clientId, const void* data, size_t size, bool reliable) {
+    ClientConnection* client = findClient(clientId);
+    if (!client) {
+        return false;
+    }
+    
+    std::span<const u8> message(static_cast<const u8*>(data), size);
+    if (reliable) {
+        return client->getConnection().queueReliable(message);
+    }
+    return queuePacket(client->getConnection(), message, monotonicNanos());
+}
+
+void Server::broadcast(const void* data, size_t size, bool reliable) {
+    for (auto& client : m_clients) {
+        if (client->isConnected()) {
+            sendTo(client->getId(), data, size, reliable);
+        }
+    }
+}
+
+bool Server::queuePacket(Connection& connection, std::span<const u8> payload, i64 now) {
+    Datagram* datagram = m_pool->acquire();
+    if (!datagram) {
+        // Pool exhausted between flushes: push what we have out early
+        sendQueued();
+        datagram = m_pool->acquire();
+    }
+    
+    if (!connection.writePacket(payload, now, *datagram)) {
+        m_pool->release(datagram);
+        return false;
+    }
+    m_outgoing.push_back(datagram);
+    return true;
+}
+
+void Server::flush() {
+    if (!m_running) {
+        return;
+    }
+    
+    // Clients that got nothing this tick still need acks, resends and keepalives
+    const i64 now = monotonicNanos();
+    for (auto& client : m_clients) {
+        if (client->isConnected() && client->getConnection().needsSend(now)) {
+            queuePacket(client->getConnection(), {}, now);
+        }
+    }
+    
+    sendQueued();
+}
+
+void Server::sendQueued() {
+    if (m_outgoing.empty()) {
+        return;
+    }
+    
+    const u32 sent = m_socket.send(m_outgoing);
+    if (sent < m_outgoing.size()) {
+        LOG_DEBUG("Socket accepted {} of {} datagrams", sent, m_outgoing.size());
+    }
+    
+    for (Datagram* datagram : m_outgoing) {
+        m_pool->release(datagram);
+    }
+    m_outgoing.clear();
+}
+
+} // namespace cscpp::network
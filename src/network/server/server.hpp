@@ -2,13 +2,28 @@
 
 /**
  * @file server.hpp
- * @brief Authoritative game server
+ * @brief Authoritative game server transport
+ *
+ * Owns the UDP socket and one Connection per client. poll() drains the
+ * socket in recvmmsg() batches and hands messages to a ServerHandler;
+ * sendTo() encodes datagrams straight into pooled buffers, and flush()
+ * pushes everything queued since the last flush out in sendmmsg() batches,
+ * so a tick's snapshots for every client cost a handful of syscalls.
+ * Nothing allocates after start(). Used from a single thread.
  */
 
 #include "core/types.hpp"
+#include "ecs/components/network.hpp"
 #include "network/protocol/messages.hpp"
-#include <unordered_map>
+#include "network/transport/connection.hpp"
+#include "network/transport/packet_pool.hpp"
+#include "network/transport/udp_socket.hpp"
+
 #include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace cscpp::network {
 
@@ -23,6 +38,22 @@ struct ServerConfig {
     i32 maxClients = 32;
     i32 tickRate = 128;
     std::string serverName = "CS C++ Server";
+    f32 timeoutSeconds = 10.0f;         ///< Silence before a client is dropped
+    u32 packetPoolSize = 2048;          ///< Outgoing datagrams between flushes
+};
+
+/**
+ * @brief Receives connection events and messages from Server::poll()
+ */
+class ServerHandler {
+public:
+    virtual ~ServerHandler() = default;
+    
+    virtual void onClientConnected(ClientId clientId, const ClientConnectMsg& msg) = 0;
+    virtual void onClientDisconnected(ClientId clientId, DisconnectMsg::Reason reason) = 0;
+    
+    /// One message (reliable) or one unreliable packet body
+    virtual void onMessage(ClientId clientId, std::span<const u8> data, bool reliable) = 0;
 };
 
 /**
@@ -30,26 +61,31 @@ struct ServerConfig {
  */
 class Server {
 public:
-    Server() = default;
+    Server();
     ~Server();
     
     /// Start the server
-    Result<void> start(const ServerConfig& config);
+    Result<void> start(const ServerConfig& config, ServerHandler* handler);
     
-    /// Stop the server
+    /// Stop the server (connected clients are told it shut down)
     void stop();
     
-    /// Process network events
-    void update(f32 deltaTime);
+    bool isRunning() const { return m_running; }
     
-    /// Get server tick
-    Tick getCurrentTick() const { return m_currentTick; }
+    /// Block until packets arrive or the timeout expires
+    bool waitForPackets(i64 timeoutNanos) const { return m_socket.waitReadable(timeoutNanos); }
     
-    /// Get tick rate
-    i32 getTickRate() const { return m_config.tickRate; }
+    /// Receive everything pending, dispatch it to the handler and drop timed out clients
+    void poll();
+    
+    /// Send keepalives/resends and everything queued by sendTo()
+    void flush();
     
     /// Get connected client count
-    i32 getClientCount() const { return static_cast<i32>(m_clients.size()); }
+    i32 getClientCount() const { return m_clientCount; }
+    
+    const ServerConfig& getConfig() const { return m_config; }
+    u16 getPort() const { return m_socket.getLocalPort(); }
     
     /// Kick a client
     void kickClient(ClientId clientId, const std::string& reason);
@@ -57,27 +93,51 @@ public:
     /// Broadcast message to all clients
     void broadcast(const void* data, size_t size, bool reliable);
     
-    /// Send message to specific client
-    void sendTo(ClientId clientId, const void* data, size_t size, bool reliable);
-    
+    /**
+     * @brief Send message to specific client
+     * @return false if the client is unknown, the reliable window is full
+     *         or the packet pool is exhausted
+     *
+     * Unreliable data is one datagram body (at most Connection::MAX_PAYLOAD_SIZE).
+     */
+    bool sendTo(ClientId clientId, const void* data, size_t size, bool reliable);
+    
+    /// Link statistics of a client; false if not connected
+    bool getStats(ClientId clientId, ecs::NetworkStatsComponent& stats) const;
+
 private:
-    void onClientConnect(/* ENet peer */);
-    void onClientDisconnect(ClientId clientId);
-    void onReceive(ClientId clientId, const void* data, size_t size);
+    void receiveDatagram(const Datagram& datagram, i64 now);
+    void acceptClient(const Datagram& datagram, i64 now);
+    void reject(ServerRejectMsg::Reason reason, const char* message, i64 now);
+    void checkTimeouts(i64 now);
     
-    void processUserCmd(ClientId clientId, const UserCmdMsg& msg);
-    void sendSnapshots();
+    /// Tell the client it is being dropped, then remove it
+    void sendDisconnect(ClientId clientId, DisconnectMsg::Reason reason, const char* message);
+    void removeClient(ClientId clientId, DisconnectMsg::Reason reason);
     
-    ServerConfig m_config;
-    std::unordered_map<ClientId, std::unique_ptr<ClientConnection>> m_clients;
+    /// Queue a datagram built by connection.writePacket()
+    bool queuePacket(Connection& connection, std::span<const u8> payload, i64 now);
+    void sendQueued();
     
-    Tick m_currentTick = 0;
-    ClientId m_nextClientId = 0;
+    ClientConnection* findClient(ClientId clientId) const;
     
+    ServerConfig m_config;
+    ServerHandler* m_handler = nullptr;
     bool m_running = false;
     
-    // ENet host would be here
-    // ENetHost* m_host = nullptr;
+    UdpSocket m_socket;
+    std::unique_ptr<PacketPool> m_pool;
+    std::vector<Datagram*> m_outgoing;
+    std::unique_ptr<Datagram[]> m_receiveBuffers;
+    std::vector<Datagram*> m_receiveBatch;
+    
+    std::vector<std::unique_ptr<ClientConnection>> m_clients;   ///< Indexed by ClientId
+    std::unordered_map<u64, ClientId> m_addressToClient;
+    std::vector<ClientId> m_freeIds;
+    i32 m_clientCount = 0;
+    
+    /// Handshake state for addresses that are not connected yet
+    std::unique_ptr<Connection> m_handshake;
 };
 
 /**
@@ -89,30 +149,20 @@ public:
     
     ClientId getId() const { return m_clientId; }
     
-    /// Get client ping (RTT)
-    f32 getPing() const { return m_ping; }
-    
-    /// Get last acknowledged tick
-    Tick getLastAckedTick() const { return m_lastAckedTick; }
+    /// Slots are preallocated; only connected ones carry a live connection
+    bool isConnected() const { return m_connected; }
+    void setConnected(bool connected) { m_connected = connected; }
     
-    /// Add user command
-    void addUserCmd(const UserCmd& cmd);
-    
-    /// Get pending user commands
-    const std::vector<UserCmd>& getPendingCmds() const { return m_pendingCmds; }
-    
-    /// Clear processed commands
-    void clearProcessedCmds(Tick upToTick);
+    Connection& getConnection() { return m_connection; }
+    const Connection& getConnection() const { return m_connection; }
     
+    /// Get client ping (RTT)
+    f32 getPing() const { return m_connection.getRoundTripTime(); }
+
 private:
     ClientId m_clientId;
-    f32 m_ping = 0.0f;
-    Tick m_lastAckedTick = 0;
-    std::vector<UserCmd> m_pendingCmds;
-    
-    // ENet peer would be here
-    // ENetPeer* m_peer = nullptr;
+    bool m_connected = false;
+    Connection m_connection;
 };
 
 } // namespace cscpp::network
-
@@ -0,0 +1,512 @@
+/**
+ * @file snapshot.cpp
+ * @brief Delta snapshot encoding and decoding
+ */
+
+#include "network/snapshot/snapshot.hpp"
+#include "network/protocol/bit_buffer.hpp"
+#include "network/protocol/message_schemas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cscpp::network {
+
+namespace {
+
+/// Baseline age field; age 0 means "no baseline"
+constexpr u32 BASELINE_AGE_BITS = 5;
+static_assert((1u << BASELINE_AGE_BITS) == SNAPSHOT_HISTORY_SIZE,
+              "Baseline age must cover the whole history");
+
+constexpr u32 UPDATE_TYPE_BITS = 2;
+
+/// Ids within this distance of the previous entity are sent as a short gap
+constexpr u32 SMALL_ID_GAP_BITS = 4;
+constexpr u32 NETWORK_ID_BITS = sizeof(NetworkId) * 8;
+static_assert(NETWORK_ID_BITS <= 32, "NetworkId must fit a single bit write");
+
+/// Space kept free for the end-of-entities marker
+constexpr size_t TERMINATOR_BITS = 1;
+
+constexpr u32 fieldBit(EntityField field) {
+    return static_cast<u32>(field);
+}
+
+/// Bitwise comparison, so -0/+0 and NaN payloads count as changes
+template<typename T>
+bool sameBits(const T& a, const T& b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+u32 changedFields(const EntityState& state, const EntityState& baseline) {
+    u32 changed = 0;
+    if (!sameBits(state.position, baseline.position)) changed |= fieldBit(EntityField::Position);
+    if (!sameBits(state.velocity, baseline.velocity)) changed |= fieldBit(EntityField::Velocity);
+    if (!sameBits(state.angles, baseline.angles)) changed |= fieldBit(EntityField::Angles);
+    if (state.flags != baseline.flags) changed |= fieldBit(EntityField::Flags);
+    if (state.health != baseline.health) changed |= fieldBit(EntityField::Health);
+    if (state.weaponId != baseline.weaponId) changed |= fieldBit(EntityField::Weapon);
+    if (state.animSequence != baseline.animSequence ||
+        !sameBits(state.animFrame, baseline.animFrame)) {
+        changed |= fieldBit(EntityField::Animation);
+    }
+    return changed;
+}
+
+// ============================================================================
+// Field Serialization
+// ============================================================================
+
+void writeEntityFields(BitWriter& writer, const EntityState& state, u32 fields) {
+    writer.writeBits(fields, ENTITY_FIELD_COUNT);
+
+    if (fields & fieldBit(EntityField::Position)) codec::WorldPosition::write(writer, state.position);
+    if (fields & fieldBit(EntityField::Velocity)) codec::WorldVelocity::write(writer, state.velocity);
+    if (fields & fieldBit(EntityField::Angles)) codec::Angles16::write(writer, state.angles);
+    if (fields & fieldBit(EntityField::Flags)) codec::Integer::write(writer, state.flags);
+    if (fields & fieldBit(EntityField::Health)) codec::Integer::write(writer, state.health);
+    if (fields & fieldBit(EntityField::Weapon)) codec::Integer::write(writer, state.weaponId);
+    if (fields & fieldBit(EntityField::Animation)) {
+        codec::Integer::write(writer, state.animSequence);
+        codec::Float::write(writer, state.animFrame);
+    }
+}
+
+void readEntityFields(BitReader& reader, EntityState& state) {
+    u32 fields = reader.readBits(ENTITY_FIELD_COUNT);
+
+    if (fields & fieldBit(EntityField::Position)) codec::WorldPosition::read(reader, state.position);
+    if (fields & fieldBit(EntityField::Velocity)) codec::WorldVelocity::read(reader, state.velocity);
+    if (fields & fieldBit(EntityField::Angles)) codec::Angles16::read(reader, state.angles);
+    if (fields & fieldBit(EntityField::Flags)) codec::Integer::read(reader, state.flags);
+    if (fields & fieldBit(EntityField::Health)) codec::Integer::read(reader, state.health);
+    if (fields & fieldBit(EntityField::Weapon)) codec::Integer::read(reader, state.weaponId);
+    if (fields & fieldBit(EntityField::Animation)) {
+        codec::Integer::read(reader, state.animSequence);
+        codec::Float::read(reader, state.animFrame);
+    }
+}
+
+/// Round lossy fields to what the client will decode
+void quantizeEntityState(EntityState& state) {
+    codec::WorldPosition::quantize(state.position);
+    codec::WorldVelocity::quantize(state.velocity);
+    codec::Angles16::quantize(state.angles);
+}
+
+void writeNetworkId(BitWriter& writer, NetworkId id, NetworkId previousId, bool first) {
+    NetworkId gap = id - previousId;
+    if (!first && gap < (NetworkId{1} << SMALL_ID_GAP_BITS)) {
+        writer.writeBool(true);
+        writer.writeBits(static_cast<u32>(gap), SMALL_ID_GAP_BITS);
+    } else {
+        writer.writeBool(false);
+        writer.writeBits(static_cast<u32>(id), NETWORK_ID_BITS);
+    }
+}
+
+NetworkId readNetworkId(BitReader& reader, NetworkId previousId) {
+    if (reader.readBool()) {
+        return previousId + static_cast<NetworkId>(reader.readBits(SMALL_ID_GAP_BITS));
+    }
+    return static_cast<NetworkId>(reader.readBits(NETWORK_ID_BITS));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// SnapshotFrame / SnapshotHistory
+// ============================================================================
+
+void SnapshotFrame::sortEntities() {
+    std::sort(entities.begin(), entities.end(), [](const EntityState& a, const EntityState& b) {
+        return a.networkId < b.networkId;
+    });
+}
+
+SnapshotFrame& SnapshotHistory::acquire(Tick tick) {
+    SnapshotFrame& frame = m_frames[tick % SNAPSHOT_HISTORY_SIZE];
+    frame.tick = tick;
+    frame.valid = false;
+    frame.acked = false;
+    frame.entities.clear();
+    return frame;
+}
+
+SnapshotFrame* SnapshotHistory::find(Tick tick) {
+    SnapshotFrame& frame = m_frames[tick % SNAPSHOT_HISTORY_SIZE];
+    return (frame.valid && frame.tick == tick) ? &frame : nullptr;
+}
+
+const SnapshotFrame* SnapshotHistory::find(Tick tick) const {
+    const SnapshotFrame& frame = m_frames[tick % SNAPSHOT_HISTORY_SIZE];
+    return (frame.valid && frame.tick == tick) ? &frame : nullptr;
+}
+
+void SnapshotHistory::clear() {
+    for (auto& frame : m_frames) {
+        frame.valid = false;
+        frame.acked = false;
+        frame.entities.clear();
+    }
+}
+
+// ============================================================================
+// ClientSnapshotState
+// ============================================================================
+
+void ClientSnapshotState::onAck(const ClientAckMsg& ack) {
+    const Tick last = ack.lastReceivedServerTick;
+
+    if (SnapshotFrame* frame = m_history.find(last)) {
+        frame->acked = true;
+    }
+
+    // Bit i acknowledges tick (last - 1 - i)
+    for (u32 i = 0; i < 32; ++i) {
+        if ((ack.snapshotAckBits & (1u << i)) == 0 || last < i + 1) {
+            continue;
+        }
+        if (SnapshotFrame* frame = m_history.find(last - 1 - i)) {
+            frame->acked = true;
+        }
+    }
+}
+
+const SnapshotFrame* ClientSnapshotState::selectBaseline(Tick tick) const {
+    const SnapshotFrame* best = nullptr;
+
+    for (u32 age = 1; age < SNAPSHOT_HISTORY_SIZE && age <= tick; ++age) {
+        const SnapshotFrame* frame = m_history.find(tick - age);
+        if (frame && frame->acked) {
+            best = frame;
+            break;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// SnapshotEncoder
+// ============================================================================
+
+SnapshotFrame& SnapshotEncoder::beginFrame(Tick tick) {
+    m_world.tick = tick;
+    m_world.valid = false;
+    m_world.entities.clear();
+    return m_world;
+}
+
+void SnapshotEncoder::endFrame() {
+    // Compare and store what the client will see, so lossy fields don't
+    // register as changed every tick and baselines match on both sides
+    for (EntityState& state : m_world.entities) {
+        quantizeEntityState(state);
+    }
+    m_world.sortEntities();
+    m_world.valid = true;
+}
+
+ClientSnapshotState& SnapshotEncoder::addClient(ClientId clientId) {
+    if (ClientSnapshotState* existing = findClient(clientId)) {
+        return *existing;
+    }
+    m_clients.push_back(std::make_unique<ClientSnapshotState>(clientId));
+    return *m_clients.back();
+}
+
+void SnapshotEncoder::removeClient(ClientId clientId) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(), [clientId](const auto& client) {
+        return client->getClientId() == clientId;
+    });
+    if (it != m_clients.end()) {
+        m_clients.erase(it);
+    }
+}
+
+ClientSnapshotState* SnapshotEncoder::findClient(ClientId clientId) {
+    for (auto& client : m_clients) {
+        if (client->getClientId() == clientId) {
+            return client.get();
+        }
+    }
+    return nullptr;
+}
+
+void SnapshotEncoder::onClientAck(ClientId clientId, const ClientAckMsg& ack) {
+    if (ClientSnapshotState* client = findClient(clientId)) {
+        client->onAck(ack);
+    }
+}
+
+namespace {
+
+/// World entities selected by index
+struct IndexedEntities {
+    const std::vector<EntityState>& entities;
+    std::span<const u32> indices;
+
+    size_t size() const { return indices.size(); }
+    const EntityState& operator[](size_t i) const { return entities[indices[i]]; }
+};
+
+} // anonymous namespace
+
+std::span<const u8> SnapshotEncoder::encode(ClientSnapshotState& client) const {
+    return encodeEntities(client, std::span<const EntityState>(m_world.entities));
+}
+
+std::span<const u8> SnapshotEncoder::encode(ClientSnapshotState& client, std::span<const u32> relevant) const {
+    return encodeEntities(client, IndexedEntities{m_world.entities, relevant});
+}
+
+template<typename Entities>
+std::span<const u8> SnapshotEncoder::encodeEntities(ClientSnapshotState& client, const Entities& current) const {
+    const Tick tick = m_world.tick;
+    const SnapshotFrame* baseline = client.selectBaseline(tick);
+
+    std::span<const EntityState> base;
+    if (baseline) {
+        base = baseline->entities;
+    }
+
+    // Baseline age is at least 1, so this never reuses the baseline's slot
+    SnapshotFrame& sent = client.m_history.acquire(tick);
+
+    BitWriter writer(client.m_packet.data(), client.m_packet.size());
+    writer.writeU8(static_cast<u8>(baseline ? MessageId::DeltaSnapshot : MessageId::FullSnapshot));
+    codec::VarUInt::write(writer, tick);
+    codec::VarUInt::write(writer, client.m_clientTickAck);
+    writer.writeBits(baseline ? static_cast<u32>(tick - baseline->tick) : 0u, BASELINE_AGE_BITS);
+
+    const size_t bitLimit = client.m_packet.size() * 8 - TERMINATOR_BITS;
+    const EntityState emptyState{};
+
+    NetworkId previousId = 0;
+    bool firstEntity = true;
+    bool packetFull = false;
+    u32 deferred = 0;
+
+    size_t ci = 0;
+    size_t bi = 0;
+    while (ci < current.size() || bi < base.size()) {
+        const EntityState* state = nullptr;
+        const EntityState* old = nullptr;
+
+        if (bi == base.size() || (ci < current.size() && current[ci].networkId < base[bi].networkId)) {
+            state = &current[ci++];
+        } else if (ci == current.size() || base[bi].networkId < current[ci].networkId) {
+            old = &base[bi++];
+        } else {
+            state = &current[ci++];
+            old = &base[bi++];
+        }
+
+        EntityDelta::UpdateType type;
+        u32 fields = 0;
+        if (!old) {
+            type = EntityDelta::UpdateType::Full;
+            fields = changedFields(*state, emptyState);
+        } else if (!state) {
+            type = EntityDelta::UpdateType::Remove;
+        } else {
+            fields = changedFields(*state, *old);
+            if (fields == 0) {
+                sent.entities.push_back(*state);
+                continue;
+            }
+            type = EntityDelta::UpdateType::Delta;
+        }
+
+        if (!packetFull) {
+            const NetworkId id = state ? state->networkId : old->networkId;
+            const size_t mark = writer.getBitPosition();
+
+            writer.writeBool(true);
+            writeNetworkId(writer, id, previousId, firstEntity);
+            writer.writeBits(static_cast<u32>(type), UPDATE_TYPE_BITS);
+            if (type != EntityDelta::UpdateType::Remove) {
+                writeEntityFields(writer, *state, fields);
+            }
+
+            if (!writer.hasOverflowed() && writer.getBitPosition() <= bitLimit) {
+                previousId = id;
+                firstEntity = false;
+                if (state) {
+                    sent.entities.push_back(*state);
+                }
+                continue;
+            }
+
+            writer.rewind(mark);
+            packetFull = true;
+        }
+
+        // Not sent: the client keeps whatever its baseline had
+        ++deferred;
+        if (old) {
+            sent.entities.push_back(*old);
+        }
+    }
+
+    writer.writeBool(false);
+
+    sent.valid = true;
+    client.m_packetSize = writer.getBytesWritten();
+    client.m_deferredCount = deferred;
+    return client.getPacket();
+}
+
+// ============================================================================
+// SnapshotDecoder
+// ============================================================================
+
+Result<const SnapshotFrame*> SnapshotDecoder::decode(std::span<const u8> packet) {
+    BitReader reader(packet.data(), packet.size());
+
+    const auto messageId = static_cast<MessageId>(reader.readU8());
+    Tick tick = 0;
+    Tick clientTickAck = 0;
+    codec::VarUInt::read(reader, tick);
+    codec::VarUInt::read(reader, clientTickAck);
+    const u32 baselineAge = reader.readBits(BASELINE_AGE_BITS);
+
+    if (reader.hasOverflowed()) {
+        return std::unexpected(Error{"Snapshot header truncated"});
+    }
+    if (messageId != MessageId::DeltaSnapshot && messageId != MessageId::FullSnapshot) {
+        return std::unexpected(Error{"Not a snapshot message"});
+    }
+    if ((messageId == MessageId::DeltaSnapshot) != (baselineAge != 0)) {
+        return std::unexpected(Error{"Snapshot baseline flag mismatch"});
+    }
+
+    // Too old to store without evicting newer frames
+    if (m_hasLatest && tick < m_latestTick && m_latestTick - tick >= SNAPSHOT_HISTORY_SIZE) {
+        return std::unexpected(Error{"Snapshot is older than the history window"});
+    }
+
+    // Duplicate delivery
+    if (const SnapshotFrame* existing = m_history.find(tick)) {
+        return existing;
+    }
+
+    std::span<const EntityState> base;
+    if (baselineAge != 0) {
+        if (tick < baselineAge) {
+            return std::unexpected(Error{"Snapshot baseline precedes tick 0"});
+        }
+        const SnapshotFrame* baseline = m_history.find(tick - baselineAge);
+        if (!baseline) {
+            return std::unexpected(Error{"Snapshot baseline not available"});
+        }
+        base = baseline->entities;
+    }
+
+    SnapshotFrame& frame = m_history.acquire(tick);
+
+    NetworkId previousId = 0;
+    bool firstEntity = true;
+    size_t bi = 0;
+
+    while (reader.readBool()) {
+        const NetworkId id = readNetworkId(reader, previousId);
+        const auto type = static_cast<EntityDelta::UpdateType>(reader.readBits(UPDATE_TYPE_BITS));
+
+        if (reader.hasOverflowed()) {
+            return std::unexpected(Error{"Snapshot entity truncated"});
+        }
+        if (!firstEntity && id <= previousId) {
+            return std::unexpected(Error{"Snapshot entities out of order"});
+        }
+
+        // Entities the server skipped are unchanged from the baseline
+        while (bi < base.size() && base[bi].networkId < id) {
+            frame.entities.push_back(base[bi++]);
+        }
+        const bool inBaseline = bi < base.size() && base[bi].networkId == id;
+
+        switch (type) {
+            case EntityDelta::UpdateType::Remove:
+                if (!inBaseline) {
+                    return std::unexpected(Error{"Snapshot removes an unknown entity"});
+                }
+                ++bi;
+                break;
+
+            case EntityDelta::UpdateType::Delta: {
+                if (!inBaseline) {
+                    return std::unexpected(Error{"Snapshot delta has no baseline entity"});
+                }
+                EntityState& state = frame.entities.emplace_back(base[bi++]);
+                readEntityFields(reader, state);
+                break;
+            }
+
+            case EntityDelta::UpdateType::Full: {
+                if (inBaseline) {
+                    ++bi;
+                }
+                EntityState& state = frame.entities.emplace_back();
+                state.networkId = id;
+                readEntityFields(reader, state);
+                break;
+            }
+
+            default:
+                return std::unexpected(Error{"Snapshot has an invalid update type"});
+        }
+
+        previousId = id;
+        firstEntity = false;
+    }
+
+    if (reader.hasOverflowed()) {
+        return std::unexpected(Error{"Snapshot entity data truncated"});
+    }
+
+    while (bi < base.size()) {
+        frame.entities.push_back(base[bi++]);
+    }
+
+    frame.valid = true;
+
+    if (!m_hasLatest || tick > m_latestTick) {
+        m_latestTick = tick;
+        m_clientTickAck = clientTickAck;
+        m_hasLatest = true;
+    }
+
+    return &frame;
+}
+
+const SnapshotFrame* SnapshotDecoder::getLatestFrame() const {
+    return m_hasLatest ? m_history.find(m_latestTick) : nullptr;
+}
+
+ClientAckMsg SnapshotDecoder::buildAck() const {
+    ClientAckMsg ack{};
+    ack.lastReceivedServerTick = m_latestTick;
+    ack.snapshotAckBits = 0;
+
+    if (!m_hasLatest) {
+        return ack;
+    }
+
+    for (u32 i = 0; i + 1 < SNAPSHOT_HISTORY_SIZE && i < m_latestTick; ++i) {
+        if (m_history.find(m_latestTick - 1 - i)) {
+            ack.snapshotAckBits |= 1u << i;
+        }
+    }
+    return ack;
+}
+
+void SnapshotDecoder::reset() {
+    m_history.clear();
+    m_latestTick = 0;
+    m_clientTickAck = 0;
+    m_hasLatest = false;
+}
+
+} // namespace cscpp::network
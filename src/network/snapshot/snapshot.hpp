@@ -0,0 +1,228 @@
+#pragma once
+
+/**
+ * @file snapshot.hpp
+ * @brief Delta-compressed world snapshots
+ *
+ * The server captures one SnapshotFrame of replicated entity state per tick.
+ * For every client it keeps a ring of the frames that client was sent, each
+ * holding exactly the state the client will have after decoding it. A new
+ * snapshot is encoded as the difference between the current world frame and
+ * the newest frame the client acknowledged (or the empty frame if none).
+ *
+ * Wire format (bit packed, see BitWriter):
+ *   u8   MessageId (DeltaSnapshot, or FullSnapshot without a baseline)
+ *   var  server tick
+ *   var  last processed client command tick
+ *   5b   baseline age in ticks (0 = no baseline)
+ *   per entity: 1b continue, id gap, 2b UpdateType, then for Delta/Full
+ *               the changed field mask and the changed fields
+ *               (codecs from message_schemas.hpp)
+ *   1b   terminator (0)
+ *
+ * Entities are sorted by network id, so both sides merge-walk the current
+ * entity list against the baseline list. Encoding writes directly into a
+ * per-client MAX_PACKET_SIZE buffer. If the packet fills up, the remaining
+ * entities are left at their baseline state and picked up next tick.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "network/protocol/messages.hpp"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cscpp::network {
+
+/// Frames kept per client (and per decoder); bounds the baseline age
+constexpr u32 SNAPSHOT_HISTORY_SIZE = 32;
+
+/// Number of EntityField bits in the changed field mask
+constexpr u32 ENTITY_FIELD_COUNT = 7;
+
+// ============================================================================
+// Snapshot Frames
+// ============================================================================
+
+/**
+ * @brief Replicated entity state at one tick, sorted by network id
+ */
+struct SnapshotFrame {
+    Tick tick = 0;
+    bool valid = false;
+    bool acked = false;                     ///< Client confirmed receipt (server side)
+    std::vector<EntityState> entities;
+
+    /// Sort entities by network id (required before encoding)
+    void sortEntities();
+};
+
+/**
+ * @brief Fixed ring of frames indexed by tick
+ *
+ * Frame storage is reused, so steady-state operation does not allocate.
+ */
+class SnapshotHistory {
+public:
+    /// Claim the slot for `tick`, discarding the frame that was there
+    SnapshotFrame& acquire(Tick tick);
+
+    /// Frame for `tick`, or nullptr if it was never stored or has been overwritten
+    SnapshotFrame* find(Tick tick);
+    const SnapshotFrame* find(Tick tick) const;
+
+    void clear();
+
+private:
+    std::array<SnapshotFrame, SNAPSHOT_HISTORY_SIZE> m_frames;
+};
+
+// ============================================================================
+// Server Side
+// ============================================================================
+
+/**
+ * @brief Per-client delta state and packet buffer
+ */
+class ClientSnapshotState {
+public:
+    explicit ClientSnapshotState(ClientId clientId) : m_clientId(clientId) {}
+
+    ClientId getClientId() const { return m_clientId; }
+
+    /// Mark the frames named by an ack as received
+    void onAck(const ClientAckMsg& ack);
+
+    /// Newest acknowledged frame usable as a baseline for `tick`
+    const SnapshotFrame* selectBaseline(Tick tick) const;
+
+    /// Last client command tick processed by the server (echoed in snapshots)
+    void setClientTickAck(Tick tick) { m_clientTickAck = tick; }
+    Tick getClientTickAck() const { return m_clientTickAck; }
+
+    /// Last encoded packet
+    std::span<const u8> getPacket() const { return {m_packet.data(), m_packetSize}; }
+
+    /// Entities that did not fit in the last packet
+    u32 getDeferredCount() const { return m_deferredCount; }
+
+    /// Viewer used for relevance (the client's own entity and eye position)
+    void setViewer(NetworkId entity, Vec3 eyePosition) {
+        m_viewerId = entity;
+        m_viewOrigin = eyePosition;
+        m_hasViewer = true;
+    }
+    void clearViewer() { m_hasViewer = false; }
+    bool hasViewer() const { return m_hasViewer; }
+    NetworkId getViewerId() const { return m_viewerId; }
+    Vec3 getViewOrigin() const { return m_viewOrigin; }
+
+    /// Scratch for the relevant entity set, reused every snapshot
+    std::vector<u32>& getRelevantEntities() { return m_relevant; }
+
+private:
+    friend class SnapshotEncoder;
+
+    ClientId m_clientId;
+    Tick m_clientTickAck = 0;
+    SnapshotHistory m_history;
+
+    std::array<u8, MAX_PACKET_SIZE> m_packet{};
+    size_t m_packetSize = 0;
+    u32 m_deferredCount = 0;
+
+    NetworkId m_viewerId = INVALID_NETWORK_ID;
+    Vec3 m_viewOrigin{0.0f};
+    bool m_hasViewer = false;
+    std::vector<u32> m_relevant;
+};
+
+/**
+ * @brief Builds per-client delta snapshots from the current world frame
+ *
+ * Fill the world frame with beginFrame()/endFrame() once per tick, then call
+ * encode() for each client. Encoding different clients only reads shared
+ * state, so clients can be encoded concurrently.
+ */
+class SnapshotEncoder {
+public:
+    /// Start a new world frame; append replicated entities to the result
+    SnapshotFrame& beginFrame(Tick tick);
+
+    /// Finish the world frame (sorts entities)
+    void endFrame();
+
+    const SnapshotFrame& getWorldFrame() const { return m_world; }
+
+    // ========================================================================
+    // Clients
+    // ========================================================================
+
+    ClientSnapshotState& addClient(ClientId clientId);
+    void removeClient(ClientId clientId);
+    ClientSnapshotState* findClient(ClientId clientId);
+
+    size_t getClientCount() const { return m_clients.size(); }
+    ClientSnapshotState& getClient(size_t index) { return *m_clients[index]; }
+
+    /// Apply an ack from a client
+    void onClientAck(ClientId clientId, const ClientAckMsg& ack);
+
+    /**
+     * @brief Encode the world frame for one client
+     * @return Packet bytes (valid until the next encode for this client)
+     */
+    std::span<const u8> encode(ClientSnapshotState& client) const;
+
+    /**
+     * @brief Encode only the given world entities (ascending indices)
+     *
+     * Entities that drop out of the set are removed on the client.
+     */
+    std::span<const u8> encode(ClientSnapshotState& client, std::span<const u32> relevant) const;
+
+private:
+    template<typename Entities>
+    std::span<const u8> encodeEntities(ClientSnapshotState& client, const Entities& current) const;
+
+    SnapshotFrame m_world;
+    std::vector<std::unique_ptr<ClientSnapshotState>> m_clients;
+};
+
+// ============================================================================
+// Client Side
+// ============================================================================
+
+/**
+ * @brief Reconstructs world frames from snapshot packets
+ */
+class SnapshotDecoder {
+public:
+    /**
+     * @brief Decode a snapshot packet against the stored baselines
+     * @return The reconstructed frame (owned by the decoder)
+     */
+    Result<const SnapshotFrame*> decode(std::span<const u8> packet);
+
+    /// Latest decoded frame, or nullptr
+    const SnapshotFrame* getLatestFrame() const;
+
+    /// Server's last processed command tick from the latest snapshot
+    Tick getClientTickAck() const { return m_clientTickAck; }
+
+    /// Ack describing every frame currently held
+    ClientAckMsg buildAck() const;
+
+    void reset();
+
+private:
+    SnapshotHistory m_history;
+    Tick m_latestTick = 0;
+    Tick m_clientTickAck = 0;
+    bool m_hasLatest = false;
+};
+
+} // namespace cscpp::network
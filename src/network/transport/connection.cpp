@@ -0,0 +1,321 @@
+/**
+ * @file connection.cpp
+ * @brief Sequenced UDP connection
+ */
+
+#include "network/transport/connection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace cscpp::network {
+
+namespace {
+
+constexpr i64 BANDWIDTH_WINDOW_NS = 1'000'000'000;
+
+/// Weight of a new sample in the smoothed RTT / loss
+constexpr f32 RTT_SMOOTHING = 0.1f;
+constexpr f32 LOSS_SMOOTHING = 0.01f;
+
+inline void putU16(u8* out, u16 value) {
+    out[0] = static_cast<u8>(value);
+    out[1] = static_cast<u8>(value >> 8);
+}
+
+inline void putU32(u8* out, u32 value) {
+    putU16(out, static_cast<u16>(value));
+    putU16(out + 2, static_cast<u16>(value >> 16));
+}
+
+inline u16 getU16(const u8* in) {
+    return static_cast<u16>(in[0] | (in[1] << 8));
+}
+
+inline u32 getU32(const u8* in) {
+    return static_cast<u32>(getU16(in)) | (static_cast<u32>(getU16(in + 2)) << 16);
+}
+
+} // anonymous namespace
+
+void Connection::reset(const NetAddress& address, i64 now) {
+    *this = Connection{};
+    m_address = address;
+    m_lastSendTime = now;
+    m_lastReceiveTime = now;
+    m_bandwidthWindowStart = now;
+}
+
+// ============================================================================
+// Sending
+// ============================================================================
+
+bool Connection::queueReliable(std::span<const u8> message) {
+    if (message.size() > MAX_RELIABLE_SIZE || getReliablePending() >= RELIABLE_WINDOW) {
+        return false;
+    }
+    
+    ReliableSlot& slot = m_sendQueue[m_sendNextId % RELIABLE_WINDOW];
+    slot.used = true;
+    slot.id = m_sendNextId;
+    slot.size = static_cast<u16>(message.size());
+    slot.lastSent = -1;
+    std::memcpy(slot.data.data(), message.data(), message.size());
+    ++m_sendNextId;
+    return true;
+}
+
+i64 Connection::getResendDelay() const {
+    const i64 rttNanos = m_hasRtt ? static_cast<i64>((m_rtt + 2.0f * m_rttJitter) * 1e9f) : 100'000'000;
+    return std::max(rttNanos, MIN_RESEND_DELAY_NS);
+}
+
+bool Connection::needsSend(i64 now) const {
+    if (now - m_lastSendTime >= KEEPALIVE_INTERVAL_NS) {
+        return true;
+    }
+    const i64 resendDelay = getResendDelay();
+    for (u16 id = m_sendOldestId; id != m_sendNextId; ++id) {
+        const ReliableSlot& slot = m_sendQueue[id % RELIABLE_WINDOW];
+        if (slot.used && slot.id == id && (slot.lastSent < 0 || now - slot.lastSent >= resendDelay)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Connection::writePacket(std::span<const u8> payload, i64 now, Datagram& out) {
+    if (payload.size() > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+    
+    u8* data = out.data.data();
+    const u16 sequence = m_localSequence++;
+    
+    putU16(data + 0, PACKET_MAGIC);
+    putU16(data + 2, sequence);
+    putU16(data + 4, m_remoteSequence);
+    putU32(data + 6, m_hasRemote ? m_receivedBits : 0u);
+    
+    SentPacket& sent = m_sent[sequence % SENT_HISTORY];
+    sent.sequence = sequence;
+    sent.valid = true;
+    sent.acked = false;
+    sent.sendTime = now;
+    sent.reliableCount = 0;
+    
+    // Piggyback reliable messages that are new or due for a resend
+    size_t offset = HEADER_SIZE;
+    const size_t limit = MAX_DATAGRAM_SIZE - payload.size();
+    const i64 resendDelay = getResendDelay();
+    for (u16 id = m_sendOldestId; id != m_sendNextId && sent.reliableCount < MAX_RELIABLE_PER_PACKET; ++id) {
+        ReliableSlot& slot = m_sendQueue[id % RELIABLE_WINDOW];
+        if (!slot.used || slot.id != id) {
+            continue;
+        }
+        if (slot.lastSent >= 0 && now - slot.lastSent < resendDelay) {
+            continue;
+        }
+        if (offset + RELIABLE_HEADER_SIZE + slot.size > limit) {
+            break;      // Keep order: later messages wait for the next packet
+        }
+        
+        putU16(data + offset, slot.id);
+        putU16(data + offset + 2, slot.size);
+        std::memcpy(data + offset + RELIABLE_HEADER_SIZE, slot.data.data(), slot.size);
+        offset += RELIABLE_HEADER_SIZE + slot.size;
+        
+        slot.lastSent = now;
+        sent.reliableIds[sent.reliableCount++] = slot.id;
+    }
+    data[10] = sent.reliableCount;
+    
+    if (!payload.empty()) {
+        std::memcpy(data + offset, payload.data(), payload.size());
+        offset += payload.size();
+    }
+    out.size = static_cast<u32>(offset);
+    out.address = m_address;
+    
+    m_lastSendTime = now;
+    ++m_packetsSent;
+    m_bytesSent += offset;
+    m_bytesSentWindow += offset;
+    updateBandwidth(now);
+    return true;
+}
+
+// ============================================================================
+// Receiving
+// ============================================================================
+
+bool Connection::readHeaderAndReliable(std::span<const u8> data, i64 now, size_t& offset) {
+    if (data.size() < HEADER_SIZE || getU16(data.data()) != PACKET_MAGIC) {
+        return false;
+    }
+    
+    const u16 sequence = getU16(data.data() + 2);
+    const u16 ack = getU16(data.data() + 4);
+    const u32 ackBits = getU32(data.data() + 6);
+    const u8 reliableCount = data[10];
+    
+    // Validate the reliable section before touching any state
+    offset = HEADER_SIZE;
+    for (u8 i = 0; i < reliableCount; ++i) {
+        if (offset + RELIABLE_HEADER_SIZE > data.size()) {
+            return false;
+        }
+        const u16 size = getU16(data.data() + offset + 2);
+        if (size > MAX_RELIABLE_SIZE || offset + RELIABLE_HEADER_SIZE + size > data.size()) {
+            return false;
+        }
+        offset += RELIABLE_HEADER_SIZE + size;
+    }
+    
+    // Sequence window: reject duplicates, record newer/older arrivals
+    if (!m_hasRemote) {
+        m_hasRemote = true;
+        m_remoteSequence = sequence;
+        m_receivedBits = 0;
+    } else if (sequenceGreater(sequence, m_remoteSequence)) {
+        const u16 shift = static_cast<u16>(sequence - m_remoteSequence);
+        m_receivedBits = shift >= 32 ? 0u : (m_receivedBits << shift);
+        if (shift <= 32) {
+            m_receivedBits |= 1u << (shift - 1);
+        }
+        m_remoteSequence = sequence;
+    } else {
+        const u16 age = static_cast<u16>(m_remoteSequence - sequence);
+        if (age == 0 || age > 32 || (m_receivedBits & (1u << (age - 1)))) {
+            return false;
+        }
+        m_receivedBits |= 1u << (age - 1);
+    }
+    
+    m_lastReceiveTime = now;
+    ++m_packetsReceived;
+    m_bytesReceived += data.size();
+    m_bytesReceivedWindow += data.size();
+    updateBandwidth(now);
+    
+    processAcks(ack, ackBits, now);
+    
+    // Store reliable messages that fall in the receive window
+    size_t cursor = HEADER_SIZE;
+    for (u8 i = 0; i < reliableCount; ++i) {
+        const u16 id = getU16(data.data() + cursor);
+        const u16 size = getU16(data.data() + cursor + 2);
+        const u8* body = data.data() + cursor + RELIABLE_HEADER_SIZE;
+        cursor += RELIABLE_HEADER_SIZE + size;
+        
+        const u16 ahead = static_cast<u16>(id - m_recvNextId);
+        if (ahead >= RELIABLE_WINDOW) {
+            continue;   // Already delivered, or beyond the window
+        }
+        ReliableSlot& slot = m_recvQueue[id % RELIABLE_WINDOW];
+        if (slot.used && slot.id == id) {
+            continue;
+        }
+        slot.used = true;
+        slot.id = id;
+        slot.size = size;
+        std::memcpy(slot.data.data(), body, size);
+    }
+    
+    return true;
+}
+
+void Connection::processAcks(u16 ack, u32 ackBits, i64 now) {
+    auto tryAck = [&](u16 sequence) {
+        SentPacket& packet = m_sent[sequence % SENT_HISTORY];
+        if (packet.valid && packet.sequence == sequence && !packet.acked) {
+            onPacketAcked(packet, now);
+        }
+    };
+    
+    // Ignore acks for packets we never sent (or from long ago)
+    if (!sequenceGreater(m_localSequence, ack)) {
+        return;
+    }
+    
+    tryAck(ack);
+    for (u32 i = 0; i < 32; ++i) {
+        if (ackBits & (1u << i)) {
+            tryAck(static_cast<u16>(ack - 1 - i));
+        }
+    }
+    
+    // Packets that fell out of the ack window without an ack are lost
+    const u16 horizon = static_cast<u16>(ack - 32);
+    while (sequenceGreater(horizon, m_lossCursor)) {
+        SentPacket& packet = m_sent[m_lossCursor % SENT_HISTORY];
+        if (packet.valid && packet.sequence == m_lossCursor) {
+            const f32 lost = packet.acked ? 0.0f : 1.0f;
+            m_packetLoss += (lost - m_packetLoss) * LOSS_SMOOTHING;
+            packet.valid = false;
+        }
+        ++m_lossCursor;
+    }
+}
+
+void Connection::onPacketAcked(SentPacket& packet, i64 now) {
+    packet.acked = true;
+    
+    const f32 sample = static_cast<f32>(now - packet.sendTime) * 1e-9f;
+    if (!m_hasRtt) {
+        m_rtt = sample;
+        m_rttJitter = sample * 0.5f;
+        m_hasRtt = true;
+    } else {
+        m_rttJitter += (std::abs(sample - m_rtt) - m_rttJitter) * RTT_SMOOTHING;
+        m_rtt += (sample - m_rtt) * RTT_SMOOTHING;
+    }
+    
+    for (u8 i = 0; i < packet.reliableCount; ++i) {
+        ReliableSlot& slot = m_sendQueue[packet.reliableIds[i] % RELIABLE_WINDOW];
+        if (slot.used && slot.id == packet.reliableIds[i]) {
+            slot.used = false;
+        }
+    }
+    
+    // Slide the send window past acknowledged messages
+    while (m_sendOldestId != m_sendNextId) {
+        const ReliableSlot& slot = m_sendQueue[m_sendOldestId % RELIABLE_WINDOW];
+        if (slot.used && slot.id == m_sendOldestId) {
+            break;
+        }
+        ++m_sendOldestId;
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void Connection::updateBandwidth(i64 now) {
+    const i64 elapsed = now - m_bandwidthWindowStart;
+    if (elapsed < BANDWIDTH_WINDOW_NS) {
+        return;
+    }
+    const f32 seconds = static_cast<f32>(elapsed) * 1e-9f;
+    m_outgoingBandwidth = static_cast<f32>(m_bytesSentWindow) / seconds;
+    m_incomingBandwidth = static_cast<f32>(m_bytesReceivedWindow) / seconds;
+    m_bytesSentWindow = 0;
+    m_bytesReceivedWindow = 0;
+    m_bandwidthWindowStart = now;
+}
+
+void Connection::fillStats(ecs::NetworkStatsComponent& stats) const {
+    stats.ping = m_rtt;
+    stats.jitter = m_rttJitter;
+    stats.packetLoss = m_packetLoss;
+    stats.packetsReceived = m_packetsReceived;
+    stats.packetsSent = m_packetsSent;
+    stats.bytesReceived = m_bytesReceived;
+    stats.bytesSent = m_bytesSent;
+    stats.incomingBandwidth = m_incomingBandwidth;
+    stats.outgoingBandwidth = m_outgoingBandwidth;
+}
+
+} // namespace cscpp::network
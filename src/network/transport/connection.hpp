@@ -0,0 +1,191 @@
+#pragma once
+
+/**
+ * @file connection.hpp
+ * @brief Sequenced UDP connection with a reliable ordered channel
+ *
+ * Every datagram carries a 16-bit sequence number plus an ack of the newest
+ * sequence received and a 32-bit mask of the ones before it, so each packet
+ * acknowledges the last 33. Unreliable payloads (snapshots, commands) ride
+ * in the packet body as-is. Reliable messages sit in a fixed send window
+ * and are piggybacked on outgoing packets until a packet carrying them is
+ * acked; the receiver delivers them once each, in order.
+ *
+ * Packet layout (little-endian bytes):
+ *   u16 magic | u16 sequence | u16 ack | u32 ackBits | u8 reliableCount
+ *   reliableCount x { u16 messageId | u16 size | bytes }
+ *   unreliable payload (rest of the datagram)
+ *
+ * All state is fixed-size; nothing allocates after construction.
+ */
+
+#include "core/types.hpp"
+#include "ecs/components/network.hpp"
+#include "network/protocol/messages.hpp"
+#include "network/transport/udp_socket.hpp"
+
+#include <array>
+#include <span>
+
+namespace cscpp::network {
+
+/// true if sequence a is newer than b (with wrap-around)
+inline bool sequenceGreater(u16 a, u16 b) {
+    return static_cast<i16>(static_cast<u16>(a - b)) > 0;
+}
+
+class Connection {
+public:
+    static constexpr u16 PACKET_MAGIC = static_cast<u16>(0xC500 | (PROTOCOL_VERSION & 0xFF));
+    static constexpr u32 HEADER_SIZE = 11;
+    static constexpr u32 RELIABLE_HEADER_SIZE = 4;
+    
+    static constexpr u32 SENT_HISTORY = 256;            ///< Sent packets remembered for acks
+    static constexpr u32 RELIABLE_WINDOW = 32;          ///< Unacked reliable messages in flight
+    static constexpr u32 MAX_RELIABLE_SIZE = 512;
+    static constexpr u32 MAX_RELIABLE_PER_PACKET = 16;
+    
+    /// Largest unreliable payload that fits a datagram
+    static constexpr u32 MAX_PAYLOAD_SIZE = MAX_DATAGRAM_SIZE - HEADER_SIZE;
+    
+    static constexpr i64 KEEPALIVE_INTERVAL_NS = 100'000'000;
+    static constexpr i64 MIN_RESEND_DELAY_NS = 20'000'000;
+    
+    void reset(const NetAddress& address, i64 now);
+    
+    const NetAddress& getAddress() const { return m_address; }
+    
+    // ========================================================================
+    // Sending
+    // ========================================================================
+    
+    /// Queue a reliable message; false if the window is full or it is too large
+    bool queueReliable(std::span<const u8> message);
+    
+    /// Reliable messages not yet acknowledged
+    u32 getReliablePending() const { return static_cast<u16>(m_sendNextId - m_sendOldestId); }
+    
+    /**
+     * @brief Build the next datagram
+     * @param payload Unreliable body (may be empty)
+     * @return false if the payload does not fit
+     *
+     * Reliable messages due for (re)sending are added while space remains.
+     */
+    bool writePacket(std::span<const u8> payload, i64 now, Datagram& out);
+    
+    /// Something must go out even without a payload (resends, keepalive)
+    bool needsSend(i64 now) const;
+    
+    // ========================================================================
+    // Receiving
+    // ========================================================================
+    
+    /**
+     * @brief Process a datagram from this connection's peer
+     * @param onReliable Called once per newly deliverable reliable message, in order
+     * @param payload Set to the unreliable body
+     * @return false for foreign, malformed and duplicate packets
+     */
+    template<typename ReliableHandler>
+    bool readPacket(std::span<const u8> data, i64 now, ReliableHandler&& onReliable,
+                    std::span<const u8>& payload) {
+        size_t offset = 0;
+        if (!readHeaderAndReliable(data, now, offset)) {
+            return false;
+        }
+        deliverReliable(onReliable);
+        payload = data.subspan(offset);
+        return true;
+    }
+    
+    bool isTimedOut(i64 now, i64 timeoutNanos) const { return now - m_lastReceiveTime > timeoutNanos; }
+    
+    // ========================================================================
+    // Statistics
+    // ========================================================================
+    
+    f32 getRoundTripTime() const { return m_rtt; }
+    f32 getPacketLoss() const { return m_packetLoss; }
+    
+    /// Datagram bytes (headers included) since reset()
+    u64 getBytesSent() const { return m_bytesSent; }
+    u64 getBytesReceived() const { return m_bytesReceived; }
+    
+    /// Copy link statistics into an ECS component
+    void fillStats(ecs::NetworkStatsComponent& stats) const;
+    
+private:
+    struct SentPacket {
+        u16 sequence = 0;
+        bool valid = false;
+        bool acked = false;
+        u8 reliableCount = 0;
+        i64 sendTime = 0;
+        std::array<u16, MAX_RELIABLE_PER_PACKET> reliableIds{};
+    };
+    
+    struct ReliableSlot {
+        bool used = false;
+        u16 id = 0;
+        u16 size = 0;
+        i64 lastSent = -1;
+        std::array<u8, MAX_RELIABLE_SIZE> data{};
+    };
+    
+    bool readHeaderAndReliable(std::span<const u8> data, i64 now, size_t& offset);
+    void processAcks(u16 ack, u32 ackBits, i64 now);
+    void onPacketAcked(SentPacket& packet, i64 now);
+    i64 getResendDelay() const;
+    void updateBandwidth(i64 now);
+    
+    template<typename ReliableHandler>
+    void deliverReliable(ReliableHandler& onReliable) {
+        for (;;) {
+            ReliableSlot& slot = m_recvQueue[m_recvNextId % RELIABLE_WINDOW];
+            if (!slot.used || slot.id != m_recvNextId) {
+                return;
+            }
+            onReliable(std::span<const u8>(slot.data.data(), slot.size));
+            slot.used = false;
+            ++m_recvNextId;
+        }
+    }
+    
+    NetAddress m_address;
+    
+    // Packet sequencing
+    u16 m_localSequence = 0;
+    u16 m_remoteSequence = 0;
+    bool m_hasRemote = false;
+    u32 m_receivedBits = 0;             ///< Bit i: remoteSequence - 1 - i received
+    u16 m_lossCursor = 0;               ///< Oldest sent sequence not yet judged lost/acked
+    std::array<SentPacket, SENT_HISTORY> m_sent;
+    
+    // Reliable channel
+    std::array<ReliableSlot, RELIABLE_WINDOW> m_sendQueue;
+    u16 m_sendNextId = 0;
+    u16 m_sendOldestId = 0;
+    std::array<ReliableSlot, RELIABLE_WINDOW> m_recvQueue;
+    u16 m_recvNextId = 0;
+    
+    // Timing and statistics
+    i64 m_lastSendTime = 0;
+    i64 m_lastReceiveTime = 0;
+    f32 m_rtt = 0.0f;
+    f32 m_rttJitter = 0.0f;
+    bool m_hasRtt = false;
+    f32 m_packetLoss = 0.0f;
+    u32 m_packetsSent = 0;
+    u32 m_packetsReceived = 0;
+    u64 m_bytesSent = 0;
+    u64 m_bytesReceived = 0;
+    
+    i64 m_bandwidthWindowStart = 0;
+    u64 m_bytesSentWindow = 0;
+    u64 m_bytesReceivedWindow = 0;
+    f32 m_outgoingBandwidth = 0.0f;
+    f32 m_incomingBandwidth = 0.0f;
+};
+
+} // namespace cscpp::network
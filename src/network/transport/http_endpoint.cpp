@@ -0,0 +1,308 @@
+/**
+ * @file http_endpoint.cpp
+ * @brief Non-blocking HTTP/1.0 responder
+ */
+
+#include "network/transport/http_endpoint.hpp"
+
+#include <cstring>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace cscpp::network {
+
+namespace {
+
+#if defined(_WIN32)
+constexpr HttpEndpoint::NativeSocket INVALID_NATIVE_SOCKET = static_cast<std::uintptr_t>(INVALID_SOCKET);
+
+/// Winsock needs one WSAStartup per process (calls are reference counted)
+struct WinsockInit {
+    WinsockInit() {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+    ~WinsockInit() { WSACleanup(); }
+};
+
+void ensureWinsock() {
+    static WinsockInit init;
+}
+
+bool wouldBlock() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+void closeNative(HttpEndpoint::NativeSocket socket) {
+    closesocket(static_cast<SOCKET>(socket));
+}
+
+void setNonBlocking(HttpEndpoint::NativeSocket socket) {
+    u_long nonBlocking = 1;
+    ioctlsocket(static_cast<SOCKET>(socket), FIONBIO, &nonBlocking);
+}
+
+constexpr int SEND_FLAGS = 0;
+#else
+constexpr int INVALID_NATIVE_SOCKET = -1;
+
+bool wouldBlock() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+void closeNative(int socket) {
+    ::close(socket);
+}
+
+void setNonBlocking(int socket) {
+    const int flags = fcntl(socket, F_GETFL, 0);
+    fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+}
+
+#if defined(MSG_NOSIGNAL)
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;    // A scraper hanging up must not raise SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+#endif
+
+const char* statusText(u32 status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        default:  return "Error";
+    }
+}
+
+} // anonymous namespace
+
+HttpEndpoint::HttpEndpoint()
+    : m_listen(INVALID_NATIVE_SOCKET)
+    , m_client(INVALID_NATIVE_SOCKET) {
+}
+
+HttpEndpoint::~HttpEndpoint() {
+    close();
+}
+
+bool HttpEndpoint::isOpen() const {
+    return m_listen != INVALID_NATIVE_SOCKET;
+}
+
+Result<void> HttpEndpoint::open(u16 port) {
+    close();
+
+#if defined(_WIN32)
+    ensureWinsock();
+    SOCKET s = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) {
+        return std::unexpected(Error{"Failed to create TCP socket"});
+    }
+    m_listen = static_cast<NativeSocket>(s);
+#else
+    m_listen = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_listen < 0) {
+        m_listen = INVALID_NATIVE_SOCKET;
+        return std::unexpected(Error{"Failed to create TCP socket"});
+    }
+#endif
+    setNonBlocking(m_listen);
+    
+    // Restarts must not wait for TIME_WAIT on the old listener
+    const int reuse = 1;
+    setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (::bind(m_listen, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::listen(m_listen, 4) != 0) {
+        close();
+        return std::unexpected(Error{"Failed to listen on TCP port " + std::to_string(port)});
+    }
+    
+    sockaddr_in bound{};
+#if defined(_WIN32)
+    int boundSize = sizeof(bound);
+#else
+    socklen_t boundSize = sizeof(bound);
+#endif
+    getsockname(m_listen, reinterpret_cast<sockaddr*>(&bound), &boundSize);
+    m_localPort = ntohs(bound.sin_port);
+    
+    return {};
+}
+
+void HttpEndpoint::close() {
+    closeClient();
+    if (m_listen == INVALID_NATIVE_SOCKET) {
+        return;
+    }
+    closeNative(m_listen);
+    m_listen = INVALID_NATIVE_SOCKET;
+    m_localPort = 0;
+}
+
+// ============================================================================
+// Connection
+// ============================================================================
+
+bool HttpEndpoint::poll(i64 now) {
+    if (!isOpen()) {
+        return false;
+    }
+    
+    if (m_state != State::Idle && now - m_clientStart > CLIENT_TIMEOUT_NS) {
+        closeClient();
+    }
+    
+    switch (m_state) {
+        case State::Idle:
+            acceptClient(now);
+            if (m_state != State::Reading) {
+                return false;
+            }
+            readRequest();
+            break;
+        case State::Reading:
+            readRequest();
+            break;
+        case State::Writing:
+            writeResponse();
+            break;
+        case State::Pending:
+            break;
+    }
+    return m_state == State::Pending;
+}
+
+void HttpEndpoint::respond(u32 status, std::string_view contentType, std::string_view body) {
+    if (m_state != State::Pending) {
+        return;
+    }
+    
+    m_response = "HTTP/1.0 ";
+    m_response += std::to_string(status);
+    m_response += ' ';
+    m_response += statusText(status);
+    m_response += "\r\nContent-Type: ";
+    m_response += contentType;
+    m_response += "\r\nContent-Length: ";
+    m_response += std::to_string(body.size());
+    m_response += "\r\nConnection: close\r\n\r\n";
+    m_response += body;
+    m_responseSent = 0;
+    
+    m_state = State::Writing;
+    writeResponse();
+}
+
+void HttpEndpoint::acceptClient(i64 now) {
+#if defined(_WIN32)
+    const SOCKET client = ::accept(static_cast<SOCKET>(m_listen), nullptr, nullptr);
+    if (client == INVALID_SOCKET) {
+        return;
+    }
+    m_client = static_cast<NativeSocket>(client);
+#else
+    m_client = ::accept(m_listen, nullptr, nullptr);
+    if (m_client < 0) {
+        m_client = INVALID_NATIVE_SOCKET;
+        return;
+    }
+#endif
+    setNonBlocking(m_client);
+    
+    m_state = State::Reading;
+    m_clientStart = now;
+    m_request.clear();
+    m_path.clear();
+}
+
+void HttpEndpoint::readRequest() {
+    char buffer[1024];
+    for (;;) {
+        const auto bytes = ::recv(m_client, buffer, sizeof(buffer), 0);
+        if (bytes == 0 || (bytes < 0 && !wouldBlock())) {
+            closeClient();
+            return;
+        }
+        if (bytes < 0) {
+            break;
+        }
+        m_request.append(buffer, static_cast<size_t>(bytes));
+        if (m_request.size() > MAX_REQUEST_SIZE) {
+            closeClient();
+            return;
+        }
+    }
+    
+    // Only the request line matters; wait for the end of the header
+    if (m_request.find("\r\n\r\n") == std::string::npos) {
+        return;
+    }
+    
+    const std::string_view request = m_request;
+    const size_t methodEnd = request.find(' ');
+    const size_t pathEnd = methodEnd == std::string_view::npos
+        ? std::string_view::npos
+        : request.find_first_of(" ?\r", methodEnd + 1);
+    
+    m_state = State::Pending;
+    if (pathEnd == std::string_view::npos) {
+        respond(400, "text/plain", "Bad Request\n");
+        return;
+    }
+    if (request.substr(0, methodEnd) != "GET") {
+        respond(405, "text/plain", "Method Not Allowed\n");
+        return;
+    }
+    m_path.assign(request.substr(methodEnd + 1, pathEnd - methodEnd - 1));
+}
+
+void HttpEndpoint::writeResponse() {
+    while (m_responseSent < m_response.size()) {
+        const auto bytes = ::send(m_client, m_response.data() + m_responseSent,
+                                  static_cast<int>(m_response.size() - m_responseSent), SEND_FLAGS);
+        if (bytes < 0 && wouldBlock()) {
+            return;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+        m_responseSent += static_cast<size_t>(bytes);
+    }
+    closeClient();
+}
+
+void HttpEndpoint::closeClient() {
+    if (m_client != INVALID_NATIVE_SOCKET) {
+        closeNative(m_client);
+        m_client = INVALID_NATIVE_SOCKET;
+    }
+    m_state = State::Idle;
+    m_request.clear();
+    m_response.clear();
+    m_responseSent = 0;
+}
+
+} // namespace cscpp::network
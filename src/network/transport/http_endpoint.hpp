@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file http_endpoint.hpp
+ * @brief Minimal non-blocking HTTP/1.0 responder for scrape endpoints
+ *
+ * Serves one TCP connection at a time and never blocks: the owner calls
+ * poll() from its loop, and when a GET request has been read it answers
+ * with respond(). Everything else gets a 405. Meant for metrics scrapers
+ * and health checks, not for general traffic; the response is written
+ * over as many polls as the socket needs and the connection is closed
+ * after it.
+ */
+
+#include "core/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cscpp::network {
+
+class HttpEndpoint {
+public:
+    static constexpr u32 MAX_REQUEST_SIZE = 4096;
+    static constexpr i64 CLIENT_TIMEOUT_NS = 2'000'000'000;
+    
+    HttpEndpoint();
+    ~HttpEndpoint();
+    
+    HttpEndpoint(const HttpEndpoint&) = delete;
+    HttpEndpoint& operator=(const HttpEndpoint&) = delete;
+    
+    /// Listen on a TCP port (0 = any) on all interfaces
+    Result<void> open(u16 port);
+    
+    void close();
+    
+    bool isOpen() const;
+    u16 getLocalPort() const { return m_localPort; }
+    
+    /**
+     * @brief Accept, read and write without blocking
+     * @return true when a GET request is waiting for respond()
+     */
+    bool poll(i64 now);
+    
+    /// Path of the waiting request, e.g. "/metrics" (query string stripped)
+    std::string_view getRequestPath() const { return m_path; }
+    
+    /// Answer the waiting request; the connection closes once it is sent
+    void respond(u32 status, std::string_view contentType, std::string_view body);
+    
+#if defined(_WIN32)
+    using NativeSocket = std::uintptr_t;
+#else
+    using NativeSocket = int;
+#endif
+    
+private:
+    enum class State : u8 {
+        Idle,       ///< No connection
+        Reading,    ///< Waiting for the request header
+        Pending,    ///< Request read, waiting for respond()
+        Writing,    ///< Sending the response
+    };
+    
+    void acceptClient(i64 now);
+    void readRequest();
+    void writeResponse();
+    void closeClient();
+    
+    NativeSocket m_listen;
+    NativeSocket m_client;
+    u16 m_localPort = 0;
+    
+    State m_state = State::Idle;
+    i64 m_clientStart = 0;
+    std::string m_request;
+    std::string m_path;
+    std::string m_response;
+    size_t m_responseSent = 0;
+};
+
+} // namespace cscpp::network
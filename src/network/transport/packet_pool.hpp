@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file packet_pool.hpp
+ * @brief Fixed pool of datagram buffers
+ *
+ * All buffers are allocated up front; acquire() and release() are O(1) and
+ * never touch the heap. Not thread-safe: one pool per thread.
+ */
+
+#include "core/types.hpp"
+#include "network/transport/udp_socket.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace cscpp::network {
+
+class PacketPool {
+public:
+    explicit PacketPool(u32 capacity = 1024)
+        : m_storage(std::make_unique<Datagram[]>(capacity))
+        , m_capacity(capacity) {
+        m_free.reserve(capacity);
+        for (u32 i = capacity; i > 0; --i) {
+            m_free.push_back(&m_storage[i - 1]);
+        }
+    }
+    
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+    
+    /// A free buffer, or nullptr if the pool is exhausted
+    Datagram* acquire() {
+        if (m_free.empty()) {
+            return nullptr;
+        }
+        Datagram* datagram = m_free.back();
+        m_free.pop_back();
+        datagram->size = 0;
+        return datagram;
+    }
+    
+    void release(Datagram* datagram) {
+        if (datagram) {
+            m_free.push_back(datagram);
+        }
+    }
+    
+    u32 getCapacity() const { return m_capacity; }
+    u32 getFreeCount() const { return static_cast<u32>(m_free.size()); }
+    
+private:
+    std::unique_ptr<Datagram[]> m_storage;
+    u32 m_capacity;
+    std::vector<Datagram*> m_free;
+};
+
+} // namespace cscpp::network
@@ -0,0 +1,317 @@
+/**
+ * @file udp_socket.cpp
+ * @brief Non-blocking UDP socket
+ */
+
+#include "network/transport/udp_socket.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace cscpp::network {
+
+namespace {
+
+#if defined(_WIN32)
+constexpr UdpSocket::NativeSocket INVALID_NATIVE_SOCKET = static_cast<std::uintptr_t>(INVALID_SOCKET);
+
+/// Winsock needs one WSAStartup per process
+struct WinsockInit {
+    WinsockInit() {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+    ~WinsockInit() { WSACleanup(); }
+};
+
+void ensureWinsock() {
+    static WinsockInit init;
+}
+#else
+constexpr int INVALID_NATIVE_SOCKET = -1;
+#endif
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in out{};
+    out.sin_family = AF_INET;
+    out.sin_addr.s_addr = htonl(address.ip);
+    out.sin_port = htons(address.port);
+    return out;
+}
+
+NetAddress fromSockaddr(const sockaddr_in& in) {
+    NetAddress out;
+    out.ip = ntohl(in.sin_addr.s_addr);
+    out.port = ntohs(in.sin_port);
+    return out;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Address
+// ============================================================================
+
+std::string NetAddress::toString() const {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u:%u",
+                  (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF,
+                  static_cast<u32>(port));
+    return buffer;
+}
+
+bool NetAddress::parse(const std::string& text, NetAddress& out) {
+    u32 a, b, c, d, p;
+    if (std::sscanf(text.c_str(), "%u.%u.%u.%u:%u", &a, &b, &c, &d, &p) != 5 ||
+        a > 255 || b > 255 || c > 255 || d > 255 || p > 65535) {
+        return false;
+    }
+    out.ip = (a << 24) | (b << 16) | (c << 8) | d;
+    out.port = static_cast<u16>(p);
+    return true;
+}
+
+// ============================================================================
+// Socket
+// ============================================================================
+
+struct UdpSocket::Scratch {
+    std::array<sockaddr_in, MAX_BATCH> addresses;
+#if defined(__linux__)
+    std::array<iovec, MAX_BATCH> iovecs;
+    std::array<mmsghdr, MAX_BATCH> messages;
+#endif
+};
+
+UdpSocket::UdpSocket()
+    : m_socket(INVALID_NATIVE_SOCKET)
+    , m_scratch(std::make_unique<Scratch>()) {
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::isOpen() const {
+    return m_socket != INVALID_NATIVE_SOCKET;
+}
+
+Result<void> UdpSocket::open(u16 port, u32 bufferBytes) {
+    close();
+    
+#if defined(_WIN32)
+    ensureWinsock();
+    SOCKET s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        return std::unexpected(Error{"Failed to create UDP socket"});
+    }
+    m_socket = static_cast<NativeSocket>(s);
+    
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    m_socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_socket < 0) {
+        m_socket = INVALID_NATIVE_SOCKET;
+        return std::unexpected(Error{"Failed to create UDP socket"});
+    }
+    
+    const int flags = fcntl(m_socket, F_GETFL, 0);
+    fcntl(m_socket, F_SETFL, flags | O_NONBLOCK);
+#endif
+    
+    // Large kernel buffers absorb a whole tick of snapshots for every client
+    const int buffer = static_cast<int>(bufferBytes);
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&buffer), sizeof(buffer));
+    setsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&buffer), sizeof(buffer));
+    
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+        close();
+        return std::unexpected(Error{"Failed to bind UDP port " + std::to_string(port)});
+    }
+    
+    sockaddr_in bound{};
+#if defined(_WIN32)
+    int boundSize = sizeof(bound);
+#else
+    socklen_t boundSize = sizeof(bound);
+#endif
+    getsockname(m_socket, reinterpret_cast<sockaddr*>(&bound), &boundSize);
+    m_localPort = ntohs(bound.sin_port);
+    
+    return {};
+}
+
+void UdpSocket::close() {
+    if (m_socket == INVALID_NATIVE_SOCKET) {
+        return;
+    }
+#if defined(_WIN32)
+    closesocket(static_cast<SOCKET>(m_socket));
+#else
+    ::close(m_socket);
+#endif
+    m_socket = INVALID_NATIVE_SOCKET;
+    m_localPort = 0;
+}
+
+u32 UdpSocket::receive(std::span<Datagram*> out) {
+    if (!isOpen() || out.empty()) {
+        return 0;
+    }
+    const u32 count = std::min<u32>(static_cast<u32>(out.size()), MAX_BATCH);
+    
+#if defined(__linux__)
+    for (u32 i = 0; i < count; ++i) {
+        m_scratch->iovecs[i].iov_base = out[i]->data.data();
+        m_scratch->iovecs[i].iov_len = out[i]->data.size();
+        
+        msghdr& header = m_scratch->messages[i].msg_hdr;
+        header = msghdr{};
+        header.msg_name = &m_scratch->addresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &m_scratch->iovecs[i];
+        header.msg_iovlen = 1;
+    }
+    
+    const int received = recvmmsg(m_socket, m_scratch->messages.data(), count, MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        return 0;
+    }
+    
+    for (int i = 0; i < received; ++i) {
+        out[i]->address = fromSockaddr(m_scratch->addresses[i]);
+        out[i]->size = m_scratch->messages[i].msg_len;
+    }
+    return static_cast<u32>(received);
+#else
+    u32 received = 0;
+    for (; received < count; ++received) {
+        sockaddr_in from{};
+    #if defined(_WIN32)
+        int fromSize = sizeof(from);
+    #else
+        socklen_t fromSize = sizeof(from);
+    #endif
+        const auto bytes = recvfrom(m_socket, reinterpret_cast<char*>(out[received]->data.data()),
+                                    static_cast<int>(out[received]->data.size()), 0,
+                                    reinterpret_cast<sockaddr*>(&from), &fromSize);
+        if (bytes <= 0) {
+            break;
+        }
+        out[received]->address = fromSockaddr(from);
+        out[received]->size = static_cast<u32>(bytes);
+    }
+    return received;
+#endif
+}
+
+u32 UdpSocket::send(std::span<const Datagram* const> datagrams) {
+    if (!isOpen()) {
+        return 0;
+    }
+    
+    u32 sent = 0;
+    while (sent < datagrams.size()) {
+        const u32 count = std::min<u32>(static_cast<u32>(datagrams.size()) - sent, MAX_BATCH);
+        
+#if defined(__linux__)
+        for (u32 i = 0; i < count; ++i) {
+            const Datagram& datagram = *datagrams[sent + i];
+            m_scratch->addresses[i] = toSockaddr(datagram.address);
+            m_scratch->iovecs[i].iov_base = const_cast<u8*>(datagram.data.data());
+            m_scratch->iovecs[i].iov_len = datagram.size;
+            
+            msghdr& header = m_scratch->messages[i].msg_hdr;
+            header = msghdr{};
+            header.msg_name = &m_scratch->addresses[i];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = &m_scratch->iovecs[i];
+            header.msg_iovlen = 1;
+        }
+        
+        const int result = sendmmsg(m_socket, m_scratch->messages.data(), count, MSG_DONTWAIT);
+        if (result <= 0) {
+            break;      // Kernel buffer full; the rest is dropped like any lost datagram
+        }
+        sent += static_cast<u32>(result);
+        if (static_cast<u32>(result) < count) {
+            break;
+        }
+#else
+        u32 batchSent = 0;
+        for (; batchSent < count; ++batchSent) {
+            const Datagram& datagram = *datagrams[sent + batchSent];
+            const sockaddr_in to = toSockaddr(datagram.address);
+            const auto bytes = sendto(m_socket, reinterpret_cast<const char*>(datagram.data.data()),
+                                      static_cast<int>(datagram.size), 0,
+                                      reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+            if (bytes < 0) {
+                break;
+            }
+        }
+        sent += batchSent;
+        if (batchSent < count) {
+            break;
+        }
+#endif
+    }
+    return sent;
+}
+
+bool UdpSocket::waitReadable(i64 timeoutNanos) const {
+    if (!isOpen()) {
+        return false;
+    }
+    timeoutNanos = std::max<i64>(timeoutNanos, 0);
+    
+#if defined(__linux__)
+    // ppoll() takes the timeout at full resolution
+    pollfd fd{};
+    fd.fd = m_socket;
+    fd.events = POLLIN;
+    timespec timeout{};
+    timeout.tv_sec = static_cast<time_t>(timeoutNanos / 1'000'000'000);
+    timeout.tv_nsec = static_cast<long>(timeoutNanos % 1'000'000'000);
+    return ::ppoll(&fd, 1, &timeout, nullptr) > 0;
+#else
+    // Millisecond resolution: round up so short waits still block
+    const int timeoutMs = static_cast<int>((timeoutNanos + 999'999) / 1'000'000);
+    #if defined(_WIN32)
+    WSAPOLLFD fd{};
+    fd.fd = static_cast<SOCKET>(m_socket);
+    fd.events = POLLRDNORM;
+    return WSAPoll(&fd, 1, timeoutMs) > 0;
+    #else
+    pollfd fd{};
+    fd.fd = m_socket;
+    fd.events = POLLIN;
+    return ::poll(&fd, 1, timeoutMs) > 0;
+    #endif
+#endif
+}
+
+} // namespace cscpp::network
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file udp_socket.hpp
+ * @brief Non-blocking IPv4 UDP socket with batched send/receive
+ *
+ * On Linux a batch is one recvmmsg()/sendmmsg() call; elsewhere it falls
+ * back to one recvfrom()/sendto() per datagram behind the same interface.
+ * All syscall scratch space is preallocated for MAX_BATCH datagrams.
+ */
+
+#include "core/types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace cscpp::network {
+
+/// Largest datagram the transport sends (1500 MTU - IPv4 - UDP headers)
+constexpr u32 MAX_DATAGRAM_SIZE = 1472;
+
+/**
+ * @brief IPv4 endpoint (host byte order)
+ */
+struct NetAddress {
+    u32 ip = 0;
+    u16 port = 0;
+    
+    bool operator==(const NetAddress&) const = default;
+    
+    /// Unique 64-bit key for maps
+    u64 toKey() const { return (static_cast<u64>(ip) << 16) | port; }
+    
+    std::string toString() const;
+    
+    /// Parse "a.b.c.d:port"
+    static bool parse(const std::string& text, NetAddress& out);
+};
+
+/**
+ * @brief One datagram slot for batched I/O
+ */
+struct Datagram {
+    NetAddress address;
+    u32 size = 0;
+    std::array<u8, MAX_DATAGRAM_SIZE> data;
+};
+
+class UdpSocket {
+public:
+    static constexpr u32 MAX_BATCH = 64;
+    
+    UdpSocket();
+    ~UdpSocket();
+    
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+    
+    /**
+     * @brief Bind to a local port (0 = any) on all interfaces
+     * @param bufferBytes Kernel send/receive buffer size request
+     */
+    Result<void> open(u16 port, u32 bufferBytes = 4 * 1024 * 1024);
+    
+    void close();
+    
+    bool isOpen() const;
+    u16 getLocalPort() const { return m_localPort; }
+    
+    /**
+     * @brief Receive up to out.size() (max MAX_BATCH) datagrams without blocking
+     * @return Number of datagrams filled in
+     */
+    u32 receive(std::span<Datagram*> out);
+    
+    /**
+     * @brief Send datagrams (max MAX_BATCH per syscall, larger spans loop)
+     * @return Number of datagrams the kernel accepted
+     */
+    u32 send(std::span<const Datagram* const> datagrams);
+    
+    /// Block until readable or the timeout expires; true if data is waiting
+    bool waitReadable(i64 timeoutNanos) const;
+    
+#if defined(_WIN32)
+    using NativeSocket = std::uintptr_t;
+#else
+    using NativeSocket = int;
+#endif
+    
+private:
+    NativeSocket m_socket;
+    u16 m_localPort = 0;
+    
+    // Syscall scratch (sockaddr/iovec/mmsghdr arrays), allocated once
+    struct Scratch;
+    std::unique_ptr<Scratch> m_scratch;
+};
+
+} // namespace cscpp::network
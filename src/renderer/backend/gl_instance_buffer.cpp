@@ -0,0 +1,126 @@
+#include "renderer/backend/gl_instance_buffer.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace cscpp::renderer {
+
+GLInstanceBuffer::~GLInstanceBuffer() {
+    shutdown();
+}
+
+Result<void> GLInstanceBuffer::initialize() {
+    shutdown();
+
+    // Slices are bound with glBindBufferRange, so each one starts on the storage offset alignment
+    GLint alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const u64 align = static_cast<u64>(std::max(alignment, 1));
+    m_sliceSize = (MAX_INSTANCES * sizeof(InstanceData) + align - 1) / align * align;
+    const u64 size = m_sliceSize * FRAMES_IN_FLIGHT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    if (GLAD_GL_VERSION_4_4) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, flags);
+        m_mapped = static_cast<u8*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(size), flags));
+    }
+    if (m_mapped == nullptr) {
+        while (glGetError() != GL_NO_ERROR) {}
+        glDeleteBuffers(1, &m_buffer);
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(m_sliceSize), nullptr, GL_STREAM_DRAW);
+        m_fallback.resize(MAX_INSTANCES);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (m_mapped == nullptr) {
+        return std::unexpected(Error{"Persistent buffer mapping not supported, uploading instances per frame"});
+    }
+    LOG_INFO("Instance ring: {} frames of {} instances", FRAMES_IN_FLIGHT, MAX_INSTANCES);
+    return {};
+}
+
+void GLInstanceBuffer::shutdown() {
+    for (void*& fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (m_buffer != 0) {
+        if (m_mapped != nullptr) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+            glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_fallback = {};
+    m_sliceSize = 0;
+    m_slice = 0;
+    m_frameCount = 0;
+    m_sliceReady = false;
+}
+
+void GLInstanceBuffer::waitForSlice() {
+    CSCPP_PROFILE_FUNCTION();
+    GLsync fence = static_cast<GLsync>(m_fences[m_slice]);
+    if (fence != nullptr) {
+        // Only blocks when the GPU is FRAMES_IN_FLIGHT frames behind
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        m_fences[m_slice] = nullptr;
+    }
+    m_sliceReady = true;
+}
+
+std::span<InstanceData> GLInstanceBuffer::allocate(u32 count, u32& first) {
+    if (m_buffer == 0 || count == 0 || m_frameCount + count > MAX_INSTANCES) {
+        return {};
+    }
+    if (!m_sliceReady) {
+        waitForSlice();
+    }
+
+    InstanceData* slice = m_mapped != nullptr
+        ? reinterpret_cast<InstanceData*>(m_mapped + m_slice * m_sliceSize)
+        : m_fallback.data();
+    first = m_frameCount;
+    m_frameCount += count;
+    return {slice + first, count};
+}
+
+void GLInstanceBuffer::bind() {
+    if (m_frameCount == 0) {
+        return;
+    }
+    const GLintptr offset = m_mapped != nullptr ? static_cast<GLintptr>(m_slice * m_sliceSize) : 0;
+    if (m_mapped == nullptr) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(m_frameCount * sizeof(InstanceData)),
+                        m_fallback.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, INSTANCE_STORAGE_BINDING, m_buffer, offset,
+                      static_cast<GLsizeiptr>(m_sliceSize));
+}
+
+void GLInstanceBuffer::endFrame() {
+    if (m_frameCount == 0) {
+        return;
+    }
+    if (m_mapped != nullptr) {
+        m_fences[m_slice] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_slice = (m_slice + 1) % FRAMES_IN_FLIGHT;
+    }
+    m_frameCount = 0;
+    m_sliceReady = false;
+}
+
+} // namespace cscpp::renderer
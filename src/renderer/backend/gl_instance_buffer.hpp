@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @file gl_instance_buffer.hpp
+ * @brief Per-instance data streamed through a persistently mapped ring
+ *
+ * The ring is split into FRAMES_IN_FLIGHT slices. A frame's instances are
+ * written straight into its slice by the CPU while the GPU still reads the
+ * previous ones; the slice is bound as a shader storage buffer for the
+ * frame's draws and fenced after them, and is only written again once that
+ * fence has signalled. Shaders index it with the draw parameter
+ * (baseInstance + instance), so a slice holds at most MAX_DRAW_PARAMETER
+ * instances.
+ *
+ * Without GL 4.4 buffer storage the slice is a client-side array uploaded
+ * with one glBufferSubData when it is bound.
+ *
+ * GL thread only.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "renderer/backend/gl_mesh.hpp"
+
+#include <span>
+#include <vector>
+
+namespace cscpp::renderer {
+
+/// std430 layout of one element of the Instances buffer in instanced.vert
+struct InstanceData {
+    Mat4 model;
+    Vec4 color;
+};
+static_assert(sizeof(InstanceData) == 80, "InstanceData must match the std430 block");
+
+/// Shader storage binding point of the instance ring
+inline constexpr u32 INSTANCE_STORAGE_BINDING = 0;
+
+class GLInstanceBuffer {
+public:
+    static constexpr u32 FRAMES_IN_FLIGHT = 3;
+    static constexpr u32 MAX_INSTANCES = MAX_DRAW_PARAMETER;   ///< Per frame
+
+    GLInstanceBuffer() = default;
+    ~GLInstanceBuffer();
+
+    GLInstanceBuffer(const GLInstanceBuffer&) = delete;
+    GLInstanceBuffer& operator=(const GLInstanceBuffer&) = delete;
+
+    /// Create and map the ring (a client-side slice is used if mapping is unsupported)
+    Result<void> initialize();
+
+    void shutdown();
+
+    /// True if instances are written straight into mapped GPU memory
+    bool isPersistent() const { return m_mapped != nullptr; }
+
+    /**
+     * @brief Reserve instances in this frame's slice
+     * @param first Index of the first one, the baseInstance of draws using them
+     * @return The instances to fill, empty if the slice is full
+     */
+    std::span<InstanceData> allocate(u32 count, u32& first);
+
+    /// Bind this frame's slice to INSTANCE_STORAGE_BINDING (uploads it without persistent mapping)
+    void bind();
+
+    /// Fence this frame's slice after its draws and move on to the next one
+    void endFrame();
+
+    /// Instances reserved this frame
+    u32 getFrameCount() const { return m_frameCount; }
+
+private:
+    /// Wait until the GPU is done with the current slice (it was fenced FRAMES_IN_FLIGHT frames ago)
+    void waitForSlice();
+
+    u32 m_buffer = 0;
+    u8* m_mapped = nullptr;
+    std::vector<InstanceData> m_fallback;   // One slice without persistent mapping
+    u64 m_sliceSize = 0;                    // Bytes, rounded up to the storage offset alignment
+    u32 m_slice = 0;
+    u32 m_frameCount = 0;
+    bool m_sliceReady = false;              // waitForSlice() ran for the current slice
+    void* m_fences[FRAMES_IN_FLIGHT] = {};  // GLsync of each slice's last use
+};
+
+} // namespace cscpp::renderer
@@ -1,22 +1,164 @@
 #include "renderer/backend/gl_mesh.hpp"
+#include "renderer/backend/gl_state_cache.hpp"
 #include "core/logging/logger.hpp"
 #include <glad/glad.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <numeric>
 
 namespace cscpp::renderer {
 
+// ============================================================================
+// Packing
+// ============================================================================
+
+/// IEEE half from float, round to nearest even (overflow saturates to infinity)
+static u16 floatToHalf(f32 value) {
+    const u32 bits = std::bit_cast<u32>(value);
+    const u16 sign = static_cast<u16>((bits >> 16) & 0x8000u);
+    const u32 magnitude = bits & 0x7FFFFFFFu;
+    
+    if (magnitude >= 0x7F800000u) {
+        return static_cast<u16>(sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u));     // NaN, infinity
+    }
+    if (magnitude >= 0x477FF000u) {
+        return static_cast<u16>(sign | 0x7C00u);                                              // Too large
+    }
+    if (magnitude < 0x38800000u) {
+        // Subnormal half: shift the mantissa (with its implicit bit) into place
+        const u32 exponent = magnitude >> 23;
+        if (exponent < 102) {
+            return sign;
+        }
+        const u32 mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const u32 shift = 126 - exponent;
+        u32 half = mantissa >> shift;
+        const u32 rest = mantissa & ((1u << shift) - 1);
+        const u32 halfway = 1u << (shift - 1);
+        half += (rest > halfway || (rest == halfway && (half & 1u))) ? 1u : 0u;
+        return static_cast<u16>(sign | half);
+    }
+    
+    const u32 rebased = magnitude - (112u << 23);
+    u32 half = rebased >> 13;
+    const u32 rest = rebased & 0x1FFFu;
+    half += (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ? 1u : 0u;
+    return static_cast<u16>(sign | half);
+}
+
+static i16 toSnorm16(f32 value) {
+    return static_cast<i16>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static u16 toUnorm16(f32 value) {
+    return static_cast<u16>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+PackedVertex packVertex(const Vertex& vertex) {
+    PackedVertex packed;
+    packed.position[0] = vertex.position.x;
+    packed.position[1] = vertex.position.y;
+    packed.position[2] = vertex.position.z;
+    
+    // Octahedral: project onto |x| + |y| + |z| = 1, fold the lower half over the diagonals
+    const Vec3 n = vertex.normal;
+    const f32 l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    f32 x = l1 > 0.0f ? n.x / l1 : 0.0f;
+    f32 y = l1 > 0.0f ? n.y / l1 : 0.0f;
+    if (l1 > 0.0f && n.z < 0.0f) {
+        const f32 foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const f32 foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    packed.normal[0] = toSnorm16(x);
+    packed.normal[1] = toSnorm16(y);
+    
+    packed.texCoord[0] = floatToHalf(vertex.texCoord.x);
+    packed.texCoord[1] = floatToHalf(vertex.texCoord.y);
+    
+    packed.lightmapCoord[0] = toUnorm16(vertex.lightmapCoord.x);
+    packed.lightmapCoord[1] = toUnorm16(vertex.lightmapCoord.y);
+    packed.lightmapCoord[2] = static_cast<u16>(std::clamp(vertex.lightmapCoord.z, 0.0f, 65535.0f));
+    packed.padding = 0;
+    return packed;
+}
+
+std::vector<PackedVertex> packVertices(std::span<const Vertex> vertices) {
+    std::vector<PackedVertex> packed;
+    packed.reserve(vertices.size());
+    for (const Vertex& vertex : vertices) {
+        packed.push_back(packVertex(vertex));
+    }
+    return packed;
+}
+
+std::vector<u8> packIndices(std::span<const u32> indices, IndexType type) {
+    std::vector<u8> bytes(indices.size() * indexSize(type));
+    if (type == IndexType::U32) {
+        std::memcpy(bytes.data(), indices.data(), bytes.size());
+        return bytes;
+    }
+    u16* narrow = reinterpret_cast<u16*>(bytes.data());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        narrow[i] = static_cast<u16>(indices[i]);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// GLMesh
+// ============================================================================
+
+/// Buffer of the values 0..MAX_DRAW_PARAMETER-1, shared by every VAO (lives as long as the context)
+static u32 drawParameterBuffer() {
+    static const u32 buffer = [] {
+        std::vector<u32> values(MAX_DRAW_PARAMETER);
+        std::iota(values.begin(), values.end(), 0u);
+        u32 name = 0;
+        glGenBuffers(1, &name);
+        glBindBuffer(GL_ARRAY_BUFFER, name);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(values.size() * sizeof(u32)), values.data(),
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return name;
+    }();
+    return buffer;
+}
+
 GLMesh::~GLMesh() {
     destroy();
 }
 
 void GLMesh::create(const std::vector<Vertex>& vertices, const std::vector<u32>& indices) {
+    const IndexType indexType = selectIndexType(vertices.size());
+    const std::vector<PackedVertex> packed = packVertices(vertices);
+    const std::vector<u8> packedIndices = packIndices(indices, indexType);
+    createBuffers(static_cast<u32>(vertices.size()), static_cast<u32>(indices.size()), indexType, packed.data(),
+                  packedIndices.data());
+}
+
+void GLMesh::allocate(u32 vertexCount, u32 indexCount, IndexType indexType) {
+    createBuffers(vertexCount, indexCount, indexType, nullptr, nullptr);
+}
+
+u32 GLMesh::getGLIndexType() const {
+    return m_indexType == IndexType::U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void GLMesh::createBuffers(u32 vertexCount, u32 indexCount, IndexType indexType, const PackedVertex* vertices,
+                           const void* indices) {
     destroy();
     
-    if (vertices.empty() || indices.empty()) {
+    if (vertexCount == 0 || indexCount == 0) {
         return;
     }
     
-    m_indexCount = static_cast<u32>(indices.size());
+    m_indexCount = indexCount;
+    m_indexType = indexType;
     
     // Generate buffers
     glGenVertexArrays(1, &m_vao);
@@ -39,7 +181,7 @@ void GLMesh::create(const std::vector<Vertex>& vertices, const std::vector<u32>&
     }
     
     LOG_INFO("Created VAO: {}, VBO: {}, EBO: {}, vertices: {}, indices: {}", 
-             m_vao, m_vbo, m_ebo, vertices.size(), indices.size());
+             m_vao, m_vbo, m_ebo, vertexCount, indexCount);
     
     // Bind VAO
     glBindVertexArray(m_vao);
@@ -54,24 +196,38 @@ void GLMesh::create(const std::vector<Vertex>& vertices, const std::vector<u32>&
     }
     
     // Vertex buffer
+    const u64 vertexBytes = static_cast<u64>(vertexCount) * sizeof(PackedVertex);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexBytes), vertices, GL_STATIC_DRAW);
     
     // Index buffer (must be bound to VAO)
+    const u64 indexBytes = static_cast<u64>(indexCount) * indexSize(indexType);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(u32), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexBytes), indices, GL_STATIC_DRAW);
+    m_memorySize = vertexBytes + indexBytes;
     
     // Position attribute
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
     
-    // Normal attribute
+    // Normal attribute (octahedral, decoded in the shader)
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
     
     // TexCoord attribute
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord));
+    
+    // Lightmap attribute (fixed point in the page, page)
+    glEnableVertexAttribArray(LIGHTMAP_ATTRIBUTE);
+    glVertexAttribPointer(LIGHTMAP_ATTRIBUTE, 3, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PackedVertex),
+                          (void*)offsetof(PackedVertex, lightmapCoord));
+    
+    // Draw parameter: element baseInstance + instance of the 0, 1, 2, ... sequence
+    glBindBuffer(GL_ARRAY_BUFFER, drawParameterBuffer());
+    glEnableVertexAttribArray(DRAW_PARAMETER_ATTRIBUTE);
+    glVertexAttribIPointer(DRAW_PARAMETER_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(u32), nullptr);
+    glVertexAttribDivisor(DRAW_PARAMETER_ATTRIBUTE, 1);
     
     // Check for errors
     err = glGetError();
@@ -93,39 +249,11 @@ void GLMesh::draw() const {
         return;
     }
     
-    // Clear any previous errors
-    while (glGetError() != GL_NO_ERROR) {}
-    
-    // Bind VAO
     glBindVertexArray(m_vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), getGLIndexType(), nullptr);
+    CSCPP_GL_CHECK("GLMesh::draw");
     
-    // Verify VAO is actually bound
-    GLint boundVAO = 0;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &boundVAO);
-    if (boundVAO != static_cast<GLint>(m_vao)) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("VAO binding failed in draw! Expected: {}, Got: {}", m_vao, boundVAO);
-            logged = true;
-        }
-        return;
-    }
-    
-    // Draw
-    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
-    
-    // Check for immediate errors
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("OpenGL error immediately after glDrawElements: 0x{:X} (VAO: {}, indices: {})", 
-                     static_cast<u32>(err), m_vao, m_indexCount);
-            logged = true;
-        }
-    }
-    
-    // VAO remains bound for caller to check errors
+    // VAO remains bound for the caller
 }
 
 void GLMesh::destroy() {
@@ -142,6 +270,8 @@ void GLMesh::destroy() {
         m_vao = 0;
     }
     m_indexCount = 0;
+    m_indexType = IndexType::U32;
+    m_memorySize = 0;
 }
 
 } // namespace cscpp::renderer
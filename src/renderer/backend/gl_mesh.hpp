@@ -2,16 +2,74 @@
 
 #include "core/types.hpp"
 #include "core/math/math.hpp"
+#include <span>
 #include <vector>
 
 namespace cscpp::renderer {
 
+/// Vertex as loaders build it (and as cooked maps store it)
 struct Vertex {
     Vec3 position;
     Vec3 normal;
     Vec2 texCoord;
+    Vec3 lightmapCoord{};   ///< xy: 0..1 in the lightmap atlas page, z: page (maps only)
 };
 
+/**
+ * Vertex as GLMesh stores it on the GPU: the normal octahedral-encoded in
+ * two snorm16 (decoded by octDecode() in the vertex shaders), texture
+ * coordinates as half floats. Half floats keep 11 bits of mantissa, so map
+ * loaders rebase each face's coordinates next to zero (textures repeat)
+ * before packing. The lightmap coordinate is 16-bit fixed point in the
+ * page plus the page, read unnormalized (layered.vert divides by 65535).
+ * 28 bytes instead of 44.
+ */
+struct PackedVertex {
+    f32 position[3];
+    i16 normal[2];
+    u16 texCoord[2];
+    u16 lightmapCoord[3];
+    u16 padding;
+};
+static_assert(sizeof(PackedVertex) == 28, "PackedVertex is uploaded as is");
+
+/// Vertex attribute of PackedVertex::lightmapCoord (3 is DRAW_PARAMETER_ATTRIBUTE)
+inline constexpr u32 LIGHTMAP_ATTRIBUTE = 4;
+
+/// Pack loader vertices into the GPU layout (no GL calls, safe on workers)
+PackedVertex packVertex(const Vertex& vertex);
+std::vector<PackedVertex> packVertices(std::span<const Vertex> vertices);
+
+/// Width of a mesh's index buffer
+enum class IndexType : u8 {
+    U16,
+    U32,
+};
+
+/// Smallest index type addressing `vertexCount` vertices (indices are relative to a draw's baseVertex)
+constexpr IndexType selectIndexType(u64 vertexCount) {
+    return vertexCount <= 65536 ? IndexType::U16 : IndexType::U32;
+}
+
+constexpr u32 indexSize(IndexType type) {
+    return type == IndexType::U16 ? 2 : 4;
+}
+
+/// Indices narrowed to `type`, as the bytes to upload (no GL calls, safe on workers)
+std::vector<u8> packIndices(std::span<const u32> indices, IndexType type);
+
+/**
+ * Vertex attribute every GLMesh VAO feeds with the draw's baseInstance.
+ * It is an instanced attribute over the sequence 0, 1, 2, ..., so in a
+ * multi-draw each command reads back its own baseInstance, which stands in
+ * for gl_BaseInstance (GL 4.6) as a per-draw parameter such as a texture
+ * array layer. Plain draws read 0.
+ */
+inline constexpr u32 DRAW_PARAMETER_ATTRIBUTE = 3;
+
+/// Exclusive upper bound of the baseInstance values a draw parameter can carry
+inline constexpr u32 MAX_DRAW_PARAMETER = 4096;
+
 class GLMesh {
 public:
     GLMesh() = default;
@@ -27,11 +85,14 @@ public:
         , m_vbo(other.m_vbo)
         , m_ebo(other.m_ebo)
         , m_indexCount(other.m_indexCount)
+        , m_indexType(other.m_indexType)
+        , m_memorySize(other.m_memorySize)
     {
         other.m_vao = 0;
         other.m_vbo = 0;
         other.m_ebo = 0;
         other.m_indexCount = 0;
+        other.m_memorySize = 0;
     }
     
     // Move assignment
@@ -42,18 +103,28 @@ public:
             m_vbo = other.m_vbo;
             m_ebo = other.m_ebo;
             m_indexCount = other.m_indexCount;
+            m_indexType = other.m_indexType;
+            m_memorySize = other.m_memorySize;
             other.m_vao = 0;
             other.m_vbo = 0;
             other.m_ebo = 0;
             other.m_indexCount = 0;
+            other.m_memorySize = 0;
         }
         return *this;
     }
     
-    /// Create mesh from vertex data
+    /// Create mesh from vertex data (packed, with 16-bit indices if the vertex count allows)
     void create(const std::vector<Vertex>& vertices, const std::vector<u32>& indices);
     
-    /// Draw the mesh
+    /**
+     * @brief Create buffers of the given size without uploading (filled later through GLUploadQueue)
+     *
+     * The vertex buffer holds PackedVertex, the index buffer `indexType` indices.
+     */
+    void allocate(u32 vertexCount, u32 indexCount, IndexType indexType);
+    
+    /// Bind the VAO and draw the mesh (left bound; SimpleRenderer batches through its DrawList instead)
     void draw() const;
     
     /// Destroy the mesh
@@ -61,11 +132,29 @@ public:
     
     bool isValid() const { return m_vao != 0; }
     
+    u32 getVertexArray() const { return m_vao; }
+    u32 getIndexCount() const { return m_indexCount; }
+    u32 getVertexBuffer() const { return m_vbo; }
+    u32 getIndexBuffer() const { return m_ebo; }
+    IndexType getIndexType() const { return m_indexType; }
+    
+    /// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, for draw calls
+    u32 getGLIndexType() const;
+    
+    /// Bytes of GPU memory held by the vertex and index buffers
+    u64 getMemorySize() const { return m_memorySize; }
+    
 private:
+    /// Create the VAO and buffers; null data leaves the buffers uninitialized
+    void createBuffers(u32 vertexCount, u32 indexCount, IndexType indexType, const PackedVertex* vertices,
+                       const void* indices);
+    
     u32 m_vao = 0;
     u32 m_vbo = 0;
     u32 m_ebo = 0;
     u32 m_indexCount = 0;
+    IndexType m_indexType = IndexType::U32;
+    u64 m_memorySize = 0;
 };
 
 } // namespace cscpp::renderer
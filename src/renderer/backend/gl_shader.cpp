@@ -4,7 +4,6 @@
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
-#include <unordered_set>
 
 namespace cscpp::renderer {
 
@@ -103,92 +102,73 @@ u32 GLShader::compileShader(u32 type, const std::string& source) {
     return shader;
 }
 
-i32 GLShader::getUniformLocation(const std::string& name) {
+i32 GLShader::findUniformLocation(const std::string& name) const {
     if (m_program == 0) {
         return -1;
     }
     
-    auto it = m_uniformCache.find(name);
-    if (it != m_uniformCache.end()) {
-        return it->second;
-    }
-    
-    // Get uniform location - program doesn't need to be bound for this
-    // but we'll ensure our program is bound to be safe
-    GLint currentProgram = 0;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    
-    // Only bind if not already bound
-    if (currentProgram != static_cast<GLint>(m_program)) {
-        glUseProgram(m_program);
-    }
-    
+    // Locations are fixed at link time and can be queried without binding the program
     i32 location = glGetUniformLocation(m_program, name.c_str());
-    m_uniformCache[name] = location;
-    
-    // Restore previous program only if it was different
-    if (currentProgram != static_cast<GLint>(m_program)) {
-        glUseProgram(currentProgram);
-    }
-    
-    // Log warning if uniform not found (but only once per uniform)
     if (location == -1) {
-        static std::unordered_set<std::string> warnedUniforms;
-        if (warnedUniforms.find(name) == warnedUniforms.end()) {
-            LOG_WARN("Uniform '{}' not found in shader (may be optimized out)", name);
-            warnedUniforms.insert(name);
-        }
+        LOG_WARN("Uniform '{}' not found in shader (may be optimized out)", name);
     }
-    
     return location;
 }
 
-void GLShader::setUniform(const std::string& name, f32 value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniform1f(location, value);
+Result<void> GLShader::bindUniformBlock(const std::string& name, u32 binding) const {
+    if (m_program == 0) {
+        return std::unexpected(Error{"Shader not loaded"});
+    }
+    
+    u32 index = glGetUniformBlockIndex(m_program, name.c_str());
+    if (index == GL_INVALID_INDEX) {
+        return std::unexpected(Error{"Uniform block '" + name + "' not found in shader"});
     }
+    glUniformBlockBinding(m_program, index, binding);
+    return {};
 }
 
-void GLShader::setUniform(const std::string& name, i32 value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniform1i(location, value);
+void GLShader::setUniform(UniformHandle<f32> handle, f32 value) const {
+    if (handle.isValid()) {
+        glUniform1f(handle.location, value);
     }
 }
 
-void GLShader::setUniform(const std::string& name, bool value) {
+void GLShader::setUniform(UniformHandle<i32> handle, i32 value) const {
+    if (handle.isValid()) {
+        glUniform1i(handle.location, value);
+    }
+}
+
+void GLShader::setUniform(UniformHandle<bool> handle, bool value) const {
     // GLSL bool uniforms are set as integers (0 or 1)
-    setUniform(name, value ? 1 : 0);
+    if (handle.isValid()) {
+        glUniform1i(handle.location, value ? 1 : 0);
+    }
 }
 
-void GLShader::setUniform(const std::string& name, const Vec2& value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniform2f(location, value.x, value.y);
+void GLShader::setUniform(UniformHandle<Vec2> handle, const Vec2& value) const {
+    if (handle.isValid()) {
+        glUniform2f(handle.location, value.x, value.y);
     }
 }
 
-void GLShader::setUniform(const std::string& name, const Vec3& value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniform3f(location, value.x, value.y, value.z);
+void GLShader::setUniform(UniformHandle<Vec3> handle, const Vec3& value) const {
+    if (handle.isValid()) {
+        glUniform3f(handle.location, value.x, value.y, value.z);
     }
 }
 
-void GLShader::setUniform(const std::string& name, const Vec4& value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniform4f(location, value.x, value.y, value.z, value.w);
+void GLShader::setUniform(UniformHandle<Vec4> handle, const Vec4& value) const {
+    if (handle.isValid()) {
+        glUniform4f(handle.location, value.x, value.y, value.z, value.w);
     }
 }
 
-void GLShader::setUniform(const std::string& name, const Mat4& value) {
-    i32 location = getUniformLocation(name);
-    if (location >= 0) {
-        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+void GLShader::setUniform(UniformHandle<Mat4> handle, const Mat4& value) const {
+    if (handle.isValid()) {
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
     }
 }
 
 } // namespace cscpp::renderer
-
@@ -3,10 +3,23 @@
 #include "core/types.hpp"
 #include "core/math/math.hpp"
 #include <string>
-#include <unordered_map>
 
 namespace cscpp::renderer {
 
+/**
+ * @brief Location of a uniform, resolved once after linking
+ *
+ * T is the C++ type set through the handle, so a mismatched setUniform()
+ * call fails to compile instead of silently uploading the wrong type.
+ * Handles of uniforms the linker removed stay invalid and are ignored.
+ */
+template<typename T>
+struct UniformHandle {
+    i32 location = -1;
+    
+    bool isValid() const { return location >= 0; }
+};
+
 class GLShader {
 public:
     GLShader() = default;
@@ -24,14 +37,23 @@ public:
     /// Stop using this shader
     static void unbind();
     
-    /// Set uniform values
-    void setUniform(const std::string& name, f32 value);
-    void setUniform(const std::string& name, i32 value);
-    void setUniform(const std::string& name, bool value);  // GLSL bool uniforms use i32
-    void setUniform(const std::string& name, const Vec2& value);
-    void setUniform(const std::string& name, const Vec3& value);
-    void setUniform(const std::string& name, const Vec4& value);
-    void setUniform(const std::string& name, const Mat4& value);
+    /// Resolve a uniform by name (once, after loading; logs uniforms that are not active)
+    template<typename T>
+    UniformHandle<T> getUniform(const std::string& name) const {
+        return {findUniformLocation(name)};
+    }
+    
+    /// Attach a named uniform block to a GL_UNIFORM_BUFFER binding point
+    Result<void> bindUniformBlock(const std::string& name, u32 binding) const;
+    
+    /// Set uniform values of this shader (it must be the bound program)
+    void setUniform(UniformHandle<f32> handle, f32 value) const;
+    void setUniform(UniformHandle<i32> handle, i32 value) const;
+    void setUniform(UniformHandle<bool> handle, bool value) const;  // GLSL bool uniforms use i32
+    void setUniform(UniformHandle<Vec2> handle, const Vec2& value) const;
+    void setUniform(UniformHandle<Vec3> handle, const Vec3& value) const;
+    void setUniform(UniformHandle<Vec4> handle, const Vec4& value) const;
+    void setUniform(UniformHandle<Mat4> handle, const Mat4& value) const;
     
     /// Get shader program ID
     u32 getProgram() const { return m_program; }
@@ -40,10 +62,9 @@ public:
     
 private:
     u32 compileShader(u32 type, const std::string& source);
-    i32 getUniformLocation(const std::string& name);
+    i32 findUniformLocation(const std::string& name) const;
     
     u32 m_program = 0;
-    std::unordered_map<std::string, i32> m_uniformCache;
 };
 
 } // namespace cscpp::renderer
@@ -0,0 +1,93 @@
+#include "renderer/backend/gl_state_cache.hpp"
+#include "core/logging/logger.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace cscpp::renderer {
+
+void checkGLError(const char* what) {
+    static u32 logged = 0;
+    for (GLenum err = glGetError(); err != GL_NO_ERROR; err = glGetError()) {
+        if (logged < 16) {
+            LOG_ERROR("OpenGL error after {}: 0x{:X}", what, static_cast<u32>(err));
+            logged++;
+        }
+    }
+}
+
+void GLStateCache::useProgram(u32 program) {
+    if (m_program == program) {
+        m_stats.skippedBinds++;
+        return;
+    }
+    glUseProgram(program);
+    m_program = program;
+    m_stats.programBinds++;
+}
+
+void GLStateCache::bindVertexArray(u32 vertexArray) {
+    if (m_vertexArray == vertexArray) {
+        m_stats.skippedBinds++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    m_vertexArray = vertexArray;
+    m_stats.vertexArrayBinds++;
+}
+
+void GLStateCache::bindTexture2D(u32 unit, u32 texture) {
+    bindTexture(GL_TEXTURE_2D, unit, texture, m_textures);
+}
+
+void GLStateCache::bindTexture2DArray(u32 unit, u32 texture) {
+    bindTexture(GL_TEXTURE_2D_ARRAY, unit, texture, m_textureArrays);
+}
+
+void GLStateCache::bindTexture(u32 target, u32 unit, u32 texture, u32* cached) {
+    if (unit >= TEXTURE_UNITS) {
+        return;
+    }
+    if (cached[unit] == texture) {
+        m_stats.skippedBinds++;
+        return;
+    }
+    if (m_activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = unit;
+    }
+    glBindTexture(target, texture);
+    cached[unit] = texture;
+    m_stats.textureBinds++;
+}
+
+void GLStateCache::invalidate() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_activeUnit = UNKNOWN;
+    std::fill(std::begin(m_textures), std::end(m_textures), UNKNOWN);
+    std::fill(std::begin(m_textureArrays), std::end(m_textureArrays), UNKNOWN);
+}
+
+void GLStateCache::verify() const {
+#if defined(CSCPP_GL_VALIDATION)
+    const auto check = [](const char* binding, GLenum query, u32 expected) {
+        if (expected == UNKNOWN) {
+            return;
+        }
+        GLint actual = 0;
+        glGetIntegerv(query, &actual);
+        if (static_cast<u32>(actual) != expected) {
+            LOG_ERROR("GL state cache out of sync: {} is {}, cached {}", binding, actual, expected);
+        }
+    };
+    check("program", GL_CURRENT_PROGRAM, m_program);
+    check("vertex array", GL_VERTEX_ARRAY_BINDING, m_vertexArray);
+    if (m_activeUnit != UNKNOWN) {
+        check("active texture", GL_ACTIVE_TEXTURE, GL_TEXTURE0 + m_activeUnit);
+        check("texture", GL_TEXTURE_BINDING_2D, m_textures[m_activeUnit]);
+        check("texture array", GL_TEXTURE_BINDING_2D_ARRAY, m_textureArrays[m_activeUnit]);
+    }
+#endif
+}
+
+} // namespace cscpp::renderer
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file gl_state_cache.hpp
+ * @brief Shadow copy of the GL bindings the renderer changes per draw
+ *
+ * Binds go through the cache, which skips a call when the object is
+ * already bound, so a sorted draw list only pays for the state that
+ * actually changes between draws. Code outside the renderer (loaders,
+ * GLUploadQueue) binds objects directly; call invalidate() before
+ * submitting after such code ran.
+ *
+ * GL error checks (CSCPP_GL_CHECK) and verify() only run in builds with
+ * CSCPP_GL_VALIDATION, since every query is a driver round trip.
+ */
+
+#include "core/types.hpp"
+
+namespace cscpp::renderer {
+
+#if defined(CSCPP_GL_VALIDATION)
+    #define CSCPP_GL_CHECK(what) ::cscpp::renderer::checkGLError(what)
+#else
+    #define CSCPP_GL_CHECK(what) ((void)0)
+#endif
+
+/// Drain the GL error queue, logging the first errors with `what` (validation builds)
+void checkGLError(const char* what);
+
+/// Binds issued and skipped since the last resetStats()
+struct GLStateStats {
+    u32 programBinds = 0;
+    u32 vertexArrayBinds = 0;
+    u32 textureBinds = 0;
+    u32 skippedBinds = 0;
+};
+
+class GLStateCache {
+public:
+    static constexpr u32 TEXTURE_UNITS = 8;
+    
+    void useProgram(u32 program);
+    void bindVertexArray(u32 vertexArray);
+    void bindTexture2D(u32 unit, u32 texture);
+    void bindTexture2DArray(u32 unit, u32 texture);
+    
+    /// Forget every cached binding, the next bind of each kind is issued
+    void invalidate();
+    
+    /// Compare the cache with the driver's bindings and log mismatches (validation builds)
+    void verify() const;
+    
+    const GLStateStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+private:
+    static constexpr u32 UNKNOWN = ~0u;
+    
+    /// Bind through `cached` (one entry per unit of the target)
+    void bindTexture(u32 target, u32 unit, u32 texture, u32* cached);
+    
+    u32 m_program = UNKNOWN;
+    u32 m_vertexArray = UNKNOWN;
+    u32 m_activeUnit = UNKNOWN;
+    u32 m_textures[TEXTURE_UNITS] = {UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN};
+    u32 m_textureArrays[TEXTURE_UNITS] = {UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN};
+    GLStateStats m_stats;
+};
+
+} // namespace cscpp::renderer
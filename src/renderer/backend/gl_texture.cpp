@@ -0,0 +1,251 @@
+#include "renderer/backend/gl_texture.hpp"
+#include "core/logging/logger.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+// GL_MAX_TEXTURE_MAX_ANISOTROPY is core since 4.6; older GLAD headers only have the EXT names
+#ifndef GL_MAX_TEXTURE_MAX_ANISOTROPY
+    #define GL_MAX_TEXTURE_MAX_ANISOTROPY 0x84FF
+    #define GL_TEXTURE_MAX_ANISOTROPY 0x84FE
+#endif
+
+// S3TC is an extension, a core-profile GLAD header may not define its enums
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+    #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace cscpp::renderer {
+
+TextureFormat uncompressedFormat(u32 channels) {
+    switch (channels) {
+        case 1: return TextureFormat::R8;
+        case 2: return TextureFormat::RG8;
+        case 4: return TextureFormat::RGBA8;
+        default: return TextureFormat::RGB8;
+    }
+}
+
+u32 texelSize(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8: return 1;
+        case TextureFormat::RG8: return 2;
+        case TextureFormat::RGB8: return 3;
+        case TextureFormat::RGBA8: return 4;
+        default: return 0;
+    }
+}
+
+/// Bytes per 4x4 block of a block format
+static u32 blockSize(TextureFormat format) {
+    return format == TextureFormat::BC1 ? 8 : 16;
+}
+
+u64 textureLevelSize(u32 width, u32 height, TextureFormat format) {
+    if (isBlockCompressed(format)) {
+        return static_cast<u64>((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+    }
+    return static_cast<u64>(width) * height * texelSize(format);
+}
+
+u32 mipLevelCount(u32 width, u32 height) {
+    u32 levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        levels++;
+    }
+    return levels;
+}
+
+u64 mipChainSize(u32 width, u32 height, u32 levels, TextureFormat format) {
+    u64 size = 0;
+    for (u32 level = 0; level < levels; ++level) {
+        size += textureLevelSize(width, height, format);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return size;
+}
+
+static bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension != nullptr && std::strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isTextureFormatSupported(TextureFormat format) {
+    if (format == TextureFormat::BC1 || format == TextureFormat::BC3) {
+        static const bool s3tc = hasExtension("GL_EXT_texture_compression_s3tc");
+        return s3tc;
+    }
+    return true;
+}
+
+u32 textureStorageLevels(u32 width, u32 height, u32 uploadedLevels, TextureFormat format) {
+    const u32 levels = mipLevelCount(width, height);
+    return isBlockCompressed(format) ? std::clamp(uploadedLevels, 1u, levels) : levels;
+}
+
+/// Pixel transfer format of an uncompressed format
+static GLenum uploadFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8: return GL_RED;
+        case TextureFormat::RG8: return GL_RG;
+        case TextureFormat::RGBA8: return GL_RGBA;
+        default: return GL_RGB;
+    }
+}
+
+static GLenum internalFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8: return GL_R8;
+        case TextureFormat::RG8: return GL_RG8;
+        case TextureFormat::RGBA8: return GL_RGBA8;
+        case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default: return GL_RGB8;
+    }
+}
+
+/// Allocate immutable storage for a 2D texture (layers == 0) or a 2D array texture
+static u32 createTexture(u32 width, u32 height, u32 layers, u32 levels, TextureFormat format) {
+    const bool array = layers > 0;
+    if (width == 0 || height == 0 || levels == 0 || levels > mipLevelCount(width, height)) {
+        LOG_ERROR("Invalid texture storage: {}x{} with {} levels", width, height, levels);
+        return 0;
+    }
+    
+    u32 textureID = 0;
+    glGenTextures(1, &textureID);
+    if (textureID == 0) {
+        LOG_ERROR("Failed to generate texture");
+        return 0;
+    }
+    
+    const GLenum target = array ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    glBindTexture(target, textureID);
+    if (array) {
+        glTexStorage3D(target, static_cast<GLsizei>(levels), internalFormat(format),
+                       static_cast<GLsizei>(width), static_cast<GLsizei>(height), static_cast<GLsizei>(layers));
+    } else {
+        glTexStorage2D(target, static_cast<GLsizei>(levels), internalFormat(format),
+                       static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+    }
+    
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOG_ERROR("OpenGL error allocating {}x{}x{} texture: 0x{:X}", width, height, std::max(layers, 1u),
+                  static_cast<u32>(err));
+        glBindTexture(target, 0);
+        glDeleteTextures(1, &textureID);
+        return 0;
+    }
+    
+    // Trilinear filtering for minification, linear for magnification, seamless tiling
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    
+    // Maximum anisotropy reduces blurriness on surfaces viewed at an angle
+    static const GLfloat maxAnisotropy = [] {
+        GLfloat value = 1.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &value);
+        return value;
+    }();
+    if (maxAnisotropy > 1.0f) {
+        glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY, maxAnisotropy);
+    }
+    
+    glBindTexture(target, 0);
+    return textureID;
+}
+
+u32 createTexture2D(u32 width, u32 height, u32 levels, TextureFormat format) {
+    return createTexture(width, height, 0, levels, format);
+}
+
+u32 createTexture2DArray(u32 width, u32 height, u32 layers, u32 levels, TextureFormat format) {
+    if (layers == 0) {
+        LOG_ERROR("Invalid texture array: no layers");
+        return 0;
+    }
+    return createTexture(width, height, layers, levels, format);
+}
+
+void uploadTextureLevel(u32 texture, u32 level, u32 width, u32 height, TextureFormat format, const u8* data) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (isBlockCompressed(format)) {
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0,
+                                  static_cast<GLsizei>(width), static_cast<GLsizei>(height), internalFormat(format),
+                                  static_cast<GLsizei>(textureLevelSize(width, height, format)), data);
+    } else {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Rows of RGB data are not 4-byte aligned
+        glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0,
+                        static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                        uploadFormat(format), GL_UNSIGNED_BYTE, data);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void uploadTextureLayer(u32 texture, u32 layer, u32 level, u32 width, u32 height, TextureFormat format,
+                        const u8* data) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    if (isBlockCompressed(format)) {
+        glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, static_cast<GLint>(layer),
+                                  static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1, internalFormat(format),
+                                  static_cast<GLsizei>(textureLevelSize(width, height, format)), data);
+    } else {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, static_cast<GLint>(layer),
+                        static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1,
+                        uploadFormat(format), GL_UNSIGNED_BYTE, data);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+static void finishTexture(GLenum target, u32 texture, u32 uploadedLevels, u32 levels, TextureFormat format) {
+    if (uploadedLevels >= levels) {
+        return;
+    }
+    
+    glBindTexture(target, texture);
+    if (uploadedLevels > 1 || isBlockCompressed(format)) {
+        // glGenerateMipmap would overwrite the uploaded levels, sample only those instead
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(std::max(uploadedLevels, 1u) - 1));
+        glBindTexture(target, 0);
+        return;
+    }
+    glGenerateMipmap(target);
+    
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOG_WARN("OpenGL error generating mipmaps for texture {}: 0x{:X}", texture, static_cast<u32>(err));
+    }
+    glBindTexture(target, 0);
+}
+
+void finishTexture2D(u32 texture, u32 uploadedLevels, u32 levels, TextureFormat format) {
+    finishTexture(GL_TEXTURE_2D, texture, uploadedLevels, levels, format);
+}
+
+void finishTexture2DArray(u32 texture, u32 uploadedLevels, u32 levels, TextureFormat format) {
+    finishTexture(GL_TEXTURE_2D_ARRAY, texture, uploadedLevels, levels, format);
+}
+
+void destroyTexture2D(u32 texture) {
+    if (texture != 0) {
+        glDeleteTextures(1, &texture);
+    }
+}
+
+} // namespace cscpp::renderer
@@ -0,0 +1,107 @@
+#pragma once
+
+/**
+ * @file gl_texture.hpp
+ * @brief 2D texture creation shared by the loaders and the asset streamer
+ *
+ * Textures and 2D array textures are allocated once with immutable storage
+ * for the whole mip chain, then filled level by level, either directly (glTexSubImage2D from
+ * client memory) or from a GLUploadQueue staging ring. finishTexture2D()
+ * generates the levels that were not uploaded. Block-compressed (BCn)
+ * textures are uploaded as stored and carry their own mip chains.
+ *
+ * Array textures hold same-sized images of one format as layers, so draws
+ * of many textures can share one binding (see SimpleRenderer::drawMeshGroups).
+ */
+
+#include "core/types.hpp"
+
+namespace cscpp::renderer {
+
+/// Texel layouts of createTexture2D()
+enum class TextureFormat : u8 {
+    R8,
+    RG8,
+    RGB8,
+    RGBA8,
+    BC1,    ///< 8-byte 4x4 blocks, opaque RGB (S3TC DXT1)
+    BC3,    ///< 16-byte 4x4 blocks, RGB plus interpolated alpha (S3TC DXT5)
+    BC7,    ///< 16-byte 4x4 blocks, RGBA (BPTC)
+};
+
+/// Uncompressed format with 1-4 8-bit channels
+TextureFormat uncompressedFormat(u32 channels);
+
+/// True for the 4x4 block formats
+inline bool isBlockCompressed(TextureFormat format) {
+    return format == TextureFormat::BC1 || format == TextureFormat::BC3 || format == TextureFormat::BC7;
+}
+
+/// Bytes per texel of an uncompressed format (0 for block formats)
+u32 texelSize(TextureFormat format);
+
+/// Bytes of one level (whole blocks for block formats)
+u64 textureLevelSize(u32 width, u32 height, TextureFormat format);
+
+/// Levels of a full mip chain down to 1x1
+u32 mipLevelCount(u32 width, u32 height);
+
+/// Bytes of the first `levels` levels, packed back to back
+u64 mipChainSize(u32 width, u32 height, u32 levels, TextureFormat format);
+
+/**
+ * @brief Whether the driver samples a format natively (GL thread)
+ *
+ * BC1/BC3 need EXT_texture_compression_s3tc; BC7 is core since GL 4.2.
+ */
+bool isTextureFormatSupported(TextureFormat format);
+
+/**
+ * @brief Levels to allocate for a texture with `uploadedLevels` levels of data
+ *
+ * The full chain for uncompressed formats (finishTexture2D() generates the
+ * rest), only the uploaded levels for block formats, which cannot be
+ * generated on the GPU.
+ */
+u32 textureStorageLevels(u32 width, u32 height, u32 uploadedLevels, TextureFormat format);
+
+/**
+ * @brief Allocate an immutable 2D texture
+ *
+ * Repeat wrapping, trilinear filtering and the maximum anisotropy the
+ * driver offers. The texture is left unbound.
+ *
+ * @return Texture name, or 0 on failure
+ */
+u32 createTexture2D(u32 width, u32 height, u32 levels, TextureFormat format);
+
+/// Allocate an immutable 2D array texture with `layers` layers (sampled like createTexture2D())
+u32 createTexture2DArray(u32 width, u32 height, u32 layers, u32 levels, TextureFormat format);
+
+/**
+ * @brief Upload one level (sized by the level's dimensions)
+ *
+ * With a pixel unpack buffer bound, `data` is an offset into that buffer.
+ */
+void uploadTextureLevel(u32 texture, u32 level, u32 width, u32 height, TextureFormat format, const u8* data);
+
+/// Upload one level of one layer of an array texture (like uploadTextureLevel())
+void uploadTextureLayer(u32 texture, u32 layer, u32 level, u32 width, u32 height, TextureFormat format,
+                        const u8* data);
+
+/**
+ * @brief Complete a texture once all uploaded levels are in
+ *
+ * With only level 0 of an uncompressed texture uploaded the rest of the
+ * chain is generated on the GPU. Otherwise sampling is clamped to the
+ * uploaded levels, since generating mips would overwrite them.
+ */
+void finishTexture2D(u32 texture, u32 uploadedLevels, u32 levels, TextureFormat format);
+
+/// finishTexture2D() for an array texture, once level 0 of every layer is in
+void finishTexture2DArray(u32 texture, u32 uploadedLevels, u32 levels, TextureFormat format);
+
+/// Delete a texture created by createTexture2D() or createTexture2DArray() (0 is ignored)
+void destroyTexture2D(u32 texture);
+
+} // namespace cscpp::renderer
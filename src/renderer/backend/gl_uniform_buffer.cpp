@@ -0,0 +1,44 @@
+#include "renderer/backend/gl_uniform_buffer.hpp"
+#include <glad/glad.h>
+
+namespace cscpp::renderer {
+
+GLUniformBuffer::~GLUniformBuffer() {
+    destroy();
+}
+
+Result<void> GLUniformBuffer::create(u64 size, u32 binding) {
+    destroy();
+    
+    glGenBuffers(1, &m_buffer);
+    if (m_buffer == 0) {
+        return std::unexpected(Error{"Failed to create uniform buffer"});
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_buffer);
+    
+    m_size = size;
+    m_binding = binding;
+    return {};
+}
+
+void GLUniformBuffer::update(const void* data, u64 size) {
+    if (m_buffer == 0 || size > m_size) {
+        return;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void GLUniformBuffer::destroy() {
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_size = 0;
+}
+
+} // namespace cscpp::renderer
@@ -0,0 +1,44 @@
+#pragma once
+
+/**
+ * @file gl_uniform_buffer.hpp
+ * @brief Uniform buffer object bound to a fixed binding point
+ *
+ * Data shared by every draw of a frame or view (camera matrices) lives in
+ * one buffer written once per change, instead of being set on each
+ * program. The buffer stays bound to its binding point for its whole life;
+ * programs reach it through GLShader::bindUniformBlock() with the same
+ * binding.
+ */
+
+#include "core/types.hpp"
+
+namespace cscpp::renderer {
+
+class GLUniformBuffer {
+public:
+    GLUniformBuffer() = default;
+    ~GLUniformBuffer();
+    
+    GLUniformBuffer(const GLUniformBuffer&) = delete;
+    GLUniformBuffer& operator=(const GLUniformBuffer&) = delete;
+    
+    /// Allocate `size` bytes and bind the buffer to `binding`
+    Result<void> create(u64 size, u32 binding);
+    
+    /// Replace the start of the buffer (size must not exceed the allocation)
+    void update(const void* data, u64 size);
+    
+    void destroy();
+    
+    bool isValid() const { return m_buffer != 0; }
+    u32 getBuffer() const { return m_buffer; }
+    u32 getBinding() const { return m_binding; }
+    
+private:
+    u32 m_buffer = 0;
+    u32 m_binding = 0;
+    u64 m_size = 0;
+};
+
+} // namespace cscpp::renderer
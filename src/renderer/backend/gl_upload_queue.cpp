@@ -0,0 +1,196 @@
+#include "renderer/backend/gl_upload_queue.hpp"
+#include "renderer/backend/gl_texture.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+
+namespace cscpp::renderer {
+
+/// Staging offsets are kept 16-byte aligned for buffer copies
+static constexpr u64 STAGING_ALIGNMENT = 16;
+
+GLUploadQueue::~GLUploadQueue() {
+    shutdown();
+}
+
+Result<void> GLUploadQueue::initialize(u64 stagingSize, u64 frameBudget) {
+    shutdown();
+    m_frameBudget = frameBudget;
+    
+    // Direct uploads still work without the ring, just with client-memory copies in the driver
+    if (!GLAD_GL_VERSION_4_4) {
+        return std::unexpected(Error{"Persistent buffer mapping not supported, uploading directly"});
+    }
+    
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glBufferStorage(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(stagingSize), nullptr, flags);
+    m_mapped = static_cast<u8*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(stagingSize), flags));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    
+    if (m_mapped == nullptr) {
+        while (glGetError() != GL_NO_ERROR) {}
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return std::unexpected(Error{"Failed to map staging buffer, uploading directly"});
+    }
+    
+    m_size = stagingSize;
+    LOG_INFO("Upload queue: {} MB staging ring, {} KB per frame", m_size / (1024 * 1024), m_frameBudget / 1024);
+    return {};
+}
+
+void GLUploadQueue::shutdown() {
+    for (const auto& fence : m_fences) {
+        glDeleteSync(static_cast<GLsync>(fence.sync));
+    }
+    m_fences.clear();
+    
+    if (m_buffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_size = 0;
+    m_head = 0;
+    m_used = 0;
+    m_frameStaged = 0;
+    m_frameUploaded = 0;
+}
+
+void GLUploadQueue::beginFrame() {
+    m_frameUploaded = 0;
+    retireFences();
+}
+
+void GLUploadQueue::endFrame() {
+    if (m_frameStaged == 0) {
+        return;
+    }
+    GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_fences.push_back({sync, m_frameStaged});
+    m_frameStaged = 0;
+}
+
+void GLUploadQueue::retireFences() {
+    while (!m_fences.empty()) {
+        GLsync sync = static_cast<GLsync>(m_fences.front().sync);
+        const GLenum status = glClientWaitSync(sync, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(sync);
+        m_used -= m_fences.front().bytes;
+        m_fences.pop_front();
+    }
+}
+
+u64 GLUploadQueue::allocate(u64 size) {
+    size = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+    
+    // Frames are released in order, so the free space is [m_head, oldest in-flight byte)
+    const u64 padding = m_head + size > m_size ? m_size - m_head : 0;
+    if (m_used + padding + size > m_size) {
+        retireFences();
+        if (m_used + padding + size > m_size) {
+            return m_size;
+        }
+    }
+    
+    const u64 offset = m_head + padding == m_size ? 0 : m_head + padding;
+    m_head = offset + size;
+    m_used += padding + size;
+    m_frameStaged += padding + size;
+    return offset;
+}
+
+bool GLUploadQueue::uploadTextureLevel(u32 texture, u32 level, u32 width, u32 height, TextureFormat format,
+                                       std::span<const u8> pixels) {
+    return uploadTexture(texture, NO_LAYER, level, width, height, format, pixels);
+}
+
+bool GLUploadQueue::uploadTextureLayer(u32 texture, u32 layer, u32 level, u32 width, u32 height,
+                                       TextureFormat format, std::span<const u8> pixels) {
+    return uploadTexture(texture, layer, level, width, height, format, pixels);
+}
+
+bool GLUploadQueue::uploadTexture(u32 texture, u32 layer, u32 level, u32 width, u32 height, TextureFormat format,
+                                  std::span<const u8> pixels) {
+    CSCPP_PROFILE_FUNCTION();
+    const u64 size = textureLevelSize(width, height, format);
+    if (pixels.size() < size) {
+        LOG_ERROR("Texture {} level {}: {} bytes, expected {}", texture, level, pixels.size(), size);
+        return true;  // Nothing to retry
+    }
+    if (!fitsBudget(size)) {
+        return false;
+    }
+    
+    const auto upload = [&](const u8* data) {
+        if (layer == NO_LAYER) {
+            renderer::uploadTextureLevel(texture, level, width, height, format, data);
+        } else {
+            renderer::uploadTextureLayer(texture, layer, level, width, height, format, data);
+        }
+    };
+    
+    if (stagesUpload(size)) {
+        const u64 offset = allocate(size);
+        if (offset == m_size) {
+            return false;
+        }
+        std::memcpy(m_mapped + offset, pixels.data(), size);
+        
+        // With an unpack buffer bound the data pointer is an offset into it
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        upload(reinterpret_cast<const u8*>(static_cast<uintptr_t>(offset)));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        upload(pixels.data());
+    }
+    
+    m_frameUploaded += size;
+    m_totalUploaded += size;
+    return true;
+}
+
+bool GLUploadQueue::uploadBuffer(u32 buffer, u64 offset, std::span<const u8> data) {
+    CSCPP_PROFILE_FUNCTION();
+    const u64 size = data.size();
+    if (size == 0) {
+        return true;
+    }
+    if (!fitsBudget(size)) {
+        return false;
+    }
+    
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (stagesUpload(size)) {
+        const u64 staged = allocate(size);
+        if (staged == m_size) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            return false;
+        }
+        std::memcpy(m_mapped + staged, data.data(), size);
+        
+        glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(staged),
+                            static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    } else {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data.data());
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    m_frameUploaded += size;
+    m_totalUploaded += size;
+    return true;
+}
+
+} // namespace cscpp::renderer
@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * @file gl_upload_queue.hpp
+ * @brief Budgeted GPU uploads through a persistently mapped staging ring
+ *
+ * Loaders decode on worker threads; the GL thread then copies finished
+ * buffers into one persistently mapped pixel/copy buffer and lets the
+ * driver pull them from there (glTexSubImage2D from the bound unpack
+ * buffer, glCopyBufferSubData into vertex and index buffers), so no upload
+ * blocks on a driver-side copy of client memory. Each frame's slice of the
+ * ring is fenced and only reused once the GPU has consumed it.
+ *
+ * The per-frame byte budget bounds how long uploads can take out of a
+ * frame. An upload that does not fit returns false and is retried next
+ * frame; the first upload of a frame is always accepted so oversized items
+ * still make progress. Without GL 4.4 buffer storage the queue falls back
+ * to direct uploads under the same budget.
+ *
+ * GL thread only.
+ */
+
+#include "core/types.hpp"
+#include "renderer/backend/gl_texture.hpp"
+
+#include <deque>
+#include <span>
+
+namespace cscpp::renderer {
+
+class GLUploadQueue {
+public:
+    static constexpr u64 DEFAULT_STAGING_SIZE = 32 * 1024 * 1024;
+    static constexpr u64 DEFAULT_FRAME_BUDGET = 4 * 1024 * 1024;
+    
+    GLUploadQueue() = default;
+    ~GLUploadQueue();
+    
+    GLUploadQueue(const GLUploadQueue&) = delete;
+    GLUploadQueue& operator=(const GLUploadQueue&) = delete;
+    
+    /// Create and map the staging ring (direct uploads are used if that fails)
+    Result<void> initialize(u64 stagingSize = DEFAULT_STAGING_SIZE, u64 frameBudget = DEFAULT_FRAME_BUDGET);
+    
+    /// Release the ring (GL defers the delete until in-flight copies are done)
+    void shutdown();
+    
+    /// True if uploads are staged through the mapped ring
+    bool isStaged() const { return m_mapped != nullptr; }
+    
+    /// Reset the frame budget and reclaim ring space the GPU is done with
+    void beginFrame();
+    
+    /// Fence the uploads issued this frame
+    void endFrame();
+    
+    void setFrameBudget(u64 bytes) { m_frameBudget = bytes; }
+    u64 getFrameBudget() const { return m_frameBudget; }
+    
+    /// Bytes left in this frame's budget
+    u64 getRemainingBudget() const { return m_frameUploaded < m_frameBudget ? m_frameBudget - m_frameUploaded : 0; }
+    
+    // ========================================================================
+    // Uploads (false = over budget or ring full, retry next frame)
+    // ========================================================================
+    
+    /// Fill one level of a texture allocated with createTexture2D()
+    bool uploadTextureLevel(u32 texture, u32 level, u32 width, u32 height, TextureFormat format, std::span<const u8> pixels);
+    
+    /// Fill one level of one layer of a texture allocated with createTexture2DArray()
+    bool uploadTextureLayer(u32 texture, u32 layer, u32 level, u32 width, u32 height, TextureFormat format,
+                            std::span<const u8> pixels);
+    
+    /// Fill [offset, offset + data.size()) of a buffer object
+    bool uploadBuffer(u32 buffer, u64 offset, std::span<const u8> data);
+    
+    // ========================================================================
+    // Statistics
+    // ========================================================================
+    
+    u64 getStagingSize() const { return m_size; }
+    u64 getStagingInFlight() const { return m_used; }
+    u64 getTotalUploaded() const { return m_totalUploaded; }
+
+private:
+    /// Ring bytes used by one frame, released when its fence signals
+    struct FrameFence {
+        void* sync;  // GLsync
+        u64 bytes;
+    };
+    
+    static constexpr u32 NO_LAYER = ~0u;  // uploadTexture() target is a 2D texture
+    
+    /// Stage or directly upload one texture level (layer of an array texture unless NO_LAYER)
+    bool uploadTexture(u32 texture, u32 layer, u32 level, u32 width, u32 height, TextureFormat format,
+                       std::span<const u8> pixels);
+    
+    /// Whether an upload of `size` bytes still fits this frame's budget
+    bool fitsBudget(u64 size) const { return m_frameUploaded == 0 || m_frameUploaded + size <= m_frameBudget; }
+    
+    /// Items over half the ring would stall it until empty, those go direct
+    bool stagesUpload(u64 size) const { return m_mapped != nullptr && size <= m_size / 2; }
+    
+    /// Reserve contiguous ring space, returns the offset or m_size if the ring is full
+    u64 allocate(u64 size);
+    
+    /// Release frames the GPU has finished with (never blocks)
+    void retireFences();
+    
+    u32 m_buffer = 0;
+    u8* m_mapped = nullptr;
+    u64 m_size = 0;
+    u64 m_head = 0;             ///< Next write offset
+    u64 m_used = 0;             ///< Ring bytes not yet released by a fence
+    u64 m_frameStaged = 0;      ///< Ring bytes consumed this frame (including wrap padding)
+    std::deque<FrameFence> m_fences;
+    
+    u64 m_frameBudget = DEFAULT_FRAME_BUDGET;
+    u64 m_frameUploaded = 0;
+    u64 m_totalUploaded = 0;
+};
+
+} // namespace cscpp::renderer
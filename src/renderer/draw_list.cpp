@@ -0,0 +1,35 @@
+#include "renderer/draw_list.hpp"
+#include "renderer/backend/gl_mesh.hpp"
+#include <algorithm>
+
+namespace cscpp::renderer {
+
+static u64 makeSortKey(u32 program, u32 textureID, u32 vertexArray) {
+    return (static_cast<u64>(program & 0xFFu) << 56) | (static_cast<u64>(textureID & 0xFFFFFFu) << 32) | vertexArray;
+}
+
+void DrawList::add(u32 program, const GLMesh& mesh, const Mat4& model, u32 textureID, const Vec3& color) {
+    if (!mesh.isValid() || mesh.getIndexCount() == 0) {
+        return;
+    }
+    m_items.push_back({makeSortKey(program, textureID, mesh.getVertexArray()), program, mesh.getVertexArray(),
+                       mesh.getGLIndexType(), mesh.getIndexCount(), 0, 0, textureID, 0, model, color});
+}
+
+void DrawList::addIndirect(u32 program, const GLMesh& mesh, const Mat4& model, u32 textureID, u32 lightmapID,
+                           const Vec3& color, std::span<const DrawIndirectCommand> commands) {
+    if (!mesh.isValid() || commands.empty()) {
+        return;
+    }
+    const u32 firstCommand = static_cast<u32>(m_commands.size());
+    m_commands.insert(m_commands.end(), commands.begin(), commands.end());
+    m_items.push_back({makeSortKey(program, textureID, mesh.getVertexArray()), program, mesh.getVertexArray(),
+                       mesh.getGLIndexType(), 0, firstCommand, static_cast<u32>(commands.size()), textureID, lightmapID,
+                       model, color});
+}
+
+void DrawList::sort() {
+    std::ranges::sort(m_items, {}, &DrawItem::sortKey);
+}
+
+} // namespace cscpp::renderer
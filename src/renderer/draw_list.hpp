@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file draw_list.hpp
+ * @brief Per-frame list of draws, sorted by state before submission
+ *
+ * Items carry the GL names they bind rather than a GLMesh pointer, so a
+ * list stays valid if the mesh object moves. The sort key orders by
+ * program, then texture, then vertex array: the most expensive state
+ * changes happen least often. Names are truncated in the key (8 bits of
+ * the program, 24 of the texture), which only ever costs grouping, never
+ * correctness, since the state cache compares full names.
+ *
+ * An item is either one glDrawElements of a whole mesh or a range of
+ * indirect commands into the mesh's shared buffers, submitted with one
+ * glMultiDrawElementsIndirect. Commands of all items are kept in one array
+ * so a flush uploads them to the indirect buffer in a single write.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include <span>
+#include <vector>
+
+namespace cscpp::renderer {
+
+class GLMesh;
+
+/// Layout of GL's DrawElementsIndirectCommand
+struct DrawIndirectCommand {
+    u32 indexCount;
+    u32 instanceCount;
+    u32 firstIndex;
+    i32 baseVertex;
+    u32 baseInstance;   ///< Read back through DRAW_PARAMETER_ATTRIBUTE
+};
+static_assert(sizeof(DrawIndirectCommand) == 20, "DrawIndirectCommand must match the GL layout");
+
+struct DrawItem {
+    u64 sortKey;
+    u32 program;
+    u32 vertexArray;
+    u32 indexType;      ///< GL_UNSIGNED_SHORT or GL_UNSIGNED_INT (GLMesh::getGLIndexType())
+    u32 indexCount;     ///< Whole-mesh draws
+    u32 firstCommand;   ///< Multi-draws: range in DrawList::getCommands()
+    u32 commandCount;   ///< 0 = whole-mesh draw
+    u32 textureID;      ///< 0 = untextured
+    u32 lightmapID;     ///< Lightmap atlas array at unit 1, 0 = unlit
+    Mat4 model;
+    Vec3 color;
+};
+
+class DrawList {
+public:
+    /// Queue an indexed draw of a whole mesh (invalid meshes are dropped)
+    void add(u32 program, const GLMesh& mesh, const Mat4& model, u32 textureID, const Vec3& color);
+    
+    /// Queue indirect commands into a mesh's buffers as one multi-draw (empty ranges are dropped)
+    void addIndirect(u32 program, const GLMesh& mesh, const Mat4& model, u32 textureID, u32 lightmapID,
+                     const Vec3& color, std::span<const DrawIndirectCommand> commands);
+    
+    /// Order items by program, texture and vertex array
+    void sort();
+    
+    void clear() {
+        m_items.clear();
+        m_commands.clear();
+    }
+    
+    std::span<const DrawItem> getItems() const { return m_items; }
+    std::span<const DrawIndirectCommand> getCommands() const { return m_commands; }
+    bool empty() const { return m_items.empty(); }
+    size_t size() const { return m_items.size(); }
+
+private:
+    std::vector<DrawItem> m_items;              // Capacity kept across frames
+    std::vector<DrawIndirectCommand> m_commands;
+};
+
+} // namespace cscpp::renderer
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file frustum.hpp
+ * @brief View frustum planes and bounding box tests
+ *
+ * Planes are extracted from a combined matrix (Gribb/Hartmann), so the
+ * frustum lives in whatever space that matrix maps from: pass
+ * viewProjection * model to test model-space boxes without transforming
+ * them. Assumes GL's -1..1 clip depth.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+
+namespace cscpp::renderer {
+
+struct Frustum {
+    Vec4 planes[6];     ///< left, right, bottom, top, near, far; xyz points inside
+    
+    Frustum() = default;
+    explicit Frustum(const Mat4& clipFromSpace) { extractFromMatrix(clipFromSpace); }
+    
+    void extractFromMatrix(const Mat4& m) {
+        const Vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        const Vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        const Vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        const Vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        
+        planes[0] = row3 + row0;
+        planes[1] = row3 - row0;
+        planes[2] = row3 + row1;
+        planes[3] = row3 - row1;
+        planes[4] = row3 + row2;
+        planes[5] = row3 - row2;
+        
+        for (Vec4& plane : planes) {
+            const f32 length = glm::length(Vec3(plane));
+            if (length > 0.0f) {
+                plane /= length;
+            }
+        }
+    }
+    
+    /// False only if the box is entirely outside one plane (conservative near corners)
+    bool testAABB(const AABB& box) const {
+        for (const Vec4& plane : planes) {
+            // Corner farthest along the plane normal
+            const Vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                                plane.y >= 0.0f ? box.max.y : box.min.y,
+                                plane.z >= 0.0f ? box.max.z : box.min.z);
+            if (glm::dot(Vec3(plane), positive) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace cscpp::renderer
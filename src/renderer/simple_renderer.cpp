@@ -1,11 +1,45 @@
 #include "renderer/simple_renderer.hpp"
 #include "core/logging/logger.hpp"
 #include <glad/glad.h>
-#include <fstream>
+#include "core/profiling/profiler.hpp"
+#include "core/profiling/profiler_gpu.hpp"
+#include <algorithm>
+#include <cstdint>
 
 namespace cscpp::renderer {
 
+SimpleRenderer::~SimpleRenderer() {
+    if (m_indirectBuffer != 0) {
+        glDeleteBuffers(1, &m_indirectBuffer);
+    }
+}
+
+Result<void> SimpleRenderer::loadProgram(Program& program, const std::string& name) {
+    // Try multiple paths for shaders
+    Result<void> result = std::unexpected(Error{"No shader files found"});
+    for (const char* prefix : {"", "../", "../../"}) {
+        const std::string path = std::string(prefix) + "assets/shaders/" + name;
+        result = program.shader.loadFromFiles(path + ".vert", path + ".frag");
+        if (result) {
+            LOG_INFO("Loaded shaders from: {}.vert", path);
+            break;
+        }
+    }
+    if (!result) {
+        return result;
+    }
+    
+    // Handles are resolved here so the draw path never looks a uniform up by name
+    program.model = program.shader.getUniform<Mat4>("uModel");
+    program.color = program.shader.getUniform<Vec3>("uColor");
+    program.useTexture = program.shader.getUniform<bool>("uUseTexture");
+    program.useLightmap = program.shader.getUniform<bool>("uUseLightmap");
+    return program.shader.bindUniformBlock("FrameUniforms", FRAME_UNIFORM_BINDING);
+}
+
 Result<void> SimpleRenderer::initialize() {
+    CSCPP_PROFILE_GPU_CONTEXT();
+    
     // Enable depth testing
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -18,26 +52,30 @@ Result<void> SimpleRenderer::initialize() {
     // Set default clear color
     glClearColor(0.2f, 0.2f, 0.3f, 1.0f);
     
-    // Try multiple paths for shaders
-    std::vector<std::pair<std::string, std::string>> shaderPaths = {
-        {"assets/shaders/basic.vert", "assets/shaders/basic.frag"},
-        {"../assets/shaders/basic.vert", "../assets/shaders/basic.frag"},
-        {"../../assets/shaders/basic.vert", "../../assets/shaders/basic.frag"},
-    };
+    if (auto result = loadProgram(m_basic, "basic"); !result) {
+        LOG_ERROR("Failed to load basic shader: {}", result.error().message);
+        return result;
+    }
+    if (auto result = loadProgram(m_layered, "layered"); !result) {
+        LOG_ERROR("Failed to load layered shader: {}", result.error().message);
+        return result;
+    }
+    m_layered.textureArrays = true;
+    if (auto result = loadProgram(m_instanced, "instanced"); !result) {
+        LOG_ERROR("Failed to load instanced shader: {}", result.error().message);
+        return result;
+    }
     
-    Result<void> result = std::unexpected(Error{"No shader files found"});
-    for (const auto& [vert, frag] : shaderPaths) {
-        result = m_basicShader.loadFromFiles(vert, frag);
-        if (result) {
-            LOG_INFO("Loaded shaders from: {}", vert);
-            break;
-        }
+    // Without persistent mapping instances are still drawn, through one upload per frame
+    if (auto ringResult = m_instances.initialize(); !ringResult) {
+        LOG_WARN("{}", ringResult.error().message);
     }
     
-    if (!result) {
-        LOG_ERROR("Failed to load basic shader: {}", result.error().message);
-        return result;
+    if (auto bufferResult = m_frameUniforms.create(sizeof(FrameUniforms), FRAME_UNIFORM_BINDING); !bufferResult) {
+        LOG_ERROR("Failed to create frame uniform buffer: {}", bufferResult.error().message);
+        return bufferResult;
     }
+    glGenBuffers(1, &m_indirectBuffer);
     
     LOG_INFO("Simple renderer initialized");
     return {};
@@ -55,11 +93,21 @@ void SimpleRenderer::setCamera(const Mat4& view, const Mat4& projection) {
 }
 
 void SimpleRenderer::clear(const Vec3& color) {
+    CSCPP_PROFILE_GPU_ZONE("Clear");
     glClearColor(color.r, color.g, color.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+void SimpleRenderer::endFrame() {
+    flush();
+    CSCPP_PROFILE_GPU_COLLECT();
+}
+
 void SimpleRenderer::drawMesh(const GLMesh& mesh, const Mat4& model, const Vec3& color) {
+    drawMeshWithTexture(mesh, model, 0, color);
+}
+
+void SimpleRenderer::drawMeshWithTexture(const GLMesh& mesh, const Mat4& model, u32 textureID, const Vec3& color) {
     if (!mesh.isValid()) {
         static bool logged = false;
         if (!logged) {
@@ -68,202 +116,139 @@ void SimpleRenderer::drawMesh(const GLMesh& mesh, const Mat4& model, const Vec3&
         }
         return;
     }
-    
-    if (!m_basicShader.isValid()) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("Shader is not valid!");
-            logged = true;
-        }
-        return;
-    }
-    
-    // Clear any previous errors at the start
-    GLenum prevErr = GL_NO_ERROR;
-    while ((prevErr = glGetError()) != GL_NO_ERROR) {
-        // Clear all previous errors
-    }
-    
-    // Bind shader first
-    m_basicShader.bind();
-    
-    // Check for errors after binding
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("OpenGL error after shader bind: 0x{:X}", static_cast<u32>(err));
-            logged = true;
-        }
-    }
-    
-    // Set uniforms
-    m_basicShader.setUniform("uModel", model);
-    m_basicShader.setUniform("uView", m_view);
-    m_basicShader.setUniform("uProjection", m_projection);
-    m_basicShader.setUniform("uColor", color);
-    m_basicShader.setUniform("uUseTexture", false);  // Will be set to true when texture is bound
-    
-    // Check for errors after setting uniforms
-    err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("OpenGL error after setting uniforms: 0x{:X}", static_cast<u32>(err));
-            logged = true;
-        }
-    }
-    
-    // Ensure shader is still bound before drawing (in case getUniformLocation changed it)
-    m_basicShader.bind();
-    
-    // Verify shader is actually bound
-    GLint currentProgram = 0;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    if (currentProgram != static_cast<GLint>(m_basicShader.getProgram())) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("Shader program not bound before draw! Expected: {}, Got: {}", 
-                     m_basicShader.getProgram(), currentProgram);
-            logged = true;
-        }
-        // Force bind it
-        glUseProgram(m_basicShader.getProgram());
-    }
-    
-    // Verify vertex attributes are enabled (they should be part of VAO state)
-    // But let's check if the shader program is valid and linked
-    GLint linkStatus = 0;
-    glGetProgramiv(m_basicShader.getProgram(), GL_LINK_STATUS, &linkStatus);
-    if (linkStatus != GL_TRUE) {
-        static bool logged = false;
-        if (!logged) {
-            char infoLog[512];
-            glGetProgramInfoLog(m_basicShader.getProgram(), 512, nullptr, infoLog);
-            LOG_ERROR("Shader program not properly linked: {}", infoLog);
-            logged = true;
-        }
+    if (!m_basic.shader.isValid()) {
         return;
     }
-    
-    // Draw the mesh (VAO will be bound by mesh.draw())
-    // Check VAO before drawing
-    GLint boundVAOBefore = 0;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &boundVAOBefore);
-    
-    // Verify mesh is valid before drawing
-    if (!mesh.isValid()) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("Attempting to draw invalid mesh!");
-            logged = true;
-        }
+    m_drawList.add(m_basic.shader.getProgram(), mesh, model, textureID, color);
+}
+
+void SimpleRenderer::drawMeshGroups(const GLMesh& mesh, const Mat4& model, u32 textureID, bool textureArray,
+                                    u32 lightmapID, std::span<const DrawIndirectCommand> commands, const Vec3& color) {
+    const Program& program = textureArray ? m_layered : m_basic;
+    if (!mesh.isValid() || !program.shader.isValid()) {
         return;
     }
-    
-    mesh.draw();
-    
-    // Check VAO after drawing (should still be bound)
-    GLint boundVAOAfter = 0;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &boundVAOAfter);
-    
-    // Check for errors after drawing
-    err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static u32 errorCount = 0;
-        if (errorCount < 5) {
-            LOG_ERROR("OpenGL error after mesh.draw(): 0x{:X} (program: {}, VAO before: {}, VAO after: {})", 
-                     static_cast<u32>(err), currentProgram, boundVAOBefore, boundVAOAfter);
-            errorCount++;
-        }
-    }
-    
-    // Unbind VAO after error check
-    glBindVertexArray(0);
+    m_drawList.addIndirect(program.shader.getProgram(), mesh, model, textureID, textureArray ? lightmapID : 0, color,
+                           commands);
 }
 
-void SimpleRenderer::drawMeshWithTexture(const GLMesh& mesh, const Mat4& model, u32 textureID, const Vec3& color) {
-    if (!mesh.isValid() || textureID == 0) {
-        // Fall back to regular draw if invalid
-        static bool logged = false;
-        if (!logged) {
-            LOG_WARN("drawMeshWithTexture called with invalid mesh or texture ID {}", textureID);
-            logged = true;
-        }
-        drawMesh(mesh, model, color);
+void SimpleRenderer::drawInstanced(const GLMesh& mesh, u32 textureID, std::span<const DrawIndirectCommand> commands) {
+    if (!mesh.isValid() || !m_instanced.shader.isValid()) {
         return;
     }
-    
-    if (!m_basicShader.isValid()) {
+    m_drawList.addIndirect(m_instanced.shader.getProgram(), mesh, Mat4(1.0f), textureID, 0, Vec3(1.0f), commands);
+}
+
+void SimpleRenderer::uploadDrawUniforms(Program& program, const DrawItem& item) {
+    // Program uniforms persist, so per-draw values are only sent when they change
+    const bool useTexture = item.textureID != 0;
+    if (!program.valid || program.useTextureValue != useTexture) {
+        program.shader.setUniform(program.useTexture, useTexture);
+        program.useTextureValue = useTexture;
+        m_stats.uniformUploads++;
+    }
+    const bool useLightmap = item.lightmapID != 0;
+    if (program.useLightmap.isValid() && (!program.valid || program.useLightmapValue != useLightmap)) {
+        program.shader.setUniform(program.useLightmap, useLightmap);
+        program.useLightmapValue = useLightmap;
+        m_stats.uniformUploads++;
+    }
+    if (program.model.isValid() && (!program.valid || program.modelValue != item.model)) {
+        program.shader.setUniform(program.model, item.model);
+        program.modelValue = item.model;
+        m_stats.uniformUploads++;
+    }
+    if (program.color.isValid() && (!program.valid || program.colorValue != item.color)) {
+        program.shader.setUniform(program.color, item.color);
+        program.colorValue = item.color;
+        m_stats.uniformUploads++;
+    }
+    program.valid = true;
+}
+
+void SimpleRenderer::flush() {
+    CSCPP_PROFILE_FUNCTION();
+    CSCPP_PROFILE_GPU_ZONE("DrawList");
+    
+    m_stats = {};
+    m_state.resetStats();
+    if (m_drawList.empty()) {
+        m_instances.endFrame();
         return;
     }
+    m_drawList.sort();
     
-    // Clear any previous errors
-    while (glGetError() != GL_NO_ERROR) {}
-    
-    // Bind shader first
-    m_basicShader.bind();
+    // Loaders and the upload queue bind textures and VAOs directly between frames
+    m_state.invalidate();
     
-    // Set uniforms
-    m_basicShader.setUniform("uModel", model);
-    m_basicShader.setUniform("uView", m_view);
-    m_basicShader.setUniform("uProjection", m_projection);
-    m_basicShader.setUniform("uColor", color);
-    m_basicShader.setUniform("uUseTexture", true);
-    
-    // Bind texture to texture unit 0 BEFORE setting the uniform
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    // Verify texture is actually bound
-    GLint boundTexture = 0;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
-    if (boundTexture != static_cast<GLint>(textureID)) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("Texture binding failed! Expected: {}, Got: {}", textureID, boundTexture);
-            logged = true;
-        }
+    // Camera matrices are shared by every draw: one buffer write per frame at most
+    if (!m_frameValid || m_frameValues.view != m_view || m_frameValues.projection != m_projection) {
+        m_frameValues = {m_view, m_projection, m_projection * m_view};
+        m_frameUniforms.update(&m_frameValues, sizeof(FrameUniforms));
+        m_frameValid = true;
+        m_stats.uniformUploads++;
     }
     
-    // Set the sampler uniform to use texture unit 0
-    // This must be done AFTER binding the texture
-    m_basicShader.setUniform("uTexture", 0);
-    
-    // Debug: log texture binding on first call
-    static bool firstTextureBind = true;
-    if (firstTextureBind) {
-        LOG_INFO("Bound texture ID {} to texture unit 0, verified bound: {}", textureID, boundTexture);
-        firstTextureBind = false;
-    }
-    
-    // Check for OpenGL errors
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("OpenGL error after binding texture {}: 0x{:X}", textureID, static_cast<u32>(err));
-            logged = true;
+    // Every multi-draw's commands in one write, the buffer is re-specified so the driver can orphan it
+    const std::span<const DrawIndirectCommand> commands = m_drawList.getCommands();
+    if (!commands.empty()) {
+        const u64 size = commands.size_bytes();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        if (size > m_indirectCapacity) {
+            m_indirectCapacity = std::max(size, m_indirectCapacity * 2);
+        }
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(m_indirectCapacity), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(size), commands.data());
+    }
+    
+    // The frame's instances were written into the ring while the items were queued
+    m_stats.instances = m_instances.getFrameCount();
+    m_instances.bind();
+    
+    for (const DrawItem& item : m_drawList.getItems()) {
+        Program& program = programFor(item.program);
+        m_state.useProgram(item.program);
+        uploadDrawUniforms(program, item);
+        
+        if (item.textureID != 0) {
+            if (program.textureArrays) {
+                m_state.bindTexture2DArray(0, item.textureID);
+            } else {
+                m_state.bindTexture2D(0, item.textureID);
+            }
+        }
+        if (item.lightmapID != 0) {
+            m_state.bindTexture2DArray(1, item.lightmapID);
         }
+        m_state.bindVertexArray(item.vertexArray);
+        
+        if (item.commandCount > 0) {
+            const uintptr_t offset = static_cast<uintptr_t>(item.firstCommand) * sizeof(DrawIndirectCommand);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, item.indexType, reinterpret_cast<const void*>(offset),
+                                        static_cast<GLsizei>(item.commandCount), sizeof(DrawIndirectCommand));
+            m_stats.indirectCommands += item.commandCount;
+        } else {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(item.indexCount), item.indexType, nullptr);
+        }
+        CSCPP_GL_CHECK("draw list item");
+        m_stats.draws++;
     }
+    m_state.verify();
+    m_instances.endFrame();
     
-    // Draw mesh
-    mesh.draw();
-    
-    // Check for errors after drawing
-    err = glGetError();
-    if (err != GL_NO_ERROR) {
-        static bool logged = false;
-        if (!logged) {
-            LOG_ERROR("OpenGL error after drawing with texture {}: 0x{:X}", textureID, static_cast<u32>(err));
-            logged = true;
-        }
+    // A bound VAO would capture element buffer binds made by later uploads
+    m_state.bindVertexArray(0);
+    if (!commands.empty()) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
     }
+    m_drawList.clear();
     
-    // Unbind texture
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindVertexArray(0);
+    m_stats.state = m_state.getStats();
+    CSCPP_PROFILE_PLOT("Draw calls", static_cast<i64>(m_stats.draws));
+    CSCPP_PROFILE_PLOT("State changes", static_cast<i64>(m_stats.state.programBinds + m_stats.state.textureBinds +
+                                                         m_stats.state.vertexArrayBinds));
+    CSCPP_PROFILE_PLOT("Instances", static_cast<i64>(m_stats.instances));
+    CSCPP_PROFILE_PLOT("Uniform uploads", static_cast<i64>(m_stats.uniformUploads));
 }
 
 } // namespace cscpp::renderer
-
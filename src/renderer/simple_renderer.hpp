@@ -4,15 +4,57 @@
 #include "core/math/math.hpp"
 #include "renderer/backend/gl_shader.hpp"
 #include "renderer/backend/gl_mesh.hpp"
+#include "renderer/backend/gl_instance_buffer.hpp"
+#include "renderer/backend/gl_state_cache.hpp"
+#include "renderer/backend/gl_uniform_buffer.hpp"
+#include "renderer/draw_list.hpp"
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace cscpp::renderer {
 
+/// Work done by the last flush()
+struct RenderStats {
+    u32 draws = 0;              ///< GL draw calls, a multi-draw counts once
+    u32 indirectCommands = 0;   ///< Commands submitted by multi-draws
+    u32 instances = 0;          ///< Instances streamed through the instance ring
+    u32 uniformUploads = 0;
+    GLStateStats state;
+};
+
+/// std140 layout of the FrameUniforms block in basic.vert and layered.vert
+struct FrameUniforms {
+    Mat4 view;
+    Mat4 projection;
+    Mat4 viewProjection;
+};
+static_assert(sizeof(FrameUniforms) == 3 * 64, "FrameUniforms must match the std140 block");
+
+/// Uniform buffer binding point of FrameUniforms
+inline constexpr u32 FRAME_UNIFORM_BINDING = 0;
+
+/**
+ * @brief Forward renderer with deferred, state-sorted submission
+ *
+ * drawMesh(), drawMeshWithTexture() and drawMeshGroups() only queue a
+ * DrawItem. endFrame() sorts the frame's items by shader, texture and VAO
+ * and submits them through a GLStateCache; the indirect commands of all
+ * multi-draws go to the GPU in one buffer write. Camera matrices go to a uniform buffer once per
+ * frame; per-draw uniforms are set through handles resolved at load and
+ * only when their value differs from what the program already holds.
+ * Instanced draws take their model matrices from a GLInstanceBuffer
+ * instead, so any number of copies of a mesh and texture is one draw.
+ * Meshes and textures must stay alive until endFrame().
+ */
 class SimpleRenderer {
 public:
     SimpleRenderer() = default;
-    ~SimpleRenderer() = default;
+    ~SimpleRenderer();
+    
+    SimpleRenderer(const SimpleRenderer&) = delete;
+    SimpleRenderer& operator=(const SimpleRenderer&) = delete;
     
     /// Initialize the renderer
     Result<void> initialize();
@@ -26,17 +68,94 @@ public:
     /// Clear the screen
     void clear(const Vec3& color = Vec3(0.1f, 0.1f, 0.15f));
     
-    /// Draw a mesh with a model matrix
+    /// Submit the queued draws and finish the frame's GPU profiling zones (call before swapping buffers)
+    void endFrame();
+    
+    /// Queue a mesh with a model matrix, untextured
     void drawMesh(const GLMesh& mesh, const Mat4& model, const Vec3& color = Vec3(1.0f));
     
-    /// Draw a mesh with a texture
+    /// Queue a mesh with a texture (0 draws it untextured)
     void drawMeshWithTexture(const GLMesh& mesh, const Mat4& model, u32 textureID, const Vec3& color = Vec3(1.0f));
     
+    /**
+     * @brief Queue index ranges of a mesh as one glMultiDrawElementsIndirect
+     *
+     * With `textureArray` the texture is a 2D array and each command's
+     * baseInstance selects its layer; otherwise baseInstance must be 0.
+     * `lightmapID` is a 2D array of lightmap atlas pages, sampled at each
+     * vertex's lightmap coordinate (texture arrays only, 0 = unlit).
+     * Commands are copied, the span only has to live for the call.
+     */
+    void drawMeshGroups(const GLMesh& mesh, const Mat4& model, u32 textureID, bool textureArray, u32 lightmapID,
+                        std::span<const DrawIndirectCommand> commands, const Vec3& color = Vec3(1.0f));
+    
+    /**
+     * @brief Reserve instances for drawInstanced() in this frame's instance ring
+     * @param first Pass as the baseInstance of the commands drawing them
+     * @return Data to fill before endFrame(), empty once the frame has GLInstanceBuffer::MAX_INSTANCES
+     */
+    std::span<InstanceData> allocateInstances(u32 count, u32& first) { return m_instances.allocate(count, first); }
+    
+    /**
+     * @brief Queue instanced index ranges of a mesh as one glMultiDrawElementsIndirect
+     *
+     * Each command draws instanceCount instances starting at baseInstance,
+     * an index returned by allocateInstances(). `textureID` is a 2D texture
+     * (0 = untextured); the color comes from each instance.
+     */
+    void drawInstanced(const GLMesh& mesh, u32 textureID, std::span<const DrawIndirectCommand> commands);
+    
+    /// Sort and submit the queued draws (endFrame() does this)
+    void flush();
+    
     /// Get the basic shader
-    GLShader& getShader() { return m_basicShader; }
+    GLShader& getShader() { return m_basic.shader; }
+    
+    const RenderStats& getStats() const { return m_stats; }
     
 private:
-    GLShader m_basicShader;
+    /// A shader, its per-draw uniforms and the values it holds (to skip redundant uploads)
+    struct Program {
+        GLShader shader;
+        UniformHandle<Mat4> model;
+        UniformHandle<Vec3> color;
+        UniformHandle<bool> useTexture;
+        UniformHandle<bool> useLightmap;
+        bool textureArrays = false;     // Samples a 2D array texture at unit 0 (and the lightmap array at 1)
+        
+        Mat4 modelValue;
+        Vec3 colorValue;
+        bool useTextureValue = false;
+        bool useLightmapValue = false;
+        bool valid = false;             // False until the first flush uploads everything
+    };
+    
+    /// Load a shader pair from assets/shaders and resolve its uniforms
+    Result<void> loadProgram(Program& program, const std::string& name);
+    
+    /// Program a draw item refers to
+    Program& programFor(u32 name) {
+        if (name == m_layered.shader.getProgram()) {
+            return m_layered;
+        }
+        return name == m_instanced.shader.getProgram() ? m_instanced : m_basic;
+    }
+    
+    /// Set the per-draw uniforms of an item that differ from what the program holds
+    void uploadDrawUniforms(Program& program, const DrawItem& item);
+    
+    Program m_basic;
+    Program m_layered;
+    Program m_instanced;
+    GLInstanceBuffer m_instances;
+    GLUniformBuffer m_frameUniforms;
+    FrameUniforms m_frameValues;
+    bool m_frameValid = false;
+    u32 m_indirectBuffer = 0;
+    u64 m_indirectCapacity = 0;
+    DrawList m_drawList;
+    GLStateCache m_state;
+    RenderStats m_stats;
     Mat4 m_view;
     Mat4 m_projection;
     i32 m_viewportWidth = 1920;
@@ -0,0 +1,95 @@
+/**
+ * @file connection_router.cpp
+ * @brief Connection to match routing
+ */
+
+#include "server/connection_router.hpp"
+#include "server/match.hpp"
+
+namespace cscpp::server {
+
+u32 ConnectionRouter::addMatch(Match* match, u32 maxClients) {
+    MatchSlot& slot = m_matches.emplace_back();
+    slot.match = match;
+    slot.maxClients = maxClients;
+    return static_cast<u32>(m_matches.size() - 1);
+}
+
+const ConnectionRouter::Route* ConnectionRouter::connect(ConnectionKey connection, i32 preferredMatch) {
+    if (auto it = m_routes.find(connection); it != m_routes.end()) {
+        return &it->second;
+    }
+    
+    // Pick the requested match, or the emptiest one with room
+    i32 chosen = -1;
+    if (preferredMatch >= 0) {
+        if (static_cast<size_t>(preferredMatch) < m_matches.size()) {
+            const MatchSlot& slot = m_matches[static_cast<size_t>(preferredMatch)];
+            if (slot.clientCount < slot.maxClients) {
+                chosen = preferredMatch;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < m_matches.size(); ++i) {
+            const MatchSlot& slot = m_matches[i];
+            if (slot.clientCount >= slot.maxClients) {
+                continue;
+            }
+            if (chosen < 0 || slot.clientCount < m_matches[static_cast<size_t>(chosen)].clientCount) {
+                chosen = static_cast<i32>(i);
+            }
+        }
+    }
+    if (chosen < 0) {
+        return nullptr;
+    }
+    
+    MatchSlot& slot = m_matches[static_cast<size_t>(chosen)];
+    ClientId clientId;
+    if (!slot.freeIds.empty()) {
+        clientId = slot.freeIds.back();
+        slot.freeIds.pop_back();
+    } else {
+        clientId = slot.nextId++;
+    }
+    ++slot.clientCount;
+    
+    if (clientId >= slot.connections.size()) {
+        slot.connections.resize(clientId + 1, INVALID_CONNECTION);
+    }
+    slot.connections[clientId] = connection;
+    
+    Route& route = m_routes[connection];
+    route.matchIndex = static_cast<u32>(chosen);
+    route.clientId = clientId;
+    return &route;
+}
+
+void ConnectionRouter::disconnect(ConnectionKey connection) {
+    auto it = m_routes.find(connection);
+    if (it == m_routes.end()) {
+        return;
+    }
+    
+    MatchSlot& slot = m_matches[it->second.matchIndex];
+    slot.freeIds.push_back(it->second.clientId);
+    slot.connections[it->second.clientId] = INVALID_CONNECTION;
+    --slot.clientCount;
+    m_routes.erase(it);
+}
+
+const ConnectionRouter::Route* ConnectionRouter::find(ConnectionKey connection) const {
+    auto it = m_routes.find(connection);
+    return it != m_routes.end() ? &it->second : nullptr;
+}
+
+bool ConnectionRouter::dispatch(ConnectionKey connection, std::span<const u8> data) {
+    const Route* route = find(connection);
+    if (!route) {
+        return false;
+    }
+    m_matches[route->matchIndex].match->receivePacket(route->clientId, data);
+    return true;
+}
+
+} // namespace cscpp::server
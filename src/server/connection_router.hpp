@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * @file connection_router.hpp
+ * @brief Routes packets from the shared socket layer to matches
+ *
+ * The host has one network endpoint for all matches. Each remote connection
+ * (address/port pair, or transport peer id) is assigned to one match and
+ * gets a client id inside it; incoming packets are then handed to that
+ * match's receivePacket(). Used from the network thread only.
+ */
+
+#include "core/types.hpp"
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace cscpp::server {
+
+class Match;
+
+/// Transport-level identity of a remote endpoint
+using ConnectionKey = u64;
+
+constexpr ConnectionKey INVALID_CONNECTION = ~ConnectionKey{0};
+
+class ConnectionRouter {
+public:
+    struct Route {
+        u32 matchIndex = 0;
+        ClientId clientId = INVALID_CLIENT_ID;
+    };
+    
+    /// Register a match; returns its index
+    u32 addMatch(Match* match, u32 maxClients);
+    
+    size_t getMatchCount() const { return m_matches.size(); }
+    
+    /**
+     * @brief Place a new connection in a match
+     * @param preferredMatch Match asked for by the client, or -1 for the
+     *                       least populated match with a free slot
+     * @return nullptr if every candidate match is full
+     */
+    const Route* connect(ConnectionKey connection, i32 preferredMatch = -1);
+    
+    /// Free the connection's slot
+    void disconnect(ConnectionKey connection);
+    
+    const Route* find(ConnectionKey connection) const;
+    
+    /// Connection holding a match's client id, or INVALID_CONNECTION
+    ConnectionKey findConnection(u32 matchIndex, ClientId clientId) const {
+        const std::vector<ConnectionKey>& connections = m_matches[matchIndex].connections;
+        return clientId < connections.size() ? connections[clientId] : INVALID_CONNECTION;
+    }
+    
+    /// Hand a packet to the connection's match; false if not connected
+    bool dispatch(ConnectionKey connection, std::span<const u8> data);
+    
+    u32 getClientCount(u32 matchIndex) const { return m_matches[matchIndex].clientCount; }
+    
+private:
+    struct MatchSlot {
+        Match* match = nullptr;
+        u32 maxClients = 0;
+        u32 clientCount = 0;
+        std::vector<ClientId> freeIds;
+        ClientId nextId = 0;
+        std::vector<ConnectionKey> connections;     ///< Indexed by client id
+    };
+    
+    std::vector<MatchSlot> m_matches;
+    std::unordered_map<ConnectionKey, Route> m_routes;
+};
+
+} // namespace cscpp::server
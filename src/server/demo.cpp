@@ -0,0 +1,138 @@
+/**
+ * @file demo.cpp
+ * @brief Demo recording and reading
+ */
+
+#include "server/demo.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace cscpp::server {
+
+namespace {
+
+template<typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+Result<void> DemoWriter::open(const std::string& path, const DemoHeader& header) {
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        return std::unexpected(Error{"Failed to create demo: " + path});
+    }
+
+    const u8 nameLength = static_cast<u8>(std::min<size_t>(header.mapName.size(), 255));
+    writeValue(m_file, MAGIC);
+    writeValue(m_file, VERSION);
+    writeValue(m_file, header.tickRate);
+    writeValue(m_file, nameLength);
+    m_file.write(header.mapName.data(), nameLength);
+    m_bytesWritten = 13 + nameLength;
+    m_hasTick = false;
+
+    if (!m_file) {
+        return std::unexpected(Error{"Failed to write demo: " + path});
+    }
+    return {};
+}
+
+void DemoWriter::close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+void DemoWriter::writeRecord(DemoRecord type, Tick tick, ClientId clientId, std::span<const u8> data) {
+    if (!m_file.is_open() || data.size() > std::numeric_limits<u16>::max()) {
+        return;
+    }
+
+    if (!m_hasTick || tick != m_tick) {
+        writeValue(m_file, static_cast<u8>(DemoRecord::Tick));
+        writeValue(m_file, static_cast<u32>(tick));
+        m_tick = tick;
+        m_hasTick = true;
+        m_bytesWritten += 5;
+    }
+
+    writeValue(m_file, static_cast<u8>(type));
+    writeValue(m_file, static_cast<u16>(clientId));
+    writeValue(m_file, static_cast<u16>(data.size()));
+    m_file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    m_bytesWritten += 5 + data.size();
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+Result<void> DemoReader::open(const std::string& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file) {
+        return std::unexpected(Error{"Failed to open demo: " + path});
+    }
+
+    u32 magic = 0;
+    u32 version = 0;
+    u8 nameLength = 0;
+    if (!readValue(m_file, magic) || !readValue(m_file, version) || magic != DemoWriter::MAGIC) {
+        return std::unexpected(Error{"Not a demo: " + path});
+    }
+    if (version != DemoWriter::VERSION) {
+        return std::unexpected(Error{"Unsupported demo version " + std::to_string(version) + ": " + path});
+    }
+    if (!readValue(m_file, m_header.tickRate) || !readValue(m_file, nameLength) || m_header.tickRate == 0) {
+        return std::unexpected(Error{"Truncated demo header: " + path});
+    }
+    m_header.mapName.resize(nameLength);
+    if (!m_file.read(m_header.mapName.data(), nameLength)) {
+        return std::unexpected(Error{"Truncated demo header: " + path});
+    }
+    m_tick = 0;
+    return {};
+}
+
+bool DemoReader::next(DemoEntry& entry) {
+    u8 type = 0;
+    while (readValue(m_file, type)) {
+        if (type == static_cast<u8>(DemoRecord::Tick)) {
+            u32 tick = 0;
+            if (!readValue(m_file, tick)) {
+                return false;
+            }
+            m_tick = static_cast<Tick>(tick);
+            continue;
+        }
+        if (type != static_cast<u8>(DemoRecord::Packet) && type != static_cast<u8>(DemoRecord::Snapshot)) {
+            return false;
+        }
+
+        u16 clientId = 0;
+        u16 size = 0;
+        if (!readValue(m_file, clientId) || !readValue(m_file, size)) {
+            return false;
+        }
+        entry.type = static_cast<DemoRecord>(type);
+        entry.tick = m_tick;
+        entry.clientId = static_cast<ClientId>(clientId);
+        entry.data.resize(size);
+        return static_cast<bool>(m_file.read(reinterpret_cast<char*>(entry.data.data()), size));
+    }
+    return false;
+}
+
+} // namespace cscpp::server
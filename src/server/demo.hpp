@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file demo.hpp
+ * @brief Recorded match traffic: inbound client messages and outbound snapshots
+ *
+ * A demo holds what one match received and sent, in the order the network
+ * thread saw it: every message routed to the match (connects, commands,
+ * acks, disconnects) and every snapshot packet encoded for a client. Each
+ * record is tagged with the tick of the newest frame the network thread had
+ * encoded when it was written, so a replay can feed the messages tagged
+ * before a tick and then run that tick.
+ *
+ * File layout (little-endian):
+ *   u32 magic | u32 version | u32 tick rate | u8 map name length | map name
+ *   records: u8 DemoRecord, then
+ *     Tick:             u32 tick (all following records belong to it)
+ *     Packet/Snapshot:  u16 client id | u16 size | bytes
+ *
+ * Messages are stored as they were bit-packed on the wire; the per-record
+ * overhead is five bytes plus five per tick that has records.
+ */
+
+#include "core/types.hpp"
+
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cscpp::server {
+
+enum class DemoRecord : u8 {
+    Tick = 0,
+    Packet = 1,         ///< Message routed to the match (network::MessageId first)
+    Snapshot = 2,       ///< Snapshot packet encoded for a client
+};
+
+struct DemoHeader {
+    u32 tickRate = 128;
+    std::string mapName;
+};
+
+/// One packet or snapshot read back from a demo
+struct DemoEntry {
+    DemoRecord type = DemoRecord::Packet;
+    Tick tick = 0;
+    ClientId clientId = INVALID_CLIENT_ID;
+    std::vector<u8> data;
+};
+
+class DemoWriter {
+public:
+    static constexpr u32 MAGIC = 0x4D445343;    // "CSDM"
+    static constexpr u32 VERSION = 1;
+
+    Result<void> open(const std::string& path, const DemoHeader& header);
+    void close();
+    bool isOpen() const { return m_file.is_open(); }
+
+    /// A message the match received from a client
+    void writePacket(Tick tick, ClientId clientId, std::span<const u8> data) {
+        writeRecord(DemoRecord::Packet, tick, clientId, data);
+    }
+
+    /// A snapshot packet the match encoded for a client
+    void writeSnapshot(Tick tick, ClientId clientId, std::span<const u8> packet) {
+        writeRecord(DemoRecord::Snapshot, tick, clientId, packet);
+    }
+
+    u64 getBytesWritten() const { return m_bytesWritten; }
+
+private:
+    void writeRecord(DemoRecord type, Tick tick, ClientId clientId, std::span<const u8> data);
+
+    std::ofstream m_file;
+    Tick m_tick = 0;
+    bool m_hasTick = false;
+    u64 m_bytesWritten = 0;
+};
+
+class DemoReader {
+public:
+    Result<void> open(const std::string& path);
+
+    const DemoHeader& getHeader() const { return m_header; }
+
+    /// Read the next packet or snapshot (entry.data is reused); false at the end
+    bool next(DemoEntry& entry);
+
+private:
+    std::ifstream m_file;
+    DemoHeader m_header;
+    Tick m_tick = 0;
+};
+
+} // namespace cscpp::server
@@ -0,0 +1,106 @@
+/**
+ * @file map_cache.cpp
+ * @brief Shared map loading
+ */
+
+#include "server/map_cache.hpp"
+#include "assets/bsp/bsp_entities.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "core/logging/logger.hpp"
+
+namespace cscpp::server {
+
+namespace {
+
+/// Hulls and decompressed PVS from a cooked map, if there is one for this BSP
+bool loadCookedMap(MapData& map, const std::string& bspPath, const assets::bsp::BSPView& bsp) {
+    assets::cooked::CookedMapView view;
+    if (!view.open(assets::cooked::cookedPathFor(bspPath))) {
+        return false;
+    }
+    if (bsp.isOpen() && !view.isCookedFrom(bsp)) {
+        LOG_WARN("Cooked map {} is stale, loading the BSP instead", view.getPath());
+        return false;
+    }
+    
+    if (auto result = map.collision.load(view); !result) {
+        LOG_WARN("Cooked collision load failed for {}: {}", view.getPath(), result.error().message);
+        return false;
+    }
+    LOG_INFO("Map collision loaded from: {}", view.getPath());
+    
+    if (auto visResult = map.visibility.load(view); !visResult) {
+        LOG_WARN("No visibility for map '{}': {}", map.name, visResult.error().message);
+    }
+    return true;
+}
+
+void loadMap(MapData& map) {
+    const std::string relativePath = "assets/maps/" + map.name + ".bsp";
+    const std::string searchPaths[] = {
+        relativePath,
+        "../" + relativePath,
+        "../../" + relativePath,
+    };
+    
+    for (const auto& path : searchPaths) {
+        // One mapping feeds both loaders; it is released once they have copied what they keep
+        assets::bsp::BSPView view;
+        auto result = view.open(path);
+        if (result) {
+            map.spawnPoints = assets::bsp::readSpawnPoints(view);
+        }
+        if (loadCookedMap(map, path, view)) {
+            return;
+        }
+        if (result) {
+            result = map.collision.load(view);
+        }
+        if (result) {
+            LOG_INFO("Map collision loaded from: {}", path);
+            
+            // Same file carries the PVS used for snapshot relevance
+            auto visResult = map.visibility.load(view);
+            if (!visResult) {
+                LOG_WARN("No visibility for map '{}': {}", map.name, visResult.error().message);
+            }
+            return;
+        }
+        LOG_DEBUG("Collision load failed for {}: {}", path, result.error().message);
+    }
+    
+    LOG_WARN("No collision for map '{}', players will move without clipping", map.name);
+}
+
+} // anonymous namespace
+
+std::shared_ptr<const MapData> MapCache::acquire(const std::string& mapName) {
+    std::lock_guard lock(m_mutex);
+    
+    if (auto it = m_maps.find(mapName); it != m_maps.end()) {
+        if (auto map = it->second.lock()) {
+            return map;
+        }
+    }
+    
+    auto map = std::make_shared<MapData>();
+    map->name = mapName;
+    loadMap(*map);
+    
+    std::shared_ptr<const MapData> shared = std::move(map);
+    m_maps[mapName] = shared;
+    return shared;
+}
+
+size_t MapCache::getLoadedCount() const {
+    std::lock_guard lock(m_mutex);
+    
+    size_t count = 0;
+    for (const auto& [name, map] : m_maps) {
+        count += map.expired() ? 0 : 1;
+    }
+    return count;
+}
+
+} // namespace cscpp::server
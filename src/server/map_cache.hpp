@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * @file map_cache.hpp
+ * @brief Read-only map data shared between matches
+ *
+ * Collision hulls and the PVS are immutable after loading and all queries
+ * are const, so every match on the same map uses one copy regardless of
+ * which thread it runs on.
+ */
+
+#include "core/types.hpp"
+#include "movement/collision/collision_world.hpp"
+#include "network/interest/map_visibility.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cscpp::server {
+
+/**
+ * @brief Immutable per-map data
+ */
+struct MapData {
+    std::string name;
+    movement::CollisionWorld collision;     ///< Empty if the map could not be loaded
+    network::MapVisibility visibility;
+    std::vector<Vec3> spawnPoints;          ///< info_player_start/deathmatch origins (may be empty)
+};
+
+class MapCache {
+public:
+    /**
+     * @brief Get a map, loading it on first use
+     *
+     * Never fails: a missing map yields empty collision and visibility so
+     * the match still runs (players move without clipping).
+     */
+    std::shared_ptr<const MapData> acquire(const std::string& mapName);
+    
+    /// Maps currently held by at least one match
+    size_t getLoadedCount() const;
+    
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<const MapData>> m_maps;
+};
+
+} // namespace cscpp::server
@@ -0,0 +1,508 @@
+/**
+ * @file match.cpp
+ * @brief One authoritative match world
+ */
+
+#include "server/match.hpp"
+#include "core/logging/logger.hpp"
+#include "core/memory/allocation_counter.hpp"
+#include "core/profiling/profiler.hpp"
+#include "gameplay/weapons/weapon.hpp"
+#include "movement/collision/collision_world.hpp"
+#include "network/protocol/message_schemas.hpp"
+
+#include <algorithm>
+
+namespace cscpp::server {
+
+/// Adds the heap allocations made while in scope to a counter
+class CountAllocations {
+public:
+    explicit CountAllocations(metrics::Counter& counter) : m_counter(counter) {}
+    ~CountAllocations() { m_counter.add(m_scope.getCount()); }
+    
+private:
+    metrics::Counter& m_counter;
+    AllocationScope m_scope;
+};
+
+namespace {
+
+/// Head, chest, stomach and legs, filling the standing hull around the origin
+void addStandingHitboxes(ecs::HitboxComponent& hitbox) {
+    using gameplay::HitGroup;
+    const auto add = [&](HitGroup group, Vec3 mins, Vec3 maxs) {
+        hitbox.hitboxes.push_back({mins, maxs, static_cast<i32>(group),
+                                   gameplay::getHitGroupDamageMultiplier(group)});
+    };
+    const Vec3 hullMins = movement::hull::STANDING_MINS;
+    const Vec3 hullMaxs = movement::hull::STANDING_MAXS;
+    
+    add(HitGroup::Head,     Vec3(-6.0f, -6.0f, 24.0f),       Vec3(6.0f, 6.0f, hullMaxs.z));
+    add(HitGroup::Chest,    Vec3(-10.0f, -12.0f, 6.0f),      Vec3(10.0f, 12.0f, 24.0f));
+    add(HitGroup::Stomach,  Vec3(-9.0f, -10.0f, -8.0f),      Vec3(9.0f, 10.0f, 6.0f));
+    add(HitGroup::LeftLeg,  Vec3(-7.0f, 0.0f, hullMins.z),   Vec3(7.0f, 8.0f, -8.0f));
+    add(HitGroup::RightLeg, Vec3(-7.0f, -8.0f, hullMins.z),  Vec3(7.0f, 0.0f, -8.0f));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Lifetime
+// ============================================================================
+
+bool Match::initialize(u32 id, const MatchConfig& config, std::shared_ptr<const MapData> map,
+                       f32 tickInterval, JobSystem& jobs) {
+    m_id = id;
+    m_config = config;
+    m_map = std::move(map);
+    m_jobs = &jobs;
+    m_tickInterval = tickInterval;
+    
+    // Initialize ECS world
+    m_world = std::make_unique<ecs::World>();
+    m_world->setJobSystem(m_jobs);
+    
+    // Initialize movement variables
+    m_moveVars.gravity = 800.0f;
+    m_moveVars.stopSpeed = 100.0f;
+    m_moveVars.maxSpeed = 320.0f;
+    m_moveVars.accelerate = 10.0f;
+    m_moveVars.airAccelerate = 10.0f;  // Set to 100 for classic bhop
+    m_moveVars.friction = 4.0f;
+    m_moveVars.stepSize = 18.0f;
+    m_moveVars.maxVelocity = 2000.0f;
+    
+    // Snapshot relevance (PVS culling)
+    m_interest.setVisibility(&m_map->visibility);
+    
+    // Broad-phase for hitscan and area queries, kept in step with rewinds
+    m_lagCompensation.setSpatialGrid(&m_spatial);
+    m_lagCompensation.setTickInterval(m_tickInterval);
+    
+    // Shared movement setup for all players. Traces only read the world.
+    m_moveBatch.setMoveVars(&m_moveVars);
+    m_moveBatch.setFrameTime(m_tickInterval);
+    if (m_map->collision.isLoaded()) {
+        m_moveBatch.setTrace(&movement::worldTraceFunction,
+                             const_cast<movement::CollisionWorld*>(&m_map->collision));
+    }
+    m_moveBatch.reserve(static_cast<size_t>(config.maxPlayers));
+    m_moveEntities.reserve(static_cast<size_t>(config.maxPlayers));
+    
+    LOG_INFO("[match {}] '{}' on {} ({} players)", m_id, config.serverName, config.mapName, config.maxPlayers);
+    return true;
+}
+
+void Match::shutdown() {
+    m_world.reset();
+    m_map.reset();
+}
+
+// ============================================================================
+// Tick
+// ============================================================================
+
+void Match::tick(Tick tick, bool shed) {
+    CSCPP_PROFILE_ZONE("Match::tick");
+    const i64 start = monotonicNanos();
+    const CountAllocations allocations(m_metrics.tickAllocations);
+    
+    // 1. Spawn and remove players, queue the commands decoded by the network thread
+    applyClientEvents();
+    m_metrics.commandQueueDepth.record(m_cmdRing.size());
+    applyClientCommands();
+    i64 mark = m_metrics.recordStage(TickStage::Commands, start);
+    
+    // 2. Process inputs and run movement for each player
+    processPlayerMovement(tick);
+    mark = m_metrics.recordStage(TickStage::Movement, mark);
+    
+    // 3. Refresh the broad-phase and store post-movement hitboxes for
+    //    lag-compensated hit tests
+    m_spatial.sync(m_world->getRegistry());
+    m_lagCompensation.recordTick(m_world->getRegistry(), tick);
+    mark = m_metrics.recordStage(TickStage::LagCompensation, mark);
+    
+    // 4. Run world simulation (projectiles, game logic)
+    simulateWorld();
+    mark = m_metrics.recordStage(TickStage::Simulation, mark);
+    
+    // 5. Hand the replicated state to the network thread for encoding
+    //    (skipped while catching up; clients interpolate across the gap)
+    if (!shed) {
+        publishSnapshot(tick);
+        mark = m_metrics.recordStage(TickStage::Publish, mark);
+    }
+    
+    // Update world tick
+    m_world->setCurrentTick(tick);
+    
+    m_metrics.tickDuration.record(static_cast<u64>(mark - start));
+    m_metrics.ticks.add();
+}
+
+// ============================================================================
+// Input
+// ============================================================================
+
+void Match::receivePacket(ClientId clientId, std::span<const u8> data) {
+    CSCPP_PROFILE_FUNCTION();
+    if (data.empty()) {
+        return;
+    }
+    const CountAllocations allocations(m_metrics.networkAllocations);
+    
+    network::BitReader reader(data.data(), data.size());
+    
+    switch (static_cast<network::MessageId>(data[0])) {
+        case network::MessageId::ClientConnect:
+        case network::MessageId::ClientDisconnect: {
+            // The router already admitted the connection; start or stop its
+            // snapshot stream here and its player on the host thread
+            const bool joined = static_cast<network::MessageId>(data[0]) == network::MessageId::ClientConnect;
+            if (joined) {
+                m_snapshots.addClient(clientId);
+            } else {
+                m_snapshots.removeClient(clientId);
+            }
+            ClientEvent* event = m_eventRing.beginPush();
+            if (!event) {
+                LOG_WARN("[match {}] Event ring full, client {} {} ignored",
+                         m_id, clientId, joined ? "join" : "leave");
+                break;
+            }
+            event->clientId = clientId;
+            event->joined = joined;
+            m_eventRing.endPush();
+            break;
+        }
+        case network::MessageId::UserCmd: {
+            network::UserCmdMsg cmdMsg(&m_packetArena);
+            if (!network::readMessage(reader, cmdMsg)) {
+                return;
+            }
+            for (const UserCmd& cmd : cmdMsg.cmds) {
+                QueuedCmd* slot = m_cmdRing.beginPush();
+                if (!slot) {
+                    // Host thread is behind; the client resends recent commands
+                    m_metrics.droppedCommands.add();
+                    break;
+                }
+                slot->clientId = clientId;
+                slot->cmd = cmd;
+                m_cmdRing.endPush();
+            }
+            break;
+        }
+        case network::MessageId::ClientAck: {
+            network::ClientAckMsg ack{};
+            if (network::readMessage(reader, ack)) {
+                m_snapshots.onClientAck(clientId, ack);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Match::applyClientEvents() {
+    CSCPP_PROFILE_FUNCTION();
+    auto& registry = m_world->getRegistry();
+    
+    while (ClientEvent* event = m_eventRing.front()) {
+        // A client id is reused after a leave; never keep two players for it
+        for (auto [entity, player] : registry.view<ecs::PlayerComponent>().each()) {
+            if (player.clientId == event->clientId) {
+                m_world->destroyEntity(entity);
+                break;
+            }
+        }
+        if (event->joined) {
+            spawnPlayer(event->clientId);
+        }
+        m_eventRing.pop();
+    }
+}
+
+void Match::spawnPlayer(ClientId clientId) {
+    // Clients take the spawn points in turn, then stand in a grid around them
+    const std::vector<Vec3>& spawns = m_map->spawnPoints;
+    const u32 spawnCount = static_cast<u32>(std::max<size_t>(spawns.size(), 1));
+    const u32 slot = static_cast<u32>(clientId) / spawnCount;
+    const Vec3 spawn = spawns.empty() ? Vec3(0.0f) : spawns[clientId % spawnCount];
+    const Vec3 offset(static_cast<f32>(slot % SPAWN_GRID_SIDE) * SPAWN_SPACING,
+                      static_cast<f32>(slot / SPAWN_GRID_SIDE % SPAWN_GRID_SIDE) * SPAWN_SPACING, 0.0f);
+    
+    Vec3 origin = spawn + offset;
+    if (m_map->collision.isLoaded() &&
+        m_map->collision.pointContents(origin, movement::HULL_STANDING) != movement::CONTENTS_EMPTY) {
+        origin = spawn;
+    }
+    
+    const entt::entity entity = m_world->createEntity();
+    m_world->addComponent<ecs::TransformComponent>(entity).position = origin;
+    m_world->addComponent<ecs::VelocityComponent>(entity);
+    m_world->addComponent<ecs::MovementComponent>(entity);
+    m_world->addComponent<ecs::InputComponent>(entity);
+    m_world->addComponent<ecs::HealthComponent>(entity);
+    addStandingHitboxes(m_world->addComponent<ecs::HitboxComponent>(entity));
+    m_world->addComponent<ecs::PlayerComponent>(entity).clientId = clientId;
+    m_world->addComponent<ecs::NetworkIdComponent>(entity).networkId = m_nextNetworkId++;
+    
+    LOG_DEBUG("[match {}] Spawned client {} at ({:.0f}, {:.0f}, {:.0f})",
+              m_id, clientId, origin.x, origin.y, origin.z);
+}
+
+void Match::applyClientCommands() {
+    CSCPP_PROFILE_FUNCTION();
+    auto& registry = m_world->getRegistry();
+    
+    // Client id -> player entity, so each command is one lookup
+    m_clientEntities.assign(m_clientEntities.size(), entt::null);
+    i64 players = 0;
+    for (auto [entity, player] : registry.view<ecs::PlayerComponent>().each()) {
+        ++players;
+        if (player.clientId == INVALID_CLIENT_ID) continue;
+        if (player.clientId >= m_clientEntities.size()) {
+            m_clientEntities.resize(player.clientId + 1, entt::null);
+        }
+        m_clientEntities[player.clientId] = entity;
+    }
+    m_metrics.players.set(players);
+    
+    // Clients resend recent commands; the input ring drops the copies
+    while (QueuedCmd* queued = m_cmdRing.front()) {
+        if (queued->clientId < m_clientEntities.size()) {
+            const entt::entity entity = m_clientEntities[queued->clientId];
+            if (entity != entt::null) {
+                if (auto* input = registry.try_get<ecs::InputComponent>(entity)) {
+                    input->addCmd(queued->cmd);
+                }
+            }
+        }
+        m_cmdRing.pop();
+    }
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+void Match::processPlayerMovement(Tick tick) {
+    CSCPP_PROFILE_FUNCTION();
+    auto& registry = m_world->getRegistry();
+    
+    // Get all player entities with movement components
+    auto view = registry.view<
+        ecs::TransformComponent,
+        ecs::VelocityComponent,
+        ecs::MovementComponent,
+        ecs::InputComponent,
+        ecs::PlayerComponent
+    >();
+    
+    m_moveBatch.clear();
+    m_moveEntities.clear();
+    
+    // Fill one lane per player (hulls, move vars and trace come from the batch)
+    for (auto [entity, transform, velocity, movement, input, player] : view.each()) {
+        // Skip dead players
+        if (!player.isAlive) continue;
+        
+        // Get the command for this tick
+        UserCmd* cmd = input.getCmd(tick);
+        if (!cmd) continue;
+        
+        movement::PlayerMove& pm = m_moveBatch.addLane();
+        
+        // Set position and velocity
+        pm.origin = transform.position;
+        pm.velocity = velocity.linear;
+        pm.baseVelocity = movement.baseVelocity;
+        
+        // Set input
+        movement::PM_SetupCmd(&pm, *cmd, input.lastButtons);
+        
+        // Set state
+        pm.flags = movement.flags;
+        pm.waterLevel = movement.waterLevel;
+        pm.useHull = movement.useHull;
+        pm.duckTime = movement.duckTime;
+        pm.inDuck = movement.inDuck;
+        pm.fallVelocity = movement.fallVelocity;
+        pm.maxSpeed = movement.maxSpeed;
+        pm.dead = !player.isAlive;
+        
+        m_moveEntities.push_back(entity);
+    }
+    
+    // Run movement simulation for all players. Lanes are independent and
+    // results are written back below in view order, so the outcome does
+    // not depend on how chunks were scheduled.
+    const u32 laneCount = static_cast<u32>(m_moveBatch.size());
+    const u32 threadCount = m_jobs->getWorkerCount() + 1;
+    const u32 grainSize = std::max(MIN_MOVEMENT_CHUNK, (laneCount + threadCount - 1) / threadCount);
+    
+    m_jobs->parallelFor(laneCount, grainSize, [this](u32 begin, u32 end) {
+        m_moveBatch.run(begin, end);
+    });
+    
+    // Update entity state from movement results
+    for (size_t i = 0; i < m_moveEntities.size(); ++i) {
+        const movement::PlayerMove& pm = m_moveBatch.lane(i);
+        auto [transform, velocity, movement, input] = view.get<
+            ecs::TransformComponent,
+            ecs::VelocityComponent,
+            ecs::MovementComponent,
+            ecs::InputComponent
+        >(m_moveEntities[i]);
+        
+        transform.position = pm.origin;
+        velocity.linear = pm.velocity;
+        movement.baseVelocity = pm.baseVelocity;
+        movement.viewAngles = pm.viewAngles;
+        movement.flags = pm.flags;
+        movement.useHull = pm.useHull;
+        movement.duckTime = pm.duckTime;
+        movement.inDuck = pm.inDuck;
+        movement.fallVelocity = pm.fallVelocity;
+        
+        // Update processed tick (frees the command slots up to it)
+        input.lastButtons = pm.buttons;
+        input.markProcessed(tick);
+    }
+}
+
+void Match::simulateWorld() {
+    CSCPP_PROFILE_FUNCTION();
+    // Projectile simulation, game logic, etc.
+}
+
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+void Match::publishSnapshot(Tick tick) {
+    CSCPP_PROFILE_FUNCTION();
+    PublishedFrame* frame = m_frameRing.beginPush();
+    if (!frame) {
+        // The network thread has not caught up; never wait for it
+        m_metrics.droppedFrames.add();
+        return;
+    }
+    
+    auto& registry = m_world->getRegistry();
+    
+    // Capture replicated state once; every client is delta'd against it.
+    // Slots are reused, so the vectors keep their capacity
+    frame->tick = tick;
+    frame->entities.clear();
+    frame->views.clear();
+    
+    auto view = registry.view<ecs::NetworkIdComponent, ecs::TransformComponent>();
+    for (auto [entity, netId, transform] : view.each()) {
+        if (!netId.isReplicated || netId.networkId == INVALID_NETWORK_ID) continue;
+        
+        network::EntityState& state = frame->entities.emplace_back();
+        state.networkId = netId.networkId;
+        state.position = transform.position;
+        
+        if (auto* velocity = registry.try_get<ecs::VelocityComponent>(entity)) {
+            state.velocity = velocity->linear;
+        }
+        if (auto* movement = registry.try_get<ecs::MovementComponent>(entity)) {
+            state.angles = movement->viewAngles;
+            state.flags = static_cast<u16>(movement->flags);
+        }
+        if (auto* health = registry.try_get<ecs::HealthComponent>(entity)) {
+            state.health = static_cast<u8>(std::clamp(health->health, 0.0f, 255.0f));
+        }
+        if (auto* weapon = registry.try_get<ecs::WeaponStateComponent>(entity)) {
+            state.weaponId = weapon->weaponId;
+        }
+        if (auto* animation = registry.try_get<ecs::AnimationComponent>(entity)) {
+            state.animSequence = static_cast<u16>(animation->currentAnim.animationId);
+            state.animFrame = animation->currentAnim.time;
+        }
+    }
+    
+    // The last processed command tick and viewer of each client
+    for (auto [entity, player, input] : registry.view<ecs::PlayerComponent, ecs::InputComponent>().each()) {
+        ClientView& client = frame->views.emplace_back();
+        client.clientId = player.clientId;
+        client.cmdAck = input.lastProcessedTick;
+        
+        auto* netId = registry.try_get<ecs::NetworkIdComponent>(entity);
+        auto* transform = registry.try_get<ecs::TransformComponent>(entity);
+        auto* movement = registry.try_get<ecs::MovementComponent>(entity);
+        if (player.isAlive && netId && transform) {
+            f32 viewHeight = (movement && movement->isDucking())
+                ? movement::hull::DUCKED_VIEW_HEIGHT
+                : movement::hull::STANDING_VIEW_HEIGHT;
+            client.hasViewer = true;
+            client.viewerId = netId->networkId;
+            client.eyePosition = transform->position + Vec3(0.0f, 0.0f, viewHeight);
+        }
+    }
+    
+    m_frameRing.endPush();
+}
+
+bool Match::encodeSnapshots() {
+    CSCPP_PROFILE_FUNCTION();
+    const CountAllocations allocations(m_metrics.networkAllocations);
+    
+    // Messages decoded since the last frame are gone
+    m_packetArena.reset();
+    
+    // Only the newest frame matters; older ones are already stale
+    while (m_frameRing.size() > 1) {
+        m_frameRing.front();
+        m_frameRing.pop();
+    }
+    PublishedFrame* published = m_frameRing.front();
+    if (!published) {
+        return false;
+    }
+    const i64 start = monotonicNanos();
+    
+    network::SnapshotFrame& frame = m_snapshots.beginFrame(published->tick);
+    frame.entities.assign(published->entities.begin(), published->entities.end());
+    m_snapshots.endFrame();
+    m_interest.prepare(m_snapshots.getWorldFrame());
+    
+    for (const ClientView& view : published->views) {
+        auto* client = m_snapshots.findClient(view.clientId);
+        if (!client) continue;
+        
+        client->setClientTickAck(view.cmdAck);
+        if (view.hasViewer) {
+            client->setViewer(view.viewerId, view.eyePosition);
+        } else {
+            // Spectators and dead players see everything
+            client->clearViewer();
+        }
+    }
+    m_frameRing.pop();
+    
+    for (size_t i = 0; i < m_snapshots.getClientCount(); ++i) {
+        network::ClientSnapshotState& client = m_snapshots.getClient(i);
+        if (client.hasViewer()) {
+            m_interest.selectRelevant(client.getViewOrigin(), client.getViewerId(),
+                                      client.getRelevantEntities());
+            m_snapshots.encode(client, client.getRelevantEntities());
+        } else {
+            m_snapshots.encode(client);
+        }
+        m_metrics.snapshotBytes.record(client.getPacket().size());
+    }
+    
+    m_metrics.encodeDuration.record(static_cast<u64>(monotonicNanos() - start));
+    m_metrics.snapshotFrames.add();
+    m_metrics.clients.set(static_cast<i64>(m_snapshots.getClientCount()));
+    return true;
+}
+
+} // namespace cscpp::server
@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @file match.hpp
+ * @brief One authoritative match world
+ *
+ * A match owns its ECS world, movement batch, snapshot state and lag
+ * compensation, and borrows the read-only map data. Its work is split
+ * between two threads that only meet in lock-free SPSC rings:
+ *
+ *  - the match's host thread runs tick(): it spawns and removes the
+ *    players of joined and departed clients, applies the queued commands,
+ *    simulates, and publishes the replicated entity states of the tick;
+ *  - the network thread decodes packets in receivePacket() and turns the
+ *    newest published frame into per-client packets in encodeSnapshots().
+ *
+ * Neither side ever waits for the other. A full command ring drops
+ * commands (clients resend them) and a full frame ring drops that tick's
+ * snapshot, so a slow network thread or client cannot delay a tick.
+ *
+ * Neither side allocates in steady state: buffers are reused and decoded
+ * messages live in a FrameArena reset once per network frame. Both count
+ * the heap allocations they do make in the match metrics.
+ */
+
+#include "core/types.hpp"
+#include "core/jobs/job_system.hpp"
+#include "core/jobs/spsc_ring.hpp"
+#include "core/memory/frame_arena.hpp"
+#include "ecs/ecs.hpp"
+#include "movement/pm_shared/pm_batch.hpp"
+#include "network/protocol/messages.hpp"
+#include "network/snapshot/snapshot.hpp"
+#include "network/interest/interest_manager.hpp"
+#include "gameplay/lag_compensation/lag_compensation.hpp"
+#include "gameplay/spatial/spatial_grid.hpp"
+#include "server/map_cache.hpp"
+#include "server/server_config.hpp"
+#include "server/server_metrics.hpp"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cscpp::server {
+
+class Match {
+public:
+    /**
+     * @brief Set up the world
+     * @param jobs Pool for per-player movement (may have zero workers, then
+     *             everything runs on the caller)
+     */
+    bool initialize(u32 id, const MatchConfig& config, std::shared_ptr<const MapData> map,
+                    f32 tickInterval, JobSystem& jobs);
+    
+    void shutdown();
+    
+    /**
+     * @brief Run one server tick (host thread)
+     * @param shed Behind schedule: skip work that can wait for the next tick
+     */
+    void tick(Tick tick, bool shed);
+    
+    /// Decode a packet from one of this match's clients (network thread)
+    void receivePacket(ClientId clientId, std::span<const u8> data);
+    
+    /**
+     * @brief Encode the newest published frame for every client (network thread)
+     * @return false if no frame was published since the last call
+     *
+     * Afterwards each client's getPacket() in getSnapshots() is ready to send.
+     */
+    bool encodeSnapshots();
+    
+    /// Frames skipped because the network thread was behind (host thread)
+    u64 getDroppedFrames() const { return m_metrics.droppedFrames.get(); }
+    
+    /// Commands dropped because the host thread was behind (network thread)
+    u64 getDroppedCommands() const { return m_metrics.droppedCommands.get(); }
+    
+    /// Tick and snapshot metrics (readable from any thread)
+    const MatchMetrics& getMetrics() const { return m_metrics; }
+    
+    u32 getId() const { return m_id; }
+    const MatchConfig& getConfig() const { return m_config; }
+    const MapData& getMap() const { return *m_map; }
+    ecs::World& getWorld() { return *m_world; }
+    
+    /// Snapshot encoder (network thread only)
+    network::SnapshotEncoder& getSnapshots() { return m_snapshots; }
+    
+private:
+    /// One client command decoded by the network thread
+    struct QueuedCmd {
+        ClientId clientId = INVALID_CLIENT_ID;
+        UserCmd cmd{};
+    };
+    
+    /// A client joining (spawn its player) or leaving (remove it)
+    struct ClientEvent {
+        ClientId clientId = INVALID_CLIENT_ID;
+        bool joined = false;
+    };
+    
+    /// Where a client looks from, captured with the frame
+    struct ClientView {
+        ClientId clientId = INVALID_CLIENT_ID;
+        Tick cmdAck = 0;                ///< Last command tick processed for the client
+        bool hasViewer = false;         ///< Alive player (else sees everything)
+        NetworkId viewerId = INVALID_NETWORK_ID;
+        Vec3 eyePosition{0.0f};
+    };
+    
+    /// Replicated state of one tick, handed from the host to the network thread
+    struct PublishedFrame {
+        Tick tick = 0;
+        std::vector<network::EntityState> entities;
+        std::vector<ClientView> views;
+    };
+    
+    // Host thread
+    void applyClientEvents();
+    void spawnPlayer(ClientId clientId);
+    void applyClientCommands();
+    void processPlayerMovement(Tick tick);
+    void simulateWorld();
+    void publishSnapshot(Tick tick);
+    
+    /// Smallest number of players worth handing to a worker
+    static constexpr u32 MIN_MOVEMENT_CHUNK = 8;
+    
+    /// About a second of redundant commands from a full match
+    static constexpr u32 CMD_RING_SIZE = 4096;
+    static constexpr u32 FRAME_RING_SIZE = 4;
+    static constexpr u32 EVENT_RING_SIZE = 64;
+    
+    /// Players sharing a spawn point stand in a grid this far apart
+    static constexpr f32 SPAWN_SPACING = 40.0f;
+    static constexpr u32 SPAWN_GRID_SIDE = 4;
+    
+    u32 m_id = 0;
+    MatchConfig m_config;
+    std::shared_ptr<const MapData> m_map;
+    JobSystem* m_jobs = nullptr;
+    f32 m_tickInterval = 1.0f / 128.0f;
+    
+    std::unique_ptr<ecs::World> m_world;
+    movement::MoveVars m_moveVars;
+    movement::PlayerMoveBatch m_moveBatch;
+    std::vector<entt::entity> m_moveEntities;
+    gameplay::SpatialGrid m_spatial;
+    gameplay::LagCompensation m_lagCompensation;
+    std::vector<entt::entity> m_clientEntities;     ///< Player entity by client id (host thread scratch)
+    NetworkId m_nextNetworkId = 1;
+    
+    // Network thread -> host thread
+    SpscRing<QueuedCmd, CMD_RING_SIZE> m_cmdRing;
+    SpscRing<ClientEvent, EVENT_RING_SIZE> m_eventRing;
+    
+    // Host thread -> network thread
+    SpscRing<PublishedFrame, FRAME_RING_SIZE> m_frameRing;
+    
+    // Network thread
+    network::SnapshotEncoder m_snapshots;
+    network::InterestManager m_interest;
+    FrameArena m_packetArena;           ///< Decoded messages, reset by encodeSnapshots()
+    
+    // Host and network thread sections, each on its own cache lines
+    MatchMetrics m_metrics;
+};
+
+} // namespace cscpp::server
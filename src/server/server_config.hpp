@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file server_config.hpp
+ * @brief Dedicated server and match configuration
+ */
+
+#include "core/types.hpp"
+#include "core/time/tick_pacer.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cscpp::server {
+
+/**
+ * @brief Settings of one match world
+ */
+struct MatchConfig {
+    std::string mapName = "de_dust2";
+    i32 maxPlayers = 32;
+    std::string serverName = "Counter-Strike C++ Server";
+    std::string rconPassword = "";
+};
+
+/**
+ * @brief Settings of the host process
+ *
+ * All matches of a host share the tick rate and the network port.
+ */
+struct HostConfig {
+    std::vector<MatchConfig> matches{MatchConfig{}};
+    i32 tickRate = 128;
+    u16 port = 27015;
+    i32 hostThreads = -1;               ///< Match threads (-1 = one per core, up to the match count)
+    i32 workerThreads = -1;             ///< Movement worker threads with a single match thread (-1 = auto)
+    bool pinThreads = true;             ///< Pin match threads to cores
+    OverloadPolicy overload = OverloadPolicy::CatchUp;  ///< What to do when ticks run late
+    u16 metricsPort = 0;                ///< TCP port of the Prometheus /metrics endpoint (0 = off)
+    std::string recordPath;             ///< Demo of the first match's traffic (empty = off)
+};
+
+} // namespace cscpp::server
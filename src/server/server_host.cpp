@@ -0,0 +1,539 @@
+/**
+ * @file server_host.cpp
+ * @brief Multi-match host
+ */
+
+#include "server/server_host.hpp"
+#include "core/logging/logger.hpp"
+#include "core/profiling/profiler.hpp"
+#include "network/protocol/serialization.hpp"
+#include "network/protocol/message_schemas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace cscpp::server {
+
+namespace {
+
+/// Exported histogram ranges (powers of two of the recorded unit)
+constexpr u32 DURATION_MIN_EXPONENT = 10;       // ~1 us
+constexpr u32 DURATION_MAX_EXPONENT = 26;       // ~67 ms
+constexpr u32 BYTES_MIN_EXPONENT = 4;
+constexpr u32 BYTES_MAX_EXPONENT = 11;          // Above one datagram
+constexpr u32 DEPTH_MAX_EXPONENT = 12;
+constexpr f64 NANOS_TO_SECONDS = 1e-9;
+
+std::string label(const char* name, u64 value) {
+    return std::string(name) + "=\"" + std::to_string(value) + "\"";
+}
+
+/// Pin the calling thread to one core (best effort)
+bool pinCurrentThread(u32 core) {
+#if defined(_WIN32)
+    if (core >= 64) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+} // anonymous namespace
+
+ServerHost::~ServerHost() {
+    shutdown();
+}
+
+bool ServerHost::initialize(const HostConfig& config) {
+    m_config = config;
+    if (m_config.matches.empty()) {
+        LOG_ERROR("Server host needs at least one match");
+        return false;
+    }
+    
+    const u32 tickRate = static_cast<u32>(std::max(config.tickRate, 1));
+    const f32 tickInterval = 1.0f / static_cast<f32>(tickRate);
+    const u32 matchCount = static_cast<u32>(m_config.matches.size());
+    const u32 cores = std::max(std::thread::hardware_concurrency(), 1u);
+    
+    u32 threadCount = config.hostThreads < 0 ? cores : static_cast<u32>(std::max(config.hostThreads, 1));
+    threadCount = std::min(threadCount, matchCount);
+    
+    // Movement workers only pay off when the matches do not fill the cores
+    u32 workers = 0;
+    if (threadCount == 1) {
+        workers = config.workerThreads < 0
+            ? JobSystem::defaultWorkerCount()
+            : static_cast<u32>(config.workerThreads);
+    }
+    m_jobs.initialize(workers);
+    
+    m_matches.reserve(matchCount);
+    i32 totalPlayers = 0;
+    for (u32 i = 0; i < matchCount; ++i) {
+        const MatchConfig& matchConfig = m_config.matches[i];
+        auto match = std::make_unique<Match>();
+        if (!match->initialize(i, matchConfig, m_maps.acquire(matchConfig.mapName), tickInterval, m_jobs)) {
+            LOG_ERROR("Failed to initialize match {}", i);
+            return false;
+        }
+        m_router.addMatch(match.get(), static_cast<u32>(std::max(matchConfig.maxPlayers, 0)));
+        m_matches.push_back(std::move(match));
+        totalPlayers += std::max(matchConfig.maxPlayers, 0);
+    }
+    
+    network::ServerConfig transportConfig;
+    transportConfig.port = config.port;
+    transportConfig.maxClients = std::max(totalPlayers, 1);
+    transportConfig.tickRate = static_cast<i32>(tickRate);
+    transportConfig.serverName = m_config.matches[0].serverName;
+    if (auto result = m_transport.start(transportConfig, this); !result) {
+        LOG_ERROR("Failed to start network transport: {}", result.error().message);
+        return false;
+    }
+    
+    if (config.metricsPort != 0) {
+        if (auto result = m_metricsEndpoint.open(config.metricsPort); !result) {
+            LOG_ERROR("Failed to open metrics endpoint: {}", result.error().message);
+            return false;
+        }
+    }
+    if (!config.recordPath.empty()) {
+        DemoHeader header;
+        header.tickRate = tickRate;
+        header.mapName = m_config.matches[0].mapName;
+        if (auto result = m_demo.open(config.recordPath, header); !result) {
+            LOG_ERROR("Failed to start recording: {}", result.error().message);
+            return false;
+        }
+    }
+    m_startNanos = monotonicNanos();
+    
+    TickPacerConfig pacerConfig;
+    pacerConfig.tickRate = tickRate;
+    pacerConfig.overload = config.overload;
+    
+    for (u32 t = 0; t < threadCount; ++t) {
+        auto worker = std::make_unique<MatchThread>();
+        worker->index = t;
+        worker->pacer.configure(pacerConfig);
+        m_threads.push_back(std::move(worker));
+    }
+    for (u32 i = 0; i < matchCount; ++i) {
+        m_threads[i % threadCount]->matches.push_back(m_matches[i].get());
+    }
+    
+    LOG_INFO("Server host initialized");
+    LOG_INFO("  Matches: {} on {} maps", matchCount, m_maps.getLoadedCount());
+    LOG_INFO("  Tick rate: {} Hz ({:.4f}s interval)", tickRate, tickInterval);
+    LOG_INFO("  Port: {}", config.port);
+    LOG_INFO("  Match threads: {}{}", threadCount, config.pinThreads ? " (pinned)" : "");
+    LOG_INFO("  Worker threads: {}", m_jobs.getWorkerCount());
+    LOG_INFO("  Overload policy: {}", config.overload == OverloadPolicy::Shed ? "shed" : "catch up");
+    if (m_metricsEndpoint.isOpen()) {
+        LOG_INFO("  Metrics: http://0.0.0.0:{}/metrics", m_metricsEndpoint.getLocalPort());
+    }
+    if (m_demo.isOpen()) {
+        LOG_INFO("  Recording match 0 to: {}", config.recordPath);
+    }
+    
+    return true;
+}
+
+void ServerHost::run(const std::atomic<bool>& shutdown) {
+    LOG_INFO("Starting server tick loop");
+    
+    for (auto& worker : m_threads) {
+        MatchThread* thread = worker.get();
+        thread->thread = std::thread([this, thread, &shutdown] { runMatchThread(*thread, shutdown); });
+    }
+    
+    // This is the network thread: packets are decoded into the matches
+    // through the handler callbacks in poll(), snapshots leave in one flush
+    CSCPP_PROFILE_THREAD("Network");
+    while (!shutdown.load(std::memory_order_relaxed)) {
+        m_transport.waitForPackets(NETWORK_WAIT_NS);
+        {
+            CSCPP_PROFILE_ZONE("Network::poll");
+            m_transport.poll();
+        }
+        sendMatchSnapshots();
+        {
+            CSCPP_PROFILE_ZONE("Network::flush");
+            m_transport.flush();
+        }
+        serveMetrics(monotonicNanos());
+    }
+    
+    for (auto& worker : m_threads) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void ServerHost::runMatchThread(MatchThread& worker, const std::atomic<bool>& shutdown) {
+    const std::string threadName = "Match thread " + std::to_string(worker.index);
+    CSCPP_PROFILE_THREAD(threadName.c_str());
+    
+    if (m_config.pinThreads) {
+        const u32 cores = std::max(std::thread::hardware_concurrency(), 1u);
+        if (!pinCurrentThread(worker.index % cores)) {
+            LOG_DEBUG("Could not pin match thread {}", worker.index);
+        }
+    }
+    
+    worker.pacer.start();
+    const i64 interval = worker.pacer.getIntervalNanos();
+    i64 nextReport = monotonicNanos() + STATS_REPORT_INTERVAL_NS;
+    Tick tick = 0;
+    
+    while (!shutdown.load(std::memory_order_relaxed)) {
+        const TickTiming timing = worker.pacer.waitForTick();
+        tick = timing.tick;
+        
+        for (Match* match : worker.matches) {
+            match->tick(tick, timing.shed);
+        }
+        worker.pacer.endTick();
+        
+        const i64 lateness = timing.getLateness();
+        const i64 work = monotonicNanos() - timing.startNanos;
+        worker.metrics.ticks.add();
+        worker.metrics.startLateness.record(static_cast<u64>(std::max<i64>(lateness, 0)));
+        worker.metrics.tickWork.record(static_cast<u64>(work));
+        if (lateness >= interval) {
+            worker.metrics.lateTicks.add();
+        }
+        if (work > interval) {
+            worker.metrics.overruns.add();
+        }
+        if (timing.shed) {
+            worker.metrics.shedTicks.add();
+        }
+        
+        // One frame per tick of the first match thread
+        if (worker.index == 0) {
+            CSCPP_PROFILE_FRAME();
+        }
+        
+        if (timing.startNanos >= nextReport) {
+            reportTickStats(worker);
+            nextReport = timing.startNanos + STATS_REPORT_INTERVAL_NS;
+        }
+    }
+    
+    LOG_INFO("Match thread {} stopped after {} ticks", worker.index, tick);
+}
+
+void ServerHost::reportTickStats(MatchThread& worker) {
+    const TickPacerStats& stats = worker.pacer.getStats();
+    
+    LOG_DEBUG("[thread {}] Ticks: {} | start jitter p50 {} us, p99 {} us, max {} us | work p99 {} us, max {} us",
+              worker.index, stats.ticks,
+              stats.startJitter.getPercentileNanos(50.0) / 1000,
+              stats.startJitter.getPercentileNanos(99.0) / 1000,
+              stats.startJitter.getMaxNanos() / 1000,
+              stats.tickDuration.getPercentileNanos(99.0) / 1000,
+              stats.tickDuration.getMaxNanos() / 1000);
+    
+    if (stats.lateTicks || stats.overruns || stats.droppedTicks) {
+        LOG_WARN("[thread {}] Tick overload: {} late, {} overran, {} shed, {} dropped (of {})",
+                 worker.index, stats.lateTicks, stats.overruns, stats.shedTicks,
+                 stats.droppedTicks, stats.ticks);
+    }
+    
+    for (const Match* match : worker.matches) {
+        if (match->getDroppedFrames()) {
+            LOG_WARN("[match {}] {} snapshots dropped waiting for the network thread",
+                     match->getId(), match->getDroppedFrames());
+        }
+    }
+    
+    // The pacer only counts dropped ticks; carry them over before the reset
+    worker.metrics.droppedTicks.add(stats.droppedTicks);
+    worker.pacer.resetStats();
+}
+
+// ============================================================================
+// Network
+// ============================================================================
+
+void ServerHost::sendMatchSnapshots() {
+    CSCPP_PROFILE_FUNCTION();
+    for (u32 i = 0; i < static_cast<u32>(m_matches.size()); ++i) {
+        Match& match = *m_matches[i];
+        if (!match.encodeSnapshots()) {
+            continue;
+        }
+        
+        network::SnapshotEncoder& snapshots = match.getSnapshots();
+        const bool record = i == 0 && m_demo.isOpen();
+        for (size_t c = 0; c < snapshots.getClientCount(); ++c) {
+            const network::ClientSnapshotState& client = snapshots.getClient(c);
+            const std::span<const u8> packet = client.getPacket();
+            const ConnectionKey connection = m_router.findConnection(i, client.getClientId());
+            if (packet.empty() || connection == INVALID_CONNECTION) {
+                continue;
+            }
+            m_transport.sendTo(static_cast<ClientId>(connection), packet.data(), packet.size(), false);
+            if (record) {
+                m_demo.writeSnapshot(snapshots.getWorldFrame().tick, client.getClientId(), packet);
+            }
+        }
+    }
+}
+
+void ServerHost::dispatch(ClientId clientId, std::span<const u8> data) {
+    const ConnectionRouter::Route* route = m_router.find(clientId);
+    if (!route) {
+        return;
+    }
+    if (route->matchIndex == 0 && m_demo.isOpen()) {
+        // Tagged with the newest frame encoded so far; the match applies it on a later tick
+        m_demo.writePacket(m_matches[0]->getSnapshots().getWorldFrame().tick, route->clientId, data);
+    }
+    m_router.dispatch(clientId, data);
+}
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+void ServerHost::serveMetrics(i64 now) {
+    if (!m_metricsEndpoint.poll(now)) {
+        return;
+    }
+    if (m_metricsEndpoint.getRequestPath() != "/metrics") {
+        m_metricsEndpoint.respond(404, "text/plain", "Not Found\n");
+        return;
+    }
+    
+    CSCPP_PROFILE_ZONE("ServerHost::serveMetrics");
+    m_metricsText.clear();
+    writeMetrics(m_metricsText);
+    m_metricsEndpoint.respond(200, "text/plain; version=0.0.4", m_metricsText.getText());
+}
+
+void ServerHost::writeMetrics(metrics::PrometheusWriter& out) const {
+    out.family("cscpp_uptime_seconds", "gauge", "Seconds since the host started");
+    out.sample("cscpp_uptime_seconds", {}, static_cast<f64>(monotonicNanos() - m_startNanos) * NANOS_TO_SECONDS);
+    
+    // Match threads
+    std::vector<std::string> threadLabels;
+    for (const auto& worker : m_threads) {
+        threadLabels.push_back(label("thread", worker->index));
+    }
+    
+    auto threadCounter = [&](const char* name, const char* help, metrics::Counter ThreadMetrics::* counter) {
+        out.family(name, "counter", help);
+        for (size_t t = 0; t < m_threads.size(); ++t) {
+            out.sample(name, threadLabels[t], (m_threads[t]->metrics.*counter).get());
+        }
+    };
+    threadCounter("cscpp_thread_ticks_total", "Ticks run by the match thread", &ThreadMetrics::ticks);
+    threadCounter("cscpp_thread_late_ticks_total", "Ticks started a full interval late", &ThreadMetrics::lateTicks);
+    threadCounter("cscpp_thread_overruns_total", "Ticks whose work took longer than one interval", &ThreadMetrics::overruns);
+    threadCounter("cscpp_thread_shed_ticks_total", "Ticks run without publishing snapshots", &ThreadMetrics::shedTicks);
+    threadCounter("cscpp_thread_dropped_ticks_total", "Backlogged ticks discarded", &ThreadMetrics::droppedTicks);
+    
+    out.family("cscpp_thread_tick_work_seconds", "histogram", "Work per tick for all matches of the thread");
+    for (size_t t = 0; t < m_threads.size(); ++t) {
+        out.histogram("cscpp_thread_tick_work_seconds", threadLabels[t], m_threads[t]->metrics.tickWork,
+                      NANOS_TO_SECONDS, DURATION_MIN_EXPONENT, DURATION_MAX_EXPONENT);
+    }
+    out.family("cscpp_thread_start_lateness_seconds", "histogram", "Tick start after its due time");
+    for (size_t t = 0; t < m_threads.size(); ++t) {
+        out.histogram("cscpp_thread_start_lateness_seconds", threadLabels[t], m_threads[t]->metrics.startLateness,
+                      NANOS_TO_SECONDS, DURATION_MIN_EXPONENT, DURATION_MAX_EXPONENT);
+    }
+    
+    // Matches
+    std::vector<std::string> matchLabels;
+    for (const auto& match : m_matches) {
+        matchLabels.push_back(label("match", match->getId()));
+    }
+    
+    auto matchCounter = [&](const char* name, const char* help, metrics::Counter MatchMetrics::* counter) {
+        out.family(name, "counter", help);
+        for (size_t m = 0; m < m_matches.size(); ++m) {
+            out.sample(name, matchLabels[m], (m_matches[m]->getMetrics().*counter).get());
+        }
+    };
+    auto matchGauge = [&](const char* name, const char* help, metrics::Gauge MatchMetrics::* gauge) {
+        out.family(name, "gauge", help);
+        for (size_t m = 0; m < m_matches.size(); ++m) {
+            out.sample(name, matchLabels[m], static_cast<f64>((m_matches[m]->getMetrics().*gauge).get()));
+        }
+    };
+    auto matchHistogram = [&](const char* name, const char* help, metrics::Histogram MatchMetrics::* histogram,
+                              f64 scale, u32 minExponent, u32 maxExponent) {
+        out.family(name, "histogram", help);
+        for (size_t m = 0; m < m_matches.size(); ++m) {
+            out.histogram(name, matchLabels[m], m_matches[m]->getMetrics().*histogram,
+                          scale, minExponent, maxExponent);
+        }
+    };
+    
+    matchCounter("cscpp_match_ticks_total", "Ticks simulated", &MatchMetrics::ticks);
+    matchCounter("cscpp_match_dropped_frames_total", "Snapshots dropped waiting for the network thread",
+                 &MatchMetrics::droppedFrames);
+    matchCounter("cscpp_match_dropped_commands_total", "Commands dropped waiting for the match thread",
+                 &MatchMetrics::droppedCommands);
+    matchCounter("cscpp_match_snapshot_frames_total", "Published frames encoded", &MatchMetrics::snapshotFrames);
+    matchCounter("cscpp_match_tick_allocations_total", "Heap allocations made by match ticks",
+                 &MatchMetrics::tickAllocations);
+    matchCounter("cscpp_match_network_allocations_total", "Heap allocations made decoding and encoding packets",
+                 &MatchMetrics::networkAllocations);
+    matchGauge("cscpp_match_players", "Player entities in the world", &MatchMetrics::players);
+    matchGauge("cscpp_match_clients", "Clients receiving snapshots", &MatchMetrics::clients);
+    
+    matchHistogram("cscpp_match_tick_duration_seconds", "Match::tick() duration", &MatchMetrics::tickDuration,
+                   NANOS_TO_SECONDS, DURATION_MIN_EXPONENT, DURATION_MAX_EXPONENT);
+    
+    out.family("cscpp_match_stage_duration_seconds", "histogram", "Duration of each tick stage");
+    for (size_t m = 0; m < m_matches.size(); ++m) {
+        for (size_t stage = 0; stage < TICK_STAGE_COUNT; ++stage) {
+            const std::string labels = matchLabels[m] + ",stage=\"" + TICK_STAGE_NAMES[stage] + "\"";
+            out.histogram("cscpp_match_stage_duration_seconds", labels,
+                          m_matches[m]->getMetrics().stageDuration[stage],
+                          NANOS_TO_SECONDS, DURATION_MIN_EXPONENT, DURATION_MAX_EXPONENT);
+        }
+    }
+    
+    matchHistogram("cscpp_match_command_queue_depth", "Queued commands at the start of a tick",
+                   &MatchMetrics::commandQueueDepth, 1.0, 0, DEPTH_MAX_EXPONENT);
+    matchHistogram("cscpp_match_snapshot_encode_seconds", "Snapshot encoding per frame, all clients",
+                   &MatchMetrics::encodeDuration, NANOS_TO_SECONDS, DURATION_MIN_EXPONENT, DURATION_MAX_EXPONENT);
+    matchHistogram("cscpp_match_snapshot_bytes", "Snapshot payload per client packet",
+                   &MatchMetrics::snapshotBytes, 1.0, BYTES_MIN_EXPONENT, BYTES_MAX_EXPONENT);
+    
+    // Clients (link statistics live in the transport, owned by this thread)
+    struct ClientSample {
+        std::string labels;
+        ecs::NetworkStatsComponent stats;
+    };
+    std::vector<ClientSample> clients;
+    for (u32 m = 0; m < static_cast<u32>(m_matches.size()); ++m) {
+        network::SnapshotEncoder& snapshots = m_matches[m]->getSnapshots();
+        for (size_t c = 0; c < snapshots.getClientCount(); ++c) {
+            const ClientId clientId = snapshots.getClient(c).getClientId();
+            const ConnectionKey connection = m_router.findConnection(m, clientId);
+            ClientSample sample;
+            if (connection == INVALID_CONNECTION ||
+                !m_transport.getStats(static_cast<ClientId>(connection), sample.stats)) {
+                continue;
+            }
+            sample.labels = matchLabels[m] + "," + label("client", clientId);
+            clients.push_back(std::move(sample));
+        }
+    }
+    
+    out.family("cscpp_client_bytes_received_total", "counter", "Datagram bytes received from the client");
+    for (const ClientSample& client : clients) {
+        out.sample("cscpp_client_bytes_received_total", client.labels, client.stats.bytesReceived);
+    }
+    out.family("cscpp_client_bytes_sent_total", "counter", "Datagram bytes sent to the client");
+    for (const ClientSample& client : clients) {
+        out.sample("cscpp_client_bytes_sent_total", client.labels, client.stats.bytesSent);
+    }
+    out.family("cscpp_client_rtt_seconds", "gauge", "Smoothed round-trip time");
+    for (const ClientSample& client : clients) {
+        out.sample("cscpp_client_rtt_seconds", client.labels, static_cast<f64>(client.stats.ping));
+    }
+    out.family("cscpp_client_packet_loss_ratio", "gauge", "Estimated packet loss (0-1)");
+    for (const ClientSample& client : clients) {
+        out.sample("cscpp_client_packet_loss_ratio", client.labels, static_cast<f64>(client.stats.packetLoss));
+    }
+}
+
+void ServerHost::onClientConnected(ClientId clientId, const network::ClientConnectMsg& msg) {
+    const ConnectionRouter::Route* route = m_router.connect(clientId);
+    if (!route) {
+        m_transport.kickClient(clientId, "All matches are full");
+        return;
+    }
+    
+    Match& match = *m_matches[route->matchIndex];
+    
+    network::ServerAcceptMsg accept{};
+    accept.clientId = route->clientId;
+    accept.serverTick = 0;      // Clients sync their clock from the first snapshot
+    accept.tickRate = static_cast<u32>(std::max(m_config.tickRate, 1));
+    accept.snapshotRate = accept.tickRate;
+    std::strncpy(accept.mapName, match.getConfig().mapName.c_str(), sizeof(accept.mapName) - 1);
+    accept.gameMode = 0;
+    
+    u8 buffer[128];
+    network::BitWriter writer(buffer, sizeof(buffer));
+    network::writeMessage(writer, accept);
+    m_transport.sendTo(clientId, buffer, writer.getBytesWritten(), true);
+    
+    // Let the match start the client's snapshot stream
+    writer = network::BitWriter(buffer, sizeof(buffer));
+    network::writeMessage(writer, msg);
+    dispatch(clientId, std::span<const u8>(buffer, writer.getBytesWritten()));
+    
+    LOG_INFO("Client {} joined match {} as client {}", clientId, route->matchIndex, route->clientId);
+}
+
+void ServerHost::onClientDisconnected(ClientId clientId, [[maybe_unused]] network::DisconnectMsg::Reason reason) {
+    if (!m_router.find(clientId)) {
+        return;
+    }
+    
+    const u8 disconnect = static_cast<u8>(network::MessageId::ClientDisconnect);
+    dispatch(clientId, std::span<const u8>(&disconnect, 1));
+    m_router.disconnect(clientId);
+    
+    LOG_DEBUG("Client {} left (reason {})", clientId, static_cast<u32>(reason));
+}
+
+void ServerHost::onMessage(ClientId clientId, std::span<const u8> data, [[maybe_unused]] bool reliable) {
+    dispatch(clientId, data);
+}
+
+void ServerHost::shutdown() {
+    for (auto& worker : m_threads) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    m_threads.clear();
+    
+    // Says goodbye to the clients while the matches still exist
+    m_transport.stop();
+    m_metricsEndpoint.close();
+    m_demo.close();
+    
+    for (auto& match : m_matches) {
+        match->shutdown();
+    }
+    m_matches.clear();
+    
+    m_jobs.shutdown();
+}
+
+} // namespace cscpp::server
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file server_host.hpp
+ * @brief Runs many independent matches in one process
+ *
+ * Matches are spread round-robin over a fixed set of match threads, one per
+ * core by default and pinned to it. Each thread paces its own ticks and
+ * runs its matches back-to-back every tick. Maps are loaded once through a
+ * shared MapCache. The calling thread of run() is the network thread: it
+ * owns the UDP transport, decodes packets into each match's command ring
+ * (routed by the ConnectionRouter), and encodes and sends every match's
+ * snapshots in one batched flush. Match threads only simulate.
+ *
+ * With a single match thread the matches use a movement worker pool; with
+ * several, each match runs serially on its thread, since the threads
+ * already occupy the cores.
+ *
+ * With a metrics port set, the network thread also answers Prometheus
+ * scrapes of /metrics between polls, reading the matches' and threads'
+ * single-writer metrics without stopping them.
+ *
+ * With a record path set, the network thread also writes the first match's
+ * inbound messages and outbound snapshots to a demo (see demo.hpp).
+ */
+
+#include "core/types.hpp"
+#include "core/jobs/job_system.hpp"
+#include "core/metrics/metrics.hpp"
+#include "core/time/tick_pacer.hpp"
+#include "network/server/server.hpp"
+#include "network/transport/http_endpoint.hpp"
+#include "server/connection_router.hpp"
+#include "server/demo.hpp"
+#include "server/map_cache.hpp"
+#include "server/match.hpp"
+#include "server/server_config.hpp"
+#include "server/server_metrics.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace cscpp::server {
+
+class ServerHost : private network::ServerHandler {
+public:
+    ServerHost() = default;
+    ~ServerHost() override;
+    
+    ServerHost(const ServerHost&) = delete;
+    ServerHost& operator=(const ServerHost&) = delete;
+    
+    bool initialize(const HostConfig& config);
+    
+    /// Run until shutdown becomes true
+    void run(const std::atomic<bool>& shutdown);
+    
+    void shutdown();
+    
+    size_t getMatchCount() const { return m_matches.size(); }
+    Match& getMatch(size_t index) { return *m_matches[index]; }
+    ConnectionRouter& getRouter() { return m_router; }
+    network::Server& getTransport() { return m_transport; }
+    const MapCache& getMapCache() const { return m_maps; }
+    
+private:
+    /// One pinned thread ticking a subset of the matches
+    struct MatchThread {
+        u32 index = 0;
+        std::vector<Match*> matches;
+        TickPacer pacer;
+        ThreadMetrics metrics;
+        std::thread thread;
+    };
+    
+    void runMatchThread(MatchThread& worker, const std::atomic<bool>& shutdown);
+    static void reportTickStats(MatchThread& worker);
+    
+    /// Encode every match's newest frame and queue the packets on the transport
+    void sendMatchSnapshots();
+    
+    /// Route a message to its match, recording it if that match is being recorded
+    void dispatch(ClientId clientId, std::span<const u8> data);
+    
+    /// Answer a pending metrics scrape (network thread)
+    void serveMetrics(i64 now);
+    void writeMetrics(metrics::PrometheusWriter& out) const;
+    
+    // network::ServerHandler (transport client ids are the router's connection keys)
+    void onClientConnected(ClientId clientId, const network::ClientConnectMsg& msg) override;
+    void onClientDisconnected(ClientId clientId, network::DisconnectMsg::Reason reason) override;
+    void onMessage(ClientId clientId, std::span<const u8> data, bool reliable) override;
+    
+    /// How often tick timing is logged
+    static constexpr i64 STATS_REPORT_INTERVAL_NS = 10'000'000'000;
+    
+    /// Longest the network loop blocks waiting for packets, which bounds
+    /// how long a published frame waits to be encoded
+    static constexpr i64 NETWORK_WAIT_NS = 250'000;
+    
+    HostConfig m_config;
+    MapCache m_maps;
+    JobSystem m_jobs;
+    ConnectionRouter m_router;
+    network::Server m_transport;
+    std::vector<std::unique_ptr<Match>> m_matches;
+    std::vector<std::unique_ptr<MatchThread>> m_threads;
+    
+    network::HttpEndpoint m_metricsEndpoint;
+    metrics::PrometheusWriter m_metricsText;    ///< Reused between scrapes
+    DemoWriter m_demo;                          ///< Match 0, written by the network thread
+    i64 m_startNanos = 0;
+};
+
+} // namespace cscpp::server
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file server_metrics.hpp
+ * @brief Always-on per-match and per-thread server metrics
+ *
+ * Each block is written by one thread only (see core/metrics/metrics.hpp)
+ * and read by the network thread when the metrics endpoint is scraped.
+ * Blocks written by different threads start on their own cache line so
+ * recording never bounces a line between cores.
+ */
+
+#include "core/types.hpp"
+#include "core/metrics/metrics.hpp"
+#include "core/time/tick_pacer.hpp"
+
+#include <array>
+
+namespace cscpp::server {
+
+/// Timed stages of Match::tick()
+enum class TickStage : u8 {
+    Commands,
+    Movement,
+    LagCompensation,
+    Simulation,
+    Publish,
+    Count
+};
+
+constexpr size_t TICK_STAGE_COUNT = static_cast<size_t>(TickStage::Count);
+
+/// Label value of each stage in the exported metrics
+constexpr std::array<const char*, TICK_STAGE_COUNT> TICK_STAGE_NAMES = {
+    "commands", "movement", "lag_compensation", "simulation", "publish",
+};
+
+struct MatchMetrics {
+    static constexpr size_t CACHE_LINE = 64;
+    
+    // Host thread
+    alignas(CACHE_LINE) metrics::Counter ticks;
+    metrics::Counter droppedFrames;             ///< Snapshots not published, network thread behind
+    metrics::Gauge players;
+    metrics::Histogram tickDuration;            ///< ns
+    std::array<metrics::Histogram, TICK_STAGE_COUNT> stageDuration;     ///< ns
+    metrics::Histogram commandQueueDepth;       ///< Commands waiting at the start of a tick
+    metrics::Counter tickAllocations;           ///< Heap allocations in tick(), flat in steady state
+    
+    // Network thread
+    alignas(CACHE_LINE) metrics::Counter droppedCommands;   ///< Command ring full, host thread behind
+    metrics::Counter snapshotFrames;
+    metrics::Gauge clients;
+    metrics::Histogram encodeDuration;          ///< ns per frame, all clients
+    metrics::Histogram snapshotBytes;           ///< Per client packet
+    metrics::Counter networkAllocations;        ///< Heap allocations decoding packets and encoding snapshots
+    
+    /// Record a stage that ran from since until now; returns now
+    i64 recordStage(TickStage stage, i64 since) {
+        const i64 now = monotonicNanos();
+        stageDuration[static_cast<size_t>(stage)].record(static_cast<u64>(now - since));
+        return now;
+    }
+};
+
+/// Pacing of one match thread (written by that thread)
+struct ThreadMetrics {
+    static constexpr size_t CACHE_LINE = 64;
+    
+    alignas(CACHE_LINE) metrics::Counter ticks;
+    metrics::Counter lateTicks;                 ///< Started a full interval late
+    metrics::Counter overruns;                  ///< Work took longer than one interval
+    metrics::Counter shedTicks;
+    metrics::Counter droppedTicks;              ///< Backlog discarded (added with each stats report)
+    metrics::Histogram startLateness;           ///< ns after the due time
+    metrics::Histogram tickWork;                ///< ns for all matches of the thread
+};
+
+} // namespace cscpp::server
@@ -0,0 +1,113 @@
+/**
+ * @file test_user_cmd_ring.cpp
+ * @brief Server-side command buffering (UserCmdRing / InputComponent)
+ */
+
+#include "ecs/components/player.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+namespace cscpp::ecs {
+namespace {
+
+constexpr Tick CAPACITY = static_cast<Tick>(UserCmdRing::CAPACITY);
+
+UserCmd makeCmd(Tick tick) {
+    UserCmd cmd{};
+    cmd.tick = tick;
+    cmd.buttons = static_cast<u16>(tick);
+    return cmd;
+}
+
+TEST(UserCmdRingTest, RejectsDuplicateAndProcessedTicks) {
+    UserCmdRing ring;
+    EXPECT_TRUE(ring.insert(makeCmd(10)));
+    EXPECT_FALSE(ring.insert(makeCmd(10)));
+    EXPECT_EQ(ring.size(), 1u);
+
+    ring.markProcessed(10);
+    EXPECT_FALSE(ring.insert(makeCmd(10)));
+    EXPECT_FALSE(ring.insert(makeCmd(9)));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(UserCmdRingTest, BatchCountsOnlyNewCommands) {
+    UserCmdRing ring;
+    const std::vector<UserCmd> first = {makeCmd(1), makeCmd(2), makeCmd(3)};
+    const std::vector<UserCmd> resend = {makeCmd(2), makeCmd(3), makeCmd(4)};
+    EXPECT_EQ(ring.insert(first), 3u);
+    EXPECT_EQ(ring.insert(resend), 1u);
+    ASSERT_NE(ring.find(4), nullptr);
+    EXPECT_EQ(ring.find(4)->buttons, 4u);
+}
+
+TEST(UserCmdRingTest, RejectsTicksMoreThanOneLapAhead) {
+    UserCmdRing ring;
+    ring.insert(makeCmd(100));
+    ring.markProcessed(100);
+
+    EXPECT_TRUE(ring.insert(makeCmd(100 + CAPACITY)));
+    EXPECT_FALSE(ring.insert(makeCmd(100 + CAPACITY + 1)));
+    EXPECT_FALSE(ring.insert(makeCmd(std::numeric_limits<Tick>::max())));
+    EXPECT_EQ(ring.getNewestTick(), 100 + CAPACITY);
+
+    // A far-future tick must not block the commands that follow
+    EXPECT_TRUE(ring.insert(makeCmd(101)));
+    EXPECT_NE(ring.find(101), nullptr);
+}
+
+TEST(UserCmdRingTest, SlotsWrapAcrossManyLaps) {
+    UserCmdRing ring;
+    // Every message resends the last four commands, as clients do
+    for (Tick tick = 1; tick <= 5 * CAPACITY; ++tick) {
+        for (Tick resend = tick > 3 ? tick - 3 : 1; resend <= tick; ++resend) {
+            ring.insert(makeCmd(resend));
+        }
+        const UserCmd* cmd = ring.find(tick);
+        ASSERT_NE(cmd, nullptr) << tick;
+        EXPECT_EQ(cmd->tick, tick);
+        ring.markProcessed(tick);
+        EXPECT_TRUE(ring.empty()) << tick;
+    }
+}
+
+TEST(UserCmdRingTest, TicksNearTheTopOfTheRangeDoNotWrap) {
+    constexpr Tick base = std::numeric_limits<Tick>::max() - CAPACITY;
+    UserCmdRing ring;
+    ring.insert(makeCmd(base));
+    ring.markProcessed(base);
+
+    // base + CAPACITY is the largest Tick; tick + CAPACITY would wrap for all of these
+    EXPECT_TRUE(ring.insert(makeCmd(base + CAPACITY)));
+    EXPECT_TRUE(ring.insert(makeCmd(base + 1)));
+    EXPECT_TRUE(ring.insert(makeCmd(base + CAPACITY / 2)));
+    EXPECT_EQ(ring.size(), 3u);
+    EXPECT_EQ(ring.getNewestTick(), base + CAPACITY);
+}
+
+TEST(UserCmdRingTest, OldTicksBeforeFirstProcessedCommand) {
+    UserCmdRing ring;
+    ASSERT_TRUE(ring.insert(makeCmd(1000)));
+
+    // Within one lap behind the newest: kept; a full lap behind: would overwrite a newer slot
+    EXPECT_TRUE(ring.insert(makeCmd(1000 - CAPACITY + 1)));
+    EXPECT_FALSE(ring.insert(makeCmd(1000 - CAPACITY)));
+    EXPECT_NE(ring.find(1000), nullptr);
+}
+
+TEST(InputComponentTest, TracksLatestAcceptedCommand) {
+    InputComponent input;
+    EXPECT_EQ(input.addCmds(std::vector<UserCmd>{makeCmd(5), makeCmd(6), makeCmd(6)}), 2u);
+    EXPECT_EQ(input.latestCmd.tick, 6u);
+
+    input.markProcessed(6);
+    EXPECT_EQ(input.lastProcessedTick, 6u);
+    EXPECT_FALSE(input.addCmd(makeCmd(6 + CAPACITY + 1)));
+    EXPECT_EQ(input.latestCmd.tick, 6u);
+}
+
+} // anonymous namespace
+} // namespace cscpp::ecs
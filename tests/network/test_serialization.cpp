@@ -0,0 +1,244 @@
+/**
+ * @file test_serialization.cpp
+ * @brief Round trips of the bit-packed codecs and message schemas
+ */
+
+#include "network/protocol/message_schemas.hpp"
+#include "core/memory/frame_arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <limits>
+
+namespace cscpp::network {
+namespace {
+
+/// Write one value with Codec, read it back, and return what the receiver sees
+template<typename Codec, typename T>
+T roundTrip(const T& value, size_t* bitsWritten = nullptr) {
+    std::array<u8, 64> buffer{};
+    BitWriter writer(buffer.data(), buffer.size());
+    Codec::write(writer, value);
+    EXPECT_FALSE(writer.hasOverflowed());
+    if (bitsWritten) {
+        *bitsWritten = writer.getBitPosition();
+    }
+
+    BitReader reader(buffer.data(), writer.getBytesWritten());
+    T decoded{};
+    Codec::read(reader, decoded);
+    EXPECT_FALSE(reader.hasOverflowed());
+    return decoded;
+}
+
+// ============================================================================
+// Varints
+// ============================================================================
+
+TEST(VarUIntTest, RoundTripsGroupBoundaries) {
+    constexpr u32 values[] = {0u, 1u, 127u, 128u, 16383u, 16384u, 2097151u, 2097152u,
+                              std::numeric_limits<u32>::max()};
+    for (u32 value : values) {
+        EXPECT_EQ(roundTrip<codec::VarUInt>(value), value) << value;
+    }
+}
+
+TEST(VarUIntTest, UsesOneGroupPerSevenBits) {
+    size_t bits = 0;
+    roundTrip<codec::VarUInt>(127u, &bits);
+    EXPECT_EQ(bits, 8u);
+    roundTrip<codec::VarUInt>(128u, &bits);
+    EXPECT_EQ(bits, 16u);
+    roundTrip<codec::VarUInt>(std::numeric_limits<u32>::max(), &bits);
+    EXPECT_EQ(bits, 40u);
+}
+
+TEST(VarUIntTest, RejectsEndlessContinuation) {
+    std::array<u8, 8> buffer{};
+    buffer.fill(0xFF);  // Every group says another follows
+
+    BitReader reader(buffer.data(), buffer.size());
+    u32 value = 1;
+    codec::VarUInt::read(reader, value);
+    EXPECT_TRUE(reader.hasOverflowed());
+    EXPECT_EQ(value, 0u);
+}
+
+// ============================================================================
+// Quantized scalars and vectors
+// ============================================================================
+
+TEST(QuantizedTest, MoveAxisKeepsEndpointsAndZeroExact) {
+    for (f32 value : {-1.0f, 0.0f, 1.0f}) {
+        EXPECT_EQ(roundTrip<codec::MoveAxis>(value), value);
+    }
+}
+
+TEST(QuantizedTest, MoveAxisClampsOutOfRange) {
+    EXPECT_EQ(roundTrip<codec::MoveAxis>(4.0f), 1.0f);
+    EXPECT_EQ(roundTrip<codec::MoveAxis>(-4.0f), -1.0f);
+    EXPECT_EQ(roundTrip<codec::MoveAxis>(std::numeric_limits<f32>::quiet_NaN()), -1.0f);
+}
+
+TEST(QuantizedTest, QuantizeMatchesDecode) {
+    for (f32 value = -1.0f; value <= 1.0f; value += 0.013f) {
+        f32 quantized = value;
+        codec::MoveAxis::quantize(quantized);
+        EXPECT_EQ(roundTrip<codec::MoveAxis>(value), quantized) << value;
+        EXPECT_NEAR(quantized, value, 1.0f / 254.0f) << value;
+    }
+}
+
+TEST(QuantizedTest, WorldPositionRoundTripsWithinHalfAStep) {
+    constexpr f32 STEP = 16384.0f / static_cast<f32>((1u << 20) - 2u);
+    const Vec3 positions[] = {
+        Vec3(0.0f), Vec3(-8192.0f), Vec3(8192.0f),
+        Vec3(123.456f, -2048.75f, 64.03125f), Vec3(-1.0f, 0.5f, 7000.1f),
+    };
+    for (const Vec3& position : positions) {
+        Vec3 quantized = position;
+        codec::WorldPosition::quantize(quantized);
+
+        const Vec3 decoded = roundTrip<codec::WorldPosition>(position);
+        EXPECT_EQ(decoded, quantized);
+        for (int axis = 0; axis < 3; ++axis) {
+            EXPECT_NEAR(decoded[axis], position[axis], STEP * 0.5f + 1e-3f);
+        }
+    }
+}
+
+TEST(QuantizedTest, WorldVelocityClampsToRange) {
+    const Vec3 decoded = roundTrip<codec::WorldVelocity>(Vec3(5000.0f, -5000.0f, 0.0f));
+    EXPECT_EQ(decoded, Vec3(2048.0f, -2048.0f, 0.0f));
+}
+
+// ============================================================================
+// Angles
+// ============================================================================
+
+TEST(AngleTest, WrapsIntoZeroTo360) {
+    const Vec3 decoded = roundTrip<codec::Angles16>(Vec3(-90.0f, 450.0f, 0.0f));
+    EXPECT_NEAR(decoded.x, 270.0f, 0.01f);
+    EXPECT_NEAR(decoded.y, 90.0f, 0.01f);
+    EXPECT_EQ(decoded.z, 0.0f);
+}
+
+TEST(AngleTest, QuantizeMatchesDecode) {
+    for (f32 degrees = -360.0f; degrees <= 720.0f; degrees += 7.77f) {
+        Vec3 angles(degrees, degrees * 0.5f, -degrees);
+        Vec3 quantized = angles;
+        codec::Angles16::quantize(quantized);
+        EXPECT_EQ(roundTrip<codec::Angles16>(angles), quantized) << degrees;
+    }
+}
+
+// ============================================================================
+// Messages
+// ============================================================================
+
+UserCmd makeCmd(Tick tick) {
+    UserCmd cmd{};
+    cmd.tick = tick;
+    cmd.viewAngles = Vec3(-12.3f, 181.7f, 0.0f);
+    cmd.forwardMove = 0.7f;
+    cmd.sideMove = -1.0f;
+    cmd.buttons = 0x0123;
+    return cmd;
+}
+
+TEST(MessageTest, UserCmdDecodesToItsQuantizedValues) {
+    const UserCmd cmd = makeCmd(100000);
+    UserCmd expected = cmd;
+    codec::Angles16::quantize(expected.viewAngles);
+    codec::MoveAxis::quantize(expected.forwardMove);
+    codec::MoveAxis::quantize(expected.sideMove);
+
+    const UserCmd decoded = roundTrip<codec::Nested>(cmd);
+    EXPECT_EQ(decoded.tick, expected.tick);
+    EXPECT_EQ(decoded.viewAngles, expected.viewAngles);
+    EXPECT_EQ(decoded.forwardMove, expected.forwardMove);
+    EXPECT_EQ(decoded.sideMove, expected.sideMove);
+    EXPECT_EQ(decoded.buttons, expected.buttons);
+}
+
+TEST(MessageTest, UserCmdMsgDecodesIntoArena) {
+    UserCmdMsg msg;
+    msg.clientTick = 5000;
+    msg.lastReceivedServerTick = 4990;
+    for (Tick tick = 4997; tick <= 5000; ++tick) {
+        msg.cmds.push_back(makeCmd(tick));
+    }
+    msg.cmdCount = static_cast<u8>(msg.cmds.size());
+
+    std::array<u8, MAX_PACKET_SIZE> buffer{};
+    BitWriter writer(buffer.data(), buffer.size());
+    writeMessage(writer, msg);
+    ASSERT_FALSE(writer.hasOverflowed());
+
+    FrameArena arena(4096);
+    UserCmdMsg decoded(&arena);
+    BitReader reader(buffer.data(), writer.getBytesWritten());
+    ASSERT_TRUE(readMessage(reader, decoded));
+
+    EXPECT_EQ(decoded.clientTick, msg.clientTick);
+    EXPECT_EQ(decoded.lastReceivedServerTick, msg.lastReceivedServerTick);
+    EXPECT_EQ(decoded.cmdCount, 4u);
+    ASSERT_EQ(decoded.cmds.size(), 4u);
+    for (size_t i = 0; i < decoded.cmds.size(); ++i) {
+        EXPECT_EQ(decoded.cmds[i].tick, msg.cmds[i].tick);
+        EXPECT_EQ(decoded.cmds[i].buttons, msg.cmds[i].buttons);
+    }
+
+    // The commands live in the arena, not on the heap
+    EXPECT_EQ(decoded.cmds.get_allocator().resource(), &arena);
+    EXPECT_GT(arena.getUsed(), 0u);
+    EXPECT_EQ(arena.getOverflowCount(), 0u);
+}
+
+TEST(MessageTest, RejectsTruncatedMessage) {
+    UserCmdMsg msg;
+    msg.clientTick = 77;
+    msg.lastReceivedServerTick = 70;
+    msg.cmds.push_back(makeCmd(77));
+    msg.cmdCount = 1;
+
+    std::array<u8, MAX_PACKET_SIZE> buffer{};
+    BitWriter writer(buffer.data(), buffer.size());
+    writeMessage(writer, msg);
+
+    UserCmdMsg decoded;
+    BitReader reader(buffer.data(), writer.getBytesWritten() - 2);
+    EXPECT_FALSE(readMessage(reader, decoded));
+}
+
+TEST(MessageTest, RejectsOtherMessageId) {
+    ClientAckMsg ack{};
+    ack.lastReceivedServerTick = 12;
+    ack.snapshotAckBits = 0xF;
+
+    std::array<u8, 32> buffer{};
+    BitWriter writer(buffer.data(), buffer.size());
+    writeMessage(writer, ack);
+
+    UserCmdMsg decoded;
+    BitReader reader(buffer.data(), writer.getBytesWritten());
+    EXPECT_FALSE(readMessage(reader, decoded));
+}
+
+TEST(MessageTest, RejectsArrayLongerThanItsLimit) {
+    using Cmds = codec::Array<codec::Nested, MAX_PENDING_COMMANDS>;
+
+    std::array<u8, 8> buffer{};
+    BitWriter writer(buffer.data(), buffer.size());
+    writer.writeBits(MAX_PENDING_COMMANDS + 1, Cmds::COUNT_BITS);
+
+    std::vector<UserCmd> cmds;
+    BitReader reader(buffer.data(), writer.getBytesWritten());
+    Cmds::read(reader, cmds);
+    EXPECT_TRUE(reader.hasOverflowed());
+    EXPECT_TRUE(cmds.empty());
+}
+
+} // anonymous namespace
+} // namespace cscpp::network
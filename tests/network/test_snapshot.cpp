@@ -0,0 +1,227 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief SnapshotEncoder -> SnapshotDecoder delta round trips
+ */
+
+#include "network/snapshot/snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace cscpp::network {
+namespace {
+
+constexpr ClientId CLIENT = 3;
+
+EntityState makeEntity(NetworkId id, f32 offset) {
+    EntityState state{};
+    state.networkId = id;
+    state.position = Vec3(10.0f * static_cast<f32>(id) + offset, -20.0f, 64.0f + offset);
+    state.velocity = Vec3(250.0f, 0.0f, -offset);
+    state.angles = Vec3(5.0f, 90.0f + offset, 0.0f);
+    state.flags = static_cast<u16>(id);
+    state.health = 100;
+    state.weaponId = 7;
+    state.animSequence = 2;
+    state.animFrame = 0.25f;
+    return state;
+}
+
+void expectSameEntity(const EntityState& actual, const EntityState& expected) {
+    EXPECT_EQ(actual.networkId, expected.networkId);
+    EXPECT_EQ(actual.position, expected.position) << "entity " << expected.networkId;
+    EXPECT_EQ(actual.velocity, expected.velocity) << "entity " << expected.networkId;
+    EXPECT_EQ(actual.angles, expected.angles) << "entity " << expected.networkId;
+    EXPECT_EQ(actual.flags, expected.flags);
+    EXPECT_EQ(actual.health, expected.health);
+    EXPECT_EQ(actual.weaponId, expected.weaponId);
+    EXPECT_EQ(actual.animSequence, expected.animSequence);
+    EXPECT_EQ(actual.animFrame, expected.animFrame);
+}
+
+void expectSameEntities(const std::vector<EntityState>& actual, const std::vector<EntityState>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        expectSameEntity(actual[i], expected[i]);
+    }
+}
+
+/// Encoder with one client, a decoder standing in for that client, and helpers to drive both
+class SnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_client = &m_encoder.addClient(CLIENT);
+    }
+
+    /// Publish a world frame
+    void setWorld(Tick tick, const std::vector<EntityState>& entities) {
+        SnapshotFrame& frame = m_encoder.beginFrame(tick);
+        frame.entities = entities;
+        m_encoder.endFrame();
+    }
+
+    std::span<const u8> encode() {
+        return m_encoder.encode(*m_client);
+    }
+
+    const SnapshotFrame& decode(std::span<const u8> packet) {
+        auto result = m_decoder.decode(packet);
+        EXPECT_TRUE(result.has_value()) << (result ? "" : result.error().message);
+        static const SnapshotFrame empty;
+        return result ? **result : empty;
+    }
+
+    /// Send the decoder's ack back to the server
+    void ack() {
+        m_encoder.onClientAck(CLIENT, m_decoder.buildAck());
+    }
+
+    static MessageId messageId(std::span<const u8> packet) {
+        return static_cast<MessageId>(packet[0]);
+    }
+
+    SnapshotEncoder m_encoder;
+    ClientSnapshotState* m_client = nullptr;
+    SnapshotDecoder m_decoder;
+};
+
+TEST_F(SnapshotTest, FullSnapshotWithoutBaseline) {
+    setWorld(100, {makeEntity(5, 0.0f), makeEntity(1, 0.5f), makeEntity(40, 1.0f)});
+
+    const auto packet = encode();
+    EXPECT_EQ(messageId(packet), MessageId::FullSnapshot);
+    EXPECT_EQ(m_client->getDeferredCount(), 0u);
+
+    const SnapshotFrame& frame = decode(packet);
+    EXPECT_EQ(frame.tick, 100u);
+    expectSameEntities(frame.entities, m_encoder.getWorldFrame().entities);
+}
+
+TEST_F(SnapshotTest, DeltaAgainstAckedBaseline) {
+    std::vector<EntityState> entities = {makeEntity(1, 0.0f), makeEntity(2, 0.0f), makeEntity(3, 0.0f)};
+    setWorld(100, entities);
+    const size_t fullSize = encode().size();
+    decode(m_client->getPacket());
+    ack();
+
+    // Only entity 2 moves
+    entities[1].position.x += 32.0f;
+    setWorld(101, entities);
+    const auto packet = encode();
+    EXPECT_EQ(messageId(packet), MessageId::DeltaSnapshot);
+    EXPECT_LT(packet.size(), fullSize / 2);
+
+    const SnapshotFrame& frame = decode(packet);
+    expectSameEntities(frame.entities, m_encoder.getWorldFrame().entities);
+}
+
+TEST_F(SnapshotTest, UnackedFramesAreNotBaselines) {
+    setWorld(100, {makeEntity(1, 0.0f)});
+    decode(encode());   // Received, but the ack is lost
+
+    setWorld(101, {makeEntity(1, 1.0f)});
+    EXPECT_EQ(messageId(encode()), MessageId::FullSnapshot);
+}
+
+TEST_F(SnapshotTest, BaselineAgeStopsAtHistoryLimit) {
+    const std::vector<EntityState> entities = {makeEntity(1, 0.0f), makeEntity(2, 0.0f)};
+    setWorld(100, entities);
+    decode(encode());
+    ack();
+
+    // The oldest baseline the age field can name
+    const Tick oldest = 100 + SNAPSHOT_HISTORY_SIZE - 1;
+    setWorld(oldest, entities);
+    auto packet = encode();
+    EXPECT_EQ(messageId(packet), MessageId::DeltaSnapshot);
+    expectSameEntities(decode(packet).entities, m_encoder.getWorldFrame().entities);
+
+    // One tick further the baseline is out of reach: full snapshot
+    setWorld(oldest + 1, entities);
+    packet = encode();
+    EXPECT_EQ(messageId(packet), MessageId::FullSnapshot);
+    expectSameEntities(decode(packet).entities, m_encoder.getWorldFrame().entities);
+}
+
+TEST_F(SnapshotTest, DeferredEntitiesKeepBaselineAndArriveLater) {
+    // Small entities: all of them fit in the first packet
+    constexpr NetworkId COUNT = 120;
+    std::vector<EntityState> entities;
+    for (NetworkId id = 1; id <= COUNT; ++id) {
+        EntityState state{};
+        state.networkId = id;
+        state.health = 100;
+        entities.push_back(state);
+    }
+    setWorld(10, entities);
+    decode(encode());
+    ASSERT_EQ(m_client->getDeferredCount(), 0u);
+    ack();
+    const std::vector<EntityState> baseline = m_encoder.getWorldFrame().entities;
+
+    // Every entity changes every field: far more than one packet
+    for (NetworkId id = 1; id <= COUNT; ++id) {
+        entities[id - 1] = makeEntity(id, 3.0f);
+    }
+    setWorld(11, entities);
+    auto packet = encode();
+    const u32 deferred = m_client->getDeferredCount();
+    ASSERT_GT(deferred, 0u);
+    EXPECT_LE(packet.size(), MAX_PACKET_SIZE);
+
+    // Sent entities are current, deferred ones are exactly their baseline
+    const SnapshotFrame& partial = decode(packet);
+    ASSERT_EQ(partial.entities.size(), COUNT);
+    const std::vector<EntityState>& world = m_encoder.getWorldFrame().entities;
+    const size_t sent = COUNT - deferred;
+    for (size_t i = 0; i < COUNT; ++i) {
+        expectSameEntity(partial.entities[i], i < sent ? world[i] : baseline[i]);
+    }
+
+    // The next ticks pick up the rest without the world changing
+    Tick tick = 11;
+    while (m_client->getDeferredCount() > 0) {
+        ASSERT_LT(tick, 20u) << "deferred entities never arrived";
+        ack();
+        setWorld(++tick, entities);
+        decode(encode());
+    }
+    expectSameEntities(m_decoder.getLatestFrame()->entities, m_encoder.getWorldFrame().entities);
+}
+
+TEST_F(SnapshotTest, EntitiesLeavingRelevantSetAreRemoved) {
+    setWorld(50, {makeEntity(1, 0.0f), makeEntity(2, 0.0f), makeEntity(3, 0.0f)});
+    const std::vector<u32> all = {0, 1, 2};
+    decode(m_encoder.encode(*m_client, all));
+    ack();
+
+    const std::vector<u32> culled = {0, 2};
+    setWorld(51, {makeEntity(1, 0.0f), makeEntity(2, 0.0f), makeEntity(3, 0.0f)});
+    const auto packet = m_encoder.encode(*m_client, culled);
+    EXPECT_EQ(messageId(packet), MessageId::DeltaSnapshot);
+
+    const SnapshotFrame& frame = decode(packet);
+    ASSERT_EQ(frame.entities.size(), 2u);
+    EXPECT_EQ(frame.entities[0].networkId, 1u);
+    EXPECT_EQ(frame.entities[1].networkId, 3u);
+
+    // Back in the set: sent in full again
+    ack();
+    setWorld(52, {makeEntity(1, 0.0f), makeEntity(2, 0.0f), makeEntity(3, 0.0f)});
+    expectSameEntities(decode(m_encoder.encode(*m_client, all)).entities, m_encoder.getWorldFrame().entities);
+}
+
+TEST_F(SnapshotTest, RejectsDeltaWithMissingBaseline) {
+    setWorld(100, {makeEntity(1, 0.0f)});
+    encode();   // Lost in transit, but acked by a misbehaving client
+    m_encoder.onClientAck(CLIENT, ClientAckMsg{100, 0});
+
+    setWorld(101, {makeEntity(1, 1.0f)});
+    const auto packet = encode();
+    ASSERT_EQ(messageId(packet), MessageId::DeltaSnapshot);
+    EXPECT_FALSE(m_decoder.decode(packet).has_value());
+}
+
+} // anonymous namespace
+} // namespace cscpp::network
@@ -0,0 +1,219 @@
+/**
+ * @file asset_compiler.cpp
+ * @brief Offline map and texture cooker (BSP + WADs -> .cmap, images -> .ktx2)
+ *
+ * Runs every load-time conversion of a map once: face triangulation and
+ * texture coordinates per texture group, palette conversion, mip chain
+ * generation and BC1/BC3 compression for embedded and WAD textures, hull 0
+ * construction and PVS decompression. The result is written next to the
+ * BSP (or to -out) and picked up by the client and the server map cache as
+ * long as it matches the BSP it was cooked from.
+ *
+ * With -texture the inputs are images, cooked into KTX2 files with full
+ * mip chains the same way; the glTF loader prefers a .ktx2 next to the
+ * image a model references. -uncompressed keeps RGBA8 (maps) or the
+ * image's own channels (textures) instead of BCn.
+ *
+ * WADs and palette.lmp are looked up the same way the client does, so run
+ * it from the directory the client runs from. No GL context is needed.
+ *
+ * Usage:
+ *   asset_compiler [-uncompressed] [-out path] map.bsp [map.bsp ...]
+ *   asset_compiler -texture [-uncompressed] [-out path] image.png [image.png ...]
+ */
+
+#include "core/types.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "assets/bsp/simple_bsp_loader.hpp"
+#include "assets/cooked/cooked_map_view.hpp"
+#include "assets/cooked/cooked_map_writer.hpp"
+#include "assets/texture/block_compression.hpp"
+#include "assets/texture/ktx2.hpp"
+#include "movement/collision/collision_world.hpp"
+#include "network/interest/map_visibility.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace cscpp;
+
+namespace {
+
+f64 millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Cook one map, then load the result back the way the runtime does
+bool cookMap(const std::string& bspPath, const std::string& outPath, bool compressTextures) {
+    const auto start = std::chrono::steady_clock::now();
+    
+    assets::bsp::BSPView bsp;
+    if (auto opened = bsp.open(bspPath); !opened) {
+        std::fprintf(stderr, "%s\n", opened.error().message.c_str());
+        return false;
+    }
+    
+    assets::cooked::CookedMapWriter writer;
+    writer.setSource(bsp);
+    
+    assets::SimpleBSPLoader loader;
+    if (auto cooked = loader.cook(bsp, writer, compressTextures); !cooked) {
+        std::fprintf(stderr, "%s: %s\n", bspPath.c_str(), cooked.error().message.c_str());
+        return false;
+    }
+    
+    movement::CollisionWorld collision;
+    if (auto loaded = collision.load(bsp); !loaded) {
+        std::fprintf(stderr, "%s\n", loaded.error().message.c_str());
+        return false;
+    }
+    collision.cook(writer);
+    
+    // Maps compiled without vis still get their leaf tree
+    network::MapVisibility visibility;
+    if (auto loaded = visibility.load(bsp); loaded) {
+        visibility.cook(writer);
+    } else {
+        std::fprintf(stderr, "warning: %s\n", loaded.error().message.c_str());
+    }
+    
+    if (auto written = writer.write(outPath); !written) {
+        std::fprintf(stderr, "%s\n", written.error().message.c_str());
+        return false;
+    }
+    const f64 cookMs = millisecondsSince(start);
+    
+    // Round trip: everything the runtime maps must validate and load
+    const auto verifyStart = std::chrono::steady_clock::now();
+    assets::cooked::CookedMapView view;
+    if (auto opened = view.open(outPath); !opened || !view.isCookedFrom(bsp)) {
+        std::fprintf(stderr, "Cooked map does not read back: %s\n", outPath.c_str());
+        return false;
+    }
+    movement::CollisionWorld cookedCollision;
+    if (auto loaded = cookedCollision.load(view); !loaded ||
+        cookedCollision.getNodeCount() != collision.getNodeCount() ||
+        cookedCollision.getClipNodeCount() != collision.getClipNodeCount()) {
+        std::fprintf(stderr, "Cooked collision does not read back: %s\n", outPath.c_str());
+        return false;
+    }
+    network::MapVisibility cookedVisibility;
+    if (visibility.isLoaded() && !cookedVisibility.load(view)) {
+        std::fprintf(stderr, "Cooked visibility does not read back: %s\n", outPath.c_str());
+        return false;
+    }
+    const f64 verifyMs = millisecondsSince(verifyStart);
+    
+    std::printf("%s -> %s\n", bspPath.c_str(), outPath.c_str());
+    std::printf("  %llu KB (BSP %llu KB): vertices %llu KB, textures %llu KB, PVS %llu KB\n",
+                static_cast<unsigned long long>(writer.getFileSize() / 1024),
+                static_cast<unsigned long long>(bsp.getFileSize() / 1024),
+                static_cast<unsigned long long>(writer.getSectionSize(assets::cooked::SECTION_VERTICES) / 1024),
+                static_cast<unsigned long long>(writer.getSectionSize(assets::cooked::SECTION_TEXTURE_DATA) / 1024),
+                static_cast<unsigned long long>(writer.getSectionSize(assets::cooked::SECTION_PVS) / 1024));
+    std::printf("  cooked in %.1f ms, collision + PVS read back in %.2f ms\n", cookMs, verifyMs);
+    return true;
+}
+
+/// Cook one image into a KTX2 file: full mip chain, BC3 if any texel is translucent, BC1 otherwise
+bool cookTexture(const std::string& imagePath, const std::string& outPath, bool compress) {
+    const auto start = std::chrono::steady_clock::now();
+    
+    auto image = assets::loadImageFile(imagePath);
+    if (!image) {
+        std::fprintf(stderr, "%s\n", image.error().message.c_str());
+        return false;
+    }
+    assets::extendMipChain(*image);
+    const u64 sourceSize = image->pixels.size();
+    
+    if (compress) {
+        bool translucent = false;
+        if (image->format == renderer::TextureFormat::RGBA8) {
+            const size_t levelSize = static_cast<size_t>(image->width) * image->height * 4;
+            for (size_t i = 3; i < levelSize; i += 4) {
+                translucent |= image->pixels[i] != 255;
+            }
+        }
+        auto compressed = assets::compressImage(*image, translucent ? renderer::TextureFormat::BC3
+                                                                    : renderer::TextureFormat::BC1);
+        if (!compressed) {
+            std::fprintf(stderr, "%s\n", compressed.error().message.c_str());
+            return false;
+        }
+        image = std::move(*compressed);
+    }
+    
+    if (auto written = assets::writeKTX2File(outPath, *image); !written) {
+        std::fprintf(stderr, "%s\n", written.error().message.c_str());
+        return false;
+    }
+    
+    // Round trip: the runtime must read back exactly what was written
+    auto loaded = assets::loadKTX2File(outPath);
+    if (!loaded || loaded->format != image->format || loaded->pixels != image->pixels) {
+        std::fprintf(stderr, "KTX2 file does not read back: %s\n", outPath.c_str());
+        return false;
+    }
+    
+    std::printf("%s -> %s\n", imagePath.c_str(), outPath.c_str());
+    std::printf("  %ux%u, %u levels, format %u: %llu KB (uncompressed %llu KB), cooked in %.1f ms\n",
+                image->width, image->height, image->mipCount, static_cast<u32>(image->format),
+                static_cast<unsigned long long>(image->pixels.size() / 1024),
+                static_cast<unsigned long long>(sourceSize / 1024), millisecondsSince(start));
+    return true;
+}
+
+std::string ktx2PathFor(const std::string& imagePath) {
+    return std::filesystem::path(imagePath).replace_extension(assets::KTX2_EXTENSION).string();
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::string outPath;
+    std::vector<std::string> inputs;
+    bool textures = false;
+    bool compress = true;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        
+        if (arg == "-out" && hasValue) {
+            outPath = argv[++i];
+        } else if (arg == "-texture") {
+            textures = true;
+        } else if (arg == "-uncompressed") {
+            compress = false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    if (inputs.empty()) {
+        std::fprintf(stderr, "Usage: asset_compiler [-uncompressed] [-out path] map.bsp [map.bsp ...]\n"
+                             "       asset_compiler -texture [-uncompressed] [-out path] image [image ...]\n");
+        return 2;
+    }
+    if (!outPath.empty() && inputs.size() > 1) {
+        std::fprintf(stderr, "-out needs a single input\n");
+        return 2;
+    }
+    
+    bool ok = true;
+    for (const auto& input : inputs) {
+        if (textures) {
+            ok &= cookTexture(input, outPath.empty() ? ktx2PathFor(input) : outPath, compress);
+        } else {
+            ok &= cookMap(input, outPath.empty() ? assets::cooked::cookedPathFor(input) : outPath, compress);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file synthetic_player.hpp
+ * @brief Seeded input generator shared by the benchmark and load tools
+ *
+ * Holds a movement for a quarter to a few seconds, then picks another:
+ * running, strafing, backpedalling or standing, while turning, with
+ * occasional jumps and ducks. The same seed always yields the same
+ * commands, so runs are comparable across builds.
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "movement/pm_shared/pm_shared.hpp"
+
+#include <cmath>
+
+namespace cscpp::tools {
+
+/// Deterministic per-player input: runs, strafes, turns, jumps and ducks
+class SyntheticPlayer {
+public:
+    explicit SyntheticPlayer(u32 seed)
+        : m_state(seed * 2654435761u + 1u) {
+        m_yaw = static_cast<f32>(next() % 360);
+    }
+
+    UserCmd nextCmd(Tick tick, f32 tickInterval) {
+        if (m_holdTicks == 0) {
+            static constexpr f32 FORWARD[] = {1.0f, 1.0f, 0.5f, 0.0f, -1.0f};
+            static constexpr f32 SIDE[] = {0.0f, 0.0f, 1.0f, -1.0f};
+            m_forward = FORWARD[next() % 5];
+            m_side = SIDE[next() % 4];
+            m_turnRate = static_cast<f32>(static_cast<i32>(next() % 181) - 90);
+            m_duck = next() % 8 == 0;
+            m_holdTicks = static_cast<u32>((0.25f + static_cast<f32>(next() % 100) * 0.015f) / tickInterval);
+        }
+        --m_holdTicks;
+
+        m_yaw = std::fmod(m_yaw + m_turnRate * tickInterval + 360.0f, 360.0f);
+
+        UserCmd cmd{};
+        cmd.tick = tick;
+        cmd.viewAngles = Vec3(0.0f, m_yaw, 0.0f);
+        cmd.forwardMove = m_forward;
+        cmd.sideMove = m_side;
+        cmd.buttons = static_cast<u16>((m_duck ? movement::IN_DUCK : 0) |
+                                       (next() % 64 == 0 ? movement::IN_JUMP : 0));
+        return cmd;
+    }
+
+private:
+    u32 next() {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    u32 m_state;
+    u32 m_holdTicks = 0;
+    f32 m_yaw = 0.0f;
+    f32 m_turnRate = 0.0f;
+    f32 m_forward = 0.0f;
+    f32 m_side = 0.0f;
+    bool m_duck = false;
+};
+
+} // namespace cscpp::tools
@@ -0,0 +1,482 @@
+/**
+ * @file movement_bench.cpp
+ * @brief Headless player movement benchmark and determinism check
+ *
+ * Loads a BSP through the collision engine, spawns N players on the map's
+ * spawn points and runs a UserCmd stream through PM_PlayerMove for a number
+ * of ticks, the same way a match does. Reports ns per player-tick, traces
+ * per move and a hash of the final player state.
+ *
+ * The command stream is synthetic (seeded, so identical between runs) or
+ * read from a file written earlier with -record. Two builds fed the same
+ * stream must print the same hash; comparing hashes across builds and
+ * CSCPP_GOLDSCR_PARITY settings shows whether a change moved any player.
+ *
+ * Usage:
+ *   movement_bench [-map path] [-players N] [-ticks N] [-tickrate N] [-seed N]
+ *                  [-mode batch|scalar|both] [-record file] [-replay file]
+ *                  [-expect hash]
+ */
+
+#include "core/types.hpp"
+#include "core/math/math.hpp"
+#include "assets/bsp/bsp_entities.hpp"
+#include "assets/bsp/bsp_view.hpp"
+#include "movement/collision/collision_world.hpp"
+#include "movement/pm_shared/pm_batch.hpp"
+#include "movement/pm_shared/pm_shared.hpp"
+#include "common/synthetic_player.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace cscpp;
+
+namespace {
+
+constexpr u32 STREAM_MAGIC = 0x564D5343;   // "CSMV"
+constexpr u32 STREAM_VERSION = 1;
+
+/// Players are placed in a square grid this far apart around each spawn
+constexpr f32 SPAWN_SPACING = 40.0f;
+
+// ============================================================================
+// Spawn Points
+// ============================================================================
+
+/// Maps without spawn entities: sample free space inside the world bounds
+std::vector<Vec3> sampleSpawnPoints(const movement::CollisionWorld& world, u32 count) {
+    std::vector<Vec3> spawns;
+    const movement::CollisionModel& model = world.getModel(0);
+    u32 state = 0x9E3779B9u;
+    for (u32 attempt = 0; attempt < count * 64 && spawns.size() < count; ++attempt) {
+        Vec3 point(0.0f);
+        for (i32 axis = 0; axis < 3; ++axis) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            const f32 t = static_cast<f32>(state & 0xFFFFFF) / static_cast<f32>(0xFFFFFF);
+            point[axis] = model.mins[axis] + (model.maxs[axis] - model.mins[axis]) * t;
+        }
+        if (world.pointContents(point, movement::HULL_STANDING) == movement::CONTENTS_EMPTY) {
+            spawns.push_back(point);
+        }
+    }
+    return spawns;
+}
+
+// ============================================================================
+// Command Streams
+// ============================================================================
+
+/**
+ * @brief Commands of every player for every tick, plus where they start
+ *
+ * File layout (little-endian): magic, version, players, ticks, tick rate,
+ * spawn origin per player, then per tick and player the view angles,
+ * forward/side/up move and buttons.
+ */
+struct CommandStream {
+    u32 players = 0;
+    u32 ticks = 0;
+    u32 tickRate = 128;
+    std::vector<Vec3> spawns;
+    std::vector<UserCmd> cmds;          ///< [tick * players + player]
+    
+    const UserCmd& get(u32 tick, u32 player) const { return cmds[static_cast<size_t>(tick) * players + player]; }
+};
+
+template<typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool saveStream(const CommandStream& stream, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    writeValue(file, STREAM_MAGIC);
+    writeValue(file, STREAM_VERSION);
+    writeValue(file, stream.players);
+    writeValue(file, stream.ticks);
+    writeValue(file, stream.tickRate);
+    for (const Vec3& spawn : stream.spawns) {
+        writeValue(file, spawn.x);
+        writeValue(file, spawn.y);
+        writeValue(file, spawn.z);
+    }
+    for (const UserCmd& cmd : stream.cmds) {
+        writeValue(file, cmd.viewAngles.x);
+        writeValue(file, cmd.viewAngles.y);
+        writeValue(file, cmd.viewAngles.z);
+        writeValue(file, cmd.forwardMove);
+        writeValue(file, cmd.sideMove);
+        writeValue(file, cmd.upMove);
+        writeValue(file, cmd.buttons);
+    }
+    return static_cast<bool>(file);
+}
+
+bool loadStream(CommandStream& stream, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    u32 magic = 0;
+    u32 version = 0;
+    if (!readValue(file, magic) || !readValue(file, version) ||
+        magic != STREAM_MAGIC || version != STREAM_VERSION) {
+        return false;
+    }
+    if (!readValue(file, stream.players) || !readValue(file, stream.ticks) || !readValue(file, stream.tickRate) ||
+        stream.players == 0 || stream.tickRate == 0) {
+        return false;
+    }
+    
+    stream.spawns.resize(stream.players);
+    for (Vec3& spawn : stream.spawns) {
+        if (!readValue(file, spawn.x) || !readValue(file, spawn.y) || !readValue(file, spawn.z)) {
+            return false;
+        }
+    }
+    
+    stream.cmds.resize(static_cast<size_t>(stream.players) * stream.ticks);
+    for (size_t i = 0; i < stream.cmds.size(); ++i) {
+        UserCmd& cmd = stream.cmds[i];
+        cmd.tick = static_cast<Tick>(i / stream.players + 1);
+        if (!readValue(file, cmd.viewAngles.x) || !readValue(file, cmd.viewAngles.y) ||
+            !readValue(file, cmd.viewAngles.z) || !readValue(file, cmd.forwardMove) ||
+            !readValue(file, cmd.sideMove) || !readValue(file, cmd.upMove) || !readValue(file, cmd.buttons)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CommandStream makeSyntheticStream(const movement::CollisionWorld& world, const std::vector<Vec3>& spawnPoints,
+                                  u32 players, u32 ticks, u32 tickRate, u32 seed) {
+    CommandStream stream;
+    stream.players = players;
+    stream.ticks = ticks;
+    stream.tickRate = tickRate;
+    
+    // Fill each spawn with a small grid of players before moving on
+    const u32 perSpawn = static_cast<u32>(std::ceil(static_cast<f32>(players) /
+                                                    static_cast<f32>(spawnPoints.size())));
+    const u32 side = static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(perSpawn))));
+    stream.spawns.reserve(players);
+    for (u32 i = 0; i < players; ++i) {
+        const u32 slot = i / static_cast<u32>(spawnPoints.size());
+        const Vec3 offset(static_cast<f32>(slot % side) * SPAWN_SPACING,
+                          static_cast<f32>(slot / side) * SPAWN_SPACING, 0.0f);
+        const Vec3 spawn = spawnPoints[i % spawnPoints.size()];
+        const bool free = world.pointContents(spawn + offset, movement::HULL_STANDING) == movement::CONTENTS_EMPTY;
+        stream.spawns.push_back(free ? spawn + offset : spawn);
+    }
+    
+    std::vector<tools::SyntheticPlayer> bots;
+    bots.reserve(players);
+    for (u32 i = 0; i < players; ++i) {
+        bots.emplace_back(seed ^ (i * 0x85EBCA6Bu));
+    }
+    
+    const f32 tickInterval = 1.0f / static_cast<f32>(tickRate);
+    stream.cmds.reserve(static_cast<size_t>(players) * ticks);
+    for (u32 tick = 0; tick < ticks; ++tick) {
+        for (u32 i = 0; i < players; ++i) {
+            stream.cmds.push_back(bots[i].nextCmd(static_cast<Tick>(tick + 1), tickInterval));
+        }
+    }
+    return stream;
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+/// What a match carries per player from one tick to the next
+struct PlayerState {
+    Vec3 origin{0.0f};
+    Vec3 velocity{0.0f};
+    Vec3 baseVelocity{0.0f};
+    i32 flags = 0;
+    i32 waterLevel = 0;
+    i32 useHull = 0;
+    f32 duckTime = 0.0f;
+    bool inDuck = false;
+    f32 fallVelocity = 0.0f;
+    u16 lastButtons = 0;
+};
+
+/// Trace user data: the world plus a call counter
+struct TraceContext {
+    const movement::CollisionWorld* world = nullptr;
+    u64 traces = 0;
+};
+
+movement::TraceResult countingTrace(const movement::PlayerMove* pm, Vec3 start, Vec3 end, i32 hullType) {
+    auto* context = static_cast<TraceContext*>(pm->traceUserData);
+    ++context->traces;
+    return context->world->traceHull(start, end, hullType);
+}
+
+void loadLane(movement::PlayerMove& pm, const PlayerState& state, const UserCmd& cmd) {
+    pm.origin = state.origin;
+    pm.velocity = state.velocity;
+    pm.baseVelocity = state.baseVelocity;
+    movement::PM_SetupCmd(&pm, cmd, state.lastButtons);
+    pm.flags = state.flags;
+    pm.waterLevel = state.waterLevel;
+    pm.useHull = state.useHull;
+    pm.duckTime = state.duckTime;
+    pm.inDuck = state.inDuck;
+    pm.fallVelocity = state.fallVelocity;
+    pm.maxSpeed = 250.0f;
+}
+
+void storeLane(const movement::PlayerMove& pm, PlayerState& state) {
+    state.origin = pm.origin;
+    state.velocity = pm.velocity;
+    state.baseVelocity = pm.baseVelocity;
+    state.flags = pm.flags;
+    state.waterLevel = pm.waterLevel;
+    state.useHull = pm.useHull;
+    state.duckTime = pm.duckTime;
+    state.inDuck = pm.inDuck;
+    state.fallVelocity = pm.fallVelocity;
+    state.lastButtons = pm.buttons;
+}
+
+/// FNV-1a over the exact bits of every player's state
+u64 hashStates(const std::vector<PlayerState>& states) {
+    u64 hash = 0xCBF29CE484222325ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const u8*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    };
+    for (const PlayerState& state : states) {
+        mix(&state.origin, sizeof(state.origin));
+        mix(&state.velocity, sizeof(state.velocity));
+        mix(&state.baseVelocity, sizeof(state.baseVelocity));
+        mix(&state.flags, sizeof(state.flags));
+        mix(&state.waterLevel, sizeof(state.waterLevel));
+        mix(&state.useHull, sizeof(state.useHull));
+        mix(&state.duckTime, sizeof(state.duckTime));
+        mix(&state.inDuck, sizeof(state.inDuck));
+        mix(&state.fallVelocity, sizeof(state.fallVelocity));
+        mix(&state.lastButtons, sizeof(state.lastButtons));
+    }
+    return hash;
+}
+
+struct BenchResult {
+    u64 hash = 0;
+    u64 traces = 0;
+    f64 totalNanos = 0.0;
+    f64 worstTickNanos = 0.0;
+    u32 onGround = 0;
+};
+
+BenchResult runBench(const CommandStream& stream, const movement::CollisionWorld& world, bool batched) {
+    movement::MoveVars moveVars;
+    moveVars.gravity = 800.0f;
+    moveVars.stopSpeed = 100.0f;
+    moveVars.maxSpeed = 320.0f;
+    moveVars.accelerate = 10.0f;
+    moveVars.airAccelerate = 10.0f;
+    moveVars.friction = 4.0f;
+    moveVars.stepSize = 18.0f;
+    moveVars.maxVelocity = 2000.0f;
+    
+    const f32 tickInterval = 1.0f / static_cast<f32>(stream.tickRate);
+    TraceContext context{&world, 0};
+    
+    movement::PlayerMoveBatch batch;
+    batch.setMoveVars(&moveVars);
+    batch.setFrameTime(tickInterval);
+    batch.setTrace(&countingTrace, &context);
+    batch.reserve(stream.players);
+    
+    movement::PlayerMove scalarTemplate;
+    scalarTemplate.initHulls();
+    scalarTemplate.moveVars = &moveVars;
+    scalarTemplate.frameTime = tickInterval;
+    scalarTemplate.traceFunc = &countingTrace;
+    scalarTemplate.traceUserData = &context;
+    movement::PlayerMove scalar;
+    
+    std::vector<PlayerState> states(stream.players);
+    for (u32 i = 0; i < stream.players; ++i) {
+        states[i].origin = stream.spawns[i];
+    }
+    
+    BenchResult result;
+    for (u32 tick = 0; tick < stream.ticks; ++tick) {
+        const auto start = std::chrono::steady_clock::now();
+        
+        if (batched) {
+            batch.clear();
+            for (u32 i = 0; i < stream.players; ++i) {
+                loadLane(batch.addLane(), states[i], stream.get(tick, i));
+            }
+            batch.run();
+            for (u32 i = 0; i < stream.players; ++i) {
+                storeLane(batch.lane(i), states[i]);
+            }
+        } else {
+            for (u32 i = 0; i < stream.players; ++i) {
+                scalar = scalarTemplate;
+                loadLane(scalar, states[i], stream.get(tick, i));
+                movement::PM_PlayerMove(&scalar);
+                storeLane(scalar, states[i]);
+            }
+        }
+        
+        const f64 nanos = std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+        result.totalNanos += nanos;
+        result.worstTickNanos = std::max(result.worstTickNanos, nanos);
+    }
+    
+    result.hash = hashStates(states);
+    result.traces = context.traces;
+    for (const PlayerState& state : states) {
+        result.onGround += (state.flags & movement::FL_ONGROUND) ? 1 : 0;
+    }
+    return result;
+}
+
+void printResult(const char* mode, const CommandStream& stream, const BenchResult& result) {
+    const f64 moves = static_cast<f64>(stream.players) * stream.ticks;
+    std::printf("%-6s  %8.1f ns/player-tick  %6.2f traces/move  worst tick %8.3f ms  "
+                "on ground %u/%u  hash %016" PRIx64 "\n",
+                mode, result.totalNanos / moves, static_cast<f64>(result.traces) / moves,
+                result.worstTickNanos / 1e6, result.onGround, stream.players, result.hash);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::string mapPath = "assets/maps/de_dust2.bsp";
+    std::string mode = "batch";
+    std::string recordPath;
+    std::string replayPath;
+    std::string expected;
+    u32 players = 2048;
+    u32 ticks = 1280;
+    u32 tickRate = 128;
+    u32 seed = 1;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        
+        if (arg == "-map" && hasValue) {
+            mapPath = argv[++i];
+        } else if (arg == "-players" && hasValue) {
+            players = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "-ticks" && hasValue) {
+            ticks = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "-tickrate" && hasValue) {
+            tickRate = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (arg == "-seed" && hasValue) {
+            seed = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "-mode" && hasValue) {
+            mode = argv[++i];
+        } else if (arg == "-record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "-replay" && hasValue) {
+            replayPath = argv[++i];
+        } else if (arg == "-expect" && hasValue) {
+            expected = argv[++i];
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    
+    if (mode != "batch" && mode != "scalar" && mode != "both") {
+        std::fprintf(stderr, "-mode must be batch, scalar or both\n");
+        return 2;
+    }
+    
+    // One mapping serves both the hulls and the spawn entities
+    assets::bsp::BSPView bsp;
+    if (auto opened = bsp.open(mapPath); !opened) {
+        std::fprintf(stderr, "%s\n", opened.error().message.c_str());
+        return 1;
+    }
+    movement::CollisionWorld world;
+    if (auto loaded = world.load(bsp); !loaded) {
+        std::fprintf(stderr, "%s\n", loaded.error().message.c_str());
+        return 1;
+    }
+    
+    CommandStream stream;
+    if (!replayPath.empty()) {
+        if (!loadStream(stream, replayPath)) {
+            std::fprintf(stderr, "Failed to read command stream: %s\n", replayPath.c_str());
+            return 1;
+        }
+    } else {
+        std::vector<Vec3> spawns = assets::bsp::readSpawnPoints(bsp);
+        if (spawns.empty()) {
+            spawns = sampleSpawnPoints(world, 64);
+        }
+        if (spawns.empty()) {
+            std::fprintf(stderr, "No spawn points in %s\n", mapPath.c_str());
+            return 1;
+        }
+        stream = makeSyntheticStream(world, spawns, players, ticks, tickRate, seed);
+    }
+    
+    if (!recordPath.empty() && !saveStream(stream, recordPath)) {
+        std::fprintf(stderr, "Failed to write command stream: %s\n", recordPath.c_str());
+        return 1;
+    }
+
+#ifdef CSCPP_GOLDSRC_PARITY
+    const char* parity = "on";
+#else
+    const char* parity = "off";
+#endif
+    std::printf("%s: %u players x %u ticks at %u Hz (%s), GoldSrc parity %s\n",
+                mapPath.c_str(), stream.players, stream.ticks, stream.tickRate,
+                replayPath.empty() ? "synthetic" : replayPath.c_str(), parity);
+    
+    u64 hash = 0;
+    bool consistent = true;
+    if (mode == "batch" || mode == "both") {
+        const BenchResult result = runBench(stream, world, true);
+        printResult("batch", stream, result);
+        hash = result.hash;
+    }
+    if (mode == "scalar" || mode == "both") {
+        const BenchResult result = runBench(stream, world, false);
+        printResult("scalar", stream, result);
+        consistent = mode != "both" || result.hash == hash;
+        hash = result.hash;
+    }
+    
+    if (!consistent) {
+        std::fprintf(stderr, "Batch and scalar movement diverged\n");
+        return 1;
+    }
+    if (!expected.empty() && std::strtoull(expected.c_str(), nullptr, 16) != hash) {
+        std::fprintf(stderr, "Hash mismatch: expected %s\n", expected.c_str());
+        return 1;
+    }
+    return 0;
+}
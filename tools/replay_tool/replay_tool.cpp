@@ -0,0 +1,669 @@
+/**
+ * @file replay_tool.cpp
+ * @brief Server load generator and demo replay
+ *
+ * bots: drives N synthetic clients over the real UDP transport, against a
+ * server host started in this process (or a running one with -connect).
+ * Each bot completes the handshake, sends a UserCmdMsg every tick carrying
+ * its newest commands (seeded input, identical between runs), and acks
+ * every snapshot it decodes. Reports the match's tick time percentiles
+ * (in-process only) and bytes/s per client in both directions. With
+ * -record the host writes the match's traffic to a demo.
+ *
+ * replay: feeds a demo's recorded client messages into a headless match
+ * and runs its ticks back-to-back, as fast as the machine allows. Reports
+ * tick time percentiles, speed against realtime, snapshot bytes/s per
+ * client as recorded and as replayed, and a hash of every replayed
+ * snapshot packet. The simulation is deterministic, so a build that
+ * prints a different hash for the same demo changed what clients receive.
+ *
+ * Both modes exit with 1 when a limit is exceeded, for use as a regression
+ * gate on netcode and movement changes.
+ *
+ * Usage:
+ *   replay_tool bots [-bots N] [-seconds N] [-tickrate N] [-map name] [-seed N]
+ *                    [-port N] [-connect a.b.c.d:port] [-record file] [limits]
+ *   replay_tool replay file [-workers N] [-expect hash] [limits]
+ *
+ *   limits: [-max-tick-p99-us N] [-max-client-bps N]
+ */
+
+#include "core/types.hpp"
+#include "core/logging/logger.hpp"
+#include "core/time/tick_pacer.hpp"
+#include "network/protocol/message_schemas.hpp"
+#include "network/protocol/serialization.hpp"
+#include "network/snapshot/snapshot.hpp"
+#include "network/transport/connection.hpp"
+#include "network/transport/udp_socket.hpp"
+#include "server/demo.hpp"
+#include "server/map_cache.hpp"
+#include "server/match.hpp"
+#include "server/server_host.hpp"
+#include "common/synthetic_player.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cscpp;
+
+namespace {
+
+/// Commands are sent this many ticks ahead of the newest snapshot
+constexpr Tick CMD_LEAD_TICKS = 4;
+
+/// Resynchronise when the command tick runs further ahead than this
+constexpr Tick MAX_CMD_LEAD_TICKS = 32;
+
+/// Newest commands repeated in every UserCmdMsg, covering lost packets
+constexpr u32 CMD_REDUNDANCY = 4;
+
+/// Bots that are not in game by then count as failed
+constexpr i64 CONNECT_TIMEOUT_NS = 5'000'000'000;
+
+/// Each bot has its own socket; it only ever holds a few ticks of snapshots
+constexpr u32 BOT_SOCKET_BUFFER = 256 * 1024;
+
+constexpr f64 NANOS_TO_SECONDS = 1e-9;
+
+struct Limits {
+    u64 maxTickP99Micros = 0;       ///< 0 = unchecked
+    u64 maxClientBytesPerSecond = 0;
+};
+
+/// Min, mean and max of one value over all clients
+struct Spread {
+    f64 min = 0.0;
+    f64 mean = 0.0;
+    f64 max = 0.0;
+
+    static Spread of(const std::vector<f64>& values) {
+        Spread spread;
+        if (values.empty()) {
+            return spread;
+        }
+        spread.min = *std::min_element(values.begin(), values.end());
+        spread.max = *std::max_element(values.begin(), values.end());
+        for (f64 value : values) {
+            spread.mean += value;
+        }
+        spread.mean /= static_cast<f64>(values.size());
+        return spread;
+    }
+};
+
+void printSpread(const char* label, const Spread& spread) {
+    std::printf("  %-22s min %9.0f  mean %9.0f  max %9.0f B/s\n", label, spread.min, spread.mean, spread.max);
+}
+
+/// Tick time percentiles of a match, microseconds
+void printTickTimes(const server::MatchMetrics& match) {
+    const metrics::Histogram& ticks = match.tickDuration;
+    const metrics::Histogram& encode = match.encodeDuration;
+    std::printf("  tick time              p50 %7.1f  p99 %7.1f  max %7.1f us  (%" PRIu64 " ticks)\n",
+                static_cast<f64>(ticks.getPercentile(50.0)) / 1000.0,
+                static_cast<f64>(ticks.getPercentile(99.0)) / 1000.0,
+                static_cast<f64>(ticks.getMax()) / 1000.0, ticks.getCount());
+    std::printf("  snapshot encode        p50 %7.1f  p99 %7.1f  max %7.1f us  (all clients)\n",
+                static_cast<f64>(encode.getPercentile(50.0)) / 1000.0,
+                static_cast<f64>(encode.getPercentile(99.0)) / 1000.0,
+                static_cast<f64>(encode.getMax()) / 1000.0);
+}
+
+/// Check the limits; prints every violation
+bool checkLimits(const Limits& limits, const server::MatchMetrics* metrics, const Spread& clientBytes) {
+    bool ok = true;
+    if (limits.maxTickP99Micros && metrics) {
+        const u64 p99 = metrics->tickDuration.getPercentile(99.0) / 1000;
+        if (p99 > limits.maxTickP99Micros) {
+            std::fprintf(stderr, "Tick p99 %" PRIu64 " us exceeds %" PRIu64 " us\n", p99, limits.maxTickP99Micros);
+            ok = false;
+        }
+    }
+    if (limits.maxClientBytesPerSecond && clientBytes.max > static_cast<f64>(limits.maxClientBytesPerSecond)) {
+        std::fprintf(stderr, "Client bandwidth %.0f B/s exceeds %" PRIu64 " B/s\n",
+                     clientBytes.max, limits.maxClientBytesPerSecond);
+        ok = false;
+    }
+    return ok;
+}
+
+// ============================================================================
+// Bots
+// ============================================================================
+
+/// One synthetic client with its own socket and connection
+class BotClient {
+public:
+    BotClient(u32 index, u32 seed) : m_index(index), m_input(seed ^ (index * 0x85EBCA6Bu)) {
+        for (u32 i = 0; i < m_inbox.size(); ++i) {
+            m_inboxPointers[i] = &m_inbox[i];
+        }
+    }
+
+    /// Open a socket and send the ClientConnect handshake
+    Result<void> connect(const network::NetAddress& server, i64 now) {
+        if (auto result = m_socket.open(0, BOT_SOCKET_BUFFER); !result) {
+            return result;
+        }
+        m_connection.reset(server, now);
+
+        network::ClientConnectMsg connect{};
+        connect.protocolVersion = network::PROTOCOL_VERSION;
+        std::snprintf(connect.playerName, sizeof(connect.playerName), "bot%u", m_index);
+
+        u8 buffer[128];
+        network::BitWriter writer(buffer, sizeof(buffer));
+        network::writeMessage(writer, connect);
+        m_connection.queueReliable(std::span<const u8>(buffer, writer.getBytesWritten()));
+        send({}, now);
+        return {};
+    }
+
+    /// Process everything the server sent since the last call
+    void receive(i64 now) {
+        for (;;) {
+            const u32 count = m_socket.receive(m_inboxPointers);
+            for (u32 i = 0; i < count; ++i) {
+                const network::Datagram& datagram = m_inbox[i];
+                if (datagram.address != m_connection.getAddress()) {
+                    continue;
+                }
+
+                auto onReliable = [this](std::span<const u8> message) {
+                    if (!message.empty() && static_cast<network::MessageId>(message[0]) == network::MessageId::ServerAccept) {
+                        network::BitReader reader(message.data(), message.size());
+                        network::ServerAcceptMsg accept{};
+                        m_accepted = network::readMessage(reader, accept);
+                    }
+                };
+                std::span<const u8> payload;
+                if (m_connection.readPacket(std::span<const u8>(datagram.data.data(), datagram.size),
+                                            now, onReliable, payload) && !payload.empty()) {
+                    receivePayload(payload, now);
+                }
+            }
+            if (count < m_inboxPointers.size()) {
+                return;
+            }
+        }
+    }
+
+    /// Send this tick's commands, or whatever the connection still owes the server
+    void update(f32 tickInterval, i64 now) {
+        if (m_disconnected) {
+            return;
+        }
+        if (m_nextCmdTick == 0) {
+            // Not in game yet: resend the handshake and keep the link alive
+            if (m_connection.needsSend(now)) {
+                send({}, now);
+            }
+            return;
+        }
+
+        m_cmds[m_cmdCount++ % CMD_REDUNDANCY] = m_input.nextCmd(m_nextCmdTick++, tickInterval);
+
+        m_cmdMsg.clientTick = m_nextCmdTick - 1;
+        m_cmdMsg.lastReceivedServerTick = m_latestTick;
+        m_cmdMsg.cmds.clear();
+        const u32 count = std::min(m_cmdCount, CMD_REDUNDANCY);
+        for (u32 i = m_cmdCount - count; i < m_cmdCount; ++i) {
+            m_cmdMsg.cmds.push_back(m_cmds[i % CMD_REDUNDANCY]);
+        }
+        m_cmdMsg.cmdCount = static_cast<u8>(count);
+
+        u8 buffer[network::Connection::MAX_PAYLOAD_SIZE];
+        network::BitWriter writer(buffer, sizeof(buffer));
+        network::writeMessage(writer, m_cmdMsg);
+        send(std::span<const u8>(buffer, writer.getBytesWritten()), now);
+    }
+
+    /// Tell the server this bot quit
+    void disconnect(i64 now) {
+        if (!m_disconnected) {
+            const u8 quit = static_cast<u8>(network::MessageId::ClientDisconnect);
+            send(std::span<const u8>(&quit, 1), now);
+            m_disconnected = true;
+        }
+    }
+
+    bool isInGame() const { return m_accepted && m_snapshots > 0 && !m_disconnected; }
+    bool isDisconnected() const { return m_disconnected; }
+    u64 getSnapshots() const { return m_snapshots; }
+    u64 getBadSnapshots() const { return m_badSnapshots; }
+    u64 getBytesSent() const { return m_connection.getBytesSent(); }
+    u64 getBytesReceived() const { return m_connection.getBytesReceived(); }
+
+private:
+    void receivePayload(std::span<const u8> payload, i64 now) {
+        const auto id = static_cast<network::MessageId>(payload[0]);
+        if (id == network::MessageId::ClientDisconnect || id == network::MessageId::ServerReject) {
+            // Kicked, rejected or the server shut down
+            m_disconnected = true;
+            return;
+        }
+        if (id != network::MessageId::FullSnapshot && id != network::MessageId::DeltaSnapshot) {
+            return;
+        }
+
+        auto frame = m_decoder.decode(payload);
+        if (!frame) {
+            ++m_badSnapshots;
+            return;
+        }
+        ++m_snapshots;
+        m_latestTick = std::max(m_latestTick, (*frame)->tick);
+
+        // Keep the commands a few ticks ahead of the server's clock
+        if (m_nextCmdTick <= m_latestTick || m_nextCmdTick > m_latestTick + MAX_CMD_LEAD_TICKS) {
+            m_nextCmdTick = m_latestTick + CMD_LEAD_TICKS;
+        }
+
+        const network::ClientAckMsg ack = m_decoder.buildAck();
+        u8 buffer[32];
+        network::BitWriter writer(buffer, sizeof(buffer));
+        network::writeMessage(writer, ack);
+        send(std::span<const u8>(buffer, writer.getBytesWritten()), now);
+    }
+
+    void send(std::span<const u8> payload, i64 now) {
+        if (m_connection.writePacket(payload, now, m_outbox)) {
+            const network::Datagram* datagram = &m_outbox;
+            m_socket.send(std::span<const network::Datagram* const>(&datagram, 1));
+        }
+    }
+
+    u32 m_index;
+    tools::SyntheticPlayer m_input;
+    network::UdpSocket m_socket;
+    network::Connection m_connection;
+    network::SnapshotDecoder m_decoder;
+    network::UserCmdMsg m_cmdMsg;
+    std::array<UserCmd, CMD_REDUNDANCY> m_cmds{};
+    u32 m_cmdCount = 0;
+
+    bool m_accepted = false;
+    bool m_disconnected = false;
+    Tick m_latestTick = 0;
+    Tick m_nextCmdTick = 0;             ///< 0 until the first snapshot
+    u64 m_snapshots = 0;
+    u64 m_badSnapshots = 0;
+
+    std::array<network::Datagram, 8> m_inbox;
+    std::array<network::Datagram*, 8> m_inboxPointers{};
+    network::Datagram m_outbox;
+};
+
+struct BotOptions {
+    u32 bots = 32;
+    u32 seconds = 10;
+    u32 tickRate = 128;
+    u32 seed = 1;
+    u16 port = 27015;
+    std::string mapName = "de_dust2";
+    std::string connect;                ///< Remote server; empty = host one in-process
+    std::string recordPath;
+    Limits limits;
+};
+
+int runBots(const BotOptions& options) {
+    // In-process host unless pointed at a running server
+    std::unique_ptr<server::ServerHost> host;
+    std::atomic<bool> stopHost{false};
+    std::thread hostThread;
+
+    network::NetAddress address;
+    if (options.connect.empty()) {
+        server::HostConfig config;
+        config.tickRate = static_cast<i32>(options.tickRate);
+        config.port = options.port;
+        config.pinThreads = false;
+        config.recordPath = options.recordPath;
+        config.matches[0].mapName = options.mapName;
+        config.matches[0].maxPlayers = static_cast<i32>(options.bots);
+
+        host = std::make_unique<server::ServerHost>();
+        if (!host->initialize(config)) {
+            std::fprintf(stderr, "Failed to start the server host\n");
+            return 1;
+        }
+        hostThread = std::thread([&] { host->run(stopHost); });
+        network::NetAddress::parse("127.0.0.1:" + std::to_string(options.port), address);
+    } else if (!network::NetAddress::parse(options.connect, address)) {
+        std::fprintf(stderr, "Bad server address: %s\n", options.connect.c_str());
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<BotClient>> bots;
+    bots.reserve(options.bots);
+    const i64 connectStart = monotonicNanos();
+    for (u32 i = 0; i < options.bots; ++i) {
+        auto bot = std::make_unique<BotClient>(i, options.seed);
+        if (auto result = bot->connect(address, connectStart); !result) {
+            std::fprintf(stderr, "Bot %u: %s\n", i, result.error().message.c_str());
+            break;
+        }
+        bots.push_back(std::move(bot));
+    }
+
+    TickPacerConfig pacerConfig;
+    pacerConfig.tickRate = options.tickRate;
+    pacerConfig.overload = OverloadPolicy::Shed;
+    TickPacer pacer(pacerConfig);
+    pacer.start();
+    const f32 tickInterval = pacer.getIntervalSeconds();
+
+    // Connect everyone, then measure a window of steady play
+    std::vector<u64> sentAtStart(bots.size(), 0);
+    std::vector<u64> receivedAtStart(bots.size(), 0);
+    i64 windowStart = 0;
+    i64 windowEnd = 0;
+    for (;;) {
+        pacer.waitForTick();
+        const i64 now = monotonicNanos();
+        for (auto& bot : bots) {
+            bot->receive(now);
+            bot->update(tickInterval, now);
+        }
+        pacer.endTick();
+
+        if (windowStart == 0) {
+            const bool allInGame = std::all_of(bots.begin(), bots.end(),
+                                               [](const auto& bot) { return bot->isInGame(); });
+            if (allInGame) {
+                windowStart = now;
+                windowEnd = now + static_cast<i64>(options.seconds) * 1'000'000'000;
+                for (size_t i = 0; i < bots.size(); ++i) {
+                    sentAtStart[i] = bots[i]->getBytesSent();
+                    receivedAtStart[i] = bots[i]->getBytesReceived();
+                }
+            } else if (now - connectStart > CONNECT_TIMEOUT_NS) {
+                break;
+            }
+        } else if (now >= windowEnd) {
+            break;
+        }
+    }
+
+    const i64 end = monotonicNanos();
+    for (auto& bot : bots) {
+        bot->disconnect(end);
+    }
+
+    u32 inGame = 0;
+    u64 badSnapshots = 0;
+    std::vector<f64> upload;
+    std::vector<f64> download;
+    std::vector<f64> snapshotRate;
+    const f64 seconds = windowStart ? static_cast<f64>(end - windowStart) * NANOS_TO_SECONDS : 0.0;
+    for (size_t i = 0; i < bots.size(); ++i) {
+        const BotClient& bot = *bots[i];
+        inGame += bot.getSnapshots() > 0 ? 1 : 0;
+        badSnapshots += bot.getBadSnapshots();
+        if (seconds > 0.0) {
+            upload.push_back(static_cast<f64>(bot.getBytesSent() - sentAtStart[i]) / seconds);
+            download.push_back(static_cast<f64>(bot.getBytesReceived() - receivedAtStart[i]) / seconds);
+        }
+    }
+
+    std::printf("%u bots on %s at %u Hz (%s), %.1f s measured\n",
+                options.bots, options.connect.empty() ? options.mapName.c_str() : options.connect.c_str(),
+                options.tickRate, options.connect.empty() ? "in-process host" : "remote host", seconds);
+    std::printf("  in game                %u/%u  (%" PRIu64 " undecodable snapshots)\n",
+                inGame, options.bots, badSnapshots);
+    printSpread("server -> client", Spread::of(download));
+    printSpread("client -> server", Spread::of(upload));
+
+    const server::MatchMetrics* metrics = nullptr;
+    if (host) {
+        // Let the host see the quits before it stops; its metrics outlive run()
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        stopHost = true;
+        hostThread.join();
+
+        metrics = &host->getMatch(0).getMetrics();
+        printTickTimes(*metrics);
+        std::printf("  players %" PRIi64 ", dropped %" PRIu64 " commands and %" PRIu64 " snapshots\n",
+                    static_cast<i64>(metrics->players.get()), metrics->droppedCommands.get(), metrics->droppedFrames.get());
+    }
+
+    bool ok = windowStart != 0 && badSnapshots == 0;
+    if (windowStart == 0) {
+        std::fprintf(stderr, "Only %u of %u bots got in game within %lld s\n", inGame, options.bots,
+                     static_cast<long long>(CONNECT_TIMEOUT_NS / 1'000'000'000));
+    }
+    ok = checkLimits(options.limits, metrics, Spread::of(download)) && ok;
+
+    if (host) {
+        host->shutdown();
+    }
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+struct ReplayOptions {
+    std::string path;
+    i32 workers = 0;
+    std::string expected;
+    Limits limits;
+};
+
+/// Snapshot bytes per client id
+void addClientBytes(std::vector<u64>& bytes, ClientId clientId, size_t size) {
+    if (clientId >= bytes.size()) {
+        bytes.resize(static_cast<size_t>(clientId) + 1, 0);
+    }
+    bytes[clientId] += size;
+}
+
+std::vector<f64> bytesPerSecond(const std::vector<u64>& bytes, f64 seconds) {
+    std::vector<f64> rates;
+    for (u64 total : bytes) {
+        if (total > 0 && seconds > 0.0) {
+            rates.push_back(static_cast<f64>(total) / seconds);
+        }
+    }
+    return rates;
+}
+
+int runReplay(const ReplayOptions& options) {
+    server::DemoReader reader;
+    if (auto result = reader.open(options.path); !result) {
+        std::fprintf(stderr, "%s\n", result.error().message.c_str());
+        return 1;
+    }
+    const server::DemoHeader& header = reader.getHeader();
+
+    // Read everything first so only the match is timed
+    std::vector<server::DemoEntry> entries;
+    server::DemoEntry entry;
+    ClientId maxClientId = 0;
+    while (reader.next(entry)) {
+        maxClientId = std::max(maxClientId, entry.clientId);
+        entries.push_back(entry);
+    }
+    if (entries.empty()) {
+        std::fprintf(stderr, "Empty demo: %s\n", options.path.c_str());
+        return 1;
+    }
+    const Tick firstTick = entries.front().tick;
+    const Tick lastTick = entries.back().tick;
+
+    JobSystem jobs;
+    jobs.initialize(options.workers < 0 ? JobSystem::defaultWorkerCount() : static_cast<u32>(options.workers));
+    server::MapCache maps;
+    server::MatchConfig config;
+    config.mapName = header.mapName;
+    config.maxPlayers = static_cast<i32>(maxClientId) + 1;
+
+    auto match = std::make_unique<server::Match>();
+    if (!match->initialize(0, config, maps.acquire(header.mapName), 1.0f / static_cast<f32>(header.tickRate), jobs)) {
+        std::fprintf(stderr, "Failed to initialize the match\n");
+        return 1;
+    }
+
+    std::vector<u64> recordedBytes;
+    std::vector<u64> replayedBytes;
+    u64 hash = 0xCBF29CE484222325ull;
+
+    // Each tick gets the messages the live match had received before it ran
+    const i64 start = monotonicNanos();
+    size_t cursor = 0;
+    for (Tick tick = firstTick + 1; tick <= lastTick; ++tick) {
+        for (; cursor < entries.size() && entries[cursor].tick < tick; ++cursor) {
+            const server::DemoEntry& recorded = entries[cursor];
+            if (recorded.type == server::DemoRecord::Packet) {
+                match->receivePacket(recorded.clientId, recorded.data);
+            } else {
+                addClientBytes(recordedBytes, recorded.clientId, recorded.data.size());
+            }
+        }
+
+        match->tick(tick, false);
+        if (!match->encodeSnapshots()) {
+            continue;
+        }
+
+        // FNV-1a over every packet, in client order
+        network::SnapshotEncoder& snapshots = match->getSnapshots();
+        for (size_t c = 0; c < snapshots.getClientCount(); ++c) {
+            const network::ClientSnapshotState& client = snapshots.getClient(c);
+            const std::span<const u8> packet = client.getPacket();
+            addClientBytes(replayedBytes, client.getClientId(), packet.size());
+            for (u8 byte : packet) {
+                hash = (hash ^ byte) * 0x100000001B3ull;
+            }
+        }
+    }
+    const f64 wallSeconds = static_cast<f64>(monotonicNanos() - start) * NANOS_TO_SECONDS;
+    for (; cursor < entries.size(); ++cursor) {
+        if (entries[cursor].type == server::DemoRecord::Snapshot) {
+            addClientBytes(recordedBytes, entries[cursor].clientId, entries[cursor].data.size());
+        }
+    }
+    const f64 gameSeconds = static_cast<f64>(lastTick - firstTick) / static_cast<f64>(header.tickRate);
+
+    const Spread recorded = Spread::of(bytesPerSecond(recordedBytes, gameSeconds));
+    const Spread replayed = Spread::of(bytesPerSecond(replayedBytes, gameSeconds));
+
+    std::printf("%s: %s at %u Hz, %u ticks (%.1f s) in %.2f s, %.1fx realtime\n",
+                options.path.c_str(), header.mapName.c_str(), header.tickRate, static_cast<u32>(lastTick - firstTick),
+                gameSeconds, wallSeconds, wallSeconds > 0.0 ? gameSeconds / wallSeconds : 0.0);
+    std::printf("  clients                %zu, %zu recorded messages\n",
+                bytesPerSecond(replayedBytes, gameSeconds).size(), entries.size());
+    printSpread("recorded snapshots", recorded);
+    printSpread("replayed snapshots", replayed);
+    printTickTimes(match->getMetrics());
+    std::printf("  snapshot hash          %016" PRIx64 "\n", hash);
+
+    bool ok = checkLimits(options.limits, &match->getMetrics(), replayed);
+    if (!options.expected.empty() && std::strtoull(options.expected.c_str(), nullptr, 16) != hash) {
+        std::fprintf(stderr, "Hash mismatch: expected %s\n", options.expected.c_str());
+        ok = false;
+    }
+
+    match->shutdown();
+    jobs.shutdown();
+    return ok ? 0 : 1;
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "Usage:\n"
+                 "  replay_tool bots [-bots N] [-seconds N] [-tickrate N] [-map name] [-seed N]\n"
+                 "                   [-port N] [-connect a.b.c.d:port] [-record file] [limits]\n"
+                 "  replay_tool replay file [-workers N] [-expect hash] [limits]\n"
+                 "  limits: [-max-tick-p99-us N] [-max-client-bps N]\n");
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+    const std::string mode = argv[1];
+
+    BotOptions bots;
+    ReplayOptions replay;
+    Limits limits;
+    int first = 2;
+    if (mode == "replay") {
+        if (argc < 3) {
+            printUsage();
+            return 2;
+        }
+        replay.path = argv[2];
+        first = 3;
+    } else if (mode != "bots") {
+        printUsage();
+        return 2;
+    }
+
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-max-tick-p99-us" && hasValue) {
+            limits.maxTickP99Micros = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-max-client-bps" && hasValue) {
+            limits.maxClientBytesPerSecond = std::strtoull(argv[++i], nullptr, 10);
+        } else if (mode == "bots" && arg == "-bots" && hasValue) {
+            bots.bots = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (mode == "bots" && arg == "-seconds" && hasValue) {
+            bots.seconds = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (mode == "bots" && arg == "-tickrate" && hasValue) {
+            bots.tickRate = static_cast<u32>(std::max(std::atoi(argv[++i]), 1));
+        } else if (mode == "bots" && arg == "-seed" && hasValue) {
+            bots.seed = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (mode == "bots" && arg == "-port" && hasValue) {
+            bots.port = static_cast<u16>(std::atoi(argv[++i]));
+        } else if (mode == "bots" && arg == "-map" && hasValue) {
+            bots.mapName = argv[++i];
+        } else if (mode == "bots" && arg == "-connect" && hasValue) {
+            bots.connect = argv[++i];
+        } else if (mode == "bots" && arg == "-record" && hasValue) {
+            bots.recordPath = argv[++i];
+        } else if (mode == "replay" && arg == "-workers" && hasValue) {
+            replay.workers = std::atoi(argv[++i]);
+        } else if (mode == "replay" && arg == "-expect" && hasValue) {
+            replay.expected = argv[++i];
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (mode == "bots" && !bots.connect.empty() && !bots.recordPath.empty()) {
+        std::fprintf(stderr, "-record needs the in-process host (drop -connect, or record with the server's -record)\n");
+        return 2;
+    }
+
+    Logger::initialize("replay_tool.log", LogLevel::Info, LogLevel::Debug);
+
+    int result = 0;
+    if (mode == "bots") {
+        bots.limits = limits;
+        result = runBots(bots);
+    } else {
+        replay.limits = limits;
+        result = runReplay(replay);
+    }
+
+    Logger::shutdown();
+    return result;
+}